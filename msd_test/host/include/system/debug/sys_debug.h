@@ -0,0 +1,80 @@
+/*******************************************************************************
+  Debug System Service Header File of the Host Build
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sys_debug.h
+
+  Summary
+    Error levels and message macros of the debug system service.
+
+  Description
+    The project does not ship the debug system service, whose header
+    definitions.h includes. The host build puts this header first on the
+    include path instead: it defines the error levels and compiles the
+    messages out, as the target does without SYS_DEBUG_USE_CONSOLE.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SYS_DEBUG_H
+#define SYS_DEBUG_H
+
+#include <stdint.h>
+
+#define SYS_ERROR_FATAL     0
+#define SYS_ERROR_ERROR     1
+#define SYS_ERROR_WARNING   2
+#define SYS_ERROR_INFO      3
+#define SYS_ERROR_DEBUG     4
+
+typedef uint32_t SYS_ERROR_LEVEL;
+
+#ifndef SYS_DEBUG_MESSAGE
+    #define SYS_DEBUG_MESSAGE(level, message)
+#endif
+
+#ifndef SYS_DEBUG_PRINT
+    #define SYS_DEBUG_PRINT(level, fmt, ...)
+#endif
+
+#ifndef SYS_DEBUG
+    #define SYS_DEBUG(level, message)
+#endif
+
+#ifndef SYS_CONSOLE_PRINT
+    #define SYS_CONSOLE_PRINT(fmt, ...)
+#endif
+
+#ifndef SYS_CONSOLE_MESSAGE
+    #define SYS_CONSOLE_MESSAGE(message)
+#endif
+
+#define SYS_DEBUG_BreakPoint()
+
+#endif // SYS_DEBUG_H
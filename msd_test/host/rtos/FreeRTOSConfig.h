@@ -0,0 +1,116 @@
+/*******************************************************************************
+  FreeRTOS Kernel Configuration Header of the Host Build
+
+  File Name:
+    FreeRTOSConfig.h
+
+  Summary:
+    Build-time configuration of the FreeRTOS kernel on its POSIX port.
+
+  Description:
+    This file replaces the FreeRTOSConfig.h of src/config/default for the
+    FreeRTOS tests of the host build (GCC/POSIX port). It keeps the task
+    related settings of the target, which are the ones the tests check:
+    the priorities, the tick rate, the stack overflow check and the 64-bit
+    run-time statistics in SYS_TIME counts, which sim_rtos.c counts from
+    the monotonic clock of the host.
+
+    The Cortex-M interrupt priorities and handler names do not apply. The
+    stacks are the stacks of the task threads, so they hold at least
+    PTHREAD_STACK_MIN bytes, and the kernel allocates them with malloc
+    (heap_3).
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+#include <limits.h>
+
+/* Free running 64-bit SYS_TIME counter, used for the run-time statistics */
+extern uint64_t SYS_TIME_Counter64Get ( void );
+
+/* Reports a failed configASSERT and ends the test program */
+extern void SIM_RTOS_AssertFailed ( const char * file, unsigned long line );
+
+/*-----------------------------------------------------------
+ * Application specific definitions.
+ *----------------------------------------------------------*/
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configUSE_TICKLESS_IDLE                 0
+#define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES                    ( 5UL )
+#define configMINIMAL_STACK_SIZE                ( ( size_t ) PTHREAD_STACK_MIN / sizeof( StackType_t ) )
+#define configSTACK_DEPTH_TYPE                  size_t
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configSUPPORT_STATIC_ALLOCATION         0
+#define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( 1024 * 1024 ) )
+#define configMAX_TASK_NAME_LEN                 ( 8 )
+#define configTICK_TYPE_WIDTH_IN_BITS           TICK_TYPE_WIDTH_32_BITS
+#define configIDLE_SHOULD_YIELD                 1
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configUSE_MUTEXES                       1
+#define configUSE_RECURSIVE_MUTEXES             0
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configQUEUE_REGISTRY_SIZE               0
+#define configUSE_QUEUE_SETS                    0
+#define configUSE_TIMERS                        0
+#define configUSE_CO_ROUTINES                   0
+
+/* Hook function related definitions (see freertos_hooks.c). The idle hook
+   waits in SIM_RTOS_WaitForInterrupt and accounts the idle time of the
+   scheduler service. */
+#define configUSE_IDLE_HOOK                     1
+#define configUSE_TICK_HOOK                     0
+#define configCHECK_FOR_STACK_OVERFLOW          2
+#define configUSE_MALLOC_FAILED_HOOK            1
+
+/* Run time and task stats gathering related definitions. */
+#define configGENERATE_RUN_TIME_STATS           1
+#define configRUN_TIME_COUNTER_TYPE             uint64_t
+#define configUSE_TRACE_FACILITY                1
+#define configUSE_STATS_FORMATTING_FUNCTIONS    0
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        SYS_TIME_Counter64Get()
+
+/* Optional functions - most linkers will remove unused functions anyway. */
+#define INCLUDE_vTaskPrioritySet                0
+#define INCLUDE_uxTaskPriorityGet               0
+#define INCLUDE_vTaskDelete                     0
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_vTaskDelayUntil                 0
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetIdleTaskHandle          0
+
+#define configASSERT( x )                       if( ( x ) == 0 ) { SIM_RTOS_AssertFailed( __FILE__, __LINE__ ); }
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,409 @@
+/*******************************************************************************
+  Simulated Clock Implementation
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_clock.c
+
+  Summary
+    Virtual time, interrupts and the TC0 timer of the host build.
+
+  Description
+    See sim_clock.h. The scheduled events are kept in a list sorted by time.
+    There are only a few of them at a time (one or two per peripheral), so
+    the list is scanned instead of kept in a heap.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stddef.h>
+#include "sim_clock.h"
+#include "peripheral/tc/plib_tc0.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Largest interrupt source number the masks cover */
+#define SIM_CLOCK_SOURCES_NUMBER    (256U)
+
+/* The simulated counter counts SIM_CLOCK_TIMER_FREQUENCY / 1 GHz = 3 / 50
+   per nanosecond */
+#define SIM_CLOCK_COUNT_MUL         (3U)
+#define SIM_CLOCK_COUNT_DIV         (50U)
+
+#define SIM_CLOCK_COUNTER_PERIOD    (0x100000000ULL)
+
+typedef struct
+{
+    SIM_TIME now;
+
+    SIM_CLOCK_EVENT* events;
+
+    bool interruptsEnabled;
+
+    bool sourceEnabled[SIM_CLOCK_SOURCES_NUMBER];
+
+} SIM_CLOCK_OBJ;
+
+typedef struct
+{
+    bool isRunning;
+
+    /* Counter value when it was stopped, or the virtual count at which the
+       counter was 0 while it runs */
+    uint64_t countBase;
+
+    uint32_t compare;
+
+    TC_TIMER_CALLBACK callback;
+
+    uintptr_t context;
+
+    SIM_CLOCK_EVENT matchEvent;
+
+    SIM_CLOCK_EVENT overflowEvent;
+
+} SIM_CLOCK_TIMER_OBJ;
+
+static SIM_CLOCK_OBJ simClockObj;
+
+static SIM_CLOCK_TIMER_OBJ simTimerObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool SIM_CLOCK_SourceIsEnabled( INT_SOURCE source )
+{
+    uint32_t index = (uint32_t)source;
+
+    return (index >= SIM_CLOCK_SOURCES_NUMBER) || simClockObj.sourceEnabled[index];
+}
+
+static void SIM_CLOCK_EventUnlink( SIM_CLOCK_EVENT* event )
+{
+    SIM_CLOCK_EVENT** link = &simClockObj.events;
+
+    while (*link != NULL)
+    {
+        if (*link == event)
+        {
+            *link = event->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+    event->next = NULL;
+    event->isScheduled = false;
+}
+
+/* Virtual count of the simulated counter at the given time */
+static uint64_t SIM_CLOCK_CountGet( SIM_TIME time )
+{
+    return (time * SIM_CLOCK_COUNT_MUL) / SIM_CLOCK_COUNT_DIV;
+}
+
+/* First time at which the virtual count reaches the given count */
+static SIM_TIME SIM_CLOCK_CountTimeGet( uint64_t count )
+{
+    return ((count * SIM_CLOCK_COUNT_DIV) + SIM_CLOCK_COUNT_MUL - 1U) / SIM_CLOCK_COUNT_MUL;
+}
+
+static uint32_t SIM_CLOCK_TimerCounterGet( void )
+{
+    if (!simTimerObj.isRunning)
+    {
+        return (uint32_t)simTimerObj.countBase;
+    }
+    return (uint32_t)(SIM_CLOCK_CountGet(simClockObj.now) - simTimerObj.countBase);
+}
+
+/* Schedules the compare match and the overflow after the current count */
+static void SIM_CLOCK_TimerEventsUpdate( void )
+{
+    uint64_t count;
+    uint64_t delta;
+
+    if (!simTimerObj.isRunning)
+    {
+        SIM_CLOCK_EventCancel(&simTimerObj.matchEvent);
+        SIM_CLOCK_EventCancel(&simTimerObj.overflowEvent);
+        return;
+    }
+
+    count = SIM_CLOCK_CountGet(simClockObj.now);
+
+    delta = (uint32_t)(simTimerObj.compare - SIM_CLOCK_TimerCounterGet());
+    if (delta == 0U)
+    {
+        delta = SIM_CLOCK_COUNTER_PERIOD;
+    }
+    SIM_CLOCK_EventSchedule(&simTimerObj.matchEvent, SIM_CLOCK_CountTimeGet(count + delta));
+
+    delta = SIM_CLOCK_COUNTER_PERIOD - SIM_CLOCK_TimerCounterGet();
+    SIM_CLOCK_EventSchedule(&simTimerObj.overflowEvent, SIM_CLOCK_CountTimeGet(count + delta));
+}
+
+static void SIM_CLOCK_TimerHandler( uintptr_t context )
+{
+    TC_TIMER_STATUS status = (TC_TIMER_STATUS)context;
+
+    SIM_CLOCK_TimerEventsUpdate();
+
+    if (simTimerObj.callback != NULL)
+    {
+        simTimerObj.callback(status, simTimerObj.context);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SIM_CLOCK_Initialize( void )
+{
+    uint32_t index;
+
+    simClockObj.now = 0U;
+    simClockObj.events = NULL;
+    simClockObj.interruptsEnabled = true;
+    for (index = 0U; index < SIM_CLOCK_SOURCES_NUMBER; index++)
+    {
+        simClockObj.sourceEnabled[index] = true;
+    }
+
+    simTimerObj.isRunning = false;
+    simTimerObj.countBase = 0U;
+    simTimerObj.compare = 0U;
+    simTimerObj.callback = NULL;
+    SIM_CLOCK_EventInitialize(&simTimerObj.matchEvent, TC0_IRQn, SIM_CLOCK_TimerHandler, (uintptr_t)TC_TIMER_STATUS_MATCH1);
+    SIM_CLOCK_EventInitialize(&simTimerObj.overflowEvent, TC0_IRQn, SIM_CLOCK_TimerHandler, (uintptr_t)TC_TIMER_STATUS_OVERFLOW);
+}
+
+SIM_TIME SIM_CLOCK_Now( void )
+{
+    return simClockObj.now;
+}
+
+void SIM_CLOCK_EventInitialize( SIM_CLOCK_EVENT* event, INT_SOURCE source,
+                                SIM_CLOCK_HANDLER handler, uintptr_t context )
+{
+    event->time = 0U;
+    event->source = source;
+    event->handler = handler;
+    event->context = context;
+    event->isScheduled = false;
+    event->next = NULL;
+}
+
+void SIM_CLOCK_EventSchedule( SIM_CLOCK_EVENT* event, SIM_TIME time )
+{
+    SIM_CLOCK_EVENT** link = &simClockObj.events;
+
+    if (event->isScheduled)
+    {
+        SIM_CLOCK_EventUnlink(event);
+    }
+
+    /* Events due at the same time run in the order they were scheduled */
+    while ((*link != NULL) && ((*link)->time <= time))
+    {
+        link = &(*link)->next;
+    }
+
+    event->time = time;
+    event->next = *link;
+    event->isScheduled = true;
+    *link = event;
+}
+
+void SIM_CLOCK_EventCancel( SIM_CLOCK_EVENT* event )
+{
+    if (event->isScheduled)
+    {
+        SIM_CLOCK_EventUnlink(event);
+    }
+}
+
+SIM_TIME SIM_CLOCK_NextEventGet( void )
+{
+    return (simClockObj.events != NULL) ? simClockObj.events->time : UINT64_MAX;
+}
+
+void SIM_CLOCK_Advance( SIM_TIME step )
+{
+    SIM_TIME target = simClockObj.now + step;
+    SIM_CLOCK_EVENT* event;
+
+    while (simClockObj.interruptsEnabled)
+    {
+        /* Earliest due event that is not masked */
+        event = simClockObj.events;
+        while ((event != NULL) && (event->time <= target) && !SIM_CLOCK_SourceIsEnabled(event->source))
+        {
+            event = event->next;
+        }
+        if ((event == NULL) || (event->time > target))
+        {
+            break;
+        }
+
+        if (event->time > simClockObj.now)
+        {
+            simClockObj.now = event->time;
+        }
+        SIM_CLOCK_EventUnlink(event);
+        event->handler(event->context);
+    }
+
+    simClockObj.now = target;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SYS_INT Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_INT_Enable( void )
+{
+    simClockObj.interruptsEnabled = true;
+}
+
+bool SYS_INT_Disable( void )
+{
+    bool state = simClockObj.interruptsEnabled;
+
+    simClockObj.interruptsEnabled = false;
+    return state;
+}
+
+void SYS_INT_Restore( bool state )
+{
+    simClockObj.interruptsEnabled = state;
+}
+
+bool SYS_INT_SourceDisable( INT_SOURCE source )
+{
+    uint32_t index = (uint32_t)source;
+    bool state = SIM_CLOCK_SourceIsEnabled(source);
+
+    if (index < SIM_CLOCK_SOURCES_NUMBER)
+    {
+        simClockObj.sourceEnabled[index] = false;
+    }
+    return state;
+}
+
+void SYS_INT_SourceRestore( INT_SOURCE source, bool status )
+{
+    uint32_t index = (uint32_t)source;
+
+    if (status && (index < SIM_CLOCK_SOURCES_NUMBER))
+    {
+        simClockObj.sourceEnabled[index] = true;
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: TC0 PLIB Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void TC0_TimerInitialize( void )
+{
+    simTimerObj.isRunning = false;
+    simTimerObj.countBase = 0U;
+}
+
+void TC0_TimerStart( void )
+{
+    if (!simTimerObj.isRunning)
+    {
+        simTimerObj.countBase = SIM_CLOCK_CountGet(simClockObj.now) - simTimerObj.countBase;
+        simTimerObj.isRunning = true;
+    }
+    SIM_CLOCK_TimerEventsUpdate();
+}
+
+void TC0_TimerStop( void )
+{
+    if (simTimerObj.isRunning)
+    {
+        simTimerObj.countBase = SIM_CLOCK_TimerCounterGet();
+        simTimerObj.isRunning = false;
+    }
+    SIM_CLOCK_TimerEventsUpdate();
+}
+
+uint32_t TC0_TimerFrequencyGet( void )
+{
+    return SIM_CLOCK_TIMER_FREQUENCY;
+}
+
+void TC0_Timer32bitPeriodSet( uint32_t period )
+{
+    /* The counter always runs over the full 32 bits */
+    (void)period;
+}
+
+uint32_t TC0_Timer32bitPeriodGet( void )
+{
+    return 0xFFFFFFFFU;
+}
+
+uint32_t TC0_Timer32bitCounterGet( void )
+{
+    return SIM_CLOCK_TimerCounterGet();
+}
+
+void TC0_Timer32bitCompareSet( uint32_t compare )
+{
+    simTimerObj.compare = compare;
+    SIM_CLOCK_TimerEventsUpdate();
+}
+
+void TC0_TimerCallbackRegister( TC_TIMER_CALLBACK callback, uintptr_t context )
+{
+    simTimerObj.callback = callback;
+    simTimerObj.context = context;
+}
@@ -0,0 +1,165 @@
+/*******************************************************************************
+  Simulated Clock Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_clock.h
+
+  Summary
+    Virtual time, interrupts and the TC0 timer of the host build.
+
+  Description
+    The host build runs the firmware modules as a single Linux process. Time
+    does not flow on its own: it is a 64-bit nanosecond counter moved forward
+    by SIM_CLOCK_Advance, which the main loop of a host program calls once
+    per pass over the tasks. The step given to SIM_CLOCK_Advance stands for
+    the processor time of one pass.
+
+    The simulated peripherals schedule SIM_CLOCK_EVENT objects at the virtual
+    time their hardware would raise an interrupt. SIM_CLOCK_Advance calls the
+    handler of each event that falls due, in time order, as the interrupt
+    handler of its source. An event whose source is disabled with
+    SYS_INT_SourceDisable, or that falls due while SYS_INT_Disable is in
+    effect, stays pending until it is enabled again.
+
+    This file also implements the SYS_INT functions and the TC0 32-bit
+    timer functions used by SYS_TIME, so sys_time.c runs unmodified against
+    the virtual time.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "system/int/sys_int.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Virtual time in nanoseconds since SIM_CLOCK_Initialize */
+typedef uint64_t SIM_TIME;
+
+#define SIM_TIME_US(us)     ((SIM_TIME)(us) * 1000U)
+#define SIM_TIME_MS(ms)     ((SIM_TIME)(ms) * 1000000U)
+
+/* Frequency of the simulated TC0 counter, as on the target */
+#define SIM_CLOCK_TIMER_FREQUENCY   (60000000U)
+
+/* Source of the events no interrupt mask delays, such as the bus activity
+   of a peripheral */
+#define SIM_CLOCK_SOURCE_NONE       ((INT_SOURCE)0x7FFFFFFF)
+
+typedef void (*SIM_CLOCK_HANDLER)(uintptr_t context);
+
+// *****************************************************************************
+/* Simulated interrupt
+
+  Summary:
+    An interrupt a simulated peripheral raises at a given virtual time.
+
+  Remarks:
+    The object is owned by the peripheral and is only linked into the event
+    list while it is scheduled.
+*/
+
+typedef struct SIM_CLOCK_EVENT_
+{
+    /* Time the event falls due */
+    SIM_TIME time;
+
+    /* Interrupt source whose masking delays the event */
+    INT_SOURCE source;
+
+    SIM_CLOCK_HANDLER handler;
+
+    uintptr_t context;
+
+    bool isScheduled;
+
+    struct SIM_CLOCK_EVENT_* next;
+
+} SIM_CLOCK_EVENT;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Resets the virtual time to 0, drops all events and enables all the
+   interrupts. */
+void SIM_CLOCK_Initialize( void );
+
+SIM_TIME SIM_CLOCK_Now( void );
+
+/* Prepares an event. It is not scheduled. */
+void SIM_CLOCK_EventInitialize( SIM_CLOCK_EVENT* event, INT_SOURCE source,
+                                SIM_CLOCK_HANDLER handler, uintptr_t context );
+
+/* Schedules the event at the given time, or moves it there if it is already
+   scheduled. A time in the past makes the event due on the next
+   SIM_CLOCK_Advance. */
+void SIM_CLOCK_EventSchedule( SIM_CLOCK_EVENT* event, SIM_TIME time );
+
+void SIM_CLOCK_EventCancel( SIM_CLOCK_EVENT* event );
+
+/* Time of the earliest scheduled event, or UINT64_MAX if there is none */
+SIM_TIME SIM_CLOCK_NextEventGet( void );
+
+/* Moves the virtual time forward by step nanoseconds and calls the handler
+   of every event that falls due and is not masked, in time order. The time
+   seen by a handler is the time of its event. */
+void SIM_CLOCK_Advance( SIM_TIME step );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_CLOCK_H
@@ -0,0 +1,224 @@
+/*******************************************************************************
+  Simulated Core Registers
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_core.c
+
+  Summary
+    NVIC, PORT and calibration row windows.
+
+  Description
+    See sim_core.h.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stddef.h>
+#include <string.h>
+#include "device.h"
+#include "system/int/sys_int.h"
+#include "sim_mmio.h"
+#include "sim_core.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_CORE_PAGE_SIZE          (4096U)
+
+/* NVIC registers, from the start of the System Control Space */
+#define SIM_CORE_NVIC_OFFSET(member)    ((uint32_t)(NVIC_BASE - SCS_BASE) + (uint32_t)offsetof(NVIC_Type, member))
+#define SIM_CORE_NVIC_WORDS             (8U)
+
+#define SIM_CORE_PORT_GROUP_SIZE    (sizeof(port_group_registers_t))
+
+typedef struct
+{
+    uint8_t* scs;
+
+    uint8_t* port;
+
+    uint8_t* calibration;
+
+} SIM_CORE_OBJ;
+
+static SIM_CORE_OBJ simCoreObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool SIM_CORE_IsInRange( uint32_t offset, uint32_t start, uint32_t size )
+{
+    return (offset >= start) && (offset < (start + size));
+}
+
+static void SIM_CORE_ScsWrite( uintptr_t context, uint32_t offset, uint64_t value )
+{
+    uint32_t word = (uint32_t)value;
+    uint32_t base;
+    uint32_t bit;
+
+    (void)context;
+
+    if (SIM_CORE_IsInRange(offset, SIM_CORE_NVIC_OFFSET(ISER), SIM_CORE_NVIC_WORDS * 4U))
+    {
+        base = ((offset - SIM_CORE_NVIC_OFFSET(ISER)) / 4U) * 32U;
+        for (bit = 0U; bit < 32U; bit++)
+        {
+            if ((word & (1UL << bit)) != 0U)
+            {
+                SYS_INT_SourceRestore((INT_SOURCE)(base + bit), true);
+            }
+        }
+    }
+    else if (SIM_CORE_IsInRange(offset, SIM_CORE_NVIC_OFFSET(ICER), SIM_CORE_NVIC_WORDS * 4U))
+    {
+        base = ((offset - SIM_CORE_NVIC_OFFSET(ICER)) / 4U) * 32U;
+        for (bit = 0U; bit < 32U; bit++)
+        {
+            if ((word & (1UL << bit)) != 0U)
+            {
+                (void)SYS_INT_SourceDisable((INT_SOURCE)(base + bit));
+            }
+        }
+    }
+    else if (SIM_CORE_IsInRange(offset, SIM_CORE_NVIC_OFFSET(ISPR), SIM_CORE_NVIC_OFFSET(IP) - SIM_CORE_NVIC_OFFSET(ISPR)))
+    {
+        /* Pending and active states belong to the simulated peripherals */
+    }
+    else if (SIM_CORE_IsInRange(offset, SIM_CORE_NVIC_OFFSET(IP), sizeof(NVIC->IP)))
+    {
+        simCoreObj.scs[offset] = (uint8_t)value;
+    }
+    else if ((offset + 4U) <= SIM_CORE_PAGE_SIZE)
+    {
+        memcpy(&simCoreObj.scs[offset], &word, sizeof(word));
+    }
+}
+
+static void SIM_CORE_PortWrite( uintptr_t context, uint32_t offset, uint64_t value )
+{
+    port_group_registers_t* group;
+    uint32_t word = (uint32_t)value;
+    uint32_t reg;
+
+    (void)context;
+
+    if (offset >= (PORT_GROUP_NUMBER * SIM_CORE_PORT_GROUP_SIZE))
+    {
+        return;
+    }
+    group = (port_group_registers_t*)&simCoreObj.port[(offset / SIM_CORE_PORT_GROUP_SIZE) * SIM_CORE_PORT_GROUP_SIZE];
+    reg = offset % SIM_CORE_PORT_GROUP_SIZE;
+
+    switch (reg)
+    {
+        case PORT_DIR_REG_OFST:     group->PORT_DIR = word;     break;
+        case PORT_DIRCLR_REG_OFST:  group->PORT_DIR &= ~word;   break;
+        case PORT_DIRSET_REG_OFST:  group->PORT_DIR |= word;    break;
+        case PORT_DIRTGL_REG_OFST:  group->PORT_DIR ^= word;    break;
+        case PORT_OUT_REG_OFST:     group->PORT_OUT = word;     break;
+        case PORT_OUTCLR_REG_OFST:  group->PORT_OUT &= ~word;   break;
+        case PORT_OUTSET_REG_OFST:  group->PORT_OUT |= word;    break;
+        case PORT_OUTTGL_REG_OFST:  group->PORT_OUT ^= word;    break;
+
+        case PORT_IN_REG_OFST:
+        case PORT_WRCONFIG_REG_OFST:
+            /* Read-only, and write-only */
+            break;
+
+        default:
+            if (reg >= PORT_PMUX_REG_OFST)
+            {
+                /* PMUX and PINCFG are byte registers */
+                simCoreObj.port[offset] = (uint8_t)value;
+            }
+            else
+            {
+                memcpy(&simCoreObj.port[offset], &word, sizeof(word));
+            }
+            break;
+    }
+
+    /* The clear, set and toggle registers read as the register they change.
+       IN follows OUT: nothing else drives the pins. */
+    group->PORT_DIRCLR = group->PORT_DIR;
+    group->PORT_DIRSET = group->PORT_DIR;
+    group->PORT_DIRTGL = group->PORT_DIR;
+    group->PORT_OUTCLR = group->PORT_OUT;
+    group->PORT_OUTSET = group->PORT_OUT;
+    group->PORT_OUTTGL = group->PORT_OUT;
+    word = group->PORT_OUT;
+    memcpy((uint8_t*)group + PORT_IN_REG_OFST, &word, sizeof(word));
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+bool SIM_CORE_Initialize( void )
+{
+    simCoreObj.scs = SIM_MMIO_WindowMap(SCS_BASE, SIM_CORE_PAGE_SIZE, SIM_CORE_ScsWrite, 0U);
+    simCoreObj.port = SIM_MMIO_WindowMap((uintptr_t)PORT_REGS, SIM_CORE_PAGE_SIZE, SIM_CORE_PortWrite, 0U);
+    simCoreObj.calibration = SIM_MMIO_WindowMap(SW0_ADDR & ~(SIM_CORE_PAGE_SIZE - 1U), SIM_CORE_PAGE_SIZE, NULL, 0U);
+
+    if ((simCoreObj.scs == NULL) || (simCoreObj.port == NULL) || (simCoreObj.calibration == NULL))
+    {
+        return false;
+    }
+
+    /* Erased flash. The drivers fall back to their default calibration. */
+    memset(simCoreObj.calibration, 0xFF, SIM_CORE_PAGE_SIZE);
+    return true;
+}
+
+bool SIM_CORE_PinGet( uint32_t group, uint32_t pin )
+{
+    const port_group_registers_t* regs;
+
+    if ((simCoreObj.port == NULL) || (group >= PORT_GROUP_NUMBER) || (pin >= 32U))
+    {
+        return false;
+    }
+    regs = (const port_group_registers_t*)&simCoreObj.port[group * SIM_CORE_PORT_GROUP_SIZE];
+    return ((regs->PORT_OUT >> pin) & 1U) != 0U;
+}
@@ -0,0 +1,89 @@
+/*******************************************************************************
+  Simulated Core Registers Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_core.h
+
+  Summary
+    NVIC, PORT and calibration row registers of the host build.
+
+  Description
+    The register windows the firmware touches around the peripherals the
+    host build simulates:
+    - The System Control Space, for the NVIC_EnableIRQ and
+      NVIC_ClearPendingIRQ calls behind the SYS_INT macros. Enabling an
+      interrupt source enables it in SIM_CLOCK. Pending states are kept by
+      the simulated peripherals, so the pending registers ignore writes.
+    - The PORT groups, whose OUTSET, OUTCLR and OUTTGL registers change OUT
+      as on the target, so a test can check the board LEDs.
+    - The NVM software calibration row, read-only and erased.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_CORE_H
+#define SIM_CORE_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Maps the windows, or resets them if they are mapped. Call it after
+   SIM_CLOCK_Initialize. Returns false if a window cannot be mapped. */
+bool SIM_CORE_Initialize( void );
+
+/* Output value of a PORT pin */
+bool SIM_CORE_PinGet( uint32_t group, uint32_t pin );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_CORE_H
@@ -0,0 +1,318 @@
+/*******************************************************************************
+  Simulated Memory Mapped Registers
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_mmio.c
+
+  Summary
+    Register windows trapping the writes of the firmware.
+
+  Description
+    Each window is a memory file mapped twice: read-only at the address of
+    the target, where the firmware accesses it, and writable anywhere as
+    the alias the peripheral model keeps its registers in.
+
+    A write to the read-only view raises SIGSEGV. The handler saves the
+    pages of the window the write may touch, makes the view writable and
+    sets the trap flag, so the write runs and SIGTRAP follows right after
+    the instruction. That handler takes the written value, puts the saved
+    pages back, makes the view read-only again and calls the model. Only
+    two pages are saved, so a large window such as a flash bank costs no
+    more per write than a register window.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "sim_mmio.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_MMIO_WINDOWS_NUMBER     (8U)
+
+/* The page written to and the next one, which a write that crosses the end
+   of the page reaches */
+#define SIM_MMIO_SNAPSHOT_SIZE      (2U * 4096U)
+
+/* Trap flag of RFLAGS */
+#define SIM_MMIO_EFLAGS_TF          (0x100U)
+
+typedef struct
+{
+    uintptr_t address;
+
+    size_t size;
+
+    /* Writable mapping of the same memory */
+    uint8_t* alias;
+
+    SIM_MMIO_WRITE_HANDLER handler;
+
+    uintptr_t context;
+
+} SIM_MMIO_WINDOW;
+
+typedef struct
+{
+    SIM_MMIO_WINDOW windows[SIM_MMIO_WINDOWS_NUMBER];
+
+    uint32_t windowsNumber;
+
+    bool isInstalled;
+
+    /* Window of the write being single-stepped, NULL between writes */
+    SIM_MMIO_WINDOW* pending;
+
+    uint32_t pendingOffset;
+
+    /* Content of the pending window before the write, from
+       snapshotOffset on */
+    uint32_t snapshotOffset;
+
+    size_t snapshotSize;
+
+    uint8_t snapshot[SIM_MMIO_SNAPSHOT_SIZE];
+
+} SIM_MMIO_OBJ;
+
+static SIM_MMIO_OBJ simMmioObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Lets a fault the simulator does not handle take its default action when
+   the instruction runs again */
+static void SIM_MMIO_DefaultRestore( int signal )
+{
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_DFL;
+    (void)sigaction(signal, &action, NULL);
+}
+
+static SIM_MMIO_WINDOW* SIM_MMIO_WindowFind( uintptr_t address )
+{
+    uint32_t index;
+
+    for (index = 0U; index < simMmioObj.windowsNumber; index++)
+    {
+        SIM_MMIO_WINDOW* window = &simMmioObj.windows[index];
+
+        if ((address >= window->address) && (address < (window->address + window->size)))
+        {
+            return window;
+        }
+    }
+    return NULL;
+}
+
+static void SIM_MMIO_FaultHandler( int signal, siginfo_t* info, void* data )
+{
+    ucontext_t* context = (ucontext_t*)data;
+    SIM_MMIO_WINDOW* window = SIM_MMIO_WindowFind((uintptr_t)info->si_addr);
+
+    if ((window == NULL) || (simMmioObj.pending != NULL))
+    {
+        SIM_MMIO_DefaultRestore(signal);
+        return;
+    }
+    if (window->handler == NULL)
+    {
+        fprintf(stderr, "sim_mmio: write to read-only address 0x%lx\n", (unsigned long)(uintptr_t)info->si_addr);
+        abort();
+    }
+
+    simMmioObj.pending = window;
+    simMmioObj.pendingOffset = (uint32_t)((uintptr_t)info->si_addr - window->address);
+    simMmioObj.snapshotOffset = simMmioObj.pendingOffset & ~(uint32_t)(SIM_MMIO_SNAPSHOT_SIZE / 2U - 1U);
+    simMmioObj.snapshotSize = window->size - simMmioObj.snapshotOffset;
+    if (simMmioObj.snapshotSize > SIM_MMIO_SNAPSHOT_SIZE)
+    {
+        simMmioObj.snapshotSize = SIM_MMIO_SNAPSHOT_SIZE;
+    }
+    memcpy(simMmioObj.snapshot, &window->alias[simMmioObj.snapshotOffset], simMmioObj.snapshotSize);
+    (void)mprotect((void*)window->address, window->size, PROT_READ | PROT_WRITE);
+    context->uc_mcontext.gregs[REG_EFL] |= SIM_MMIO_EFLAGS_TF;
+}
+
+static void SIM_MMIO_StepHandler( int signal, siginfo_t* info, void* data )
+{
+    ucontext_t* context = (ucontext_t*)data;
+    SIM_MMIO_WINDOW* window = simMmioObj.pending;
+    uint32_t offset = simMmioObj.pendingOffset;
+    uint64_t value = 0U;
+    size_t length = sizeof(value);
+
+    (void)info;
+
+    if (window == NULL)
+    {
+        SIM_MMIO_DefaultRestore(signal);
+        return;
+    }
+    context->uc_mcontext.gregs[REG_EFL] &= ~(greg_t)SIM_MMIO_EFLAGS_TF;
+
+    if ((offset + length) > window->size)
+    {
+        length = window->size - offset;
+    }
+    memcpy(&value, &window->alias[offset], length);
+    memcpy(&window->alias[simMmioObj.snapshotOffset], simMmioObj.snapshot, simMmioObj.snapshotSize);
+    (void)mprotect((void*)window->address, window->size, PROT_READ);
+    simMmioObj.pending = NULL;
+
+    window->handler(window->context, offset, value);
+}
+
+static bool SIM_MMIO_Install( void )
+{
+    struct sigaction action;
+
+    if (simMmioObj.isInstalled)
+    {
+        return true;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_flags = SA_SIGINFO;
+    (void)sigemptyset(&action.sa_mask);
+
+    action.sa_sigaction = SIM_MMIO_FaultHandler;
+    if (sigaction(SIGSEGV, &action, NULL) != 0)
+    {
+        return false;
+    }
+    action.sa_sigaction = SIM_MMIO_StepHandler;
+    if (sigaction(SIGTRAP, &action, NULL) != 0)
+    {
+        return false;
+    }
+    simMmioObj.isInstalled = true;
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void* SIM_MMIO_WindowMap( uintptr_t address, size_t size,
+                          SIM_MMIO_WRITE_HANDLER handler, uintptr_t context )
+{
+#if defined(__linux__) && defined(__x86_64__)
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    SIM_MMIO_WINDOW* window = SIM_MMIO_WindowFind(address);
+    void* view;
+    void* alias;
+    int fd;
+
+    size = (size + pageSize - 1U) & ~(pageSize - 1U);
+    if (window != NULL)
+    {
+        if ((window->address != address) || (window->size != size))
+        {
+            return NULL;
+        }
+        window->handler = handler;
+        window->context = context;
+        memset(window->alias, 0, window->size);
+        return window->alias;
+    }
+
+    if (((address & (pageSize - 1U)) != 0U) || (size > SIM_MMIO_WINDOW_SIZE_MAX) ||
+        (simMmioObj.windowsNumber >= SIM_MMIO_WINDOWS_NUMBER) || !SIM_MMIO_Install())
+    {
+        return NULL;
+    }
+
+    fd = memfd_create("sim_mmio", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        (void)close(fd);
+        return NULL;
+    }
+    view = mmap((void*)address, size, PROT_READ, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+    if (view != (void*)address)
+    {
+        if (view != MAP_FAILED)
+        {
+            /* An older kernel took the address as a hint only */
+            (void)munmap(view, size);
+        }
+        (void)close(fd);
+        return NULL;
+    }
+    alias = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (alias == MAP_FAILED)
+    {
+        (void)munmap(view, size);
+        return NULL;
+    }
+
+    window = &simMmioObj.windows[simMmioObj.windowsNumber++];
+    window->address = address;
+    window->size = size;
+    window->alias = alias;
+    window->handler = handler;
+    window->context = context;
+    return alias;
+#else
+    (void)address;
+    (void)size;
+    (void)handler;
+    (void)context;
+    return NULL;
+#endif
+}
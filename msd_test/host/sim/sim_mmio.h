@@ -0,0 +1,115 @@
+/*******************************************************************************
+  Simulated Memory Mapped Registers Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_mmio.h
+
+  Summary
+    Maps register windows at the addresses of the target.
+
+  Description
+    The drivers that access their peripheral through its registers, such as
+    DRV_USBFSV1, run unmodified on the host on top of a window mapped at the
+    address the device header gives the peripheral. Reads see the content
+    of the window. Writes call the peripheral model, which decides what the
+    registers hold afterwards: a write-one-to-clear flag register, a
+    set/clear register pair or a register that starts an operation behaves
+    as on the target.
+
+    A window is mapped read-only. A write faults; the fault handler lets
+    the instruction run once with the window writable and single-steps over
+    it, then restores the window and passes the written value to the model.
+    No instruction is decoded, so read-modify-write instructions and string
+    instructions work as they are.
+
+    This needs the addresses of the target to be free in the host process,
+    a non position independent executable, and x86-64 Linux.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_MMIO_H
+#define SIM_MMIO_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Largest window, in bytes: a flash bank */
+#define SIM_MMIO_WINDOW_SIZE_MAX    (0x100000U)
+
+/* Called after each write to a window, with the offset of the first byte
+   written and the 8 bytes the window held from there on after the write,
+   little endian. The window holds its content from before the write again
+   when the handler runs: the handler masks the value to the width of the
+   register and updates the window through the alias SIM_MMIO_WindowMap
+   returned. */
+typedef void (*SIM_MMIO_WRITE_HANDLER)( uintptr_t context, uint32_t offset, uint64_t value );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Maps a zeroed window of size bytes at the page aligned address, or finds
+   the window mapped there by an earlier call and zeroes it. A NULL handler
+   makes the window read-only memory: a write to it aborts. Returns the
+   writable alias of the window, or NULL if the address is not free or the
+   host does not support windows. */
+void* SIM_MMIO_WindowMap( uintptr_t address, size_t size,
+                          SIM_MMIO_WRITE_HANDLER handler, uintptr_t context );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_MMIO_H
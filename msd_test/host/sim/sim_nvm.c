@@ -0,0 +1,209 @@
+/*******************************************************************************
+  Simulated Internal Flash Volumes
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_nvm.c
+
+  Summary
+    DRV_FLASH and DRV_UF2 stand-ins of the host build.
+
+  Description
+    The internal flash disk and the UF2 update volume program the NVMCTRL.
+    In the USB builds these functions take the place of drv_flash.c and
+    drv_uf2.c with a medium that is never attached, so their MSD LUNs answer
+    as an empty drive and the other LUNs run as on the target. The drivers
+    themselves are tested on the simulated NVMCTRL, by test_flash and
+    test_uf2.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Handle of the single client, the driver index plus one */
+#define SIM_NVM_HANDLE(index)       ((DRV_HANDLE)(index) + 1U)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: DRV_FLASH Functions
+// *****************************************************************************
+// *****************************************************************************
+
+SYS_MODULE_OBJ DRV_FLASH_Initialize ( const SYS_MODULE_INDEX drvIndex, const SYS_MODULE_INIT * const init )
+{
+    return (SYS_MODULE_OBJ)drvIndex;
+}
+
+SYS_STATUS DRV_FLASH_Status ( SYS_MODULE_OBJ object )
+{
+    return SYS_STATUS_READY;
+}
+
+void DRV_FLASH_Tasks ( SYS_MODULE_OBJ object )
+{
+}
+
+bool DRV_FLASH_IsBusy ( SYS_MODULE_OBJ object )
+{
+    return false;
+}
+
+DRV_HANDLE DRV_FLASH_Open ( const SYS_MODULE_INDEX drvIndex, const DRV_IO_INTENT ioIntent )
+{
+    return SIM_NVM_HANDLE(drvIndex);
+}
+
+void DRV_FLASH_Close ( DRV_HANDLE handle )
+{
+}
+
+void DRV_FLASH_AsyncRead ( const DRV_HANDLE handle, DRV_FLASH_COMMAND_HANDLE * commandHandle,
+        void * targetBuffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    if (commandHandle != NULL)
+    {
+        *commandHandle = DRV_FLASH_COMMAND_HANDLE_INVALID;
+    }
+}
+
+void DRV_FLASH_AsyncWrite ( const DRV_HANDLE handle, DRV_FLASH_COMMAND_HANDLE * commandHandle,
+        void * sourceBuffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    if (commandHandle != NULL)
+    {
+        *commandHandle = DRV_FLASH_COMMAND_HANDLE_INVALID;
+    }
+}
+
+SYS_MEDIA_GEOMETRY * DRV_FLASH_GeometryGet ( const DRV_HANDLE handle )
+{
+    return NULL;
+}
+
+void DRV_FLASH_EventHandlerSet ( const DRV_HANDLE handle, const void * eventHandler, const uintptr_t context )
+{
+}
+
+bool DRV_FLASH_IsAttached ( const DRV_HANDLE handle )
+{
+    return false;
+}
+
+bool DRV_FLASH_IsWriteProtected ( const DRV_HANDLE handle )
+{
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: DRV_UF2 Functions
+// *****************************************************************************
+// *****************************************************************************
+
+SYS_MODULE_OBJ DRV_UF2_Initialize ( const SYS_MODULE_INDEX drvIndex, const SYS_MODULE_INIT * const init )
+{
+    return (SYS_MODULE_OBJ)drvIndex;
+}
+
+SYS_STATUS DRV_UF2_Status ( SYS_MODULE_OBJ object )
+{
+    return SYS_STATUS_READY;
+}
+
+void DRV_UF2_Tasks ( SYS_MODULE_OBJ object )
+{
+}
+
+bool DRV_UF2_IsBusy ( SYS_MODULE_OBJ object )
+{
+    return false;
+}
+
+DRV_UF2_UPDATE_STATE DRV_UF2_UpdateStateGet ( SYS_MODULE_OBJ object )
+{
+    return DRV_UF2_UPDATE_IDLE;
+}
+
+DRV_HANDLE DRV_UF2_Open ( const SYS_MODULE_INDEX drvIndex, const DRV_IO_INTENT ioIntent )
+{
+    return SIM_NVM_HANDLE(drvIndex);
+}
+
+void DRV_UF2_Close ( DRV_HANDLE handle )
+{
+}
+
+void DRV_UF2_AsyncRead ( const DRV_HANDLE handle, DRV_UF2_COMMAND_HANDLE * commandHandle,
+        void * targetBuffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    if (commandHandle != NULL)
+    {
+        *commandHandle = DRV_UF2_COMMAND_HANDLE_INVALID;
+    }
+}
+
+void DRV_UF2_AsyncWrite ( const DRV_HANDLE handle, DRV_UF2_COMMAND_HANDLE * commandHandle,
+        void * sourceBuffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    if (commandHandle != NULL)
+    {
+        *commandHandle = DRV_UF2_COMMAND_HANDLE_INVALID;
+    }
+}
+
+SYS_MEDIA_GEOMETRY * DRV_UF2_GeometryGet ( const DRV_HANDLE handle )
+{
+    return NULL;
+}
+
+void DRV_UF2_EventHandlerSet ( const DRV_HANDLE handle, const void * eventHandler, const uintptr_t context )
+{
+}
+
+bool DRV_UF2_IsAttached ( const DRV_HANDLE handle )
+{
+    return false;
+}
+
+bool DRV_UF2_IsWriteProtected ( const DRV_HANDLE handle )
+{
+    return true;
+}
@@ -0,0 +1,700 @@
+/*******************************************************************************
+  Simulated NVMCTRL and Flash
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_nvmctrl.c
+
+  Summary
+    NVMCTRL register window and flash bank model.
+
+  Description
+    See sim_nvmctrl.h.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stddef.h>
+#include <string.h>
+#include "definitions.h"
+#include "sim_mmio.h"
+#include "sim_nvmctrl.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_NVMCTRL_REGS_SIZE           (4096U)
+
+#define SIM_NVMCTRL_PAGE_SIZE           (512U)
+#define SIM_NVMCTRL_BLOCK_SIZE          (8192U)
+#define SIM_NVMCTRL_QUAD_WORD_SIZE      (16U)
+
+/* The lock regions split the whole flash in 32 */
+#define SIM_NVMCTRL_REGION_SIZE         (FLASH_SIZE / 32U)
+
+#define SIM_NVMCTRL_REG(member)         ((uint32_t)offsetof(nvmctrl_registers_t, member))
+
+/* Window of the SmartEEPROM, a host page */
+#define SIM_NVMCTRL_SEE_WINDOW_SIZE     (4096U)
+
+/* SmartEEPROM fuses of the project: one block per sector, 16-byte pages */
+#define SIM_NVMCTRL_SEE_SBLK            (1U)
+#define SIM_NVMCTRL_SEE_PSZ             (2U)
+
+/* Errors the commands raise */
+#define SIM_NVMCTRL_ERRORS              (NVMCTRL_INTFLAG_ADDRE_Msk | NVMCTRL_INTFLAG_PROGE_Msk | \
+                                         NVMCTRL_INTFLAG_LOCKE_Msk | NVMCTRL_INTFLAG_NVME_Msk)
+
+typedef struct
+{
+    uint8_t* regs;
+
+    uint8_t* flash;
+
+    uint8_t pageBuffer[SIM_NVMCTRL_PAGE_SIZE];
+
+    /* Command in progress, its address and the flags it ends with */
+    uint16_t command;
+
+    uint32_t commandAddress;
+
+    uint16_t commandErrors;
+
+    SIM_CLOCK_EVENT readyEvent;
+
+    /* Window of the SmartEEPROM, and the data its sectors hold */
+    uint8_t* seeprom;
+
+    uint8_t seeData[SIM_NVMCTRL_SEE_SIZE];
+
+    /* SmartEEPROM page buffer and the page it holds */
+    uint8_t seeBuffer[SIM_NVMCTRL_SEE_PAGE_SIZE];
+
+    uint32_t seeBufferPage;
+
+    bool seeLoaded;
+
+    /* Page write or reallocation in progress */
+    bool seeBusy;
+
+    bool seeWriting;
+
+    uint8_t seeWriteData[SIM_NVMCTRL_SEE_PAGE_SIZE];
+
+    uint32_t seeWritePage;
+
+    SIM_CLOCK_EVENT seeEvent;
+
+    uint32_t seeActiveSector;
+
+    /* Page writes in the active sector */
+    uint32_t seeSectorWrites;
+
+    /* SIM_NVMCTRL_PowerLossInject was called, and the bytes of the page
+       written before the power loss */
+    bool powerLossInjected;
+
+    uint32_t powerLossSize;
+
+    bool powerLost;
+
+    uint16_t injectedErrors;
+
+    uint32_t injectedCount;
+
+    SIM_NVMCTRL_STATISTICS statistics;
+
+} SIM_NVMCTRL_OBJ;
+
+static SIM_NVMCTRL_OBJ simNvmctrlObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint16_t SIM_NVMCTRL_Reg16Get( uint32_t offset )
+{
+    uint16_t value;
+
+    memcpy(&value, &simNvmctrlObj.regs[offset], sizeof(value));
+    return value;
+}
+
+static void SIM_NVMCTRL_Reg16Set( uint32_t offset, uint16_t value )
+{
+    memcpy(&simNvmctrlObj.regs[offset], &value, sizeof(value));
+}
+
+static uint32_t SIM_NVMCTRL_Reg32Get( uint32_t offset )
+{
+    uint32_t value;
+
+    memcpy(&value, &simNvmctrlObj.regs[offset], sizeof(value));
+    return value;
+}
+
+static void SIM_NVMCTRL_Reg32Set( uint32_t offset, uint32_t value )
+{
+    memcpy(&simNvmctrlObj.regs[offset], &value, sizeof(value));
+}
+
+/* Sets flags in INTFLAG */
+static void SIM_NVMCTRL_FlagsSet( uint16_t flags )
+{
+    SIM_NVMCTRL_Reg16Set(SIM_NVMCTRL_REG(NVMCTRL_INTFLAG), SIM_NVMCTRL_Reg16Get(SIM_NVMCTRL_REG(NVMCTRL_INTFLAG)) | flags);
+}
+
+/* Erase, write or SmartEEPROM operation in progress */
+static bool SIM_NVMCTRL_IsBusy( void )
+{
+    return (((SIM_NVMCTRL_Reg16Get(SIM_NVMCTRL_REG(NVMCTRL_STATUS)) & NVMCTRL_STATUS_READY_Msk) == 0U) ||
+            simNvmctrlObj.seeBusy);
+}
+
+static void SIM_NVMCTRL_SeeStatusUpdate( void )
+{
+    SIM_NVMCTRL_Reg32Set(SIM_NVMCTRL_REG(NVMCTRL_SEESTAT),
+                         NVMCTRL_SEESTAT_ASEES(simNvmctrlObj.seeActiveSector) |
+                         NVMCTRL_SEESTAT_LOAD(simNvmctrlObj.seeLoaded ? 1U : 0U) |
+                         NVMCTRL_SEESTAT_BUSY(simNvmctrlObj.seeBusy ? 1U : 0U) |
+                         NVMCTRL_SEESTAT_SBLK(SIM_NVMCTRL_SEE_SBLK) | NVMCTRL_SEESTAT_PSZ(SIM_NVMCTRL_SEE_PSZ));
+}
+
+static void SIM_NVMCTRL_PageBufferClear( void )
+{
+    memset(simNvmctrlObj.pageBuffer, 0xFF, sizeof(simNvmctrlObj.pageBuffer));
+}
+
+/* Returns the error flags of a command on size bytes at address */
+static uint16_t SIM_NVMCTRL_AddressCheck( uint32_t address, uint32_t size )
+{
+    if ((address < SIM_NVMCTRL_FLASH_ADDRESS) ||
+        (address >= (SIM_NVMCTRL_FLASH_ADDRESS + SIM_NVMCTRL_FLASH_SIZE)) ||
+        ((address % size) != 0U))
+    {
+        return NVMCTRL_INTFLAG_ADDRE_Msk;
+    }
+    if ((SIM_NVMCTRL_Reg32Get(SIM_NVMCTRL_REG(NVMCTRL_RUNLOCK)) & (1UL << (address / SIM_NVMCTRL_REGION_SIZE))) == 0U)
+    {
+        return NVMCTRL_INTFLAG_LOCKE_Msk;
+    }
+    return 0U;
+}
+
+/* Programs size bytes at address from the page buffer: bits only go from
+   1 to 0 */
+static void SIM_NVMCTRL_Program( uint32_t address, uint32_t size )
+{
+    uint8_t* flash = &simNvmctrlObj.flash[address - SIM_NVMCTRL_FLASH_ADDRESS];
+    const uint8_t* data = &simNvmctrlObj.pageBuffer[address % SIM_NVMCTRL_PAGE_SIZE];
+    uint32_t index;
+
+    for (index = 0U; index < size; index++)
+    {
+        flash[index] &= data[index];
+    }
+}
+
+/* End of an erase or a write */
+static void SIM_NVMCTRL_ReadyHandler( uintptr_t context )
+{
+    uint32_t address = simNvmctrlObj.commandAddress;
+
+    (void)context;
+
+    if (simNvmctrlObj.commandErrors == 0U)
+    {
+        switch (simNvmctrlObj.command)
+        {
+            case NVMCTRL_CTRLB_CMD_EB_Val:
+                memset(&simNvmctrlObj.flash[address - SIM_NVMCTRL_FLASH_ADDRESS], 0xFF, SIM_NVMCTRL_BLOCK_SIZE);
+                break;
+
+            case NVMCTRL_CTRLB_CMD_WP_Val:
+                SIM_NVMCTRL_Program(address, SIM_NVMCTRL_PAGE_SIZE);
+                SIM_NVMCTRL_PageBufferClear();
+                break;
+
+            case NVMCTRL_CTRLB_CMD_WQW_Val:
+                SIM_NVMCTRL_Program(address, SIM_NVMCTRL_QUAD_WORD_SIZE);
+                memset(&simNvmctrlObj.pageBuffer[address % SIM_NVMCTRL_PAGE_SIZE], 0xFF, SIM_NVMCTRL_QUAD_WORD_SIZE);
+                break;
+
+            default:
+                break;
+        }
+    }
+    else
+    {
+        simNvmctrlObj.statistics.errors++;
+    }
+
+    SIM_NVMCTRL_FlagsSet(simNvmctrlObj.commandErrors | NVMCTRL_INTFLAG_DONE_Msk);
+    SIM_NVMCTRL_Reg16Set(SIM_NVMCTRL_REG(NVMCTRL_STATUS),
+                         SIM_NVMCTRL_Reg16Get(SIM_NVMCTRL_REG(NVMCTRL_STATUS)) | NVMCTRL_STATUS_READY_Msk);
+}
+
+/* Starts an erase or a write of size bytes at the address */
+static void SIM_NVMCTRL_Start( uint16_t command, uint32_t address, uint32_t size, SIM_TIME duration )
+{
+    uint16_t errors = SIM_NVMCTRL_AddressCheck(address, size);
+
+    if ((errors == 0U) && (simNvmctrlObj.injectedCount != 0U))
+    {
+        simNvmctrlObj.injectedCount--;
+        errors = simNvmctrlObj.injectedErrors;
+    }
+
+    simNvmctrlObj.command = command;
+    simNvmctrlObj.commandAddress = address;
+    simNvmctrlObj.commandErrors = errors;
+    SIM_NVMCTRL_Reg16Set(SIM_NVMCTRL_REG(NVMCTRL_STATUS),
+                         SIM_NVMCTRL_Reg16Get(SIM_NVMCTRL_REG(NVMCTRL_STATUS)) & (uint16_t)~NVMCTRL_STATUS_READY_Msk);
+
+    /* An address error ends the command at once */
+    SIM_CLOCK_EventSchedule(&simNvmctrlObj.readyEvent,
+                            SIM_CLOCK_Now() + (((errors & NVMCTRL_INTFLAG_ADDRE_Msk) != 0U) ? 0U : duration));
+}
+
+/* Copies the pages that hold data to the other sector */
+static void SIM_NVMCTRL_SeeReallocate( void )
+{
+    static const uint8_t erased[SIM_NVMCTRL_SEE_PAGE_SIZE] =
+    {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+    };
+    uint32_t page;
+
+    simNvmctrlObj.seeSectorWrites = 0U;
+    for (page = 0U; page < (SIM_NVMCTRL_SEE_SIZE / SIM_NVMCTRL_SEE_PAGE_SIZE); page++)
+    {
+        if (memcmp(&simNvmctrlObj.seeData[page * SIM_NVMCTRL_SEE_PAGE_SIZE], erased, sizeof(erased)) != 0)
+        {
+            simNvmctrlObj.seeSectorWrites++;
+        }
+    }
+    simNvmctrlObj.seeActiveSector ^= 1U;
+}
+
+/* Writes the SmartEEPROM page buffer to the active sector */
+static void SIM_NVMCTRL_SeeWriteStart( void )
+{
+    uint32_t pageOffset = simNvmctrlObj.seeBufferPage * SIM_NVMCTRL_SEE_PAGE_SIZE;
+    SIM_TIME duration = SIM_NVMCTRL_SEE_WRITE_TIME;
+
+    simNvmctrlObj.seeLoaded = false;
+
+    if (simNvmctrlObj.seeSectorWrites >= SIM_NVMCTRL_SEE_SECTOR_WRITES)
+    {
+        if ((simNvmctrlObj.regs[SIM_NVMCTRL_REG(NVMCTRL_SEECFG)] & NVMCTRL_SEECFG_APRDIS_Msk) != 0U)
+        {
+            /* The page buffer is lost */
+            memcpy(&simNvmctrlObj.seeprom[pageOffset], &simNvmctrlObj.seeData[pageOffset], SIM_NVMCTRL_SEE_PAGE_SIZE);
+            simNvmctrlObj.statistics.errors++;
+            SIM_NVMCTRL_FlagsSet(NVMCTRL_INTFLAG_SEESOVF_Msk);
+            SIM_NVMCTRL_SeeStatusUpdate();
+            return;
+        }
+
+        simNvmctrlObj.statistics.seeAutoReallocations++;
+        SIM_NVMCTRL_SeeReallocate();
+        duration += SIM_NVMCTRL_SEE_REALLOC_TIME;
+    }
+
+    simNvmctrlObj.statistics.seePageWrites++;
+    memcpy(simNvmctrlObj.seeWriteData, simNvmctrlObj.seeBuffer, SIM_NVMCTRL_SEE_PAGE_SIZE);
+    simNvmctrlObj.seeWritePage = simNvmctrlObj.seeBufferPage;
+    simNvmctrlObj.seeWriting = true;
+    simNvmctrlObj.seeBusy = true;
+    SIM_NVMCTRL_SeeStatusUpdate();
+    SIM_CLOCK_EventSchedule(&simNvmctrlObj.seeEvent, SIM_CLOCK_Now() + duration);
+}
+
+/* End of a SmartEEPROM page write or reallocation */
+static void SIM_NVMCTRL_SeeReadyHandler( uintptr_t context )
+{
+    uint32_t pageOffset = simNvmctrlObj.seeWritePage * SIM_NVMCTRL_SEE_PAGE_SIZE;
+    uint32_t size = SIM_NVMCTRL_SEE_PAGE_SIZE;
+
+    (void)context;
+
+    if (simNvmctrlObj.seeWriting)
+    {
+        simNvmctrlObj.seeWriting = false;
+
+        if (simNvmctrlObj.powerLossInjected)
+        {
+            /* The rest of the page stays erased, and the NVMCTRL is off */
+            size = simNvmctrlObj.powerLossSize;
+            memset(&simNvmctrlObj.seeData[pageOffset], 0xFF, SIM_NVMCTRL_SEE_PAGE_SIZE);
+            simNvmctrlObj.powerLossInjected = false;
+            simNvmctrlObj.powerLost = true;
+            simNvmctrlObj.statistics.powerLosses++;
+        }
+        memcpy(&simNvmctrlObj.seeData[pageOffset], simNvmctrlObj.seeWriteData, size);
+
+        if (simNvmctrlObj.powerLost)
+        {
+            return;
+        }
+
+        simNvmctrlObj.seeSectorWrites++;
+        if (simNvmctrlObj.seeSectorWrites == SIM_NVMCTRL_SEE_SECTOR_WRITES)
+        {
+            SIM_NVMCTRL_FlagsSet(NVMCTRL_INTFLAG_SEESFULL_Msk);
+        }
+        SIM_NVMCTRL_FlagsSet(NVMCTRL_INTFLAG_SEEWRC_Msk);
+    }
+
+    simNvmctrlObj.seeBusy = false;
+    SIM_NVMCTRL_SeeStatusUpdate();
+}
+
+static void SIM_NVMCTRL_Command( uint16_t value )
+{
+    uint16_t command = (uint16_t)((value & NVMCTRL_CTRLB_CMD_Msk) >> NVMCTRL_CTRLB_CMD_Pos);
+    uint32_t address = SIM_NVMCTRL_Reg32Get(SIM_NVMCTRL_REG(NVMCTRL_ADDR));
+    uint32_t unlocked = SIM_NVMCTRL_Reg32Get(SIM_NVMCTRL_REG(NVMCTRL_RUNLOCK));
+    uint32_t region;
+
+    if ((value & NVMCTRL_CTRLB_CMDEX_Msk) != NVMCTRL_CTRLB_CMDEX_KEY)
+    {
+        return;
+    }
+    if (SIM_NVMCTRL_IsBusy())
+    {
+        simNvmctrlObj.statistics.busyCommands++;
+        simNvmctrlObj.statistics.errors++;
+        SIM_NVMCTRL_FlagsSet(NVMCTRL_INTFLAG_PROGE_Msk);
+        return;
+    }
+
+    switch (command)
+    {
+        case NVMCTRL_CTRLB_CMD_EB_Val:
+            simNvmctrlObj.statistics.blockErases++;
+            SIM_NVMCTRL_Start(command, address & ~(SIM_NVMCTRL_BLOCK_SIZE - 1U), SIM_NVMCTRL_BLOCK_SIZE,
+                              SIM_NVMCTRL_ERASE_TIME);
+            break;
+
+        case NVMCTRL_CTRLB_CMD_WP_Val:
+            simNvmctrlObj.statistics.pageWrites++;
+            SIM_NVMCTRL_Start(command, address & ~(SIM_NVMCTRL_PAGE_SIZE - 1U), SIM_NVMCTRL_PAGE_SIZE,
+                              SIM_NVMCTRL_WRITE_TIME);
+            break;
+
+        case NVMCTRL_CTRLB_CMD_WQW_Val:
+            simNvmctrlObj.statistics.quadWordWrites++;
+            SIM_NVMCTRL_Start(command, address & ~(SIM_NVMCTRL_QUAD_WORD_SIZE - 1U), SIM_NVMCTRL_QUAD_WORD_SIZE,
+                              SIM_NVMCTRL_WRITE_TIME);
+            break;
+
+        case NVMCTRL_CTRLB_CMD_PBC_Val:
+            SIM_NVMCTRL_PageBufferClear();
+            SIM_NVMCTRL_FlagsSet(NVMCTRL_INTFLAG_DONE_Msk);
+            break;
+
+        case NVMCTRL_CTRLB_CMD_LR_Val:
+        case NVMCTRL_CTRLB_CMD_UR_Val:
+            region = (address % FLASH_SIZE) / SIM_NVMCTRL_REGION_SIZE;
+            if (command == NVMCTRL_CTRLB_CMD_LR_Val)
+            {
+                unlocked &= ~(1UL << region);
+            }
+            else
+            {
+                unlocked |= (1UL << region);
+            }
+            SIM_NVMCTRL_Reg32Set(SIM_NVMCTRL_REG(NVMCTRL_RUNLOCK), unlocked);
+            SIM_NVMCTRL_FlagsSet(NVMCTRL_INTFLAG_DONE_Msk);
+            break;
+
+        case NVMCTRL_CTRLB_CMD_BKSWRST_Val:
+            simNvmctrlObj.statistics.bankSwaps++;
+            break;
+
+        case NVMCTRL_CTRLB_CMD_SEEFLUSH_Val:
+            if (simNvmctrlObj.seeLoaded)
+            {
+                SIM_NVMCTRL_SeeWriteStart();
+            }
+            SIM_NVMCTRL_FlagsSet(NVMCTRL_INTFLAG_DONE_Msk);
+            break;
+
+        case NVMCTRL_CTRLB_CMD_SEERALOC_Val:
+            simNvmctrlObj.statistics.seeReallocations++;
+            SIM_NVMCTRL_SeeReallocate();
+            simNvmctrlObj.seeBusy = true;
+            SIM_NVMCTRL_SeeStatusUpdate();
+            SIM_CLOCK_EventSchedule(&simNvmctrlObj.seeEvent, SIM_CLOCK_Now() + SIM_NVMCTRL_SEE_REALLOC_TIME);
+            SIM_NVMCTRL_FlagsSet(NVMCTRL_INTFLAG_DONE_Msk);
+            break;
+
+        default:
+            /* Other SmartEEPROM, security and power commands */
+            SIM_NVMCTRL_FlagsSet(NVMCTRL_INTFLAG_DONE_Msk);
+            break;
+    }
+}
+
+static void SIM_NVMCTRL_RegisterWrite( uintptr_t context, uint32_t offset, uint64_t value )
+{
+    uint16_t enabled = SIM_NVMCTRL_Reg16Get(SIM_NVMCTRL_REG(NVMCTRL_INTENSET));
+
+    (void)context;
+
+    if (simNvmctrlObj.powerLost)
+    {
+        return;
+    }
+
+    switch (offset)
+    {
+        case SIM_NVMCTRL_REG(NVMCTRL_CTRLA):
+            SIM_NVMCTRL_Reg16Set(offset, (uint16_t)value);
+            break;
+
+        case SIM_NVMCTRL_REG(NVMCTRL_CTRLB):
+            SIM_NVMCTRL_Command((uint16_t)value);
+            break;
+
+        case SIM_NVMCTRL_REG(NVMCTRL_INTENCLR):
+        case SIM_NVMCTRL_REG(NVMCTRL_INTENSET):
+            /* Both read as the enabled interrupts */
+            if (offset == SIM_NVMCTRL_REG(NVMCTRL_INTENCLR))
+            {
+                enabled &= (uint16_t)~value;
+            }
+            else
+            {
+                enabled |= (uint16_t)value;
+            }
+            SIM_NVMCTRL_Reg16Set(SIM_NVMCTRL_REG(NVMCTRL_INTENCLR), enabled);
+            SIM_NVMCTRL_Reg16Set(SIM_NVMCTRL_REG(NVMCTRL_INTENSET), enabled);
+            break;
+
+        case SIM_NVMCTRL_REG(NVMCTRL_INTFLAG):
+            SIM_NVMCTRL_Reg16Set(offset, SIM_NVMCTRL_Reg16Get(offset) & (uint16_t)~value);
+            break;
+
+        case SIM_NVMCTRL_REG(NVMCTRL_ADDR):
+            SIM_NVMCTRL_Reg32Set(offset, (uint32_t)value & 0x00FFFFFFU);
+            break;
+
+        case SIM_NVMCTRL_REG(NVMCTRL_DBGCTRL):
+        case SIM_NVMCTRL_REG(NVMCTRL_SEECFG):
+            simNvmctrlObj.regs[offset] = (uint8_t)value;
+            break;
+
+        default:
+            /* Read-only */
+            break;
+    }
+}
+
+/* A write to the flash loads a word of the page buffer, or writes the
+   word, quad word or page in the automatic write modes */
+static void SIM_NVMCTRL_FlashWrite( uintptr_t context, uint32_t offset, uint64_t value )
+{
+    uint32_t address = SIM_NVMCTRL_FLASH_ADDRESS + (offset & ~3U);
+    uint32_t word = (uint32_t)value;
+    uint32_t unitSize;
+
+    (void)context;
+
+    if (simNvmctrlObj.powerLost)
+    {
+        return;
+    }
+
+    memcpy(&simNvmctrlObj.pageBuffer[address % SIM_NVMCTRL_PAGE_SIZE], &word, sizeof(word));
+    SIM_NVMCTRL_Reg32Set(SIM_NVMCTRL_REG(NVMCTRL_ADDR), address);
+
+    switch (SIM_NVMCTRL_Reg16Get(SIM_NVMCTRL_REG(NVMCTRL_CTRLA)) & NVMCTRL_CTRLA_WMODE_Msk)
+    {
+        case NVMCTRL_CTRLA_WMODE_ADW:   unitSize = 8U;                              break;
+        case NVMCTRL_CTRLA_WMODE_AQW:   unitSize = SIM_NVMCTRL_QUAD_WORD_SIZE;      break;
+        case NVMCTRL_CTRLA_WMODE_AP:    unitSize = SIM_NVMCTRL_PAGE_SIZE;           break;
+        default:                        unitSize = 0U;                              break;
+    }
+
+    if ((unitSize != 0U) && (((address + 4U) % unitSize) == 0U))
+    {
+        if (unitSize == SIM_NVMCTRL_PAGE_SIZE)
+        {
+            SIM_NVMCTRL_Command(NVMCTRL_CTRLB_CMD_WP | NVMCTRL_CTRLB_CMDEX_KEY);
+        }
+        else
+        {
+            /* The flash writes quad words: a double word leaves the other
+               half of its quad word erased in the page buffer */
+            SIM_NVMCTRL_Command(NVMCTRL_CTRLB_CMD_WQW | NVMCTRL_CTRLB_CMDEX_KEY);
+        }
+    }
+}
+
+/* A write to the SmartEEPROM loads its page buffer, and writes the page
+   the buffer held before in buffered mode, or the page written in
+   unbuffered mode */
+static void SIM_NVMCTRL_SmartEEPROMWrite( uintptr_t context, uint32_t offset, uint64_t value )
+{
+    uint32_t word = (uint32_t)value;
+    uint32_t page;
+
+    (void)context;
+
+    offset &= ~3U;
+    if (simNvmctrlObj.powerLost || (offset >= SIM_NVMCTRL_SEE_SIZE))
+    {
+        return;
+    }
+    if (SIM_NVMCTRL_IsBusy())
+    {
+        /* The CPU waits on the target: the firmware checks SEESTAT.BUSY */
+        simNvmctrlObj.statistics.busyCommands++;
+        simNvmctrlObj.statistics.errors++;
+        SIM_NVMCTRL_FlagsSet(NVMCTRL_INTFLAG_PROGE_Msk);
+        return;
+    }
+
+    page = offset / SIM_NVMCTRL_SEE_PAGE_SIZE;
+    if (simNvmctrlObj.seeLoaded && (simNvmctrlObj.seeBufferPage != page))
+    {
+        SIM_NVMCTRL_SeeWriteStart();
+    }
+    if (simNvmctrlObj.seeLoaded == false)
+    {
+        memcpy(simNvmctrlObj.seeBuffer, &simNvmctrlObj.seeprom[page * SIM_NVMCTRL_SEE_PAGE_SIZE],
+               SIM_NVMCTRL_SEE_PAGE_SIZE);
+        simNvmctrlObj.seeBufferPage = page;
+        simNvmctrlObj.seeLoaded = true;
+    }
+
+    memcpy(&simNvmctrlObj.seeBuffer[offset % SIM_NVMCTRL_SEE_PAGE_SIZE], &word, sizeof(word));
+    memcpy(&simNvmctrlObj.seeprom[offset], &word, sizeof(word));
+
+    if ((simNvmctrlObj.regs[SIM_NVMCTRL_REG(NVMCTRL_SEECFG)] & NVMCTRL_SEECFG_WMODE_Msk) == NVMCTRL_SEECFG_WMODE_UNBUFFERED)
+    {
+        SIM_NVMCTRL_SeeWriteStart();
+    }
+    else
+    {
+        SIM_NVMCTRL_SeeStatusUpdate();
+    }
+}
+
+/* Registers and SmartEEPROM state at power on */
+static void SIM_NVMCTRL_Reset( void )
+{
+    memset(simNvmctrlObj.regs, 0, SIM_NVMCTRL_REGS_SIZE);
+    SIM_NVMCTRL_PageBufferClear();
+    simNvmctrlObj.seeLoaded = false;
+    simNvmctrlObj.seeBusy = false;
+    simNvmctrlObj.seeWriting = false;
+    simNvmctrlObj.powerLossInjected = false;
+    simNvmctrlObj.powerLost = false;
+    memcpy(simNvmctrlObj.seeprom, simNvmctrlObj.seeData, SIM_NVMCTRL_SEE_SIZE);
+
+    /* 512-byte pages, with the SmartEEPROM of the device */
+    SIM_NVMCTRL_Reg32Set(SIM_NVMCTRL_REG(NVMCTRL_PARAM),
+                         NVMCTRL_PARAM_NVMP(FLASH_SIZE / SIM_NVMCTRL_PAGE_SIZE) | NVMCTRL_PARAM_PSZ(3U) |
+                         NVMCTRL_PARAM_SEE_Msk);
+    SIM_NVMCTRL_Reg16Set(SIM_NVMCTRL_REG(NVMCTRL_STATUS), NVMCTRL_STATUS_READY_Msk | NVMCTRL_STATUS_AFIRST_Msk);
+    SIM_NVMCTRL_Reg32Set(SIM_NVMCTRL_REG(NVMCTRL_RUNLOCK), 0xFFFFFFFFU);
+    SIM_NVMCTRL_SeeStatusUpdate();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+bool SIM_NVMCTRL_Initialize( void )
+{
+    memset(&simNvmctrlObj, 0, sizeof(simNvmctrlObj));
+
+    simNvmctrlObj.regs = SIM_MMIO_WindowMap((uintptr_t)NVMCTRL_REGS, SIM_NVMCTRL_REGS_SIZE,
+                                            SIM_NVMCTRL_RegisterWrite, 0U);
+    simNvmctrlObj.flash = SIM_MMIO_WindowMap(SIM_NVMCTRL_FLASH_ADDRESS, SIM_NVMCTRL_FLASH_SIZE,
+                                             SIM_NVMCTRL_FlashWrite, 0U);
+    simNvmctrlObj.seeprom = SIM_MMIO_WindowMap(SEEPROM_ADDR, SIM_NVMCTRL_SEE_WINDOW_SIZE,
+                                               SIM_NVMCTRL_SmartEEPROMWrite, 0U);
+    if ((simNvmctrlObj.regs == NULL) || (simNvmctrlObj.flash == NULL) || (simNvmctrlObj.seeprom == NULL))
+    {
+        return false;
+    }
+
+    memset(simNvmctrlObj.flash, 0xFF, SIM_NVMCTRL_FLASH_SIZE);
+    memset(simNvmctrlObj.seeprom, 0xFF, SIM_NVMCTRL_SEE_WINDOW_SIZE);
+    memset(simNvmctrlObj.seeData, 0xFF, sizeof(simNvmctrlObj.seeData));
+    SIM_CLOCK_EventInitialize(&simNvmctrlObj.readyEvent, SIM_CLOCK_SOURCE_NONE, SIM_NVMCTRL_ReadyHandler, 0U);
+    SIM_CLOCK_EventInitialize(&simNvmctrlObj.seeEvent, SIM_CLOCK_SOURCE_NONE, SIM_NVMCTRL_SeeReadyHandler, 0U);
+    SIM_NVMCTRL_Reset();
+    return true;
+}
+
+void SIM_NVMCTRL_ErrorInject( uint16_t flags, uint32_t count )
+{
+    simNvmctrlObj.injectedErrors = flags & (uint16_t)SIM_NVMCTRL_ERRORS;
+    simNvmctrlObj.injectedCount = count;
+}
+
+void SIM_NVMCTRL_PowerLossInject( uint32_t size )
+{
+    simNvmctrlObj.powerLossSize = (size < SIM_NVMCTRL_SEE_PAGE_SIZE) ? size : SIM_NVMCTRL_SEE_PAGE_SIZE;
+    simNvmctrlObj.powerLossInjected = true;
+}
+
+void SIM_NVMCTRL_PowerOn( void )
+{
+    SIM_CLOCK_EventCancel(&simNvmctrlObj.readyEvent);
+    SIM_CLOCK_EventCancel(&simNvmctrlObj.seeEvent);
+    SIM_NVMCTRL_Reset();
+}
+
+void SIM_NVMCTRL_StatisticsGet( SIM_NVMCTRL_STATISTICS* statistics )
+{
+    *statistics = simNvmctrlObj.statistics;
+}
+
+void SIM_NVMCTRL_StatisticsReset( void )
+{
+    memset(&simNvmctrlObj.statistics, 0, sizeof(simNvmctrlObj.statistics));
+}
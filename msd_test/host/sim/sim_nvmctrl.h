@@ -0,0 +1,197 @@
+/*******************************************************************************
+  Simulated NVMCTRL and Flash Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_nvmctrl.h
+
+  Summary
+    NVMCTRL registers of the host build, with the flash bank and the
+    SmartEEPROM behind them.
+
+  Description
+    The NVMCTRL registers and the upper flash bank are SIM_MMIO windows at
+    their target addresses, so plib_nvmctrl.c and the drivers on top of it
+    run unmodified:
+    - The flash bank reads as memory. A write to it loads the page buffer
+      and the ADDR register, as on the target. The page buffer takes 32-bit
+      writes only.
+    - The CTRLB commands erase a block (EB), write the page buffer to a page
+      (WP) or a quad word (WQW), clear the page buffer (PBC), lock and
+      unlock the regions (LR, UR) and swap the banks (BKSWRST). A write
+      only clears bits, as on the flash, so a page that was not erased
+      reads as the AND of its contents.
+    - Each erase and write keeps STATUS.READY low for its virtual time and
+      changes the flash when it ends. A command given while the NVMCTRL is
+      busy is dropped and raises PROGE.
+    - A command outside the bank, where the firmware runs on the target,
+      raises ADDRE, and a command in a locked region raises LOCKE.
+    - The next erases and writes fail with SIM_NVMCTRL_ErrorInject.
+    - BKSWRST resets the device on the target. It is counted, and the
+      firmware runs on.
+
+    The SmartEEPROM is enabled as by the fuses of the project, one block per
+    sector and 16-byte pages, and is a window at SEEPROM_ADDR:
+    - It reads as memory, with the data of the page buffer. It takes 32-bit
+      writes only.
+    - A write loads the SmartEEPROM page buffer. In buffered mode the page
+      is written by SEEFLUSH or by a write to another page, in unbuffered
+      mode by each write. A page write keeps SEESTAT.BUSY high for its
+      virtual time.
+    - The active sector takes SIM_NVMCTRL_SEE_SECTOR_WRITES page writes,
+      less the pages that hold data, then INTFLAG.SEESFULL is set. SEERALOC
+      copies the pages to the other sector. A write to a full sector
+      reallocates it first, or raises SEESOVF if SEECFG.APRDIS is set.
+    - SIM_NVMCTRL_PowerLossInject cuts a page write short, as a power loss
+      does. SIM_NVMCTRL_PowerOn starts the NVMCTRL again with the flash and
+      the SmartEEPROM as they were left.
+
+    The lower bank is not modeled, nor are the SmartEEPROM sectors in the
+    flash: the SmartEEPROM is kept apart from the bank.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_NVMCTRL_H
+#define SIM_NVMCTRL_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim_clock.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Modeled flash: the upper bank */
+#define SIM_NVMCTRL_FLASH_ADDRESS       (0x80000U)
+#define SIM_NVMCTRL_FLASH_SIZE          (0x80000U)
+
+/* Busy time of a block erase and of a page or quad word write */
+#define SIM_NVMCTRL_ERASE_TIME          SIM_TIME_MS(4)
+#define SIM_NVMCTRL_WRITE_TIME          SIM_TIME_US(800)
+
+/* Modeled SmartEEPROM and its page size */
+#define SIM_NVMCTRL_SEE_SIZE            (512U)
+#define SIM_NVMCTRL_SEE_PAGE_SIZE       (16U)
+
+/* Page writes an active sector takes */
+#define SIM_NVMCTRL_SEE_SECTOR_WRITES   (256U)
+
+/* Busy time of a SmartEEPROM page write and of a sector reallocation */
+#define SIM_NVMCTRL_SEE_WRITE_TIME      SIM_TIME_US(800)
+#define SIM_NVMCTRL_SEE_REALLOC_TIME    SIM_TIME_MS(20)
+
+// *****************************************************************************
+/* Simulator statistics
+
+  Summary:
+    Counters since SIM_NVMCTRL_Initialize or SIM_NVMCTRL_StatisticsReset.
+*/
+
+typedef struct
+{
+    uint32_t blockErases;
+
+    uint32_t pageWrites;
+
+    uint32_t quadWordWrites;
+
+    uint32_t bankSwaps;
+
+    /* Commands that ended with an error flag, injected or not */
+    uint32_t errors;
+
+    /* Commands given while the NVMCTRL was busy */
+    uint32_t busyCommands;
+
+    uint32_t seePageWrites;
+
+    /* SEERALOC commands, and reallocations of a write to a full sector */
+    uint32_t seeReallocations;
+
+    uint32_t seeAutoReallocations;
+
+    /* Page writes cut by SIM_NVMCTRL_PowerLossInject */
+    uint32_t powerLosses;
+
+} SIM_NVMCTRL_STATISTICS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Maps the windows, erases the bank and resets the registers. Call it after
+   SIM_CLOCK_Initialize and before NVMCTRL_Initialize. Returns false if the
+   windows cannot be mapped. */
+bool SIM_NVMCTRL_Initialize( void );
+
+/* The next count block erases and page or quad word writes end with the
+   error flags, typically NVMCTRL_INTFLAG_PROGE_Msk, and leave the flash
+   as it was */
+void SIM_NVMCTRL_ErrorInject( uint16_t flags, uint32_t count );
+
+/* The next SmartEEPROM page write is cut by a power loss once size bytes
+   of the page are written: the rest of the page reads as erased. The
+   NVMCTRL then ignores the firmware until SIM_NVMCTRL_PowerOn. */
+void SIM_NVMCTRL_PowerLossInject( uint32_t size );
+
+/* Resets the NVMCTRL as at power on. The flash and the SmartEEPROM keep
+   their data, the page buffers and a command in progress are lost. Call
+   NVMCTRL_Initialize after it. */
+void SIM_NVMCTRL_PowerOn( void );
+
+void SIM_NVMCTRL_StatisticsGet( SIM_NVMCTRL_STATISTICS* statistics );
+
+void SIM_NVMCTRL_StatisticsReset( void );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_NVMCTRL_H
@@ -0,0 +1,159 @@
+/*******************************************************************************
+  Simulated RTOS Core
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_rtos.c
+
+  Summary
+    Interrupt state, time and core instructions of the FreeRTOS host build.
+
+  Description
+    See sim_rtos.h. The interrupt state is the one of the calling task, as
+    the signal mask the POSIX port uses for its critical sections is the one
+    of the calling thread.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "system/int/sys_int.h"
+#include "system/time/sys_time.h"
+#include "sim_rtos.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Time SIM_RTOS_WaitForInterrupt sleeps, a tenth of a tick */
+#define SIM_RTOS_WAIT_NS            (100000L)
+
+static __thread bool simRtosIsInterrupt;
+
+static __thread bool simRtosInterruptsDisabled;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SIM_RTOS_InterruptEnter( void )
+{
+    simRtosIsInterrupt = true;
+}
+
+void SIM_RTOS_InterruptLeave( void )
+{
+    simRtosIsInterrupt = false;
+}
+
+bool SIM_RTOS_IsInterrupt( void )
+{
+    return simRtosIsInterrupt;
+}
+
+void SIM_RTOS_WaitForInterrupt( void )
+{
+    struct timespec wait = { .tv_sec = 0, .tv_nsec = SIM_RTOS_WAIT_NS };
+
+    (void)nanosleep(&wait, NULL);
+}
+
+void SIM_RTOS_AssertFailed( const char* file, unsigned long line )
+{
+    fprintf(stderr, "configASSERT failed at %s:%lu\n", file, line);
+    fflush(stderr);
+    abort();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SYS_INT Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_INT_Enable( void )
+{
+    simRtosInterruptsDisabled = false;
+    portENABLE_INTERRUPTS();
+}
+
+bool SYS_INT_Disable( void )
+{
+    bool state = !simRtosInterruptsDisabled;
+
+    portDISABLE_INTERRUPTS();
+    simRtosInterruptsDisabled = true;
+    return state;
+}
+
+void SYS_INT_Restore( bool state )
+{
+    if (state)
+    {
+        SYS_INT_Enable();
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SYS_TIME Counter Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+uint64_t SYS_TIME_Counter64Get( void )
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * SIM_RTOS_COUNTER_FREQUENCY) +
+           (((uint64_t)now.tv_nsec * (SIM_RTOS_COUNTER_FREQUENCY / 1000000U)) / 1000U);
+}
+
+uint32_t SYS_TIME_CounterGet( void )
+{
+    return (uint32_t)SYS_TIME_Counter64Get();
+}
+
+uint32_t SYS_TIME_FrequencyGet( void )
+{
+    return SIM_RTOS_COUNTER_FREQUENCY;
+}
@@ -0,0 +1,113 @@
+/*******************************************************************************
+  Simulated RTOS Core Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_rtos.h
+
+  Summary
+    Interrupt state, time and core instructions of the FreeRTOS host build.
+
+  Description
+    The FreeRTOS tests of the host build run the tasks of SYS_SCHED as
+    threads of the POSIX port of FreeRTOS, in real time. The tick of the
+    port is the only interrupt: SYS_INT_Disable and SYS_INT_Restore mask it
+    as the critical sections of the port do, and SYS_TIME_CounterGet counts
+    the monotonic clock of the host at the frequency of the target TC0
+    counter.
+
+    A test task stands for an interrupt handler between
+    SIM_RTOS_InterruptEnter and SIM_RTOS_InterruptLeave, so that the
+    firmware it calls takes its interrupt paths, such as the FromISR calls
+    of SYS_SCHED_EventPost.
+
+    The build includes this file ahead of sys_sched.c, whose instructions
+    of the Cortex-M core it replaces.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_RTOS_H
+#define SIM_RTOS_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Frequency of the SYS_TIME counter, as on the target */
+#define SIM_RTOS_COUNTER_FREQUENCY      (60000000U)
+
+/* Core instructions of SYS_SCHED */
+#define SYS_SCHED_IS_INTERRUPT()        SIM_RTOS_IsInterrupt()
+#define SYS_SCHED_WAIT_FOR_INTERRUPT()  SIM_RTOS_WaitForInterrupt()
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Makes the calling task an interrupt handler until SIM_RTOS_InterruptLeave */
+void SIM_RTOS_InterruptEnter( void );
+
+void SIM_RTOS_InterruptLeave( void );
+
+/* True between SIM_RTOS_InterruptEnter and SIM_RTOS_InterruptLeave of the
+   calling task, as IPSR is not 0 in a handler */
+bool SIM_RTOS_IsInterrupt( void );
+
+/* Sleeps for a fraction of a tick, as WFI waits for the next interrupt. The
+   tick stays pending while it is masked. */
+void SIM_RTOS_WaitForInterrupt( void );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_RTOS_H
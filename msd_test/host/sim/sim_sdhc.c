@@ -0,0 +1,1386 @@
+/*******************************************************************************
+  Simulated SDHC0 and SD Card Implementation
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_sdhc.c
+
+  Summary
+    SDHC0 PLIB of the host build, with an SD card behind it.
+
+  Description
+    See sim_sdhc.h. The controller side follows plib_sdhc0.c: the interrupt
+    handler below is the one of the PLIB, fed with the NISTR and EISTR bits
+    the hardware would set, so DRV_SDMMC gets the same callbacks as on the
+    target.
+
+    The card side is lenient where the SD specification leaves the card in
+    a state only a power cycle or a CMD12 would clear: after a data error
+    the card goes back to the transfer state, so the next request of the
+    driver starts from a known state.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "device.h"
+#include "peripheral/sdhc/plib_sdhc0.h"
+#include "sim_sdhc.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_SDHC_BLOCK_SIZE             (512U)
+
+/* Card size step of a version 2.0 CSD, (C_SIZE + 1) * 512 KB */
+#define SIM_SDHC_CAPACITY_UNIT          (512U * 1024U)
+
+/* Largest C_SIZE that keeps the block count within 32 bits */
+#define SIM_SDHC_CSIZE_MAX              (0x3FFFFEU)
+
+#define SIM_SDHC_RCA                    (0x1234U)
+
+/* Voltage window and status bits of the OCR */
+#define SIM_SDHC_OCR_VOLTAGE_WINDOW     (0x00FF8000U)
+#define SIM_SDHC_OCR_CCS                (1UL << 30)
+#define SIM_SDHC_OCR_READY              (1UL << 31)
+
+/* R1 card status bits */
+#define SIM_SDHC_R1_OUT_OF_RANGE        (1UL << 31)
+#define SIM_SDHC_R1_STATE_POS           (9U)
+#define SIM_SDHC_R1_READY_FOR_DATA      (1UL << 8)
+#define SIM_SDHC_R1_APP_CMD             (1UL << 5)
+
+/* Bus cycles of the command and response frames */
+#define SIM_SDHC_COMMAND_CYCLES         (48U)
+#define SIM_SDHC_NCR_CYCLES             (2U)
+#define SIM_SDHC_NCR_MAX_CYCLES         (64U)
+#define SIM_SDHC_R48_CYCLES             (48U)
+#define SIM_SDHC_R136_CYCLES            (136U)
+
+/* Bus cycles a data block adds to its data: start bit, CRC16 and end bit */
+#define SIM_SDHC_BLOCK_FRAME_CYCLES     (18U)
+
+/* Bus cycles from the end of a written block to the end of its CRC status */
+#define SIM_SDHC_CRC_STATUS_CYCLES      (8U)
+
+/* Bus cycles between the end of the response and the first written block */
+#define SIM_SDHC_NWR_CYCLES             (2U)
+
+/* Time the controller waits for data before it reports a data timeout */
+#define SIM_SDHC_DATA_TIMEOUT_NS        (100000000U)
+
+typedef enum
+{
+    SIM_SDHC_STATE_IDLE = 0,
+    SIM_SDHC_STATE_READY = 1,
+    SIM_SDHC_STATE_IDENT = 2,
+    SIM_SDHC_STATE_STBY = 3,
+    SIM_SDHC_STATE_TRAN = 4,
+    SIM_SDHC_STATE_DATA = 5,
+    SIM_SDHC_STATE_RCV = 6,
+    SIM_SDHC_STATE_PRG = 7,
+
+} SIM_SDHC_STATE;
+
+/* An interrupt and the status bits it sets */
+typedef struct
+{
+    SIM_CLOCK_EVENT event;
+
+    uint16_t nistr;
+
+    uint16_t eistr;
+
+} SIM_SDHC_IRQ;
+
+/* ADMA2 descriptor. The address is a host pointer rather than the 32-bit
+   address of SDHC_ADMA_DESCR. */
+typedef struct
+{
+    uint16_t attribute;
+
+    uint16_t length;
+
+    uint8_t* address;
+
+} SIM_SDHC_DESCR;
+
+typedef struct
+{
+    /* Image */
+    int fd;
+
+    uint32_t numBlocks;
+
+    SIM_SDHC_PROFILE profile;
+
+    uint32_t commandCrcErrorPpm;
+
+    uint32_t dataCrcErrorPpm;
+
+    uint32_t random;
+
+    uint32_t injected[SIM_SDHC_ERROR_COUNT];
+
+    FILE* trace;
+
+    SIM_SDHC_STATISTICS statistics;
+
+    /* Controller, as in SDHC_OBJECT */
+    bool isCmdInProgress;
+
+    bool isDataInProgress;
+
+    uint16_t errorStatus;
+
+    SDHC_CALLBACK callback;
+
+    uintptr_t context;
+
+    /* Controller registers */
+    uint32_t clock;
+
+    bool is4Bit;
+
+    uint16_t blockSize;
+
+    uint16_t blockCount;
+
+    SIM_SDHC_DESCR descr;
+
+    uint32_t response[4];
+
+    SIM_TIME cmdLineFreeTime;
+
+    SIM_TIME datLineFreeTime;
+
+    SIM_SDHC_IRQ cmdIrq;
+
+    SIM_SDHC_IRQ dataIrq;
+
+    SIM_SDHC_IRQ cardIrq;
+
+    /* Data transfer in progress */
+    uint8_t* dataBuffer;
+
+    bool dataIsRead;
+
+    bool dataIsMemory;
+
+    uint32_t dataBlockStart;
+
+    uint32_t dataBlockLength;
+
+    /* Blocks transferred without error */
+    uint32_t dataBlocksDone;
+
+    /* The card sends no data for the command */
+    bool isDataSilent;
+
+    SIM_TIME dataStartTime;
+
+    /* Register read by ACMD51 or CMD6 */
+    uint8_t regData[64];
+
+    /* Card */
+    bool isInserted;
+
+    SIM_SDHC_STATE state;
+
+    uint16_t rca;
+
+    bool isAppCmd;
+
+    bool isHighSpeed;
+
+    SIM_TIME readyTime;
+
+    SIM_TIME busyEndTime;
+
+    uint32_t lastWriteEnd;
+
+} SIM_SDHC_OBJ;
+
+static SIM_SDHC_OBJ simSdhcObj = { .fd = -1 };
+
+static const SIM_SDHC_PROFILE simSdhcProfiles[] =
+{
+    {
+        .name = "typical",
+        .readAccessNs = 250000U,
+        .readBlockGapNs = 2000U,
+        .writeBlockNs = 15000U,
+        .writeRandomNs = 2500000U,
+        .writeStopNs = 500000U,
+        .powerUpNs = 30000000U,
+        .highSpeed = true,
+    },
+    {
+        .name = "slow",
+        .readAccessNs = 800000U,
+        .readBlockGapNs = 10000U,
+        .writeBlockNs = 60000U,
+        .writeRandomNs = 15000000U,
+        .writeStopNs = 4000000U,
+        .powerUpNs = 200000000U,
+        .highSpeed = false,
+    },
+    {
+        .name = "ideal",
+        .readAccessNs = 0U,
+        .readBlockGapNs = 0U,
+        .writeBlockNs = 0U,
+        .writeRandomNs = 0U,
+        .writeStopNs = 0U,
+        .powerUpNs = 1000000U,
+        .highSpeed = true,
+    },
+};
+
+/* CID: manufacturer, OEM "SM", product "HOSTS", revision 1.0, serial,
+   date. Stored most significant byte first, without the CRC byte. */
+static const uint8_t simSdhcCid[15] =
+{
+    0x03U, 0x53U, 0x4DU, 0x48U, 0x4FU, 0x53U, 0x54U, 0x53U,
+    0x10U, 0x12U, 0x34U, 0x56U, 0x78U, 0x01U, 0x4AU,
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t SIM_SDHC_Random( void )
+{
+    /* xorshift32 */
+    uint32_t x = simSdhcObj.random;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    simSdhcObj.random = x;
+    return x;
+}
+
+static bool SIM_SDHC_ErrorTake( SIM_SDHC_ERROR error )
+{
+    if (simSdhcObj.injected[error] > 0U)
+    {
+        simSdhcObj.injected[error]--;
+        return true;
+    }
+    return false;
+}
+
+static bool SIM_SDHC_ErrorRoll( uint32_t ppm )
+{
+    return (ppm > 0U) && ((SIM_SDHC_Random() % 1000000U) < ppm);
+}
+
+/* Time of the given number of bus cycles */
+static SIM_TIME SIM_SDHC_CyclesNs( uint64_t cycles )
+{
+    return ((cycles * 1000000000ULL) + simSdhcObj.clock - 1U) / simSdhcObj.clock;
+}
+
+/* Time of one data block on the bus, without the card's access or busy
+   time */
+static SIM_TIME SIM_SDHC_BlockNs( uint32_t length )
+{
+    uint32_t width = simSdhcObj.is4Bit ? 4U : 1U;
+
+    return SIM_SDHC_CyclesNs(((uint64_t)length * 8U / width) + SIM_SDHC_BLOCK_FRAME_CYCLES);
+}
+
+/* Stores a 120-bit register (R2) in the response registers. The
+   controller drops the CRC byte, so byte k of the registers is bits
+   [8k+15:8k+8] of the card register. */
+static void SIM_SDHC_R2Set( const uint8_t* reg )
+{
+    uint8_t bytes[16];
+    uint32_t index;
+
+    for (index = 0U; index < 15U; index++)
+    {
+        bytes[index] = reg[14U - index];
+    }
+    bytes[15] = 0U;
+
+    for (index = 0U; index < 4U; index++)
+    {
+        simSdhcObj.response[index] = (uint32_t)bytes[index * 4U] |
+                ((uint32_t)bytes[(index * 4U) + 1U] << 8) |
+                ((uint32_t)bytes[(index * 4U) + 2U] << 16) |
+                ((uint32_t)bytes[(index * 4U) + 3U] << 24);
+    }
+}
+
+/* Version 2.0 CSD of the card, without the CRC byte */
+static void SIM_SDHC_CsdGet( uint8_t* csd )
+{
+    uint32_t cSize = (simSdhcObj.numBlocks / (SIM_SDHC_CAPACITY_UNIT / SIM_SDHC_BLOCK_SIZE)) - 1U;
+
+    memset(csd, 0, 15);
+    csd[0] = 0x40U;                             /* CSD_STRUCTURE 1 */
+    csd[1] = 0x0EU;                             /* TAAC */
+    csd[3] = simSdhcObj.isHighSpeed ? 0x5AU : 0x32U;    /* TRAN_SPEED */
+    csd[4] = 0x5BU;                             /* CCC */
+    csd[5] = 0x59U;                             /* CCC, READ_BL_LEN 9 */
+    csd[7] = (uint8_t)((cSize >> 16) & 0x3FU);  /* C_SIZE */
+    csd[8] = (uint8_t)(cSize >> 8);
+    csd[9] = (uint8_t)cSize;
+    csd[10] = 0x7FU;                            /* ERASE_BLK_EN, SECTOR_SIZE */
+    csd[11] = 0x80U;
+    csd[12] = 0x0AU;                            /* R2W_FACTOR, WRITE_BL_LEN 9 */
+    csd[13] = 0x40U;
+}
+
+static uint32_t SIM_SDHC_CardStatusGet( void )
+{
+    SIM_SDHC_STATE state = simSdhcObj.state;
+    uint32_t status;
+
+    if (SIM_CLOCK_Now() < simSdhcObj.busyEndTime)
+    {
+        state = SIM_SDHC_STATE_PRG;
+    }
+    else if (state == SIM_SDHC_STATE_PRG)
+    {
+        simSdhcObj.state = SIM_SDHC_STATE_TRAN;
+        state = SIM_SDHC_STATE_TRAN;
+    }
+
+    status = (uint32_t)state << SIM_SDHC_R1_STATE_POS;
+    if (state != SIM_SDHC_STATE_PRG)
+    {
+        status |= SIM_SDHC_R1_READY_FOR_DATA;
+    }
+    if (simSdhcObj.isAppCmd)
+    {
+        status |= SIM_SDHC_R1_APP_CMD;
+    }
+    return status;
+}
+
+/* Interrupt handler of plib_sdhc0.c, run on the status bits of irq */
+static void SIM_SDHC_InterruptHandler( uintptr_t context )
+{
+    SIM_SDHC_IRQ* irq = (SIM_SDHC_IRQ*)context;
+    uint16_t nistr = irq->nistr;
+    uint16_t eistr = irq->eistr;
+    SDHC_XFER_STATUS xferStatus = (SDHC_XFER_STATUS)0;
+
+    irq->nistr = 0U;
+    irq->eistr = 0U;
+    simSdhcObj.errorStatus |= eistr;
+
+    if ((nistr & SDHC_NISTR_CINS_Msk) != 0U)
+    {
+        xferStatus |= SDHC_XFER_STATUS_CARD_INSERTED;
+    }
+    if ((nistr & SDHC_NISTR_CREM_Msk) != 0U)
+    {
+        xferStatus |= SDHC_XFER_STATUS_CARD_REMOVED;
+    }
+
+    if (simSdhcObj.isCmdInProgress == true)
+    {
+        if ((nistr & (SDHC_NISTR_CMDC_Msk | SDHC_NISTR_TRFC_Msk | SDHC_NISTR_ERRINT_Msk)) != 0U)
+        {
+            simSdhcObj.isCmdInProgress = false;
+            xferStatus |= SDHC_XFER_STATUS_CMD_COMPLETED;
+        }
+    }
+
+    if (simSdhcObj.isDataInProgress == true)
+    {
+        if ((nistr & (SDHC_NISTR_TRFC_Msk | SDHC_NISTR_DMAINT_Msk | SDHC_NISTR_ERRINT_Msk)) != 0U)
+        {
+            if ((nistr & SDHC_NISTR_TRFC_Msk) != 0U)
+            {
+                simSdhcObj.errorStatus &= (uint16_t)(~SDHC_EISTR_DATTEO_Msk);
+            }
+            simSdhcObj.isDataInProgress = false;
+            xferStatus |= SDHC_XFER_STATUS_DATA_COMPLETED;
+        }
+    }
+
+    if ((simSdhcObj.callback != NULL) && ((uint32_t)xferStatus > 0U))
+    {
+        simSdhcObj.callback(xferStatus, simSdhcObj.context);
+    }
+}
+
+static void SIM_SDHC_IrqRaise( SIM_SDHC_IRQ* irq, SIM_TIME time, uint16_t nistr, uint16_t eistr )
+{
+    if (eistr != 0U)
+    {
+        nistr |= SDHC_NISTR_ERRINT_Msk;
+    }
+    irq->nistr |= nistr;
+    irq->eistr |= eistr;
+    SIM_CLOCK_EventSchedule(&irq->event, time);
+}
+
+/* Ends the data phase: moves the blocks transferred without error between
+   the buffer and the image, then raises the data interrupt */
+static void SIM_SDHC_DataHandler( uintptr_t context )
+{
+    SIM_SDHC_IRQ* irq = (SIM_SDHC_IRQ*)context;
+    size_t length = (size_t)simSdhcObj.dataBlocksDone * simSdhcObj.dataBlockLength;
+    off_t offset = (off_t)simSdhcObj.dataBlockStart * SIM_SDHC_BLOCK_SIZE;
+    ssize_t result = (ssize_t)length;
+
+    if (length > 0U)
+    {
+        if (!simSdhcObj.dataIsMemory)
+        {
+            memcpy(simSdhcObj.dataBuffer, simSdhcObj.regData, length);
+        }
+        else if (simSdhcObj.dataIsRead)
+        {
+            result = pread(simSdhcObj.fd, simSdhcObj.dataBuffer, length, offset);
+            simSdhcObj.statistics.readBlocks += simSdhcObj.dataBlocksDone;
+        }
+        else
+        {
+            result = pwrite(simSdhcObj.fd, simSdhcObj.dataBuffer, length, offset);
+            simSdhcObj.statistics.writeBlocks += simSdhcObj.dataBlocksDone;
+            simSdhcObj.lastWriteEnd = simSdhcObj.dataBlockStart + simSdhcObj.dataBlocksDone;
+        }
+    }
+    if (result != (ssize_t)length)
+    {
+        /* The image failed: report it as a CRC error of the card */
+        irq->eistr |= SDHC_EISTR_DATCRC_Msk;
+        irq->nistr |= SDHC_NISTR_ERRINT_Msk;
+    }
+
+    simSdhcObj.statistics.dataBusyTime += SIM_CLOCK_Now() - simSdhcObj.dataStartTime;
+
+    if ((irq->eistr != 0U) && simSdhcObj.dataIsMemory)
+    {
+        /* Lenient model: a failed transfer leaves the card in tran */
+        simSdhcObj.state = SIM_SDHC_STATE_TRAN;
+    }
+
+    if (simSdhcObj.trace != NULL)
+    {
+        fprintf(simSdhcObj.trace, "sdhc t=%llu data=%s lba=%lu blocks=%lu us=%llu err=0x%x\n",
+                (unsigned long long)(SIM_CLOCK_Now() / 1000U),
+                simSdhcObj.dataIsRead ? "read" : "write",
+                (unsigned long)simSdhcObj.dataBlockStart,
+                (unsigned long)simSdhcObj.dataBlocksDone,
+                (unsigned long long)((SIM_CLOCK_Now() - simSdhcObj.dataStartTime) / 1000U),
+                (unsigned int)irq->eistr);
+    }
+
+    SIM_SDHC_InterruptHandler(context);
+}
+
+/* Starts the data phase of a command whose response ends at cmdEndTime */
+static void SIM_SDHC_DataStart( SIM_TIME cmdEndTime, uint32_t blocks, bool isMulti )
+{
+    SIM_SDHC_DESCR* descr = &simSdhcObj.descr;
+    uint32_t bytes = blocks * simSdhcObj.dataBlockLength;
+    uint32_t descrLength = (descr->length == 0U) ? 65536U : descr->length;
+    uint32_t errorBlock = blocks;
+    uint16_t eistr = 0U;
+    SIM_TIME blockNs = SIM_SDHC_BlockNs(simSdhcObj.dataBlockLength);
+    SIM_TIME time;
+    uint32_t index;
+
+    simSdhcObj.dataBlocksDone = 0U;
+    simSdhcObj.dataBuffer = descr->address;
+
+    /* The descriptor table holds a single line, which must carry the whole
+       transfer */
+    if (((descr->attribute & (SDHC_DESC_TABLE_ATTR_VALID | SDHC_DESC_TABLE_ATTR_END)) !=
+            (SDHC_DESC_TABLE_ATTR_VALID | SDHC_DESC_TABLE_ATTR_END)) ||
+        ((descr->attribute & SDHC_DESC_TABLE_ATTR_LINK_DESC) != SDHC_DESC_TABLE_ATTR_XFER_DATA) ||
+        (descr->address == NULL) || (descrLength != bytes))
+    {
+        simSdhcObj.statistics.admaErrors++;
+        simSdhcObj.dataStartTime = cmdEndTime;
+        simSdhcObj.datLineFreeTime = cmdEndTime;
+        SIM_SDHC_IrqRaise(&simSdhcObj.dataIrq, cmdEndTime, 0U, SDHC_EISTR_ADMA_Msk);
+        return;
+    }
+
+    if (simSdhcObj.isDataSilent || SIM_SDHC_ErrorTake(SIM_SDHC_ERROR_DATA_TIMEOUT))
+    {
+        simSdhcObj.statistics.dataTimeouts++;
+        time = cmdEndTime + SIM_SDHC_DATA_TIMEOUT_NS;
+        simSdhcObj.dataStartTime = cmdEndTime;
+        simSdhcObj.datLineFreeTime = time;
+        SIM_SDHC_IrqRaise(&simSdhcObj.dataIrq, time, 0U, SDHC_EISTR_DATTEO_Msk);
+        return;
+    }
+
+    if (SIM_SDHC_ErrorTake(SIM_SDHC_ERROR_DATA_CRC))
+    {
+        errorBlock = 0U;
+    }
+    else
+    {
+        for (index = 0U; index < blocks; index++)
+        {
+            if (SIM_SDHC_ErrorRoll(simSdhcObj.dataCrcErrorPpm))
+            {
+                errorBlock = index;
+                break;
+            }
+        }
+    }
+    if (errorBlock < blocks)
+    {
+        simSdhcObj.statistics.dataCrcErrors++;
+        eistr = SDHC_EISTR_DATCRC_Msk;
+    }
+
+    if (simSdhcObj.dataIsRead)
+    {
+        time = cmdEndTime;
+        if (simSdhcObj.dataIsMemory)
+        {
+            time += simSdhcObj.profile.readAccessNs;
+        }
+        simSdhcObj.dataStartTime = time;
+
+        for (index = 0U; index < blocks; index++)
+        {
+            if (index > 0U)
+            {
+                time += simSdhcObj.profile.readBlockGapNs;
+            }
+            time += blockNs;
+            if (index == errorBlock)
+            {
+                break;
+            }
+        }
+        simSdhcObj.state = isMulti ? SIM_SDHC_STATE_DATA : SIM_SDHC_STATE_TRAN;
+    }
+    else
+    {
+        time = cmdEndTime + SIM_SDHC_CyclesNs(SIM_SDHC_NWR_CYCLES);
+        simSdhcObj.dataStartTime = time;
+
+        for (index = 0U; index < blocks; index++)
+        {
+            time += blockNs + SIM_SDHC_CyclesNs(SIM_SDHC_CRC_STATUS_CYCLES);
+            if (index == errorBlock)
+            {
+                break;
+            }
+            /* The card holds DAT0 low while it programs the block */
+            time += simSdhcObj.profile.writeBlockNs;
+            if ((index == 0U) && (simSdhcObj.dataBlockStart != simSdhcObj.lastWriteEnd))
+            {
+                time += simSdhcObj.profile.writeRandomNs;
+            }
+        }
+        simSdhcObj.state = isMulti ? SIM_SDHC_STATE_RCV : SIM_SDHC_STATE_TRAN;
+        simSdhcObj.busyEndTime = time;
+    }
+
+    simSdhcObj.dataBlocksDone = (errorBlock < blocks) ? errorBlock : blocks;
+    simSdhcObj.datLineFreeTime = time;
+    if (eistr != 0U)
+    {
+        SIM_SDHC_IrqRaise(&simSdhcObj.dataIrq, time, 0U, eistr);
+    }
+    else
+    {
+        SIM_SDHC_IrqRaise(&simSdhcObj.dataIrq, time, SDHC_NISTR_TRFC_Msk | SDHC_NISTR_DMAINT_Msk, 0U);
+    }
+}
+
+/* Runs a command on the card. Returns false if the card does not respond.
+   busyNs is set to the busy time of an R1b response, and blocks to the
+   number of blocks of a data phase. */
+static bool SIM_SDHC_CardCommand( uint8_t opCode, uint32_t argument, uint32_t* busyNs, uint32_t* blocks )
+{
+    bool isAppCmd = simSdhcObj.isAppCmd;
+    SIM_SDHC_STATE state = simSdhcObj.state;
+    uint8_t reg[15];
+    uint32_t status;
+
+    *busyNs = 0U;
+    *blocks = 0U;
+    simSdhcObj.isAppCmd = false;
+
+    if ((state == SIM_SDHC_STATE_PRG) && (SIM_CLOCK_Now() >= simSdhcObj.busyEndTime))
+    {
+        simSdhcObj.state = SIM_SDHC_STATE_TRAN;
+        state = SIM_SDHC_STATE_TRAN;
+    }
+
+    if (isAppCmd)
+    {
+        switch (opCode)
+        {
+            case SDHC_CMD_SD_SEND_OP_COND:
+                if ((state != SIM_SDHC_STATE_IDLE) && (state != SIM_SDHC_STATE_READY))
+                {
+                    return false;
+                }
+                status = SIM_SDHC_OCR_VOLTAGE_WINDOW;
+                if (((argument & SIM_SDHC_OCR_VOLTAGE_WINDOW) != 0U) &&
+                    (SIM_CLOCK_Now() >= simSdhcObj.readyTime))
+                {
+                    status |= SIM_SDHC_OCR_READY | SIM_SDHC_OCR_CCS;
+                    simSdhcObj.state = SIM_SDHC_STATE_READY;
+                }
+                simSdhcObj.response[0] = status;
+                return true;
+
+            case SDHC_CMD_SET_BUS_WIDTH:
+                if (state != SIM_SDHC_STATE_TRAN)
+                {
+                    return false;
+                }
+                simSdhcObj.response[0] = SIM_SDHC_CardStatusGet() | SIM_SDHC_R1_APP_CMD;
+                return true;
+
+            case SDHC_CMD_READ_SCR:
+                if (state != SIM_SDHC_STATE_TRAN)
+                {
+                    return false;
+                }
+                simSdhcObj.response[0] = SIM_SDHC_CardStatusGet() | SIM_SDHC_R1_APP_CMD;
+                memset(simSdhcObj.regData, 0, sizeof(simSdhcObj.regData));
+                /* SD_SPEC 2, 1-bit and 4-bit bus */
+                simSdhcObj.regData[0] = 0x02U;
+                simSdhcObj.regData[1] = 0x05U;
+                *blocks = 1U;
+                return true;
+
+            default:
+                /* Other application commands are the ones below */
+                break;
+        }
+    }
+
+    switch (opCode)
+    {
+        case SDHC_CMD_GO_IDLE_STATE:
+            simSdhcObj.state = SIM_SDHC_STATE_IDLE;
+            simSdhcObj.rca = 0U;
+            simSdhcObj.isHighSpeed = false;
+            simSdhcObj.readyTime = SIM_CLOCK_Now() + simSdhcObj.profile.powerUpNs;
+            return true;
+
+        case SDHC_CMD_SEND_IF_COND:
+            if (state != SIM_SDHC_STATE_IDLE)
+            {
+                return false;
+            }
+            simSdhcObj.response[0] = argument & 0xFFFU;
+            return true;
+
+        case SDHC_CMD_APP_CMD:
+            simSdhcObj.isAppCmd = true;
+            simSdhcObj.response[0] = SIM_SDHC_CardStatusGet();
+            return true;
+
+        case SDHC_CMD_ALL_SEND_CID:
+            if (state != SIM_SDHC_STATE_READY)
+            {
+                return false;
+            }
+            SIM_SDHC_R2Set(simSdhcCid);
+            simSdhcObj.state = SIM_SDHC_STATE_IDENT;
+            return true;
+
+        case SDHC_CMD_SEND_RCA:
+            if ((state != SIM_SDHC_STATE_IDENT) && (state != SIM_SDHC_STATE_STBY))
+            {
+                return false;
+            }
+            simSdhcObj.rca = SIM_SDHC_RCA;
+            simSdhcObj.state = SIM_SDHC_STATE_STBY;
+            simSdhcObj.response[0] = ((uint32_t)simSdhcObj.rca << 16) |
+                    ((uint32_t)SIM_SDHC_STATE_STBY << SIM_SDHC_R1_STATE_POS) | SIM_SDHC_R1_READY_FOR_DATA;
+            return true;
+
+        case SDHC_CMD_SEND_CSD:
+        case SDHC_CMD_SEND_CID:
+            if ((state != SIM_SDHC_STATE_STBY) || ((argument >> 16) != simSdhcObj.rca))
+            {
+                return false;
+            }
+            if (opCode == SDHC_CMD_SEND_CSD)
+            {
+                SIM_SDHC_CsdGet(reg);
+                SIM_SDHC_R2Set(reg);
+            }
+            else
+            {
+                SIM_SDHC_R2Set(simSdhcCid);
+            }
+            return true;
+
+        case SDHC_CMD_SELECT_DESELECT_CARD:
+            if ((argument >> 16) == simSdhcObj.rca)
+            {
+                if ((state != SIM_SDHC_STATE_STBY) && (state != SIM_SDHC_STATE_TRAN))
+                {
+                    return false;
+                }
+                simSdhcObj.response[0] = SIM_SDHC_CardStatusGet();
+                simSdhcObj.state = SIM_SDHC_STATE_TRAN;
+                return true;
+            }
+            /* Another card is selected: this one goes back to standby
+               without a response */
+            if (state == SIM_SDHC_STATE_TRAN)
+            {
+                simSdhcObj.state = SIM_SDHC_STATE_STBY;
+            }
+            return false;
+
+        case SDHC_CMD_SWITCH:
+            if (state != SIM_SDHC_STATE_TRAN)
+            {
+                return false;
+            }
+            simSdhcObj.response[0] = SIM_SDHC_CardStatusGet();
+            memset(simSdhcObj.regData, 0, sizeof(simSdhcObj.regData));
+            /* Maximum current, then the functions of group 1 */
+            simSdhcObj.regData[1] = 0x64U;
+            simSdhcObj.regData[13] = simSdhcObj.profile.highSpeed ? 0x03U : 0x01U;
+            if (simSdhcObj.profile.highSpeed && ((argument & 0xFU) == 1U))
+            {
+                simSdhcObj.regData[16] = 0x01U;
+                if ((argument & (1UL << 31)) != 0U)
+                {
+                    simSdhcObj.isHighSpeed = true;
+                }
+            }
+            else
+            {
+                simSdhcObj.regData[16] = 0x00U;
+            }
+            *blocks = 1U;
+            return true;
+
+        case SDHC_CMD_STOP_TRANSMISSION:
+            if (state == SIM_SDHC_STATE_DATA)
+            {
+                simSdhcObj.response[0] = SIM_SDHC_CardStatusGet();
+                simSdhcObj.state = SIM_SDHC_STATE_TRAN;
+                return true;
+            }
+            if (state == SIM_SDHC_STATE_RCV)
+            {
+                simSdhcObj.response[0] = SIM_SDHC_CardStatusGet();
+                simSdhcObj.state = SIM_SDHC_STATE_PRG;
+                *busyNs = simSdhcObj.profile.writeStopNs;
+                return true;
+            }
+            return false;
+
+        case SDHC_CMD_SEND_STATUS:
+            if ((state < SIM_SDHC_STATE_STBY) || ((argument >> 16) != simSdhcObj.rca))
+            {
+                return false;
+            }
+            simSdhcObj.response[0] = SIM_SDHC_CardStatusGet();
+            return true;
+
+        case SDHC_CMD_SET_BLOCKLEN:
+            if (state != SIM_SDHC_STATE_TRAN)
+            {
+                return false;
+            }
+            simSdhcObj.response[0] = SIM_SDHC_CardStatusGet();
+            return true;
+
+        case SDHC_CMD_READ_SINGLE_BLOCK:
+        case SDHC_CMD_READ_MULTI_BLOCK:
+        case SDHC_CMD_WRITE_SINGLE_BLOCK:
+        case SDHC_CMD_WRITE_MULTI_BLOCK:
+            if (state != SIM_SDHC_STATE_TRAN)
+            {
+                return false;
+            }
+            simSdhcObj.response[0] = SIM_SDHC_CardStatusGet();
+            if ((opCode == SDHC_CMD_READ_SINGLE_BLOCK) || (opCode == SDHC_CMD_WRITE_SINGLE_BLOCK))
+            {
+                *blocks = 1U;
+            }
+            else
+            {
+                *blocks = simSdhcObj.blockCount;
+            }
+            if ((argument >= simSdhcObj.numBlocks) || (*blocks > (simSdhcObj.numBlocks - argument)))
+            {
+                /* The card sends no data and the transfer times out */
+                simSdhcObj.response[0] |= SIM_SDHC_R1_OUT_OF_RANGE;
+                simSdhcObj.isDataSilent = true;
+            }
+            if ((opCode == SDHC_CMD_READ_SINGLE_BLOCK) || (opCode == SDHC_CMD_READ_MULTI_BLOCK))
+            {
+                simSdhcObj.statistics.readCommands++;
+            }
+            else
+            {
+                simSdhcObj.statistics.writeCommands++;
+            }
+            return true;
+
+        default:
+            /* Not a command of an SD memory card, or SDIO (CMD5, CMD52) */
+            return false;
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+bool SIM_SDHC_Initialize( const SIM_SDHC_INIT* init )
+{
+    struct stat st;
+    uint64_t capacity = init->capacity;
+
+    SIM_SDHC_Deinitialize();
+    memset(&simSdhcObj, 0, sizeof(simSdhcObj));
+    simSdhcObj.fd = -1;
+
+    simSdhcObj.fd = open(init->imagePath, O_RDWR | O_CREAT, 0644);
+    if ((simSdhcObj.fd < 0) || (fstat(simSdhcObj.fd, &st) != 0))
+    {
+        SIM_SDHC_Deinitialize();
+        return false;
+    }
+    if (capacity == 0U)
+    {
+        capacity = (uint64_t)st.st_size;
+    }
+    if ((capacity == 0U) || ((capacity % SIM_SDHC_CAPACITY_UNIT) != 0U) ||
+        (((capacity / SIM_SDHC_CAPACITY_UNIT) - 1U) > SIM_SDHC_CSIZE_MAX))
+    {
+        SIM_SDHC_Deinitialize();
+        return false;
+    }
+    if (((uint64_t)st.st_size < capacity) && (ftruncate(simSdhcObj.fd, (off_t)capacity) != 0))
+    {
+        SIM_SDHC_Deinitialize();
+        return false;
+    }
+
+    simSdhcObj.numBlocks = (uint32_t)(capacity / SIM_SDHC_BLOCK_SIZE);
+    simSdhcObj.profile = *((init->profile != NULL) ? init->profile : &simSdhcProfiles[0]);
+    simSdhcObj.commandCrcErrorPpm = init->commandCrcErrorPpm;
+    simSdhcObj.dataCrcErrorPpm = init->dataCrcErrorPpm;
+    simSdhcObj.random = (init->seed != 0U) ? init->seed : 1U;
+    simSdhcObj.isInserted = init->isInserted;
+    simSdhcObj.clock = SDHC_CLOCK_FREQ_400_KHZ;
+    simSdhcObj.lastWriteEnd = UINT32_MAX;
+    simSdhcObj.readyTime = SIM_CLOCK_Now() + simSdhcObj.profile.powerUpNs;
+
+    SIM_CLOCK_EventInitialize(&simSdhcObj.cmdIrq.event, SDHC0_IRQn, SIM_SDHC_InterruptHandler, (uintptr_t)&simSdhcObj.cmdIrq);
+    SIM_CLOCK_EventInitialize(&simSdhcObj.dataIrq.event, SDHC0_IRQn, SIM_SDHC_DataHandler, (uintptr_t)&simSdhcObj.dataIrq);
+    SIM_CLOCK_EventInitialize(&simSdhcObj.cardIrq.event, SDHC0_IRQn, SIM_SDHC_InterruptHandler, (uintptr_t)&simSdhcObj.cardIrq);
+    return true;
+}
+
+void SIM_SDHC_Deinitialize( void )
+{
+    SIM_CLOCK_EventCancel(&simSdhcObj.cmdIrq.event);
+    SIM_CLOCK_EventCancel(&simSdhcObj.dataIrq.event);
+    SIM_CLOCK_EventCancel(&simSdhcObj.cardIrq.event);
+    if (simSdhcObj.fd >= 0)
+    {
+        (void)close(simSdhcObj.fd);
+        simSdhcObj.fd = -1;
+    }
+}
+
+const SIM_SDHC_PROFILE* SIM_SDHC_ProfileGet( const char* name )
+{
+    size_t index;
+
+    for (index = 0U; index < (sizeof(simSdhcProfiles) / sizeof(simSdhcProfiles[0])); index++)
+    {
+        if (strcmp(simSdhcProfiles[index].name, name) == 0)
+        {
+            return &simSdhcProfiles[index];
+        }
+    }
+    return NULL;
+}
+
+bool SIM_SDHC_ProfileSet( SIM_SDHC_PROFILE* profile, const char* assignment )
+{
+    const char* value = strchr(assignment, '=');
+    size_t keyLength;
+    unsigned long number;
+    char* end;
+
+    if (value == NULL)
+    {
+        return false;
+    }
+    keyLength = (size_t)(value - assignment);
+    value++;
+    number = strtoul(value, &end, 0);
+    if ((end == value) || (*end != '\0'))
+    {
+        return false;
+    }
+
+#define SIM_SDHC_KEY_IS(key)    ((keyLength == (sizeof(key) - 1U)) && (strncmp(assignment, key, keyLength) == 0))
+
+    if (SIM_SDHC_KEY_IS("read_access_us"))
+    {
+        profile->readAccessNs = (uint32_t)(number * 1000U);
+    }
+    else if (SIM_SDHC_KEY_IS("read_gap_us"))
+    {
+        profile->readBlockGapNs = (uint32_t)(number * 1000U);
+    }
+    else if (SIM_SDHC_KEY_IS("write_block_us"))
+    {
+        profile->writeBlockNs = (uint32_t)(number * 1000U);
+    }
+    else if (SIM_SDHC_KEY_IS("write_random_us"))
+    {
+        profile->writeRandomNs = (uint32_t)(number * 1000U);
+    }
+    else if (SIM_SDHC_KEY_IS("write_stop_us"))
+    {
+        profile->writeStopNs = (uint32_t)(number * 1000U);
+    }
+    else if (SIM_SDHC_KEY_IS("power_up_ms"))
+    {
+        profile->powerUpNs = (uint32_t)(number * 1000000U);
+    }
+    else if (SIM_SDHC_KEY_IS("high_speed"))
+    {
+        profile->highSpeed = (number != 0U);
+    }
+    else
+    {
+        return false;
+    }
+
+#undef SIM_SDHC_KEY_IS
+
+    return true;
+}
+
+void SIM_SDHC_CardInsert( bool isInserted )
+{
+    SIM_TIME now = SIM_CLOCK_Now();
+
+    if (isInserted == simSdhcObj.isInserted)
+    {
+        return;
+    }
+    simSdhcObj.isInserted = isInserted;
+
+    if (isInserted)
+    {
+        /* A new card powers up in idle */
+        simSdhcObj.state = SIM_SDHC_STATE_IDLE;
+        simSdhcObj.rca = 0U;
+        simSdhcObj.isAppCmd = false;
+        simSdhcObj.isHighSpeed = false;
+        simSdhcObj.busyEndTime = 0U;
+        simSdhcObj.lastWriteEnd = UINT32_MAX;
+        simSdhcObj.readyTime = now + simSdhcObj.profile.powerUpNs;
+        SIM_SDHC_IrqRaise(&simSdhcObj.cardIrq, now, SDHC_NISTR_CINS_Msk, 0U);
+    }
+    else
+    {
+        /* Whatever was on the bus is lost */
+        SIM_CLOCK_EventCancel(&simSdhcObj.cmdIrq.event);
+        SIM_CLOCK_EventCancel(&simSdhcObj.dataIrq.event);
+        simSdhcObj.cmdIrq.nistr = 0U;
+        simSdhcObj.cmdIrq.eistr = 0U;
+        simSdhcObj.dataIrq.nistr = 0U;
+        simSdhcObj.dataIrq.eistr = 0U;
+        simSdhcObj.cmdLineFreeTime = now;
+        simSdhcObj.datLineFreeTime = now;
+        SIM_SDHC_IrqRaise(&simSdhcObj.cardIrq, now, SDHC_NISTR_CREM_Msk, 0U);
+    }
+}
+
+void SIM_SDHC_ErrorInject( SIM_SDHC_ERROR error, uint32_t count )
+{
+    if (error < SIM_SDHC_ERROR_COUNT)
+    {
+        simSdhcObj.injected[error] += count;
+    }
+}
+
+void SIM_SDHC_StatisticsGet( SIM_SDHC_STATISTICS* statistics )
+{
+    *statistics = simSdhcObj.statistics;
+}
+
+void SIM_SDHC_StatisticsReset( void )
+{
+    memset(&simSdhcObj.statistics, 0, sizeof(simSdhcObj.statistics));
+}
+
+void SIM_SDHC_TraceSet( FILE* stream )
+{
+    simSdhcObj.trace = stream;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SDHC0 PLIB Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void SDHC0_BusWidthSet( SDHC_BUS_WIDTH busWidth )
+{
+    simSdhcObj.is4Bit = (busWidth == SDHC_BUS_WIDTH_4_BIT);
+}
+
+void SDHC0_SpeedModeSet( SDHC_SPEED_MODE speedMode )
+{
+    /* The bus timing only depends on the clock */
+    (void)speedMode;
+}
+
+void SDHC0_BlockSizeSet( uint16_t blockSize )
+{
+    if (blockSize == 0U)
+    {
+        blockSize = 1U;
+    }
+    else if (blockSize > SIM_SDHC_BLOCK_SIZE)
+    {
+        blockSize = SIM_SDHC_BLOCK_SIZE;
+    }
+    else
+    {
+        /* Do not modify the block size */
+    }
+    simSdhcObj.blockSize = blockSize;
+}
+
+void SDHC0_BlockCountSet( uint16_t numBlocks )
+{
+    simSdhcObj.blockCount = numBlocks;
+}
+
+bool SDHC0_IsCmdLineBusy( void )
+{
+    return SIM_CLOCK_Now() < simSdhcObj.cmdLineFreeTime;
+}
+
+bool SDHC0_IsDatLineBusy( void )
+{
+    return (SIM_CLOCK_Now() < simSdhcObj.datLineFreeTime) ||
+           (simSdhcObj.isInserted && (SIM_CLOCK_Now() < simSdhcObj.busyEndTime));
+}
+
+bool SDHC0_IsCardAttached( void )
+{
+    return simSdhcObj.isInserted;
+}
+
+bool SDHC0_ClockSet( uint32_t speed )
+{
+    if (speed == 0U)
+    {
+        return false;
+    }
+    simSdhcObj.clock = speed;
+    return true;
+}
+
+void SDHC0_ClockEnable( void )
+{
+}
+
+void SDHC0_ClockDisable( void )
+{
+}
+
+uint16_t SDHC0_CommandErrorGet( void )
+{
+    return (simSdhcObj.errorStatus & (SDHC_EISTR_CMDTEO_Msk | SDHC_EISTR_CMDCRC_Msk |
+                SDHC_EISTR_CMDEND_Msk | SDHC_EISTR_CMDIDX_Msk));
+}
+
+uint16_t SDHC0_DataErrorGet( void )
+{
+    return (simSdhcObj.errorStatus & (SDHC_EISTR_ADMA_Msk | SDHC_EISTR_DATTEO_Msk |
+            SDHC_EISTR_DATCRC_Msk | SDHC_EISTR_DATEND_Msk));
+}
+
+void SDHC0_ErrorReset( SDHC_RESET_TYPE resetType )
+{
+    SIM_TIME now = SIM_CLOCK_Now();
+
+    if (((uint32_t)resetType & ((uint32_t)SDHC_RESET_ALL | (uint32_t)SDHC_RESET_CMD)) != 0U)
+    {
+        SIM_CLOCK_EventCancel(&simSdhcObj.cmdIrq.event);
+        simSdhcObj.cmdIrq.nistr = 0U;
+        simSdhcObj.cmdIrq.eistr = 0U;
+        simSdhcObj.cmdLineFreeTime = now;
+    }
+    if (((uint32_t)resetType & ((uint32_t)SDHC_RESET_ALL | (uint32_t)SDHC_RESET_DAT)) != 0U)
+    {
+        SIM_CLOCK_EventCancel(&simSdhcObj.dataIrq.event);
+        simSdhcObj.dataIrq.nistr = 0U;
+        simSdhcObj.dataIrq.eistr = 0U;
+        simSdhcObj.datLineFreeTime = now;
+    }
+}
+
+uint16_t SDHC0_GetError( void )
+{
+    return simSdhcObj.errorStatus;
+}
+
+void SDHC0_ResponseRead( SDHC_READ_RESPONSE_REG respReg, uint32_t* response )
+{
+    switch (respReg)
+    {
+        case SDHC_READ_RESP_REG_1:
+        case SDHC_READ_RESP_REG_2:
+        case SDHC_READ_RESP_REG_3:
+            *response = simSdhcObj.response[respReg];
+            break;
+
+        case SDHC_READ_RESP_REG_ALL:
+            memcpy(response, simSdhcObj.response, sizeof(simSdhcObj.response));
+            break;
+
+        case SDHC_READ_RESP_REG_0:
+        default:
+            *response = simSdhcObj.response[0];
+            break;
+    }
+}
+
+void SDHC0_ModuleInit( void )
+{
+    SDHC0_ErrorReset(SDHC_RESET_ALL);
+    simSdhcObj.clock = SDHC_CLOCK_FREQ_400_KHZ;
+    simSdhcObj.is4Bit = false;
+    simSdhcObj.blockSize = SIM_SDHC_BLOCK_SIZE;
+    simSdhcObj.blockCount = 0U;
+}
+
+void SDHC0_Initialize( void )
+{
+    simSdhcObj.errorStatus = 0U;
+    simSdhcObj.isCmdInProgress = false;
+    simSdhcObj.isDataInProgress = false;
+    simSdhcObj.callback = NULL;
+    SDHC0_ModuleInit();
+}
+
+void SDHC0_CallbackRegister( SDHC_CALLBACK callback, uintptr_t contextHandle )
+{
+    if (callback != NULL)
+    {
+        simSdhcObj.callback = callback;
+        simSdhcObj.context = contextHandle;
+    }
+}
+
+void SDHC0_CommandSend( uint8_t opCode, uint32_t argument, uint8_t respType, SDHC_DataTransferFlags transferFlags )
+{
+    SIM_TIME now = SIM_CLOCK_Now();
+    SIM_TIME cmdEndTime;
+    uint32_t responseCycles = 0U;
+    uint32_t busyNs = 0U;
+    uint32_t blocks = 0U;
+    bool isResponding = false;
+    bool isCrcChecked = false;
+    uint16_t eistr = 0U;
+
+    simSdhcObj.isCmdInProgress = false;
+    simSdhcObj.isDataInProgress = false;
+    simSdhcObj.errorStatus = 0U;
+    simSdhcObj.isDataSilent = false;
+    simSdhcObj.statistics.commands++;
+
+    switch (respType)
+    {
+        case SDHC_CMD_RESP_R1:
+        case SDHC_CMD_RESP_R1B:
+        case SDHC_CMD_RESP_R5:
+        case SDHC_CMD_RESP_R6:
+        case SDHC_CMD_RESP_R7:
+            responseCycles = SIM_SDHC_R48_CYCLES;
+            isCrcChecked = true;
+            break;
+
+        case SDHC_CMD_RESP_R3:
+        case SDHC_CMD_RESP_R4:
+            responseCycles = SIM_SDHC_R48_CYCLES;
+            break;
+
+        case SDHC_CMD_RESP_R2:
+            responseCycles = SIM_SDHC_R136_CYCLES;
+            isCrcChecked = true;
+            break;
+
+        default:
+            break;
+    }
+
+    if (transferFlags.isDataPresent == true)
+    {
+        simSdhcObj.isDataInProgress = true;
+    }
+    simSdhcObj.isCmdInProgress = true;
+
+    if (simSdhcObj.trace != NULL)
+    {
+        fprintf(simSdhcObj.trace, "sdhc t=%llu cmd=%u%s arg=0x%08lx\n",
+                (unsigned long long)(now / 1000U), (unsigned int)opCode,
+                simSdhcObj.isAppCmd ? "a" : "", (unsigned long)argument);
+    }
+
+    if (simSdhcObj.isInserted)
+    {
+        if (SIM_SDHC_ErrorTake(SIM_SDHC_ERROR_COMMAND_TIMEOUT))
+        {
+            simSdhcObj.isAppCmd = false;
+        }
+        else if ((responseCycles > 0U) && isCrcChecked &&
+                 (SIM_SDHC_ErrorTake(SIM_SDHC_ERROR_COMMAND_CRC) ||
+                  SIM_SDHC_ErrorRoll(simSdhcObj.commandCrcErrorPpm)))
+        {
+            /* The card never saw a valid command, the host sees a bad
+               response */
+            simSdhcObj.isAppCmd = false;
+            simSdhcObj.statistics.commandCrcErrors++;
+            eistr = SDHC_EISTR_CMDCRC_Msk;
+            isResponding = true;
+        }
+        else
+        {
+            isResponding = SIM_SDHC_CardCommand(opCode, argument, &busyNs, &blocks);
+        }
+    }
+
+    if (responseCycles == 0U)
+    {
+        /* No response expected: the command ends with its last bit */
+        cmdEndTime = now + SIM_SDHC_CyclesNs(SIM_SDHC_COMMAND_CYCLES);
+    }
+    else if (!isResponding)
+    {
+        cmdEndTime = now + SIM_SDHC_CyclesNs(SIM_SDHC_COMMAND_CYCLES + SIM_SDHC_NCR_MAX_CYCLES);
+        simSdhcObj.statistics.commandTimeouts++;
+        eistr = SDHC_EISTR_CMDTEO_Msk;
+    }
+    else
+    {
+        cmdEndTime = now + SIM_SDHC_CyclesNs(SIM_SDHC_COMMAND_CYCLES + SIM_SDHC_NCR_CYCLES + responseCycles);
+    }
+    simSdhcObj.cmdLineFreeTime = cmdEndTime;
+
+    if (eistr != 0U)
+    {
+        /* The PLIB completes both the command and its data on the error */
+        SIM_SDHC_IrqRaise(&simSdhcObj.cmdIrq, cmdEndTime, 0U, eistr);
+        return;
+    }
+
+    if (respType == SDHC_CMD_RESP_R1B)
+    {
+        /* Only the transfer complete of the end of busy is enabled */
+        if (busyNs > 0U)
+        {
+            simSdhcObj.busyEndTime = cmdEndTime + busyNs;
+            simSdhcObj.statistics.dataBusyTime += busyNs;
+        }
+        if (simSdhcObj.busyEndTime > cmdEndTime)
+        {
+            cmdEndTime = simSdhcObj.busyEndTime;
+        }
+        simSdhcObj.datLineFreeTime = cmdEndTime;
+        SIM_SDHC_IrqRaise(&simSdhcObj.cmdIrq, cmdEndTime, SDHC_NISTR_TRFC_Msk, 0U);
+        return;
+    }
+
+    SIM_SDHC_IrqRaise(&simSdhcObj.cmdIrq, cmdEndTime, SDHC_NISTR_CMDC_Msk, 0U);
+
+    if (transferFlags.isDataPresent == true)
+    {
+        simSdhcObj.dataIsRead = (transferFlags.transferDir == SDHC_DATA_TRANSFER_DIR_READ);
+        simSdhcObj.dataIsMemory = (opCode == SDHC_CMD_READ_SINGLE_BLOCK) || (opCode == SDHC_CMD_READ_MULTI_BLOCK) ||
+                (opCode == SDHC_CMD_WRITE_SINGLE_BLOCK) || (opCode == SDHC_CMD_WRITE_MULTI_BLOCK);
+        simSdhcObj.dataBlockStart = argument;
+        simSdhcObj.dataBlockLength = simSdhcObj.blockSize;
+        if (blocks == 0U)
+        {
+            /* The card does not send data for this command */
+            simSdhcObj.isDataSilent = true;
+            blocks = 1U;
+        }
+        SIM_SDHC_DataStart(cmdEndTime, blocks, transferFlags.transferType == SDHC_DATA_TRANSFER_TYPE_MULTI);
+    }
+}
+
+void SDHC0_DmaSetup( uint8_t* buffer, uint32_t numBytes, SDHC_DATA_TRANSFER_DIR direction )
+{
+    (void)direction;
+
+    /* As the PLIB: a single descriptor line of up to 65536 bytes, and the
+       previous descriptor is left in place for a longer transfer */
+    if (numBytes <= 65536U)
+    {
+        simSdhcObj.descr.address = buffer;
+        simSdhcObj.descr.length = (uint16_t)numBytes;
+        simSdhcObj.descr.attribute = (SDHC_DESC_TABLE_ATTR_XFER_DATA | SDHC_DESC_TABLE_ATTR_VALID |
+                SDHC_DESC_TABLE_ATTR_INTR | SDHC_DESC_TABLE_ATTR_END);
+    }
+}
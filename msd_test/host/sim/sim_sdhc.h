@@ -0,0 +1,262 @@
+/*******************************************************************************
+  Simulated SDHC0 and SD Card Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_sdhc.h
+
+  Summary
+    SDHC0 PLIB of the host build, with an SD card behind it.
+
+  Description
+    sim_sdhc.c implements the SDHC0_* functions of plib_sdhc0.h, so
+    drv_sdmmc.c runs unmodified on top of it. Behind the controller sits a
+    model of a high capacity SD memory card:
+    - The card answers the commands DRV_SDMMC sends, with the R1, R1b, R2,
+      R3, R6 and R7 responses in the response registers. Commands a memory
+      card does not answer, such as CMD5 and CMD52, time out.
+    - Data moves through an ADMA2 descriptor table set by SDHC0_DmaSetup.
+      A transfer that does not match its descriptor ends with an ADMA
+      error, as on the target.
+    - The blocks are kept in an image file. The file is extended with
+      ftruncate, so an image of a large card only uses the disk space of the
+      blocks written.
+    - Each command, data block and busy period takes the virtual time given
+      by the bus clock, the bus width and a SIM_SDHC_PROFILE.
+    - Command and data CRC errors are raised at a configured rate, or on the
+      next transfers with SIM_SDHC_ErrorInject.
+    - The card can be removed and inserted, which raises the card detect
+      interrupt.
+
+    The command and data completions are SIM_CLOCK events on SDHC0_IRQn.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_SDHC_H
+#define SIM_SDHC_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "sim_clock.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Card timing profile
+
+  Summary:
+    Times the card takes besides the bus transfers.
+
+  Remarks:
+    The bus transfers themselves take the time of their bits at the clock
+    and bus width the driver has set.
+*/
+
+typedef struct
+{
+    const char* name;
+
+    /* From the end of a read command to the first data block (NAC) */
+    uint32_t readAccessNs;
+
+    /* Between two blocks of a multiple block read */
+    uint32_t readBlockGapNs;
+
+    /* Busy time after each written block */
+    uint32_t writeBlockNs;
+
+    /* Extra busy time of a write that does not start where the previous
+       write ended, for the erase and copy of a partly written page */
+    uint32_t writeRandomNs;
+
+    /* Busy time after CMD12 ends a multiple block write */
+    uint32_t writeStopNs;
+
+    /* From CMD0 to the end of the power up busy reported by ACMD41 */
+    uint32_t powerUpNs;
+
+    /* The card supports the high speed mode of CMD6 */
+    bool highSpeed;
+
+} SIM_SDHC_PROFILE;
+
+// *****************************************************************************
+/* Simulator configuration
+
+  Summary:
+    Passed to SIM_SDHC_Initialize.
+*/
+
+typedef struct
+{
+    /* Image file, created if it does not exist */
+    const char* imagePath;
+
+    /* Card size in bytes, a multiple of 512 KB. 0 takes the size of the
+       existing image file. A smaller image file is extended. */
+    uint64_t capacity;
+
+    const SIM_SDHC_PROFILE* profile;
+
+    /* Rate of CRC errors, in errors per million commands and per million
+       data blocks */
+    uint32_t commandCrcErrorPpm;
+    uint32_t dataCrcErrorPpm;
+
+    /* Seed of the error generator */
+    uint32_t seed;
+
+    /* Card present at start */
+    bool isInserted;
+
+} SIM_SDHC_INIT;
+
+// *****************************************************************************
+/* Injected errors
+
+  Summary:
+    Errors SIM_SDHC_ErrorInject raises on the next commands or transfers.
+*/
+
+typedef enum
+{
+    /* CRC error on the response of the next commands */
+    SIM_SDHC_ERROR_COMMAND_CRC = 0,
+
+    /* The next commands get no response */
+    SIM_SDHC_ERROR_COMMAND_TIMEOUT,
+
+    /* CRC error on the first block of the next data transfers */
+    SIM_SDHC_ERROR_DATA_CRC,
+
+    /* The card sends no data, or no CRC status, on the next data
+       transfers */
+    SIM_SDHC_ERROR_DATA_TIMEOUT,
+
+    SIM_SDHC_ERROR_COUNT
+
+} SIM_SDHC_ERROR;
+
+// *****************************************************************************
+/* Simulator statistics
+
+  Summary:
+    Counters since SIM_SDHC_Initialize or SIM_SDHC_StatisticsReset.
+*/
+
+typedef struct
+{
+    uint32_t commands;
+
+    uint32_t readCommands;
+
+    uint32_t writeCommands;
+
+    uint64_t readBlocks;
+
+    uint64_t writeBlocks;
+
+    uint32_t commandCrcErrors;
+
+    uint32_t commandTimeouts;
+
+    uint32_t dataCrcErrors;
+
+    uint32_t dataTimeouts;
+
+    uint32_t admaErrors;
+
+    /* Time the data lines were transferring data or held busy by the card */
+    SIM_TIME dataBusyTime;
+
+} SIM_SDHC_STATISTICS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Opens the image and resets the controller and the card. Call it after
+   SIM_CLOCK_Initialize and before SDHC0_Initialize. Returns false if the
+   image cannot be opened or sized. */
+bool SIM_SDHC_Initialize( const SIM_SDHC_INIT* init );
+
+/* Closes the image */
+void SIM_SDHC_Deinitialize( void );
+
+/* Built-in profile by name ("typical", "slow" or "ideal"), NULL if there is
+   no such profile */
+const SIM_SDHC_PROFILE* SIM_SDHC_ProfileGet( const char* name );
+
+/* Applies "key=value" to a profile. The keys are read_access_us,
+   read_gap_us, write_block_us, write_random_us, write_stop_us,
+   power_up_ms and high_speed. Returns false for an unknown key. */
+bool SIM_SDHC_ProfileSet( SIM_SDHC_PROFILE* profile, const char* assignment );
+
+/* Inserts or removes the card and raises the card detect interrupt. A
+   transfer in progress on a removed card never completes. */
+void SIM_SDHC_CardInsert( bool isInserted );
+
+/* Raises the error on the next count commands or data transfers */
+void SIM_SDHC_ErrorInject( SIM_SDHC_ERROR error, uint32_t count );
+
+void SIM_SDHC_StatisticsGet( SIM_SDHC_STATISTICS* statistics );
+
+void SIM_SDHC_StatisticsReset( void );
+
+/* Writes one line per command to the stream, or stops with NULL */
+void SIM_SDHC_TraceSet( FILE* stream );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_SDHC_H
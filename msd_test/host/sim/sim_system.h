@@ -0,0 +1,95 @@
+/*******************************************************************************
+  Simulated System Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_system.h
+
+  Summary
+    Initialization and tasks of the modules the host build runs.
+
+  Description
+    The host counterpart of initialization.c and tasks.c. It initializes
+    the modules that run on the host with the initialization data of the
+    target, and runs their tasks in a loop that moves the virtual time.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_SYSTEM_H
+#define SIM_SYSTEM_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim_clock.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Initializes TC0, SDHC0, DRV_SDMMC and SYS_TIME as SYS_Initialize does.
+   SIM_CLOCK and SIM_SDHC must be initialized first. */
+void SIM_SYSTEM_Initialize( void );
+
+/* Adds a task to the main loop, after DRV_SDMMC_Tasks and the tasks added
+   before it. SIM_SYSTEM_Initialize removes the added tasks. Returns false if
+   the task table is full. */
+bool SIM_SYSTEM_TasksAdd( void (*task)( void ) );
+
+/* One pass of the main loop: runs the tasks, then moves the virtual time by
+   step, which stands for the processor time of the pass */
+void SIM_SYSTEM_Tasks( SIM_TIME step );
+
+/* Runs passes until isDone returns true or timeout of virtual time has
+   passed. Returns the value of the last isDone. */
+bool SIM_SYSTEM_RunUntil( bool (*isDone)( uintptr_t context ), uintptr_t context,
+                          SIM_TIME step, SIM_TIME timeout );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_SYSTEM_H
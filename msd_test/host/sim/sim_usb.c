@@ -0,0 +1,1440 @@
+/*******************************************************************************
+  Simulated USB Controller and Bus
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_usb.c
+
+  Summary
+    USB peripheral in device mode, full speed bus and host controller.
+
+  Description
+    The bus runs one transaction at a time on the bus event. A transaction
+    is answered when its token goes out, from the registers and the
+    endpoint descriptors as they are at that time, and takes effect on both
+    sides when its handshake ends. A register write moves the register
+    write generation on, which tells the host controller that an endpoint
+    that answered NAK may answer differently now.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stddef.h>
+#include <string.h>
+#include "device.h"
+#include "interrupts.h"
+#include "sim_mmio.h"
+#include "sim_usb.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_USB_REGS_SIZE           (4096U)
+
+#define SIM_USB_ENDPOINTS_NUMBER    (USB_DEVICE_ENDPOINT_NUMBER)
+
+#define SIM_USB_ENDPOINT_OFFSET     ((uint32_t)offsetof(usb_device_registers_t, DEVICE_ENDPOINT))
+#define SIM_USB_ENDPOINT_SIZE       ((uint32_t)sizeof(usb_device_endpoint_registers_t))
+#define SIM_USB_EP_REG(endpoint, reg)                                       \
+    (SIM_USB_ENDPOINT_OFFSET + ((uint32_t)(endpoint) * SIM_USB_ENDPOINT_SIZE) + USB_DEVICE_##reg##_REG_OFST)
+
+/* EPTYPE of a control endpoint */
+#define SIM_USB_EPTYPE_CONTROL      (1U)
+
+/* Bit times of the packets, SYNC, PID, CRC and EOP included, of the gap
+   between two packets of a transaction and of the wait for a handshake that
+   does not come */
+#define SIM_USB_TOKEN_BITS          (35U)
+#define SIM_USB_DATA_BITS           (35U)
+#define SIM_USB_HANDSHAKE_BITS      (19U)
+#define SIM_USB_GAP_BITS            (8U)
+#define SIM_USB_TIMEOUT_BITS        (18U)
+#define SIM_USB_SOF_BITS            (SIM_USB_TOKEN_BITS + SIM_USB_GAP_BITS)
+
+/* No transaction may run into the last bit times of a frame */
+#define SIM_USB_EOF_BITS            (42U)
+
+#define SIM_USB_FRAME_TIME          SIM_TIME_MS(1)
+#define SIM_USB_RESET_TIME          SIM_TIME_MS(10)
+
+/* From a flag to the first instruction of the handler */
+#define SIM_USB_INTERRUPT_LATENCY   SIM_TIME_US(1)
+
+#define SIM_USB_PACKET_SIZE_MAX     (1023U)
+
+/* One queue per endpoint number and direction */
+#define SIM_USB_QUEUES_NUMBER       (32U)
+
+#define SIM_USB_STAGE_SETUP         (0U)
+#define SIM_USB_STAGE_DATA          (1U)
+#define SIM_USB_STAGE_STATUS        (2U)
+
+typedef enum
+{
+    SIM_USB_LINE_OTHER = 0,
+
+    SIM_USB_LINE_SOF,
+
+    SIM_USB_LINE_TRCPT0,
+
+    SIM_USB_LINE_TRCPT1,
+
+    SIM_USB_LINES_NUMBER
+
+} SIM_USB_LINE;
+
+typedef enum
+{
+    SIM_USB_TOKEN_SETUP = 0,
+
+    SIM_USB_TOKEN_OUT,
+
+    SIM_USB_TOKEN_IN,
+
+} SIM_USB_TOKEN;
+
+typedef enum
+{
+    SIM_USB_HANDSHAKE_ACK = 0,
+
+    SIM_USB_HANDSHAKE_NAK,
+
+    SIM_USB_HANDSHAKE_STALL,
+
+    /* The device did not answer */
+    SIM_USB_HANDSHAKE_NONE,
+
+} SIM_USB_HANDSHAKE;
+
+typedef struct
+{
+    SIM_USB_TRANSFER* transfer;
+
+    SIM_USB_TOKEN token;
+
+    uint8_t endpoint;
+
+    SIM_USB_HANDSHAKE handshake;
+
+    uint16_t length;
+
+    uint8_t data[SIM_USB_PACKET_SIZE_MAX];
+
+    uint32_t bits;
+
+    uint32_t payloadBits;
+
+} SIM_USB_TRANSACTION;
+
+typedef struct
+{
+    /* Writable alias of the registers */
+    uint8_t* regs;
+
+    bool isConnected;
+
+    bool isResetting;
+
+    /* The reset has ended and the frames run */
+    bool isRunning;
+
+    /* Moves on with every register write and every change of the transfer
+       queues */
+    uint32_t generation;
+
+    SIM_CLOCK_EVENT lineEvents[SIM_USB_LINES_NUMBER];
+
+    bool isInInterrupt;
+
+    SIM_CLOCK_EVENT resetEvent;
+
+    SIM_CLOCK_EVENT frameEvent;
+
+    SIM_CLOCK_EVENT busEvent;
+
+    uint32_t frameNumber;
+
+    bool isFrameOpen;
+
+    SIM_TIME frameStart;
+
+    uint32_t frameBusyBits;
+
+    uint32_t framePayloadBits;
+
+    uint32_t frameTransactions;
+
+    uint32_t frameBytes;
+
+    SIM_USB_TRANSACTION transaction;
+
+    bool isInFlight;
+
+    SIM_USB_TRANSFER* queueHeads[SIM_USB_QUEUES_NUMBER];
+
+    SIM_USB_TRANSFER* queueTails[SIM_USB_QUEUES_NUMBER];
+
+    /* Next queue to serve after the control queue */
+    uint32_t cursor;
+
+    /* The idle endpoints are polled in the statistics only */
+    bool isPolling;
+
+    SIM_TIME pollStart;
+
+    uint32_t pollRoundBits;
+
+    uint32_t pollRoundNaks;
+
+    SIM_USB_STATISTICS statistics;
+
+    FILE* trace;
+
+} SIM_USB_OBJ;
+
+static SIM_USB_OBJ simUsbObj;
+
+static void (* const simUsbHandlers[SIM_USB_LINES_NUMBER])( void ) =
+{
+    DRV_USBFSV1_OTHER_Handler,
+    DRV_USBFSV1_SOF_HSOF_Handler,
+    DRV_USBFSV1_TRCPT0_Handler,
+    DRV_USBFSV1_TRCPT1_Handler,
+};
+
+static const INT_SOURCE simUsbSources[SIM_USB_LINES_NUMBER] =
+{
+    USB_OTHER_IRQn,
+    USB_SOF_HSOF_IRQn,
+    USB_TRCPT0_IRQn,
+    USB_TRCPT1_IRQn,
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Register Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint8_t SIM_USB_Read8( uint32_t offset )
+{
+    return simUsbObj.regs[offset];
+}
+
+static uint16_t SIM_USB_Read16( uint32_t offset )
+{
+    uint16_t value;
+
+    memcpy(&value, &simUsbObj.regs[offset], sizeof(value));
+    return value;
+}
+
+static uint32_t SIM_USB_Read32( uint32_t offset )
+{
+    uint32_t value;
+
+    memcpy(&value, &simUsbObj.regs[offset], sizeof(value));
+    return value;
+}
+
+static void SIM_USB_Write8( uint32_t offset, uint8_t value )
+{
+    simUsbObj.regs[offset] = value;
+}
+
+static void SIM_USB_Write16( uint32_t offset, uint16_t value )
+{
+    memcpy(&simUsbObj.regs[offset], &value, sizeof(value));
+}
+
+static void SIM_USB_Write32( uint32_t offset, uint32_t value )
+{
+    memcpy(&simUsbObj.regs[offset], &value, sizeof(value));
+}
+
+/* Bank of an endpoint in the descriptor table at DESCADD, NULL if DESCADD
+   is not set */
+static usb_device_desc_bank_registers_t* SIM_USB_BankGet( uint8_t endpoint, uint32_t bank )
+{
+    usb_descriptor_device_registers_t* table;
+
+    table = (usb_descriptor_device_registers_t*)(uintptr_t)SIM_USB_Read32(USB_DESCADD_REG_OFST);
+    return (table == NULL) ? NULL : &table[endpoint].DEVICE_DESC_BANK[bank];
+}
+
+/* Clears the state a USB reset or a disabled peripheral does not keep */
+static void SIM_USB_EndpointsReset( void )
+{
+    uint32_t endpoint;
+
+    for (endpoint = 0U; endpoint < SIM_USB_ENDPOINTS_NUMBER; endpoint++)
+    {
+        memset(&simUsbObj.regs[SIM_USB_EP_REG(endpoint, EPCFG)], 0, SIM_USB_ENDPOINT_SIZE);
+    }
+    SIM_USB_Write8(USB_DEVICE_DADD_REG_OFST, 0U);
+}
+
+static void SIM_USB_RegistersReset( void )
+{
+    memset(simUsbObj.regs, 0, SIM_USB_REGS_SIZE);
+    SIM_USB_Write16(USB_DEVICE_CTRLB_REG_OFST, USB_DEVICE_CTRLB_DETACH_Msk);
+}
+
+/* Updates EPINTSMRY and raises or drops the interrupt lines */
+static void SIM_USB_RegistersUpdate( void )
+{
+    bool lines[SIM_USB_LINES_NUMBER] = { false };
+    uint16_t summary = 0U;
+    uint16_t flags;
+    uint8_t epFlags;
+    uint32_t endpoint;
+    uint32_t line;
+
+    for (endpoint = 0U; endpoint < SIM_USB_ENDPOINTS_NUMBER; endpoint++)
+    {
+        epFlags = SIM_USB_Read8(SIM_USB_EP_REG(endpoint, EPINTFLAG)) &
+                  SIM_USB_Read8(SIM_USB_EP_REG(endpoint, EPINTENSET));
+        if (epFlags != 0U)
+        {
+            summary |= (uint16_t)(1U << endpoint);
+        }
+        lines[SIM_USB_LINE_TRCPT0] |= ((epFlags & USB_DEVICE_EPINTFLAG_TRCPT0_Msk) != 0U);
+        lines[SIM_USB_LINE_TRCPT1] |= ((epFlags & USB_DEVICE_EPINTFLAG_TRCPT1_Msk) != 0U);
+        lines[SIM_USB_LINE_OTHER] |= ((epFlags & ~USB_DEVICE_EPINTFLAG_TRCPT_Msk) != 0U);
+    }
+    SIM_USB_Write16(USB_DEVICE_EPINTSMRY_REG_OFST, summary);
+
+    flags = SIM_USB_Read16(USB_DEVICE_INTFLAG_REG_OFST) & SIM_USB_Read16(USB_DEVICE_INTENSET_REG_OFST);
+    lines[SIM_USB_LINE_SOF] = ((flags & USB_DEVICE_INTFLAG_SOF_Msk) != 0U);
+    lines[SIM_USB_LINE_OTHER] |= ((flags & ~USB_DEVICE_INTFLAG_SOF_Msk) != 0U);
+
+    /* A handler in progress looks at all the flags before it returns */
+    if (simUsbObj.isInInterrupt)
+    {
+        return;
+    }
+
+    for (line = 0U; line < SIM_USB_LINES_NUMBER; line++)
+    {
+        SIM_CLOCK_EVENT* event = &simUsbObj.lineEvents[line];
+
+        if (lines[line] && !event->isScheduled)
+        {
+            SIM_CLOCK_EventSchedule(event, SIM_CLOCK_Now() + SIM_USB_INTERRUPT_LATENCY);
+        }
+        else if (!lines[line] && event->isScheduled)
+        {
+            SIM_CLOCK_EventCancel(event);
+        }
+    }
+}
+
+static void SIM_USB_LineHandler( uintptr_t context )
+{
+    simUsbObj.isInInterrupt = true;
+    simUsbHandlers[context]();
+    simUsbObj.isInInterrupt = false;
+
+    SIM_USB_RegistersUpdate();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Bus Timing Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* 12 bits per microsecond */
+static SIM_TIME SIM_USB_BitsToTime( uint64_t bits )
+{
+    return ((bits * 250U) + 2U) / 3U;
+}
+
+static uint64_t SIM_USB_TimeToBits( SIM_TIME time )
+{
+    return ((time * 3U) + 249U) / 250U;
+}
+
+/* Data bits on the wire, with a stuffed bit after six ones in a row */
+static uint32_t SIM_USB_PayloadBits( const uint8_t* data, uint32_t length )
+{
+    uint32_t bits = length * 8U;
+    uint32_t ones = 0U;
+    uint32_t index;
+    uint32_t bit;
+
+    for (index = 0U; index < length; index++)
+    {
+        for (bit = 0U; bit < 8U; bit++)
+        {
+            if ((data[index] & (1U << bit)) == 0U)
+            {
+                ones = 0U;
+            }
+            else if (++ones == 6U)
+            {
+                bits++;
+                ones = 0U;
+            }
+        }
+    }
+    return bits;
+}
+
+/* Bit time in the current frame */
+static uint32_t SIM_USB_FramePosition( void )
+{
+    return (uint32_t)SIM_USB_TimeToBits(SIM_CLOCK_Now() - simUsbObj.frameStart);
+}
+
+static SIM_TIME SIM_USB_FrameGuardTime( void )
+{
+    return simUsbObj.frameStart + SIM_USB_BitsToTime(SIM_USB_FRAME_BITS - SIM_USB_EOF_BITS);
+}
+
+static uint32_t SIM_USB_TransactionBits( SIM_USB_TOKEN token, SIM_USB_HANDSHAKE handshake, uint32_t payloadBits )
+{
+    uint32_t bits = SIM_USB_TOKEN_BITS;
+
+    if (token == SIM_USB_TOKEN_IN)
+    {
+        if (handshake == SIM_USB_HANDSHAKE_NONE)
+        {
+            return bits + SIM_USB_TIMEOUT_BITS;
+        }
+        bits += SIM_USB_GAP_BITS;
+        if (handshake == SIM_USB_HANDSHAKE_ACK)
+        {
+            /* Data from the device, ACK from the host */
+            bits += SIM_USB_DATA_BITS + payloadBits + SIM_USB_GAP_BITS;
+        }
+        return bits + SIM_USB_HANDSHAKE_BITS + SIM_USB_GAP_BITS;
+    }
+
+    bits += SIM_USB_GAP_BITS + SIM_USB_DATA_BITS + payloadBits;
+    if (handshake == SIM_USB_HANDSHAKE_NONE)
+    {
+        return bits + SIM_USB_TIMEOUT_BITS;
+    }
+    return bits + SIM_USB_GAP_BITS + SIM_USB_HANDSHAKE_BITS + SIM_USB_GAP_BITS;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Transfer Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t SIM_USB_QueueIndex( const SIM_USB_TRANSFER* transfer )
+{
+    uint32_t index = transfer->endpoint & 0x0FU;
+
+    if ((transfer->type != SIM_USB_TRANSFER_CONTROL) && ((transfer->endpoint & 0x80U) != 0U))
+    {
+        index += 16U;
+    }
+    return index;
+}
+
+static void SIM_USB_QueueRemove( SIM_USB_TRANSFER* transfer )
+{
+    uint32_t index = SIM_USB_QueueIndex(transfer);
+    SIM_USB_TRANSFER** link = &simUsbObj.queueHeads[index];
+    SIM_USB_TRANSFER* previous = NULL;
+
+    while (*link != NULL)
+    {
+        if (*link == transfer)
+        {
+            *link = transfer->next;
+            if (simUsbObj.queueTails[index] == transfer)
+            {
+                simUsbObj.queueTails[index] = previous;
+            }
+            break;
+        }
+        previous = *link;
+        link = &(*link)->next;
+    }
+    transfer->next = NULL;
+}
+
+/* Direction of the data stage of a control transfer, or of the transfer */
+static bool SIM_USB_IsIn( const SIM_USB_TRANSFER* transfer )
+{
+    if (transfer->type == SIM_USB_TRANSFER_CONTROL)
+    {
+        return ((transfer->setup[0] & 0x80U) != 0U);
+    }
+    return ((transfer->endpoint & 0x80U) != 0U);
+}
+
+static const char* SIM_USB_TypeName( SIM_USB_TRANSFER_TYPE type )
+{
+    static const char* const names[] = { "control", "bulk", "interrupt" };
+
+    return names[type];
+}
+
+static const char* SIM_USB_StatusName( SIM_USB_TRANSFER_STATUS status )
+{
+    static const char* const names[] = { "pending", "ok", "stall", "noresp", "cancel" };
+
+    return names[status];
+}
+
+static void SIM_USB_TransferEnd( SIM_USB_TRANSFER* transfer, SIM_USB_TRANSFER_STATUS status )
+{
+    SIM_TIME now = SIM_CLOCK_Now();
+
+    SIM_USB_QueueRemove(transfer);
+
+    transfer->status = status;
+    transfer->endTime = now;
+    if (!transfer->isStarted)
+    {
+        transfer->startTime = now;
+        transfer->startFrame = simUsbObj.frameNumber;
+    }
+    transfer->frames = simUsbObj.frameNumber - transfer->startFrame + 1U;
+    simUsbObj.statistics.transfers++;
+
+    if (simUsbObj.trace != NULL)
+    {
+        uint8_t endpoint = transfer->endpoint;
+
+        if ((transfer->type == SIM_USB_TRANSFER_CONTROL) && SIM_USB_IsIn(transfer))
+        {
+            endpoint |= 0x80U;
+        }
+        fprintf(simUsbObj.trace, "usb t=%llu ep=0x%02x type=%s len=%lu actual=%lu status=%s us=%llu wait=%llu frames=%lu packets=%lu naks=%lu\n",
+                (unsigned long long)(now / 1000U),
+                (unsigned int)endpoint,
+                SIM_USB_TypeName(transfer->type),
+                (unsigned long)transfer->length,
+                (unsigned long)transfer->actualLength,
+                SIM_USB_StatusName(status),
+                (unsigned long long)((now - transfer->submitTime) / 1000U),
+                (unsigned long long)((transfer->startTime - transfer->submitTime) / 1000U),
+                (unsigned long)transfer->frames,
+                (unsigned long)transfer->packets,
+                (unsigned long)transfer->naks);
+    }
+
+    if (transfer->callback != NULL)
+    {
+        transfer->callback(transfer);
+    }
+}
+
+static void SIM_USB_TransfersEnd( SIM_USB_TRANSFER_STATUS status )
+{
+    uint32_t index;
+
+    for (index = 0U; index < SIM_USB_QUEUES_NUMBER; index++)
+    {
+        while (simUsbObj.queueHeads[index] != NULL)
+        {
+            SIM_USB_TransferEnd(simUsbObj.queueHeads[index], status);
+        }
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Bus Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Ends the polling of the idle endpoints at the given time, or at the end
+   of frame guard, on a whole round. Returns the end of the last round. */
+static SIM_TIME SIM_USB_PollingEnd( SIM_TIME time )
+{
+    SIM_TIME guard = SIM_USB_FrameGuardTime();
+    SIM_TIME end;
+    uint64_t rounds;
+    uint32_t index;
+
+    if (!simUsbObj.isPolling)
+    {
+        return time;
+    }
+    simUsbObj.isPolling = false;
+
+    /* The round in progress at the given time ends, if it fits */
+    rounds = 0U;
+    if (time > simUsbObj.pollStart)
+    {
+        rounds = (SIM_USB_TimeToBits(time - simUsbObj.pollStart) + simUsbObj.pollRoundBits - 1U) / simUsbObj.pollRoundBits;
+    }
+    end = simUsbObj.pollStart + SIM_USB_BitsToTime(rounds * simUsbObj.pollRoundBits);
+    while ((rounds > 0U) && (end > guard))
+    {
+        rounds--;
+        end = simUsbObj.pollStart + SIM_USB_BitsToTime(rounds * simUsbObj.pollRoundBits);
+    }
+
+    simUsbObj.frameBusyBits += (uint32_t)(rounds * simUsbObj.pollRoundBits);
+    simUsbObj.statistics.nakBits += rounds * simUsbObj.pollRoundBits;
+    simUsbObj.statistics.naks += rounds * simUsbObj.pollRoundNaks;
+    for (index = 0U; index < SIM_USB_QUEUES_NUMBER; index++)
+    {
+        SIM_USB_TRANSFER* transfer = simUsbObj.queueHeads[index];
+
+        if ((transfer != NULL) && (transfer->nakGeneration == simUsbObj.generation) && (transfer->nakBits != 0U))
+        {
+            transfer->naks += (uint32_t)rounds;
+        }
+    }
+    return end;
+}
+
+/* The next transaction starts after the SOF, or after a polling round */
+static void SIM_USB_BusSchedule( SIM_TIME time )
+{
+    if (simUsbObj.isRunning && !simUsbObj.isInFlight)
+    {
+        SIM_CLOCK_EventSchedule(&simUsbObj.busEvent, time);
+    }
+}
+
+/* Tells the host controller that the answer of an endpoint may have
+   changed */
+static void SIM_USB_BusWake( void )
+{
+    SIM_TIME now = SIM_CLOCK_Now();
+
+    simUsbObj.generation++;
+    if (simUsbObj.isPolling)
+    {
+        SIM_USB_BusSchedule(SIM_USB_PollingEnd(now));
+    }
+    else if (!simUsbObj.busEvent.isScheduled)
+    {
+        SIM_USB_BusSchedule(now);
+    }
+}
+
+static void SIM_USB_BusStop( SIM_USB_TRANSFER_STATUS status )
+{
+    simUsbObj.isRunning = false;
+    simUsbObj.isResetting = false;
+    simUsbObj.isInFlight = false;
+    simUsbObj.isPolling = false;
+    simUsbObj.isFrameOpen = false;
+    SIM_CLOCK_EventCancel(&simUsbObj.resetEvent);
+    SIM_CLOCK_EventCancel(&simUsbObj.frameEvent);
+    SIM_CLOCK_EventCancel(&simUsbObj.busEvent);
+
+    SIM_USB_TransfersEnd(status);
+}
+
+static void SIM_USB_ConnectionUpdate( void )
+{
+    bool isConnected = ((SIM_USB_Read8(USB_CTRLA_REG_OFST) & USB_CTRLA_ENABLE_Msk) != 0U) &&
+                       ((SIM_USB_Read16(USB_DEVICE_CTRLB_REG_OFST) & USB_DEVICE_CTRLB_DETACH_Msk) == 0U);
+
+    if (isConnected != simUsbObj.isConnected)
+    {
+        simUsbObj.isConnected = isConnected;
+        if (!isConnected)
+        {
+            SIM_USB_BusStop(SIM_USB_TRANSFER_NO_RESPONSE);
+        }
+    }
+}
+
+/* Picks the transfer of the next transaction: the control queue first, then
+   the other queues in turn. The transaction must end before the end of
+   frame guard, with a packet of maxPacketSize bytes for an IN token. */
+static SIM_USB_TRANSFER* SIM_USB_TransferPick( void )
+{
+    uint32_t position = SIM_USB_FramePosition();
+    uint32_t count;
+    uint32_t index;
+
+    for (count = 0U; count <= SIM_USB_QUEUES_NUMBER; count++)
+    {
+        SIM_USB_TRANSFER* transfer;
+        uint32_t payload;
+        bool isIn;
+
+        /* The control queue of endpoint 0 on each pass, then the next one */
+        index = (count == 0U) ? 0U : ((simUsbObj.cursor + count - 1U) % SIM_USB_QUEUES_NUMBER);
+        transfer = simUsbObj.queueHeads[index];
+        if ((transfer == NULL) || ((count != 0U) && (index == 0U)))
+        {
+            continue;
+        }
+
+        if ((transfer->type == SIM_USB_TRANSFER_INTERRUPT) && transfer->isStarted &&
+            ((simUsbObj.frameNumber - transfer->lastFrame) < ((transfer->interval == 0U) ? 1U : transfer->interval)))
+        {
+            continue;
+        }
+
+        isIn = SIM_USB_IsIn(transfer);
+        if (transfer->stage == SIM_USB_STAGE_SETUP)
+        {
+            payload = 8U;
+            isIn = false;
+        }
+        else if (transfer->stage == SIM_USB_STAGE_STATUS)
+        {
+            payload = 0U;
+            isIn = !isIn || (transfer->length == 0U);
+        }
+        else if (isIn)
+        {
+            payload = transfer->maxPacketSize;
+        }
+        else
+        {
+            payload = transfer->length - transfer->actualLength;
+            if (payload > transfer->maxPacketSize)
+            {
+                payload = transfer->maxPacketSize;
+            }
+        }
+
+        /* Bit stuffing adds at most a bit in six */
+        payload = (payload * 8U) + ((payload * 8U) / 6U);
+        if ((position + SIM_USB_TransactionBits(isIn ? SIM_USB_TOKEN_IN : SIM_USB_TOKEN_OUT, SIM_USB_HANDSHAKE_ACK, payload)) >
+            (SIM_USB_FRAME_BITS - SIM_USB_EOF_BITS))
+        {
+            continue;
+        }
+
+        if (index != 0U)
+        {
+            simUsbObj.cursor = (index + 1U) % SIM_USB_QUEUES_NUMBER;
+        }
+        return transfer;
+    }
+    return NULL;
+}
+
+/* Answer of the device to the token, and the data of an IN packet */
+static void SIM_USB_DeviceAnswer( SIM_USB_TRANSACTION* transaction, uint8_t address )
+{
+    uint8_t endpoint = transaction->endpoint;
+    uint8_t dadd = SIM_USB_Read8(USB_DEVICE_DADD_REG_OFST);
+    uint8_t config;
+    uint8_t status;
+    usb_device_desc_bank_registers_t* bank;
+    uint32_t count;
+
+    transaction->handshake = SIM_USB_HANDSHAKE_NONE;
+    if (!simUsbObj.isConnected || ((dadd & USB_DEVICE_DADD_ADDEN_Msk) == 0U) ||
+        ((dadd & USB_DEVICE_DADD_DADD_Msk) != address) || (endpoint >= SIM_USB_ENDPOINTS_NUMBER))
+    {
+        return;
+    }
+
+    config = SIM_USB_Read8(SIM_USB_EP_REG(endpoint, EPCFG));
+    status = SIM_USB_Read8(SIM_USB_EP_REG(endpoint, EPSTATUS));
+    switch (transaction->token)
+    {
+        case SIM_USB_TOKEN_SETUP:
+            if ((config & USB_DEVICE_EPCFG_EPTYPE0_Msk) == USB_DEVICE_EPCFG_EPTYPE0(SIM_USB_EPTYPE_CONTROL))
+            {
+                transaction->handshake = SIM_USB_HANDSHAKE_ACK;
+            }
+            break;
+
+        case SIM_USB_TOKEN_OUT:
+            if ((config & USB_DEVICE_EPCFG_EPTYPE0_Msk) == 0U)
+            {
+                break;
+            }
+            if ((status & USB_DEVICE_EPSTATUS_STALLRQ0_Msk) != 0U)
+            {
+                transaction->handshake = SIM_USB_HANDSHAKE_STALL;
+            }
+            else if ((status & USB_DEVICE_EPSTATUS_BK0RDY_Msk) != 0U)
+            {
+                transaction->handshake = SIM_USB_HANDSHAKE_NAK;
+            }
+            else
+            {
+                transaction->handshake = SIM_USB_HANDSHAKE_ACK;
+            }
+            break;
+
+        case SIM_USB_TOKEN_IN:
+        default:
+            if (((config & USB_DEVICE_EPCFG_EPTYPE1_Msk) == 0U) &&
+                ((config & USB_DEVICE_EPCFG_EPTYPE0_Msk) != USB_DEVICE_EPCFG_EPTYPE0(SIM_USB_EPTYPE_CONTROL)))
+            {
+                break;
+            }
+            if ((status & USB_DEVICE_EPSTATUS_STALLRQ1_Msk) != 0U)
+            {
+                transaction->handshake = SIM_USB_HANDSHAKE_STALL;
+                break;
+            }
+            if ((status & USB_DEVICE_EPSTATUS_BK1RDY_Msk) == 0U)
+            {
+                transaction->handshake = SIM_USB_HANDSHAKE_NAK;
+                break;
+            }
+            bank = SIM_USB_BankGet(endpoint, 1U);
+            if (bank == NULL)
+            {
+                break;
+            }
+            count = (bank->USB_PCKSIZE & USB_DEVICE_PCKSIZE_BYTE_COUNT_Msk) >> USB_DEVICE_PCKSIZE_BYTE_COUNT_Pos;
+            if (count > SIM_USB_PACKET_SIZE_MAX)
+            {
+                count = SIM_USB_PACKET_SIZE_MAX;
+            }
+            memcpy(transaction->data, (const void*)(uintptr_t)bank->USB_ADDR, count);
+            transaction->length = (uint16_t)count;
+            transaction->handshake = SIM_USB_HANDSHAKE_ACK;
+            break;
+    }
+}
+
+/* Effect of an acknowledged packet on the device */
+static void SIM_USB_DeviceReceive( const SIM_USB_TRANSACTION* transaction )
+{
+    uint8_t endpoint = transaction->endpoint;
+    usb_device_desc_bank_registers_t* bank;
+    uint8_t status = SIM_USB_Read8(SIM_USB_EP_REG(endpoint, EPSTATUS));
+    uint8_t flags = SIM_USB_Read8(SIM_USB_EP_REG(endpoint, EPINTFLAG));
+
+    if (transaction->token == SIM_USB_TOKEN_IN)
+    {
+        status &= (uint8_t)~USB_DEVICE_EPSTATUS_BK1RDY_Msk;
+        flags |= USB_DEVICE_EPINTFLAG_TRCPT1_Msk;
+    }
+    else
+    {
+        bank = SIM_USB_BankGet(endpoint, 0U);
+        if (bank != NULL)
+        {
+            memcpy((void*)(uintptr_t)bank->USB_ADDR, transaction->data, transaction->length);
+            bank->USB_PCKSIZE = (bank->USB_PCKSIZE & ~USB_DEVICE_PCKSIZE_BYTE_COUNT_Msk) |
+                                USB_DEVICE_PCKSIZE_BYTE_COUNT(transaction->length);
+        }
+        status |= USB_DEVICE_EPSTATUS_BK0RDY_Msk;
+        if (transaction->token == SIM_USB_TOKEN_SETUP)
+        {
+            /* A SETUP packet clears the stall of the control endpoint */
+            status &= (uint8_t)~USB_DEVICE_EPSTATUS_STALLRQ_Msk;
+            flags |= USB_DEVICE_EPINTFLAG_RXSTP_Msk;
+        }
+        else
+        {
+            flags |= USB_DEVICE_EPINTFLAG_TRCPT0_Msk;
+        }
+    }
+
+    SIM_USB_Write8(SIM_USB_EP_REG(endpoint, EPSTATUS), status);
+    SIM_USB_Write8(SIM_USB_EP_REG(endpoint, EPINTFLAG), flags);
+    SIM_USB_RegistersUpdate();
+}
+
+/* Effect of an acknowledged packet on the transfer. Returns true when the
+   transfer is complete. */
+static bool SIM_USB_HostReceive( SIM_USB_TRANSFER* transfer, const SIM_USB_TRANSACTION* transaction )
+{
+    uint32_t length = transaction->length;
+    bool isShort = (length < transfer->maxPacketSize);
+
+    transfer->packets++;
+
+    switch (transfer->stage)
+    {
+        case SIM_USB_STAGE_SETUP:
+            transfer->stage = (transfer->length == 0U) ? SIM_USB_STAGE_STATUS : SIM_USB_STAGE_DATA;
+            return false;
+
+        case SIM_USB_STAGE_STATUS:
+            return true;
+
+        case SIM_USB_STAGE_DATA:
+        default:
+            break;
+    }
+
+    if (transaction->token == SIM_USB_TOKEN_IN)
+    {
+        if (length > (transfer->length - transfer->actualLength))
+        {
+            /* Babble: the packet does not fit the buffer */
+            length = transfer->length - transfer->actualLength;
+        }
+        memcpy(&transfer->buffer[transfer->actualLength], transaction->data, length);
+        transfer->actualLength += length;
+        simUsbObj.statistics.inBytes += length;
+
+        if (!isShort && (transfer->actualLength < transfer->length))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        transfer->actualLength += length;
+        simUsbObj.statistics.outBytes += length;
+
+        if (transfer->actualLength < transfer->length)
+        {
+            return false;
+        }
+        if (!isShort && transfer->zeroLengthPacket && (transfer->type != SIM_USB_TRANSFER_CONTROL))
+        {
+            /* A zero length packet follows a last packet of maxPacketSize */
+            return false;
+        }
+    }
+    if (transfer->type == SIM_USB_TRANSFER_CONTROL)
+    {
+        transfer->stage = SIM_USB_STAGE_STATUS;
+        return false;
+    }
+    return true;
+}
+
+static void SIM_USB_TransactionStart( void )
+{
+    SIM_USB_TRANSACTION* transaction = &simUsbObj.transaction;
+    SIM_USB_TRANSFER* transfer;
+    SIM_USB_STATISTICS* statistics = &simUsbObj.statistics;
+    uint32_t index;
+    uint32_t remaining;
+    bool isIn;
+
+    if (!simUsbObj.isRunning || simUsbObj.isPolling)
+    {
+        return;
+    }
+
+    transfer = SIM_USB_TransferPick();
+    if (transfer == NULL)
+    {
+        /* Nothing to do, or nothing fits before the next SOF */
+        return;
+    }
+
+    if ((transfer->nakGeneration == simUsbObj.generation) && (transfer->nakBits != 0U))
+    {
+        /* The round came back to an endpoint that answered NAK since the
+           last register write: poll in the statistics only */
+        simUsbObj.isPolling = true;
+        simUsbObj.pollStart = SIM_CLOCK_Now();
+        simUsbObj.pollRoundBits = 0U;
+        simUsbObj.pollRoundNaks = 0U;
+        for (index = 0U; index < SIM_USB_QUEUES_NUMBER; index++)
+        {
+            SIM_USB_TRANSFER* head = simUsbObj.queueHeads[index];
+
+            if ((head != NULL) && (head->nakGeneration == simUsbObj.generation) && (head->nakBits != 0U))
+            {
+                simUsbObj.pollRoundBits += head->nakBits;
+                simUsbObj.pollRoundNaks++;
+            }
+        }
+        return;
+    }
+
+    transaction->transfer = transfer;
+    transaction->endpoint = transfer->endpoint & 0x0FU;
+    transaction->length = 0U;
+    isIn = SIM_USB_IsIn(transfer);
+    if (transfer->stage == SIM_USB_STAGE_SETUP)
+    {
+        transaction->token = SIM_USB_TOKEN_SETUP;
+        transaction->length = 8U;
+        memcpy(transaction->data, transfer->setup, 8U);
+    }
+    else if (transfer->stage == SIM_USB_STAGE_STATUS)
+    {
+        transaction->token = (!isIn || (transfer->length == 0U)) ? SIM_USB_TOKEN_IN : SIM_USB_TOKEN_OUT;
+    }
+    else if (isIn)
+    {
+        transaction->token = SIM_USB_TOKEN_IN;
+    }
+    else
+    {
+        transaction->token = SIM_USB_TOKEN_OUT;
+        remaining = transfer->length - transfer->actualLength;
+        transaction->length = (remaining > transfer->maxPacketSize) ? transfer->maxPacketSize : (uint16_t)remaining;
+        memcpy(transaction->data, &transfer->buffer[transfer->actualLength], transaction->length);
+    }
+
+    SIM_USB_DeviceAnswer(transaction, transfer->address);
+    if ((transaction->token == SIM_USB_TOKEN_IN) && (transaction->handshake == SIM_USB_HANDSHAKE_ACK) &&
+        (transaction->length > transfer->maxPacketSize))
+    {
+        transaction->length = transfer->maxPacketSize;
+    }
+
+    transaction->payloadBits = 0U;
+    if ((transaction->token != SIM_USB_TOKEN_IN) || (transaction->handshake == SIM_USB_HANDSHAKE_ACK))
+    {
+        transaction->payloadBits = SIM_USB_PayloadBits(transaction->data, transaction->length);
+    }
+    transaction->bits = SIM_USB_TransactionBits(transaction->token, transaction->handshake, transaction->payloadBits);
+
+    if (!transfer->isStarted)
+    {
+        transfer->isStarted = true;
+        transfer->startTime = SIM_CLOCK_Now();
+        transfer->startFrame = simUsbObj.frameNumber;
+    }
+    transfer->lastFrame = simUsbObj.frameNumber;
+
+    simUsbObj.frameBusyBits += transaction->bits;
+    switch (transaction->handshake)
+    {
+        case SIM_USB_HANDSHAKE_ACK:
+            statistics->transactions++;
+            statistics->payloadBits += transaction->payloadBits;
+            statistics->overheadBits += transaction->bits - transaction->payloadBits;
+            simUsbObj.framePayloadBits += transaction->payloadBits;
+            simUsbObj.frameTransactions++;
+            simUsbObj.frameBytes += transaction->length;
+            break;
+
+        case SIM_USB_HANDSHAKE_NAK:
+            statistics->naks++;
+            statistics->nakBits += transaction->bits;
+            transfer->naks++;
+            transfer->nakGeneration = simUsbObj.generation;
+            transfer->nakBits = transaction->bits;
+            break;
+
+        case SIM_USB_HANDSHAKE_STALL:
+            statistics->stalls++;
+            statistics->errorBits += transaction->bits;
+            break;
+
+        case SIM_USB_HANDSHAKE_NONE:
+        default:
+            statistics->timeouts++;
+            statistics->errorBits += transaction->bits;
+            break;
+    }
+
+    simUsbObj.isInFlight = true;
+    SIM_CLOCK_EventSchedule(&simUsbObj.busEvent, SIM_CLOCK_Now() + SIM_USB_BitsToTime(transaction->bits));
+}
+
+static void SIM_USB_TransactionEnd( void )
+{
+    SIM_USB_TRANSACTION* transaction = &simUsbObj.transaction;
+    SIM_USB_TRANSFER* transfer = transaction->transfer;
+    bool isComplete = false;
+
+    simUsbObj.isInFlight = false;
+
+    switch (transaction->handshake)
+    {
+        case SIM_USB_HANDSHAKE_ACK:
+            SIM_USB_DeviceReceive(transaction);
+            isComplete = SIM_USB_HostReceive(transfer, transaction);
+            if (isComplete)
+            {
+                SIM_USB_TransferEnd(transfer, SIM_USB_TRANSFER_COMPLETED);
+                return;
+            }
+            break;
+
+        case SIM_USB_HANDSHAKE_NAK:
+            break;
+
+        case SIM_USB_HANDSHAKE_STALL:
+            SIM_USB_Write8(SIM_USB_EP_REG(transaction->endpoint, EPINTFLAG),
+                           SIM_USB_Read8(SIM_USB_EP_REG(transaction->endpoint, EPINTFLAG)) |
+                           ((transaction->token == SIM_USB_TOKEN_IN) ? USB_DEVICE_EPINTFLAG_STALL1_Msk : USB_DEVICE_EPINTFLAG_STALL0_Msk));
+            SIM_USB_RegistersUpdate();
+            SIM_USB_TransferEnd(transfer, SIM_USB_TRANSFER_STALLED);
+            return;
+
+        case SIM_USB_HANDSHAKE_NONE:
+        default:
+            SIM_USB_TransferEnd(transfer, SIM_USB_TRANSFER_NO_RESPONSE);
+            return;
+    }
+
+    if (transfer->isCancelled)
+    {
+        SIM_USB_TransferEnd(transfer, SIM_USB_TRANSFER_CANCELLED);
+    }
+}
+
+static void SIM_USB_BusHandler( uintptr_t context )
+{
+    (void)context;
+
+    if (simUsbObj.isInFlight)
+    {
+        SIM_USB_TransactionEnd();
+    }
+    SIM_USB_TransactionStart();
+}
+
+static void SIM_USB_FrameEnd( void )
+{
+    SIM_USB_STATISTICS* statistics = &simUsbObj.statistics;
+    uint32_t bucket;
+
+    (void)SIM_USB_PollingEnd(SIM_USB_FrameGuardTime());
+
+    statistics->frames++;
+    statistics->busyBits += simUsbObj.frameBusyBits;
+    if (simUsbObj.frameTransactions > statistics->frameTransactionsMax)
+    {
+        statistics->frameTransactionsMax = simUsbObj.frameTransactions;
+    }
+    if (simUsbObj.frameBytes > statistics->frameBytesMax)
+    {
+        statistics->frameBytesMax = simUsbObj.frameBytes;
+    }
+
+    bucket = (simUsbObj.frameBusyBits * 10U) / SIM_USB_FRAME_BITS;
+    if ((simUsbObj.frameBusyBits + SIM_USB_EOF_BITS + SIM_USB_TOKEN_BITS + SIM_USB_GAP_BITS + SIM_USB_HANDSHAKE_BITS + SIM_USB_GAP_BITS) >
+        SIM_USB_FRAME_BITS)
+    {
+        /* Not even a NAK would have fit */
+        bucket = SIM_USB_HISTOGRAM_BUCKETS - 1U;
+    }
+    else if (bucket > 9U)
+    {
+        bucket = 9U;
+    }
+    statistics->busyHistogram[bucket]++;
+
+    bucket = (simUsbObj.framePayloadBits * 10U) / SIM_USB_FRAME_BITS;
+    statistics->payloadHistogram[(bucket > 9U) ? 9U : bucket]++;
+}
+
+static void SIM_USB_FrameHandler( uintptr_t context )
+{
+    SIM_TIME now = SIM_CLOCK_Now();
+    uint16_t fnum;
+
+    (void)context;
+
+    if (simUsbObj.isFrameOpen)
+    {
+        SIM_USB_FrameEnd();
+        simUsbObj.frameNumber++;
+    }
+    simUsbObj.isFrameOpen = true;
+    simUsbObj.frameStart = now;
+    simUsbObj.frameBusyBits = SIM_USB_SOF_BITS;
+    simUsbObj.framePayloadBits = 0U;
+    simUsbObj.frameTransactions = 0U;
+    simUsbObj.frameBytes = 0U;
+    simUsbObj.statistics.overheadBits += SIM_USB_SOF_BITS;
+    SIM_CLOCK_EventSchedule(&simUsbObj.frameEvent, now + SIM_USB_FRAME_TIME);
+
+    fnum = (uint16_t)USB_DEVICE_FNUM_FNUM(simUsbObj.frameNumber);
+    SIM_USB_Write16(USB_DEVICE_FNUM_REG_OFST, fnum);
+    SIM_USB_Write16(USB_DEVICE_INTFLAG_REG_OFST, SIM_USB_Read16(USB_DEVICE_INTFLAG_REG_OFST) | USB_DEVICE_INTFLAG_SOF_Msk);
+    SIM_USB_RegistersUpdate();
+
+    simUsbObj.generation++;
+    if (!simUsbObj.isInFlight)
+    {
+        SIM_USB_BusSchedule(now + SIM_USB_BitsToTime(SIM_USB_SOF_BITS));
+    }
+}
+
+static void SIM_USB_ResetHandler( uintptr_t context )
+{
+    (void)context;
+
+    simUsbObj.isResetting = false;
+    simUsbObj.isRunning = true;
+    simUsbObj.frameNumber = 0U;
+    simUsbObj.isFrameOpen = false;
+
+    SIM_USB_EndpointsReset();
+    SIM_USB_Write8(USB_DEVICE_STATUS_REG_OFST, USB_DEVICE_STATUS_SPEED(USB_DEVICE_STATUS_SPEED_FS_Val));
+    SIM_USB_Write16(USB_DEVICE_INTFLAG_REG_OFST, SIM_USB_Read16(USB_DEVICE_INTFLAG_REG_OFST) | USB_DEVICE_INTFLAG_EORST_Msk);
+    SIM_USB_RegistersUpdate();
+
+    SIM_CLOCK_EventSchedule(&simUsbObj.frameEvent, SIM_CLOCK_Now());
+}
+
+static void SIM_USB_RegisterWrite( uintptr_t context, uint32_t offset, uint64_t value )
+{
+    uint32_t endpoint;
+    uint32_t reg;
+
+    (void)context;
+
+    if ((offset >= SIM_USB_ENDPOINT_OFFSET) &&
+        (offset < (SIM_USB_ENDPOINT_OFFSET + (SIM_USB_ENDPOINTS_NUMBER * SIM_USB_ENDPOINT_SIZE))))
+    {
+        endpoint = (offset - SIM_USB_ENDPOINT_OFFSET) / SIM_USB_ENDPOINT_SIZE;
+        reg = (offset - SIM_USB_ENDPOINT_OFFSET) % SIM_USB_ENDPOINT_SIZE;
+        switch (reg)
+        {
+            case USB_DEVICE_EPCFG_REG_OFST:
+                SIM_USB_Write8(offset, (uint8_t)value);
+                break;
+
+            case USB_DEVICE_EPSTATUSCLR_REG_OFST:
+                offset = SIM_USB_EP_REG(endpoint, EPSTATUS);
+                SIM_USB_Write8(offset, SIM_USB_Read8(offset) & (uint8_t)~value);
+                break;
+
+            case USB_DEVICE_EPSTATUSSET_REG_OFST:
+                offset = SIM_USB_EP_REG(endpoint, EPSTATUS);
+                SIM_USB_Write8(offset, SIM_USB_Read8(offset) | (uint8_t)value);
+                break;
+
+            case USB_DEVICE_EPINTFLAG_REG_OFST:
+                SIM_USB_Write8(offset, SIM_USB_Read8(offset) & (uint8_t)~value);
+                break;
+
+            case USB_DEVICE_EPINTENCLR_REG_OFST:
+                offset = SIM_USB_EP_REG(endpoint, EPINTENSET);
+                SIM_USB_Write8(offset, SIM_USB_Read8(offset) & (uint8_t)~value);
+                break;
+
+            case USB_DEVICE_EPINTENSET_REG_OFST:
+                offset = SIM_USB_EP_REG(endpoint, EPINTENSET);
+                SIM_USB_Write8(offset, SIM_USB_Read8(offset) | (uint8_t)value);
+                break;
+
+            default:
+                /* Read-only or reserved */
+                break;
+        }
+        /* The enable clear register reads as the enables */
+        SIM_USB_Write8(SIM_USB_EP_REG(endpoint, EPINTENCLR), SIM_USB_Read8(SIM_USB_EP_REG(endpoint, EPINTENSET)));
+    }
+    else
+    {
+        switch (offset)
+        {
+            case USB_CTRLA_REG_OFST:
+                if ((value & USB_CTRLA_SWRST_Msk) != 0U)
+                {
+                    SIM_USB_RegistersReset();
+                }
+                else
+                {
+                    SIM_USB_Write8(offset, (uint8_t)value & (USB_CTRLA_ENABLE_Msk | USB_CTRLA_RUNSTDBY_Msk | USB_CTRLA_MODE_Msk));
+                }
+                if ((SIM_USB_Read8(offset) & USB_CTRLA_ENABLE_Msk) == 0U)
+                {
+                    SIM_USB_EndpointsReset();
+                }
+                break;
+
+            case USB_QOSCTRL_REG_OFST:
+            case USB_DEVICE_DADD_REG_OFST:
+                SIM_USB_Write8(offset, (uint8_t)value);
+                break;
+
+            case USB_DEVICE_CTRLB_REG_OFST:
+            case USB_PADCAL_REG_OFST:
+                SIM_USB_Write16(offset, (uint16_t)value);
+                break;
+
+            case USB_DEVICE_INTENCLR_REG_OFST:
+                SIM_USB_Write16(USB_DEVICE_INTENSET_REG_OFST,
+                                SIM_USB_Read16(USB_DEVICE_INTENSET_REG_OFST) & (uint16_t)~value);
+                break;
+
+            case USB_DEVICE_INTENSET_REG_OFST:
+                SIM_USB_Write16(offset, SIM_USB_Read16(offset) | (uint16_t)value);
+                break;
+
+            case USB_DEVICE_INTFLAG_REG_OFST:
+                SIM_USB_Write16(offset, SIM_USB_Read16(offset) & (uint16_t)~value);
+                break;
+
+            case USB_DESCADD_REG_OFST:
+                SIM_USB_Write32(offset, (uint32_t)value);
+                break;
+
+            default:
+                /* SYNCBUSY, STATUS, FSMSTATUS, FNUM and EPINTSMRY are
+                   read-only, and the synchronization never waits */
+                break;
+        }
+        SIM_USB_Write16(USB_DEVICE_INTENCLR_REG_OFST, SIM_USB_Read16(USB_DEVICE_INTENSET_REG_OFST));
+    }
+
+    SIM_USB_ConnectionUpdate();
+    SIM_USB_RegistersUpdate();
+    SIM_USB_BusWake();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+bool SIM_USB_Initialize( void )
+{
+    uint32_t line;
+
+    simUsbObj.regs = SIM_MMIO_WindowMap((uintptr_t)USB_REGS, SIM_USB_REGS_SIZE, SIM_USB_RegisterWrite, 0U);
+    if (simUsbObj.regs == NULL)
+    {
+        return false;
+    }
+
+    simUsbObj.isConnected = false;
+    simUsbObj.isInInterrupt = false;
+    simUsbObj.generation = 0U;
+    simUsbObj.frameNumber = 0U;
+    simUsbObj.cursor = 0U;
+    memset(simUsbObj.queueHeads, 0, sizeof(simUsbObj.queueHeads));
+    memset(simUsbObj.queueTails, 0, sizeof(simUsbObj.queueTails));
+    memset(&simUsbObj.statistics, 0, sizeof(simUsbObj.statistics));
+
+    for (line = 0U; line < SIM_USB_LINES_NUMBER; line++)
+    {
+        SIM_CLOCK_EventInitialize(&simUsbObj.lineEvents[line], simUsbSources[line], SIM_USB_LineHandler, line);
+    }
+    SIM_CLOCK_EventInitialize(&simUsbObj.resetEvent, SIM_CLOCK_SOURCE_NONE, SIM_USB_ResetHandler, 0U);
+    SIM_CLOCK_EventInitialize(&simUsbObj.frameEvent, SIM_CLOCK_SOURCE_NONE, SIM_USB_FrameHandler, 0U);
+    SIM_CLOCK_EventInitialize(&simUsbObj.busEvent, SIM_CLOCK_SOURCE_NONE, SIM_USB_BusHandler, 0U);
+
+    SIM_USB_BusStop(SIM_USB_TRANSFER_CANCELLED);
+    SIM_USB_RegistersReset();
+    return true;
+}
+
+bool SIM_USB_IsConnected( void )
+{
+    return simUsbObj.isConnected;
+}
+
+void SIM_USB_BusReset( void )
+{
+    if (!simUsbObj.isConnected)
+    {
+        return;
+    }
+
+    SIM_USB_BusStop(SIM_USB_TRANSFER_CANCELLED);
+    simUsbObj.isResetting = true;
+    SIM_CLOCK_EventSchedule(&simUsbObj.resetEvent, SIM_CLOCK_Now() + SIM_USB_RESET_TIME);
+}
+
+bool SIM_USB_IsResetting( void )
+{
+    return simUsbObj.isResetting;
+}
+
+uint32_t SIM_USB_FrameNumberGet( void )
+{
+    return simUsbObj.frameNumber;
+}
+
+void SIM_USB_TransferSubmit( SIM_USB_TRANSFER* transfer )
+{
+    uint32_t index = SIM_USB_QueueIndex(transfer);
+
+    transfer->status = SIM_USB_TRANSFER_PENDING;
+    transfer->actualLength = 0U;
+    transfer->submitTime = SIM_CLOCK_Now();
+    transfer->startTime = 0U;
+    transfer->endTime = 0U;
+    transfer->frames = 0U;
+    transfer->packets = 0U;
+    transfer->naks = 0U;
+    transfer->stage = (transfer->type == SIM_USB_TRANSFER_CONTROL) ? SIM_USB_STAGE_SETUP : SIM_USB_STAGE_DATA;
+    transfer->isStarted = false;
+    transfer->isCancelled = false;
+    transfer->nakGeneration = 0U;
+    transfer->nakBits = 0U;
+    transfer->next = NULL;
+
+    if (!simUsbObj.isRunning)
+    {
+        SIM_USB_TransferEnd(transfer, SIM_USB_TRANSFER_NO_RESPONSE);
+        return;
+    }
+
+    if (simUsbObj.queueTails[index] == NULL)
+    {
+        simUsbObj.queueHeads[index] = transfer;
+    }
+    else
+    {
+        simUsbObj.queueTails[index]->next = transfer;
+    }
+    simUsbObj.queueTails[index] = transfer;
+
+    SIM_USB_BusWake();
+}
+
+bool SIM_USB_TransferCancel( SIM_USB_TRANSFER* transfer )
+{
+    if (transfer->status != SIM_USB_TRANSFER_PENDING)
+    {
+        return false;
+    }
+
+    if (simUsbObj.isInFlight && (simUsbObj.transaction.transfer == transfer))
+    {
+        transfer->isCancelled = true;
+        return true;
+    }
+    SIM_USB_TransferEnd(transfer, SIM_USB_TRANSFER_CANCELLED);
+    SIM_USB_BusWake();
+    return true;
+}
+
+void SIM_USB_StatisticsGet( SIM_USB_STATISTICS* statistics )
+{
+    *statistics = simUsbObj.statistics;
+}
+
+void SIM_USB_StatisticsReset( void )
+{
+    memset(&simUsbObj.statistics, 0, sizeof(simUsbObj.statistics));
+}
+
+void SIM_USB_TraceSet( FILE* stream )
+{
+    simUsbObj.trace = stream;
+}
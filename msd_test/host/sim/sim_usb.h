@@ -0,0 +1,327 @@
+/*******************************************************************************
+  Simulated USB Controller and Bus Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_usb.h
+
+  Summary
+    USB peripheral of the host build, on a full speed bus with a host
+    controller at the other end.
+
+  Description
+    sim_usb.c models the USB peripheral in device mode through its
+    registers, so drv_usbfsv1.c and drv_usbfsv1_device.c run unmodified on
+    top of it:
+    - The registers sit in a SIM_MMIO window at USB_REGS. The flag
+      registers clear the bits written as one, the SET and CLR registers
+      change the enable and status registers they stand for, and SWRST
+      resets the peripheral.
+    - The endpoint banks are the descriptors at DESCADD, as on the target:
+      an OUT or SETUP packet is copied to the ADDR of bank 0 with its
+      BYTE_COUNT, and an IN packet takes BYTE_COUNT bytes from the ADDR of
+      bank 1. BK0RDY and BK1RDY decide whether a packet is accepted or sent,
+      and STALLRQ0 and STALLRQ1 stall the endpoint.
+    - The four interrupt lines are raised while an enabled flag of their
+      group is set, and call the DRV_USBFSV1 handlers shortly after, unless
+      SIM_CLOCK masks them.
+
+    The host side submits transfers, which the host controller splits into
+    transactions on the bus:
+    - Each packet, handshake and inter-packet gap takes its time in bits at
+      12 Mbit/s, with the bit stuffing of the data sent. A frame starts with
+      an SOF every millisecond and a transaction only starts if it ends
+      before the end of frame guard.
+    - Control transfers go first, then the bulk and interrupt endpoints in
+      turn, an interrupt endpoint at most once per interval.
+    - An endpoint that answers NAK is polled again. When a whole round only
+      got NAKs and the firmware wrote no register, the polling goes on in
+      the statistics only, until the firmware writes a register or the frame
+      ends, instead of as one event per transaction.
+    - A reset takes 10 ms, then the frames start.
+
+    Data toggles, CRC errors and the retries of a real host controller on
+    a transaction error are not modeled: a transaction the device does not
+    answer ends the transfer.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_USB_H
+#define SIM_USB_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "sim_clock.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Bit times of a full speed frame */
+#define SIM_USB_FRAME_BITS          (12000U)
+
+/* Buckets of the frame utilization histogram, 10 % each and one for the
+   frames that were busy to the end */
+#define SIM_USB_HISTOGRAM_BUCKETS   (11U)
+
+typedef enum
+{
+    SIM_USB_TRANSFER_CONTROL = 0,
+
+    SIM_USB_TRANSFER_BULK,
+
+    SIM_USB_TRANSFER_INTERRUPT,
+
+} SIM_USB_TRANSFER_TYPE;
+
+typedef enum
+{
+    SIM_USB_TRANSFER_PENDING = 0,
+
+    SIM_USB_TRANSFER_COMPLETED,
+
+    /* The device answered a transaction with STALL */
+    SIM_USB_TRANSFER_STALLED,
+
+    /* The device did not answer a transaction, or left the bus */
+    SIM_USB_TRANSFER_NO_RESPONSE,
+
+    /* SIM_USB_TransferCancel or SIM_USB_BusReset ended the transfer */
+    SIM_USB_TRANSFER_CANCELLED,
+
+} SIM_USB_TRANSFER_STATUS;
+
+// *****************************************************************************
+/* Host transfer
+
+  Summary:
+    A transfer the host controller carries out on one endpoint.
+
+  Remarks:
+    The submitter owns the object and sets the fields of the first group.
+    The simulator sets the other fields. The transfers of one endpoint run
+    in the order they were submitted.
+*/
+
+typedef struct SIM_USB_TRANSFER_
+{
+    uint8_t address;
+
+    /* Endpoint number, with 0x80 for an IN endpoint. The direction of a
+       control transfer is the one of its setup packet. */
+    uint8_t endpoint;
+
+    SIM_USB_TRANSFER_TYPE type;
+
+    uint16_t maxPacketSize;
+
+    /* Frames between two transactions of an interrupt endpoint */
+    uint16_t interval;
+
+    uint8_t setup[8];
+
+    /* Data stage of a control transfer, or the data of the transfer */
+    uint8_t* buffer;
+
+    uint32_t length;
+
+    /* Ends an OUT transfer of a multiple of maxPacketSize bytes with a zero
+       length packet */
+    bool zeroLengthPacket;
+
+    /* Called when the transfer ends, from the event that ended it */
+    void (*callback)( struct SIM_USB_TRANSFER_* transfer );
+
+    uintptr_t context;
+
+    SIM_USB_TRANSFER_STATUS status;
+
+    uint32_t actualLength;
+
+    SIM_TIME submitTime;
+
+    /* Start of the first transaction, and end of the transfer */
+    SIM_TIME startTime;
+
+    SIM_TIME endTime;
+
+    /* Frames from the first transaction to the end */
+    uint32_t frames;
+
+    /* Transactions the device acknowledged, and answered with NAK */
+    uint32_t packets;
+
+    uint32_t naks;
+
+    /* Simulator state */
+    uint8_t stage;
+
+    bool isStarted;
+
+    bool isCancelled;
+
+    uint32_t startFrame;
+
+    uint32_t lastFrame;
+
+    /* Register write generation of the last NAK, and its bit times */
+    uint32_t nakGeneration;
+
+    uint32_t nakBits;
+
+    struct SIM_USB_TRANSFER_* next;
+
+} SIM_USB_TRANSFER;
+
+// *****************************************************************************
+/* Bus statistics
+
+  Summary:
+    Counters since SIM_USB_Initialize or SIM_USB_StatisticsReset.
+
+  Remarks:
+    The bit counts only cover frames that have ended. The busy bits of a
+    frame are its SOF and all the transactions in it, whatever their
+    outcome; its payload bits are the data bits of the acknowledged data
+    packets, bit stuffing included.
+*/
+
+typedef struct
+{
+    uint32_t frames;
+
+    uint64_t busyBits;
+
+    uint64_t payloadBits;
+
+    /* Tokens, handshakes, packet identifiers, CRCs, gaps and SOFs of the
+       acknowledged transactions */
+    uint64_t overheadBits;
+
+    /* Transactions answered with NAK, including the ones accounted while
+       polling idle endpoints */
+    uint64_t nakBits;
+
+    /* Stalled transactions and transactions without answer */
+    uint64_t errorBits;
+
+    uint64_t transactions;
+
+    uint64_t naks;
+
+    uint32_t stalls;
+
+    uint32_t timeouts;
+
+    uint64_t inBytes;
+
+    uint64_t outBytes;
+
+    uint32_t transfers;
+
+    /* Most transactions and payload bytes a frame carried */
+    uint32_t frameTransactionsMax;
+
+    uint32_t frameBytesMax;
+
+    /* Frames by the share of their bit times the bus was busy: [0] below
+       10 %, [9] from 90 % and [10] busy up to the end of frame guard */
+    uint32_t busyHistogram[SIM_USB_HISTOGRAM_BUCKETS];
+
+    /* Frames by the share of their bit times that carried payload, in the
+       same buckets */
+    uint32_t payloadHistogram[SIM_USB_HISTOGRAM_BUCKETS];
+
+} SIM_USB_STATISTICS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Maps the registers, or resets them if they are mapped, and disconnects
+   the bus. Call it after SIM_CLOCK_Initialize and SIM_CORE_Initialize and
+   before DRV_USBFSV1_Initialize. Returns false if the registers cannot be
+   mapped. */
+bool SIM_USB_Initialize( void );
+
+/* The peripheral is enabled and not detached, so the device pulls D+ up */
+bool SIM_USB_IsConnected( void );
+
+/* Resets the bus for 10 ms and cancels the transfers in progress. The
+   frames start when the reset ends. Does nothing while disconnected. */
+void SIM_USB_BusReset( void );
+
+/* A reset is in progress */
+bool SIM_USB_IsResetting( void );
+
+/* Number of the last SOF sent, counting from the end of the first reset */
+uint32_t SIM_USB_FrameNumberGet( void );
+
+/* Queues the transfer on its endpoint. A transfer submitted while the bus is
+   not running ends at once with SIM_USB_TRANSFER_NO_RESPONSE. */
+void SIM_USB_TransferSubmit( SIM_USB_TRANSFER* transfer );
+
+/* Ends a pending transfer with SIM_USB_TRANSFER_CANCELLED, after the
+   transaction it is in. Returns false if the transfer is not pending. */
+bool SIM_USB_TransferCancel( SIM_USB_TRANSFER* transfer );
+
+void SIM_USB_StatisticsGet( SIM_USB_STATISTICS* statistics );
+
+void SIM_USB_StatisticsReset( void );
+
+/* Writes one line per transfer that ends to the stream, or stops with
+   NULL */
+void SIM_USB_TraceSet( FILE* stream );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_USB_H
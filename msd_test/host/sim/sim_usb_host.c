@@ -0,0 +1,598 @@
+/*******************************************************************************
+  Simulated USB Host
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_usb_host.c
+
+  Summary
+    Scripted USB host: enumeration, MSD Bulk-Only Transport and CDC.
+
+  Description
+    See sim_usb_host.h.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "sim_system.h"
+#include "sim_usb_host.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Standard requests and descriptors */
+#define SIM_USB_HOST_REQUEST_CLEAR_FEATURE      (0x01U)
+#define SIM_USB_HOST_REQUEST_SET_ADDRESS        (0x05U)
+#define SIM_USB_HOST_REQUEST_GET_DESCRIPTOR     (0x06U)
+#define SIM_USB_HOST_REQUEST_SET_CONFIGURATION  (0x09U)
+
+#define SIM_USB_HOST_DESCRIPTOR_DEVICE          (0x01U)
+#define SIM_USB_HOST_DESCRIPTOR_CONFIGURATION   (0x02U)
+#define SIM_USB_HOST_DESCRIPTOR_INTERFACE       (0x04U)
+#define SIM_USB_HOST_DESCRIPTOR_ENDPOINT        (0x05U)
+
+#define SIM_USB_HOST_FEATURE_ENDPOINT_HALT      (0x00U)
+
+#define SIM_USB_HOST_TYPE_IN                    (0x80U)
+#define SIM_USB_HOST_TYPE_CLASS                 (0x20U)
+#define SIM_USB_HOST_RECIPIENT_INTERFACE        (0x01U)
+#define SIM_USB_HOST_RECIPIENT_ENDPOINT         (0x02U)
+
+/* Class codes, and the requests of the MSD Bulk-Only Transport and of
+   the CDC ACM */
+#define SIM_USB_HOST_CLASS_CDC                  (0x02U)
+#define SIM_USB_HOST_CLASS_MSD                  (0x08U)
+#define SIM_USB_HOST_CLASS_CDC_DATA             (0x0AU)
+#define SIM_USB_HOST_CLASS_VENDOR               (0xFFU)
+
+#define SIM_USB_HOST_MSD_GET_MAX_LUN            (0xFEU)
+
+#define SIM_USB_HOST_CDC_SET_LINE_CODING        (0x20U)
+#define SIM_USB_HOST_CDC_GET_LINE_CODING        (0x21U)
+#define SIM_USB_HOST_CDC_SET_CONTROL_LINE_STATE (0x22U)
+
+#define SIM_USB_HOST_CBW_SIGNATURE              (0x43425355UL)
+#define SIM_USB_HOST_CSW_SIGNATURE              (0x53425355UL)
+#define SIM_USB_HOST_CBW_SIZE                   (31U)
+#define SIM_USB_HOST_CSW_SIZE                   (13U)
+
+/* Reset recovery and SET_ADDRESS recovery of the USB 2.0 specification */
+#define SIM_USB_HOST_RESET_RECOVERY             SIM_TIME_MS(10)
+#define SIM_USB_HOST_ADDRESS_RECOVERY           SIM_TIME_MS(2)
+
+typedef struct
+{
+    SIM_TIME step;
+
+    SIM_TIME timeout;
+
+    SIM_USB_HOST_DEVICE device;
+
+    SIM_USB_TRANSFER transfer;
+
+    uint32_t tag;
+
+} SIM_USB_HOST_OBJ;
+
+static SIM_USB_HOST_OBJ simUsbHostObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool SIM_USB_HOST_IsNever( uintptr_t context )
+{
+    (void)context;
+    return false;
+}
+
+static bool SIM_USB_HOST_IsConnected( uintptr_t context )
+{
+    (void)context;
+    return SIM_USB_IsConnected();
+}
+
+static bool SIM_USB_HOST_IsResetDone( uintptr_t context )
+{
+    (void)context;
+    return !SIM_USB_IsResetting();
+}
+
+static bool SIM_USB_HOST_IsTransferDone( uintptr_t context )
+{
+    return ((const SIM_USB_TRANSFER*)context)->status != SIM_USB_TRANSFER_PENDING;
+}
+
+static void SIM_USB_HOST_Put32( uint8_t* buffer, uint32_t value )
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t SIM_USB_HOST_Get32( const uint8_t* buffer )
+{
+    return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) |
+           ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+static uint32_t SIM_USB_HOST_Get32BE( const uint8_t* buffer )
+{
+    return ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) |
+           ((uint32_t)buffer[2] << 8) | (uint32_t)buffer[3];
+}
+
+static bool SIM_USB_HOST_DescriptorGet( uint8_t type, uint8_t* buffer, uint16_t length )
+{
+    uint32_t actualLength = 0U;
+
+    return (SIM_USB_HOST_ControlTransfer(SIM_USB_HOST_TYPE_IN, SIM_USB_HOST_REQUEST_GET_DESCRIPTOR,
+                                         (uint16_t)(type << 8), 0U, buffer, length,
+                                         &actualLength) == SIM_USB_TRANSFER_COMPLETED) &&
+           (actualLength == length);
+}
+
+/* Finds the MSD and CDC endpoints in the configuration descriptor */
+static void SIM_USB_HOST_ConfigurationParse( SIM_USB_HOST_DEVICE* device )
+{
+    const uint8_t* descriptor = device->configuration;
+    uint32_t offset = 0U;
+    uint8_t class = 0U;
+    uint8_t endpoint;
+    uint16_t maxPacketSize;
+    bool isIn;
+
+    while (((offset + 2U) <= device->configurationLength) && (descriptor[offset] >= 2U))
+    {
+        const uint8_t* item = &descriptor[offset];
+
+        if ((item[1] == SIM_USB_HOST_DESCRIPTOR_INTERFACE) && (item[0] >= 9U))
+        {
+            class = item[5];
+            if (class == SIM_USB_HOST_CLASS_MSD)
+            {
+                device->msdInterface = item[2];
+            }
+            else if (class == SIM_USB_HOST_CLASS_CDC)
+            {
+                device->cdcInterface = item[2];
+            }
+            else if (class == SIM_USB_HOST_CLASS_VENDOR)
+            {
+                device->vendorInterface = item[2];
+            }
+        }
+        else if ((item[1] == SIM_USB_HOST_DESCRIPTOR_ENDPOINT) && (item[0] >= 7U))
+        {
+            endpoint = item[2];
+            maxPacketSize = (uint16_t)(item[4] | (item[5] << 8));
+            isIn = ((endpoint & SIM_USB_HOST_TYPE_IN) != 0U);
+            if (class == SIM_USB_HOST_CLASS_MSD)
+            {
+                *(isIn ? &device->msdIn : &device->msdOut) = endpoint;
+                device->msdMaxPacketSize = maxPacketSize;
+            }
+            else if (class == SIM_USB_HOST_CLASS_CDC)
+            {
+                device->cdcNotification = endpoint;
+            }
+            else if (class == SIM_USB_HOST_CLASS_CDC_DATA)
+            {
+                *(isIn ? &device->cdcIn : &device->cdcOut) = endpoint;
+                device->cdcMaxPacketSize = maxPacketSize;
+            }
+            else if (class == SIM_USB_HOST_CLASS_VENDOR)
+            {
+                *(isIn ? &device->vendorIn : &device->vendorOut) = endpoint;
+                device->vendorMaxPacketSize = maxPacketSize;
+            }
+        }
+        offset += item[0];
+    }
+}
+
+static uint16_t SIM_USB_HOST_MaxPacketSizeGet( uint8_t endpoint )
+{
+    const SIM_USB_HOST_DEVICE* device = &simUsbHostObj.device;
+
+    if ((endpoint == device->cdcIn) || (endpoint == device->cdcOut))
+    {
+        return device->cdcMaxPacketSize;
+    }
+    if ((endpoint == device->vendorIn) || (endpoint == device->vendorOut))
+    {
+        return device->vendorMaxPacketSize;
+    }
+    return device->msdMaxPacketSize;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SIM_USB_HOST_Initialize( SIM_TIME step, SIM_TIME timeout )
+{
+    memset(&simUsbHostObj, 0, sizeof(simUsbHostObj));
+    simUsbHostObj.step = step;
+    simUsbHostObj.timeout = timeout;
+}
+
+void SIM_USB_HOST_Wait( SIM_TIME time )
+{
+    (void)SIM_SYSTEM_RunUntil(SIM_USB_HOST_IsNever, 0U, simUsbHostObj.step, time);
+}
+
+bool SIM_USB_HOST_Enumerate( void )
+{
+    SIM_USB_HOST_DEVICE* device = &simUsbHostObj.device;
+    uint8_t header[9];
+
+    memset(device, 0, sizeof(*device));
+    device->maxPacketSize0 = 8U;
+    device->msdIn = SIM_USB_HOST_ENDPOINT_NONE;
+    device->msdOut = SIM_USB_HOST_ENDPOINT_NONE;
+    device->cdcNotification = SIM_USB_HOST_ENDPOINT_NONE;
+    device->cdcIn = SIM_USB_HOST_ENDPOINT_NONE;
+    device->cdcOut = SIM_USB_HOST_ENDPOINT_NONE;
+    device->vendorIn = SIM_USB_HOST_ENDPOINT_NONE;
+    device->vendorOut = SIM_USB_HOST_ENDPOINT_NONE;
+
+    if (!SIM_SYSTEM_RunUntil(SIM_USB_HOST_IsConnected, 0U, simUsbHostObj.step, simUsbHostObj.timeout))
+    {
+        return false;
+    }
+    SIM_USB_BusReset();
+    (void)SIM_SYSTEM_RunUntil(SIM_USB_HOST_IsResetDone, 0U, simUsbHostObj.step, simUsbHostObj.timeout);
+    SIM_USB_HOST_Wait(SIM_USB_HOST_RESET_RECOVERY);
+
+    /* The first 8 bytes give the maximum packet size of endpoint 0 */
+    if (!SIM_USB_HOST_DescriptorGet(SIM_USB_HOST_DESCRIPTOR_DEVICE, device->deviceDescriptor, 8U))
+    {
+        return false;
+    }
+    device->maxPacketSize0 = device->deviceDescriptor[7];
+
+    if (SIM_USB_HOST_ControlTransfer(0U, SIM_USB_HOST_REQUEST_SET_ADDRESS, SIM_USB_HOST_ADDRESS, 0U,
+                                     NULL, 0U, NULL) != SIM_USB_TRANSFER_COMPLETED)
+    {
+        return false;
+    }
+    SIM_USB_HOST_Wait(SIM_USB_HOST_ADDRESS_RECOVERY);
+    device->address = SIM_USB_HOST_ADDRESS;
+
+    if (!SIM_USB_HOST_DescriptorGet(SIM_USB_HOST_DESCRIPTOR_DEVICE, device->deviceDescriptor,
+                                    sizeof(device->deviceDescriptor)) ||
+        !SIM_USB_HOST_DescriptorGet(SIM_USB_HOST_DESCRIPTOR_CONFIGURATION, header, sizeof(header)))
+    {
+        return false;
+    }
+    device->configurationLength = (uint16_t)(header[2] | (header[3] << 8));
+    if (device->configurationLength > SIM_USB_HOST_CONFIGURATION_SIZE_MAX)
+    {
+        device->configurationLength = SIM_USB_HOST_CONFIGURATION_SIZE_MAX;
+    }
+    if (!SIM_USB_HOST_DescriptorGet(SIM_USB_HOST_DESCRIPTOR_CONFIGURATION, device->configuration,
+                                    device->configurationLength))
+    {
+        return false;
+    }
+    SIM_USB_HOST_ConfigurationParse(device);
+
+    if (SIM_USB_HOST_ControlTransfer(0U, SIM_USB_HOST_REQUEST_SET_CONFIGURATION, header[5], 0U,
+                                     NULL, 0U, NULL) != SIM_USB_TRANSFER_COMPLETED)
+    {
+        return false;
+    }
+    return ((device->msdIn != SIM_USB_HOST_ENDPOINT_NONE) && (device->msdOut != SIM_USB_HOST_ENDPOINT_NONE)) ||
+           ((device->vendorIn != SIM_USB_HOST_ENDPOINT_NONE) && (device->vendorOut != SIM_USB_HOST_ENDPOINT_NONE));
+}
+
+const SIM_USB_HOST_DEVICE* SIM_USB_HOST_DeviceGet( void )
+{
+    return &simUsbHostObj.device;
+}
+
+SIM_USB_TRANSFER_STATUS SIM_USB_HOST_TransferRun( SIM_USB_TRANSFER* transfer )
+{
+    SIM_USB_TransferSubmit(transfer);
+    if (!SIM_SYSTEM_RunUntil(SIM_USB_HOST_IsTransferDone, (uintptr_t)transfer,
+                             simUsbHostObj.step, simUsbHostObj.timeout))
+    {
+        /* The cancel waits for the transaction in progress */
+        (void)SIM_USB_TransferCancel(transfer);
+        (void)SIM_SYSTEM_RunUntil(SIM_USB_HOST_IsTransferDone, (uintptr_t)transfer,
+                                  simUsbHostObj.step, simUsbHostObj.timeout);
+    }
+    return transfer->status;
+}
+
+SIM_USB_TRANSFER_STATUS SIM_USB_HOST_ControlTransfer( uint8_t requestType, uint8_t request,
+                                                      uint16_t value, uint16_t index,
+                                                      uint8_t* buffer, uint16_t length,
+                                                      uint32_t* actualLength )
+{
+    SIM_USB_TRANSFER* transfer = &simUsbHostObj.transfer;
+
+    memset(transfer, 0, sizeof(*transfer));
+    transfer->address = simUsbHostObj.device.address;
+    transfer->endpoint = 0U;
+    transfer->type = SIM_USB_TRANSFER_CONTROL;
+    transfer->maxPacketSize = simUsbHostObj.device.maxPacketSize0;
+    transfer->setup[0] = requestType;
+    transfer->setup[1] = request;
+    transfer->setup[2] = (uint8_t)value;
+    transfer->setup[3] = (uint8_t)(value >> 8);
+    transfer->setup[4] = (uint8_t)index;
+    transfer->setup[5] = (uint8_t)(index >> 8);
+    transfer->setup[6] = (uint8_t)length;
+    transfer->setup[7] = (uint8_t)(length >> 8);
+    transfer->buffer = buffer;
+    transfer->length = length;
+
+    (void)SIM_USB_HOST_TransferRun(transfer);
+    if (actualLength != NULL)
+    {
+        *actualLength = transfer->actualLength;
+    }
+    return transfer->status;
+}
+
+SIM_USB_TRANSFER_STATUS SIM_USB_HOST_BulkTransfer( uint8_t endpoint, uint8_t* buffer, uint32_t length,
+                                                   uint32_t* actualLength )
+{
+    SIM_USB_TRANSFER* transfer = &simUsbHostObj.transfer;
+
+    memset(transfer, 0, sizeof(*transfer));
+    transfer->address = simUsbHostObj.device.address;
+    transfer->endpoint = endpoint;
+    transfer->type = SIM_USB_TRANSFER_BULK;
+    transfer->maxPacketSize = SIM_USB_HOST_MaxPacketSizeGet(endpoint);
+    transfer->buffer = buffer;
+    transfer->length = length;
+
+    (void)SIM_USB_HOST_TransferRun(transfer);
+    if (actualLength != NULL)
+    {
+        *actualLength = transfer->actualLength;
+    }
+    return transfer->status;
+}
+
+bool SIM_USB_HOST_HaltClear( uint8_t endpoint )
+{
+    return SIM_USB_HOST_ControlTransfer(SIM_USB_HOST_RECIPIENT_ENDPOINT, SIM_USB_HOST_REQUEST_CLEAR_FEATURE,
+                                        SIM_USB_HOST_FEATURE_ENDPOINT_HALT, endpoint,
+                                        NULL, 0U, NULL) == SIM_USB_TRANSFER_COMPLETED;
+}
+
+bool SIM_USB_HOST_MsdMaxLunGet( uint8_t* maxLun )
+{
+    uint32_t actualLength = 0U;
+
+    return (SIM_USB_HOST_ControlTransfer(SIM_USB_HOST_TYPE_IN | SIM_USB_HOST_TYPE_CLASS | SIM_USB_HOST_RECIPIENT_INTERFACE,
+                                         SIM_USB_HOST_MSD_GET_MAX_LUN, 0U, simUsbHostObj.device.msdInterface,
+                                         maxLun, 1U, &actualLength) == SIM_USB_TRANSFER_COMPLETED) &&
+           (actualLength == 1U);
+}
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdCommand( uint8_t lun, const uint8_t* cdb, uint8_t cdbLength,
+                                                 bool isIn, uint8_t* data, uint32_t length,
+                                                 uint32_t* residue )
+{
+    const SIM_USB_HOST_DEVICE* device = &simUsbHostObj.device;
+    uint8_t cbw[SIM_USB_HOST_CBW_SIZE] = { 0 };
+    uint8_t csw[SIM_USB_HOST_CSW_SIZE] = { 0 };
+    SIM_USB_TRANSFER_STATUS status;
+    uint8_t endpoint;
+    uint32_t actualLength = 0U;
+    uint32_t tag = ++simUsbHostObj.tag;
+
+    if (cdbLength > 16U)
+    {
+        return SIM_USB_HOST_MSD_TRANSPORT_ERROR;
+    }
+    SIM_USB_HOST_Put32(&cbw[0], SIM_USB_HOST_CBW_SIGNATURE);
+    SIM_USB_HOST_Put32(&cbw[4], tag);
+    SIM_USB_HOST_Put32(&cbw[8], length);
+    cbw[12] = isIn ? 0x80U : 0x00U;
+    cbw[13] = lun;
+    cbw[14] = cdbLength;
+    memcpy(&cbw[15], cdb, cdbLength);
+
+    if (SIM_USB_HOST_BulkTransfer(device->msdOut, cbw, sizeof(cbw), NULL) != SIM_USB_TRANSFER_COMPLETED)
+    {
+        return SIM_USB_HOST_MSD_TRANSPORT_ERROR;
+    }
+
+    if (length != 0U)
+    {
+        endpoint = isIn ? device->msdIn : device->msdOut;
+        status = SIM_USB_HOST_BulkTransfer(endpoint, data, length, NULL);
+        if (status == SIM_USB_TRANSFER_STALLED)
+        {
+            /* The device ends the data stage early, the CSW follows */
+            (void)SIM_USB_HOST_HaltClear(endpoint);
+        }
+        else if (status != SIM_USB_TRANSFER_COMPLETED)
+        {
+            return SIM_USB_HOST_MSD_TRANSPORT_ERROR;
+        }
+    }
+
+    status = SIM_USB_HOST_BulkTransfer(device->msdIn, csw, sizeof(csw), &actualLength);
+    if (status == SIM_USB_TRANSFER_STALLED)
+    {
+        (void)SIM_USB_HOST_HaltClear(device->msdIn);
+        status = SIM_USB_HOST_BulkTransfer(device->msdIn, csw, sizeof(csw), &actualLength);
+    }
+    if ((status != SIM_USB_TRANSFER_COMPLETED) || (actualLength != SIM_USB_HOST_CSW_SIZE) ||
+        (SIM_USB_HOST_Get32(&csw[0]) != SIM_USB_HOST_CSW_SIGNATURE) || (SIM_USB_HOST_Get32(&csw[4]) != tag) ||
+        (csw[12] > (uint8_t)SIM_USB_HOST_MSD_PHASE_ERROR))
+    {
+        return SIM_USB_HOST_MSD_TRANSPORT_ERROR;
+    }
+    if (residue != NULL)
+    {
+        *residue = SIM_USB_HOST_Get32(&csw[8]);
+    }
+    return (SIM_USB_HOST_MSD_STATUS)csw[12];
+}
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdInquiry( uint8_t lun, uint8_t data[36] )
+{
+    const uint8_t cdb[6] = { 0x12U, 0U, 0U, 0U, 36U, 0U };
+
+    return SIM_USB_HOST_MsdCommand(lun, cdb, sizeof(cdb), true, data, 36U, NULL);
+}
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdTestUnitReady( uint8_t lun )
+{
+    const uint8_t cdb[6] = { 0x00U };
+
+    return SIM_USB_HOST_MsdCommand(lun, cdb, sizeof(cdb), false, NULL, 0U, NULL);
+}
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdRequestSense( uint8_t lun, uint8_t* senseKey, uint16_t* ascq )
+{
+    const uint8_t cdb[6] = { 0x03U, 0U, 0U, 0U, 18U, 0U };
+    uint8_t data[18] = { 0 };
+    SIM_USB_HOST_MSD_STATUS status;
+
+    status = SIM_USB_HOST_MsdCommand(lun, cdb, sizeof(cdb), true, data, sizeof(data), NULL);
+    *senseKey = data[2] & 0x0FU;
+    *ascq = (uint16_t)((data[12] << 8) | data[13]);
+    return status;
+}
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdReadCapacity( uint8_t lun, uint32_t* lastBlock, uint32_t* blockSize )
+{
+    const uint8_t cdb[10] = { 0x25U };
+    uint8_t data[8] = { 0 };
+    SIM_USB_HOST_MSD_STATUS status;
+
+    status = SIM_USB_HOST_MsdCommand(lun, cdb, sizeof(cdb), true, data, sizeof(data), NULL);
+    *lastBlock = SIM_USB_HOST_Get32BE(&data[0]);
+    *blockSize = SIM_USB_HOST_Get32BE(&data[4]);
+    return status;
+}
+
+static SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdReadWrite10( bool isRead, uint8_t lun, uint32_t block, uint16_t nBlocks,
+                                                            uint8_t* buffer, uint32_t blockSize )
+{
+    uint8_t cdb[10] = { 0 };
+
+    cdb[0] = isRead ? 0x28U : 0x2AU;
+    cdb[2] = (uint8_t)(block >> 24);
+    cdb[3] = (uint8_t)(block >> 16);
+    cdb[4] = (uint8_t)(block >> 8);
+    cdb[5] = (uint8_t)block;
+    cdb[7] = (uint8_t)(nBlocks >> 8);
+    cdb[8] = (uint8_t)nBlocks;
+
+    return SIM_USB_HOST_MsdCommand(lun, cdb, sizeof(cdb), isRead, buffer, (uint32_t)nBlocks * blockSize, NULL);
+}
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdRead10( uint8_t lun, uint32_t block, uint16_t nBlocks,
+                                                uint8_t* buffer, uint32_t blockSize )
+{
+    return SIM_USB_HOST_MsdReadWrite10(true, lun, block, nBlocks, buffer, blockSize);
+}
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdWrite10( uint8_t lun, uint32_t block, uint16_t nBlocks,
+                                                 uint8_t* buffer, uint32_t blockSize )
+{
+    return SIM_USB_HOST_MsdReadWrite10(false, lun, block, nBlocks, buffer, blockSize);
+}
+
+bool SIM_USB_HOST_CdcLineCodingSet( const uint8_t lineCoding[7] )
+{
+    uint8_t buffer[7];
+
+    memcpy(buffer, lineCoding, sizeof(buffer));
+    return SIM_USB_HOST_ControlTransfer(SIM_USB_HOST_TYPE_CLASS | SIM_USB_HOST_RECIPIENT_INTERFACE,
+                                        SIM_USB_HOST_CDC_SET_LINE_CODING, 0U, simUsbHostObj.device.cdcInterface,
+                                        buffer, sizeof(buffer), NULL) == SIM_USB_TRANSFER_COMPLETED;
+}
+
+bool SIM_USB_HOST_CdcLineCodingGet( uint8_t lineCoding[7] )
+{
+    uint32_t actualLength = 0U;
+
+    return (SIM_USB_HOST_ControlTransfer(SIM_USB_HOST_TYPE_IN | SIM_USB_HOST_TYPE_CLASS | SIM_USB_HOST_RECIPIENT_INTERFACE,
+                                         SIM_USB_HOST_CDC_GET_LINE_CODING, 0U, simUsbHostObj.device.cdcInterface,
+                                         lineCoding, 7U, &actualLength) == SIM_USB_TRANSFER_COMPLETED) &&
+           (actualLength == 7U);
+}
+
+bool SIM_USB_HOST_CdcControlLineStateSet( uint16_t state )
+{
+    return SIM_USB_HOST_ControlTransfer(SIM_USB_HOST_TYPE_CLASS | SIM_USB_HOST_RECIPIENT_INTERFACE,
+                                        SIM_USB_HOST_CDC_SET_CONTROL_LINE_STATE, state,
+                                        simUsbHostObj.device.cdcInterface, NULL, 0U, NULL) == SIM_USB_TRANSFER_COMPLETED;
+}
+
+bool SIM_USB_HOST_CdcWrite( const uint8_t* buffer, uint32_t length )
+{
+    SIM_USB_TRANSFER* transfer = &simUsbHostObj.transfer;
+
+    memset(transfer, 0, sizeof(*transfer));
+    transfer->address = simUsbHostObj.device.address;
+    transfer->endpoint = simUsbHostObj.device.cdcOut;
+    transfer->type = SIM_USB_TRANSFER_BULK;
+    transfer->maxPacketSize = simUsbHostObj.device.cdcMaxPacketSize;
+    /* The host controller only reads an OUT buffer */
+    transfer->buffer = (uint8_t*)buffer;
+    transfer->length = length;
+    transfer->zeroLengthPacket = true;
+
+    return (SIM_USB_HOST_TransferRun(transfer) == SIM_USB_TRANSFER_COMPLETED) &&
+           (transfer->actualLength == length);
+}
+
+uint32_t SIM_USB_HOST_CdcRead( uint8_t* buffer, uint32_t length )
+{
+    uint32_t actualLength = 0U;
+
+    (void)SIM_USB_HOST_BulkTransfer(simUsbHostObj.device.cdcIn, buffer, length, &actualLength);
+    return actualLength;
+}
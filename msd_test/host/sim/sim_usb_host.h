@@ -0,0 +1,241 @@
+/*******************************************************************************
+  Simulated USB Host Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_usb_host.h
+
+  Summary
+    Scripted USB host of the host build.
+
+  Description
+    Blocking requests on top of the SIM_USB transfers, for the tests and
+    tools of the host build. Each function submits its transfers and runs
+    the SIM_SYSTEM main loop until they end, so the firmware serves them in
+    virtual time as it would serve a PC:
+    - SIM_USB_HOST_Enumerate waits for the device to connect, resets the
+      bus, reads the descriptors, sets the address and the configuration,
+      and finds the MSD, CDC and vendor specific endpoints in the
+      configuration descriptor.
+    - The MSD functions run the Bulk-Only Transport: a CBW, the data stage
+      and the CSW, clearing the halt of an endpoint the device stalls.
+    - The CDC functions set and get the line coding and the control line
+      state, and write and read the data interface.
+
+    A request that does not end within the timeout is cancelled.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_USB_HOST_H
+#define SIM_USB_HOST_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim_usb.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Address SIM_USB_HOST_Enumerate gives the device */
+#define SIM_USB_HOST_ADDRESS            (1U)
+
+#define SIM_USB_HOST_CONFIGURATION_SIZE_MAX (256U)
+
+/* Endpoint that the configuration does not have */
+#define SIM_USB_HOST_ENDPOINT_NONE      (0xFFU)
+
+// *****************************************************************************
+/* Enumerated device
+
+  Summary:
+    What SIM_USB_HOST_Enumerate learned about the device.
+*/
+
+typedef struct
+{
+    uint8_t address;
+
+    uint8_t maxPacketSize0;
+
+    uint8_t deviceDescriptor[18];
+
+    uint8_t configuration[SIM_USB_HOST_CONFIGURATION_SIZE_MAX];
+
+    uint16_t configurationLength;
+
+    /* Endpoint addresses and maximum packet sizes of the functions */
+    uint8_t msdInterface;
+
+    uint8_t msdIn;
+
+    uint8_t msdOut;
+
+    uint16_t msdMaxPacketSize;
+
+    uint8_t cdcInterface;
+
+    uint8_t cdcNotification;
+
+    uint8_t cdcIn;
+
+    uint8_t cdcOut;
+
+    uint16_t cdcMaxPacketSize;
+
+    uint8_t vendorInterface;
+
+    uint8_t vendorIn;
+
+    uint8_t vendorOut;
+
+    uint16_t vendorMaxPacketSize;
+
+} SIM_USB_HOST_DEVICE;
+
+// *****************************************************************************
+/* MSD command status
+
+  Summary:
+    Status of the CSW of a Bulk-Only Transport command, or the transport
+    error that kept the host from reading it.
+*/
+
+typedef enum
+{
+    SIM_USB_HOST_MSD_PASSED = 0,
+
+    SIM_USB_HOST_MSD_FAILED = 1,
+
+    SIM_USB_HOST_MSD_PHASE_ERROR = 2,
+
+    /* A transfer failed, or the CSW is not valid */
+    SIM_USB_HOST_MSD_TRANSPORT_ERROR,
+
+} SIM_USB_HOST_MSD_STATUS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Sets the main loop step the requests run with, and their timeout */
+void SIM_USB_HOST_Initialize( SIM_TIME step, SIM_TIME timeout );
+
+/* Runs the main loop for the given time */
+void SIM_USB_HOST_Wait( SIM_TIME time );
+
+/* Enumerates and configures the device. Returns false if a request fails
+   or the configuration has neither an MSD nor a vendor specific function. */
+bool SIM_USB_HOST_Enumerate( void );
+
+const SIM_USB_HOST_DEVICE* SIM_USB_HOST_DeviceGet( void );
+
+/* Runs a transfer the caller set up, and returns how it ended */
+SIM_USB_TRANSFER_STATUS SIM_USB_HOST_TransferRun( SIM_USB_TRANSFER* transfer );
+
+/* Control transfer on endpoint 0. The direction is the one of
+   requestType. The length of the data stage goes in actualLength. */
+SIM_USB_TRANSFER_STATUS SIM_USB_HOST_ControlTransfer( uint8_t requestType, uint8_t request,
+                                                      uint16_t value, uint16_t index,
+                                                      uint8_t* buffer, uint16_t length,
+                                                      uint32_t* actualLength );
+
+/* Bulk transfer on one of the endpoints of the configuration */
+SIM_USB_TRANSFER_STATUS SIM_USB_HOST_BulkTransfer( uint8_t endpoint, uint8_t* buffer, uint32_t length,
+                                                   uint32_t* actualLength );
+
+/* CLEAR_FEATURE(ENDPOINT_HALT) */
+bool SIM_USB_HOST_HaltClear( uint8_t endpoint );
+
+/* GET_MAX_LUN. Returns false if the request fails. */
+bool SIM_USB_HOST_MsdMaxLunGet( uint8_t* maxLun );
+
+/* One command: the CBW, the data stage of length bytes in the direction
+   isIn, and the CSW. The data residue of the CSW goes in residue. */
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdCommand( uint8_t lun, const uint8_t* cdb, uint8_t cdbLength,
+                                                 bool isIn, uint8_t* data, uint32_t length,
+                                                 uint32_t* residue );
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdInquiry( uint8_t lun, uint8_t data[36] );
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdTestUnitReady( uint8_t lun );
+
+/* Sense key, and additional sense code and qualifier as ASC << 8 | ASCQ */
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdRequestSense( uint8_t lun, uint8_t* senseKey, uint16_t* ascq );
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdReadCapacity( uint8_t lun, uint32_t* lastBlock, uint32_t* blockSize );
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdRead10( uint8_t lun, uint32_t block, uint16_t nBlocks,
+                                                uint8_t* buffer, uint32_t blockSize );
+
+SIM_USB_HOST_MSD_STATUS SIM_USB_HOST_MsdWrite10( uint8_t lun, uint32_t block, uint16_t nBlocks,
+                                                 uint8_t* buffer, uint32_t blockSize );
+
+/* SET_LINE_CODING and GET_LINE_CODING with the 7 bytes of the line
+   coding */
+bool SIM_USB_HOST_CdcLineCodingSet( const uint8_t lineCoding[7] );
+
+bool SIM_USB_HOST_CdcLineCodingGet( uint8_t lineCoding[7] );
+
+/* SET_CONTROL_LINE_STATE, DTR in bit 0 and RTS in bit 1 */
+bool SIM_USB_HOST_CdcControlLineStateSet( uint16_t state );
+
+/* Writes to the CDC data interface, ending with a zero length packet if
+   length is a multiple of the maximum packet size */
+bool SIM_USB_HOST_CdcWrite( const uint8_t* buffer, uint32_t length );
+
+/* Reads from the CDC data interface until a short packet or length bytes.
+   Returns the bytes read, 0 if nothing came within the timeout. */
+uint32_t SIM_USB_HOST_CdcRead( uint8_t* buffer, uint32_t length );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_USB_HOST_H
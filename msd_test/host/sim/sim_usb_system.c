@@ -0,0 +1,278 @@
+/*******************************************************************************
+  Simulated USB System
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_usb_system.c
+
+  Summary
+    Initialization and tasks of the USB device stack of the host build.
+
+  Description
+    See sim_usb_system.h.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "configuration.h"
+#include "definitions.h"
+#include "sim_core.h"
+#include "sim_usb.h"
+#include "sim_system.h"
+#include "sim_usb_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Driver Initialization Data
+// *****************************************************************************
+// *****************************************************************************
+
+static uint8_t drvRamDisk0MediaBuffer[DRV_RAMDISK_MEDIA_SIZE] __attribute__((aligned(4)));
+
+static const DRV_RAMDISK_INIT drvRamDisk0InitData =
+{
+    .mediaBuffer                    = drvRamDisk0MediaBuffer,
+    .mediaSize                      = DRV_RAMDISK_MEDIA_SIZE,
+    .latencyUS                      = DRV_RAMDISK_LATENCY_US,
+};
+
+static const DRV_USBFSV1_INIT drvUSBInit =
+{
+    .interruptSource = USB_OTHER_IRQn,
+    .interruptSource1 = USB_SOF_HSOF_IRQn,
+    .interruptSource2 = USB_TRCPT0_IRQn,
+    .interruptSource3 = USB_TRCPT1_IRQn,
+    .moduleInit = {0},
+    .operationMode = DRV_USBFSV1_OPMODE_DEVICE,
+    .operationSpeed = USB_SPEED_FULL,
+    .runInStandby = true,
+    .suspendInSleep = false,
+    .usbID = USB_REGS,
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: CDC Echo Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define SIM_USB_SYSTEM_CDC_BUFFER_SIZE  (512U)
+
+typedef struct
+{
+    bool isReading;
+
+    bool isWriting;
+
+    /* Bytes read and not written back yet */
+    uint32_t length;
+
+    USB_CDC_LINE_CODING lineCoding;
+
+} SIM_USB_SYSTEM_CDC_OBJ;
+
+/* Taken by app.c for the CDC event handler, which does not use it here */
+CDC_DATA cdcData;
+
+extern APP_DATA appData;
+
+static SIM_USB_SYSTEM_CDC_OBJ simUsbSystemCdcObj;
+
+static uint8_t simUsbSystemCdcBuffer[SIM_USB_SYSTEM_CDC_BUFFER_SIZE] USB_ALIGN;
+
+static const USB_CDC_LINE_CODING simUsbSystemLineCoding =
+{
+    .dwDTERate = 115200,
+    .bCharFormat = 0,
+    .bParityType = 0,
+    .bDataBits = 8,
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Callback Functions
+// *****************************************************************************
+// *****************************************************************************
+
+USB_DEVICE_CDC_EVENT_RESPONSE USBDeviceCDCEventHandler
+(
+    USB_DEVICE_CDC_INDEX instanceIndex,
+    USB_DEVICE_CDC_EVENT event,
+    void * pData,
+    uintptr_t userData
+)
+{
+    SIM_USB_SYSTEM_CDC_OBJ* cdc = &simUsbSystemCdcObj;
+
+    switch (event)
+    {
+        case USB_DEVICE_CDC_EVENT_SET_LINE_CODING:
+            USB_DEVICE_ControlReceive(appData.usbDeviceHandle, &cdc->lineCoding, sizeof(USB_CDC_LINE_CODING));
+            break;
+
+        case USB_DEVICE_CDC_EVENT_GET_LINE_CODING:
+            USB_DEVICE_ControlSend(appData.usbDeviceHandle, &cdc->lineCoding, sizeof(USB_CDC_LINE_CODING));
+            break;
+
+        case USB_DEVICE_CDC_EVENT_SET_CONTROL_LINE_STATE:
+        case USB_DEVICE_CDC_EVENT_SEND_BREAK:
+        case USB_DEVICE_CDC_EVENT_CONTROL_TRANSFER_DATA_RECEIVED:
+            USB_DEVICE_ControlStatus(appData.usbDeviceHandle, USB_DEVICE_CONTROL_STATUS_OK);
+            break;
+
+        case USB_DEVICE_CDC_EVENT_READ_COMPLETE:
+            cdc->length = ((USB_DEVICE_CDC_EVENT_DATA_READ_COMPLETE *)pData)->length;
+            cdc->isReading = false;
+            break;
+
+        case USB_DEVICE_CDC_EVENT_WRITE_COMPLETE:
+            cdc->isWriting = false;
+            break;
+
+        case USB_DEVICE_CDC_EVENT_CONTROL_TRANSFER_DATA_SENT:
+        case USB_DEVICE_CDC_EVENT_SERIAL_STATE_NOTIFICATION_COMPLETE:
+        default:
+            break;
+    }
+
+    return USB_DEVICE_CDC_EVENT_RESPONSE_NONE;
+}
+
+/* The host build has no scheduler: every task runs on every pass */
+void SYS_SCHED_EventPost ( uint32_t events )
+{
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Reads from the CDC data interface and writes what it read back */
+static void SIM_USB_SYSTEM_CdcTasks( void )
+{
+    SIM_USB_SYSTEM_CDC_OBJ* cdc = &simUsbSystemCdcObj;
+    USB_DEVICE_CDC_TRANSFER_HANDLE handle;
+
+    if (!appData.isConfigured)
+    {
+        /* The device layer ends the transfers in progress */
+        cdc->isReading = false;
+        cdc->isWriting = false;
+        cdc->length = 0U;
+        return;
+    }
+    if (cdc->isReading || cdc->isWriting)
+    {
+        return;
+    }
+
+    if (cdc->length != 0U)
+    {
+        cdc->isWriting = true;
+        if (USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &handle, simUsbSystemCdcBuffer, cdc->length,
+                                 USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE) != USB_DEVICE_CDC_RESULT_OK)
+        {
+            cdc->isWriting = false;
+            return;
+        }
+        cdc->length = 0U;
+    }
+    else
+    {
+        cdc->isReading = true;
+        if (USB_DEVICE_CDC_Read(USB_DEVICE_CDC_INDEX_0, &handle, simUsbSystemCdcBuffer,
+                                SIM_USB_SYSTEM_CDC_BUFFER_SIZE) != USB_DEVICE_CDC_RESULT_OK)
+        {
+            cdc->isReading = false;
+        }
+    }
+}
+
+static void SIM_USB_SYSTEM_Tasks( void )
+{
+    DRV_RAMDISK_Tasks(sysObj.drvRamDisk0);
+
+    USB_DEVICE_Tasks(sysObj.usbDevObject0);
+    DRV_USBFSV1_Tasks(sysObj.drvUSBFSV1Object);
+
+    APP_Tasks();
+
+    SIM_USB_SYSTEM_CdcTasks();
+
+    SYS_FAT_Tasks();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+bool SIM_USB_SYSTEM_Initialize( void )
+{
+    if (!SIM_CORE_Initialize() || !SIM_USB_Initialize())
+    {
+        return false;
+    }
+
+    SIM_SYSTEM_Initialize();
+
+    /* sim_nvm.c takes no initialization data */
+    sysObj.drvFlash0 = DRV_FLASH_Initialize(DRV_FLASH_INDEX_0, NULL);
+
+    sysObj.drvRamDisk0 = DRV_RAMDISK_Initialize(DRV_RAMDISK_INDEX_0, (SYS_MODULE_INIT *)&drvRamDisk0InitData);
+
+    sysObj.drvUf2_0 = DRV_UF2_Initialize(DRV_UF2_INDEX_0, NULL);
+
+    SYS_FAT_Initialize();
+
+    sysObj.usbDevObject0 = USB_DEVICE_Initialize(USB_DEVICE_INDEX_0, (SYS_MODULE_INIT *)&usbDevInitData);
+
+    sysObj.drvUSBFSV1Object = DRV_USBFSV1_Initialize(DRV_USBFSV1_INDEX_0, (SYS_MODULE_INIT *)&drvUSBInit);
+
+    APP_Initialize();
+
+    memset(&simUsbSystemCdcObj, 0, sizeof(simUsbSystemCdcObj));
+    simUsbSystemCdcObj.lineCoding = simUsbSystemLineCoding;
+
+    return SIM_SYSTEM_TasksAdd(SIM_USB_SYSTEM_Tasks);
+}
+
+bool SIM_USB_SYSTEM_IsConfigured( void )
+{
+    return appData.isConfigured;
+}
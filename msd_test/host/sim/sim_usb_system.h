@@ -0,0 +1,94 @@
+/*******************************************************************************
+  Simulated USB System Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_usb_system.h
+
+  Summary
+    Initialization of the USB device stack of the host build.
+
+  Description
+    Extends SIM_SYSTEM with the modules behind the USB device of the target,
+    initialized with the initialization data of initialization.c and
+    usb_device_init_data.c: the USBFSV1 driver on the simulated peripheral,
+    the USB device layer with its MSD and CDC functions, the RAM disk, the
+    FAT service and the application of app.c. The MSD LUNs are the
+    simulated SD card, the internal flash and UF2 volumes, which sim_nvm.c
+    leaves empty, and the RAM disk.
+
+    cdc.c needs services the host build does not run. The CDC function is
+    served instead by an echo: the data the host writes to the CDC data
+    interface is read back by the host, and the line coding is kept in RAM.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_USB_SYSTEM_H
+#define SIM_USB_SYSTEM_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim_clock.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Initializes the core registers, the USB peripheral and SIM_SYSTEM, then
+   the USB device stack as SYS_Initialize does, and adds its tasks to the
+   SIM_SYSTEM main loop. SIM_CLOCK and SIM_SDHC must be initialized first.
+   Returns false if a register window cannot be mapped. */
+bool SIM_USB_SYSTEM_Initialize( void );
+
+/* The application has seen the device configured by the host */
+bool SIM_USB_SYSTEM_IsConfigured( void );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_USB_SYSTEM_H
@@ -0,0 +1,1029 @@
+/*******************************************************************************
+  Simulated USB/IP Server
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_usbip.c
+
+  Summary
+    USB/IP server on top of the SIM_USB transfers.
+
+  Description
+    See sim_usbip.h.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "sim_system.h"
+#include "sim_usb.h"
+#include "sim_usb_host.h"
+#include "sim_usbip.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Operations, before a connection has the device attached */
+#define SIM_USBIP_VERSION               (0x0111U)
+#define SIM_USBIP_OP_REQ_DEVLIST        (0x8005U)
+#define SIM_USBIP_OP_REP_DEVLIST        (0x0005U)
+#define SIM_USBIP_OP_REQ_IMPORT         (0x8003U)
+#define SIM_USBIP_OP_REP_IMPORT         (0x0003U)
+#define SIM_USBIP_OP_HEADER_SIZE        (8U)
+
+#define SIM_USBIP_ST_OK                 (0U)
+#define SIM_USBIP_ST_DEV_BUSY           (2U)
+#define SIM_USBIP_ST_NODEV              (4U)
+
+#define SIM_USBIP_PATH_SIZE             (256U)
+#define SIM_USBIP_BUS_ID_SIZE           (32U)
+#define SIM_USBIP_DEVICE_SIZE           (SIM_USBIP_PATH_SIZE + SIM_USBIP_BUS_ID_SIZE + 24U)
+#define SIM_USBIP_INTERFACES_MAX        (32U)
+
+#define SIM_USBIP_BUS_NUMBER            (1U)
+#define SIM_USBIP_SPEED_FULL            (2U)
+
+/* Commands, once it is attached */
+#define SIM_USBIP_CMD_SUBMIT            (1U)
+#define SIM_USBIP_CMD_UNLINK            (2U)
+#define SIM_USBIP_RET_SUBMIT            (3U)
+#define SIM_USBIP_RET_UNLINK            (4U)
+#define SIM_USBIP_HEADER_SIZE           (48U)
+
+#define SIM_USBIP_DIR_IN                (1U)
+
+/* transfer_flags of a URB */
+#define SIM_USBIP_URB_SHORT_NOT_OK      (0x0001U)
+#define SIM_USBIP_URB_ZERO_PACKET       (0x0040U)
+
+/* SET_FEATURE(PORT_RESET), which usbip-host turns into a device reset */
+#define SIM_USBIP_REQUEST_TYPE_PORT     (0x23U)
+#define SIM_USBIP_REQUEST_SET_FEATURE   (0x03U)
+#define SIM_USBIP_FEATURE_PORT_RESET    (4U)
+
+/* Command and status wrappers of the MSD function */
+#define SIM_USBIP_CBW_SIZE              (31U)
+#define SIM_USBIP_CSW_SIZE              (13U)
+
+#define SIM_USBIP_DESCRIPTOR_INTERFACE  (0x04U)
+#define SIM_USBIP_DESCRIPTOR_ENDPOINT   (0x05U)
+
+#define SIM_USBIP_CONNECTIONS_NUMBER    (4U)
+
+/* cdc_acm alone keeps 16 reads and up to 16 writes queued */
+#define SIM_USBIP_URBS_NUMBER           (128U)
+
+#define SIM_USBIP_ENDPOINTS_NUMBER      (30U)
+
+#define SIM_USBIP_TRANSFER_SIZE_MAX     (16U * 1024U * 1024U)
+
+/* Main loop passes of a round, and the longest wait for the sockets before
+   a round that follows an idle one */
+#define SIM_USBIP_ROUND_PASSES          (500U)
+#define SIM_USBIP_IDLE_WAIT             (1)
+
+typedef struct
+{
+    uint8_t address;
+
+    SIM_USB_TRANSFER_TYPE type;
+
+    uint16_t maxPacketSize;
+
+    uint8_t interval;
+
+} SIM_USBIP_ENDPOINT;
+
+typedef struct
+{
+    int socket;
+
+    bool isAttached;
+
+    /* A send failed: the connection closes after the socket round */
+    bool isBroken;
+
+    uint8_t header[SIM_USBIP_HEADER_SIZE];
+
+    uint32_t headerCount;
+
+    /* URB of a CMD_SUBMIT whose OUT data is being received */
+    struct SIM_USBIP_URB_* dataUrb;
+
+    uint32_t dataCount;
+
+} SIM_USBIP_CONNECTION;
+
+typedef struct SIM_USBIP_URB_
+{
+    bool isUsed;
+
+    /* Connection the reply goes to, NULL once it has closed */
+    SIM_USBIP_CONNECTION* connection;
+
+    uint32_t seqnum;
+
+    uint32_t flags;
+
+    bool isIn;
+
+    /* A CMD_UNLINK came for the URB: RET_UNLINK replaces RET_SUBMIT */
+    bool isUnlinked;
+
+    uint32_t unlinkSeqnum;
+
+    uint8_t* buffer;
+
+    SIM_USB_TRANSFER transfer;
+
+} SIM_USBIP_URB;
+
+typedef struct
+{
+    int listenSocket;
+
+    uint16_t port;
+
+    SIM_TIME step;
+
+    SIM_USBIP_CONNECTION connections[SIM_USBIP_CONNECTIONS_NUMBER];
+
+    SIM_USBIP_URB urbs[SIM_USBIP_URBS_NUMBER];
+
+    SIM_USBIP_ENDPOINT endpoints[SIM_USBIP_ENDPOINTS_NUMBER];
+
+    uint32_t endpointsNumber;
+
+    /* Something happened in the last round: the next one does not wait */
+    bool isActive;
+
+    SIM_USBIP_STATISTICS statistics;
+
+    FILE* record;
+
+    /* End of the last CSW, 0 before the first one */
+    SIM_TIME cswTime;
+
+} SIM_USBIP_OBJ;
+
+static SIM_USBIP_OBJ simUsbipObj = { .listenSocket = -1 };
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void SIM_USBIP_Put16( uint8_t* buffer, uint16_t value )
+{
+    buffer[0] = (uint8_t)(value >> 8);
+    buffer[1] = (uint8_t)value;
+}
+
+static void SIM_USBIP_Put32( uint8_t* buffer, uint32_t value )
+{
+    buffer[0] = (uint8_t)(value >> 24);
+    buffer[1] = (uint8_t)(value >> 16);
+    buffer[2] = (uint8_t)(value >> 8);
+    buffer[3] = (uint8_t)value;
+}
+
+static uint16_t SIM_USBIP_Get16( const uint8_t* buffer )
+{
+    return (uint16_t)(((uint16_t)buffer[0] << 8) | buffer[1]);
+}
+
+static uint32_t SIM_USBIP_Get32( const uint8_t* buffer )
+{
+    return ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) |
+           ((uint32_t)buffer[2] << 8) | (uint32_t)buffer[3];
+}
+
+/* Endpoints of the configuration, as the other end of the bus sees them */
+static void SIM_USBIP_EndpointsUpdate( void )
+{
+    const SIM_USB_HOST_DEVICE* device = SIM_USB_HOST_DeviceGet();
+    uint32_t offset = 0U;
+
+    simUsbipObj.endpointsNumber = 0U;
+    while (((offset + 2U) <= device->configurationLength) && (device->configuration[offset] >= 2U))
+    {
+        const uint8_t* item = &device->configuration[offset];
+
+        if ((item[1] == SIM_USBIP_DESCRIPTOR_ENDPOINT) && (item[0] >= 7U) &&
+            (simUsbipObj.endpointsNumber < SIM_USBIP_ENDPOINTS_NUMBER))
+        {
+            SIM_USBIP_ENDPOINT* endpoint = &simUsbipObj.endpoints[simUsbipObj.endpointsNumber];
+
+            /* Isochronous endpoints are not simulated */
+            if ((item[3] & 0x03U) != 0x01U)
+            {
+                endpoint->address = item[2];
+                endpoint->type = ((item[3] & 0x03U) == 0x03U) ? SIM_USB_TRANSFER_INTERRUPT : SIM_USB_TRANSFER_BULK;
+                endpoint->maxPacketSize = (uint16_t)((item[4] | (item[5] << 8)) & 0x07FFU);
+                endpoint->interval = item[6];
+                simUsbipObj.endpointsNumber++;
+            }
+        }
+        offset += item[0];
+    }
+}
+
+static const SIM_USBIP_ENDPOINT* SIM_USBIP_EndpointFind( uint8_t address )
+{
+    uint32_t index;
+
+    for (index = 0U; index < simUsbipObj.endpointsNumber; index++)
+    {
+        if (simUsbipObj.endpoints[index].address == address)
+        {
+            return &simUsbipObj.endpoints[index];
+        }
+    }
+    return NULL;
+}
+
+/* The usbip_usb_device structure, and the usbip_usb_interface structures
+   that follow it in a device list. Returns the bytes written. */
+static uint32_t SIM_USBIP_DeviceWrite( uint8_t* buffer, bool hasInterfaces )
+{
+    const SIM_USB_HOST_DEVICE* device = SIM_USB_HOST_DeviceGet();
+    const uint8_t* descriptor = device->deviceDescriptor;
+    uint32_t length = SIM_USBIP_DEVICE_SIZE;
+    uint32_t offset = 0U;
+
+    memset(buffer, 0, SIM_USBIP_DEVICE_SIZE);
+    (void)snprintf((char*)buffer, SIM_USBIP_PATH_SIZE, "/sys/devices/platform/msd_test/usb%u/%s",
+                   SIM_USBIP_BUS_NUMBER, SIM_USBIP_BUS_ID);
+    (void)snprintf((char*)&buffer[SIM_USBIP_PATH_SIZE], SIM_USBIP_BUS_ID_SIZE, "%s", SIM_USBIP_BUS_ID);
+    buffer += SIM_USBIP_PATH_SIZE + SIM_USBIP_BUS_ID_SIZE;
+
+    SIM_USBIP_Put32(&buffer[0], SIM_USBIP_BUS_NUMBER);
+    SIM_USBIP_Put32(&buffer[4], device->address);
+    SIM_USBIP_Put32(&buffer[8], SIM_USBIP_SPEED_FULL);
+    SIM_USBIP_Put16(&buffer[12], (uint16_t)(descriptor[8] | (descriptor[9] << 8)));
+    SIM_USBIP_Put16(&buffer[14], (uint16_t)(descriptor[10] | (descriptor[11] << 8)));
+    SIM_USBIP_Put16(&buffer[16], (uint16_t)(descriptor[12] | (descriptor[13] << 8)));
+    buffer[18] = descriptor[4];
+    buffer[19] = descriptor[5];
+    buffer[20] = descriptor[6];
+    buffer[21] = device->configuration[5];
+    buffer[22] = descriptor[17];
+    buffer[23] = device->configuration[4];
+
+    if (!hasInterfaces)
+    {
+        return length;
+    }
+    buffer += 24U;
+    while (((offset + 2U) <= device->configurationLength) && (device->configuration[offset] >= 2U))
+    {
+        const uint8_t* item = &device->configuration[offset];
+
+        /* Alternate setting 0 of each interface */
+        if ((item[1] == SIM_USBIP_DESCRIPTOR_INTERFACE) && (item[0] >= 9U) && (item[3] == 0U) &&
+            (length < (SIM_USBIP_DEVICE_SIZE + (SIM_USBIP_INTERFACES_MAX * 4U))))
+        {
+            buffer[0] = item[5];
+            buffer[1] = item[6];
+            buffer[2] = item[7];
+            buffer[3] = 0U;
+            buffer += 4U;
+            length += 4U;
+        }
+        offset += item[0];
+    }
+    return length;
+}
+
+static void SIM_USBIP_CbwRecord( const uint8_t* cbw, uint32_t length )
+{
+    SIM_TIME now = SIM_CLOCK_Now();
+    uint32_t dataLength;
+    uint8_t cdbLength;
+    uint8_t index;
+
+    if ((length != SIM_USBIP_CBW_SIZE) || (memcmp(cbw, "USBC", 4U) != 0))
+    {
+        return;
+    }
+    dataLength = (uint32_t)cbw[8] | ((uint32_t)cbw[9] << 8) | ((uint32_t)cbw[10] << 16) | ((uint32_t)cbw[11] << 24);
+    cdbLength = cbw[14] & 0x1FU;
+    if ((cdbLength == 0U) || (cdbLength > 16U))
+    {
+        return;
+    }
+
+    fprintf(simUsbipObj.record, "%llu %u %s %lu ",
+            (unsigned long long)(((simUsbipObj.cswTime != 0U) && (now > simUsbipObj.cswTime)) ? ((now - simUsbipObj.cswTime) / 1000U) : 0U),
+            (unsigned)(cbw[13] & 0x0FU), (dataLength == 0U) ? "none" : (((cbw[12] & 0x80U) != 0U) ? "in" : "out"),
+            (unsigned long)dataLength);
+    for (index = 0U; index < cdbLength; index++)
+    {
+        fprintf(simUsbipObj.record, "%02x", cbw[15U + index]);
+    }
+    fputc('\n', simUsbipObj.record);
+}
+
+static void SIM_USBIP_Send( SIM_USBIP_CONNECTION* connection, const uint8_t* data, uint32_t length )
+{
+    ssize_t count;
+
+    while ((length > 0U) && !connection->isBroken)
+    {
+        count = send(connection->socket, data, length, MSG_NOSIGNAL);
+        if (count < 0)
+        {
+            if (errno != EINTR)
+            {
+                connection->isBroken = true;
+            }
+            continue;
+        }
+        data += count;
+        length -= (uint32_t)count;
+    }
+}
+
+static void SIM_USBIP_ReturnSend( SIM_USBIP_CONNECTION* connection, uint32_t command, uint32_t seqnum,
+                                  int32_t status, const uint8_t* data, uint32_t length )
+{
+    uint8_t header[SIM_USBIP_HEADER_SIZE];
+
+    memset(header, 0, sizeof(header));
+    SIM_USBIP_Put32(&header[0], command);
+    SIM_USBIP_Put32(&header[4], seqnum);
+    SIM_USBIP_Put32(&header[20], (uint32_t)status);
+    if (command == SIM_USBIP_RET_SUBMIT)
+    {
+        SIM_USBIP_Put32(&header[24], length);
+    }
+    SIM_USBIP_Send(connection, header, sizeof(header));
+    if (data != NULL)
+    {
+        SIM_USBIP_Send(connection, data, length);
+    }
+}
+
+static SIM_USBIP_URB* SIM_USBIP_UrbAllocate( SIM_USBIP_CONNECTION* connection, uint32_t length )
+{
+    uint32_t index;
+
+    for (index = 0U; index < SIM_USBIP_URBS_NUMBER; index++)
+    {
+        SIM_USBIP_URB* urb = &simUsbipObj.urbs[index];
+
+        if (!urb->isUsed)
+        {
+            memset(urb, 0, sizeof(*urb));
+            urb->buffer = malloc((length > 0U) ? length : 1U);
+            if (urb->buffer == NULL)
+            {
+                return NULL;
+            }
+            urb->isUsed = true;
+            urb->connection = connection;
+            return urb;
+        }
+    }
+    return NULL;
+}
+
+static void SIM_USBIP_UrbFree( SIM_USBIP_URB* urb )
+{
+    free(urb->buffer);
+    urb->buffer = NULL;
+    urb->isUsed = false;
+}
+
+/* Error codes of the Linux host controller drivers */
+static int32_t SIM_USBIP_StatusGet( const SIM_USBIP_URB* urb )
+{
+    const SIM_USB_TRANSFER* transfer = &urb->transfer;
+
+    switch (transfer->status)
+    {
+        case SIM_USB_TRANSFER_COMPLETED:
+            if (urb->isIn && ((urb->flags & SIM_USBIP_URB_SHORT_NOT_OK) != 0U) &&
+                (transfer->actualLength < transfer->length))
+            {
+                return -EREMOTEIO;
+            }
+            return 0;
+
+        case SIM_USB_TRANSFER_STALLED:
+            return -EPIPE;
+
+        case SIM_USB_TRANSFER_CANCELLED:
+            return -ECONNRESET;
+
+        case SIM_USB_TRANSFER_NO_RESPONSE:
+        default:
+            return -EPROTO;
+    }
+}
+
+static void SIM_USBIP_TransferCallback( SIM_USB_TRANSFER* transfer )
+{
+    SIM_USBIP_URB* urb = (SIM_USBIP_URB*)transfer->context;
+    int32_t status = SIM_USBIP_StatusGet(urb);
+
+    if (status != 0)
+    {
+        simUsbipObj.statistics.errors++;
+    }
+    if (urb->isIn)
+    {
+        simUsbipObj.statistics.inBytes += transfer->actualLength;
+        if ((simUsbipObj.record != NULL) && (transfer->endpoint == SIM_USB_HOST_DeviceGet()->msdIn) &&
+            (status == 0) && (transfer->actualLength == SIM_USBIP_CSW_SIZE) && (memcmp(urb->buffer, "USBS", 4U) == 0))
+        {
+            simUsbipObj.cswTime = SIM_CLOCK_Now();
+        }
+    }
+    else
+    {
+        simUsbipObj.statistics.outBytes += transfer->actualLength;
+    }
+
+    if (urb->connection != NULL)
+    {
+        if (urb->isUnlinked)
+        {
+            SIM_USBIP_ReturnSend(urb->connection, SIM_USBIP_RET_UNLINK, urb->unlinkSeqnum, status, NULL, 0U);
+        }
+        else if (urb->isIn)
+        {
+            SIM_USBIP_ReturnSend(urb->connection, SIM_USBIP_RET_SUBMIT, urb->seqnum, status,
+                                 urb->buffer, transfer->actualLength);
+        }
+        else
+        {
+            /* The length of an OUT transfer goes back without its data */
+            SIM_USBIP_ReturnSend(urb->connection, SIM_USBIP_RET_SUBMIT, urb->seqnum, status, NULL,
+                                 transfer->actualLength);
+        }
+    }
+
+    SIM_USBIP_UrbFree(urb);
+    simUsbipObj.isActive = true;
+}
+
+/* Resets the bus and enumerates the device again, as usb_reset_device does
+   for usbip-host */
+static int32_t SIM_USBIP_DeviceReset( void )
+{
+    if (!SIM_USB_HOST_Enumerate())
+    {
+        return -EPROTO;
+    }
+    SIM_USBIP_EndpointsUpdate();
+    return 0;
+}
+
+/* Starts the transfer of a CMD_SUBMIT whose OUT data has arrived */
+static void SIM_USBIP_UrbSubmit( SIM_USBIP_URB* urb, const uint8_t* header, uint32_t length )
+{
+    const SIM_USB_HOST_DEVICE* device = SIM_USB_HOST_DeviceGet();
+    SIM_USB_TRANSFER* transfer = &urb->transfer;
+    uint8_t number = (uint8_t)SIM_USBIP_Get32(&header[16]);
+    const uint8_t* setup = &header[40];
+    const SIM_USBIP_ENDPOINT* endpoint;
+    uint16_t setupLength;
+
+    memset(transfer, 0, sizeof(*transfer));
+    transfer->address = device->address;
+    transfer->buffer = urb->buffer;
+    transfer->length = length;
+    transfer->callback = SIM_USBIP_TransferCallback;
+    transfer->context = (uintptr_t)urb;
+
+    if (number == 0U)
+    {
+        if ((setup[0] == SIM_USBIP_REQUEST_TYPE_PORT) && (setup[1] == SIM_USBIP_REQUEST_SET_FEATURE) &&
+            (setup[2] == SIM_USBIP_FEATURE_PORT_RESET))
+        {
+            SIM_USBIP_ReturnSend(urb->connection, SIM_USBIP_RET_SUBMIT, urb->seqnum, SIM_USBIP_DeviceReset(),
+                                 NULL, 0U);
+            SIM_USBIP_UrbFree(urb);
+            return;
+        }
+
+        transfer->type = SIM_USB_TRANSFER_CONTROL;
+        transfer->maxPacketSize = device->maxPacketSize0;
+        memcpy(transfer->setup, setup, sizeof(transfer->setup));
+        setupLength = (uint16_t)(setup[6] | (setup[7] << 8));
+        if (transfer->length > setupLength)
+        {
+            transfer->length = setupLength;
+        }
+        urb->isIn = ((setup[0] & 0x80U) != 0U);
+    }
+    else
+    {
+        endpoint = SIM_USBIP_EndpointFind((uint8_t)(number | (urb->isIn ? 0x80U : 0U)));
+        if (endpoint == NULL)
+        {
+            SIM_USBIP_ReturnSend(urb->connection, SIM_USBIP_RET_SUBMIT, urb->seqnum, -EPIPE, NULL, 0U);
+            simUsbipObj.statistics.errors++;
+            SIM_USBIP_UrbFree(urb);
+            return;
+        }
+        transfer->endpoint = endpoint->address;
+        transfer->type = endpoint->type;
+        transfer->maxPacketSize = endpoint->maxPacketSize;
+        transfer->interval = endpoint->interval;
+        transfer->zeroLengthPacket = !urb->isIn && ((urb->flags & SIM_USBIP_URB_ZERO_PACKET) != 0U);
+        if ((simUsbipObj.record != NULL) && (endpoint->address == device->msdOut))
+        {
+            SIM_USBIP_CbwRecord(urb->buffer, length);
+        }
+    }
+
+    SIM_USB_TransferSubmit(transfer);
+}
+
+static bool SIM_USBIP_SubmitReceive( SIM_USBIP_CONNECTION* connection )
+{
+    const uint8_t* header = connection->header;
+    uint32_t length = SIM_USBIP_Get32(&header[24]);
+    SIM_USBIP_URB* urb;
+
+    if (length > SIM_USBIP_TRANSFER_SIZE_MAX)
+    {
+        return false;
+    }
+    urb = SIM_USBIP_UrbAllocate(connection, length);
+    if (urb == NULL)
+    {
+        fprintf(stderr, "usbip: out of URBs\n");
+        return false;
+    }
+    urb->seqnum = SIM_USBIP_Get32(&header[4]);
+    urb->isIn = (SIM_USBIP_Get32(&header[12]) == SIM_USBIP_DIR_IN);
+    urb->flags = SIM_USBIP_Get32(&header[20]);
+    simUsbipObj.statistics.submits++;
+
+    if (!urb->isIn && (length > 0U))
+    {
+        /* The data follows the header */
+        connection->dataUrb = urb;
+        connection->dataCount = 0U;
+        return true;
+    }
+    SIM_USBIP_UrbSubmit(urb, header, length);
+    return true;
+}
+
+static void SIM_USBIP_UnlinkReceive( SIM_USBIP_CONNECTION* connection )
+{
+    uint32_t seqnum = SIM_USBIP_Get32(&connection->header[4]);
+    uint32_t target = SIM_USBIP_Get32(&connection->header[20]);
+    uint32_t index;
+
+    simUsbipObj.statistics.unlinks++;
+    for (index = 0U; index < SIM_USBIP_URBS_NUMBER; index++)
+    {
+        SIM_USBIP_URB* urb = &simUsbipObj.urbs[index];
+
+        if (urb->isUsed && (urb->connection == connection) && (urb->seqnum == target) &&
+            !urb->isUnlinked && (urb != connection->dataUrb))
+        {
+            /* RET_UNLINK goes back when the transfer ends */
+            urb->isUnlinked = true;
+            urb->unlinkSeqnum = seqnum;
+            (void)SIM_USB_TransferCancel(&urb->transfer);
+            return;
+        }
+    }
+
+    /* The URB has already been given back */
+    SIM_USBIP_ReturnSend(connection, SIM_USBIP_RET_UNLINK, seqnum, 0, NULL, 0U);
+}
+
+static bool SIM_USBIP_OperationReceive( SIM_USBIP_CONNECTION* connection )
+{
+    uint8_t reply[SIM_USBIP_OP_HEADER_SIZE + 4U + SIM_USBIP_DEVICE_SIZE + (SIM_USBIP_INTERFACES_MAX * 4U)];
+    const uint8_t* header = connection->header;
+    uint16_t code = SIM_USBIP_Get16(&header[2]);
+    uint32_t length;
+    uint32_t index;
+    uint32_t status = SIM_USBIP_ST_OK;
+
+    memset(reply, 0, sizeof(reply));
+    SIM_USBIP_Put16(&reply[0], SIM_USBIP_VERSION);
+
+    if (code == SIM_USBIP_OP_REQ_DEVLIST)
+    {
+        SIM_USBIP_Put16(&reply[2], SIM_USBIP_OP_REP_DEVLIST);
+        SIM_USBIP_Put32(&reply[8], 1U);
+        length = SIM_USBIP_OP_HEADER_SIZE + 4U + SIM_USBIP_DeviceWrite(&reply[12], true);
+        SIM_USBIP_Send(connection, reply, length);
+        return false;
+    }
+
+    /* OP_REQ_IMPORT */
+    if (strncmp((const char*)&header[SIM_USBIP_OP_HEADER_SIZE], SIM_USBIP_BUS_ID, SIM_USBIP_BUS_ID_SIZE) != 0)
+    {
+        status = SIM_USBIP_ST_NODEV;
+    }
+    for (index = 0U; index < SIM_USBIP_CONNECTIONS_NUMBER; index++)
+    {
+        if (simUsbipObj.connections[index].isAttached)
+        {
+            status = SIM_USBIP_ST_DEV_BUSY;
+        }
+    }
+
+    SIM_USBIP_Put16(&reply[2], SIM_USBIP_OP_REP_IMPORT);
+    SIM_USBIP_Put32(&reply[4], status);
+    if (status != SIM_USBIP_ST_OK)
+    {
+        SIM_USBIP_Send(connection, reply, SIM_USBIP_OP_HEADER_SIZE);
+        return false;
+    }
+    length = SIM_USBIP_OP_HEADER_SIZE + SIM_USBIP_DeviceWrite(&reply[SIM_USBIP_OP_HEADER_SIZE], false);
+    SIM_USBIP_Send(connection, reply, length);
+
+    connection->isAttached = true;
+    simUsbipObj.statistics.imports++;
+    return true;
+}
+
+/* Bytes of the message the header belongs to, header included, but for the
+   OUT data of a CMD_SUBMIT */
+static uint32_t SIM_USBIP_MessageSize( const SIM_USBIP_CONNECTION* connection )
+{
+    if (connection->isAttached)
+    {
+        return SIM_USBIP_HEADER_SIZE;
+    }
+    if ((connection->headerCount >= SIM_USBIP_OP_HEADER_SIZE) &&
+        (SIM_USBIP_Get16(&connection->header[2]) == SIM_USBIP_OP_REQ_IMPORT))
+    {
+        return SIM_USBIP_OP_HEADER_SIZE + SIM_USBIP_BUS_ID_SIZE;
+    }
+    return SIM_USBIP_OP_HEADER_SIZE;
+}
+
+/* Handles a whole message. Returns false if the connection must close. */
+static bool SIM_USBIP_MessageReceive( SIM_USBIP_CONNECTION* connection )
+{
+    uint16_t code;
+
+    if (!connection->isAttached)
+    {
+        code = SIM_USBIP_Get16(&connection->header[2]);
+        if ((SIM_USBIP_Get16(&connection->header[0]) != SIM_USBIP_VERSION) ||
+            ((code != SIM_USBIP_OP_REQ_DEVLIST) && (code != SIM_USBIP_OP_REQ_IMPORT)))
+        {
+            return false;
+        }
+        return SIM_USBIP_OperationReceive(connection);
+    }
+
+    switch (SIM_USBIP_Get32(&connection->header[0]))
+    {
+        case SIM_USBIP_CMD_SUBMIT:
+            return SIM_USBIP_SubmitReceive(connection);
+
+        case SIM_USBIP_CMD_UNLINK:
+            SIM_USBIP_UnlinkReceive(connection);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/* Reads what the socket has. Returns false if the connection must close. */
+static bool SIM_USBIP_Receive( SIM_USBIP_CONNECTION* connection )
+{
+    SIM_USBIP_URB* urb;
+    uint32_t length;
+    ssize_t count;
+
+    while (!connection->isBroken)
+    {
+        urb = connection->dataUrb;
+        if (urb != NULL)
+        {
+            length = SIM_USBIP_Get32(&connection->header[24]);
+            count = recv(connection->socket, &urb->buffer[connection->dataCount],
+                         length - connection->dataCount, MSG_DONTWAIT);
+        }
+        else
+        {
+            length = SIM_USBIP_MessageSize(connection);
+            count = recv(connection->socket, &connection->header[connection->headerCount],
+                         length - connection->headerCount, MSG_DONTWAIT);
+        }
+
+        if (count == 0)
+        {
+            return false;
+        }
+        if (count < 0)
+        {
+            return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR);
+        }
+        simUsbipObj.isActive = true;
+
+        if (urb != NULL)
+        {
+            connection->dataCount += (uint32_t)count;
+            if (connection->dataCount == length)
+            {
+                connection->dataUrb = NULL;
+                connection->headerCount = 0U;
+                SIM_USBIP_UrbSubmit(urb, connection->header, length);
+            }
+            continue;
+        }
+
+        connection->headerCount += (uint32_t)count;
+        if (connection->headerCount < SIM_USBIP_MessageSize(connection))
+        {
+            continue;
+        }
+        if (!SIM_USBIP_MessageReceive(connection))
+        {
+            return false;
+        }
+        if (connection->dataUrb == NULL)
+        {
+            connection->headerCount = 0U;
+        }
+    }
+    return false;
+}
+
+static void SIM_USBIP_ConnectionClose( SIM_USBIP_CONNECTION* connection )
+{
+    uint32_t index;
+
+    if (connection->dataUrb != NULL)
+    {
+        SIM_USBIP_UrbFree(connection->dataUrb);
+        connection->dataUrb = NULL;
+    }
+
+    /* The transfers end without a reply */
+    for (index = 0U; index < SIM_USBIP_URBS_NUMBER; index++)
+    {
+        SIM_USBIP_URB* urb = &simUsbipObj.urbs[index];
+
+        if (urb->isUsed && (urb->connection == connection))
+        {
+            urb->connection = NULL;
+            (void)SIM_USB_TransferCancel(&urb->transfer);
+        }
+    }
+
+    (void)close(connection->socket);
+    memset(connection, 0, sizeof(*connection));
+    connection->socket = -1;
+}
+
+static void SIM_USBIP_Accept( void )
+{
+    SIM_USBIP_CONNECTION* connection = NULL;
+    int socketId;
+    int enable = 1;
+    uint32_t index;
+
+    socketId = accept(simUsbipObj.listenSocket, NULL, NULL);
+    if (socketId < 0)
+    {
+        return;
+    }
+    for (index = 0U; index < SIM_USBIP_CONNECTIONS_NUMBER; index++)
+    {
+        if (simUsbipObj.connections[index].socket < 0)
+        {
+            connection = &simUsbipObj.connections[index];
+            break;
+        }
+    }
+    if (connection == NULL)
+    {
+        (void)close(socketId);
+        return;
+    }
+
+    /* The protocol sends small messages that wait for their answer */
+    (void)setsockopt(socketId, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    memset(connection, 0, sizeof(*connection));
+    connection->socket = socketId;
+    simUsbipObj.statistics.connections++;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+bool SIM_USBIP_Initialize( const SIM_USBIP_INIT* init )
+{
+    struct sockaddr_in address;
+    socklen_t addressLength = sizeof(address);
+    int enable = 1;
+    uint32_t index;
+
+    memset(&simUsbipObj, 0, sizeof(simUsbipObj));
+    simUsbipObj.listenSocket = -1;
+    simUsbipObj.step = init->step;
+    for (index = 0U; index < SIM_USBIP_CONNECTIONS_NUMBER; index++)
+    {
+        simUsbipObj.connections[index].socket = -1;
+    }
+    SIM_USBIP_EndpointsUpdate();
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(init->port);
+    if (inet_pton(AF_INET, (init->address != NULL) ? init->address : "127.0.0.1", &address.sin_addr) != 1)
+    {
+        return false;
+    }
+
+    simUsbipObj.listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (simUsbipObj.listenSocket < 0)
+    {
+        return false;
+    }
+    (void)setsockopt(simUsbipObj.listenSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if ((bind(simUsbipObj.listenSocket, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+        (listen(simUsbipObj.listenSocket, (int)SIM_USBIP_CONNECTIONS_NUMBER) != 0) ||
+        (getsockname(simUsbipObj.listenSocket, (struct sockaddr*)&address, &addressLength) != 0))
+    {
+        (void)close(simUsbipObj.listenSocket);
+        simUsbipObj.listenSocket = -1;
+        return false;
+    }
+    simUsbipObj.port = ntohs(address.sin_port);
+    return true;
+}
+
+uint16_t SIM_USBIP_PortGet( void )
+{
+    return simUsbipObj.port;
+}
+
+bool SIM_USBIP_IsAttached( void )
+{
+    uint32_t index;
+
+    for (index = 0U; index < SIM_USBIP_CONNECTIONS_NUMBER; index++)
+    {
+        if (simUsbipObj.connections[index].isAttached)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SIM_USBIP_Tasks( void )
+{
+    struct pollfd fds[1U + SIM_USBIP_CONNECTIONS_NUMBER];
+    SIM_USBIP_CONNECTION* connection;
+    SIM_USB_STATISTICS before;
+    SIM_USB_STATISTICS after;
+    uint32_t index;
+    uint32_t pass;
+
+    fds[0].fd = simUsbipObj.listenSocket;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    for (index = 0U; index < SIM_USBIP_CONNECTIONS_NUMBER; index++)
+    {
+        fds[1U + index].fd = simUsbipObj.connections[index].socket;
+        fds[1U + index].events = POLLIN;
+        fds[1U + index].revents = 0;
+    }
+
+    if (poll(fds, 1U + SIM_USBIP_CONNECTIONS_NUMBER, simUsbipObj.isActive ? 0 : SIM_USBIP_IDLE_WAIT) > 0)
+    {
+        for (index = 0U; index < SIM_USBIP_CONNECTIONS_NUMBER; index++)
+        {
+            connection = &simUsbipObj.connections[index];
+            if ((connection->socket >= 0) && ((fds[1U + index].revents & (POLLIN | POLLHUP | POLLERR)) != 0) &&
+                !SIM_USBIP_Receive(connection))
+            {
+                SIM_USBIP_ConnectionClose(connection);
+            }
+        }
+        if ((fds[0].revents & POLLIN) != 0)
+        {
+            SIM_USBIP_Accept();
+        }
+    }
+    simUsbipObj.isActive = false;
+
+    SIM_USB_StatisticsGet(&before);
+    for (pass = 0U; pass < SIM_USBIP_ROUND_PASSES; pass++)
+    {
+        SIM_SYSTEM_Tasks(simUsbipObj.step);
+    }
+    SIM_USB_StatisticsGet(&after);
+    if (after.transactions != before.transactions)
+    {
+        simUsbipObj.isActive = true;
+    }
+
+    for (index = 0U; index < SIM_USBIP_CONNECTIONS_NUMBER; index++)
+    {
+        connection = &simUsbipObj.connections[index];
+        if ((connection->socket >= 0) && connection->isBroken)
+        {
+            SIM_USBIP_ConnectionClose(connection);
+        }
+    }
+}
+
+void SIM_USBIP_StatisticsGet( SIM_USBIP_STATISTICS* statistics )
+{
+    *statistics = simUsbipObj.statistics;
+}
+
+void SIM_USBIP_RecordSet( FILE* stream )
+{
+    simUsbipObj.record = stream;
+    simUsbipObj.cswTime = 0U;
+}
+
+void SIM_USBIP_Deinitialize( void )
+{
+    uint32_t index;
+    uint32_t pass;
+    bool isBusy = true;
+
+    for (index = 0U; index < SIM_USBIP_CONNECTIONS_NUMBER; index++)
+    {
+        if (simUsbipObj.connections[index].socket >= 0)
+        {
+            SIM_USBIP_ConnectionClose(&simUsbipObj.connections[index]);
+        }
+    }
+    if (simUsbipObj.listenSocket >= 0)
+    {
+        (void)close(simUsbipObj.listenSocket);
+        simUsbipObj.listenSocket = -1;
+    }
+
+    /* A cancel waits for the transaction in progress */
+    for (pass = 0U; isBusy && (pass < SIM_USBIP_ROUND_PASSES); pass++)
+    {
+        SIM_SYSTEM_Tasks(simUsbipObj.step);
+        isBusy = false;
+        for (index = 0U; index < SIM_USBIP_URBS_NUMBER; index++)
+        {
+            isBusy = isBusy || simUsbipObj.urbs[index].isUsed;
+        }
+    }
+}
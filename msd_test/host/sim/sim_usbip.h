@@ -0,0 +1,169 @@
+/*******************************************************************************
+  Simulated USB/IP Server Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_usbip.h
+
+  Summary
+    USB/IP server exporting the device of the host build over TCP.
+
+  Description
+    The server lets the USB/IP client of Linux, vhci_hcd with the usbip
+    tool, attach the simulated device, so the kernel's own usb-storage and
+    cdc_acm drivers use the firmware:
+
+        usbip_server --image card.img &
+        modprobe vhci-hcd
+        usbip attach -r 127.0.0.1 -b 1-1
+
+    It implements version 1.1.1 of the protocol:
+    - OP_REQ_DEVLIST lists the device, whose bus ID is SIM_USBIP_BUS_ID.
+    - OP_REQ_IMPORT attaches it to the connection. One connection at a time
+      can have it attached.
+    - CMD_SUBMIT becomes a SIM_USB transfer, sent on the simulated bus with
+      the transfers of the other endpoints. RET_SUBMIT goes back when it
+      ends.
+    - CMD_UNLINK cancels a transfer. RET_UNLINK replaces its RET_SUBMIT, or
+      comes at once if it had already ended.
+
+    The device must be enumerated with SIM_USB_HOST_Enumerate first, as it
+    is on the machine usbip-host exports a device from. The requests of the
+    client go to the device as they come, but for a reset request to the
+    port, which resets the bus and enumerates the device again.
+
+    SIM_USBIP_Tasks is the main loop of the server. While data moves on the
+    bus, it runs the passes of SIM_SYSTEM back to back. Once the bus is
+    idle, it waits for the sockets between the passes, so that virtual time
+    roughly follows real time. The times a client measures are real times;
+    the timing of the firmware is in the SIM_USB trace and statistics.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SIM_USBIP_H
+#define SIM_USBIP_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "sim_clock.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Port of the usbip tool */
+#define SIM_USBIP_PORT_DEFAULT      (3240U)
+
+#define SIM_USBIP_BUS_ID            "1-1"
+
+typedef struct
+{
+    /* IPv4 address to listen on, NULL for 127.0.0.1 */
+    const char* address;
+
+    /* TCP port, 0 for a free port */
+    uint16_t port;
+
+    /* Main loop step, as for SIM_USB_HOST_Initialize */
+    SIM_TIME step;
+
+} SIM_USBIP_INIT;
+
+typedef struct
+{
+    uint32_t connections;
+
+    uint32_t imports;
+
+    uint32_t submits;
+
+    uint32_t unlinks;
+
+    /* Transfers that ended with an error, cancelled ones included */
+    uint32_t errors;
+
+    uint64_t inBytes;
+
+    uint64_t outBytes;
+
+} SIM_USBIP_STATISTICS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Listens for connections. The device must be enumerated. Returns false
+   if the socket cannot be set up. */
+bool SIM_USBIP_Initialize( const SIM_USBIP_INIT* init );
+
+/* Port the server listens on */
+uint16_t SIM_USBIP_PortGet( void );
+
+/* A connection has the device attached */
+bool SIM_USBIP_IsAttached( void );
+
+/* Serves the sockets, then runs a round of main loop passes */
+void SIM_USBIP_Tasks( void );
+
+void SIM_USBIP_StatisticsGet( SIM_USBIP_STATISTICS* statistics );
+
+/* Writes one line per CBW the client sends to the MSD function, in the
+   trace format msd_bench replays, or stops with NULL. The idle time of a
+   CBW is the virtual time since the previous CSW. */
+void SIM_USBIP_RecordSet( FILE* stream );
+
+/* Closes the connections and cancels their transfers */
+void SIM_USBIP_Deinitialize( void );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // SIM_USBIP_H
@@ -0,0 +1,800 @@
+/*******************************************************************************
+  SYS_FAT Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_fat.c
+
+  Summary
+    Runs sys_fat.c and the MSD function against the simulated SD card and a
+    scripted host.
+
+  Description
+    The host of SIM_USB_HOST ejects the card with START STOP UNIT, the
+    service mounts the volume, and the host loads the card again. The test
+    checks that the service takes the card only once the host has ejected
+    it, and that the host sees no medium from the mount to the unmount.
+
+    The host formats the card as a PC would, with WRITE (10): an MBR with
+    one FAT32 partition, clusters of one block and a root directory of two
+    clusters. The service then creates, writes and closes files until the
+    root directory is full, and the host reads the volume back with
+    READ (10) and checks it: the FAT copies, the cluster chains, the
+    directory entries, the FS info sector and the file data. The host then
+    deletes files, and the next mount must see them deleted.
+
+    Last, the card is removed while a file is open: the service must drop
+    the volume and leave the next card to the host.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "definitions.h"
+#include "sim_sdhc.h"
+#include "sim_system.h"
+#include "sim_usb_host.h"
+#include "sim_usb_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_CAPACITY           (64U * 1024U * 1024U)
+#define TEST_NUM_BLOCKS         (TEST_CAPACITY / 512U)
+
+/* LUN of the SD card in usb_device_init_data.c */
+#define TEST_LUN_SDMMC          (0U)
+
+/* Processor time of one pass of the main loop */
+#define TEST_LOOP_STEP          SIM_TIME_US(2)
+
+#define TEST_TIMEOUT            SIM_TIME_MS(3000)
+
+/* Transfers of 64 KB and more overflow 16-bit lengths */
+#define TEST_MAX_BLOCKS         (128U)
+
+/* Largest file the test writes at once */
+#define TEST_WRITE_BLOCKS       (256U)
+
+/* Volume the host formats: one partition, clusters of one block */
+#define TEST_PARTITION_START    (2048U)
+#define TEST_PARTITION_BLOCKS   (TEST_NUM_BLOCKS - TEST_PARTITION_START)
+#define TEST_RESERVED_BLOCKS    (32U)
+#define TEST_FAT_BLOCKS         (1024U)
+#define TEST_FSINFO_BLOCK       (TEST_PARTITION_START + 1U)
+#define TEST_BACKUP_BLOCK       (TEST_PARTITION_START + 6U)
+#define TEST_FAT_START          (TEST_PARTITION_START + TEST_RESERVED_BLOCKS)
+#define TEST_DATA_START         (TEST_FAT_START + (2U * TEST_FAT_BLOCKS))
+#define TEST_CLUSTERS           (TEST_PARTITION_BLOCKS - TEST_RESERVED_BLOCKS - (2U * TEST_FAT_BLOCKS))
+
+/* The root directory is clusters 2 and 3, the file of the host cluster 4 */
+#define TEST_ROOT_CLUSTER       (2U)
+#define TEST_ROOT_ENTRIES       (2U * 16U)
+#define TEST_HOST_CLUSTER       (4U)
+
+/* FAT blocks the host reads back. The test uses the clusters they cover. */
+#define TEST_FAT_CHECK_BLOCKS   (8U)
+#define TEST_FAT_CHECK_CLUSTERS (TEST_FAT_CHECK_BLOCKS * 128U)
+
+#define TEST_FAT_EOC            (0x0FFFFFFFU)
+
+/* Date SYS_FAT gives the files, 1 January 2019 */
+#define TEST_FILE_DATE          ((uint16_t)(((2019U - 1980U) << 9) | (1U << 5) | 1U))
+
+#define TEST_CHECK(condition)                                               \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (false)
+
+typedef struct
+{
+    bool isDone;
+
+    SYS_FAT_EVENT event;
+
+} TEST_CLIENT;
+
+/* File the volume should hold */
+typedef struct
+{
+    /* Name as stored in the directory entry */
+    char entryName[12];
+
+    uint32_t blocks;
+
+    uint8_t seed;
+
+    bool isFound;
+
+} TEST_FILE;
+
+static int testFailures;
+
+static TEST_CLIENT testClient;
+
+static TEST_FILE testFiles[TEST_ROOT_ENTRIES];
+
+static uint32_t testFileCount;
+
+static uint8_t testWriteBuffer[TEST_WRITE_BLOCKS * 512U];
+
+static uint8_t testReadBuffer[TEST_WRITE_BLOCKS * 512U];
+
+static uint8_t testFat[2][TEST_FAT_CHECK_BLOCKS * 512U];
+
+static uint8_t testDirectory[2U * 512U];
+
+static uint8_t testBlock[512];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint16_t TEST_Get16( const uint8_t* data )
+{
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static uint32_t TEST_Get32( const uint8_t* data )
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void TEST_Put16( uint8_t* data, uint32_t value )
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+static void TEST_Put32( uint8_t* data, uint32_t value )
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    data[3] = (uint8_t)(value >> 24);
+}
+
+static bool TEST_IsConfigured( uintptr_t context )
+{
+    (void)context;
+    return SIM_USB_SYSTEM_IsConfigured();
+}
+
+static bool TEST_IsDone( uintptr_t context )
+{
+    (void)context;
+    return testClient.isDone;
+}
+
+static bool TEST_IsUnmounted( uintptr_t context )
+{
+    (void)context;
+    return !SYS_FAT_IsMounted();
+}
+
+static void TEST_EventHandler( SYS_FAT_EVENT event, uintptr_t context )
+{
+    TEST_CLIENT* client = (TEST_CLIENT*)context;
+
+    client->event = event;
+    client->isDone = true;
+}
+
+/* Runs the request the service took until it ends, and returns true if it
+   ended with error, or completed for SYS_FAT_ERROR_NONE. The requests end
+   in SYS_FAT_Tasks, never in the call that starts them. */
+static bool TEST_Request( bool isStarted, SYS_FAT_ERROR error )
+{
+    if (!isStarted)
+    {
+        return false;
+    }
+
+    testClient.isDone = false;
+    if (!SIM_SYSTEM_RunUntil(TEST_IsDone, 0U, TEST_LOOP_STEP, TEST_TIMEOUT))
+    {
+        return false;
+    }
+
+    return (testClient.event == ((error == SYS_FAT_ERROR_NONE) ? SYS_FAT_EVENT_COMPLETE : SYS_FAT_EVENT_ERROR)) &&
+           (SYS_FAT_ErrorGet() == error);
+}
+
+static void TEST_PatternFill( uint8_t* buffer, uint32_t length, uint32_t start, uint8_t seed )
+{
+    uint32_t index;
+
+    for (index = 0U; index < length; index++)
+    {
+        buffer[index] = (uint8_t)(((start + index) * 7U) + seed);
+    }
+}
+
+/* Waits for the LUN to report ready, as a PC polls a removable drive */
+static bool TEST_UnitReadyWait( void )
+{
+    uint32_t attempt;
+
+    for (attempt = 0U; attempt < 100U; attempt++)
+    {
+        if (SIM_USB_HOST_MsdTestUnitReady(TEST_LUN_SDMMC) == SIM_USB_HOST_MSD_PASSED)
+        {
+            return true;
+        }
+        SIM_USB_HOST_Wait(SIM_TIME_MS(10));
+    }
+    return false;
+}
+
+/* The LUN reports no medium, and fails the reads */
+static bool TEST_IsMediumNotPresent( void )
+{
+    uint8_t senseKey = 0U;
+    uint16_t ascq = 0U;
+
+    return (SIM_USB_HOST_MsdTestUnitReady(TEST_LUN_SDMMC) == SIM_USB_HOST_MSD_FAILED) &&
+           (SIM_USB_HOST_MsdRequestSense(TEST_LUN_SDMMC, &senseKey, &ascq) == SIM_USB_HOST_MSD_PASSED) &&
+           (senseKey == 0x02U) && ((ascq >> 8) == 0x3AU) &&
+           (SIM_USB_HOST_MsdRead10(TEST_LUN_SDMMC, 0U, 1U, testBlock, 512U) == SIM_USB_HOST_MSD_FAILED);
+}
+
+/* START STOP UNIT with the LOEJ bit: loads the card, or ejects it */
+static SIM_USB_HOST_MSD_STATUS TEST_StartStopUnit( bool load )
+{
+    const uint8_t cdb[6] = { 0x1BU, 0U, 0U, 0U, (uint8_t)(0x02U | (load ? 0x01U : 0x00U)), 0U };
+
+    return SIM_USB_HOST_MsdCommand(TEST_LUN_SDMMC, cdb, sizeof(cdb), false, NULL, 0U, NULL);
+}
+
+static void TEST_Eject( void )
+{
+    TEST_CHECK(TEST_StartStopUnit(false) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK(TEST_IsMediumNotPresent());
+}
+
+static bool TEST_BlocksRead( uint32_t block, uint32_t nBlocks, uint8_t* buffer )
+{
+    uint16_t count;
+
+    for (; nBlocks != 0U; nBlocks -= count)
+    {
+        count = (uint16_t)((nBlocks < TEST_MAX_BLOCKS) ? nBlocks : TEST_MAX_BLOCKS);
+        if (SIM_USB_HOST_MsdRead10(TEST_LUN_SDMMC, block, count, buffer, 512U) != SIM_USB_HOST_MSD_PASSED)
+        {
+            return false;
+        }
+        block += count;
+        buffer = &buffer[count * 512U];
+    }
+    return true;
+}
+
+static bool TEST_BlocksWrite( uint32_t block, uint32_t nBlocks, uint8_t* buffer )
+{
+    return SIM_USB_HOST_MsdWrite10(TEST_LUN_SDMMC, block, (uint16_t)nBlocks, buffer, 512U) == SIM_USB_HOST_MSD_PASSED;
+}
+
+static void TEST_FileAdd( const char* entryName, uint32_t blocks, uint8_t seed )
+{
+    TEST_FILE* file = &testFiles[testFileCount];
+
+    memcpy(file->entryName, entryName, sizeof(file->entryName));
+    file->blocks = blocks;
+    file->seed = seed;
+    testFileCount++;
+}
+
+static void TEST_FileRemove( const char* entryName )
+{
+    uint32_t index;
+
+    for (index = 0U; index < testFileCount; index++)
+    {
+        if (memcmp(testFiles[index].entryName, entryName, 11U) == 0)
+        {
+            testFileCount--;
+            testFiles[index] = testFiles[testFileCount];
+            return;
+        }
+    }
+}
+
+/* Creates a file of size bytes and writes blocks to it, chunk blocks at a
+   time */
+static void TEST_FileWrite( const char* name, const char* entryName, uint32_t size,
+                            uint32_t blocks, uint32_t chunk, uint8_t seed )
+{
+    uint32_t offset;
+    uint32_t count;
+
+    TEST_CHECK(TEST_Request(SYS_FAT_FileCreate(name, size), SYS_FAT_ERROR_NONE));
+
+    for (offset = 0U; offset < blocks; offset += count)
+    {
+        count = ((blocks - offset) < chunk) ? (blocks - offset) : chunk;
+        TEST_PatternFill(testWriteBuffer, count * 512U, offset * 512U, seed);
+        TEST_CHECK(TEST_Request(SYS_FAT_FileWrite(testWriteBuffer, count * 512U), SYS_FAT_ERROR_NONE));
+    }
+    TEST_CHECK(SYS_FAT_FileSizeGet() == (blocks * 512U));
+
+    TEST_CHECK(TEST_Request(SYS_FAT_FileClose(), SYS_FAT_ERROR_NONE));
+    TEST_FileAdd(entryName, blocks, seed);
+}
+
+/* Builds a directory entry, as the host and SYS_FAT write them */
+static void TEST_EntryBuild( uint8_t* entry, const char* entryName, uint8_t attribute, uint32_t cluster, uint32_t size )
+{
+    memset(entry, 0, 32U);
+    memcpy(entry, entryName, 11U);
+    entry[11] = attribute;
+    TEST_Put16(&entry[16], TEST_FILE_DATE);
+    TEST_Put16(&entry[18], TEST_FILE_DATE);
+    TEST_Put16(&entry[20], cluster >> 16);
+    TEST_Put16(&entry[24], TEST_FILE_DATE);
+    TEST_Put16(&entry[26], cluster);
+    TEST_Put32(&entry[28], size);
+}
+
+/* Formats the card as a PC does, with a file in the root directory */
+static void TEST_Format( void )
+{
+    uint8_t* fat = testFat[0];
+    uint32_t copy;
+
+    /* MBR with one FAT32 (LBA) partition */
+    memset(testBlock, 0, sizeof(testBlock));
+    testBlock[446 + 4] = 0x0CU;
+    TEST_Put32(&testBlock[446 + 8], TEST_PARTITION_START);
+    TEST_Put32(&testBlock[446 + 12], TEST_PARTITION_BLOCKS);
+    TEST_Put16(&testBlock[510], 0xAA55U);
+    TEST_CHECK(TEST_BlocksWrite(0U, 1U, testBlock));
+
+    /* Boot sector and its backup */
+    memset(testBlock, 0, sizeof(testBlock));
+    testBlock[0] = 0xEBU;
+    testBlock[1] = 0x58U;
+    testBlock[2] = 0x90U;
+    memcpy(&testBlock[3], "MSDOS5.0", 8U);
+    TEST_Put16(&testBlock[11], 512U);
+    testBlock[13] = 1U;
+    TEST_Put16(&testBlock[14], TEST_RESERVED_BLOCKS);
+    testBlock[16] = 2U;
+    testBlock[21] = 0xF8U;
+    TEST_Put16(&testBlock[24], 63U);
+    TEST_Put16(&testBlock[26], 255U);
+    TEST_Put32(&testBlock[28], TEST_PARTITION_START);
+    TEST_Put32(&testBlock[32], TEST_PARTITION_BLOCKS);
+    TEST_Put32(&testBlock[36], TEST_FAT_BLOCKS);
+    TEST_Put32(&testBlock[44], TEST_ROOT_CLUSTER);
+    TEST_Put16(&testBlock[48], 1U);
+    TEST_Put16(&testBlock[50], 6U);
+    testBlock[64] = 0x80U;
+    testBlock[66] = 0x29U;
+    TEST_Put32(&testBlock[67], 0x12345678U);
+    memcpy(&testBlock[71], "MSD_TEST   ", 11U);
+    memcpy(&testBlock[82], "FAT32   ", 8U);
+    TEST_Put16(&testBlock[510], 0xAA55U);
+    TEST_CHECK(TEST_BlocksWrite(TEST_PARTITION_START, 1U, testBlock));
+    TEST_CHECK(TEST_BlocksWrite(TEST_BACKUP_BLOCK, 1U, testBlock));
+
+    /* FS info sector: the file of the host is the last cluster in use */
+    memset(testBlock, 0, sizeof(testBlock));
+    TEST_Put32(&testBlock[0], 0x41615252U);
+    TEST_Put32(&testBlock[484], 0x61417272U);
+    TEST_Put32(&testBlock[488], TEST_CLUSTERS - 3U);
+    TEST_Put32(&testBlock[492], TEST_HOST_CLUSTER + 1U);
+    TEST_Put32(&testBlock[508], 0xAA550000U);
+    TEST_CHECK(TEST_BlocksWrite(TEST_FSINFO_BLOCK, 1U, testBlock));
+    TEST_CHECK(TEST_BlocksWrite(TEST_BACKUP_BLOCK + 1U, 1U, testBlock));
+
+    /* Both FATs. The rest of the FATs and the data area are still 0. */
+    memset(fat, 0, sizeof(testFat[0]));
+    TEST_Put32(&fat[0], 0x0FFFFFF8U);
+    TEST_Put32(&fat[4], TEST_FAT_EOC);
+    TEST_Put32(&fat[TEST_ROOT_CLUSTER * 4U], TEST_ROOT_CLUSTER + 1U);
+    TEST_Put32(&fat[(TEST_ROOT_CLUSTER + 1U) * 4U], TEST_FAT_EOC);
+    TEST_Put32(&fat[TEST_HOST_CLUSTER * 4U], TEST_FAT_EOC);
+    for (copy = 0U; copy < 2U; copy++)
+    {
+        TEST_CHECK(TEST_BlocksWrite(TEST_FAT_START + (copy * TEST_FAT_BLOCKS), TEST_FAT_CHECK_BLOCKS, fat));
+    }
+
+    /* Root directory, with the volume label */
+    memset(testDirectory, 0, sizeof(testDirectory));
+    TEST_EntryBuild(&testDirectory[0], "MSD_TEST   ", 0x08U, 0U, 0U);
+    TEST_EntryBuild(&testDirectory[32], "HOST    TXT", 0x20U, TEST_HOST_CLUSTER, 512U);
+    TEST_CHECK(TEST_BlocksWrite(TEST_DATA_START, 2U, testDirectory));
+
+    TEST_PatternFill(testWriteBuffer, 512U, 0U, 0x10U);
+    TEST_CHECK(TEST_BlocksWrite(TEST_DATA_START + (TEST_HOST_CLUSTER - 2U), 1U, testWriteBuffer));
+
+    testFileCount = 0U;
+    TEST_FileAdd("HOST    TXT", 1U, 0x10U);
+}
+
+static uint32_t TEST_FatEntryGet( uint32_t cluster )
+{
+    return TEST_Get32(&testFat[0][cluster * 4U]) & 0x0FFFFFFFU;
+}
+
+/* Reads the volume back and checks it against testFiles. The FS info
+   sector must give nextFree as the next free cluster. */
+static void TEST_VolumeCheck( uint32_t nextFree )
+{
+    bool isUsed[TEST_FAT_CHECK_CLUSTERS] = { false };
+    const uint8_t* entry;
+    TEST_FILE* file;
+    uint32_t usedCount = 2U;
+    uint32_t foundCount = 0U;
+    uint32_t cluster;
+    uint32_t index;
+    uint32_t block;
+
+    for (index = 0U; index < testFileCount; index++)
+    {
+        testFiles[index].isFound = false;
+    }
+
+    /* The FATs are the same, and only the root directory and the files
+       use clusters */
+    TEST_CHECK(TEST_BlocksRead(TEST_FAT_START, TEST_FAT_CHECK_BLOCKS, testFat[0]));
+    TEST_CHECK(TEST_BlocksRead(TEST_FAT_START + TEST_FAT_BLOCKS, TEST_FAT_CHECK_BLOCKS, testFat[1]));
+    TEST_CHECK(memcmp(testFat[0], testFat[1], sizeof(testFat[0])) == 0);
+    TEST_CHECK(TEST_Get32(&testFat[0][0]) == 0x0FFFFFF8U);
+    TEST_CHECK(TEST_FatEntryGet(1U) == TEST_FAT_EOC);
+    TEST_CHECK(TEST_FatEntryGet(TEST_ROOT_CLUSTER) == (TEST_ROOT_CLUSTER + 1U));
+    TEST_CHECK(TEST_FatEntryGet(TEST_ROOT_CLUSTER + 1U) == TEST_FAT_EOC);
+    isUsed[TEST_ROOT_CLUSTER] = true;
+    isUsed[TEST_ROOT_CLUSTER + 1U] = true;
+
+    TEST_CHECK(TEST_BlocksRead(TEST_DATA_START, 2U, testDirectory));
+    for (index = 0U; index < TEST_ROOT_ENTRIES; index++)
+    {
+        entry = &testDirectory[index * 32U];
+        if (entry[0] == 0x00U)
+        {
+            break;
+        }
+        if ((entry[0] == 0xE5U) || ((entry[11] & 0x08U) != 0U))
+        {
+            continue;
+        }
+
+        for (file = testFiles; file < &testFiles[testFileCount]; file++)
+        {
+            if (memcmp(entry, file->entryName, 11U) == 0)
+            {
+                break;
+            }
+        }
+        if ((file == &testFiles[testFileCount]) || file->isFound)
+        {
+            printf("unexpected entry %.11s\n", (const char*)entry);
+            TEST_CHECK(false);
+            continue;
+        }
+        file->isFound = true;
+        foundCount++;
+
+        TEST_CHECK(entry[11] == 0x20U);
+        TEST_CHECK(TEST_Get16(&entry[24]) == TEST_FILE_DATE);
+        TEST_CHECK(TEST_Get32(&entry[28]) == (file->blocks * 512U));
+
+        /* One cluster run per file, none for an empty one */
+        cluster = ((uint32_t)TEST_Get16(&entry[20]) << 16) | TEST_Get16(&entry[26]);
+        TEST_CHECK((file->blocks != 0U) || (cluster == 0U));
+        for (block = 0U; block < file->blocks; block++)
+        {
+            if (((cluster + block) >= TEST_FAT_CHECK_CLUSTERS) || isUsed[cluster + block])
+            {
+                TEST_CHECK(false);
+                break;
+            }
+            isUsed[cluster + block] = true;
+            usedCount++;
+            TEST_CHECK(TEST_FatEntryGet(cluster + block) ==
+                       ((block == (file->blocks - 1U)) ? TEST_FAT_EOC : (cluster + block + 1U)));
+        }
+
+        if ((file->blocks != 0U) && (block == file->blocks))
+        {
+            TEST_PatternFill(testWriteBuffer, file->blocks * 512U, 0U, file->seed);
+            TEST_CHECK(TEST_BlocksRead(TEST_DATA_START + (cluster - 2U), file->blocks, testReadBuffer));
+            TEST_CHECK(memcmp(testWriteBuffer, testReadBuffer, file->blocks * 512U) == 0);
+        }
+    }
+    TEST_CHECK(foundCount == testFileCount);
+
+    /* The clusters no file uses are free, the ones a close trimmed too */
+    for (cluster = 2U; cluster < TEST_FAT_CHECK_CLUSTERS; cluster++)
+    {
+        if (!isUsed[cluster] && (TEST_FatEntryGet(cluster) != 0U))
+        {
+            printf("cluster %u is not free\n", cluster);
+            TEST_CHECK(false);
+            break;
+        }
+    }
+
+    TEST_CHECK(TEST_BlocksRead(TEST_FSINFO_BLOCK, 1U, testBlock));
+    TEST_CHECK(TEST_Get32(&testBlock[0]) == 0x41615252U);
+    TEST_CHECK(TEST_Get32(&testBlock[484]) == 0x61417272U);
+    TEST_CHECK(TEST_Get32(&testBlock[488]) == (TEST_CLUSTERS - usedCount));
+    TEST_CHECK(TEST_Get32(&testBlock[492]) == nextFree);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Tests
+// *****************************************************************************
+// *****************************************************************************
+
+static void TEST_Enumeration( void )
+{
+    TEST_CHECK(SIM_USB_HOST_Enumerate());
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsConfigured, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+    TEST_CHECK(TEST_UnitReadyWait());
+}
+
+/* The card belongs to the host until it ejects it */
+static void TEST_Ownership( void )
+{
+    TEST_CHECK(!SYS_FAT_Mount());
+    TEST_CHECK(SIM_USB_HOST_MsdRead10(TEST_LUN_SDMMC, 0U, 1U, testBlock, 512U) == SIM_USB_HOST_MSD_PASSED);
+
+    TEST_Eject();
+    TEST_CHECK(TEST_StartStopUnit(true) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK(TEST_UnitReadyWait());
+    TEST_CHECK(!SYS_FAT_Mount());
+
+    /* The card of the simulation is blank. The mount fails and the card
+       stays ejected until the host loads it. */
+    TEST_Eject();
+    TEST_CHECK(TEST_Request(SYS_FAT_Mount(), SYS_FAT_ERROR_FORMAT));
+    TEST_CHECK(!SYS_FAT_IsMounted());
+    TEST_CHECK(TEST_IsMediumNotPresent());
+    TEST_CHECK(TEST_StartStopUnit(true) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK(TEST_UnitReadyWait());
+}
+
+static void TEST_Files( void )
+{
+    uint32_t index;
+    char name[13];
+    char entryName[12];
+
+    TEST_Format();
+    TEST_VolumeCheck(TEST_HOST_CLUSTER + 1U);
+
+    TEST_Eject();
+    TEST_CHECK(TEST_Request(SYS_FAT_Mount(), SYS_FAT_ERROR_NONE));
+    TEST_CHECK(SYS_FAT_IsMounted());
+    TEST_CHECK(!SYS_FAT_Mount());
+
+    /* A load does not give the card back while the service holds it */
+    TEST_CHECK(TEST_StartStopUnit(true) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK(TEST_IsMediumNotPresent());
+
+    TEST_CHECK(TEST_Request(SYS_FAT_FileCreate("host.txt", 512U), SYS_FAT_ERROR_EXISTS));
+    TEST_CHECK(!SYS_FAT_FileCreate("BAD*.TXT", 512U));
+    TEST_CHECK(!SYS_FAT_FileCreate("TOOLONGNAME.TXT", 512U));
+    TEST_CHECK(!SYS_FAT_FileCreate(".TXT", 512U));
+    TEST_CHECK(!SYS_FAT_FileCreate("A.TEXT", 512U));
+
+    /* 80 clusters allocated, 48 written: the close frees the last 32 */
+    TEST_CHECK(TEST_Request(SYS_FAT_FileCreate("log.bin", 80U * 512U), SYS_FAT_ERROR_NONE));
+    TEST_CHECK(!SYS_FAT_FileCreate("OTHER.BIN", 512U));
+    TEST_CHECK(!SYS_FAT_FileWrite(testWriteBuffer, 100U));
+    for (index = 0U; index < 3U; index++)
+    {
+        TEST_PatternFill(testWriteBuffer, 16U * 512U, index * 16U * 512U, 0x20U);
+        TEST_CHECK(TEST_Request(SYS_FAT_FileWrite(testWriteBuffer, 16U * 512U), SYS_FAT_ERROR_NONE));
+    }
+    TEST_CHECK(SYS_FAT_FileSizeGet() == (48U * 512U));
+    TEST_CHECK(!SYS_FAT_FileWrite(testWriteBuffer, 33U * 512U));
+    TEST_CHECK(!SYS_FAT_Unmount());
+    TEST_CHECK(TEST_Request(SYS_FAT_FileClose(), SYS_FAT_ERROR_NONE));
+    TEST_CHECK(!SYS_FAT_FileClose());
+    TEST_FileAdd("LOG     BIN", 48U, 0x20U);
+
+    /* One write over two requests of the SDHC, filling the file */
+    TEST_FileWrite("DATA.BIN", "DATA    BIN", 200U * 512U, 200U, 200U, 0x30U);
+
+    /* Empty: no cluster at all */
+    TEST_FileWrite("EMPTY", "EMPTY      ", 1000U, 0U, 1U, 0x40U);
+
+    /* The root directory fills up, into its second cluster */
+    for (index = 0U; testFileCount < (TEST_ROOT_ENTRIES - 1U); index++)
+    {
+        (void)snprintf(name, sizeof(name), "F%02u.TXT", index);
+        (void)snprintf(entryName, sizeof(entryName), "F%02u     TXT", index);
+        TEST_FileWrite(name, entryName, 512U, 1U, 1U, (uint8_t)(0x50U + index));
+    }
+    TEST_CHECK(TEST_Request(SYS_FAT_FileCreate("FULL.TXT", 512U), SYS_FAT_ERROR_DIRECTORY_FULL));
+
+    TEST_CHECK(TEST_Request(SYS_FAT_Unmount(), SYS_FAT_ERROR_NONE));
+    TEST_CHECK(!SYS_FAT_IsMounted());
+    TEST_CHECK(!SYS_FAT_Unmount());
+
+    /* The host gets the card back without a load */
+    TEST_CHECK(TEST_UnitReadyWait());
+
+    /* LOG.BIN from cluster 5, DATA.BIN from the trimmed end of LOG.BIN, then
+       the small files where EMPTY was allocated */
+    TEST_VolumeCheck(TEST_HOST_CLUSTER + 1U + 48U + 200U + index);
+}
+
+/* The host deletes the file of one cluster in entry index of the root
+   directory, and makes its cluster the next free one */
+static void TEST_HostDelete( uint32_t index )
+{
+    uint8_t* entry = &testDirectory[index * 32U];
+    uint32_t cluster;
+    uint32_t block;
+    uint32_t copy;
+
+    TEST_CHECK(TEST_BlocksRead(TEST_DATA_START, 2U, testDirectory));
+    cluster = ((uint32_t)TEST_Get16(&entry[20]) << 16) | TEST_Get16(&entry[26]);
+    TEST_FileRemove((const char*)entry);
+    entry[0] = 0xE5U;
+    TEST_CHECK(TEST_BlocksWrite(TEST_DATA_START + (index / 16U), 1U, &testDirectory[(index / 16U) * 512U]));
+
+    block = TEST_FAT_START + (cluster / 128U);
+    TEST_CHECK(TEST_BlocksRead(block, 1U, testBlock));
+    TEST_CHECK(TEST_Get32(&testBlock[(cluster % 128U) * 4U]) == TEST_FAT_EOC);
+    TEST_Put32(&testBlock[(cluster % 128U) * 4U], 0U);
+    for (copy = 0U; copy < 2U; copy++)
+    {
+        TEST_CHECK(TEST_BlocksWrite(block + (copy * TEST_FAT_BLOCKS), 1U, testBlock));
+    }
+
+    TEST_CHECK(TEST_BlocksRead(TEST_FSINFO_BLOCK, 1U, testBlock));
+    TEST_Put32(&testBlock[488], TEST_Get32(&testBlock[488]) + 1U);
+    TEST_Put32(&testBlock[492], cluster);
+    TEST_CHECK(TEST_BlocksWrite(TEST_FSINFO_BLOCK, 1U, testBlock));
+}
+
+/* The host deletes files between two mounts. The service must not use the
+   FAT it read before. */
+static void TEST_HostChange( void )
+{
+    /* The files after EMPTY, from entry 5 on */
+    uint32_t cluster = TEST_HOST_CLUSTER + 1U + 48U + 200U;
+
+    /* NEW.TXT takes the entry and the cluster of F00.TXT */
+    TEST_HostDelete(5U);
+    TEST_Eject();
+    TEST_CHECK(TEST_Request(SYS_FAT_Mount(), SYS_FAT_ERROR_NONE));
+    TEST_FileWrite("NEW.TXT", "NEW     TXT", 512U, 1U, 1U, 0x60U);
+    TEST_CHECK(TEST_Request(SYS_FAT_Unmount(), SYS_FAT_ERROR_NONE));
+    TEST_CHECK(TEST_UnitReadyWait());
+
+    TEST_VolumeCheck(cluster + 1U);
+    TEST_CHECK(memcmp(&testDirectory[5U * 32U], "NEW     TXT", 11U) == 0);
+    TEST_CHECK(TEST_Get16(&testDirectory[(5U * 32U) + 26U]) == cluster);
+
+    /* Again, with the FAT of the last mount in the cache of the service */
+    TEST_HostDelete(7U);
+    TEST_HostDelete(6U);
+    TEST_Eject();
+    TEST_CHECK(TEST_Request(SYS_FAT_Mount(), SYS_FAT_ERROR_NONE));
+    TEST_FileWrite("NEW2.TXT", "NEW2    TXT", 512U, 1U, 1U, 0x61U);
+    TEST_CHECK(TEST_Request(SYS_FAT_Unmount(), SYS_FAT_ERROR_NONE));
+    TEST_CHECK(TEST_UnitReadyWait());
+
+    TEST_VolumeCheck(cluster + 2U);
+    TEST_CHECK(memcmp(&testDirectory[6U * 32U], "NEW2    TXT", 11U) == 0);
+    TEST_CHECK(TEST_Get16(&testDirectory[(6U * 32U) + 26U]) == (cluster + 1U));
+}
+
+/* The card is removed with a file open, in the last free entry */
+static void TEST_CardRemoval( void )
+{
+    TEST_Eject();
+    TEST_CHECK(TEST_Request(SYS_FAT_Mount(), SYS_FAT_ERROR_NONE));
+    TEST_CHECK(TEST_Request(SYS_FAT_FileCreate("LOST.BIN", 8U * 512U), SYS_FAT_ERROR_NONE));
+
+    SIM_SDHC_CardInsert(false);
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsUnmounted, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+    TEST_CHECK(!SYS_FAT_FileWrite(testWriteBuffer, 512U));
+    TEST_CHECK(!SYS_FAT_Mount());
+
+    SIM_SDHC_CardInsert(true);
+    TEST_CHECK(TEST_UnitReadyWait());
+    TEST_CHECK(!SYS_FAT_Mount());
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    const char* imagePath = (argc > 1) ? argv[1] : "test_fat.img";
+    SIM_SDHC_INIT sdhcInit =
+    {
+        .imagePath = imagePath,
+        .capacity = TEST_CAPACITY,
+        .profile = SIM_SDHC_ProfileGet("typical"),
+        .seed = 1U,
+        .isInserted = true,
+    };
+
+    (void)unlink(imagePath);
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_SDHC_Initialize(&sdhcInit))
+    {
+        printf("cannot create %s\n", imagePath);
+        return 1;
+    }
+    if (!SIM_USB_SYSTEM_Initialize())
+    {
+        printf("cannot map the USB registers\n");
+        return 1;
+    }
+    SIM_USB_HOST_Initialize(TEST_LOOP_STEP, TEST_TIMEOUT);
+    SYS_FAT_EventHandlerSet(TEST_EventHandler, (uintptr_t)&testClient);
+
+    TEST_Enumeration();
+    if (testFailures == 0)
+    {
+        TEST_Ownership();
+        TEST_Files();
+        TEST_HostChange();
+        TEST_CardRemoval();
+    }
+
+    SIM_SDHC_Deinitialize();
+    (void)unlink(imagePath);
+
+    printf("test_fat: %s (%d failures, %llu ms of virtual time)\n",
+           (testFailures == 0) ? "pass" : "FAIL", testFailures,
+           (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return (testFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,414 @@
+/*******************************************************************************
+  DRV_FLASH Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_flash.c
+
+  Summary
+    Runs drv_flash.c and plib_nvmctrl.c against the simulated NVMCTRL.
+
+  Description
+    The test writes blocks through the driver and checks that reads see them
+    at once, while the flash only gets them after the flush delay, with one
+    erase per erase block and no write of a blank page. A write that spans
+    two erase blocks waits for the write back of the first one.
+
+    It then makes the write backs fail. The RAM copy must keep the blocks
+    that were reported written and write them back on a later try, and the
+    error must reach the write that waited for the write back, or else the
+    next write.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "sim_nvmctrl.h"
+#include "sim_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_NUM_BLOCKS         (DRV_FLASH_MEDIA_SIZE / DRV_FLASH_BLOCK_SIZE)
+#define TEST_ERASE_BLOCKS       (NVMCTRL_FLASH_BLOCKSIZE / DRV_FLASH_BLOCK_SIZE)
+
+/* Processor time of one pass of the main loop */
+#define TEST_LOOP_STEP          SIM_TIME_US(10)
+
+#define TEST_TIMEOUT            SIM_TIME_MS(3000)
+
+/* Past the flush delay of the driver */
+#define TEST_FLUSH_TIME         SIM_TIME_MS(DRV_FLASH_FLUSH_DELAY_MS + 100U)
+
+#define TEST_MAX_BLOCKS         (32U)
+
+#define TEST_CHECK(condition)                                               \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (false)
+
+typedef struct
+{
+    DRV_HANDLE handle;
+
+    volatile bool isDone;
+
+    volatile SYS_MEDIA_BLOCK_EVENT event;
+
+    DRV_FLASH_COMMAND_HANDLE commandHandle;
+
+} TEST_CLIENT;
+
+static TEST_CLIENT testClient;
+
+static SYS_MODULE_OBJ testFlashObj;
+
+static int testFailures;
+
+static uint8_t testEraseBuffer[NVMCTRL_FLASH_BLOCKSIZE] __attribute__((aligned(4)));
+
+static const DRV_FLASH_INIT testFlashInit =
+{
+    .startAddress = DRV_FLASH_MEDIA_START_ADDRESS,
+    .mediaSize = DRV_FLASH_MEDIA_SIZE,
+    .eraseBuffer = testEraseBuffer,
+};
+
+static uint8_t testWriteBuffer[TEST_MAX_BLOCKS * DRV_FLASH_BLOCK_SIZE] __attribute__((aligned(4)));
+
+static uint8_t testReadBuffer[TEST_MAX_BLOCKS * DRV_FLASH_BLOCK_SIZE] __attribute__((aligned(4)));
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void TEST_FlashTasks( void )
+{
+    DRV_FLASH_Tasks(testFlashObj);
+}
+
+static void TEST_EventHandler( SYS_MEDIA_BLOCK_EVENT event, SYS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle, uintptr_t context )
+{
+    TEST_CLIENT* client = (TEST_CLIENT*)context;
+
+    /* A request that completes at once calls back before the handle is
+       returned */
+    client->event = event;
+    client->isDone = true;
+}
+
+static bool TEST_IsDone( uintptr_t context )
+{
+    return ((TEST_CLIENT*)context)->isDone;
+}
+
+static bool TEST_IsIdle( uintptr_t context )
+{
+    (void)context;
+    return !DRV_FLASH_IsBusy(testFlashObj);
+}
+
+static bool TEST_Never( uintptr_t context )
+{
+    (void)context;
+    return false;
+}
+
+static void TEST_Run( SIM_TIME duration )
+{
+    (void)SIM_SYSTEM_RunUntil(TEST_Never, 0U, TEST_LOOP_STEP, duration);
+}
+
+static const uint8_t* TEST_FlashAddress( uint32_t block )
+{
+    return (const uint8_t*)(uintptr_t)(DRV_FLASH_MEDIA_START_ADDRESS + (block * DRV_FLASH_BLOCK_SIZE));
+}
+
+static void TEST_PatternFill( uint8_t* buffer, uint32_t blockStart, uint32_t nBlocks, uint8_t seed )
+{
+    uint32_t index;
+
+    for (index = 0U; index < (nBlocks * DRV_FLASH_BLOCK_SIZE); index++)
+    {
+        buffer[index] = (uint8_t)(((blockStart * DRV_FLASH_BLOCK_SIZE) + index) * 13U + seed);
+    }
+}
+
+/* Submits a request and runs the system until it completes. Returns the
+   event, or SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR if the request was not
+   accepted or did not complete. */
+static SYS_MEDIA_BLOCK_EVENT TEST_Transfer( bool isWrite, uint8_t* buffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    testClient.isDone = false;
+    testClient.event = SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR;
+    testClient.commandHandle = DRV_FLASH_COMMAND_HANDLE_INVALID;
+
+    if (isWrite)
+    {
+        DRV_FLASH_AsyncWrite(testClient.handle, &testClient.commandHandle, buffer, blockStart, nBlocks);
+    }
+    else
+    {
+        DRV_FLASH_AsyncRead(testClient.handle, &testClient.commandHandle, buffer, blockStart, nBlocks);
+    }
+    if (testClient.commandHandle == DRV_FLASH_COMMAND_HANDLE_INVALID)
+    {
+        return SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR;
+    }
+
+    if (!SIM_SYSTEM_RunUntil(TEST_IsDone, (uintptr_t)&testClient, TEST_LOOP_STEP, TEST_TIMEOUT))
+    {
+        printf("request at block %lu did not complete\n", (unsigned long)blockStart);
+        return SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR;
+    }
+    return testClient.event;
+}
+
+/* Reads the blocks through the driver and compares them with the buffer */
+static bool TEST_ReadCompare( const uint8_t* expected, uint32_t blockStart, uint32_t nBlocks )
+{
+    memset(testReadBuffer, 0, nBlocks * DRV_FLASH_BLOCK_SIZE);
+
+    return (TEST_Transfer(false, testReadBuffer, blockStart, nBlocks) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE) &&
+           (memcmp(expected, testReadBuffer, nBlocks * DRV_FLASH_BLOCK_SIZE) == 0);
+}
+
+/* Runs past the flush delay and until the write back ends */
+static void TEST_Flush( void )
+{
+    TEST_Run(TEST_FLUSH_TIME);
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsIdle, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Tests
+// *****************************************************************************
+// *****************************************************************************
+
+static void TEST_Geometry( void )
+{
+    SYS_MEDIA_GEOMETRY* geometry = DRV_FLASH_GeometryGet(testClient.handle);
+
+    TEST_CHECK(geometry != NULL);
+    if (geometry != NULL)
+    {
+        TEST_CHECK(geometry->geometryTable[SYS_MEDIA_GEOMETRY_TABLE_READ_ENTRY].blockSize == DRV_FLASH_BLOCK_SIZE);
+        TEST_CHECK(geometry->geometryTable[SYS_MEDIA_GEOMETRY_TABLE_READ_ENTRY].numBlocks == TEST_NUM_BLOCKS);
+        TEST_CHECK(geometry->geometryTable[SYS_MEDIA_GEOMETRY_TABLE_ERASE_ENTRY].blockSize == NVMCTRL_FLASH_BLOCKSIZE);
+    }
+    TEST_CHECK(DRV_FLASH_IsAttached(testClient.handle));
+    TEST_CHECK(!DRV_FLASH_IsWriteProtected(testClient.handle));
+}
+
+static void TEST_WriteBack( void )
+{
+    SIM_NVMCTRL_STATISTICS statistics;
+
+    SIM_NVMCTRL_StatisticsReset();
+    TEST_PatternFill(testWriteBuffer, 3U, 4U, 0x11U);
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, 3U, 4U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+
+    /* In the RAM copy only, until the flush delay */
+    TEST_CHECK(TEST_ReadCompare(testWriteBuffer, 3U, 4U));
+    TEST_CHECK(TEST_FlashAddress(3U)[0] == 0xFFU);
+
+    TEST_Flush();
+    TEST_CHECK(memcmp(TEST_FlashAddress(3U), testWriteBuffer, 4U * DRV_FLASH_BLOCK_SIZE) == 0);
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.blockErases == 1U);
+    TEST_CHECK(statistics.pageWrites == 4U);
+
+    /* The same blocks again: the flash already holds them */
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, 3U, 4U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    TEST_Flush();
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.blockErases == 1U);
+}
+
+static void TEST_WriteAcrossBlocks( void )
+{
+    uint32_t blockStart = TEST_ERASE_BLOCKS - 6U;
+    SIM_NVMCTRL_STATISTICS statistics;
+
+    SIM_NVMCTRL_StatisticsReset();
+    TEST_PatternFill(testWriteBuffer, blockStart, 20U, 0x22U);
+
+    /* Completes once the first erase block is written back */
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, blockStart, 20U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    TEST_CHECK(memcmp(TEST_FlashAddress(blockStart), testWriteBuffer, 6U * DRV_FLASH_BLOCK_SIZE) == 0);
+    TEST_CHECK(TEST_ReadCompare(testWriteBuffer, blockStart, 20U));
+
+    TEST_Flush();
+    TEST_CHECK(memcmp(TEST_FlashAddress(blockStart), testWriteBuffer, 20U * DRV_FLASH_BLOCK_SIZE) == 0);
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.blockErases == 2U);
+}
+
+/* A write back that fails while no write waits for it */
+static void TEST_WriteBackError( void )
+{
+    uint32_t blockStart = 2U * TEST_ERASE_BLOCKS;
+    uint8_t* pattern = &testWriteBuffer[4U * DRV_FLASH_BLOCK_SIZE];
+    SIM_NVMCTRL_STATISTICS statistics;
+
+    /* The flash holds one pattern, the RAM copy another one */
+    TEST_PatternFill(testWriteBuffer, blockStart, 4U, 0x33U);
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, blockStart, 4U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    TEST_Flush();
+    TEST_PatternFill(testWriteBuffer, blockStart, 4U, 0x44U);
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, blockStart, 4U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+
+    /* Two write backs fail */
+    SIM_NVMCTRL_StatisticsReset();
+    SIM_NVMCTRL_ErrorInject(NVMCTRL_INTFLAG_PROGE_Msk, 2U);
+    TEST_Flush();
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.errors == 1U);
+
+    /* The blocks reported written are still there */
+    TEST_CHECK(TEST_ReadCompare(testWriteBuffer, blockStart, 4U));
+
+    /* The next write reports the error and is not applied */
+    TEST_PatternFill(pattern, blockStart + 4U, 1U, 0x55U);
+    TEST_CHECK(TEST_Transfer(true, pattern, blockStart + 4U, 1U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR);
+    TEST_CHECK(TEST_ReadCompare(TEST_FlashAddress(blockStart + 4U), blockStart + 4U, 1U));
+
+    /* The second try fails too, and is reported once */
+    TEST_Flush();
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.errors == 2U);
+    TEST_CHECK(TEST_Transfer(true, pattern, blockStart + 4U, 1U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR);
+
+    /* The third one writes the blocks back */
+    TEST_Flush();
+    TEST_CHECK(memcmp(TEST_FlashAddress(blockStart), testWriteBuffer, 4U * DRV_FLASH_BLOCK_SIZE) == 0);
+    TEST_CHECK(TEST_Transfer(true, pattern, blockStart + 4U, 1U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    TEST_Flush();
+    TEST_CHECK(memcmp(TEST_FlashAddress(blockStart + 4U), pattern, DRV_FLASH_BLOCK_SIZE) == 0);
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.errors == 2U);
+}
+
+/* A write back that fails while a write to another erase block waits */
+static void TEST_WriteBackErrorPending( void )
+{
+    uint32_t blockStart = 4U * TEST_ERASE_BLOCKS;
+    uint32_t otherStart = 5U * TEST_ERASE_BLOCKS;
+    uint8_t* pattern = &testWriteBuffer[4U * DRV_FLASH_BLOCK_SIZE];
+
+    TEST_PatternFill(testWriteBuffer, blockStart, 4U, 0x66U);
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, blockStart, 4U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+
+    /* The waiting write gets the error */
+    SIM_NVMCTRL_ErrorInject(NVMCTRL_INTFLAG_PROGE_Msk, 1U);
+    TEST_PatternFill(pattern, otherStart, 2U, 0x77U);
+    TEST_CHECK(TEST_Transfer(true, pattern, otherStart, 2U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR);
+    TEST_CHECK(TEST_ReadCompare(testWriteBuffer, blockStart, 4U));
+
+    /* It was reported, so the write made again waits for the next try */
+    TEST_CHECK(TEST_Transfer(true, pattern, otherStart, 2U) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    TEST_CHECK(memcmp(TEST_FlashAddress(blockStart), testWriteBuffer, 4U * DRV_FLASH_BLOCK_SIZE) == 0);
+
+    TEST_Flush();
+    TEST_CHECK(memcmp(TEST_FlashAddress(otherStart), pattern, 2U * DRV_FLASH_BLOCK_SIZE) == 0);
+}
+
+static void TEST_Controller( void )
+{
+    SIM_NVMCTRL_STATISTICS statistics;
+
+    /* The driver never gives a command to a busy NVMCTRL */
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.busyCommands == 0U);
+    TEST_CHECK(statistics.bankSwaps == 0U);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    (void)argc;
+    (void)argv;
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_NVMCTRL_Initialize())
+    {
+        printf("cannot map the NVMCTRL and the flash\n");
+        return 1;
+    }
+    SIM_SYSTEM_Initialize();
+    NVMCTRL_Initialize();
+
+    testFlashObj = DRV_FLASH_Initialize(DRV_FLASH_INDEX_0, (const SYS_MODULE_INIT*)&testFlashInit);
+    TEST_CHECK(testFlashObj != SYS_MODULE_OBJ_INVALID);
+    TEST_CHECK(SIM_SYSTEM_TasksAdd(TEST_FlashTasks));
+
+    testClient.handle = DRV_FLASH_Open(DRV_FLASH_INDEX_0, DRV_IO_INTENT_READWRITE);
+    TEST_CHECK(testClient.handle != DRV_HANDLE_INVALID);
+    DRV_FLASH_EventHandlerSet(testClient.handle, (const void*)TEST_EventHandler, (uintptr_t)&testClient);
+
+    if (testFailures == 0)
+    {
+        TEST_Geometry();
+        TEST_WriteBack();
+        TEST_WriteAcrossBlocks();
+        TEST_WriteBackError();
+        TEST_WriteBackErrorPending();
+        TEST_Controller();
+    }
+
+    DRV_FLASH_Close(testClient.handle);
+
+    printf("test_flash: %s (%d failures, %llu ms of virtual time)\n",
+           (testFailures == 0) ? "pass" : "FAIL", testFailures,
+           (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return (testFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,405 @@
+/*******************************************************************************
+  SYS_KVS Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_kvs.c
+
+  Summary
+    Runs sys_kvs.c and plib_nvmctrl.c against the simulated SmartEEPROM.
+
+  Description
+    The test stores, reads and deletes entries and checks that they are
+    written after the flush delay, once per entry however often they
+    change, and that they are there after a power cycle. It then writes
+    until the active sector is full several times: the store must
+    reallocate it before a write needs it, and keep every entry.
+
+    Last, a power loss cuts an entry write short. After power on the store
+    must hold the old value of the entry or none, never the torn one, and
+    the other entries as they were.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "sim_nvmctrl.h"
+#include "sim_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Processor time of one pass of the main loop */
+#define TEST_LOOP_STEP          SIM_TIME_US(10)
+
+#define TEST_TIMEOUT            SIM_TIME_MS(3000)
+
+#define TEST_CHECK(condition)                                               \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (false)
+
+typedef struct
+{
+    uint16_t key;
+
+    uint8_t length;
+
+    uint8_t value[SYS_KVS_VALUE_SIZE_MAX];
+
+} TEST_ENTRY;
+
+static int testFailures;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool TEST_IsIdle( uintptr_t context )
+{
+    (void)context;
+    return !SYS_KVS_IsBusy();
+}
+
+static bool TEST_IsPowerLost( uintptr_t context )
+{
+    SIM_NVMCTRL_STATISTICS statistics;
+
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    return (statistics.powerLosses != (uint32_t)context);
+}
+
+static bool TEST_Never( uintptr_t context )
+{
+    (void)context;
+    return false;
+}
+
+static void TEST_Run( SIM_TIME duration )
+{
+    (void)SIM_SYSTEM_RunUntil(TEST_Never, 0U, TEST_LOOP_STEP, duration);
+}
+
+/* Writes the changed entries now and waits for the writes */
+static void TEST_Flush( void )
+{
+    SYS_KVS_Flush();
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsIdle, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+}
+
+/* Power on: the NVMCTRL and the store start again from the SmartEEPROM */
+static void TEST_PowerCycle( void )
+{
+    SIM_NVMCTRL_PowerOn();
+    NVMCTRL_Initialize();
+    SYS_KVS_Initialize();
+    TEST_CHECK(SYS_KVS_IsPersistent());
+}
+
+static uint32_t TEST_PageWritesGet( void )
+{
+    SIM_NVMCTRL_STATISTICS statistics;
+
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    return statistics.seePageWrites;
+}
+
+static void TEST_EntryFill( TEST_ENTRY* entry, uint16_t key, uint8_t length, uint8_t seed )
+{
+    uint32_t index;
+
+    entry->key = key;
+    entry->length = length;
+    for (index = 0U; index < SYS_KVS_VALUE_SIZE_MAX; index++)
+    {
+        entry->value[index] = (uint8_t)((index * 29U) + seed);
+    }
+}
+
+static bool TEST_EntrySet( const TEST_ENTRY* entry )
+{
+    return SYS_KVS_Set(entry->key, entry->value, entry->length);
+}
+
+static bool TEST_EntryMatches( const TEST_ENTRY* entry )
+{
+    uint8_t value[SYS_KVS_VALUE_SIZE_MAX];
+
+    memset(value, 0, sizeof(value));
+    return SYS_KVS_Get(entry->key, value, entry->length) && (memcmp(value, entry->value, entry->length) == 0);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Tests
+// *****************************************************************************
+// *****************************************************************************
+
+static void TEST_SetGetDelete( void )
+{
+    TEST_ENTRY entries[4];
+    uint8_t value[SYS_KVS_VALUE_SIZE_MAX + 1U];
+    uint32_t pageWrites;
+    uint32_t index;
+
+    TEST_CHECK(SYS_KVS_IsPersistent());
+    TEST_CHECK((NVMCTRL_REGS->NVMCTRL_SEECFG & NVMCTRL_SEECFG_WMODE_Msk) == NVMCTRL_SEECFG_WMODE_BUFFERED);
+
+    for (index = 0U; index < 4U; index++)
+    {
+        TEST_EntryFill(&entries[index], (uint16_t)(0x100U + index), (uint8_t)(index * 4U), (uint8_t)index);
+        TEST_CHECK(TEST_EntrySet(&entries[index]));
+    }
+    for (index = 0U; index < 4U; index++)
+    {
+        TEST_CHECK(TEST_EntryMatches(&entries[index]));
+    }
+
+    /* Wrong size, invalid key, too large a value, unknown key */
+    TEST_CHECK(!SYS_KVS_Get(entries[1].key, value, entries[1].length + 1U));
+    TEST_CHECK(!SYS_KVS_Set(SYS_KVS_KEY_INVALID, value, 4U));
+    TEST_CHECK(!SYS_KVS_Set(0x200U, value, sizeof(value)));
+    TEST_CHECK(!SYS_KVS_Get(0x200U, value, 4U));
+    TEST_CHECK(!SYS_KVS_Delete(0x200U));
+
+    /* Written once the changes stop for the flush delay */
+    pageWrites = TEST_PageWritesGet();
+    TEST_Run(SIM_TIME_MS(SYS_KVS_FLUSH_DELAY_MS / 2U));
+    TEST_CHECK(TEST_PageWritesGet() == pageWrites);
+    TEST_Run(SIM_TIME_MS(SYS_KVS_FLUSH_DELAY_MS));
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsIdle, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+    TEST_CHECK(TEST_PageWritesGet() == (pageWrites + 4U));
+
+    TEST_PowerCycle();
+    for (index = 0U; index < 4U; index++)
+    {
+        TEST_CHECK(TEST_EntryMatches(&entries[index]));
+    }
+
+    /* Repeated changes cost one write, an unchanged value none */
+    pageWrites = TEST_PageWritesGet();
+    for (index = 0U; index < 10U; index++)
+    {
+        TEST_EntryFill(&entries[2], entries[2].key, entries[2].length, (uint8_t)(0x40U + index));
+        TEST_CHECK(TEST_EntrySet(&entries[2]));
+        TEST_CHECK(TEST_EntrySet(&entries[0]));
+    }
+    TEST_Flush();
+    TEST_CHECK(TEST_PageWritesGet() == (pageWrites + 1U));
+
+    /* A change lost with the power before its write keeps the old value */
+    TEST_EntryFill(&entries[3], entries[3].key, entries[3].length, 0x50U);
+    TEST_CHECK(TEST_EntrySet(&entries[3]));
+    TEST_PowerCycle();
+    TEST_CHECK(!TEST_EntryMatches(&entries[3]));
+    TEST_EntryFill(&entries[3], entries[3].key, entries[3].length, 3U);
+    TEST_CHECK(TEST_EntryMatches(&entries[3]));
+
+    TEST_CHECK(SYS_KVS_Delete(entries[1].key));
+    TEST_CHECK(!TEST_EntryMatches(&entries[1]));
+    TEST_Flush();
+    TEST_PowerCycle();
+    TEST_CHECK(!TEST_EntryMatches(&entries[1]));
+    TEST_CHECK(TEST_EntryMatches(&entries[0]));
+    TEST_CHECK(TEST_EntryMatches(&entries[2]));
+    TEST_CHECK(TEST_EntryMatches(&entries[3]));
+
+    /* The entries run out */
+    for (index = 0U; index < SYS_KVS_ENTRIES_NUMBER; index++)
+    {
+        (void)SYS_KVS_Set((uint16_t)(0x300U + index), value, 1U);
+    }
+    TEST_CHECK(!SYS_KVS_Set(0x400U, value, 1U));
+    for (index = 0U; index < SYS_KVS_ENTRIES_NUMBER; index++)
+    {
+        (void)SYS_KVS_Delete((uint16_t)(0x300U + index));
+    }
+    TEST_CHECK(SYS_KVS_Set(0x400U, value, 1U));
+    TEST_CHECK(SYS_KVS_Delete(0x400U));
+
+    TEST_CHECK(SYS_KVS_Delete(entries[0].key));
+    TEST_CHECK(SYS_KVS_Delete(entries[2].key));
+    TEST_CHECK(SYS_KVS_Delete(entries[3].key));
+    TEST_Flush();
+}
+
+static void TEST_Reallocation( void )
+{
+    TEST_ENTRY entries[SYS_KVS_ENTRIES_NUMBER];
+    SIM_NVMCTRL_STATISTICS statistics;
+    uint32_t index;
+    uint32_t round;
+
+    for (index = 0U; index < SYS_KVS_ENTRIES_NUMBER; index++)
+    {
+        TEST_EntryFill(&entries[index], (uint16_t)(0x500U + index), SYS_KVS_VALUE_SIZE_MAX, (uint8_t)index);
+        TEST_CHECK(TEST_EntrySet(&entries[index]));
+    }
+    TEST_Flush();
+
+    /* Fill the sector three times over, one entry changing at a time */
+    SIM_NVMCTRL_StatisticsReset();
+    for (round = 0U; round < (3U * SIM_NVMCTRL_SEE_SECTOR_WRITES); round++)
+    {
+        index = round % SYS_KVS_ENTRIES_NUMBER;
+        TEST_EntryFill(&entries[index], entries[index].key, SYS_KVS_VALUE_SIZE_MAX, (uint8_t)(round + 1U));
+        TEST_CHECK(TEST_EntrySet(&entries[index]));
+        TEST_Flush();
+    }
+
+    /* The store reallocated each full sector before it was written */
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.seePageWrites == (3U * SIM_NVMCTRL_SEE_SECTOR_WRITES));
+    TEST_CHECK(statistics.seeReallocations >= 3U);
+    TEST_CHECK(statistics.seeAutoReallocations == 0U);
+    TEST_CHECK(statistics.errors == 0U);
+    TEST_CHECK(statistics.busyCommands == 0U);
+
+    TEST_PowerCycle();
+    for (index = 0U; index < SYS_KVS_ENTRIES_NUMBER; index++)
+    {
+        TEST_CHECK(TEST_EntryMatches(&entries[index]));
+    }
+
+    for (index = 0U; index < SYS_KVS_ENTRIES_NUMBER; index++)
+    {
+        TEST_CHECK(SYS_KVS_Delete(entries[index].key));
+    }
+    TEST_Flush();
+}
+
+/* A power loss after size bytes of the write of an entry */
+static void TEST_TornWrite( uint32_t size )
+{
+    TEST_ENTRY others[3];
+    TEST_ENTRY oldEntry;
+    TEST_ENTRY newEntry;
+    SIM_NVMCTRL_STATISTICS statistics;
+    uint8_t value[SYS_KVS_VALUE_SIZE_MAX];
+    uint32_t index;
+
+    for (index = 0U; index < 3U; index++)
+    {
+        TEST_EntryFill(&others[index], (uint16_t)(0x600U + index), 6U, (uint8_t)(0x60U + index));
+        TEST_CHECK(TEST_EntrySet(&others[index]));
+    }
+    TEST_EntryFill(&oldEntry, 0x700U, SYS_KVS_VALUE_SIZE_MAX, 0x70U);
+    TEST_CHECK(TEST_EntrySet(&oldEntry));
+    TEST_Flush();
+
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_EntryFill(&newEntry, oldEntry.key, SYS_KVS_VALUE_SIZE_MAX, 0x80U);
+    TEST_CHECK(TEST_EntrySet(&newEntry));
+    SIM_NVMCTRL_PowerLossInject(size);
+    SYS_KVS_Flush();
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsPowerLost, statistics.powerLosses, TEST_LOOP_STEP, TEST_TIMEOUT));
+
+    TEST_PowerCycle();
+
+    /* The old value or none, never a mix of both */
+    memset(value, 0, sizeof(value));
+    if (SYS_KVS_Get(oldEntry.key, value, SYS_KVS_VALUE_SIZE_MAX))
+    {
+        TEST_CHECK((memcmp(value, oldEntry.value, SYS_KVS_VALUE_SIZE_MAX) == 0) ||
+                   (memcmp(value, newEntry.value, SYS_KVS_VALUE_SIZE_MAX) == 0));
+    }
+    for (index = 0U; index < 3U; index++)
+    {
+        TEST_CHECK(TEST_EntryMatches(&others[index]));
+    }
+
+    /* The store takes the entry again */
+    TEST_CHECK(TEST_EntrySet(&newEntry));
+    TEST_Flush();
+    TEST_PowerCycle();
+    TEST_CHECK(TEST_EntryMatches(&newEntry));
+    for (index = 0U; index < 3U; index++)
+    {
+        TEST_CHECK(TEST_EntryMatches(&others[index]));
+        TEST_CHECK(SYS_KVS_Delete(others[index].key));
+    }
+    TEST_CHECK(SYS_KVS_Delete(newEntry.key));
+    TEST_Flush();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    uint32_t size;
+
+    (void)argc;
+    (void)argv;
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_NVMCTRL_Initialize())
+    {
+        printf("cannot map the NVMCTRL, the flash and the SmartEEPROM\n");
+        return 1;
+    }
+    SIM_SYSTEM_Initialize();
+    NVMCTRL_Initialize();
+    SYS_KVS_Initialize();
+    TEST_CHECK(SIM_SYSTEM_TasksAdd(SYS_KVS_Tasks));
+
+    TEST_SetGetDelete();
+    TEST_Reallocation();
+
+    /* In the header, in the value, and before any byte */
+    for (size = 0U; size < SIM_NVMCTRL_SEE_PAGE_SIZE; size += 3U)
+    {
+        TEST_TornWrite(size);
+    }
+
+    printf("test_kvs: %s (%d failures, %llu ms of virtual time)\n",
+           (testFailures == 0) ? "pass" : "FAIL", testFailures,
+           (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return (testFailures == 0) ? 0 : 1;
+}
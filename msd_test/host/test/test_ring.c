@@ -0,0 +1,338 @@
+/*******************************************************************************
+  Ring Buffer Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_ring.c
+
+  Summary
+    Stresses the SYS_RING rings with producer and consumer threads.
+
+  Description
+    On the target the producers of the rings are interrupts. Here they are
+    threads, running truly in parallel with the consumer, which exercises
+    the host variant of the barriers and of the MPSC reservation.
+
+    Each element carries its producer, its sequence number in that producer
+    and the number of elements left in its batch. The consumer checks that
+    no element is lost, duplicated or reordered within a producer, and that
+    the elements of one batch come out next to each other. The rings are
+    small so that they wrap and run full all the time.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "system/ring/sys_ring.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_RING_SIZE          (16U)
+
+#define TEST_PRODUCERS          (4U)
+
+#define TEST_ELEMENTS           (400000U)
+
+#define TEST_BATCH_MAX          (5U)
+
+/* Wall clock time without a new element after which the consumer reports
+   the missing elements as lost */
+#define TEST_STALL_SECONDS      (5)
+
+/* Producer in bits 56 to 63, elements left in the batch in bits 48 to 55
+   and the sequence number in bits 0 to 31 */
+#define TEST_ELEMENT(producer, left, sequence)                              \
+    (((uint64_t)(producer) << 56) | ((uint64_t)(left) << 48) | (uint64_t)(sequence))
+#define TEST_ELEMENT_PRODUCER(element)  ((uint32_t)((element) >> 56))
+#define TEST_ELEMENT_LEFT(element)      ((uint32_t)((element) >> 48) & 0xFFU)
+#define TEST_ELEMENT_SEQUENCE(element)  ((uint32_t)(element))
+
+static SYS_RING testRing;
+
+static uint64_t testRingStorage[TEST_RING_SIZE];
+
+static SYS_RING_MPSC testMpscRing;
+
+static uint64_t testMpscStorage[TEST_RING_SIZE];
+
+static volatile uint32_t testMpscSequence[TEST_RING_SIZE];
+
+static uint32_t testFailures;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t TEST_BatchSize( uint32_t* random )
+{
+    /* xorshift32 */
+    *random ^= *random << 13;
+    *random ^= *random >> 17;
+    *random ^= *random << 5;
+    return (*random % TEST_BATCH_MAX) + 1U;
+}
+
+static void TEST_BatchFill( uint64_t* batch, uint32_t producer, uint32_t sequence, uint32_t count )
+{
+    uint32_t index;
+
+    for (index = 0U; index < count; index++)
+    {
+        batch[index] = TEST_ELEMENT(producer, count - index - 1U, sequence + index);
+    }
+}
+
+static void* TEST_SpscProducer( void* context )
+{
+    uint64_t batch[TEST_BATCH_MAX];
+    uint32_t random = 1U;
+    uint32_t sequence = 0U;
+    uint32_t count;
+    uint32_t written;
+
+    (void)context;
+
+    while (sequence < TEST_ELEMENTS)
+    {
+        count = TEST_BatchSize(&random);
+        if (count > (TEST_ELEMENTS - sequence))
+        {
+            count = TEST_ELEMENTS - sequence;
+        }
+        TEST_BatchFill(batch, 0U, sequence, count);
+
+        /* The SPSC ring may take part of a batch */
+        written = SYS_RING_Write(&testRing, testRingStorage, sizeof(uint64_t), batch, count);
+        sequence += written;
+        if (written == 0U)
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* TEST_MpscProducer( void* context )
+{
+    uint64_t batch[TEST_BATCH_MAX];
+    uint32_t producer = (uint32_t)(uintptr_t)context;
+    uint32_t random = producer + 1U;
+    uint32_t sequence = 0U;
+    uint32_t count;
+
+    while (sequence < TEST_ELEMENTS)
+    {
+        count = TEST_BatchSize(&random);
+        if (count > (TEST_ELEMENTS - sequence))
+        {
+            count = TEST_ELEMENTS - sequence;
+        }
+        TEST_BatchFill(batch, producer, sequence, count);
+
+        if (SYS_RING_MPSC_Write(&testMpscRing, testMpscStorage, sizeof(uint64_t), batch, count))
+        {
+            sequence += count;
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void TEST_Fail( const char* test, uint64_t element, const char* reason )
+{
+    if (testFailures < 10U)
+    {
+        printf("%s: element 0x%016llx %s\n", test, (unsigned long long)element, reason);
+    }
+    testFailures++;
+}
+
+/* Called when the consumer found the ring empty. Returns true once it has
+   been empty for TEST_STALL_SECONDS. */
+static bool TEST_IsStalled( uint32_t received, uint32_t* lastReceived, time_t* lastTime )
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    if (received != *lastReceived)
+    {
+        *lastReceived = received;
+        *lastTime = now.tv_sec;
+        return false;
+    }
+    sched_yield();
+    return ((now.tv_sec - *lastTime) > TEST_STALL_SECONDS);
+}
+
+static void TEST_SpscRun( void )
+{
+    pthread_t producer;
+    uint64_t elements[7];
+    uint32_t expected = 0U;
+    uint32_t received = 0U;
+    uint32_t lastReceived = ~0U;
+    time_t lastTime = 0;
+    uint32_t count;
+    uint32_t index;
+
+    SYS_RING_Initialize(&testRing, TEST_RING_SIZE);
+    (void)pthread_create(&producer, NULL, TEST_SpscProducer, NULL);
+
+    while (received < TEST_ELEMENTS)
+    {
+        count = SYS_RING_Read(&testRing, testRingStorage, sizeof(uint64_t), elements, 7U);
+        for (index = 0U; index < count; index++)
+        {
+            if (TEST_ELEMENT_SEQUENCE(elements[index]) != expected)
+            {
+                TEST_Fail("spsc", elements[index], "out of sequence");
+            }
+            expected = TEST_ELEMENT_SEQUENCE(elements[index]) + 1U;
+            received++;
+        }
+        if ((count == 0U) && TEST_IsStalled(received, &lastReceived, &lastTime))
+        {
+            TEST_Fail("spsc", TEST_ELEMENT(0U, 0U, expected), "never came");
+            return;
+        }
+    }
+
+    (void)pthread_join(producer, NULL);
+    if (SYS_RING_Read(&testRing, testRingStorage, sizeof(uint64_t), elements, 7U) != 0U)
+    {
+        TEST_Fail("spsc", elements[0], "after the last element");
+    }
+}
+
+static void TEST_MpscRun( void )
+{
+    pthread_t producers[TEST_PRODUCERS];
+    uint32_t expected[TEST_PRODUCERS] = { 0U };
+    uint64_t elements[3];
+    uint32_t received = 0U;
+    uint32_t lastReceived = ~0U;
+    time_t lastTime = 0;
+    uint32_t batchProducer = 0U;
+    uint32_t batchLeft = 0U;
+    uint32_t producer;
+    uint32_t count;
+    uint32_t index;
+
+    SYS_RING_MPSC_Initialize(&testMpscRing, testMpscSequence, TEST_RING_SIZE);
+    for (producer = 0U; producer < TEST_PRODUCERS; producer++)
+    {
+        (void)pthread_create(&producers[producer], NULL, TEST_MpscProducer, (void*)(uintptr_t)producer);
+    }
+
+    while (received < (TEST_PRODUCERS * TEST_ELEMENTS))
+    {
+        /* Read fewer elements than a batch, so that batches are split
+           between reads */
+        count = SYS_RING_MPSC_Read(&testMpscRing, testMpscStorage, sizeof(uint64_t), elements, 3U);
+        for (index = 0U; index < count; index++)
+        {
+            uint64_t element = elements[index];
+
+            producer = TEST_ELEMENT_PRODUCER(element);
+            if (producer >= TEST_PRODUCERS)
+            {
+                TEST_Fail("mpsc", element, "from no producer");
+                continue;
+            }
+            if ((batchLeft != 0U) && ((producer != batchProducer) || (TEST_ELEMENT_LEFT(element) != (batchLeft - 1U))))
+            {
+                TEST_Fail("mpsc", element, "inside the batch of another producer");
+            }
+            if (TEST_ELEMENT_SEQUENCE(element) != expected[producer])
+            {
+                TEST_Fail("mpsc", element, "out of sequence");
+            }
+            batchProducer = producer;
+            batchLeft = TEST_ELEMENT_LEFT(element);
+            expected[producer] = TEST_ELEMENT_SEQUENCE(element) + 1U;
+            received++;
+        }
+        if ((count == 0U) && TEST_IsStalled(received, &lastReceived, &lastTime))
+        {
+            for (producer = 0U; producer < TEST_PRODUCERS; producer++)
+            {
+                if (expected[producer] != TEST_ELEMENTS)
+                {
+                    TEST_Fail("mpsc", TEST_ELEMENT(producer, 0U, expected[producer]), "never came");
+                }
+            }
+            return;
+        }
+    }
+
+    for (producer = 0U; producer < TEST_PRODUCERS; producer++)
+    {
+        (void)pthread_join(producers[producer], NULL);
+        if (expected[producer] != TEST_ELEMENTS)
+        {
+            TEST_Fail("mpsc", TEST_ELEMENT(producer, 0U, expected[producer]), "is the last of its producer");
+        }
+    }
+    if (SYS_RING_MPSC_Read(&testMpscRing, testMpscStorage, sizeof(uint64_t), elements, 3U) != 0U)
+    {
+        TEST_Fail("mpsc", elements[0], "after the last element");
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( void )
+{
+    TEST_SpscRun();
+    TEST_MpscRun();
+
+    printf("test_ring: %s (%lu failures)\n", (testFailures == 0U) ? "pass" : "FAIL", (unsigned long)testFailures);
+    return (testFailures == 0U) ? 0 : 1;
+}
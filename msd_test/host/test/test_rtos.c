@@ -0,0 +1,369 @@
+/*******************************************************************************
+  FreeRTOS Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_rtos.c
+
+  Summary
+    Runs the tasks of SYS_SCHED as FreeRTOS tasks on the POSIX port.
+
+  Description
+    The test builds sys_sched.c, osal_freertos.c and freertos_hooks.c with
+    OSAL_USE_RTOS and runs a table of three tasks at the priorities of the
+    project configuration: an SDMMC task that stays busy, a USB task and an
+    APP task. A control task above them stands for the USB interrupt.
+
+    - Priority isolation: while the SDMMC task is busy and never blocks,
+      the control task posts the USB event from its interrupt every tick.
+      The USB task has to run within TEST_LATENCY_MAX_US of every post,
+      and the APP task, below the SDMMC task, must not run until the SDMMC
+      task is done.
+    - Stack high-water marks: the USB task uses TEST_STACK_USED bytes of its
+      stack once. SYS_SCHED_TaskStatisticsGet has to report that much less
+      free stack for it than for the APP task.
+    - Run-time statistics: the processor time the kernel counts for the
+      SDMMC task has to match the time it spent busy, the USB and APP tasks
+      have to have used far less, and the idle hook has to have accounted
+      the idle time.
+
+    The test runs in real time, in about a second.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "configuration.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "osal/osal.h"
+#include "system/sched/sys_sched.h"
+#include "system/time/sys_time.h"
+#include "sim_rtos.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* USB interrupts the control task raises, one per tick */
+#define TEST_POSTS_NUMBER       (200U)
+
+/* Processor time of one step of the SDMMC task */
+#define TEST_STORAGE_STEP_US    (10000U)
+
+/* Longest time from a USB interrupt to the run of the USB task. The SDMMC
+   task does not give the processor up in TEST_STORAGE_STEP_US. */
+#define TEST_LATENCY_MAX_US     (5000U)
+
+/* Stack of every task. The stack is the one of the task thread, so it
+   holds at least PTHREAD_STACK_MIN bytes. */
+#define TEST_STACK_BYTES        (256U * 1024U)
+
+/* Stack the USB task uses once */
+#define TEST_STACK_USED         (64U * 1024U)
+
+#define TEST_CONTROL_PRIORITY   (configMAX_PRIORITIES - 1U)
+
+#define TEST_US_TO_COUNT(us)    ((uint64_t)(us) * (SIM_RTOS_COUNTER_FREQUENCY / 1000000U))
+
+#define TEST_CHECK(condition)                                               \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (false)
+
+enum
+{
+    TEST_TASK_SDMMC = 0,
+    TEST_TASK_USB,
+    TEST_TASK_APP,
+};
+
+typedef struct
+{
+    /* Set until the control task is done with the USB interrupts */
+    volatile bool isStorageBusy;
+
+    volatile uint32_t storageSteps;
+
+    /* Interrupts raised, the time of the last one, and the interrupts the
+       USB task has seen */
+    volatile uint32_t posts;
+
+    volatile uint64_t postTime;
+
+    volatile uint32_t handled;
+
+    volatile uint64_t latencyMax;
+
+    volatile uint32_t appRuns;
+
+    /* Given by the USB task when it has seen every interrupt */
+    OSAL_SEM_HANDLE_TYPE doneSemaphore;
+
+} TEST_OBJ;
+
+static TEST_OBJ testObj;
+
+static int testFailures;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Test Tasks
+// *****************************************************************************
+// *****************************************************************************
+
+/* Writes bytes of the stack of the caller */
+static void __attribute__((noinline)) TEST_StackUse( void )
+{
+    volatile uint8_t buffer[TEST_STACK_USED];
+    size_t index;
+
+    for (index = 0U; index < sizeof(buffer); index++)
+    {
+        buffer[index] = (uint8_t)index;
+    }
+}
+
+static void TEST_StorageTasks( void )
+{
+    uint64_t end = SYS_TIME_Counter64Get() + TEST_US_TO_COUNT(TEST_STORAGE_STEP_US);
+
+    if (!testObj.isStorageBusy)
+    {
+        return;
+    }
+
+    /* Keeps the processor as a transfer polled to its end does */
+    while (SYS_TIME_Counter64Get() < end)
+    {
+    }
+    testObj.storageSteps++;
+}
+
+static bool TEST_StorageIsBusy( void )
+{
+    return testObj.isStorageBusy;
+}
+
+static void TEST_UsbTasks( void )
+{
+    uint64_t latency;
+
+    if (testObj.handled == 0U)
+    {
+        TEST_StackUse();
+    }
+    if (testObj.handled == testObj.posts)
+    {
+        return;
+    }
+
+    latency = SYS_TIME_Counter64Get() - testObj.postTime;
+    if (latency > testObj.latencyMax)
+    {
+        testObj.latencyMax = latency;
+    }
+
+    testObj.handled = testObj.posts;
+    if (testObj.handled == TEST_POSTS_NUMBER)
+    {
+        (void)OSAL_SEM_Post(&testObj.doneSemaphore);
+    }
+}
+
+static void TEST_AppTasks( void )
+{
+    testObj.appRuns++;
+}
+
+static const SYS_SCHED_TASK testTasks[] =
+{
+    [TEST_TASK_SDMMC] =
+    {
+        .name = "SDMMC",
+        .run = TEST_StorageTasks,
+        .isBusy = TEST_StorageIsBusy,
+        .events = SYS_SCHED_EVENT_SDHC,
+        .runEvents = 0U,
+        .rtosPriority = DRV_SDMMC_RTOS_TASK_PRIORITY,
+        .rtosStackSize = TEST_STACK_BYTES / sizeof(StackType_t),
+    },
+    [TEST_TASK_USB] =
+    {
+        .name = "USB",
+        .run = TEST_UsbTasks,
+        .isBusy = NULL,
+        .events = SYS_SCHED_EVENT_USB,
+        .runEvents = 0U,
+        .rtosPriority = USB_DEVICE_RTOS_TASK_PRIORITY,
+        .rtosStackSize = TEST_STACK_BYTES / sizeof(StackType_t),
+    },
+    [TEST_TASK_APP] =
+    {
+        .name = "APP",
+        .run = TEST_AppTasks,
+        .isBusy = NULL,
+        .events = SYS_SCHED_EVENT_USB,
+        .runEvents = 0U,
+        .rtosPriority = APP_RTOS_TASK_PRIORITY,
+        .rtosStackSize = TEST_STACK_BYTES / sizeof(StackType_t),
+    },
+};
+
+#define TEST_TASKS_NUMBER       (sizeof(testTasks) / sizeof(testTasks[0]))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void TEST_Isolation( uint32_t appRunsBusy )
+{
+    printf("# posts=%lu handled=%lu latency_max_us=%llu storage_steps=%lu app_runs_busy=%lu app_runs=%lu\n",
+           (unsigned long)testObj.posts, (unsigned long)testObj.handled,
+           (unsigned long long)(testObj.latencyMax / TEST_US_TO_COUNT(1U)),
+           (unsigned long)testObj.storageSteps, (unsigned long)appRunsBusy,
+           (unsigned long)testObj.appRuns);
+
+    TEST_CHECK(testObj.handled == TEST_POSTS_NUMBER);
+    TEST_CHECK(testObj.latencyMax <= TEST_US_TO_COUNT(TEST_LATENCY_MAX_US));
+    TEST_CHECK(testObj.storageSteps > 0U);
+    TEST_CHECK(appRunsBusy == 0U);
+    TEST_CHECK(testObj.appRuns > 0U);
+}
+
+static void TEST_Statistics( uint64_t elapsed )
+{
+    SYS_SCHED_TASK_STATISTICS statistics[TEST_TASKS_NUMBER];
+    uint64_t runTimeTotal = 0U;
+    uint64_t storageTime = testObj.storageSteps * TEST_US_TO_COUNT(TEST_STORAGE_STEP_US);
+    size_t task;
+
+    for (task = 0U; task < TEST_TASKS_NUMBER; task++)
+    {
+        TEST_CHECK(SYS_SCHED_TaskStatisticsGet(task, &statistics[task]));
+        printf("# task=%s runs=%lu run_us=%llu stack_free=%lu\n", SYS_SCHED_TaskNameGet(task),
+               (unsigned long)statistics[task].runs,
+               (unsigned long long)(statistics[task].runTime / TEST_US_TO_COUNT(1U)),
+               (unsigned long)statistics[task].stackFree);
+        runTimeTotal += statistics[task].runTime;
+    }
+    printf("# elapsed_us=%llu idle_us=%llu\n", (unsigned long long)(elapsed / TEST_US_TO_COUNT(1U)),
+           (unsigned long long)(SYS_SCHED_IdleTimeGet() / TEST_US_TO_COUNT(1U)));
+
+    /* Stack high-water marks */
+    TEST_CHECK(statistics[TEST_TASK_USB].stackFree > 0U);
+    TEST_CHECK(statistics[TEST_TASK_USB].stackFree <= (TEST_STACK_BYTES - TEST_STACK_USED));
+    TEST_CHECK(statistics[TEST_TASK_APP].stackFree > (TEST_STACK_BYTES - TEST_STACK_USED));
+    TEST_CHECK(statistics[TEST_TASK_SDMMC].stackFree > (TEST_STACK_BYTES - TEST_STACK_USED));
+
+    /* Run-time statistics: the kernel counts the busy time of the SDMMC
+       task, which the other tasks do not come near */
+    TEST_CHECK(statistics[TEST_TASK_SDMMC].runTime >= ((storageTime * 3U) / 4U));
+    TEST_CHECK(statistics[TEST_TASK_USB].runTime < (statistics[TEST_TASK_SDMMC].runTime / 10U));
+    TEST_CHECK(statistics[TEST_TASK_APP].runTime < (statistics[TEST_TASK_SDMMC].runTime / 10U));
+    TEST_CHECK(runTimeTotal <= elapsed);
+    TEST_CHECK(statistics[TEST_TASK_USB].runs > TEST_POSTS_NUMBER);
+    TEST_CHECK(SYS_SCHED_IdleTimeGet() > 0U);
+}
+
+/* Stands for the USB interrupt, then checks the results and ends the test */
+static void TEST_ControlTask( void* parameter )
+{
+    uint64_t start = SYS_TIME_Counter64Get();
+    uint32_t appRunsBusy;
+    uint32_t post;
+
+    (void)parameter;
+
+    for (post = 0U; post < TEST_POSTS_NUMBER; post++)
+    {
+        vTaskDelay(1U);
+
+        testObj.postTime = SYS_TIME_Counter64Get();
+        testObj.posts++;
+        SIM_RTOS_InterruptEnter();
+        SYS_SCHED_EventPost(SYS_SCHED_EVENT_USB);
+        SIM_RTOS_InterruptLeave();
+    }
+    TEST_CHECK(OSAL_SEM_Pend(&testObj.doneSemaphore, 1000U) == OSAL_RESULT_SUCCESS);
+
+    /* The tasks below the SDMMC task and the idle task run once it is done */
+    appRunsBusy = testObj.appRuns;
+    testObj.isStorageBusy = false;
+    vTaskDelay(pdMS_TO_TICKS(100U));
+
+    TEST_Isolation(appRunsBusy);
+    TEST_Statistics(SYS_TIME_Counter64Get() - start);
+
+    printf("test_rtos: %s (%d failures)\n", (testFailures == 0) ? "pass" : "FAIL", testFailures);
+    fflush(stdout);
+    exit((testFailures == 0) ? 0 : 1);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    (void)argc;
+    (void)argv;
+
+    testObj.isStorageBusy = true;
+    if ((OSAL_SEM_Create(&testObj.doneSemaphore, OSAL_SEM_TYPE_BINARY, 1U, 0U) != OSAL_RESULT_SUCCESS) ||
+        (xTaskCreate(TEST_ControlTask, "CONTROL", TEST_STACK_BYTES / sizeof(StackType_t), NULL,
+                     TEST_CONTROL_PRIORITY, NULL) != pdPASS))
+    {
+        printf("test_rtos: cannot create the control task\n");
+        return 1;
+    }
+
+    SYS_SCHED_Initialize(testTasks, TEST_TASKS_NUMBER);
+    SYS_SCHED_Run();
+
+    printf("test_rtos: the scheduler returned\n");
+    return 1;
+}
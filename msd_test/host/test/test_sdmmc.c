@@ -0,0 +1,394 @@
+/*******************************************************************************
+  DRV_SDMMC Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_sdmmc.c
+
+  Summary
+    Runs drv_sdmmc.c against the simulated SDHC0 and SD card.
+
+  Description
+    The test attaches the card, checks the geometry the driver reads from
+    the CSD, and moves data through single and multiple block requests,
+    checking it against the image file. It then checks that the driver
+    reports the errors of the card and the controller, and recovers from
+    them on the next request, and that it detaches and attaches again when
+    the card is removed and inserted.
+
+    The optional argument is the path of the image file, by default
+    test_sdmmc.img in the current directory.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "definitions.h"
+#include "sim_sdhc.h"
+#include "sim_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_CAPACITY           (64U * 1024U * 1024U)
+#define TEST_NUM_BLOCKS         (TEST_CAPACITY / 512U)
+
+/* Processor time of one pass of the main loop */
+#define TEST_LOOP_STEP          SIM_TIME_US(2)
+
+#define TEST_TIMEOUT            SIM_TIME_MS(3000)
+
+#define TEST_MAX_BLOCKS         (256U)
+
+#define TEST_CHECK(condition)                                               \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (false)
+
+typedef struct
+{
+    DRV_HANDLE handle;
+
+    volatile bool isDone;
+
+    volatile SYS_MEDIA_BLOCK_EVENT event;
+
+    DRV_SDMMC_COMMAND_HANDLE commandHandle;
+
+} TEST_CLIENT;
+
+static TEST_CLIENT testClient;
+
+static int testFailures;
+
+static int testImageFd = -1;
+
+static uint8_t testWriteBuffer[TEST_MAX_BLOCKS * 512U] __attribute__((aligned(4)));
+
+static uint8_t testReadBuffer[TEST_MAX_BLOCKS * 512U] __attribute__((aligned(4)));
+
+static uint8_t testFileBuffer[TEST_MAX_BLOCKS * 512U];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void TEST_EventHandler( SYS_MEDIA_BLOCK_EVENT event, SYS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle, uintptr_t context )
+{
+    TEST_CLIENT* client = (TEST_CLIENT*)context;
+
+    if (commandHandle == client->commandHandle)
+    {
+        client->event = event;
+        client->isDone = true;
+    }
+}
+
+static bool TEST_IsDone( uintptr_t context )
+{
+    return ((TEST_CLIENT*)context)->isDone;
+}
+
+static bool TEST_IsAttached( uintptr_t context )
+{
+    (void)context;
+    return DRV_SDMMC_IsAttached(testClient.handle);
+}
+
+static bool TEST_IsDetached( uintptr_t context )
+{
+    (void)context;
+    return !DRV_SDMMC_IsAttached(testClient.handle);
+}
+
+static bool TEST_IsOpen( uintptr_t context )
+{
+    TEST_CLIENT* client = (TEST_CLIENT*)context;
+
+    client->handle = DRV_SDMMC_Open(DRV_SDMMC_INDEX_0, DRV_IO_INTENT_READWRITE);
+    return client->handle != DRV_HANDLE_INVALID;
+}
+
+static void TEST_PatternFill( uint8_t* buffer, uint32_t blockStart, uint32_t nBlocks, uint8_t seed )
+{
+    uint32_t index;
+
+    for (index = 0U; index < (nBlocks * 512U); index++)
+    {
+        buffer[index] = (uint8_t)(((blockStart * 512U) + index) * 7U + seed);
+    }
+}
+
+/* Submits a request and runs the system until it completes. Returns the
+   event, or SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR if the request was not
+   accepted or did not complete. The time it took goes in elapsed. */
+static SYS_MEDIA_BLOCK_EVENT TEST_Transfer( bool isWrite, uint8_t* buffer, uint32_t blockStart, uint32_t nBlocks, SIM_TIME* elapsed )
+{
+    SIM_TIME start = SIM_CLOCK_Now();
+
+    testClient.isDone = false;
+    testClient.event = SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR;
+    testClient.commandHandle = DRV_SDMMC_COMMAND_HANDLE_INVALID;
+
+    if (isWrite)
+    {
+        DRV_SDMMC_AsyncWrite(testClient.handle, &testClient.commandHandle, buffer, blockStart, nBlocks);
+    }
+    else
+    {
+        DRV_SDMMC_AsyncRead(testClient.handle, &testClient.commandHandle, buffer, blockStart, nBlocks);
+    }
+    if (testClient.commandHandle == DRV_SDMMC_COMMAND_HANDLE_INVALID)
+    {
+        return SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR;
+    }
+
+    if (!SIM_SYSTEM_RunUntil(TEST_IsDone, (uintptr_t)&testClient, TEST_LOOP_STEP, TEST_TIMEOUT))
+    {
+        printf("request at block %lu did not complete\n", (unsigned long)blockStart);
+        return SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR;
+    }
+    if (elapsed != NULL)
+    {
+        *elapsed = SIM_CLOCK_Now() - start;
+    }
+    return testClient.event;
+}
+
+/* Writes a pattern, reads it back through the driver and from the image */
+static void TEST_WriteReadCheck( uint32_t blockStart, uint32_t nBlocks, uint8_t seed )
+{
+    size_t length = (size_t)nBlocks * 512U;
+
+    TEST_PatternFill(testWriteBuffer, blockStart, nBlocks, seed);
+    memset(testReadBuffer, 0, length);
+
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, blockStart, nBlocks, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    TEST_CHECK(TEST_Transfer(false, testReadBuffer, blockStart, nBlocks, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    TEST_CHECK(memcmp(testWriteBuffer, testReadBuffer, length) == 0);
+
+    TEST_CHECK(pread(testImageFd, testFileBuffer, length, (off_t)blockStart * 512) == (ssize_t)length);
+    TEST_CHECK(memcmp(testWriteBuffer, testFileBuffer, length) == 0);
+}
+
+static void TEST_Attach( void )
+{
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsAttached, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Tests
+// *****************************************************************************
+// *****************************************************************************
+
+static void TEST_Geometry( void )
+{
+    SYS_MEDIA_GEOMETRY* geometry = DRV_SDMMC_GeometryGet(testClient.handle);
+
+    TEST_CHECK(geometry != NULL);
+    if (geometry != NULL)
+    {
+        TEST_CHECK(geometry->numReadRegions == 1U);
+        TEST_CHECK(geometry->geometryTable[0].blockSize == 512U);
+        TEST_CHECK(geometry->geometryTable[0].numBlocks == TEST_NUM_BLOCKS);
+    }
+}
+
+static void TEST_Transfers( void )
+{
+    TEST_WriteReadCheck(0U, 1U, 0x11U);
+    TEST_WriteReadCheck(1000U, 16U, 0x22U);
+    TEST_WriteReadCheck(4096U, 128U, 0x33U);
+    TEST_WriteReadCheck(TEST_NUM_BLOCKS - 1U, 1U, 0x44U);
+    TEST_WriteReadCheck(TEST_NUM_BLOCKS - 8U, 8U, 0x55U);
+}
+
+static void TEST_Timing( void )
+{
+    SIM_TIME elapsed = 0U;
+    SIM_SDHC_STATISTICS statistics;
+
+    /* 128 blocks on a 4-bit bus at 25 MHz take 5.3 ms on the bus, plus
+       the access time of the card and the commands around them */
+    TEST_CHECK(TEST_Transfer(false, testReadBuffer, 4096U, 128U, &elapsed) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    TEST_CHECK(elapsed > SIM_TIME_US(5300));
+    TEST_CHECK(elapsed < SIM_TIME_MS(8));
+
+    SIM_SDHC_StatisticsReset();
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, 4096U, 128U, &elapsed) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    SIM_SDHC_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.writeCommands == 1U);
+    TEST_CHECK(statistics.writeBlocks == 128U);
+    TEST_CHECK(statistics.dataBusyTime <= elapsed);
+}
+
+static void TEST_Errors( void )
+{
+    SIM_SDHC_STATISTICS statistics;
+
+    TEST_PatternFill(testWriteBuffer, 2000U, 4U, 0x66U);
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, 2000U, 4U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+
+    /* Each error fails its request only */
+    SIM_SDHC_StatisticsReset();
+    SIM_SDHC_ErrorInject(SIM_SDHC_ERROR_DATA_CRC, 1U);
+    TEST_CHECK(TEST_Transfer(false, testReadBuffer, 2000U, 4U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR);
+    memset(testReadBuffer, 0, 4U * 512U);
+    TEST_CHECK(TEST_Transfer(false, testReadBuffer, 2000U, 4U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    TEST_CHECK(memcmp(testWriteBuffer, testReadBuffer, 4U * 512U) == 0);
+
+    SIM_SDHC_ErrorInject(SIM_SDHC_ERROR_COMMAND_CRC, 1U);
+    TEST_CHECK(TEST_Transfer(false, testReadBuffer, 2000U, 4U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR);
+    TEST_CHECK(TEST_Transfer(false, testReadBuffer, 2000U, 4U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+
+    SIM_SDHC_ErrorInject(SIM_SDHC_ERROR_DATA_TIMEOUT, 1U);
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, 2000U, 4U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR);
+    TEST_WriteReadCheck(2000U, 4U, 0x77U);
+
+    SIM_SDHC_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.dataCrcErrors == 1U);
+    TEST_CHECK(statistics.commandCrcErrors == 1U);
+    TEST_CHECK(statistics.dataTimeouts == 1U);
+
+    /* Past the end of the card: the card flags the command and sends no
+       data */
+    TEST_CHECK(TEST_Transfer(false, testReadBuffer, TEST_NUM_BLOCKS - 1U, 2U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR);
+    TEST_WriteReadCheck(TEST_NUM_BLOCKS - 2U, 2U, 0x88U);
+
+    /* The PLIB sets up one ADMA2 line of up to 64 KB and leaves the
+       previous line in place for a longer request, which the controller
+       rejects instead of moving the wrong data */
+    SIM_SDHC_StatisticsReset();
+    TEST_CHECK(TEST_Transfer(false, testReadBuffer, 0U, 256U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR);
+    SIM_SDHC_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.admaErrors == 1U);
+    TEST_CHECK(statistics.readBlocks == 0U);
+    TEST_WriteReadCheck(0U, 128U, 0x99U);
+}
+
+static void TEST_CardDetect( void )
+{
+    TEST_PatternFill(testWriteBuffer, 3000U, 2U, 0xAAU);
+    TEST_CHECK(TEST_Transfer(true, testWriteBuffer, 3000U, 2U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+
+    SIM_SDHC_CardInsert(false);
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsDetached, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+    TEST_CHECK(TEST_Transfer(false, testReadBuffer, 3000U, 2U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR);
+
+    SIM_SDHC_CardInsert(true);
+    TEST_Attach();
+    memset(testReadBuffer, 0, 2U * 512U);
+    TEST_CHECK(TEST_Transfer(false, testReadBuffer, 3000U, 2U, NULL) == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE);
+    TEST_CHECK(memcmp(testWriteBuffer, testReadBuffer, 2U * 512U) == 0);
+
+    /* Removed with a request in progress */
+    DRV_SDMMC_AsyncRead(testClient.handle, &testClient.commandHandle, testReadBuffer, 0U, 128U);
+    testClient.isDone = false;
+    SIM_SYSTEM_Tasks(TEST_LOOP_STEP);
+    SIM_SYSTEM_Tasks(TEST_LOOP_STEP);
+    SIM_SDHC_CardInsert(false);
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsDetached, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+    TEST_CHECK(testClient.isDone && (testClient.event == SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR));
+
+    SIM_SDHC_CardInsert(true);
+    TEST_Attach();
+    TEST_WriteReadCheck(3000U, 2U, 0xBBU);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    const char* imagePath = (argc > 1) ? argv[1] : "test_sdmmc.img";
+    SIM_SDHC_INIT sdhcInit =
+    {
+        .imagePath = imagePath,
+        .capacity = TEST_CAPACITY,
+        .profile = SIM_SDHC_ProfileGet("typical"),
+        .seed = 1U,
+        .isInserted = true,
+    };
+
+    (void)unlink(imagePath);
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_SDHC_Initialize(&sdhcInit))
+    {
+        printf("cannot create %s\n", imagePath);
+        return 1;
+    }
+    testImageFd = open(imagePath, O_RDONLY);
+    SIM_SYSTEM_Initialize();
+
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsOpen, (uintptr_t)&testClient, TEST_LOOP_STEP, TEST_TIMEOUT));
+    DRV_SDMMC_EventHandlerSet(testClient.handle, (const void*)TEST_EventHandler, (uintptr_t)&testClient);
+    TEST_Attach();
+
+    if (testFailures == 0)
+    {
+        TEST_Geometry();
+        TEST_Transfers();
+        TEST_Timing();
+        TEST_Errors();
+        TEST_CardDetect();
+    }
+
+    DRV_SDMMC_Close(testClient.handle);
+    (void)close(testImageFd);
+    SIM_SDHC_Deinitialize();
+    (void)unlink(imagePath);
+
+    printf("test_sdmmc: %s (%d failures, %llu ms of virtual time)\n",
+           (testFailures == 0) ? "pass" : "FAIL", testFailures,
+           (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return (testFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,350 @@
+/*******************************************************************************
+  SYS_TIME Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_time.c
+
+  Summary
+    Runs sys_time.c against the simulated TC0 timer.
+
+  Description
+    The test runs SYS_TIME callbacks in virtual time and checks when each
+    of them comes: never before its due time, and not later than one wheel
+    tick after it. It is built twice, for the delta list engine and for
+    the timing wheel engine of SYS_TIME_TIMING_WHEEL_ENABLE.
+
+    - Periodic timers of 1 ms and 7 ms run together for a second. The 7 ms
+      timer moves down from the second level of the wheel on the tick of
+      an expiry of the 1 ms timer, which the wheel once took a full
+      revolution of that level later.
+    - Single shot timers expire from every level of the wheel, with a 1 ms
+      timer running beside them.
+    - Timers are created, destroyed and replaced at random, and each one
+      has to come as many times as its period allows.
+    - The wheel engine keeps periodic timers free of drift.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "sim_clock.h"
+#include "sim_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Timers the test runs at the same time. SYS_TIME_MAX_TIMERS bounds it. */
+#define TEST_TIMERS_NUMBER      (6U)
+
+/* A wheel tick of 8192 counts at 60 MHz, and the compare update margin */
+#define TEST_LATENESS_MAX       SIM_TIME_US(150)
+
+/* Rounding of the counts to nanoseconds */
+#define TEST_EARLINESS_MAX      SIM_TIME_US(1)
+
+#define TEST_CHECK(condition)                                               \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (false)
+
+typedef struct
+{
+    SYS_TIME_HANDLE handle;
+
+    SYS_TIME_CALLBACK_TYPE type;
+
+    /* Time the timer was started, and its period or delay */
+    SIM_TIME start;
+
+    SIM_TIME period;
+
+    /* Callbacks so far, and the time of the last one */
+    uint32_t count;
+
+    SIM_TIME last;
+
+    /* Callbacks before their due time, and after their due time plus
+       TEST_LATENESS_MAX */
+    uint32_t early;
+
+    uint32_t late;
+
+    SIM_TIME lateMax;
+
+} TEST_TIMER;
+
+static TEST_TIMER testTimers[TEST_TIMERS_NUMBER];
+
+static int testFailures;
+
+static uint32_t testSeed = 1U;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t TEST_RandomGet( uint32_t range )
+{
+    testSeed = (testSeed * 1103515245U) + 12345U;
+    return (testSeed >> 8) % range;
+}
+
+/* Due time of the next callback. The list engine reloads a periodic timer
+   when it handles the expiry, so its period runs from the last callback.
+   The wheel engine runs it from the previous due time. */
+static SIM_TIME TEST_DueGet( const TEST_TIMER* timer )
+{
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+    return timer->start + ((SIM_TIME)(timer->count + 1U) * timer->period);
+#else
+    return ((timer->count == 0U) ? timer->start : timer->last) + timer->period;
+#endif
+}
+
+static void TEST_Callback( uintptr_t context )
+{
+    TEST_TIMER* timer = (TEST_TIMER*)context;
+    SIM_TIME now = SIM_CLOCK_Now();
+    SIM_TIME due = TEST_DueGet(timer);
+
+    if ((now + TEST_EARLINESS_MAX) < due)
+    {
+        timer->early++;
+    }
+    else if (now > due)
+    {
+        if ((now - due) > timer->lateMax)
+        {
+            timer->lateMax = now - due;
+        }
+        if ((now - due) > TEST_LATENESS_MAX)
+        {
+            timer->late++;
+        }
+    }
+
+    timer->count++;
+    timer->last = now;
+}
+
+static bool TEST_TimerStart( TEST_TIMER* timer, SIM_TIME period, SYS_TIME_CALLBACK_TYPE type )
+{
+    memset(timer, 0, sizeof(*timer));
+    timer->type = type;
+    timer->period = period;
+    timer->start = SIM_CLOCK_Now();
+    timer->handle = SYS_TIME_CallbackRegisterUS(TEST_Callback, (uintptr_t)timer,
+                                                (uint32_t)(period / 1000U), type);
+    return timer->handle != SYS_TIME_HANDLE_INVALID;
+}
+
+static void TEST_TimerStop( TEST_TIMER* timer )
+{
+    if (timer->handle != SYS_TIME_HANDLE_INVALID)
+    {
+        (void)SYS_TIME_TimerDestroy(timer->handle);
+        timer->handle = SYS_TIME_HANDLE_INVALID;
+    }
+}
+
+/* Checks the callbacks of the timer up to now, and prints the failures
+   with its name */
+static void TEST_TimerCheck( const TEST_TIMER* timer, const char* name )
+{
+    SIM_TIME now = SIM_CLOCK_Now();
+    SIM_TIME elapsed = now - timer->start;
+    uint32_t countMin;
+    uint32_t countMax;
+
+    if (timer->type == SYS_TIME_PERIODIC)
+    {
+        /* A period that ended less than the lateness ago may still come */
+        countMax = (uint32_t)(elapsed / timer->period);
+        countMin = (elapsed > TEST_LATENESS_MAX) ? (uint32_t)((elapsed - TEST_LATENESS_MAX) / timer->period) : 0U;
+#if !defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+        /* Each period of the list engine can be late by the lateness */
+        countMin = (uint32_t)(elapsed / (timer->period + TEST_LATENESS_MAX));
+#endif
+    }
+    else
+    {
+        countMax = (elapsed >= timer->period) ? 1U : 0U;
+        countMin = (elapsed > (timer->period + TEST_LATENESS_MAX)) ? 1U : 0U;
+    }
+
+    if ((timer->early != 0U) || (timer->late != 0U) || (timer->count < countMin) || (timer->count > countMax))
+    {
+        printf("%s: period=%lluus count=%lu expected=%lu..%lu early=%lu late=%lu late_max=%lluus\n",
+               name, (unsigned long long)(timer->period / 1000U), (unsigned long)timer->count,
+               (unsigned long)countMin, (unsigned long)countMax, (unsigned long)timer->early,
+               (unsigned long)timer->late, (unsigned long long)(timer->lateMax / 1000U));
+        testFailures++;
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Tests
+// *****************************************************************************
+// *****************************************************************************
+
+static void TEST_Rates( void )
+{
+    TEST_CHECK(TEST_TimerStart(&testTimers[0], SIM_TIME_MS(1), SYS_TIME_PERIODIC));
+    TEST_CHECK(TEST_TimerStart(&testTimers[1], SIM_TIME_MS(7), SYS_TIME_PERIODIC));
+
+    SIM_CLOCK_Advance(SIM_TIME_MS(1000) + SIM_TIME_US(500));
+
+    TEST_CHECK(testTimers[0].count == 1000U);
+    TEST_CHECK(testTimers[1].count == 142U);
+    TEST_TimerCheck(&testTimers[0], "rates 1 ms");
+    TEST_TimerCheck(&testTimers[1], "rates 7 ms");
+
+    TEST_TimerStop(&testTimers[0]);
+    TEST_TimerStop(&testTimers[1]);
+}
+
+static void TEST_Levels( void )
+{
+    /* A tick, a level 0 slot, the first level 1 and level 2 slots, and the
+       top level */
+    static const uint32_t delaysUs[TEST_TIMERS_NUMBER - 1U] = { 50U, 3000U, 7000U, 150000U, 70000000U };
+    uint32_t index;
+
+    /* Away from a slot boundary of any level */
+    SIM_CLOCK_Advance(SIM_TIME_US(1234));
+
+    TEST_CHECK(TEST_TimerStart(&testTimers[0], SIM_TIME_MS(1), SYS_TIME_PERIODIC));
+    for (index = 1U; index < TEST_TIMERS_NUMBER; index++)
+    {
+        TEST_CHECK(TEST_TimerStart(&testTimers[index], SIM_TIME_US(delaysUs[index - 1U]), SYS_TIME_SINGLE));
+    }
+
+    SIM_CLOCK_Advance(SIM_TIME_MS(70100));
+
+    TEST_TimerCheck(&testTimers[0], "levels 1 ms");
+    for (index = 1U; index < TEST_TIMERS_NUMBER; index++)
+    {
+        TEST_CHECK(testTimers[index].count == 1U);
+        TEST_TimerCheck(&testTimers[index], "levels single");
+    }
+
+    TEST_TimerStop(&testTimers[0]);
+}
+
+static void TEST_Random( void )
+{
+    char name[32];
+    uint32_t step;
+    uint32_t index;
+
+    for (index = 0U; index < TEST_TIMERS_NUMBER; index++)
+    {
+        testTimers[index].handle = SYS_TIME_HANDLE_INVALID;
+    }
+
+    for (step = 0U; step < 4000U; step++)
+    {
+        SIM_CLOCK_Advance(SIM_TIME_US(TEST_RandomGet(20000U)));
+
+        index = TEST_RandomGet(TEST_TIMERS_NUMBER);
+        if (testTimers[index].handle != SYS_TIME_HANDLE_INVALID)
+        {
+            (void)snprintf(name, sizeof(name), "random %lu", (unsigned long)step);
+            TEST_TimerCheck(&testTimers[index], name);
+            TEST_TimerStop(&testTimers[index]);
+        }
+        if (TEST_RandomGet(4U) != 0U)
+        {
+            /* From 1 ms to about 2 s, most of them short */
+            SIM_TIME period = SIM_TIME_US(1000U + TEST_RandomGet(1U << (10U + TEST_RandomGet(11U))));
+
+            TEST_CHECK(TEST_TimerStart(&testTimers[index], period,
+                                       (TEST_RandomGet(2U) == 0U) ? SYS_TIME_PERIODIC : SYS_TIME_SINGLE));
+        }
+    }
+
+    for (index = 0U; index < TEST_TIMERS_NUMBER; index++)
+    {
+        if (testTimers[index].handle != SYS_TIME_HANDLE_INVALID)
+        {
+            TEST_TimerCheck(&testTimers[index], "random end");
+            TEST_TimerStop(&testTimers[index]);
+        }
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    (void)argc;
+    (void)argv;
+
+    /* Only the timer runs: the SDMMC driver and its timers are not polled */
+    SIM_CLOCK_Initialize();
+    SIM_SYSTEM_Initialize();
+
+    TEST_Rates();
+    TEST_Levels();
+    TEST_Random();
+
+    printf("test_time: %s engine %s (%d failures, %llu ms of virtual time)\n",
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+           "wheel",
+#else
+           "list",
+#endif
+           (testFailures == 0) ? "pass" : "FAIL", testFailures,
+           (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return (testFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,499 @@
+/*******************************************************************************
+  DRV_UF2 Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_uf2.c
+
+  Summary
+    Runs drv_uf2.c and plib_nvmctrl.c against the simulated NVMCTRL.
+
+  Description
+    The test writes UF2 images to the update volume as a host copies a file
+    to it, a few blocks per write, and checks the upper flash bank and the
+    bank swap:
+    - An image whose blocks come out of order within a few pages, some of
+      them twice, between directory and FAT writes, is programmed as it is
+      and swapped in once the swap delay has passed without writes.
+    - An image with missing blocks programs its complete pages and is not
+      swapped in until the missing blocks arrive.
+    - An image shuffled over more pages than the driver holds, and an image
+      without a valid vector table, are never swapped in.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "sim_nvmctrl.h"
+#include "sim_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* UF2 format */
+#define TEST_UF2_MAGIC_START0       (0x0A324655U)
+#define TEST_UF2_MAGIC_START1       (0x9E5D5157U)
+#define TEST_UF2_MAGIC_END          (0x0AB16F30U)
+#define TEST_UF2_FLAG_FAMILY_ID     (0x00002000U)
+#define TEST_UF2_PAYLOAD_SIZE       (256U)
+
+#define TEST_IMAGE_BLOCKS_MAX       (96U)
+
+/* Blocks of the volume per write, and where the file is written */
+#define TEST_WRITE_BLOCKS_MAX       (4U)
+#define TEST_FILE_BLOCK             (0x100U)
+
+/* Processor time of one pass of the main loop */
+#define TEST_LOOP_STEP              SIM_TIME_US(10)
+
+#define TEST_TIMEOUT                SIM_TIME_MS(3000)
+
+#define TEST_CHECK(condition)                                               \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (false)
+
+typedef struct
+{
+    uint32_t magicStart0;
+    uint32_t magicStart1;
+    uint32_t flags;
+    uint32_t targetAddr;
+    uint32_t payloadSize;
+    uint32_t blockNo;
+    uint32_t numBlocks;
+    uint32_t familyId;
+    uint8_t data[476];
+    uint32_t magicEnd;
+
+} TEST_UF2_BLOCK;
+
+typedef struct
+{
+    DRV_HANDLE handle;
+
+    volatile bool isDone;
+
+    volatile SYS_MEDIA_BLOCK_EVENT event;
+
+} TEST_CLIENT;
+
+static TEST_CLIENT testClient;
+
+static SYS_MODULE_OBJ testUf2Obj;
+
+static int testFailures;
+
+static uint32_t testRandom;
+
+static const DRV_UF2_INIT testUf2Init =
+{
+    .bankAddress = DRV_UF2_BANK_ADDRESS,
+    .imageSize = DRV_UF2_IMAGE_SIZE,
+};
+
+/* Image payload and the order its blocks are sent in, with repeats */
+static uint8_t testImage[TEST_IMAGE_BLOCKS_MAX * TEST_UF2_PAYLOAD_SIZE];
+
+static uint32_t testOrder[2U * TEST_IMAGE_BLOCKS_MAX];
+
+static uint8_t testWriteBuffer[TEST_WRITE_BLOCKS_MAX * DRV_UF2_BLOCK_SIZE] __attribute__((aligned(4)));
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t TEST_RandomGet( uint32_t range )
+{
+    testRandom = (testRandom * 1103515245U) + 12345U;
+    return (testRandom >> 8) % range;
+}
+
+static void TEST_Uf2Tasks( void )
+{
+    DRV_UF2_Tasks(testUf2Obj);
+}
+
+static void TEST_EventHandler( SYS_MEDIA_BLOCK_EVENT event, SYS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle, uintptr_t context )
+{
+    TEST_CLIENT* client = (TEST_CLIENT*)context;
+
+    /* A write that is taken at once calls back before the handle is
+       returned */
+    client->event = event;
+    client->isDone = true;
+}
+
+static bool TEST_IsDone( uintptr_t context )
+{
+    return ((TEST_CLIENT*)context)->isDone;
+}
+
+static bool TEST_IsIdle( uintptr_t context )
+{
+    (void)context;
+    return !DRV_UF2_IsBusy(testUf2Obj);
+}
+
+static bool TEST_Never( uintptr_t context )
+{
+    (void)context;
+    return false;
+}
+
+static void TEST_Run( SIM_TIME duration )
+{
+    (void)SIM_SYSTEM_RunUntil(TEST_Never, 0U, TEST_LOOP_STEP, duration);
+}
+
+static uint32_t TEST_BankSwapsGet( void )
+{
+    SIM_NVMCTRL_STATISTICS statistics;
+
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    return statistics.bankSwaps;
+}
+
+/* Fills the payload of an image of numBlocks UF2 blocks, starting with a
+   vector table that is valid or not */
+static void TEST_ImageBuild( uint32_t numBlocks, uint8_t seed, bool isValid )
+{
+    uint32_t vectors[2];
+    uint32_t index;
+
+    for (index = 0U; index < (numBlocks * TEST_UF2_PAYLOAD_SIZE); index++)
+    {
+        testImage[index] = (uint8_t)((index * 7U) + (index >> 8) + seed);
+    }
+
+    /* Stack at the end of the RAM, reset handler in the image */
+    vectors[0] = isValid ? (HSRAM_ADDR + HSRAM_SIZE) : 0U;
+    vectors[1] = 0x00000401U;
+    memcpy(testImage, vectors, sizeof(vectors));
+}
+
+/* Sends the blocks in order */
+static void TEST_OrderSequential( uint32_t numBlocks )
+{
+    uint32_t index;
+
+    for (index = 0U; index < numBlocks; index++)
+    {
+        testOrder[index] = index;
+    }
+}
+
+/* Shuffles the blocks within windows of window blocks */
+static void TEST_OrderShuffle( uint32_t numBlocks, uint32_t window )
+{
+    uint32_t start;
+    uint32_t index;
+    uint32_t other;
+    uint32_t block;
+    uint32_t size;
+
+    TEST_OrderSequential(numBlocks);
+    for (start = 0U; start < numBlocks; start += window)
+    {
+        size = ((numBlocks - start) < window) ? (numBlocks - start) : window;
+        for (index = size - 1U; index > 0U; index--)
+        {
+            other = TEST_RandomGet(index + 1U);
+            block = testOrder[start + index];
+            testOrder[start + index] = testOrder[start + other];
+            testOrder[start + other] = block;
+        }
+    }
+}
+
+/* Sends the count UF2 blocks of the order, a few per write. Every
+   repeatEvery blocks an earlier block is sent again, and every fatEvery
+   writes a block of zeros, as the directory and FAT updates of the host.
+   Returns false if a write does not complete. */
+static bool TEST_ImageSend( uint32_t numBlocks, uint32_t count, uint32_t repeatEvery, uint32_t fatEvery )
+{
+    TEST_UF2_BLOCK uf2;
+    uint32_t position = 0U;
+    uint32_t writes = 0U;
+    uint32_t sent = 0U;
+    uint32_t nBlocks;
+    uint32_t block;
+
+    while (position < count)
+    {
+        nBlocks = 0U;
+        if ((fatEvery != 0U) && ((writes % fatEvery) == (fatEvery - 1U)))
+        {
+            memset(testWriteBuffer, 0, DRV_UF2_BLOCK_SIZE);
+            nBlocks = 1U;
+        }
+
+        while ((nBlocks < (1U + TEST_RandomGet(TEST_WRITE_BLOCKS_MAX))) && (position < count))
+        {
+            if ((repeatEvery != 0U) && (sent >= 8U) && ((sent % repeatEvery) == 0U))
+            {
+                block = testOrder[position - 1U - TEST_RandomGet(8U)];
+            }
+            else
+            {
+                block = testOrder[position];
+                position++;
+            }
+            sent++;
+
+            memset(&uf2, 0, sizeof(uf2));
+            uf2.magicStart0 = TEST_UF2_MAGIC_START0;
+            uf2.magicStart1 = TEST_UF2_MAGIC_START1;
+            uf2.flags = TEST_UF2_FLAG_FAMILY_ID;
+            uf2.targetAddr = block * TEST_UF2_PAYLOAD_SIZE;
+            uf2.payloadSize = TEST_UF2_PAYLOAD_SIZE;
+            uf2.blockNo = block;
+            uf2.numBlocks = numBlocks;
+            uf2.familyId = DRV_UF2_FAMILY_ID;
+            memcpy(uf2.data, &testImage[block * TEST_UF2_PAYLOAD_SIZE], TEST_UF2_PAYLOAD_SIZE);
+            uf2.magicEnd = TEST_UF2_MAGIC_END;
+            memcpy(&testWriteBuffer[nBlocks * DRV_UF2_BLOCK_SIZE], &uf2, sizeof(uf2));
+            nBlocks++;
+        }
+
+        testClient.isDone = false;
+        testClient.event = SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR;
+        DRV_UF2_AsyncWrite(testClient.handle, NULL, testWriteBuffer, TEST_FILE_BLOCK + position, nBlocks);
+        if (!SIM_SYSTEM_RunUntil(TEST_IsDone, (uintptr_t)&testClient, TEST_LOOP_STEP, TEST_TIMEOUT) ||
+            (testClient.event != SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE))
+        {
+            printf("write at UF2 block %lu did not complete\n", (unsigned long)position);
+            return false;
+        }
+        writes++;
+    }
+
+    return true;
+}
+
+/* Compares size bytes of the bank with the image */
+static bool TEST_FlashMatches( uint32_t size )
+{
+    return (memcmp((const void*)(uintptr_t)DRV_UF2_BANK_ADDRESS, testImage, size) == 0);
+}
+
+static bool TEST_FlashIsErased( uint32_t offset, uint32_t size )
+{
+    const uint8_t* flash = (const uint8_t*)(uintptr_t)(DRV_UF2_BANK_ADDRESS + offset);
+    uint32_t index;
+
+    for (index = 0U; index < size; index++)
+    {
+        if (flash[index] != 0xFFU)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Checks that the banks are swapped after the swap delay, not before */
+static void TEST_SwapCheck( void )
+{
+    SIM_NVMCTRL_STATISTICS statistics;
+
+    TEST_CHECK(DRV_UF2_UpdateStateGet(testUf2Obj) == DRV_UF2_UPDATE_SWAP);
+    TEST_Run(SIM_TIME_MS(DRV_UF2_SWAP_DELAY_MS / 2U));
+    TEST_CHECK(TEST_BankSwapsGet() == 0U);
+    TEST_Run(SIM_TIME_MS(DRV_UF2_SWAP_DELAY_MS));
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.bankSwaps != 0U);
+    TEST_CHECK(statistics.errors == 0U);
+    TEST_CHECK(statistics.busyCommands == 0U);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Tests
+// *****************************************************************************
+// *****************************************************************************
+
+static void TEST_ShuffledImage( void )
+{
+    uint32_t numBlocks = 64U;
+    SIM_NVMCTRL_STATISTICS statistics;
+
+    TEST_ImageBuild(numBlocks, 0x10U, true);
+    TEST_OrderShuffle(numBlocks, 8U);
+    SIM_NVMCTRL_StatisticsReset();
+
+    TEST_CHECK(TEST_ImageSend(numBlocks, numBlocks, 7U, 5U));
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsIdle, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+    TEST_CHECK(TEST_FlashMatches(numBlocks * TEST_UF2_PAYLOAD_SIZE));
+
+    /* Each flash block erased once, each page written once */
+    SIM_NVMCTRL_StatisticsGet(&statistics);
+    TEST_CHECK(statistics.blockErases == ((numBlocks * TEST_UF2_PAYLOAD_SIZE) / NVMCTRL_FLASH_BLOCKSIZE));
+    TEST_CHECK(statistics.pageWrites == ((numBlocks * TEST_UF2_PAYLOAD_SIZE) / NVMCTRL_FLASH_PAGESIZE));
+
+    TEST_SwapCheck();
+}
+
+static void TEST_PartialImage( void )
+{
+    static const uint32_t missing[] = { 5U, 20U, 47U };
+    uint32_t numBlocks = 48U;
+    uint32_t position = 0U;
+    uint32_t index;
+
+    /* The missing blocks are sent last */
+    TEST_ImageBuild(numBlocks, 0x20U, true);
+    for (index = 0U; index < numBlocks; index++)
+    {
+        if ((index != missing[0]) && (index != missing[1]) && (index != missing[2]))
+        {
+            testOrder[position] = index;
+            position++;
+        }
+    }
+    memcpy(&testOrder[position], missing, sizeof(missing));
+
+    TEST_CHECK(TEST_ImageSend(numBlocks, numBlocks - 3U, 0U, 0U));
+    SIM_NVMCTRL_StatisticsReset();
+    TEST_Run(SIM_TIME_MS(2U * DRV_UF2_SWAP_DELAY_MS));
+    TEST_CHECK(DRV_UF2_UpdateStateGet(testUf2Obj) == DRV_UF2_UPDATE_RECEIVING);
+    TEST_CHECK(TEST_BankSwapsGet() == 0U);
+
+    /* The pages before the first missing block are programmed */
+    TEST_CHECK(TEST_FlashMatches(4U * TEST_UF2_PAYLOAD_SIZE));
+
+    memmove(testOrder, &testOrder[numBlocks - 3U], 3U * sizeof(testOrder[0]));
+    TEST_CHECK(TEST_ImageSend(numBlocks, 3U, 0U, 0U));
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsIdle, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+    TEST_CHECK(TEST_FlashMatches(numBlocks * TEST_UF2_PAYLOAD_SIZE));
+
+    /* The rest of the last flash block was erased with it */
+    TEST_CHECK(TEST_FlashIsErased(numBlocks * TEST_UF2_PAYLOAD_SIZE, 2U * NVMCTRL_FLASH_BLOCKSIZE - (numBlocks * TEST_UF2_PAYLOAD_SIZE)));
+
+    TEST_SwapCheck();
+}
+
+static void TEST_FailedImages( void )
+{
+    DRV_UF2_UPDATE_STATE state;
+
+    /* More pages open at once than the driver holds */
+    TEST_ImageBuild(96U, 0x30U, true);
+    TEST_OrderShuffle(96U, 96U);
+    TEST_CHECK(TEST_ImageSend(96U, 96U, 0U, 0U));
+    SIM_NVMCTRL_StatisticsReset();
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsIdle, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+    TEST_Run(SIM_TIME_MS(2U * DRV_UF2_SWAP_DELAY_MS));
+    state = DRV_UF2_UpdateStateGet(testUf2Obj);
+    TEST_CHECK(state != DRV_UF2_UPDATE_SWAP);
+    TEST_CHECK(TEST_BankSwapsGet() == 0U);
+
+    /* No vector table */
+    TEST_ImageBuild(16U, 0x40U, false);
+    TEST_OrderSequential(16U);
+    TEST_CHECK(TEST_ImageSend(16U, 16U, 0U, 0U));
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsIdle, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+    TEST_Run(SIM_TIME_MS(2U * DRV_UF2_SWAP_DELAY_MS));
+    TEST_CHECK(TEST_FlashMatches(16U * TEST_UF2_PAYLOAD_SIZE));
+    TEST_CHECK(DRV_UF2_UpdateStateGet(testUf2Obj) == DRV_UF2_UPDATE_FAILED);
+    TEST_CHECK(TEST_BankSwapsGet() == 0U);
+
+    /* A good image again */
+    TEST_ImageBuild(64U, 0x50U, true);
+    TEST_OrderSequential(64U);
+    TEST_CHECK(TEST_ImageSend(64U, 64U, 0U, 0U));
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsIdle, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+    TEST_CHECK(TEST_FlashMatches(64U * TEST_UF2_PAYLOAD_SIZE));
+    TEST_SwapCheck();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    (void)argc;
+    (void)argv;
+
+    testRandom = 1U;
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_NVMCTRL_Initialize())
+    {
+        printf("cannot map the NVMCTRL and the flash\n");
+        return 1;
+    }
+    SIM_SYSTEM_Initialize();
+    NVMCTRL_Initialize();
+    SYS_KVS_Initialize();
+
+    testUf2Obj = DRV_UF2_Initialize(DRV_UF2_INDEX_0, (const SYS_MODULE_INIT*)&testUf2Init);
+    TEST_CHECK(testUf2Obj != SYS_MODULE_OBJ_INVALID);
+    TEST_CHECK(SIM_SYSTEM_TasksAdd(TEST_Uf2Tasks));
+    TEST_CHECK(SIM_SYSTEM_TasksAdd(SYS_KVS_Tasks));
+
+    testClient.handle = DRV_UF2_Open(DRV_UF2_INDEX_0, DRV_IO_INTENT_READWRITE);
+    TEST_CHECK(testClient.handle != DRV_HANDLE_INVALID);
+    DRV_UF2_EventHandlerSet(testClient.handle, (const void*)TEST_EventHandler, (uintptr_t)&testClient);
+    TEST_CHECK(DRV_UF2_UpdateStateGet(testUf2Obj) == DRV_UF2_UPDATE_IDLE);
+
+    if (testFailures == 0)
+    {
+        TEST_ShuffledImage();
+        TEST_PartialImage();
+        TEST_FailedImages();
+    }
+
+    DRV_UF2_Close(testClient.handle);
+
+    printf("test_uf2: %s (%d failures, %llu ms of virtual time)\n",
+           (testFailures == 0) ? "pass" : "FAIL", testFailures,
+           (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return (testFailures == 0) ? 0 : 1;
+}
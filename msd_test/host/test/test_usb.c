@@ -0,0 +1,468 @@
+/*******************************************************************************
+  USB Device Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_usb.c
+
+  Summary
+    Runs the USB device stack against the simulated USB peripheral and a
+    scripted host.
+
+  Description
+    The test enumerates the device and checks its descriptors, then runs
+    MSD commands on the SD card and RAM disk LUNs and on the empty internal
+    flash LUN, and echoes data through the CDC function. It then checks the
+    bus statistics of a long read against the limits of a full speed bus.
+
+    The optional arguments are the path of the SD card image file, by
+    default test_usb.img in the current directory, and --trace, which
+    writes one line per host transfer to stdout.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "sim_core.h"
+#include "sim_sdhc.h"
+#include "sim_system.h"
+#include "sim_usb.h"
+#include "sim_usb_host.h"
+#include "sim_usb_system.h"
+#include "usb/usb_device_msd.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_CAPACITY           (64U * 1024U * 1024U)
+#define TEST_NUM_BLOCKS         (TEST_CAPACITY / 512U)
+
+/* LUNs of usb_device_init_data.c */
+#define TEST_LUN_SDMMC          (0U)
+#define TEST_LUN_FLASH          (1U)
+#define TEST_LUN_RAMDISK        (2U)
+
+#define TEST_RAMDISK_BLOCKS     (0x10000U / 512U)
+
+/* Processor time of one pass of the main loop */
+#define TEST_LOOP_STEP          SIM_TIME_US(2)
+
+#define TEST_TIMEOUT            SIM_TIME_MS(3000)
+
+/* Transfers of 64 KB and more overflow 16-bit lengths */
+#define TEST_MAX_BLOCKS         (128U)
+
+/* Data packets of 64 bytes that fit in a frame after the SOF */
+#define TEST_FRAME_PACKETS_MAX  (19U)
+
+/* LED_R, PB08 */
+#define TEST_LED_GROUP          (1U)
+#define TEST_LED_PIN            (8U)
+
+#define TEST_CHECK(condition)                                               \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (false)
+
+static int testFailures;
+
+static uint8_t testWriteBuffer[TEST_MAX_BLOCKS * 512U];
+
+static uint8_t testReadBuffer[TEST_MAX_BLOCKS * 512U];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool TEST_IsConfigured( uintptr_t context )
+{
+    (void)context;
+    return SIM_USB_SYSTEM_IsConfigured();
+}
+
+static void TEST_PatternFill( uint8_t* buffer, uint32_t length, uint32_t start, uint8_t seed )
+{
+    uint32_t index;
+
+    for (index = 0U; index < length; index++)
+    {
+        buffer[index] = (uint8_t)(((start + index) * 7U) + seed);
+    }
+}
+
+/* Waits for the LUN to report ready, as a PC polls a removable drive */
+static bool TEST_UnitReadyWait( uint8_t lun )
+{
+    uint32_t attempt;
+
+    for (attempt = 0U; attempt < 100U; attempt++)
+    {
+        if (SIM_USB_HOST_MsdTestUnitReady(lun) == SIM_USB_HOST_MSD_PASSED)
+        {
+            return true;
+        }
+        SIM_USB_HOST_Wait(SIM_TIME_MS(10));
+    }
+    return false;
+}
+
+static void TEST_WriteReadCheck( uint8_t lun, uint32_t block, uint16_t nBlocks, uint8_t seed )
+{
+    TEST_PatternFill(testWriteBuffer, nBlocks * 512U, block * 512U, seed);
+    memset(testReadBuffer, 0, nBlocks * 512U);
+
+    TEST_CHECK(SIM_USB_HOST_MsdWrite10(lun, block, nBlocks, testWriteBuffer, 512U) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK(SIM_USB_HOST_MsdRead10(lun, block, nBlocks, testReadBuffer, 512U) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK(memcmp(testWriteBuffer, testReadBuffer, nBlocks * 512U) == 0);
+}
+
+static void TEST_Enumeration( void )
+{
+    const SIM_USB_HOST_DEVICE* device = SIM_USB_HOST_DeviceGet();
+
+    TEST_CHECK(!SIM_CORE_PinGet(TEST_LED_GROUP, TEST_LED_PIN));
+    TEST_CHECK(SIM_USB_HOST_Enumerate());
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsConfigured, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+
+    /* Microchip VID and PID, EP0 of 64 bytes */
+    TEST_CHECK(device->maxPacketSize0 == 64U);
+    TEST_CHECK((device->deviceDescriptor[8] == 0xD8U) && (device->deviceDescriptor[9] == 0x04U));
+    TEST_CHECK((device->deviceDescriptor[10] == 0x09U) && (device->deviceDescriptor[11] == 0x00U));
+    TEST_CHECK(device->configurationLength == 98U);
+
+    TEST_CHECK((device->msdIn == 0x81U) && (device->msdOut == 0x01U) && (device->msdMaxPacketSize == 64U));
+    TEST_CHECK(device->cdcNotification == 0x82U);
+    TEST_CHECK((device->cdcIn == 0x83U) && (device->cdcOut == 0x03U) && (device->cdcMaxPacketSize == 64U));
+
+    /* app.c turns the LED on once configured */
+    TEST_CHECK(SIM_CORE_PinGet(TEST_LED_GROUP, TEST_LED_PIN));
+}
+
+static void TEST_Msd( void )
+{
+    uint8_t inquiry[36];
+    uint8_t maxLun = 0U;
+    uint8_t senseKey = 0U;
+    uint16_t ascq = 0U;
+    uint32_t lastBlock = 0U;
+    uint32_t blockSize = 0U;
+
+    TEST_CHECK(SIM_USB_HOST_MsdMaxLunGet(&maxLun) && (maxLun == 3U));
+
+    TEST_CHECK(SIM_USB_HOST_MsdInquiry(TEST_LUN_SDMMC, inquiry) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK((inquiry[1] & 0x80U) != 0U);
+    TEST_CHECK(memcmp(&inquiry[8], "Microchp", 8U) == 0);
+    TEST_CHECK(memcmp(&inquiry[16], "Mass Storage", 12U) == 0);
+
+    /* SD card */
+    TEST_CHECK(TEST_UnitReadyWait(TEST_LUN_SDMMC));
+    TEST_CHECK(SIM_USB_HOST_MsdReadCapacity(TEST_LUN_SDMMC, &lastBlock, &blockSize) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK((lastBlock == (TEST_NUM_BLOCKS - 1U)) && (blockSize == 512U));
+    TEST_WriteReadCheck(TEST_LUN_SDMMC, 0U, 1U, 0x11U);
+    TEST_WriteReadCheck(TEST_LUN_SDMMC, 1000U, TEST_MAX_BLOCKS, 0x22U);
+    TEST_WriteReadCheck(TEST_LUN_SDMMC, TEST_NUM_BLOCKS - 8U, 8U, 0x33U);
+
+    /* Past the end of the card. USB_DEVICE_MSD fails the command without
+       sense data; the next command must go through. */
+    TEST_CHECK(SIM_USB_HOST_MsdRead10(TEST_LUN_SDMMC, TEST_NUM_BLOCKS, 1U, testReadBuffer, 512U) ==
+               SIM_USB_HOST_MSD_FAILED);
+    TEST_CHECK(SIM_USB_HOST_MsdRequestSense(TEST_LUN_SDMMC, &senseKey, &ascq) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK(SIM_USB_HOST_MsdRead10(TEST_LUN_SDMMC, 0U, 1U, testReadBuffer, 512U) == SIM_USB_HOST_MSD_PASSED);
+
+    /* RAM disk */
+    TEST_CHECK(TEST_UnitReadyWait(TEST_LUN_RAMDISK));
+    TEST_CHECK(SIM_USB_HOST_MsdReadCapacity(TEST_LUN_RAMDISK, &lastBlock, &blockSize) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK((lastBlock == (TEST_RAMDISK_BLOCKS - 1U)) && (blockSize == 512U));
+    TEST_WriteReadCheck(TEST_LUN_RAMDISK, 0U, 16U, 0x44U);
+    TEST_WriteReadCheck(TEST_LUN_RAMDISK, TEST_RAMDISK_BLOCKS - 1U, 1U, 0x55U);
+
+    /* The internal flash is not simulated: no medium */
+    TEST_CHECK(SIM_USB_HOST_MsdTestUnitReady(TEST_LUN_FLASH) == SIM_USB_HOST_MSD_FAILED);
+    TEST_CHECK(SIM_USB_HOST_MsdRequestSense(TEST_LUN_FLASH, &senseKey, &ascq) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK((senseKey == 0x02U) && ((ascq >> 8) == 0x3AU));
+}
+
+/* Reads the command statistics with the vendor SCSI command. The bytes the
+   device does not send keep the value 0xFF. */
+static SIM_USB_HOST_MSD_STATUS TEST_CommandStatisticsRead( USB_DEVICE_MSD_COMMAND_STATISTICS* statistics,
+                                                           uint32_t length, bool reset, uint32_t* residue )
+{
+    uint8_t cdb[10] = { USB_DEVICE_MSD_SCSI_COMMAND_STATISTICS_READ };
+    SIM_USB_HOST_MSD_STATUS status;
+
+    cdb[1] = reset ? USB_DEVICE_MSD_SCSI_COMMAND_STATISTICS_RESET : 0U;
+    memset(testReadBuffer, 0xFF, sizeof(USB_DEVICE_MSD_COMMAND_STATISTICS));
+    *residue = 0xFFFFFFFFU;
+    status = SIM_USB_HOST_MsdCommand(TEST_LUN_SDMMC, cdb, sizeof(cdb), true, testReadBuffer, length, residue);
+    memcpy(statistics, testReadBuffer, sizeof(USB_DEVICE_MSD_COMMAND_STATISTICS));
+    return status;
+}
+
+static void TEST_CommandStatistics( void )
+{
+    USB_DEVICE_MSD_COMMAND_STATISTICS statistics;
+    USB_DEVICE_MSD_COMMAND_STATISTICS local;
+    const USB_DEVICE_MSD_OPCODE_STATISTICS* read10 = &statistics.opcodes[USB_DEVICE_MSD_OPCODE_READ_10];
+    uint32_t residue;
+    uint32_t commands = 0U;
+    uint32_t bucket;
+    uint32_t pass;
+
+    /* Restarts the statistics */
+    TEST_CHECK(TEST_CommandStatisticsRead(&statistics, sizeof(statistics), true, &residue) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK(residue == 0U);
+
+    for (pass = 0U; pass < 4U; pass++)
+    {
+        TEST_CHECK(SIM_USB_HOST_MsdRead10(TEST_LUN_SDMMC, 4096U + (pass * 8U), 8U, testReadBuffer, 512U) ==
+                   SIM_USB_HOST_MSD_PASSED);
+    }
+    for (pass = 0U; pass < 3U; pass++)
+    {
+        TEST_CHECK(SIM_USB_HOST_MsdTestUnitReady(TEST_LUN_SDMMC) == SIM_USB_HOST_MSD_PASSED);
+    }
+
+    /* More than the structure: the residue is the rest */
+    TEST_CHECK(TEST_CommandStatisticsRead(&statistics, sizeof(statistics) + 512U, true, &residue) ==
+               SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK(residue == 512U);
+
+    TEST_CHECK((read10->commands == 4U) && (read10->failed == 0U));
+    TEST_CHECK((read10->mediaUS > 0U) && (read10->dataUS > 0U) && (read10->statusUS > 0U));
+    TEST_CHECK(read10->maxUS > 0U);
+    for (bucket = 0U; bucket < USB_DEVICE_MSD_LATENCY_BUCKETS; bucket++)
+    {
+        commands += read10->histogram[bucket];
+    }
+    TEST_CHECK(commands == read10->commands);
+    TEST_CHECK(statistics.opcodes[USB_DEVICE_MSD_OPCODE_TEST_UNIT_READY].commands == 3U);
+    TEST_CHECK(statistics.opcodes[USB_DEVICE_MSD_OPCODE_WRITE_10].commands == 0U);
+    /* The first read, whose CSW came after its restart */
+    TEST_CHECK(statistics.opcodes[USB_DEVICE_MSD_OPCODE_OTHER].commands == 1U);
+    TEST_CHECK(statistics.hostIdleUS > 0U);
+
+    printf("usb msd read10: %lu commands, setup %llu us, media %llu us, data %llu us, status %llu us, host idle %llu us\n",
+           (unsigned long)read10->commands, (unsigned long long)read10->setupUS,
+           (unsigned long long)read10->mediaUS, (unsigned long long)read10->dataUS,
+           (unsigned long long)read10->statusUS, (unsigned long long)statistics.hostIdleUS);
+
+    /* The second read restarted them in turn. Its CSW completes on the
+       device after the host has it. */
+    SIM_USB_HOST_Wait(SIM_TIME_MS(1));
+    TEST_CHECK(USB_DEVICE_MSD_CommandStatisticsGet(0U, &local, false));
+    TEST_CHECK(local.opcodes[USB_DEVICE_MSD_OPCODE_READ_10].commands == 0U);
+    TEST_CHECK(local.opcodes[USB_DEVICE_MSD_OPCODE_OTHER].commands == 1U);
+
+    /* A shorter transfer gets the start of the structure */
+    TEST_CHECK(TEST_CommandStatisticsRead(&statistics, 16U, false, &residue) == SIM_USB_HOST_MSD_PASSED);
+    TEST_CHECK(residue == 0U);
+    TEST_CHECK(read10->commands == 0U);
+    TEST_CHECK(read10->setupUS == UINT64_MAX);
+}
+
+static void TEST_Cdc( void )
+{
+    const uint8_t lineCoding[7] = { 0x80U, 0x25U, 0x00U, 0x00U, 0U, 0U, 8U };
+    uint8_t readCoding[7] = { 0 };
+    uint32_t length;
+
+    TEST_CHECK(SIM_USB_HOST_CdcLineCodingSet(lineCoding));
+    TEST_CHECK(SIM_USB_HOST_CdcLineCodingGet(readCoding));
+    TEST_CHECK(memcmp(lineCoding, readCoding, sizeof(lineCoding)) == 0);
+    TEST_CHECK(SIM_USB_HOST_CdcControlLineStateSet(0x0003U));
+
+    /* A short write, and one that needs a zero length packet */
+    for (length = 100U; length >= 64U; length -= 36U)
+    {
+        TEST_PatternFill(testWriteBuffer, length, length, 0x66U);
+        memset(testReadBuffer, 0, length);
+        TEST_CHECK(SIM_USB_HOST_CdcWrite(testWriteBuffer, length));
+        TEST_CHECK(SIM_USB_HOST_CdcRead(testReadBuffer, 512U) == length);
+        TEST_CHECK(memcmp(testWriteBuffer, testReadBuffer, length) == 0);
+    }
+}
+
+static void TEST_Trace( void )
+{
+    FILE* trace = tmpfile();
+    char line[256] = "";
+    uint32_t lines = 0U;
+
+    if (trace == NULL)
+    {
+        TEST_CHECK(trace != NULL);
+        return;
+    }
+
+    SIM_USB_TraceSet(trace);
+    TEST_CHECK(SIM_USB_HOST_MsdTestUnitReady(TEST_LUN_SDMMC) == SIM_USB_HOST_MSD_PASSED);
+    SIM_USB_TraceSet(NULL);
+
+    /* The CBW and the CSW */
+    rewind(trace);
+    while (fgets(line, sizeof(line), trace) != NULL)
+    {
+        TEST_CHECK(strncmp(line, "usb t=", 6U) == 0);
+        TEST_CHECK(strstr(line, " type=bulk ") != NULL);
+        TEST_CHECK(strstr(line, " status=ok ") != NULL);
+        lines++;
+    }
+    TEST_CHECK(lines == 2U);
+    (void)fclose(trace);
+}
+
+static void TEST_Statistics( void )
+{
+    SIM_USB_STATISTICS statistics;
+    SIM_TIME start;
+    SIM_TIME elapsed;
+    uint32_t frames = 0U;
+    uint32_t bucket;
+    uint32_t pass;
+
+    SIM_USB_HOST_Wait(SIM_TIME_MS(2));
+    SIM_USB_StatisticsReset();
+    start = SIM_CLOCK_Now();
+    for (pass = 0U; pass < 8U; pass++)
+    {
+        TEST_CHECK(SIM_USB_HOST_MsdRead10(TEST_LUN_SDMMC, 2048U + (pass * TEST_MAX_BLOCKS), TEST_MAX_BLOCKS,
+                                          testReadBuffer, 512U) == SIM_USB_HOST_MSD_PASSED);
+    }
+    elapsed = SIM_CLOCK_Now() - start;
+    SIM_USB_HOST_Wait(SIM_TIME_MS(2));
+    SIM_USB_StatisticsGet(&statistics);
+
+    for (bucket = 0U; bucket < SIM_USB_HISTOGRAM_BUCKETS; bucket++)
+    {
+        frames += statistics.busyHistogram[bucket];
+    }
+    TEST_CHECK(statistics.frames > 0U);
+    TEST_CHECK(frames == statistics.frames);
+    TEST_CHECK(statistics.inBytes >= (8U * TEST_MAX_BLOCKS * 512U));
+    TEST_CHECK(statistics.frameTransactionsMax <= TEST_FRAME_PACKETS_MAX);
+    TEST_CHECK(statistics.frameBytesMax <= (TEST_FRAME_PACKETS_MAX * 64U));
+    TEST_CHECK(statistics.busyBits > statistics.payloadBits);
+    TEST_CHECK(statistics.busyBits <= ((uint64_t)statistics.frames * SIM_USB_FRAME_BITS));
+    TEST_CHECK(statistics.payloadBits >= (statistics.inBytes * 8U));
+    /* The bulk IN endpoint waits for the card */
+    TEST_CHECK(statistics.naks > 0U);
+    TEST_CHECK((statistics.stalls == 0U) && (statistics.timeouts == 0U));
+
+    /* The bulk rate cannot beat 19 packets of 64 bytes per frame */
+    TEST_CHECK(((uint64_t)statistics.inBytes * 1000000000ULL / elapsed) <= (TEST_FRAME_PACKETS_MAX * 64U * 1000U));
+
+    printf("usb read: %llu KB/s, %lu frames, busy %llu %%, payload %llu %%, %llu naks, %lu packets/frame max\n",
+           (unsigned long long)((uint64_t)statistics.inBytes * 1000000ULL / elapsed),
+           (unsigned long)statistics.frames,
+           (unsigned long long)(statistics.busyBits * 100U / ((uint64_t)statistics.frames * SIM_USB_FRAME_BITS)),
+           (unsigned long long)(statistics.payloadBits * 100U / ((uint64_t)statistics.frames * SIM_USB_FRAME_BITS)),
+           (unsigned long long)statistics.naks,
+           (unsigned long)statistics.frameTransactionsMax);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    const char* imagePath = "test_usb.img";
+    SIM_SDHC_INIT sdhcInit =
+    {
+        .capacity = TEST_CAPACITY,
+        .profile = SIM_SDHC_ProfileGet("typical"),
+        .seed = 1U,
+        .isInserted = true,
+    };
+    int index;
+
+    for (index = 1; index < argc; index++)
+    {
+        if (strcmp(argv[index], "--trace") == 0)
+        {
+            SIM_USB_TraceSet(stdout);
+        }
+        else
+        {
+            imagePath = argv[index];
+        }
+    }
+    sdhcInit.imagePath = imagePath;
+    (void)unlink(imagePath);
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_SDHC_Initialize(&sdhcInit))
+    {
+        printf("cannot create %s\n", imagePath);
+        return 1;
+    }
+    if (!SIM_USB_SYSTEM_Initialize())
+    {
+        printf("cannot map the USB registers\n");
+        return 1;
+    }
+    SIM_USB_HOST_Initialize(TEST_LOOP_STEP, TEST_TIMEOUT);
+
+    TEST_Enumeration();
+    if (testFailures == 0)
+    {
+        TEST_Msd();
+        TEST_CommandStatistics();
+        TEST_Cdc();
+        TEST_Trace();
+        TEST_Statistics();
+    }
+
+    SIM_SDHC_Deinitialize();
+    (void)unlink(imagePath);
+
+    printf("test_usb: %s (%d failures, %llu ms of virtual time)\n",
+           (testFailures == 0) ? "pass" : "FAIL", testFailures,
+           (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return (testFailures == 0) ? 0 : 1;
+}
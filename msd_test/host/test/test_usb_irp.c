@@ -0,0 +1,429 @@
+/*******************************************************************************
+  USB Device Deferred IRP Completion Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_usb_irp.c
+
+  Summary
+    Runs the deferred IRP completion of drv_usbfsv1_device.c against the
+    simulated USB peripheral.
+
+  Description
+    The test is a client of DRV_USBFSV1 itself, without the device layer,
+    built with DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION set to true. It
+    lets the host send bulk OUT packets while only the ISR runs, then runs
+    DRV_USBFSV1_Tasks, and checks:
+    - that the IRPs that fit in the completion queue are reported from
+      DRV_USBFSV1_Tasks, in order, and the ones that overflow it from the
+      ISR, each exactly once and with its data;
+    - that IRPCancelAll, IRPCancel and a bus reset report the IRPs already
+      in the completion queue as aborted, as the IRPs still queued to the
+      endpoint.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "sim_core.h"
+#include "sim_usb.h"
+
+#if (DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION != true)
+    #error "test_usb_irp needs DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION set to true"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_PACKET_SIZE        (64U)
+
+/* More IRPs than the completion queue holds */
+#define TEST_IRP_NUMBER         (DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH + 4U)
+
+#define TEST_ENDPOINT           USB_ENDPOINT_AND_DIRECTION(USB_DATA_DIRECTION_HOST_TO_DEVICE, 1)
+
+/* Processor time between two looks at the host transfer */
+#define TEST_STEP               SIM_TIME_US(10)
+
+#define TEST_TIMEOUT            SIM_TIME_MS(100)
+
+#define TEST_CHECK(condition)                                               \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (false)
+
+typedef struct
+{
+    USB_DEVICE_IRP irp;
+
+    /* Calls of the callback, and where the last one came from */
+    uint32_t callbacks;
+    bool isFromTasks;
+
+    /* Callbacks of all the IRPs before this one, when it got its own */
+    uint32_t order;
+
+    uint8_t buffer[TEST_PACKET_SIZE] USB_ALIGN;
+
+} TEST_IRP;
+
+static int testFailures;
+
+static DRV_HANDLE testHandle;
+
+static uint32_t testResets;
+
+/* DRV_USBFSV1_Tasks is running */
+static bool testInTasks;
+
+static uint32_t testCallbacks;
+
+static TEST_IRP testIrp[TEST_IRP_NUMBER];
+
+static uint8_t testHostBuffer[TEST_IRP_NUMBER * TEST_PACKET_SIZE];
+
+static const DRV_USBFSV1_INIT testUsbInit =
+{
+    .interruptSource = USB_OTHER_IRQn,
+    .interruptSource1 = USB_SOF_HSOF_IRQn,
+    .interruptSource2 = USB_TRCPT0_IRQn,
+    .interruptSource3 = USB_TRCPT1_IRQn,
+    .moduleInit = {0},
+    .operationMode = DRV_USBFSV1_OPMODE_DEVICE,
+    .operationSpeed = USB_SPEED_FULL,
+    .runInStandby = true,
+    .suspendInSleep = false,
+    .usbID = USB_REGS,
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void TEST_EventHandler( uintptr_t context, DRV_USB_EVENT event, void* eventData )
+{
+    (void)context;
+    (void)eventData;
+
+    if (event == DRV_USB_EVENT_RESET_DETECT)
+    {
+        testResets++;
+    }
+}
+
+static void TEST_IrpCallback( USB_DEVICE_IRP* irp )
+{
+    TEST_IRP* test = &testIrp[irp->userData];
+
+    test->callbacks++;
+    test->isFromTasks = testInTasks;
+    test->order = testCallbacks;
+    testCallbacks++;
+}
+
+static void TEST_Tasks( void )
+{
+    testInTasks = true;
+    DRV_USBFSV1_Tasks(sysObj.drvUSBFSV1Object);
+    testInTasks = false;
+}
+
+/* Moves the time on without running the tasks, so only the ISR runs */
+static bool TEST_IsrRunUntil( bool (*isDone)( void* context ), void* context )
+{
+    SIM_TIME end = SIM_CLOCK_Now() + TEST_TIMEOUT;
+
+    while (!isDone(context))
+    {
+        if (SIM_CLOCK_Now() >= end)
+        {
+            return false;
+        }
+        SIM_CLOCK_Advance(TEST_STEP);
+    }
+    return true;
+}
+
+static bool TEST_IsTransferDone( void* context )
+{
+    return ((SIM_USB_TRANSFER*)context)->status != SIM_USB_TRANSFER_PENDING;
+}
+
+static bool TEST_IsResetDone( void* context )
+{
+    return !SIM_USB_IsResetting() && (testResets == *(uint32_t*)context);
+}
+
+static void TEST_IrpsSubmit( uint32_t count )
+{
+    uint32_t index;
+
+    testCallbacks = 0U;
+    for (index = 0U; index < count; index++)
+    {
+        memset(&testIrp[index], 0, sizeof(TEST_IRP));
+        testIrp[index].irp.data = testIrp[index].buffer;
+        testIrp[index].irp.size = TEST_PACKET_SIZE;
+        testIrp[index].irp.callback = TEST_IrpCallback;
+        testIrp[index].irp.userData = index;
+        TEST_CHECK(DRV_USBFSV1_DEVICE_IRPSubmit(testHandle, TEST_ENDPOINT, &testIrp[index].irp) == USB_ERROR_NONE);
+    }
+}
+
+/* The host sends one packet of distinct data per IRP, while only the ISR
+   runs */
+static void TEST_HostSend( uint32_t packets )
+{
+    SIM_USB_TRANSFER transfer;
+    uint32_t index;
+
+    for (index = 0U; index < (packets * TEST_PACKET_SIZE); index++)
+    {
+        testHostBuffer[index] = (uint8_t)((index * 7U) + (index / TEST_PACKET_SIZE));
+    }
+
+    memset(&transfer, 0, sizeof(transfer));
+    transfer.address = 0U;
+    transfer.endpoint = 1U;
+    transfer.type = SIM_USB_TRANSFER_BULK;
+    transfer.maxPacketSize = TEST_PACKET_SIZE;
+    transfer.buffer = testHostBuffer;
+    transfer.length = packets * TEST_PACKET_SIZE;
+    SIM_USB_TransferSubmit(&transfer);
+
+    TEST_CHECK(TEST_IsrRunUntil(TEST_IsTransferDone, &transfer));
+    TEST_CHECK(transfer.status == SIM_USB_TRANSFER_COMPLETED);
+    TEST_CHECK(transfer.actualLength == (packets * TEST_PACKET_SIZE));
+}
+
+static void TEST_BusReset( void )
+{
+    uint32_t resets = testResets + 1U;
+
+    SIM_USB_BusReset();
+    TEST_CHECK(TEST_IsrRunUntil(TEST_IsResetDone, &resets));
+
+    TEST_CHECK(DRV_USBFSV1_DEVICE_EndpointEnable(testHandle, TEST_ENDPOINT, USB_TRANSFER_TYPE_BULK, TEST_PACKET_SIZE) == USB_ERROR_NONE);
+}
+
+static bool TEST_Attach( void )
+{
+    uint32_t index;
+
+    sysObj.drvUSBFSV1Object = DRV_USBFSV1_Initialize(DRV_USBFSV1_INDEX_0, (SYS_MODULE_INIT *)&testUsbInit);
+
+    testHandle = DRV_USBFSV1_Open(DRV_USBFSV1_INDEX_0, DRV_IO_INTENT_READWRITE);
+    TEST_CHECK(testHandle != DRV_HANDLE_INVALID);
+    if (testHandle == DRV_HANDLE_INVALID)
+    {
+        return false;
+    }
+    DRV_USBFSV1_ClientEventCallBackSet(testHandle, 0U, TEST_EventHandler);
+
+    /* The first pass reports the session, then the device layer attaches */
+    for (index = 0U; index < 10U; index++)
+    {
+        TEST_Tasks();
+        SIM_CLOCK_Advance(TEST_STEP);
+    }
+    DRV_USBFSV1_DEVICE_Attach(testHandle);
+    SIM_CLOCK_Advance(TEST_STEP);
+    TEST_CHECK(SIM_USB_IsConnected());
+
+    TEST_BusReset();
+    return (testFailures == 0);
+}
+
+/* More completions than the queue holds: the first ones wait for the
+   tasks, the others are reported from the ISR */
+static void TEST_Overflow( void )
+{
+    uint32_t index;
+    uint32_t fromIsr = 0U;
+
+    TEST_IrpsSubmit(TEST_IRP_NUMBER);
+    TEST_HostSend(TEST_IRP_NUMBER);
+
+    for (index = 0U; index < TEST_IRP_NUMBER; index++)
+    {
+        if (index < DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH)
+        {
+            /* Completed, but not reported before the tasks run */
+            TEST_CHECK(testIrp[index].callbacks == 0U);
+            TEST_CHECK(testIrp[index].irp.status == USB_DEVICE_IRP_STATUS_IN_PROGRESS);
+        }
+        else
+        {
+            TEST_CHECK(testIrp[index].callbacks == 1U);
+            TEST_CHECK(!testIrp[index].isFromTasks);
+            TEST_CHECK(testIrp[index].irp.status == USB_DEVICE_IRP_STATUS_COMPLETED);
+            fromIsr += testIrp[index].callbacks;
+        }
+    }
+    TEST_CHECK(fromIsr == (TEST_IRP_NUMBER - DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH));
+
+    TEST_Tasks();
+
+    for (index = 0U; index < TEST_IRP_NUMBER; index++)
+    {
+        TEST_CHECK(testIrp[index].callbacks == 1U);
+        TEST_CHECK(testIrp[index].irp.status == USB_DEVICE_IRP_STATUS_COMPLETED);
+        TEST_CHECK(testIrp[index].irp.size == TEST_PACKET_SIZE);
+        TEST_CHECK(memcmp(testIrp[index].buffer, &testHostBuffer[index * TEST_PACKET_SIZE], TEST_PACKET_SIZE) == 0);
+        if (index < DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH)
+        {
+            TEST_CHECK(testIrp[index].isFromTasks);
+            /* After the ISR reported the overflow, in completion order */
+            TEST_CHECK(testIrp[index].order == (fromIsr + index));
+        }
+    }
+
+    /* Nothing is left in the queue */
+    TEST_Tasks();
+    TEST_CHECK(testCallbacks == TEST_IRP_NUMBER);
+}
+
+/* IRPCancelAll aborts the IRPs of the endpoint, completed or not */
+static void TEST_CancelAll( void )
+{
+    uint32_t index;
+
+    TEST_IrpsSubmit(4U);
+    TEST_HostSend(2U);
+    TEST_CHECK(testCallbacks == 0U);
+
+    TEST_CHECK(DRV_USBFSV1_DEVICE_IRPCancelAll(testHandle, TEST_ENDPOINT) == USB_ERROR_NONE);
+
+    /* The IRPs still queued to the endpoint are reported at once, the
+       completed ones when the tasks run */
+    TEST_CHECK(testIrp[0].callbacks == 0U);
+    TEST_CHECK(testIrp[1].callbacks == 0U);
+    TEST_CHECK(testIrp[2].callbacks == 1U);
+    TEST_CHECK(testIrp[3].callbacks == 1U);
+
+    TEST_Tasks();
+
+    for (index = 0U; index < 4U; index++)
+    {
+        TEST_CHECK(testIrp[index].callbacks == 1U);
+        TEST_CHECK(testIrp[index].irp.status == USB_DEVICE_IRP_STATUS_ABORTED);
+    }
+    TEST_CHECK(testIrp[0].isFromTasks);
+    TEST_CHECK(testIrp[1].isFromTasks);
+}
+
+/* IRPCancel on a completed IRP that waits in the queue */
+static void TEST_Cancel( void )
+{
+    TEST_IrpsSubmit(2U);
+    TEST_HostSend(1U);
+
+    TEST_CHECK(DRV_USBFSV1_DEVICE_IRPCancel(testHandle, &testIrp[0].irp) == USB_ERROR_NONE);
+    TEST_CHECK(testIrp[0].callbacks == 0U);
+
+    TEST_Tasks();
+    TEST_CHECK(testIrp[0].callbacks == 1U);
+    TEST_CHECK(testIrp[0].irp.status == USB_DEVICE_IRP_STATUS_ABORTED);
+
+    /* The other IRP stays queued to the endpoint and still completes */
+    TEST_CHECK(testIrp[1].callbacks == 0U);
+    TEST_HostSend(1U);
+    TEST_Tasks();
+    TEST_CHECK(testIrp[1].callbacks == 1U);
+    TEST_CHECK(testIrp[1].irp.status == USB_DEVICE_IRP_STATUS_COMPLETED);
+    TEST_CHECK(memcmp(testIrp[1].buffer, testHostBuffer, TEST_PACKET_SIZE) == 0);
+}
+
+/* A bus reset aborts the queued completions of every endpoint */
+static void TEST_Reset( void )
+{
+    TEST_IrpsSubmit(1U);
+    TEST_HostSend(1U);
+    TEST_CHECK(testIrp[0].callbacks == 0U);
+
+    TEST_BusReset();
+
+    TEST_Tasks();
+    TEST_CHECK(testIrp[0].callbacks == 1U);
+    TEST_CHECK(testIrp[0].isFromTasks);
+    TEST_CHECK(testIrp[0].irp.status == USB_DEVICE_IRP_STATUS_ABORTED);
+
+    /* The endpoint works again after the reset */
+    TEST_IrpsSubmit(1U);
+    TEST_HostSend(1U);
+    TEST_Tasks();
+    TEST_CHECK(testIrp[0].callbacks == 1U);
+    TEST_CHECK(testIrp[0].irp.status == USB_DEVICE_IRP_STATUS_COMPLETED);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( void )
+{
+    SIM_CLOCK_Initialize();
+    if (!SIM_CORE_Initialize() || !SIM_USB_Initialize())
+    {
+        printf("cannot map the USB registers\n");
+        return 1;
+    }
+
+    if (TEST_Attach())
+    {
+        TEST_Overflow();
+        TEST_CancelAll();
+        TEST_Cancel();
+        TEST_Reset();
+    }
+
+    printf("test_usb_irp: %s (%d failures, %llu ms of virtual time)\n",
+           (testFailures == 0) ? "pass" : "FAIL", testFailures,
+           (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return (testFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,708 @@
+/*******************************************************************************
+  USB/IP Server Host Test
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    test_usbip.c
+
+  Summary
+    Drives the USB device stack through SIM_USBIP over TCP loopback.
+
+  Description
+    The main thread runs the server as usbip_server does. A client thread
+    plays vhci_hcd: it lists and imports the device, then sends the URBs
+    the kernel drivers send, with the byte layout of the Linux client:
+    - the standard requests of the hub driver, and GET_MAX_LUN,
+    - a WRITE10 and a READ10 of the SD card, their CBW, data and CSW
+      submitted back to back as usb-storage does,
+    - an unlinked CDC read, and a CDC echo behind it,
+    - a READ10 past the end of the RAM disk, with the halt recovery of
+      usb-storage.
+    It then checks that a closed connection releases the device, and the
+    CBWs the server recorded for msd_bench.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "sim_sdhc.h"
+#include "sim_system.h"
+#include "sim_usb.h"
+#include "sim_usb_host.h"
+#include "sim_usb_system.h"
+#include "sim_usbip.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_CAPACITY           (64U * 1024U * 1024U)
+
+/* LUNs of usb_device_init_data.c */
+#define TEST_LUN_SDMMC          (0U)
+#define TEST_LUN_RAMDISK        (2U)
+
+#define TEST_RAMDISK_BLOCKS     (0x10000U / 512U)
+
+#define TEST_LOOP_STEP          SIM_TIME_US(2)
+
+#define TEST_TIMEOUT            SIM_TIME_MS(3000)
+
+/* Real time the client waits for a reply */
+#define TEST_REPLY_TIMEOUT_S    (10)
+
+#define TEST_BLOCKS             (8U)
+
+#define TEST_OP_HEADER_SIZE     (8U)
+#define TEST_DEVICE_SIZE        (312U)
+#define TEST_HEADER_SIZE        (48U)
+
+#define TEST_CMD_SUBMIT         (1U)
+#define TEST_CMD_UNLINK         (2U)
+#define TEST_RET_SUBMIT         (3U)
+#define TEST_RET_UNLINK         (4U)
+
+#define TEST_DIR_OUT            (0U)
+#define TEST_DIR_IN             (1U)
+
+#define TEST_CHECK(condition)                                               \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (false)
+
+typedef struct
+{
+    uint32_t command;
+
+    uint32_t seqnum;
+
+    int32_t status;
+
+    uint32_t actualLength;
+
+} TEST_RETURN;
+
+static int testFailures;
+
+static uint16_t testPort;
+
+static volatile bool testIsClientDone;
+
+static uint32_t testSeqnum;
+
+static uint8_t testWriteBuffer[TEST_BLOCKS * 512U];
+
+static uint8_t testReadBuffer[TEST_BLOCKS * 512U];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool TEST_IsConfigured( uintptr_t context )
+{
+    (void)context;
+    return SIM_USB_SYSTEM_IsConfigured();
+}
+
+static void TEST_Put16( uint8_t* buffer, uint16_t value )
+{
+    buffer[0] = (uint8_t)(value >> 8);
+    buffer[1] = (uint8_t)value;
+}
+
+static void TEST_Put32( uint8_t* buffer, uint32_t value )
+{
+    buffer[0] = (uint8_t)(value >> 24);
+    buffer[1] = (uint8_t)(value >> 16);
+    buffer[2] = (uint8_t)(value >> 8);
+    buffer[3] = (uint8_t)value;
+}
+
+static uint16_t TEST_Get16( const uint8_t* buffer )
+{
+    return (uint16_t)(((uint16_t)buffer[0] << 8) | buffer[1]);
+}
+
+static uint32_t TEST_Get32( const uint8_t* buffer )
+{
+    return ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) |
+           ((uint32_t)buffer[2] << 8) | (uint32_t)buffer[3];
+}
+
+static int TEST_Connect( void )
+{
+    struct sockaddr_in address;
+    struct timeval timeout = { .tv_sec = TEST_REPLY_TIMEOUT_S };
+    int socketId = socket(AF_INET, SOCK_STREAM, 0);
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(testPort);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((socketId < 0) || (connect(socketId, (struct sockaddr*)&address, sizeof(address)) != 0))
+    {
+        printf("cannot connect: %s\n", strerror(errno));
+        if (socketId >= 0)
+        {
+            (void)close(socketId);
+        }
+        return -1;
+    }
+    (void)setsockopt(socketId, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return socketId;
+}
+
+static bool TEST_Send( int socketId, const uint8_t* data, uint32_t length )
+{
+    ssize_t count;
+
+    while (length > 0U)
+    {
+        count = send(socketId, data, length, MSG_NOSIGNAL);
+        if (count <= 0)
+        {
+            return false;
+        }
+        data += count;
+        length -= (uint32_t)count;
+    }
+    return true;
+}
+
+static bool TEST_Receive( int socketId, uint8_t* data, uint32_t length )
+{
+    ssize_t count;
+
+    while (length > 0U)
+    {
+        count = recv(socketId, data, length, 0);
+        if (count <= 0)
+        {
+            return false;
+        }
+        data += count;
+        length -= (uint32_t)count;
+    }
+    return true;
+}
+
+/* The server closes the connection after an operation it does not keep */
+static bool TEST_IsClosed( int socketId )
+{
+    uint8_t byte;
+
+    return recv(socketId, &byte, 1U, 0) == 0;
+}
+
+static bool TEST_OperationSend( int socketId, uint16_t code, const char* busId )
+{
+    uint8_t request[TEST_OP_HEADER_SIZE + 32U];
+    uint32_t length = TEST_OP_HEADER_SIZE;
+
+    memset(request, 0, sizeof(request));
+    TEST_Put16(&request[0], 0x0111U);
+    TEST_Put16(&request[2], code);
+    if (busId != NULL)
+    {
+        (void)snprintf((char*)&request[TEST_OP_HEADER_SIZE], 32U, "%s", busId);
+        length += 32U;
+    }
+    return TEST_Send(socketId, request, length);
+}
+
+static uint32_t TEST_Submit( int socketId, uint32_t direction, uint32_t endpoint, uint32_t flags,
+                             const uint8_t* setup, const uint8_t* data, uint32_t length )
+{
+    uint8_t header[TEST_HEADER_SIZE];
+    uint32_t seqnum = ++testSeqnum;
+
+    memset(header, 0, sizeof(header));
+    TEST_Put32(&header[0], TEST_CMD_SUBMIT);
+    TEST_Put32(&header[4], seqnum);
+    TEST_Put32(&header[8], 0x00010002U);
+    TEST_Put32(&header[12], direction);
+    TEST_Put32(&header[16], endpoint);
+    TEST_Put32(&header[20], flags);
+    TEST_Put32(&header[24], length);
+    TEST_Put32(&header[32], 0xFFFFFFFFU);
+    if (setup != NULL)
+    {
+        memcpy(&header[40], setup, 8U);
+    }
+    TEST_CHECK(TEST_Send(socketId, header, sizeof(header)));
+    if ((direction == TEST_DIR_OUT) && (length > 0U))
+    {
+        TEST_CHECK(TEST_Send(socketId, data, length));
+    }
+    return seqnum;
+}
+
+static uint32_t TEST_Unlink( int socketId, uint32_t target )
+{
+    uint8_t header[TEST_HEADER_SIZE];
+    uint32_t seqnum = ++testSeqnum;
+
+    memset(header, 0, sizeof(header));
+    TEST_Put32(&header[0], TEST_CMD_UNLINK);
+    TEST_Put32(&header[4], seqnum);
+    TEST_Put32(&header[20], target);
+    TEST_CHECK(TEST_Send(socketId, header, sizeof(header)));
+    return seqnum;
+}
+
+/* Receives a reply, and the IN data of a RET_SUBMIT into the buffer */
+static TEST_RETURN TEST_ReturnReceive( int socketId, uint8_t* buffer, uint32_t length )
+{
+    uint8_t header[TEST_HEADER_SIZE];
+    TEST_RETURN reply = { 0 };
+
+    if (!TEST_Receive(socketId, header, sizeof(header)))
+    {
+        printf("no reply\n");
+        return reply;
+    }
+    reply.command = TEST_Get32(&header[0]);
+    reply.seqnum = TEST_Get32(&header[4]);
+    reply.status = (int32_t)TEST_Get32(&header[20]);
+    if (reply.command == TEST_RET_SUBMIT)
+    {
+        reply.actualLength = TEST_Get32(&header[24]);
+        if ((buffer != NULL) && (reply.actualLength > 0U))
+        {
+            TEST_CHECK(reply.actualLength <= length);
+            TEST_CHECK(TEST_Receive(socketId, buffer, reply.actualLength));
+        }
+    }
+    return reply;
+}
+
+static void TEST_ControlCheck( int socketId, const uint8_t setup[8], uint8_t* data, uint32_t length,
+                               int32_t status, uint32_t actualLength )
+{
+    uint32_t direction = ((setup[0] & 0x80U) != 0U) ? TEST_DIR_IN : TEST_DIR_OUT;
+    uint32_t seqnum = TEST_Submit(socketId, direction, 0U, 0U, setup, data, length);
+    TEST_RETURN reply = TEST_ReturnReceive(socketId, (direction == TEST_DIR_IN) ? data : NULL, length);
+
+    TEST_CHECK((reply.command == TEST_RET_SUBMIT) && (reply.seqnum == seqnum));
+    TEST_CHECK(reply.status == status);
+    TEST_CHECK(reply.actualLength == actualLength);
+}
+
+static void TEST_CbwBuild( uint8_t cbw[31], uint32_t tag, bool isIn, uint8_t lun, uint8_t opcode,
+                           uint32_t block, uint16_t nBlocks )
+{
+    memset(cbw, 0, 31U);
+    cbw[0] = 0x55U;
+    cbw[1] = 0x53U;
+    cbw[2] = 0x42U;
+    cbw[3] = 0x43U;
+    memcpy(&cbw[4], &tag, 4U);
+    cbw[8] = (uint8_t)(nBlocks * 512U);
+    cbw[9] = (uint8_t)((nBlocks * 512U) >> 8);
+    cbw[10] = (uint8_t)((nBlocks * 512U) >> 16);
+    cbw[12] = isIn ? 0x80U : 0x00U;
+    cbw[13] = lun;
+    cbw[14] = 10U;
+    cbw[15] = opcode;
+    TEST_Put32(&cbw[17], block);
+    TEST_Put16(&cbw[22], nBlocks);
+}
+
+static bool TEST_DeviceCheck( const uint8_t* device )
+{
+    /* busid, devnum, speed, idVendor and idProduct */
+    return (strcmp((const char*)&device[256], SIM_USBIP_BUS_ID) == 0) &&
+           (TEST_Get32(&device[292]) == SIM_USB_HOST_ADDRESS) && (TEST_Get32(&device[296]) == 2U) &&
+           (TEST_Get16(&device[300]) == 0x04D8U) && (TEST_Get16(&device[302]) == 0x0009U);
+}
+
+static void TEST_DeviceList( void )
+{
+    uint8_t reply[TEST_OP_HEADER_SIZE + 4U + TEST_DEVICE_SIZE + (3U * 4U)];
+    const uint8_t* device = &reply[TEST_OP_HEADER_SIZE + 4U];
+    const uint8_t* interfaces = &device[TEST_DEVICE_SIZE];
+    int socketId = TEST_Connect();
+
+    if (socketId < 0)
+    {
+        testFailures++;
+        return;
+    }
+    TEST_CHECK(TEST_OperationSend(socketId, 0x8005U, NULL));
+    TEST_CHECK(TEST_Receive(socketId, reply, TEST_OP_HEADER_SIZE + 4U + TEST_DEVICE_SIZE));
+    TEST_CHECK((TEST_Get16(&reply[2]) == 0x0005U) && (TEST_Get32(&reply[4]) == 0U));
+    TEST_CHECK(TEST_Get32(&reply[8]) == 1U);
+    TEST_CHECK(TEST_DeviceCheck(device));
+
+    /* MSD, CDC and CDC data interfaces */
+    TEST_CHECK(device[311] == 3U);
+    TEST_CHECK(TEST_Receive(socketId, (uint8_t*)interfaces, 3U * 4U));
+    TEST_CHECK((interfaces[0] == 0x08U) && (interfaces[1] == 0x06U) && (interfaces[2] == 0x50U));
+    TEST_CHECK(interfaces[4] == 0x02U);
+    TEST_CHECK(interfaces[8] == 0x0AU);
+    TEST_CHECK(TEST_IsClosed(socketId));
+    (void)close(socketId);
+}
+
+static int TEST_Import( const char* busId )
+{
+    uint8_t reply[TEST_OP_HEADER_SIZE + TEST_DEVICE_SIZE];
+    int socketId = TEST_Connect();
+
+    if (socketId < 0)
+    {
+        testFailures++;
+        return -1;
+    }
+    TEST_CHECK(TEST_OperationSend(socketId, 0x8003U, busId));
+    TEST_CHECK(TEST_Receive(socketId, reply, TEST_OP_HEADER_SIZE));
+    TEST_CHECK(TEST_Get16(&reply[2]) == 0x0003U);
+    if (TEST_Get32(&reply[4]) != 0U)
+    {
+        TEST_CHECK(TEST_IsClosed(socketId));
+        (void)close(socketId);
+        return -1;
+    }
+    TEST_CHECK(TEST_Receive(socketId, &reply[TEST_OP_HEADER_SIZE], TEST_DEVICE_SIZE));
+    TEST_CHECK(TEST_DeviceCheck(&reply[TEST_OP_HEADER_SIZE]));
+    return socketId;
+}
+
+static void TEST_Requests( int socketId )
+{
+    const uint8_t getDescriptor[8] = { 0x80U, 0x06U, 0x00U, 0x01U, 0x00U, 0x00U, 0x40U, 0x00U };
+    const uint8_t setConfiguration[8] = { 0x00U, 0x09U, 0x01U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U };
+    const uint8_t getMaxLun[8] = { 0xA1U, 0xFEU, 0x00U, 0x00U, 0x00U, 0x00U, 0x01U, 0x00U };
+    uint8_t data[64];
+
+    memset(data, 0, sizeof(data));
+    TEST_ControlCheck(socketId, getDescriptor, data, sizeof(data), 0, 18U);
+    TEST_CHECK((data[0] == 18U) && (data[1] == 0x01U) && (data[8] == 0xD8U) && (data[9] == 0x04U));
+
+    TEST_ControlCheck(socketId, setConfiguration, NULL, 0U, 0, 0U);
+
+    TEST_ControlCheck(socketId, getMaxLun, data, 1U, 0, 1U);
+    TEST_CHECK(data[0] == 3U);
+}
+
+/* CBW, data and CSW go out together, as usb-storage queues them */
+static void TEST_Msd( int socketId )
+{
+    uint8_t cbw[31];
+    uint8_t csw[13];
+    TEST_RETURN reply;
+    uint32_t seqnums[3];
+    uint32_t index;
+    uint32_t tag;
+
+    for (index = 0U; index < sizeof(testWriteBuffer); index++)
+    {
+        testWriteBuffer[index] = (uint8_t)((index * 13U) + 5U);
+    }
+
+    tag = 0x1001U;
+    TEST_CbwBuild(cbw, tag, false, TEST_LUN_SDMMC, 0x2AU, 100U, TEST_BLOCKS);
+    seqnums[0] = TEST_Submit(socketId, TEST_DIR_OUT, 1U, 0U, NULL, cbw, sizeof(cbw));
+    seqnums[1] = TEST_Submit(socketId, TEST_DIR_OUT, 1U, 0U, NULL, testWriteBuffer, sizeof(testWriteBuffer));
+    seqnums[2] = TEST_Submit(socketId, TEST_DIR_IN, 1U, 0U, NULL, NULL, sizeof(csw));
+    reply = TEST_ReturnReceive(socketId, NULL, 0U);
+    TEST_CHECK((reply.seqnum == seqnums[0]) && (reply.status == 0) && (reply.actualLength == sizeof(cbw)));
+    reply = TEST_ReturnReceive(socketId, NULL, 0U);
+    TEST_CHECK((reply.seqnum == seqnums[1]) && (reply.status == 0) && (reply.actualLength == sizeof(testWriteBuffer)));
+    reply = TEST_ReturnReceive(socketId, csw, sizeof(csw));
+    TEST_CHECK((reply.seqnum == seqnums[2]) && (reply.status == 0) && (reply.actualLength == sizeof(csw)));
+    TEST_CHECK((memcmp(&csw[4], &tag, 4U) == 0) && (csw[12] == 0U));
+
+    tag = 0x1002U;
+    memset(testReadBuffer, 0, sizeof(testReadBuffer));
+    TEST_CbwBuild(cbw, tag, true, TEST_LUN_SDMMC, 0x28U, 100U, TEST_BLOCKS);
+    seqnums[0] = TEST_Submit(socketId, TEST_DIR_OUT, 1U, 0U, NULL, cbw, sizeof(cbw));
+    seqnums[1] = TEST_Submit(socketId, TEST_DIR_IN, 1U, 0x0001U, NULL, NULL, sizeof(testReadBuffer));
+    seqnums[2] = TEST_Submit(socketId, TEST_DIR_IN, 1U, 0U, NULL, NULL, sizeof(csw));
+    reply = TEST_ReturnReceive(socketId, NULL, 0U);
+    TEST_CHECK((reply.seqnum == seqnums[0]) && (reply.status == 0));
+    reply = TEST_ReturnReceive(socketId, testReadBuffer, sizeof(testReadBuffer));
+    TEST_CHECK((reply.seqnum == seqnums[1]) && (reply.status == 0) && (reply.actualLength == sizeof(testReadBuffer)));
+    reply = TEST_ReturnReceive(socketId, csw, sizeof(csw));
+    TEST_CHECK((reply.seqnum == seqnums[2]) && (reply.status == 0) && (csw[12] == 0U));
+    TEST_CHECK(memcmp(testWriteBuffer, testReadBuffer, sizeof(testReadBuffer)) == 0);
+}
+
+static void TEST_Unlinks( int socketId )
+{
+    const uint8_t message[5] = { 'h', 'e', 'l', 'l', 'o' };
+    uint8_t data[64];
+    TEST_RETURN reply;
+    uint32_t readSeqnum;
+    uint32_t unlinkSeqnum;
+    uint32_t writeSeqnum;
+
+    /* Nothing to read: the transfer waits until it is unlinked */
+    readSeqnum = TEST_Submit(socketId, TEST_DIR_IN, 3U, 0U, NULL, NULL, sizeof(data));
+    unlinkSeqnum = TEST_Unlink(socketId, readSeqnum);
+    reply = TEST_ReturnReceive(socketId, NULL, 0U);
+    TEST_CHECK((reply.command == TEST_RET_UNLINK) && (reply.seqnum == unlinkSeqnum));
+    TEST_CHECK(reply.status == -ECONNRESET);
+
+    /* Already given back */
+    unlinkSeqnum = TEST_Unlink(socketId, readSeqnum);
+    reply = TEST_ReturnReceive(socketId, NULL, 0U);
+    TEST_CHECK((reply.command == TEST_RET_UNLINK) && (reply.seqnum == unlinkSeqnum) && (reply.status == 0));
+
+    /* The unlinked read gets no RET_SUBMIT: the next replies are the echo's */
+    writeSeqnum = TEST_Submit(socketId, TEST_DIR_OUT, 3U, 0U, NULL, message, sizeof(message));
+    readSeqnum = TEST_Submit(socketId, TEST_DIR_IN, 3U, 0U, NULL, NULL, sizeof(data));
+    reply = TEST_ReturnReceive(socketId, NULL, 0U);
+    TEST_CHECK((reply.command == TEST_RET_SUBMIT) && (reply.seqnum == writeSeqnum) && (reply.status == 0));
+    reply = TEST_ReturnReceive(socketId, data, sizeof(data));
+    TEST_CHECK((reply.command == TEST_RET_SUBMIT) && (reply.seqnum == readSeqnum) && (reply.status == 0));
+    TEST_CHECK((reply.actualLength == sizeof(message)) && (memcmp(data, message, sizeof(message)) == 0));
+
+    /* Endpoint the device does not have */
+    readSeqnum = TEST_Submit(socketId, TEST_DIR_IN, 9U, 0U, NULL, NULL, sizeof(data));
+    reply = TEST_ReturnReceive(socketId, NULL, 0U);
+    TEST_CHECK((reply.seqnum == readSeqnum) && (reply.status == -EPIPE));
+}
+
+/* A stalled pipe is cleared, and the CSW read again, as usb-storage does */
+static TEST_RETURN TEST_HaltRecover( int socketId, uint8_t* buffer, uint32_t length, uint32_t seqnum )
+{
+    const uint8_t clearFeature[8] = { 0x02U, 0x01U, 0x00U, 0x00U, 0x81U, 0x00U, 0x00U, 0x00U };
+    TEST_RETURN reply = TEST_ReturnReceive(socketId, buffer, length);
+
+    TEST_CHECK(reply.seqnum == seqnum);
+    if (reply.status == -EPIPE)
+    {
+        TEST_ControlCheck(socketId, clearFeature, NULL, 0U, 0, 0U);
+    }
+    return reply;
+}
+
+static void TEST_PastEnd( int socketId )
+{
+    uint8_t cbw[31];
+    uint8_t csw[13];
+    TEST_RETURN reply;
+    uint32_t seqnum;
+    bool isStalled;
+
+    TEST_CbwBuild(cbw, 0x2001U, true, TEST_LUN_RAMDISK, 0x28U, TEST_RAMDISK_BLOCKS, 1U);
+    seqnum = TEST_Submit(socketId, TEST_DIR_OUT, 1U, 0U, NULL, cbw, sizeof(cbw));
+    reply = TEST_ReturnReceive(socketId, NULL, 0U);
+    TEST_CHECK((reply.seqnum == seqnum) && (reply.status == 0));
+
+    seqnum = TEST_Submit(socketId, TEST_DIR_IN, 1U, 0U, NULL, NULL, 512U);
+    reply = TEST_HaltRecover(socketId, testReadBuffer, 512U, seqnum);
+    isStalled = (reply.status == -EPIPE);
+    seqnum = TEST_Submit(socketId, TEST_DIR_IN, 1U, 0U, NULL, NULL, sizeof(csw));
+    reply = TEST_HaltRecover(socketId, csw, sizeof(csw), seqnum);
+    isStalled = isStalled || (reply.status == -EPIPE);
+    if (reply.status == -EPIPE)
+    {
+        seqnum = TEST_Submit(socketId, TEST_DIR_IN, 1U, 0U, NULL, NULL, sizeof(csw));
+        reply = TEST_ReturnReceive(socketId, csw, sizeof(csw));
+        TEST_CHECK(reply.seqnum == seqnum);
+    }
+    TEST_CHECK(isStalled);
+    TEST_CHECK((reply.status == 0) && (reply.actualLength == sizeof(csw)) && (csw[12] == 1U));
+}
+
+static void* TEST_Client( void* argument )
+{
+    int socketId;
+
+    (void)argument;
+
+    TEST_DeviceList();
+    TEST_CHECK(TEST_Import("9-9") < 0);
+
+    socketId = TEST_Import(SIM_USBIP_BUS_ID);
+    if (socketId >= 0)
+    {
+        /* One attach at a time */
+        TEST_CHECK(TEST_Import(SIM_USBIP_BUS_ID) < 0);
+
+        TEST_Requests(socketId);
+        TEST_Msd(socketId);
+        TEST_Unlinks(socketId);
+        TEST_PastEnd(socketId);
+        (void)close(socketId);
+    }
+    else
+    {
+        testFailures++;
+    }
+
+    /* The closed connection has released the device */
+    TEST_DeviceList();
+    socketId = TEST_Import(SIM_USBIP_BUS_ID);
+    TEST_CHECK(socketId >= 0);
+    if (socketId >= 0)
+    {
+        (void)close(socketId);
+    }
+
+    testIsClientDone = true;
+    return NULL;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    const char* imagePath = (argc > 1) ? argv[1] : "test_usbip.img";
+    SIM_SDHC_INIT sdhcInit =
+    {
+        .capacity = TEST_CAPACITY,
+        .profile = SIM_SDHC_ProfileGet("typical"),
+        .seed = 1U,
+        .isInserted = true,
+    };
+    SIM_USBIP_INIT usbipInit =
+    {
+        .address = NULL,
+        .port = 0U,
+        .step = TEST_LOOP_STEP,
+    };
+    SIM_USBIP_STATISTICS statistics;
+    pthread_t client;
+    FILE* record = tmpfile();
+    char line[128];
+    uint32_t nLines = 0U;
+    uint32_t attempt;
+
+    sdhcInit.imagePath = imagePath;
+    (void)unlink(imagePath);
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_SDHC_Initialize(&sdhcInit))
+    {
+        printf("cannot create %s\n", imagePath);
+        return 1;
+    }
+    if (!SIM_USB_SYSTEM_Initialize())
+    {
+        printf("cannot map the USB registers\n");
+        return 1;
+    }
+    SIM_USB_HOST_Initialize(TEST_LOOP_STEP, TEST_TIMEOUT);
+    TEST_CHECK(SIM_USB_HOST_Enumerate());
+    TEST_CHECK(SIM_SYSTEM_RunUntil(TEST_IsConfigured, 0U, TEST_LOOP_STEP, TEST_TIMEOUT));
+
+    /* The card attaches after the USB device */
+    for (attempt = 0U; attempt < 100U; attempt++)
+    {
+        if (SIM_USB_HOST_MsdTestUnitReady(TEST_LUN_SDMMC) == SIM_USB_HOST_MSD_PASSED)
+        {
+            break;
+        }
+        SIM_USB_HOST_Wait(SIM_TIME_MS(10));
+    }
+    TEST_CHECK(attempt < 100U);
+
+    if ((testFailures == 0) && SIM_USBIP_Initialize(&usbipInit))
+    {
+        testPort = SIM_USBIP_PortGet();
+        SIM_USBIP_RecordSet(record);
+        TEST_CHECK(pthread_create(&client, NULL, TEST_Client, NULL) == 0);
+        while (!testIsClientDone)
+        {
+            SIM_USBIP_Tasks();
+        }
+        (void)pthread_join(client, NULL);
+
+        SIM_USBIP_StatisticsGet(&statistics);
+        TEST_CHECK(statistics.imports == 2U);
+        TEST_CHECK(statistics.unlinks == 2U);
+        TEST_CHECK(statistics.outBytes >= sizeof(testWriteBuffer));
+        TEST_CHECK(statistics.inBytes >= sizeof(testReadBuffer));
+        SIM_USBIP_RecordSet(NULL);
+        SIM_USBIP_Deinitialize();
+
+        /* The WRITE10, READ10 and past the end READ10, in msd_bench format */
+        rewind(record);
+        while (fgets(line, sizeof(line), record) != NULL)
+        {
+            const char* expected[] =
+            {
+                "0 out 4096 2a000000006400000800\n",
+                "0 in 4096 28000000006400000800\n",
+                "2 in 512 28000000008000000100\n",
+            };
+            const char* fields = strchr(line, ' ');
+
+            TEST_CHECK((nLines < 3U) && (fields != NULL) && (strcmp(fields + 1, expected[nLines]) == 0));
+            nLines++;
+        }
+        TEST_CHECK(nLines == 3U);
+    }
+    else
+    {
+        printf("cannot listen\n");
+        testFailures++;
+    }
+
+    if (record != NULL)
+    {
+        (void)fclose(record);
+    }
+    SIM_SDHC_Deinitialize();
+    (void)unlink(imagePath);
+
+    printf("test_usbip: %s (%d failures, %llu ms of virtual time)\n",
+           (testFailures == 0) ? "pass" : "FAIL", testFailures,
+           (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return (testFailures == 0) ? 0 : 1;
+}
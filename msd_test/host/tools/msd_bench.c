@@ -0,0 +1,513 @@
+/*******************************************************************************
+  USB_DEVICE_MSD Host Benchmark
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    msd_bench.c
+
+  Summary
+    Replays host command traces through USB_DEVICE_MSD in virtual time.
+
+  Description
+    The benchmark runs the USB device stack on the simulated USB peripheral,
+    with the simulated SD card behind the MSD function, and sends it the
+    commands of trace files as a host does: CBW, data and CSW on the bulk
+    endpoints, one command at a time. It prints one line per trace in the
+    format of the 'B' lines of the target benchmark:
+
+        bench name=<trace> req=<commands> blocks=<blocks> us=<time>
+              iops=<commands/s> kbps=<KB/s> p50=<us> p90=<us> p99=<us>
+              max=<us> err=<errors>
+
+    A command's latency runs from the submission of its CBW to the end of
+    its CSW. The times are virtual, given by the bus timing of SIM_USB, the
+    card profile and a fixed processor time per pass of the main loop.
+
+    A trace has one line per CBW, and comment lines starting with '#':
+
+        <idle_us> <lun> <in|out|none> <data_length> <cdb>
+
+    idle_us is the time the host left the drive idle before the CBW, and
+    cdb the command block in hex. "usbip_server --record" writes traces of
+    a real host in this format. The data written is a fixed pattern.
+
+    Options:
+        --image <path>      image file (msd_bench.img)
+        --size <MB>         card size (64)
+        --profile <name>    typical, slow or ideal (typical)
+        --set <key=value>   changes a value of the profile
+        --dir <path>        directory of the traces (traces/ of the sources)
+        --commands <n>      replays at most n commands of each trace
+        --paced             waits idle_us before each command, which then
+                            counts in us=, iops= and kbps=
+        --trace             prints the transfers on the simulated bus
+        [trace]...          trace names in --dir, or trace file paths
+                            (explorer_copy, linux_cp, fat_churn and
+                            random_small_writes)
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_sdhc.h"
+#include "sim_system.h"
+#include "sim_usb.h"
+#include "sim_usb_host.h"
+#include "sim_usb_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define MSD_BENCH_LOOP_STEP           SIM_TIME_US(2)
+
+#define MSD_BENCH_TIMEOUT             SIM_TIME_MS(3000)
+
+/* The registers SIM_CORE maps from 8 MB up leave the program less room for
+   its data than sdmmc_bench has */
+#define MSD_BENCH_MAX_LENGTH          (256U * 1024U)
+
+#define MSD_BENCH_MAX_SAMPLES         (1U << 16)
+
+#define MSD_BENCH_MAX_CDB             (16U)
+
+#ifndef MSD_BENCH_TRACE_DIR
+#define MSD_BENCH_TRACE_DIR           "traces"
+#endif
+
+static const char* const msdBenchTraces[] =
+{
+    "explorer_copy",
+    "linux_cp",
+    "fat_churn",
+    "random_small_writes",
+};
+
+typedef struct
+{
+    uint32_t idle;
+
+    uint8_t lun;
+
+    bool isIn;
+
+    uint32_t length;
+
+    uint8_t cdb[MSD_BENCH_MAX_CDB];
+
+    uint8_t cdbLength;
+
+} MSD_BENCH_COMMAND;
+
+static uint8_t msdBenchBuffer[MSD_BENCH_MAX_LENGTH] __attribute__((aligned(4)));
+
+static uint32_t msdBenchSamples[MSD_BENCH_MAX_SAMPLES];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool MSD_BENCH_IsConfigured( uintptr_t context )
+{
+    (void)context;
+    return SIM_USB_SYSTEM_IsConfigured();
+}
+
+static int MSD_BENCH_SampleCompare( const void* a, const void* b )
+{
+    uint32_t sampleA = *(const uint32_t*)a;
+    uint32_t sampleB = *(const uint32_t*)b;
+
+    return (sampleA > sampleB) - (sampleA < sampleB);
+}
+
+static uint32_t MSD_BENCH_Percentile( uint32_t nSamples, uint32_t percent )
+{
+    uint32_t index;
+
+    if (nSamples == 0U)
+    {
+        return 0U;
+    }
+    index = (uint32_t)(((uint64_t)nSamples * percent + 99U) / 100U);
+    return msdBenchSamples[(index > 0U) ? (index - 1U) : 0U];
+}
+
+/* Returns false for a line that is not a command */
+static bool MSD_BENCH_CommandParse( const char* line, MSD_BENCH_COMMAND* command, bool* isValid )
+{
+    char direction[8];
+    char cdb[(MSD_BENCH_MAX_CDB * 2U) + 2U];
+    unsigned long idle;
+    unsigned int lun;
+    unsigned long length;
+    unsigned int byte;
+    size_t cdbChars;
+    uint32_t index;
+
+    *isValid = true;
+    while ((*line == ' ') || (*line == '\t'))
+    {
+        line++;
+    }
+    if ((*line == '#') || (*line == '\n') || (*line == '\r') || (*line == '\0'))
+    {
+        return false;
+    }
+
+    *isValid = false;
+    if (sscanf(line, "%lu %u %7s %lu %33s", &idle, &lun, direction, &length, cdb) != 5)
+    {
+        return true;
+    }
+    cdbChars = strlen(cdb);
+    if ((lun > 15U) || (length > MSD_BENCH_MAX_LENGTH) || (cdbChars < 2U) || ((cdbChars % 2U) != 0U) ||
+        (cdbChars > (MSD_BENCH_MAX_CDB * 2U)))
+    {
+        return true;
+    }
+
+    command->idle = (uint32_t)idle;
+    command->lun = (uint8_t)lun;
+    command->length = (uint32_t)length;
+    command->cdbLength = (uint8_t)(cdbChars / 2U);
+    if (strcmp(direction, "in") == 0)
+    {
+        command->isIn = true;
+    }
+    else if ((strcmp(direction, "out") == 0) || ((strcmp(direction, "none") == 0) && (length == 0U)))
+    {
+        command->isIn = false;
+    }
+    else
+    {
+        return true;
+    }
+    for (index = 0U; index < command->cdbLength; index++)
+    {
+        if (sscanf(&cdb[index * 2U], "%2x", &byte) != 1)
+        {
+            return true;
+        }
+        command->cdb[index] = (uint8_t)byte;
+    }
+    *isValid = true;
+    return true;
+}
+
+static bool MSD_BENCH_TraceRun( const char* name, const char* path, uint32_t maxCommands, bool isPaced )
+{
+    MSD_BENCH_COMMAND command;
+    SIM_USB_HOST_MSD_STATUS status;
+    SIM_TIME start;
+    SIM_TIME commandStart;
+    SIM_TIME elapsed;
+    char line[256];
+    uint32_t lineNumber = 0U;
+    uint32_t nCommands = 0U;
+    uint32_t nErrors = 0U;
+    uint64_t nBlocks = 0U;
+    bool isValid;
+    FILE* file = fopen(path, "r");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+
+    start = SIM_CLOCK_Now();
+    while ((nCommands < maxCommands) && (nCommands < MSD_BENCH_MAX_SAMPLES) && (fgets(line, sizeof(line), file) != NULL))
+    {
+        lineNumber++;
+        if (!MSD_BENCH_CommandParse(line, &command, &isValid))
+        {
+            continue;
+        }
+        if (!isValid)
+        {
+            fprintf(stderr, "%s:%lu: bad command\n", path, (unsigned long)lineNumber);
+            (void)fclose(file);
+            return false;
+        }
+
+        if (isPaced && (command.idle > 0U))
+        {
+            SIM_USB_HOST_Wait(SIM_TIME_US(command.idle));
+        }
+
+        commandStart = SIM_CLOCK_Now();
+        status = SIM_USB_HOST_MsdCommand(command.lun, command.cdb, command.cdbLength, command.isIn,
+                                         (command.length > 0U) ? msdBenchBuffer : NULL, command.length, NULL);
+        msdBenchSamples[nCommands++] = (uint32_t)((SIM_CLOCK_Now() - commandStart) / 1000U);
+
+        if (status == SIM_USB_HOST_MSD_PASSED)
+        {
+            nBlocks += command.length / 512U;
+        }
+        else
+        {
+            nErrors++;
+            if (status == SIM_USB_HOST_MSD_TRANSPORT_ERROR)
+            {
+                fprintf(stderr, "%s:%lu: the command did not complete\n", path, (unsigned long)lineNumber);
+                break;
+            }
+        }
+    }
+    (void)fclose(file);
+
+    elapsed = SIM_CLOCK_Now() - start;
+    qsort(msdBenchSamples, nCommands, sizeof(msdBenchSamples[0]), MSD_BENCH_SampleCompare);
+
+    printf("bench name=%s req=%lu blocks=%llu us=%llu iops=%llu kbps=%llu p50=%lu p90=%lu p99=%lu max=%lu err=%lu\n",
+           name, (unsigned long)nCommands, (unsigned long long)nBlocks,
+           (unsigned long long)(elapsed / 1000U),
+           (unsigned long long)((elapsed > 0U) ? (((uint64_t)nCommands * 1000000000U) / elapsed) : 0U),
+           (unsigned long long)((elapsed > 0U) ? ((nBlocks * 512U * 1000000000U / 1024U) / elapsed) : 0U),
+           (unsigned long)MSD_BENCH_Percentile(nCommands, 50U),
+           (unsigned long)MSD_BENCH_Percentile(nCommands, 90U),
+           (unsigned long)MSD_BENCH_Percentile(nCommands, 99U),
+           (unsigned long)((nCommands > 0U) ? msdBenchSamples[nCommands - 1U] : 0U),
+           (unsigned long)nErrors);
+    return true;
+}
+
+static void MSD_BENCH_Usage( const char* program )
+{
+    fprintf(stderr, "usage: %s [--image path] [--size MB] [--profile typical|slow|ideal]\n"
+                    "       [--set key=value]... [--dir path] [--commands n] [--paced] [--trace]\n"
+                    "       [trace]...\n", program);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    static SIM_SDHC_PROFILE profile;
+    SIM_SDHC_INIT sdhcInit =
+    {
+        .imagePath = "msd_bench.img",
+        .capacity = 64ULL * 1024U * 1024U,
+        .seed = 1U,
+        .isInserted = true,
+    };
+    const char* profileName = "typical";
+    const char* traceDir = MSD_BENCH_TRACE_DIR;
+    const char* assignments[16];
+    uint32_t nAssignments = 0U;
+    const char* selected[64];
+    uint32_t nSelected = 0U;
+    uint32_t maxCommands = MSD_BENCH_MAX_SAMPLES;
+    bool isPaced = false;
+    bool isTraceEnabled = false;
+    bool isFailed = false;
+    char path[512];
+    char traceName[64];
+    uint32_t lastBlock = 0U;
+    uint32_t blockSize = 0U;
+    uint32_t attempt;
+    uint32_t index;
+    int argIndex;
+
+    for (argIndex = 1; argIndex < argc; argIndex++)
+    {
+        const char* arg = argv[argIndex];
+        const char* value = (argIndex + 1 < argc) ? argv[argIndex + 1] : NULL;
+
+        if (strcmp(arg, "--trace") == 0)
+        {
+            isTraceEnabled = true;
+            continue;
+        }
+        if (strcmp(arg, "--paced") == 0)
+        {
+            isPaced = true;
+            continue;
+        }
+        if (strncmp(arg, "--", 2) != 0)
+        {
+            if (nSelected == (sizeof(selected) / sizeof(selected[0])))
+            {
+                MSD_BENCH_Usage(argv[0]);
+                return 2;
+            }
+            selected[nSelected++] = arg;
+            continue;
+        }
+        if (value == NULL)
+        {
+            MSD_BENCH_Usage(argv[0]);
+            return 2;
+        }
+        argIndex++;
+
+        if (strcmp(arg, "--image") == 0)
+        {
+            sdhcInit.imagePath = value;
+        }
+        else if (strcmp(arg, "--size") == 0)
+        {
+            sdhcInit.capacity = strtoull(value, NULL, 0) * 1024U * 1024U;
+        }
+        else if (strcmp(arg, "--profile") == 0)
+        {
+            profileName = value;
+        }
+        else if ((strcmp(arg, "--set") == 0) && (nAssignments < (sizeof(assignments) / sizeof(assignments[0]))))
+        {
+            assignments[nAssignments++] = value;
+        }
+        else if (strcmp(arg, "--dir") == 0)
+        {
+            traceDir = value;
+        }
+        else if (strcmp(arg, "--commands") == 0)
+        {
+            maxCommands = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else
+        {
+            MSD_BENCH_Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (SIM_SDHC_ProfileGet(profileName) == NULL)
+    {
+        fprintf(stderr, "unknown profile %s\n", profileName);
+        return 2;
+    }
+    profile = *SIM_SDHC_ProfileGet(profileName);
+    for (index = 0U; index < nAssignments; index++)
+    {
+        if (!SIM_SDHC_ProfileSet(&profile, assignments[index]))
+        {
+            fprintf(stderr, "unknown profile value %s\n", assignments[index]);
+            return 2;
+        }
+    }
+    sdhcInit.profile = &profile;
+    if (nSelected == 0U)
+    {
+        for (index = 0U; index < (sizeof(msdBenchTraces) / sizeof(msdBenchTraces[0])); index++)
+        {
+            selected[nSelected++] = msdBenchTraces[index];
+        }
+    }
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_SDHC_Initialize(&sdhcInit))
+    {
+        fprintf(stderr, "cannot open %s\n", sdhcInit.imagePath);
+        return 1;
+    }
+    if (!SIM_USB_SYSTEM_Initialize())
+    {
+        fprintf(stderr, "cannot map the USB registers\n");
+        SIM_SDHC_Deinitialize();
+        return 1;
+    }
+    SIM_USB_HOST_Initialize(MSD_BENCH_LOOP_STEP, MSD_BENCH_TIMEOUT);
+    if (!SIM_USB_HOST_Enumerate() ||
+        !SIM_SYSTEM_RunUntil(MSD_BENCH_IsConfigured, 0U, MSD_BENCH_LOOP_STEP, MSD_BENCH_TIMEOUT))
+    {
+        fprintf(stderr, "the device did not enumerate\n");
+        SIM_SDHC_Deinitialize();
+        return 1;
+    }
+
+    /* The card attaches after the USB device, as a PC sees it */
+    for (attempt = 0U; attempt < 100U; attempt++)
+    {
+        if (SIM_USB_HOST_MsdTestUnitReady(0U) == SIM_USB_HOST_MSD_PASSED)
+        {
+            break;
+        }
+        SIM_USB_HOST_Wait(SIM_TIME_MS(10));
+    }
+    if ((attempt == 100U) ||
+        (SIM_USB_HOST_MsdReadCapacity(0U, &lastBlock, &blockSize) != SIM_USB_HOST_MSD_PASSED))
+    {
+        fprintf(stderr, "the card did not attach\n");
+        SIM_SDHC_Deinitialize();
+        return 1;
+    }
+    if (isTraceEnabled)
+    {
+        SIM_USB_TraceSet(stdout);
+    }
+    printf("# profile=%s blocks=%lu paced=%d attach_us=%llu\n", profile.name, (unsigned long)(lastBlock + 1U),
+           isPaced ? 1 : 0, (unsigned long long)(SIM_CLOCK_Now() / 1000U));
+
+    memset(msdBenchBuffer, 0xA5, sizeof(msdBenchBuffer));
+    for (index = 0U; (index < nSelected) && !isFailed; index++)
+    {
+        const char* name = selected[index];
+        const char* separator = strrchr(name, '/');
+        char* extension;
+
+        if ((separator != NULL) || (strstr(name, ".trace") != NULL))
+        {
+            /* A path: named after its file */
+            (void)snprintf(path, sizeof(path), "%s", name);
+            (void)snprintf(traceName, sizeof(traceName), "%s", (separator != NULL) ? (separator + 1) : name);
+            extension = strstr(traceName, ".trace");
+            if (extension != NULL)
+            {
+                *extension = '\0';
+            }
+            name = traceName;
+        }
+        else
+        {
+            (void)snprintf(path, sizeof(path), "%s/%s.trace", traceDir, name);
+        }
+        isFailed = !MSD_BENCH_TraceRun(name, path, maxCommands, isPaced);
+    }
+
+    SIM_USB_TraceSet(NULL);
+    SIM_SDHC_Deinitialize();
+    return isFailed ? 1 : 0;
+}
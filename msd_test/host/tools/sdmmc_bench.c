@@ -0,0 +1,425 @@
+/*******************************************************************************
+  DRV_SDMMC Host Benchmark
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sdmmc_bench.c
+
+  Summary
+    Measures DRV_SDMMC on the simulated SDHC0 in virtual time.
+
+  Description
+    The benchmark runs sequential and random read and write patterns through
+    DRV_SDMMC, one request at a time as the MSD function driver issues them,
+    and prints one line per pattern in the format of the 'B' lines of the
+    target benchmark:
+
+        bench name=<pattern> req=<requests> blocks=<blocks> us=<time>
+              iops=<requests/s> kbps=<KB/s> p50=<us> p90=<us> p99=<us>
+              max=<us> err=<errors>
+
+    The times are virtual, given by the card profile and the bus timing of
+    the simulator, with a fixed processor time per pass of the main loop.
+
+    Options:
+        --image <path>      image file (sdmmc_bench.img)
+        --size <MB>         card size (1024)
+        --profile <name>    typical, slow or ideal (typical)
+        --set <key=value>   changes a value of the profile
+        --duration <ms>     virtual time per pattern (1000)
+        --crc-ppm <n>       data CRC errors per million blocks (0)
+        --seed <n>          seed of the random patterns (1)
+        --trace             prints the commands of the simulator
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "sim_sdhc.h"
+#include "sim_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define SDMMC_BENCH_LOOP_STEP         SIM_TIME_US(2)
+
+#define SDMMC_BENCH_TIMEOUT           SIM_TIME_MS(3000)
+
+#define SDMMC_BENCH_MAX_BLOCKS        (128U)
+
+#define SDMMC_BENCH_MAX_SAMPLES       (1U << 20)
+
+typedef struct
+{
+    const char* name;
+
+    bool isWrite;
+
+    bool isRandom;
+
+    uint32_t nBlocks;
+
+} SDMMC_BENCH_PATTERN;
+
+static const SDMMC_BENCH_PATTERN sdmmcBenchPatterns[] =
+{
+    { "seq_read_64k",     false, false, 128U },
+    { "seq_write_64k",    true,  false, 128U },
+    { "rand_read_4k",     false, true,  8U   },
+    { "rand_write_4k",    true,  true,  8U   },
+    { "rand_read_512",    false, true,  1U   },
+    { "rand_write_512",   true,  true,  1U   },
+};
+
+typedef struct
+{
+    DRV_HANDLE handle;
+
+    volatile bool isDone;
+
+    volatile SYS_MEDIA_BLOCK_EVENT event;
+
+    DRV_SDMMC_COMMAND_HANDLE commandHandle;
+
+} SDMMC_BENCH_CLIENT;
+
+static SDMMC_BENCH_CLIENT sdmmcBenchClient;
+
+static uint8_t sdmmcBenchBuffer[SDMMC_BENCH_MAX_BLOCKS * 512U] __attribute__((aligned(4)));
+
+static uint32_t sdmmcBenchSamples[SDMMC_BENCH_MAX_SAMPLES];
+
+static uint32_t sdmmcBenchRandom;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void SDMMC_BENCH_EventHandler( SYS_MEDIA_BLOCK_EVENT event, SYS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle, uintptr_t context )
+{
+    SDMMC_BENCH_CLIENT* client = (SDMMC_BENCH_CLIENT*)context;
+
+    if (commandHandle == client->commandHandle)
+    {
+        client->event = event;
+        client->isDone = true;
+    }
+}
+
+static bool SDMMC_BENCH_IsDone( uintptr_t context )
+{
+    return ((SDMMC_BENCH_CLIENT*)context)->isDone;
+}
+
+static bool SDMMC_BENCH_IsReady( uintptr_t context )
+{
+    SDMMC_BENCH_CLIENT* client = (SDMMC_BENCH_CLIENT*)context;
+
+    if (client->handle == DRV_HANDLE_INVALID)
+    {
+        client->handle = DRV_SDMMC_Open(DRV_SDMMC_INDEX_0, DRV_IO_INTENT_READWRITE);
+    }
+    return (client->handle != DRV_HANDLE_INVALID) && DRV_SDMMC_IsAttached(client->handle);
+}
+
+static uint32_t SDMMC_BENCH_Random( void )
+{
+    /* xorshift32 */
+    sdmmcBenchRandom ^= sdmmcBenchRandom << 13;
+    sdmmcBenchRandom ^= sdmmcBenchRandom >> 17;
+    sdmmcBenchRandom ^= sdmmcBenchRandom << 5;
+    return sdmmcBenchRandom;
+}
+
+static int SDMMC_BENCH_SampleCompare( const void* a, const void* b )
+{
+    uint32_t sampleA = *(const uint32_t*)a;
+    uint32_t sampleB = *(const uint32_t*)b;
+
+    return (sampleA > sampleB) - (sampleA < sampleB);
+}
+
+static uint32_t SDMMC_BENCH_Percentile( uint32_t nSamples, uint32_t percent )
+{
+    uint32_t index;
+
+    if (nSamples == 0U)
+    {
+        return 0U;
+    }
+    index = (uint32_t)(((uint64_t)nSamples * percent + 99U) / 100U);
+    return sdmmcBenchSamples[(index > 0U) ? (index - 1U) : 0U];
+}
+
+static void SDMMC_BENCH_PatternRun( const SDMMC_BENCH_PATTERN* pattern, uint32_t numBlocks, SIM_TIME duration )
+{
+    SIM_TIME start = SIM_CLOCK_Now();
+    SIM_TIME requestStart;
+    SIM_TIME elapsed;
+    uint32_t nRequests = 0U;
+    uint32_t nErrors = 0U;
+    uint32_t blockStart = 0U;
+    uint32_t slots = numBlocks / pattern->nBlocks;
+    uint64_t nBlocks = 0U;
+
+    if (pattern->isWrite)
+    {
+        memset(sdmmcBenchBuffer, 0xA5, sizeof(sdmmcBenchBuffer));
+    }
+
+    while (((SIM_CLOCK_Now() - start) < duration) && (nRequests < SDMMC_BENCH_MAX_SAMPLES))
+    {
+        if (pattern->isRandom)
+        {
+            blockStart = (SDMMC_BENCH_Random() % slots) * pattern->nBlocks;
+        }
+
+        requestStart = SIM_CLOCK_Now();
+        sdmmcBenchClient.isDone = false;
+        sdmmcBenchClient.commandHandle = DRV_SDMMC_COMMAND_HANDLE_INVALID;
+        if (pattern->isWrite)
+        {
+            DRV_SDMMC_AsyncWrite(sdmmcBenchClient.handle, &sdmmcBenchClient.commandHandle, sdmmcBenchBuffer, blockStart, pattern->nBlocks);
+        }
+        else
+        {
+            DRV_SDMMC_AsyncRead(sdmmcBenchClient.handle, &sdmmcBenchClient.commandHandle, sdmmcBenchBuffer, blockStart, pattern->nBlocks);
+        }
+        if ((sdmmcBenchClient.commandHandle == DRV_SDMMC_COMMAND_HANDLE_INVALID) ||
+            !SIM_SYSTEM_RunUntil(SDMMC_BENCH_IsDone, (uintptr_t)&sdmmcBenchClient, SDMMC_BENCH_LOOP_STEP, SDMMC_BENCH_TIMEOUT))
+        {
+            fprintf(stderr, "%s: request at block %lu failed to complete\n", pattern->name, (unsigned long)blockStart);
+            nErrors++;
+            break;
+        }
+
+        if (sdmmcBenchClient.event != SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE)
+        {
+            nErrors++;
+        }
+        else
+        {
+            nBlocks += pattern->nBlocks;
+        }
+        sdmmcBenchSamples[nRequests++] = (uint32_t)((SIM_CLOCK_Now() - requestStart) / 1000U);
+
+        blockStart += pattern->nBlocks;
+        if ((blockStart + pattern->nBlocks) > numBlocks)
+        {
+            blockStart = 0U;
+        }
+    }
+
+    elapsed = SIM_CLOCK_Now() - start;
+    qsort(sdmmcBenchSamples, nRequests, sizeof(sdmmcBenchSamples[0]), SDMMC_BENCH_SampleCompare);
+
+    printf("bench name=%s req=%lu blocks=%llu us=%llu iops=%llu kbps=%llu p50=%lu p90=%lu p99=%lu max=%lu err=%lu\n",
+           pattern->name, (unsigned long)nRequests, (unsigned long long)nBlocks,
+           (unsigned long long)(elapsed / 1000U),
+           (unsigned long long)((elapsed > 0U) ? (((uint64_t)nRequests * 1000000000U) / elapsed) : 0U),
+           (unsigned long long)((elapsed > 0U) ? ((nBlocks * 512U * 1000000000U / 1024U) / elapsed) : 0U),
+           (unsigned long)SDMMC_BENCH_Percentile(nRequests, 50U),
+           (unsigned long)SDMMC_BENCH_Percentile(nRequests, 90U),
+           (unsigned long)SDMMC_BENCH_Percentile(nRequests, 99U),
+           (unsigned long)((nRequests > 0U) ? sdmmcBenchSamples[nRequests - 1U] : 0U),
+           (unsigned long)nErrors);
+}
+
+static void SDMMC_BENCH_Usage( const char* program )
+{
+    fprintf(stderr, "usage: %s [--image path] [--size MB] [--profile typical|slow|ideal]\n"
+                    "       [--set key=value]... [--duration ms] [--crc-ppm n] [--seed n] [--trace]\n"
+                    "       [pattern]...\n", program);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    static SIM_SDHC_PROFILE profile;
+    SIM_SDHC_INIT sdhcInit =
+    {
+        .imagePath = "sdmmc_bench.img",
+        .capacity = 1024ULL * 1024U * 1024U,
+        .seed = 1U,
+        .isInserted = true,
+    };
+    const char* profileName = "typical";
+    const char* assignments[16];
+    uint32_t nAssignments = 0U;
+    const char* selected[sizeof(sdmmcBenchPatterns) / sizeof(sdmmcBenchPatterns[0])];
+    uint32_t nSelected = 0U;
+    SIM_TIME duration = SIM_TIME_MS(1000);
+    bool isTraceEnabled = false;
+    SYS_MEDIA_GEOMETRY* geometry;
+    uint32_t numBlocks;
+    uint32_t index;
+    uint32_t patternIndex;
+    int argIndex;
+
+    for (argIndex = 1; argIndex < argc; argIndex++)
+    {
+        const char* arg = argv[argIndex];
+        const char* value = (argIndex + 1 < argc) ? argv[argIndex + 1] : NULL;
+
+        if (strcmp(arg, "--trace") == 0)
+        {
+            isTraceEnabled = true;
+            continue;
+        }
+        if (strncmp(arg, "--", 2) != 0)
+        {
+            if (nSelected == (sizeof(selected) / sizeof(selected[0])))
+            {
+                SDMMC_BENCH_Usage(argv[0]);
+                return 2;
+            }
+            selected[nSelected++] = arg;
+            continue;
+        }
+        if (value == NULL)
+        {
+            SDMMC_BENCH_Usage(argv[0]);
+            return 2;
+        }
+        argIndex++;
+
+        if (strcmp(arg, "--image") == 0)
+        {
+            sdhcInit.imagePath = value;
+        }
+        else if (strcmp(arg, "--size") == 0)
+        {
+            sdhcInit.capacity = strtoull(value, NULL, 0) * 1024U * 1024U;
+        }
+        else if (strcmp(arg, "--profile") == 0)
+        {
+            profileName = value;
+        }
+        else if ((strcmp(arg, "--set") == 0) && (nAssignments < (sizeof(assignments) / sizeof(assignments[0]))))
+        {
+            assignments[nAssignments++] = value;
+        }
+        else if (strcmp(arg, "--duration") == 0)
+        {
+            duration = SIM_TIME_MS(strtoul(value, NULL, 0));
+        }
+        else if (strcmp(arg, "--crc-ppm") == 0)
+        {
+            sdhcInit.dataCrcErrorPpm = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else if (strcmp(arg, "--seed") == 0)
+        {
+            sdhcInit.seed = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else
+        {
+            SDMMC_BENCH_Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (SIM_SDHC_ProfileGet(profileName) == NULL)
+    {
+        fprintf(stderr, "unknown profile %s\n", profileName);
+        return 2;
+    }
+    profile = *SIM_SDHC_ProfileGet(profileName);
+    for (index = 0U; index < nAssignments; index++)
+    {
+        if (!SIM_SDHC_ProfileSet(&profile, assignments[index]))
+        {
+            fprintf(stderr, "unknown profile value %s\n", assignments[index]);
+            return 2;
+        }
+    }
+    sdhcInit.profile = &profile;
+    sdmmcBenchRandom = (sdhcInit.seed != 0U) ? sdhcInit.seed : 1U;
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_SDHC_Initialize(&sdhcInit))
+    {
+        fprintf(stderr, "cannot open %s\n", sdhcInit.imagePath);
+        return 1;
+    }
+    if (isTraceEnabled)
+    {
+        SIM_SDHC_TraceSet(stdout);
+    }
+    SIM_SYSTEM_Initialize();
+
+    sdmmcBenchClient.handle = DRV_HANDLE_INVALID;
+    if (!SIM_SYSTEM_RunUntil(SDMMC_BENCH_IsReady, (uintptr_t)&sdmmcBenchClient, SDMMC_BENCH_LOOP_STEP, SDMMC_BENCH_TIMEOUT))
+    {
+        fprintf(stderr, "the card did not attach\n");
+        SIM_SDHC_Deinitialize();
+        return 1;
+    }
+    DRV_SDMMC_EventHandlerSet(sdmmcBenchClient.handle, (const void*)SDMMC_BENCH_EventHandler, (uintptr_t)&sdmmcBenchClient);
+
+    geometry = DRV_SDMMC_GeometryGet(sdmmcBenchClient.handle);
+    numBlocks = geometry->geometryTable[0].numBlocks;
+    printf("# profile=%s blocks=%lu attach_us=%llu\n", profile.name, (unsigned long)numBlocks,
+           (unsigned long long)(SIM_CLOCK_Now() / 1000U));
+
+    for (patternIndex = 0U; patternIndex < (sizeof(sdmmcBenchPatterns) / sizeof(sdmmcBenchPatterns[0])); patternIndex++)
+    {
+        bool isSelected = (nSelected == 0U);
+
+        for (index = 0U; index < nSelected; index++)
+        {
+            isSelected = isSelected || (strcmp(selected[index], sdmmcBenchPatterns[patternIndex].name) == 0);
+        }
+        if (isSelected)
+        {
+            SDMMC_BENCH_PatternRun(&sdmmcBenchPatterns[patternIndex], numBlocks, duration);
+        }
+    }
+
+    DRV_SDMMC_Close(sdmmcBenchClient.handle);
+    SIM_SDHC_Deinitialize();
+    return 0;
+}
@@ -0,0 +1,302 @@
+/*******************************************************************************
+  SYS_TIME Host Benchmark
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    time_bench.c
+
+  Summary
+    Compares the timer engines of SYS_TIME on the simulated TC0 timer.
+
+  Description
+    The benchmark is built twice, as time_bench for the delta list engine
+    and as time_bench_wheel for the timing wheel engine, both with room for
+    255 timers. For each number of timers it starts that many periodic
+    timers of 1 to 100 ms, runs them for the given virtual time, and then
+    restarts random timers while they all run. It prints one line per
+    number of timers, in the format of the 'B' lines of the target
+    benchmarks:
+
+        bench name=<list|wheel> timers=<n> us=<virtual time>
+              expiries=<callbacks> irqs=<timer interrupts>
+              isr_ns=<host time per interrupt> isr_max_ns=<longest>
+              restart_ns=<host time of a stop and a start> err=<errors>
+
+    The virtual times and the counts are exact. The ns figures are host
+    processor time, so they only compare the engines with each other: the
+    interrupt handler and the start and stop calls run with the timer
+    interrupt disabled, and these are the windows the engine makes longer
+    as timers are added. err= counts the timers that did not expire as
+    many times as their period allows.
+
+    Options:
+        --duration <ms>     virtual time per number of timers (1000)
+        --restarts <n>      restarts timed per number of timers (10000)
+        --seed <n>          seed of the periods and restarts (1)
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "definitions.h"
+#include "sim_clock.h"
+#include "sim_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+static const uint32_t timeBenchTimers[] = { 4U, 16U, 64U, 255U };
+
+typedef struct
+{
+    SYS_TIME_HANDLE handle;
+
+    uint32_t periodMs;
+
+    uint32_t count;
+
+} TIME_BENCH_TIMER;
+
+static TIME_BENCH_TIMER timeBenchTimerObjs[SYS_TIME_MAX_TIMERS];
+
+static uint32_t timeBenchRandom;
+
+static uint32_t timeBenchIrqs;
+
+static uint64_t timeBenchIsrNs;
+
+static uint64_t timeBenchIsrMaxNs;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t TIME_BENCH_RandomGet( uint32_t range )
+{
+    timeBenchRandom = (timeBenchRandom * 1103515245U) + 12345U;
+    return (timeBenchRandom >> 8) % range;
+}
+
+static uint64_t TIME_BENCH_HostNsGet( void )
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+static void TIME_BENCH_Callback( uintptr_t context )
+{
+    ((TIME_BENCH_TIMER*)context)->count++;
+}
+
+/* Runs the virtual time to the next interrupt at a time, so that each one
+   is timed on its own */
+static void TIME_BENCH_Run( SIM_TIME duration )
+{
+    SIM_TIME end = SIM_CLOCK_Now() + duration;
+    SIM_TIME next;
+    uint64_t start;
+    uint64_t elapsed;
+
+    while (SIM_CLOCK_Now() < end)
+    {
+        next = SIM_CLOCK_NextEventGet();
+        if (next > end)
+        {
+            SIM_CLOCK_Advance(end - SIM_CLOCK_Now());
+            break;
+        }
+
+        start = TIME_BENCH_HostNsGet();
+        SIM_CLOCK_Advance((next > SIM_CLOCK_Now()) ? (next - SIM_CLOCK_Now()) : 0U);
+        elapsed = TIME_BENCH_HostNsGet() - start;
+
+        timeBenchIrqs++;
+        timeBenchIsrNs += elapsed;
+        if (elapsed > timeBenchIsrMaxNs)
+        {
+            timeBenchIsrMaxNs = elapsed;
+        }
+    }
+}
+
+static bool TIME_BENCH_Measure( uint32_t nTimers, SIM_TIME duration, uint32_t restarts )
+{
+    SIM_TIME start = SIM_CLOCK_Now();
+    uint64_t expiries = 0U;
+    uint64_t restartNs;
+    uint32_t expected;
+    uint32_t errors = 0U;
+    uint32_t index;
+    uint32_t restart;
+
+    timeBenchIrqs = 0U;
+    timeBenchIsrNs = 0U;
+    timeBenchIsrMaxNs = 0U;
+
+    for (index = 0U; index < nTimers; index++)
+    {
+        TIME_BENCH_TIMER* timer = &timeBenchTimerObjs[index];
+
+        timer->periodMs = 1U + TIME_BENCH_RandomGet(100U);
+        timer->count = 0U;
+        timer->handle = SYS_TIME_CallbackRegisterMS(TIME_BENCH_Callback, (uintptr_t)timer,
+                                                    timer->periodMs, SYS_TIME_PERIODIC);
+        if (timer->handle == SYS_TIME_HANDLE_INVALID)
+        {
+            fprintf(stderr, "cannot create timer %lu\n", (unsigned long)index);
+            return false;
+        }
+    }
+
+    TIME_BENCH_Run(duration);
+
+    for (index = 0U; index < nTimers; index++)
+    {
+        /* The last period may still be pending by a wheel tick */
+        expected = (uint32_t)((SIM_CLOCK_Now() - start) / SIM_TIME_MS(timeBenchTimerObjs[index].periodMs));
+        if ((timeBenchTimerObjs[index].count + 1U) < expected)
+        {
+            errors++;
+        }
+        expiries += timeBenchTimerObjs[index].count;
+    }
+
+    restartNs = TIME_BENCH_HostNsGet();
+    for (restart = 0U; restart < restarts; restart++)
+    {
+        TIME_BENCH_TIMER* timer = &timeBenchTimerObjs[TIME_BENCH_RandomGet(nTimers)];
+
+        (void)SYS_TIME_TimerStop(timer->handle);
+        (void)SYS_TIME_TimerStart(timer->handle);
+    }
+    restartNs = TIME_BENCH_HostNsGet() - restartNs;
+
+    for (index = 0U; index < nTimers; index++)
+    {
+        (void)SYS_TIME_TimerDestroy(timeBenchTimerObjs[index].handle);
+    }
+
+    printf("bench name=%s timers=%lu us=%llu expiries=%llu irqs=%lu isr_ns=%llu isr_max_ns=%llu restart_ns=%llu err=%lu\n",
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+           "wheel",
+#else
+           "list",
+#endif
+           (unsigned long)nTimers, (unsigned long long)(duration / 1000U), (unsigned long long)expiries,
+           (unsigned long)timeBenchIrqs,
+           (unsigned long long)((timeBenchIrqs != 0U) ? (timeBenchIsrNs / timeBenchIrqs) : 0U),
+           (unsigned long long)timeBenchIsrMaxNs,
+           (unsigned long long)((restarts != 0U) ? (restartNs / restarts) : 0U),
+           (unsigned long)errors);
+    fflush(stdout);
+
+    return (errors == 0U);
+}
+
+static void TIME_BENCH_Usage( const char* program )
+{
+    fprintf(stderr, "usage: %s [--duration ms] [--restarts n] [--seed n]\n", program);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    SIM_TIME duration = SIM_TIME_MS(1000);
+    uint32_t restarts = 10000U;
+    bool isFailed = false;
+    uint32_t index;
+    int argIndex;
+
+    timeBenchRandom = 1U;
+
+    for (argIndex = 1; argIndex < argc; argIndex++)
+    {
+        const char* arg = argv[argIndex];
+        const char* value = (argIndex + 1 < argc) ? argv[argIndex + 1] : NULL;
+
+        if (value == NULL)
+        {
+            TIME_BENCH_Usage(argv[0]);
+            return 2;
+        }
+        argIndex++;
+
+        if (strcmp(arg, "--duration") == 0)
+        {
+            duration = SIM_TIME_MS(strtoul(value, NULL, 0));
+        }
+        else if (strcmp(arg, "--restarts") == 0)
+        {
+            restarts = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else if (strcmp(arg, "--seed") == 0)
+        {
+            timeBenchRandom = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else
+        {
+            TIME_BENCH_Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    /* Only the timer runs: the SDMMC driver and its timers are not polled */
+    SIM_CLOCK_Initialize();
+    SIM_SYSTEM_Initialize();
+
+    for (index = 0U; index < (sizeof(timeBenchTimers) / sizeof(timeBenchTimers[0])); index++)
+    {
+        if (timeBenchTimers[index] <= SYS_TIME_MAX_TIMERS)
+        {
+            isFailed |= !TIME_BENCH_Measure(timeBenchTimers[index], duration, restarts);
+        }
+    }
+
+    return isFailed ? 1 : 0;
+}
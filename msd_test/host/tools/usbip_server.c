@@ -0,0 +1,272 @@
+/*******************************************************************************
+  USB/IP Server of the Host Build
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    usbip_server.c
+
+  Summary
+    Exports the simulated USB device to the USB/IP client of Linux.
+
+  Description
+    The server runs the USB device stack of the firmware on the simulated
+    USB peripheral, with the simulated SD card behind the MSD function,
+    enumerates it and serves it with SIM_USBIP until it is interrupted:
+
+        usbip_server --image card.img --size 256 &
+        sudo modprobe vhci-hcd
+        sudo usbip attach -r 127.0.0.1 -b 1-1
+
+    The kernel then binds usb-storage and cdc_acm to the device, so dd, fio
+    or a file system run against the firmware. "usbip detach -p <port>"
+    releases it, and the server waits for the next attach.
+
+    Options:
+        --image <path>      image file (usbip_server.img), kept on exit
+        --size <MB>         card size, for a new image (256)
+        --profile <name>    typical, slow or ideal (typical)
+        --address <ip>      address to listen on (127.0.0.1)
+        --port <n>          TCP port (3240)
+        --record <path>     writes the CBWs of the client to a trace that
+                            msd_bench replays
+        --trace             prints the transfers on the simulated bus
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_sdhc.h"
+#include "sim_system.h"
+#include "sim_usb.h"
+#include "sim_usb_host.h"
+#include "sim_usb_system.h"
+#include "sim_usbip.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define USBIP_SERVER_LOOP_STEP        SIM_TIME_US(2)
+
+#define USBIP_SERVER_TIMEOUT          SIM_TIME_MS(3000)
+
+static volatile sig_atomic_t usbipServerIsStopped;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void USBIP_SERVER_SignalHandler( int signalNumber )
+{
+    (void)signalNumber;
+    usbipServerIsStopped = 1;
+}
+
+static bool USBIP_SERVER_IsConfigured( uintptr_t context )
+{
+    (void)context;
+    return SIM_USB_SYSTEM_IsConfigured();
+}
+
+static void USBIP_SERVER_Usage( const char* program )
+{
+    fprintf(stderr, "usage: %s [--image path] [--size MB] [--profile typical|slow|ideal]\n"
+                    "       [--address ip] [--port n] [--record path] [--trace]\n", program);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    SIM_SDHC_INIT sdhcInit =
+    {
+        .imagePath = "usbip_server.img",
+        .capacity = 256ULL * 1024U * 1024U,
+        .seed = 1U,
+        .isInserted = true,
+    };
+    SIM_USBIP_INIT usbipInit =
+    {
+        .address = "127.0.0.1",
+        .port = SIM_USBIP_PORT_DEFAULT,
+        .step = USBIP_SERVER_LOOP_STEP,
+    };
+    const char* profileName = "typical";
+    const char* recordPath = NULL;
+    FILE* record = NULL;
+    SIM_USBIP_STATISTICS statistics;
+    bool isTraceEnabled = false;
+    int argIndex;
+
+    for (argIndex = 1; argIndex < argc; argIndex++)
+    {
+        const char* arg = argv[argIndex];
+        const char* value = (argIndex + 1 < argc) ? argv[argIndex + 1] : NULL;
+
+        if (strcmp(arg, "--trace") == 0)
+        {
+            isTraceEnabled = true;
+            continue;
+        }
+        if (value == NULL)
+        {
+            USBIP_SERVER_Usage(argv[0]);
+            return 2;
+        }
+        argIndex++;
+
+        if (strcmp(arg, "--image") == 0)
+        {
+            sdhcInit.imagePath = value;
+        }
+        else if (strcmp(arg, "--size") == 0)
+        {
+            sdhcInit.capacity = strtoull(value, NULL, 0) * 1024U * 1024U;
+        }
+        else if (strcmp(arg, "--profile") == 0)
+        {
+            profileName = value;
+        }
+        else if (strcmp(arg, "--address") == 0)
+        {
+            usbipInit.address = value;
+        }
+        else if (strcmp(arg, "--port") == 0)
+        {
+            usbipInit.port = (uint16_t)strtoul(value, NULL, 0);
+        }
+        else if (strcmp(arg, "--record") == 0)
+        {
+            recordPath = value;
+        }
+        else
+        {
+            USBIP_SERVER_Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    sdhcInit.profile = SIM_SDHC_ProfileGet(profileName);
+    if (sdhcInit.profile == NULL)
+    {
+        fprintf(stderr, "unknown profile %s\n", profileName);
+        return 2;
+    }
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_SDHC_Initialize(&sdhcInit))
+    {
+        fprintf(stderr, "cannot open %s\n", sdhcInit.imagePath);
+        return 1;
+    }
+    if (!SIM_USB_SYSTEM_Initialize())
+    {
+        fprintf(stderr, "cannot map the USB registers\n");
+        SIM_SDHC_Deinitialize();
+        return 1;
+    }
+    SIM_USB_HOST_Initialize(USBIP_SERVER_LOOP_STEP, USBIP_SERVER_TIMEOUT);
+    if (!SIM_USB_HOST_Enumerate() ||
+        !SIM_SYSTEM_RunUntil(USBIP_SERVER_IsConfigured, 0U, USBIP_SERVER_LOOP_STEP, USBIP_SERVER_TIMEOUT))
+    {
+        fprintf(stderr, "the device did not enumerate\n");
+        SIM_SDHC_Deinitialize();
+        return 1;
+    }
+    if (!SIM_USBIP_Initialize(&usbipInit))
+    {
+        fprintf(stderr, "cannot listen on %s:%u\n", usbipInit.address, (unsigned)usbipInit.port);
+        SIM_SDHC_Deinitialize();
+        return 1;
+    }
+    if (isTraceEnabled)
+    {
+        SIM_USB_TraceSet(stdout);
+    }
+    if (recordPath != NULL)
+    {
+        record = fopen(recordPath, "w");
+        if (record == NULL)
+        {
+            fprintf(stderr, "cannot create %s\n", recordPath);
+            SIM_USBIP_Deinitialize();
+            SIM_SDHC_Deinitialize();
+            return 1;
+        }
+        /* Whole lines, should the server be killed */
+        (void)setvbuf(record, NULL, _IOLBF, 0U);
+        fprintf(record, "# msd_bench trace: recorded by usbip_server\n"
+                        "# <idle_us> <lun> <in|out|none> <data_length> <cdb>\n");
+        SIM_USBIP_RecordSet(record);
+    }
+
+    (void)signal(SIGINT, USBIP_SERVER_SignalHandler);
+    (void)signal(SIGTERM, USBIP_SERVER_SignalHandler);
+    printf("# listening address=%s port=%u busid=%s image=%s\n", usbipInit.address,
+           (unsigned)SIM_USBIP_PortGet(), SIM_USBIP_BUS_ID, sdhcInit.imagePath);
+    fflush(stdout);
+
+    while (usbipServerIsStopped == 0)
+    {
+        SIM_USBIP_Tasks();
+    }
+
+    SIM_USB_TraceSet(NULL);
+    SIM_USBIP_RecordSet(NULL);
+    if (record != NULL)
+    {
+        (void)fclose(record);
+    }
+    SIM_USBIP_StatisticsGet(&statistics);
+    SIM_USBIP_Deinitialize();
+    SIM_SDHC_Deinitialize();
+
+    printf("# connections=%lu imports=%lu submits=%lu unlinks=%lu errors=%lu in_bytes=%llu out_bytes=%llu virtual_ms=%llu\n",
+           (unsigned long)statistics.connections, (unsigned long)statistics.imports,
+           (unsigned long)statistics.submits, (unsigned long)statistics.unlinks,
+           (unsigned long)statistics.errors, (unsigned long long)statistics.inBytes,
+           (unsigned long long)statistics.outBytes, (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return 0;
+}
@@ -77,6 +77,7 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 */
 
 APP_DATA appData;
+extern CDC_DATA cdcData;
 
 
 // *****************************************************************************
@@ -110,12 +111,22 @@ void APP_USBDeviceEventHandler( USB_DEVICE_EVENT event, void * pEventData, uintp
         case USB_DEVICE_EVENT_RESET:
         case USB_DEVICE_EVENT_DECONFIGURED:
             appData.isConfigured = false;
+            /* The SD card is free for the FAT service */
+            SYS_FAT_HostDetach();
             /* Device was reset or de-configured. Update LED status */
             LED_R_Clear();
             break;
 
         case USB_DEVICE_EVENT_CONFIGURED:
             appData.isConfigured = true;
+            /* The SD card belongs to the host until it ejects it */
+            SYS_FAT_HostAttach();
+
+            /* Register the CDC Device application event handler here.
+             * Note how the cdcData object pointer is passed as the
+             * user data */
+            USB_DEVICE_CDC_EventHandlerSet(USB_DEVICE_CDC_INDEX_0, USBDeviceCDCEventHandler, (uintptr_t)&cdcData);
+
             /* Device is configured. Update LED status */
             LED_R_Set();
             break;
@@ -133,6 +144,7 @@ void APP_USBDeviceEventHandler( USB_DEVICE_EVENT event, void * pEventData, uintp
 
         case USB_DEVICE_EVENT_POWER_REMOVED:
             appData.isConfigured = false;
+            SYS_FAT_HostDetach();
             /* VBUS is not detected. Detach the device */
             USB_DEVICE_Detach(appDataObject->usbDeviceHandle);
             LED_R_Clear();
@@ -223,7 +235,8 @@ void APP_Tasks ( void )
 
             /* The MSD Device is maintained completely by the MSD function
              * driver and does not require application intervention. So there
-             * is nothing related to MSD Device to do here. */
+             * is nothing related to MSD Device to do here. The CDC function
+             * is serviced by CDC_Tasks. */
             break;
 
         /* The default state should never be executed. */
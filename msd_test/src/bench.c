@@ -0,0 +1,687 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    bench.c
+
+  Summary:
+    This file contains the source code for the SD card benchmark application.
+
+  Description:
+    This file contains the source code for the SD card benchmark application.
+    It drives the real SDMMC driver, SDHC0 PLIB and card through a client of
+    its own, one request at a time, so the figures include the driver state
+    machine, the ADMA transfers and the busy time of the card.
+
+    The workloads are tables of requests replayed in a loop, so every run of a
+    firmware version issues the same requests and the results of two versions
+    can be compared. The random addresses come from a xorshift generator with
+    a fixed seed, so two runs on the same card access the same blocks.
+
+    The log file workload mounts the card through the FAT service, creates
+    BENCHnnn.LOG with the next free number and appends the buffer to it. Only
+    the appends are timed: the mount, the creation and the close are not part
+    of logging at speed.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "system/memory/sys_memory.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds application data
+
+  Description:
+    This structure holds the application's data.
+
+  Remarks:
+    This structure should be initialized by the BENCH_Initialize function.
+
+    Application strings and buffers are be defined outside this structure.
+*/
+
+BENCH_DATA benchData;
+
+static uint8_t benchDataBuffer[BENCH_BUFFER_BLOCKS * BENCH_BLOCK_SIZE] CACHE_ALIGN;
+SYS_MEMORY_OBJECT_REGISTER(benchDataBuffer);
+
+static const BENCH_STEP benchSequentialRead[] =
+{
+    { false, BENCH_ADDRESS_SEQUENTIAL,   BENCH_BUFFER_BLOCKS },
+};
+
+static const BENCH_STEP benchRandomRead1[] =
+{
+    { false, BENCH_ADDRESS_RANDOM,       1U },
+};
+
+static const BENCH_STEP benchRandomRead8[] =
+{
+    { false, BENCH_ADDRESS_RANDOM,       8U },
+};
+
+static const BENCH_STEP benchMetadataRead[] =
+{
+    { false, BENCH_ADDRESS_METADATA,     1U },
+    { false, BENCH_ADDRESS_METADATA,     1U },
+    { false, BENCH_ADDRESS_METADATA,     1U },
+    { false, BENCH_ADDRESS_RANDOM,       8U },
+};
+
+/* Appended to the log file, the address comes from the FAT service */
+static const BENCH_STEP benchFileWrite[] =
+{
+    { true,  BENCH_ADDRESS_SEQUENTIAL,   BENCH_BUFFER_BLOCKS },
+};
+
+#if defined(BENCH_WRITE_ENABLE)
+static const BENCH_STEP benchSequentialWrite[] =
+{
+    { true,  BENCH_ADDRESS_SEQUENTIAL,   BENCH_BUFFER_BLOCKS },
+};
+
+static const BENCH_STEP benchCopy[] =
+{
+    { false, BENCH_ADDRESS_SEQUENTIAL,   BENCH_BUFFER_BLOCKS },
+    { true,  BENCH_ADDRESS_SEQUENTIAL_2, BENCH_BUFFER_BLOCKS },
+    { false, BENCH_ADDRESS_SEQUENTIAL,   BENCH_BUFFER_BLOCKS },
+    { true,  BENCH_ADDRESS_SEQUENTIAL_2, BENCH_BUFFER_BLOCKS },
+    { false, BENCH_ADDRESS_SEQUENTIAL,   BENCH_BUFFER_BLOCKS },
+    { true,  BENCH_ADDRESS_SEQUENTIAL_2, BENCH_BUFFER_BLOCKS },
+    { false, BENCH_ADDRESS_SEQUENTIAL,   BENCH_BUFFER_BLOCKS },
+    { true,  BENCH_ADDRESS_SEQUENTIAL_2, BENCH_BUFFER_BLOCKS },
+    { true,  BENCH_ADDRESS_METADATA,     1U },
+};
+
+static const BENCH_STEP benchMetadataWrite[] =
+{
+    { false, BENCH_ADDRESS_METADATA,     1U },
+    { true,  BENCH_ADDRESS_METADATA,     1U },
+    { true,  BENCH_ADDRESS_RANDOM,       8U },
+    { true,  BENCH_ADDRESS_METADATA,     1U },
+    { true,  BENCH_ADDRESS_METADATA,     1U },
+};
+
+static const BENCH_STEP benchRandomWrite8[] =
+{
+    { true,  BENCH_ADDRESS_RANDOM,       8U },
+};
+#endif
+
+#define BENCH_WORKLOAD(name, steps) { name, steps, sizeof(steps) / sizeof(steps[0]) }
+
+/* Name and requests of each workload, in BENCH_PATTERN order */
+static const struct
+{
+    const char * name;
+    const BENCH_STEP * steps;
+    uint32_t stepCount;
+
+} benchPatterns[BENCH_PATTERN_COUNT] =
+{
+    BENCH_WORKLOAD("seqrd16", benchSequentialRead),
+    BENCH_WORKLOAD("rndrd1",  benchRandomRead1),
+    BENCH_WORKLOAD("rndrd8",  benchRandomRead8),
+    BENCH_WORKLOAD("fatrd",   benchMetadataRead),
+    BENCH_WORKLOAD("logwr16", benchFileWrite),
+#if defined(BENCH_WRITE_ENABLE)
+    BENCH_WORKLOAD("seqwr16", benchSequentialWrite),
+    BENCH_WORKLOAD("copy",    benchCopy),
+    BENCH_WORKLOAD("fatwr",   benchMetadataWrite),
+    BENCH_WORKLOAD("rndwr8",  benchRandomWrite8),
+#endif
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Callback Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Called by DRV_SDMMC_Tasks when the request in flight completes */
+static void BENCH_SDMMCEventHandler ( SYS_MEDIA_BLOCK_EVENT event, SYS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle, uintptr_t context )
+{
+    (void) commandHandle;
+    (void) context;
+
+    benchData.commandFailed = (event != (SYS_MEDIA_BLOCK_EVENT)DRV_SDMMC_EVENT_COMMAND_COMPLETE);
+    benchData.commandCompleted = true;
+}
+
+/* Called by SYS_FAT_Tasks when the request of the log file workload
+   completes */
+static void BENCH_FATEventHandler ( SYS_FAT_EVENT event, uintptr_t context )
+{
+    (void) context;
+
+    benchData.commandFailed = (event != SYS_FAT_EVENT_COMPLETE);
+    benchData.commandCompleted = true;
+
+    /* The FAT service runs after the benchmark */
+    SYS_SCHED_EventPost(SYS_SCHED_EVENT_BENCH);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t BENCH_RandomGet ( void )
+{
+    uint32_t x = benchData.randomState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    benchData.randomState = x;
+
+    return x;
+}
+
+/* Returns the first block of a request of the workload in progress */
+static uint32_t BENCH_BlockStartGet ( const BENCH_STEP * step )
+{
+    uint32_t stream = (step->address == BENCH_ADDRESS_SEQUENTIAL_2) ? 1U : 0U;
+    uint32_t metadataBlocks;
+    uint32_t blockStart;
+
+    switch (step->address)
+    {
+        case BENCH_ADDRESS_RANDOM:
+        {
+            blockStart = (BENCH_RandomGet() % (benchData.numBlocks / step->blocks)) * step->blocks;
+            break;
+        }
+
+        case BENCH_ADDRESS_METADATA:
+        {
+            metadataBlocks = (benchData.numBlocks < BENCH_METADATA_BLOCKS) ? benchData.numBlocks : BENCH_METADATA_BLOCKS;
+            blockStart = BENCH_RandomGet() % (metadataBlocks - step->blocks + 1U);
+            break;
+        }
+
+        default:
+        {
+            if ((benchData.nextBlock[stream] + step->blocks) > benchData.numBlocks)
+            {
+                benchData.nextBlock[stream] = 0U;
+            }
+            blockStart = benchData.nextBlock[stream];
+            benchData.nextBlock[stream] += step->blocks;
+            break;
+        }
+    }
+
+    return blockStart;
+}
+
+/* Adds a completed request to the latency histogram */
+static void BENCH_LatencyRecord ( BENCH_RESULT * result, uint32_t latencyUS )
+{
+    uint32_t bucket = 0U;
+
+    while ((bucket < (BENCH_LATENCY_BUCKETS - 1U)) && ((latencyUS >> bucket) != 0U))
+    {
+        bucket++;
+    }
+
+    result->latencyHistogram[bucket]++;
+
+    if (latencyUS > result->latencyMaxUS)
+    {
+        result->latencyMaxUS = latencyUS;
+    }
+}
+
+/* Records the time the pattern has run for */
+static void BENCH_ElapsedRecord ( void )
+{
+    benchData.results[benchData.pattern].elapsedUS =
+            SYS_TIME_CountToUS(SYS_TIME_CounterGet() - benchData.patternStartCount);
+}
+
+/* Ends the pattern in progress and moves to the next one */
+static void BENCH_PatternEnd ( void )
+{
+    /* The log file workload stops the time at its last append */
+    if (benchData.pattern != (uint32_t)BENCH_PATTERN_FILE_WRITE)
+    {
+        BENCH_ElapsedRecord();
+    }
+
+    benchData.pattern++;
+    benchData.state = (benchData.pattern < (uint32_t)BENCH_PATTERN_COUNT) ?
+            BENCH_STATE_PATTERN_START : BENCH_STATE_IDLE;
+}
+
+/* Appends the buffer to the log file, or closes the file once the time is
+   up or the file is full */
+static void BENCH_FileWriteSubmit ( bool timeUp )
+{
+    bool full = ((SYS_FAT_FileSizeGet() + sizeof(benchDataBuffer)) > BENCH_FILE_SIZE);
+
+    benchData.requestBlocks = BENCH_BUFFER_BLOCKS;
+    benchData.commandCompleted = false;
+    benchData.requestStartCount = SYS_TIME_CounterGet();
+
+    if (!timeUp && !full)
+    {
+        if (SYS_FAT_FileWrite(benchDataBuffer, sizeof(benchDataBuffer)))
+        {
+            benchData.state = BENCH_STATE_REQUEST_WAIT;
+            return;
+        }
+
+        benchData.results[benchData.pattern].errors++;
+    }
+
+    BENCH_ElapsedRecord();
+    benchData.fileStep = BENCH_FILE_CLOSE;
+    benchData.state = BENCH_STATE_FILE_SUBMIT;
+}
+
+/* Moves the log file workload past a request that failed. The card is given
+   back to the host once it was taken. */
+static void BENCH_FileFailed ( void )
+{
+    benchData.results[benchData.pattern].errors++;
+
+    if ((benchData.fileStep == BENCH_FILE_MOUNT) || (benchData.fileStep == BENCH_FILE_UNMOUNT))
+    {
+        BENCH_PatternEnd();
+    }
+    else
+    {
+        benchData.fileStep = BENCH_FILE_UNMOUNT;
+        benchData.state = BENCH_STATE_FILE_SUBMIT;
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void BENCH_Initialize ( void )
+
+  Remarks:
+    See prototype in bench.h.
+ */
+
+void BENCH_Initialize ( void )
+{
+    (void) memset(&benchData, 0, sizeof(benchData));
+
+    /* Place the App state machine in its initial state. */
+    benchData.state = BENCH_STATE_INIT;
+    benchData.sdmmcHandle = DRV_HANDLE_INVALID;
+    benchData.commandHandle = DRV_SDMMC_COMMAND_HANDLE_INVALID;
+    benchData.pattern = (uint32_t)BENCH_PATTERN_COUNT;
+}
+
+
+/******************************************************************************
+  Function:
+    void BENCH_Tasks ( void )
+
+  Remarks:
+    See prototype in bench.h.
+ */
+
+void BENCH_Tasks ( void )
+{
+    BENCH_RESULT * result;
+    uint32_t latencyUS;
+
+    switch ( benchData.state )
+    {
+        case BENCH_STATE_INIT:
+        {
+            benchData.sdmmcHandle = DRV_SDMMC_Open(DRV_SDMMC_INDEX_0, DRV_IO_INTENT_READWRITE);
+            if (benchData.sdmmcHandle != DRV_HANDLE_INVALID)
+            {
+                DRV_SDMMC_EventHandlerSet(benchData.sdmmcHandle, (const void*)BENCH_SDMMCEventHandler, 0U);
+                SYS_FAT_EventHandlerSet(BENCH_FATEventHandler, 0U);
+                benchData.state = BENCH_STATE_IDLE;
+            }
+            break;
+        }
+
+        case BENCH_STATE_IDLE:
+        {
+            break;
+        }
+
+        case BENCH_STATE_PATTERN_START:
+        {
+            SYS_MEDIA_GEOMETRY * geometry = DRV_SDMMC_GeometryGet(benchData.sdmmcHandle);
+
+            benchData.numBlocks = 0U;
+            if (DRV_SDMMC_IsAttached(benchData.sdmmcHandle) && (geometry != NULL))
+            {
+                benchData.numBlocks = geometry->geometryTable[SYS_MEDIA_GEOMETRY_TABLE_READ_ENTRY].numBlocks;
+            }
+
+            benchData.step = 0U;
+            benchData.nextBlock[0] = 0U;
+            benchData.nextBlock[1] = benchData.numBlocks / 2U;
+            benchData.randomState = BENCH_RANDOM_SEED;
+            benchData.patternStartCount = SYS_TIME_CounterGet();
+
+            if (benchData.numBlocks < BENCH_BUFFER_BLOCKS)
+            {
+                /* No card: the pattern ends with one error */
+                benchData.results[benchData.pattern].errors = 1U;
+                BENCH_PatternEnd();
+                break;
+            }
+
+            if (benchData.pattern == (uint32_t)BENCH_PATTERN_FILE_WRITE)
+            {
+                benchData.fileStep = BENCH_FILE_MOUNT;
+                benchData.state = BENCH_STATE_FILE_SUBMIT;
+                break;
+            }
+
+            benchData.state = BENCH_STATE_REQUEST_SUBMIT;
+            break;
+        }
+
+        case BENCH_STATE_REQUEST_SUBMIT:
+        {
+            const BENCH_STEP * step = &benchPatterns[benchData.pattern].steps[benchData.step];
+            bool timeUp = ((SYS_TIME_CounterGet() - benchData.patternStartCount) >= SYS_TIME_MSToCount(BENCH_DURATION_MS));
+            uint32_t blockStart;
+
+            if (benchData.pattern == (uint32_t)BENCH_PATTERN_FILE_WRITE)
+            {
+                BENCH_FileWriteSubmit(timeUp);
+                break;
+            }
+
+            if (timeUp)
+            {
+                BENCH_PatternEnd();
+                break;
+            }
+
+            blockStart = BENCH_BlockStartGet(step);
+            benchData.requestBlocks = step->blocks;
+            benchData.commandCompleted = false;
+            benchData.requestStartCount = SYS_TIME_CounterGet();
+
+            if (step->isWrite)
+            {
+                DRV_SDMMC_AsyncWrite(benchData.sdmmcHandle, &benchData.commandHandle,
+                        benchDataBuffer, blockStart, step->blocks);
+            }
+            else
+            {
+                DRV_SDMMC_AsyncRead(benchData.sdmmcHandle, &benchData.commandHandle,
+                        benchDataBuffer, blockStart, step->blocks);
+            }
+
+            if (benchData.commandHandle == DRV_SDMMC_COMMAND_HANDLE_INVALID)
+            {
+                /* The card went away or the queue is full. Retried on the
+                 * next pass until the pattern time is up. */
+                benchData.results[benchData.pattern].errors++;
+                break;
+            }
+
+            benchData.step = (benchData.step + 1U) % benchPatterns[benchData.pattern].stepCount;
+            benchData.state = BENCH_STATE_REQUEST_WAIT;
+            break;
+        }
+
+        case BENCH_STATE_REQUEST_WAIT:
+        {
+            if (!benchData.commandCompleted)
+            {
+                break;
+            }
+
+            latencyUS = SYS_TIME_CountToUS(SYS_TIME_CounterGet() - benchData.requestStartCount);
+            result = &benchData.results[benchData.pattern];
+
+            result->requests++;
+            if (benchData.commandFailed)
+            {
+                result->errors++;
+            }
+            else
+            {
+                result->blocks += benchData.requestBlocks;
+            }
+            BENCH_LatencyRecord(result, latencyUS);
+
+            benchData.state = BENCH_STATE_REQUEST_SUBMIT;
+            break;
+        }
+
+        case BENCH_STATE_FILE_SUBMIT:
+        {
+            char fileName[16];
+            bool submitted;
+
+            benchData.commandCompleted = false;
+
+            switch (benchData.fileStep)
+            {
+                case BENCH_FILE_MOUNT:
+                {
+                    submitted = SYS_FAT_Mount();
+                    break;
+                }
+
+                case BENCH_FILE_CREATE:
+                {
+                    (void) snprintf(fileName, sizeof(fileName), "BENCH%03lu.LOG", (unsigned long)benchData.fileNumber);
+                    submitted = SYS_FAT_FileCreate(fileName, BENCH_FILE_SIZE);
+                    break;
+                }
+
+                case BENCH_FILE_CLOSE:
+                {
+                    submitted = SYS_FAT_FileClose();
+                    break;
+                }
+
+                default:
+                {
+                    submitted = SYS_FAT_Unmount();
+                    break;
+                }
+            }
+
+            if (!submitted)
+            {
+                /* The host has the card, or the service is not ready */
+                BENCH_FileFailed();
+                break;
+            }
+
+            benchData.state = BENCH_STATE_FILE_WAIT;
+            break;
+        }
+
+        case BENCH_STATE_FILE_WAIT:
+        {
+            if (!benchData.commandCompleted)
+            {
+                break;
+            }
+
+            if (benchData.commandFailed)
+            {
+                if ((benchData.fileStep == BENCH_FILE_CREATE) &&
+                    (SYS_FAT_ErrorGet() == SYS_FAT_ERROR_EXISTS) && (benchData.fileNumber < 999U))
+                {
+                    /* Left by an earlier run */
+                    benchData.fileNumber++;
+                    benchData.state = BENCH_STATE_FILE_SUBMIT;
+                }
+                else
+                {
+                    BENCH_FileFailed();
+                }
+                break;
+            }
+
+            switch (benchData.fileStep)
+            {
+                case BENCH_FILE_MOUNT:
+                {
+                    benchData.fileStep = BENCH_FILE_CREATE;
+                    benchData.state = BENCH_STATE_FILE_SUBMIT;
+                    break;
+                }
+
+                case BENCH_FILE_CREATE:
+                {
+                    benchData.fileNumber++;
+                    benchData.patternStartCount = SYS_TIME_CounterGet();
+                    benchData.state = BENCH_STATE_REQUEST_SUBMIT;
+                    break;
+                }
+
+                case BENCH_FILE_CLOSE:
+                {
+                    benchData.fileStep = BENCH_FILE_UNMOUNT;
+                    benchData.state = BENCH_STATE_FILE_SUBMIT;
+                    break;
+                }
+
+                default:
+                {
+                    BENCH_PatternEnd();
+                    break;
+                }
+            }
+            break;
+        }
+
+        /* The default state should never be executed. */
+        default:
+        {
+            break;
+        }
+    }
+}
+
+bool BENCH_IsBusy ( void )
+{
+    return ((benchData.state == BENCH_STATE_INIT) ||
+            (benchData.state == BENCH_STATE_PATTERN_START) ||
+            (benchData.state == BENCH_STATE_REQUEST_SUBMIT) ||
+            (benchData.state == BENCH_STATE_FILE_SUBMIT));
+}
+
+bool BENCH_Start ( void )
+{
+    if (benchData.state != BENCH_STATE_IDLE)
+    {
+        return false;
+    }
+
+    (void) memset(benchData.results, 0, sizeof(benchData.results));
+    benchData.pattern = 0U;
+    benchData.state = BENCH_STATE_PATTERN_START;
+
+    SYS_SCHED_EventPost(SYS_SCHED_EVENT_BENCH);
+
+    return true;
+}
+
+bool BENCH_IsRunning ( void )
+{
+    return (benchData.pattern < (uint32_t)BENCH_PATTERN_COUNT);
+}
+
+const char * BENCH_PatternNameGet ( BENCH_PATTERN pattern )
+{
+    if ((uint32_t)pattern >= (uint32_t)BENCH_PATTERN_COUNT)
+    {
+        return NULL;
+    }
+
+    return benchPatterns[pattern].name;
+}
+
+bool BENCH_ResultGet ( BENCH_PATTERN pattern, BENCH_RESULT * result )
+{
+    if (((uint32_t)pattern >= (uint32_t)BENCH_PATTERN_COUNT) || (result == NULL))
+    {
+        return false;
+    }
+
+    *result = benchData.results[pattern];
+
+    return true;
+}
+
+uint32_t BENCH_LatencyPercentileGet ( const BENCH_RESULT * result, uint32_t percent )
+{
+    uint32_t completed = 0U;
+    uint32_t target;
+    uint32_t count = 0U;
+    uint32_t bucket;
+
+    for (bucket = 0U; bucket < BENCH_LATENCY_BUCKETS; bucket++)
+    {
+        completed += result->latencyHistogram[bucket];
+    }
+
+    if (completed == 0U)
+    {
+        return 0U;
+    }
+
+    /* Rank of the request, rounded up */
+    target = (uint32_t)((((uint64_t)completed * percent) + 99U) / 100U);
+
+    for (bucket = 0U; bucket < (BENCH_LATENCY_BUCKETS - 1U); bucket++)
+    {
+        count += result->latencyHistogram[bucket];
+        if (count >= target)
+        {
+            break;
+        }
+    }
+
+    /* Upper bound of the bucket, which the largest latency may undercut */
+    if ((bucket < (BENCH_LATENCY_BUCKETS - 1U)) && ((1UL << bucket) < result->latencyMaxUS))
+    {
+        return (uint32_t)(1UL << bucket);
+    }
+
+    return result->latencyMaxUS;
+}
+
+
+/*******************************************************************************
+ End of File
+ */
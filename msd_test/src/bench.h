@@ -0,0 +1,496 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    bench.h
+
+  Summary:
+    This header file provides prototypes and definitions for the SD card
+    benchmark application.
+
+  Description:
+    This header file provides function prototypes and data type definitions for
+    the SD card benchmark application. The application opens its own client of
+    the SDMMC driver and, when started, replays each workload for
+    BENCH_DURATION_MS. A workload is a short sequence of requests modelled on
+    the media requests the MSD function makes for a typical host access,
+    repeated until the time is up. The application measures the requests per
+    second, the throughput and the latency distribution of every workload.
+    The MSD function keeps its client of the driver, so a benchmark run while
+    the host accesses the card measures the share the card gives to each.
+
+    The log file workload writes through the FAT service instead, which only
+    gets the card once the host has ejected it. Its figures compare with the
+    sequential writes of the same size on the raw card.
+*******************************************************************************/
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "configuration.h"
+#include "driver/sdmmc/drv_sdmmc.h"
+#include "system/fat/sys_fat.h"
+#include "system/time/sys_time.h"
+#include "system/sched/sys_sched.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Time each pattern runs for, in milliseconds */
+#ifndef BENCH_DURATION_MS
+    #define BENCH_DURATION_MS 2000U
+#endif
+
+/* Seed of the random block addresses. A fixed seed gives every run the same
+   sequence of addresses. */
+#ifndef BENCH_RANDOM_SEED
+    #define BENCH_RANDOM_SEED 0x2545F491U
+#endif
+
+/* Size of a card block in bytes */
+#define BENCH_BLOCK_SIZE 512U
+
+/* Largest request of the workloads, in blocks */
+#define BENCH_BUFFER_BLOCKS 16U
+
+/* Blocks at the start of the card where the metadata requests fall. Covers
+   the partition table, the FATs and the root directory of a FAT32 card. */
+#ifndef BENCH_METADATA_BLOCKS
+    #define BENCH_METADATA_BLOCKS 8192U
+#endif
+
+/* Bytes allocated to the file of the log file workload. The workload stops
+   early once the file is full. */
+#ifndef BENCH_FILE_SIZE
+    #define BENCH_FILE_SIZE 0x4000000U
+#endif
+
+/* Buckets of the latency histogram. Bucket n counts the requests that took
+   less than 2^n microseconds, the last bucket all the longer ones. */
+#define BENCH_LATENCY_BUCKETS 20U
+
+// *****************************************************************************
+/* Benchmark workloads
+
+  Summary:
+    Workloads replayed by the benchmark, in the order they run.
+
+  Remarks:
+    The workloads that write overwrite the card. They are only built with
+    BENCH_WRITE_ENABLE.
+*/
+
+typedef enum
+{
+    /* Consecutive reads of BENCH_BUFFER_BLOCKS blocks */
+    BENCH_PATTERN_SEQUENTIAL_READ = 0,
+
+    /* Reads of one block at random addresses */
+    BENCH_PATTERN_RANDOM_READ_1,
+
+    /* Reads of 8 blocks at random addresses aligned to 8 blocks */
+    BENCH_PATTERN_RANDOM_READ_8,
+
+    /* Directory listing and file open: FAT and directory block reads mixed
+       with data reads */
+    BENCH_PATTERN_METADATA_READ,
+
+    /* Appends of BENCH_BUFFER_BLOCKS blocks to a new log file, through the
+       FAT service. Fails with one error unless the host has ejected the card
+       or is not attached. */
+    BENCH_PATTERN_FILE_WRITE,
+
+#if defined(BENCH_WRITE_ENABLE)
+    /* Consecutive writes of BENCH_BUFFER_BLOCKS blocks */
+    BENCH_PATTERN_SEQUENTIAL_WRITE,
+
+    /* File copy on the card: sequential reads of the source, sequential
+       writes of the destination and a FAT update every 4 data writes */
+    BENCH_PATTERN_COPY,
+
+    /* Small file creation: FAT and directory block updates around one data
+       write of 8 blocks */
+    BENCH_PATTERN_METADATA_WRITE,
+
+    /* Writes of 8 blocks at random addresses aligned to 8 blocks */
+    BENCH_PATTERN_RANDOM_WRITE_8,
+#endif
+
+    BENCH_PATTERN_COUNT
+
+} BENCH_PATTERN;
+
+// *****************************************************************************
+/* Request addresses
+
+  Summary:
+    Where the requests of a workload step fall.
+*/
+
+typedef enum
+{
+    /* Follows the previous request of the first sequential stream */
+    BENCH_ADDRESS_SEQUENTIAL = 0,
+
+    /* Follows the previous request of the second sequential stream, which
+       starts in the middle of the card */
+    BENCH_ADDRESS_SEQUENTIAL_2,
+
+    /* Random, aligned to the request size */
+    BENCH_ADDRESS_RANDOM,
+
+    /* Random in the first BENCH_METADATA_BLOCKS blocks */
+    BENCH_ADDRESS_METADATA,
+
+} BENCH_ADDRESS;
+
+// *****************************************************************************
+/* Workload step
+
+  Summary:
+    One request of a workload.
+*/
+
+typedef struct
+{
+    bool isWrite;
+
+    BENCH_ADDRESS address;
+
+    /* Size of the request, BENCH_BUFFER_BLOCKS at most */
+    uint32_t blocks;
+
+} BENCH_STEP;
+
+// *****************************************************************************
+/* Benchmark result
+
+  Summary:
+    Measurements of one pattern.
+*/
+
+typedef struct
+{
+    /* Requests completed, including the failed ones */
+    uint32_t requests;
+
+    /* Blocks moved by the successful requests */
+    uint32_t blocks;
+
+    /* Requests that failed or could not be queued */
+    uint32_t errors;
+
+    /* Time the pattern ran for, in microseconds */
+    uint32_t elapsedUS;
+
+    /* Largest time from queuing a request to its completion, in
+       microseconds */
+    uint32_t latencyMaxUS;
+
+    /* Completed requests by latency, see BENCH_LATENCY_BUCKETS */
+    uint32_t latencyHistogram[BENCH_LATENCY_BUCKETS];
+
+} BENCH_RESULT;
+
+// *****************************************************************************
+/* Application states
+
+  Summary:
+    Application states enumeration
+
+  Description:
+    This enumeration defines the valid application states.  These states
+    determine the behavior of the application at various times.
+*/
+
+typedef enum
+{
+    /* Application's state machine's initial state. */
+    BENCH_STATE_INIT=0,
+
+    /* Waits for BENCH_Start */
+    BENCH_STATE_IDLE,
+
+    /* Starts the current pattern */
+    BENCH_STATE_PATTERN_START,
+
+    /* Queues the next request of the pattern */
+    BENCH_STATE_REQUEST_SUBMIT,
+
+    /* Waits for the request to complete */
+    BENCH_STATE_REQUEST_WAIT,
+
+    /* Makes the next request of the log file workload that is not a write,
+       and waits for it */
+    BENCH_STATE_FILE_SUBMIT,
+    BENCH_STATE_FILE_WAIT,
+
+} BENCH_STATES;
+
+// *****************************************************************************
+/* Log file requests
+
+  Summary:
+    Requests of the log file workload around its writes, in order.
+*/
+
+typedef enum
+{
+    BENCH_FILE_MOUNT = 0,
+
+    /* Creates the log file. The writes follow. */
+    BENCH_FILE_CREATE,
+
+    BENCH_FILE_CLOSE,
+
+    BENCH_FILE_UNMOUNT,
+
+} BENCH_FILE_STEP;
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds application data
+
+  Description:
+    This structure holds the application's data.
+
+  Remarks:
+    Application strings and buffers are be defined outside this structure.
+ */
+
+typedef struct
+{
+    /* The application's current state */
+    BENCH_STATES state;
+
+    /* Client handle of the SDMMC driver */
+    DRV_HANDLE sdmmcHandle;
+
+    /* Request in flight */
+    DRV_SDMMC_COMMAND_HANDLE commandHandle;
+
+    /* Set by the event handler when the request in flight completes */
+    volatile bool commandCompleted;
+    volatile bool commandFailed;
+
+    /* Pattern in progress */
+    uint32_t pattern;
+
+    /* Blocks of the card */
+    uint32_t numBlocks;
+
+    /* Next step of the workload */
+    uint32_t step;
+
+    /* Next block of each sequential stream */
+    uint32_t nextBlock[2];
+
+    /* State of the random address generator */
+    uint32_t randomState;
+
+    /* Blocks of the request in flight */
+    uint32_t requestBlocks;
+
+    /* Counter values at the start of the pattern and of the request in
+       flight */
+    uint32_t patternStartCount;
+    uint32_t requestStartCount;
+
+    /* Next request of the log file workload, and number in the name of the
+       log file */
+    BENCH_FILE_STEP fileStep;
+    uint32_t fileNumber;
+
+    /* Results of the last run */
+    BENCH_RESULT results[BENCH_PATTERN_COUNT];
+
+} BENCH_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void BENCH_Initialize ( void )
+
+  Summary:
+     MPLAB Harmony application initialization routine.
+
+  Description:
+    This function initializes the Harmony application.  It places the
+    application in its initial state and prepares it to run so that its
+    BENCH_Tasks function can be called.
+
+  Precondition:
+    All other system initialization routines should be called before calling
+    this routine (in "SYS_Initialize").
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+void BENCH_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    void BENCH_Tasks ( void )
+
+  Summary:
+    MPLAB Harmony benchmark application tasks function
+
+  Description:
+    This routine opens the SDMMC driver and runs the patterns after
+    BENCH_Start. It queues one request at a time and waits for its completion
+    between two calls.
+
+  Precondition:
+    The system and application initialization ("SYS_Initialize") should be
+    called before calling this.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Remarks:
+    This routine must be called from SYS_Tasks() routine.
+ */
+
+void BENCH_Tasks ( void );
+
+
+/*******************************************************************************
+  Function:
+    bool BENCH_IsBusy ( void )
+
+  Summary:
+    Returns true while the benchmark needs to run on every scheduler pass.
+
+  Description:
+    The application is busy while it opens the driver and between the
+    completion of a request and the queuing of the next one. While a request
+    is in flight it runs on the media events instead, and on the benchmark
+    event the completions of the FAT service post.
+ */
+
+bool BENCH_IsBusy ( void );
+
+
+/*******************************************************************************
+  Function:
+    bool BENCH_Start ( void )
+
+  Summary:
+    Starts a run of all the patterns.
+
+  Returns:
+    false if a run is in progress or the driver is not open yet.
+
+  Remarks:
+    The results of the previous run are cleared.
+ */
+
+bool BENCH_Start ( void );
+
+
+/*******************************************************************************
+  Function:
+    bool BENCH_IsRunning ( void )
+
+  Summary:
+    Returns true from BENCH_Start to the end of the last pattern.
+ */
+
+bool BENCH_IsRunning ( void );
+
+
+/*******************************************************************************
+  Function:
+    const char * BENCH_PatternNameGet ( BENCH_PATTERN pattern )
+
+  Summary:
+    Returns the name of a pattern, or NULL for an invalid pattern.
+ */
+
+const char * BENCH_PatternNameGet ( BENCH_PATTERN pattern );
+
+
+/*******************************************************************************
+  Function:
+    bool BENCH_ResultGet ( BENCH_PATTERN pattern, BENCH_RESULT * result )
+
+  Summary:
+    Copies the measurements of a pattern in the last run.
+
+  Returns:
+    false for an invalid pattern.
+ */
+
+bool BENCH_ResultGet ( BENCH_PATTERN pattern, BENCH_RESULT * result );
+
+
+/*******************************************************************************
+  Function:
+    uint32_t BENCH_LatencyPercentileGet ( const BENCH_RESULT * result,
+                                          uint32_t percent )
+
+  Summary:
+    Returns the latency under which percent of the requests completed.
+
+  Description:
+    The latency is read from the histogram, so it is the upper bound of a
+    bucket, a power of 2 microseconds. It is never above the largest latency.
+
+  Returns:
+    The latency in microseconds, 0 if no request completed.
+ */
+
+uint32_t BENCH_LatencyPercentileGet ( const BENCH_RESULT * result, uint32_t percent );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _BENCH_H */
+/*******************************************************************************
+ End of File
+ */
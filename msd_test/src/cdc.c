@@ -0,0 +1,1000 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    cdc.c
+
+  Summary:
+    This file contains the source code for the CDC telemetry application.
+
+  Description:
+    This file contains the source code for the CDC telemetry application. It
+    samples the transfer counters of the MSD function driver and its own CDC
+    counters once per report period and writes the resulting bandwidth of each
+    function to the CDC data interface.
+
+    Commands received from the host (one character each):
+        'L' - toggle a continuous CDC IN stream to load the bus
+        'R' - send a report immediately
+        'T' - dump the scheduler tasks, one line per task:
+              <name> n <runs> max <us> cpu <ms> stack <free bytes>
+        'M' - dump the memory usage, one line each for the main stack, the
+              heap, the sampled interrupts and the registered objects from
+              the largest down:
+              stack size <bytes> used <bytes>
+              heap size <bytes> used <bytes>
+              isr <name> depth <bytes>
+              <object> <bytes>
+        'B' - run the SD card benchmark and, once it is over, dump one line
+              per workload as key=value pairs, the latencies in us:
+              bench name=<workload> req=<n> blocks=<n> us=<n> iops=<n>
+                    kbps=<KB/s> p50=<us> p90=<us> p99=<us> max=<us> err=<n>
+        'U' - dump the USB frame statistics and the first IRPs completed
+              since the previous 'U', then restart both. The gap is the
+              time since the previous IRP in cycles:
+              usb frames <n> busy <n> pkts <n> bytes <n> max <bytes> lost <irps>
+              usb h <frames per 128 bytes moved>
+              irp f <frame> ep <address> size <bytes> st <status> gap <cycles>
+        'S' - dump the MSD command statistics since the previous 'S', then
+              restart them. The phases are mean times in us, the histogram
+              counts the commands by log2 of their time in us:
+              msd idle media <us> host <us>
+              scsi <class> n <n> fail <n> setup <us> media <us> data <us>
+                   csw <us> max <us> h <histogram>
+        'P' - dump the profile probes, one line per probe:
+              <name> n <count> min <cycles> mean <cycles> max <cycles> h <histogram>
+        'Z' - clear the profile probes
+        'C' - measure the CPU and the DMAC copy of 8 to 256 bytes, one line
+              per size. The DMAC time runs from the request to the completion
+              callback, the submit time is what the request cost the CPU:
+              copy <bytes> cpu <cycles> dma <cycles> submit <cycles>
+
+    The profile commands are only available when SYS_PROFILE_ENABLE is
+    defined, the USB command when DRV_USBFSV1_DEVICE_TRACE_ENABLE is true and
+    the MSD command when USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE is true.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "cdc.h"
+#include "app.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds application data
+
+  Description:
+    This structure holds the application's data.
+
+  Remarks:
+    This structure should be initialized by the CDC_Initialize function.
+
+    Application strings and buffers are be defined outside this structure.
+*/
+
+CDC_DATA cdcData;
+extern APP_DATA appData;
+
+static uint8_t receiveDataBuffer[CDC_BUFFER_SIZE] CACHE_ALIGN;
+static uint8_t loadDataBuffer[CDC_BUFFER_SIZE] CACHE_ALIGN;
+static char reportBuffer[CDC_REPORT_BUFFER_SIZE] CACHE_ALIGN;
+SYS_MEMORY_OBJECT_REGISTER(receiveDataBuffer);
+SYS_MEMORY_OBJECT_REGISTER(loadDataBuffer);
+
+static USB_CDC_LINE_CODING lineCoding = {115200, 0, 0, 8};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Callback Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Hands a transfer completion to the task. The ring always has room, as
+   there is never more than one read and one write in flight. */
+static void CDC_CompletionPost ( bool isWrite, USB_DEVICE_CDC_RESULT status, size_t length )
+{
+    CDC_COMPLETION completion;
+
+    completion.isWrite = isWrite;
+    completion.status = status;
+    completion.length = length;
+
+    (void) SYS_RING_Write(&cdcData.completionRing, cdcData.completions,
+            sizeof(CDC_COMPLETION), &completion, 1U);
+}
+
+USB_DEVICE_CDC_EVENT_RESPONSE USBDeviceCDCEventHandler
+(
+    USB_DEVICE_CDC_INDEX instanceIndex,
+    USB_DEVICE_CDC_EVENT event,
+    void * pData,
+    uintptr_t userData
+)
+{
+    switch(event)
+    {
+        case USB_DEVICE_CDC_EVENT_SET_LINE_CODING:
+
+            USB_DEVICE_ControlReceive(appData.usbDeviceHandle, &lineCoding,
+                                sizeof(USB_CDC_LINE_CODING));
+            break;
+
+        case USB_DEVICE_CDC_EVENT_GET_LINE_CODING:
+
+            USB_DEVICE_ControlSend(appData.usbDeviceHandle, &lineCoding,
+                                sizeof(USB_CDC_LINE_CODING));
+            break;
+
+        case USB_DEVICE_CDC_EVENT_SET_CONTROL_LINE_STATE:
+
+            /* Only report while a terminal has the port open */
+            cdcData.portOpen = (((USB_CDC_CONTROL_LINE_STATE *)pData)->dtr != 0U);
+            if (cdcData.portOpen == false)
+            {
+                /* The terminal is done with the port, keep its settings now */
+                SYS_KVS_Flush();
+            }
+            USB_DEVICE_ControlStatus(appData.usbDeviceHandle, USB_DEVICE_CONTROL_STATUS_OK);
+            break;
+
+        case USB_DEVICE_CDC_EVENT_SEND_BREAK:
+
+            USB_DEVICE_ControlStatus(appData.usbDeviceHandle, USB_DEVICE_CONTROL_STATUS_OK);
+            break;
+
+        case USB_DEVICE_CDC_EVENT_CONTROL_TRANSFER_DATA_RECEIVED:
+
+            /* The line coding is the only data stage. The store writes it
+               later, so this only updates its RAM copy. */
+            (void) SYS_KVS_Set(CDC_KVS_KEY_LINE_CODING, &lineCoding, sizeof(lineCoding));
+            USB_DEVICE_ControlStatus(appData.usbDeviceHandle, USB_DEVICE_CONTROL_STATUS_OK);
+            break;
+
+        case USB_DEVICE_CDC_EVENT_WRITE_COMPLETE:
+        {
+            USB_DEVICE_CDC_EVENT_DATA_WRITE_COMPLETE * writeObj = (USB_DEVICE_CDC_EVENT_DATA_WRITE_COMPLETE *)pData;
+            if (writeObj->handle == cdcData.wrTransferHandle)
+            {
+                CDC_CompletionPost(true, writeObj->status, writeObj->length);
+            }
+            break;
+        }
+
+        case USB_DEVICE_CDC_EVENT_READ_COMPLETE:
+        {
+            USB_DEVICE_CDC_EVENT_DATA_READ_COMPLETE * readObj = (USB_DEVICE_CDC_EVENT_DATA_READ_COMPLETE *)pData;
+            if (readObj->handle == cdcData.rdTransferHandle)
+            {
+                CDC_CompletionPost(false, readObj->status, readObj->length);
+            }
+            break;
+        }
+
+        case USB_DEVICE_CDC_EVENT_CONTROL_TRANSFER_DATA_SENT:
+        case USB_DEVICE_CDC_EVENT_SERIAL_STATE_NOTIFICATION_COMPLETE:
+        default:
+            break;
+    }
+
+    return USB_DEVICE_CDC_EVENT_RESPONSE_NONE;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Converts the bytes moved in elapsedCount SYS_TIME counts to bytes per
+   second */
+static uint32_t CDC_BytesPerSecond ( uint32_t bytes, uint32_t elapsedCount )
+{
+    if (elapsedCount == 0U)
+    {
+        return 0;
+    }
+
+    return (uint32_t)(((uint64_t)bytes * SYS_TIME_FrequencyGet()) / elapsedCount);
+}
+
+/* Converts the time the core slept in elapsedCount SYS_TIME counts to the
+   percentage of time it was running */
+static uint32_t CDC_LoadPercent ( uint32_t idleCount, uint32_t elapsedCount )
+{
+    if ((elapsedCount == 0U) || (idleCount >= elapsedCount))
+    {
+        return 0;
+    }
+
+    return (uint32_t)(((uint64_t)(elapsedCount - idleCount) * 100U) / elapsedCount);
+}
+
+/* Formats the bandwidth report since the previous report and restarts the
+   measurement. Returns the length of the report. */
+static size_t CDC_ReportBuild ( void )
+{
+    USB_DEVICE_MSD_STATISTICS msdStatistics;
+    uint32_t cdcRxBytes = cdcData.rxBytes;
+    uint32_t cdcTxBytes = cdcData.txBytes;
+    uint32_t reportCount = SYS_TIME_CounterGet();
+    uint32_t elapsedCount = reportCount - cdcData.lastReportCount;
+    uint64_t idleTime = SYS_SCHED_IdleTimeGet();
+    uint32_t idleCount = (uint32_t)(idleTime - cdcData.lastIdleTime);
+    int length;
+
+    USB_DEVICE_MSD_StatisticsGet(0, &msdStatistics);
+
+    length = snprintf(reportBuffer, sizeof(reportBuffer),
+            "MSD out %lu in %lu B/s cmd %lu thr %lu | CDC out %lu in %lu B/s | CPU %lu%%\r\n",
+            (unsigned long)CDC_BytesPerSecond(msdStatistics.bytesReceived - cdcData.lastMsdStatistics.bytesReceived, elapsedCount),
+            (unsigned long)CDC_BytesPerSecond(msdStatistics.bytesSent - cdcData.lastMsdStatistics.bytesSent, elapsedCount),
+            (unsigned long)(msdStatistics.commands - cdcData.lastMsdStatistics.commands),
+            (unsigned long)(msdStatistics.throttledFrames - cdcData.lastMsdStatistics.throttledFrames),
+            (unsigned long)CDC_BytesPerSecond(cdcRxBytes - cdcData.lastCdcRxBytes, elapsedCount),
+            (unsigned long)CDC_BytesPerSecond(cdcTxBytes - cdcData.lastCdcTxBytes, elapsedCount),
+            (unsigned long)CDC_LoadPercent(idleCount, elapsedCount));
+
+    cdcData.lastMsdStatistics = msdStatistics;
+    cdcData.lastCdcRxBytes = cdcRxBytes;
+    cdcData.lastCdcTxBytes = cdcTxBytes;
+    cdcData.lastReportCount = reportCount;
+    cdcData.lastIdleTime = idleTime;
+
+    if (length < 0)
+    {
+        return 0;
+    }
+
+    return ((size_t)length < sizeof(reportBuffer)) ? (size_t)length : (sizeof(reportBuffer) - 1U);
+}
+
+#if (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+/* Takes the frame statistics and the oldest completed IRPs for the USB dump.
+   The IRPs that do not fit are dropped, so the next dump starts with the
+   IRPs completed after this one. */
+static void CDC_USBTraceTake ( void )
+{
+    DRV_USBFSV1_DEVICE_TRACE_ENTRY discarded[4];
+
+    (void) DRV_USBFSV1_DEVICE_FrameStatisticsGet(sysObj.drvUSBFSV1Object, &cdcData.usbFrameStatistics, true);
+
+    cdcData.usbTraceCount = DRV_USBFSV1_DEVICE_TraceRead(sysObj.drvUSBFSV1Object,
+            cdcData.usbTrace, CDC_USB_TRACE_ENTRIES);
+    while (DRV_USBFSV1_DEVICE_TraceRead(sysObj.drvUSBFSV1Object, discarded, 4U) != 0U)
+    {
+        /* Drop the rest */
+    }
+
+    cdcData.usbDumpLine = 0;
+}
+#endif
+
+/* Acts on the command received in the first byte of a read */
+static void CDC_CommandProcess ( uint8_t command )
+{
+    if (command == (uint8_t)'L')
+    {
+        cdcData.loadEnabled = !cdcData.loadEnabled;
+    }
+    else if (command == (uint8_t)'R')
+    {
+        cdcData.reportPending = true;
+    }
+    else if (command == (uint8_t)'T')
+    {
+        cdcData.taskDumpIndex = 0;
+    }
+    else if (command == (uint8_t)'M')
+    {
+        cdcData.memoryDumpIndex = 0;
+    }
+    else if (command == (uint8_t)'B')
+    {
+        if (BENCH_Start())
+        {
+            cdcData.benchDumpPattern = 0;
+        }
+    }
+#if (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+    else if (command == (uint8_t)'U')
+    {
+        CDC_USBTraceTake();
+    }
+#endif
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+    else if (command == (uint8_t)'S')
+    {
+        (void) USB_DEVICE_MSD_CommandStatisticsGet(0, &cdcData.msdCommandStatistics, true);
+        cdcData.msdDumpLine = 0;
+    }
+#endif
+#if defined(SYS_PROFILE_ENABLE)
+    else if (command == (uint8_t)'P')
+    {
+        cdcData.profileDumpProbe = 0;
+    }
+    else if (command == (uint8_t)'Z')
+    {
+        SYS_PROFILE_Reset();
+    }
+    else if (command == (uint8_t)'C')
+    {
+        cdcData.copyDumpIndex = 0;
+    }
+#endif
+    else
+    {
+        /* Anything else only counts towards the CDC bandwidth */
+    }
+}
+
+/* Takes the completions posted by the event handler. A completed read is
+   acted on and the next read is queued. */
+static void CDC_CompletionsProcess ( void )
+{
+    CDC_COMPLETION completions[CDC_COMPLETION_RING_SIZE];
+    uint32_t count;
+    uint32_t i;
+
+    count = SYS_RING_Read(&cdcData.completionRing, cdcData.completions,
+            sizeof(CDC_COMPLETION), completions, CDC_COMPLETION_RING_SIZE);
+
+    for (i = 0; i < count; i++)
+    {
+        if (completions[i].isWrite)
+        {
+            if (completions[i].status == USB_DEVICE_CDC_RESULT_OK)
+            {
+                cdcData.txBytes += completions[i].length;
+            }
+            cdcData.cdcWriteCompleted = true;
+        }
+        else
+        {
+            if (completions[i].status == USB_DEVICE_CDC_RESULT_OK)
+            {
+                cdcData.rxBytes += completions[i].length;
+                if (completions[i].length > 0U)
+                {
+                    CDC_CommandProcess(receiveDataBuffer[0]);
+                }
+            }
+            USB_DEVICE_CDC_Read(USB_DEVICE_CDC_INDEX_0, &cdcData.rdTransferHandle, receiveDataBuffer, CDC_BUFFER_SIZE);
+        }
+    }
+}
+
+/* Formats the statistics of one scheduler task. Returns the length of the
+   line. */
+static size_t CDC_TaskLineBuild ( size_t task )
+{
+    SYS_SCHED_TASK_STATISTICS statistics;
+    int length;
+
+    if (!SYS_SCHED_TaskStatisticsGet(task, &statistics))
+    {
+        return 0;
+    }
+
+    length = snprintf(reportBuffer, sizeof(reportBuffer), "%s n %lu max %lu cpu %lu stack %lu\r\n",
+            SYS_SCHED_TaskNameGet(task),
+            (unsigned long)statistics.runs,
+            (unsigned long)SYS_TIME_CountToUS(statistics.runTimeMax),
+            (unsigned long)((statistics.runTime * 1000U) / SYS_TIME_FrequencyGet()),
+            (unsigned long)statistics.stackFree);
+
+    if (length < 0)
+    {
+        return 0;
+    }
+
+    return ((size_t)length < sizeof(reportBuffer)) ? (size_t)length : (sizeof(reportBuffer) - 1U);
+}
+
+/* Number of lines of a memory dump */
+static uint32_t CDC_MemoryLineCountGet ( void )
+{
+    return 2U + (uint32_t)SYS_MEMORY_ISR_COUNT + (uint32_t)SYS_MEMORY_ObjectCountGet();
+}
+
+/* Formats one line of the memory dump. Returns the length of the line. */
+static size_t CDC_MemoryLineBuild ( uint32_t line )
+{
+    SYS_MEMORY_STATISTICS statistics;
+    const SYS_MEMORY_OBJECT * object;
+    int length;
+
+    if (line < 2U)
+    {
+        if (line == 0U)
+        {
+            (void) SYS_MEMORY_StackStatisticsGet(&statistics);
+        }
+        else
+        {
+            (void) SYS_MEMORY_HeapStatisticsGet(&statistics);
+        }
+
+        length = snprintf(reportBuffer, sizeof(reportBuffer), "%s size %lu used %lu\r\n",
+                (line == 0U) ? "stack" : "heap",
+                (unsigned long)statistics.size,
+                (unsigned long)statistics.highWaterMark);
+    }
+    else if (line < (2U + (uint32_t)SYS_MEMORY_ISR_COUNT))
+    {
+        length = snprintf(reportBuffer, sizeof(reportBuffer), "isr %s depth %lu\r\n",
+                SYS_MEMORY_ISRNameGet((SYS_MEMORY_ISR)(line - 2U)),
+                (unsigned long)SYS_MEMORY_ISRDepthGet((SYS_MEMORY_ISR)(line - 2U)));
+    }
+    else
+    {
+        object = SYS_MEMORY_ObjectGet((size_t)(line - 2U - (uint32_t)SYS_MEMORY_ISR_COUNT));
+        if (object == NULL)
+        {
+            return 0;
+        }
+
+        length = snprintf(reportBuffer, sizeof(reportBuffer), "%s %lu\r\n",
+                object->name, (unsigned long)object->size);
+    }
+
+    if (length < 0)
+    {
+        return 0;
+    }
+
+    return ((size_t)length < sizeof(reportBuffer)) ? (size_t)length : (sizeof(reportBuffer) - 1U);
+}
+
+/* Formats the result of one benchmark workload as key=value pairs, so the
+   runs of two firmware versions can be compared by a script. Returns the
+   length of the line. */
+static size_t CDC_BenchLineBuild ( BENCH_PATTERN pattern )
+{
+    BENCH_RESULT result;
+    uint32_t elapsedUS;
+    int length;
+
+    if (!BENCH_ResultGet(pattern, &result))
+    {
+        return 0;
+    }
+
+    elapsedUS = (result.elapsedUS != 0U) ? result.elapsedUS : 1U;
+
+    length = snprintf(reportBuffer, sizeof(reportBuffer),
+            "bench name=%s req=%lu blocks=%lu us=%lu iops=%lu kbps=%lu p50=%lu p90=%lu p99=%lu max=%lu err=%lu\r\n",
+            BENCH_PatternNameGet(pattern),
+            (unsigned long)result.requests,
+            (unsigned long)result.blocks,
+            (unsigned long)result.elapsedUS,
+            (unsigned long)(((uint64_t)result.requests * 1000000U) / elapsedUS),
+            (unsigned long)(((uint64_t)result.blocks * BENCH_BLOCK_SIZE * 1000000U) / ((uint64_t)elapsedUS * 1024U)),
+            (unsigned long)BENCH_LatencyPercentileGet(&result, 50U),
+            (unsigned long)BENCH_LatencyPercentileGet(&result, 90U),
+            (unsigned long)BENCH_LatencyPercentileGet(&result, 99U),
+            (unsigned long)result.latencyMaxUS,
+            (unsigned long)result.errors);
+
+    if (length < 0)
+    {
+        return 0;
+    }
+
+    return ((size_t)length < sizeof(reportBuffer)) ? (size_t)length : (sizeof(reportBuffer) - 1U);
+}
+
+#if (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+/* Formats one line of the USB dump. Returns the length of the line. */
+static size_t CDC_USBLineBuild ( uint32_t line )
+{
+    const DRV_USBFSV1_DEVICE_FRAME_STATISTICS * statistics = &cdcData.usbFrameStatistics;
+    const DRV_USBFSV1_DEVICE_TRACE_ENTRY * entry;
+    size_t length;
+    uint32_t i;
+    int result;
+
+    if (line == 0U)
+    {
+        result = snprintf(reportBuffer, sizeof(reportBuffer), "usb frames %lu busy %lu pkts %lu bytes %lu max %lu lost %lu\r\n",
+                (unsigned long)statistics->frames,
+                (unsigned long)statistics->busyFrames,
+                (unsigned long)statistics->packets,
+                (unsigned long)statistics->bytes,
+                (unsigned long)statistics->maxFrameBytes,
+                (unsigned long)statistics->traceOverflows);
+    }
+    else if (line == 1U)
+    {
+        length = (size_t)snprintf(reportBuffer, sizeof(reportBuffer), "usb h");
+
+        for (i = 0; (i < DRV_USBFSV1_DEVICE_FRAME_HISTOGRAM_BUCKETS) && (length < sizeof(reportBuffer)); i++)
+        {
+            result = snprintf(&reportBuffer[length], sizeof(reportBuffer) - length, " %lu",
+                    (unsigned long)statistics->histogram[i]);
+            if (result < 0)
+            {
+                return 0;
+            }
+            length += (size_t)result;
+        }
+
+        if (length < sizeof(reportBuffer))
+        {
+            result = snprintf(&reportBuffer[length], sizeof(reportBuffer) - length, "\r\n");
+            if (result < 0)
+            {
+                return 0;
+            }
+            length += (size_t)result;
+        }
+
+        return (length < sizeof(reportBuffer)) ? length : (sizeof(reportBuffer) - 1U);
+    }
+    else
+    {
+        entry = &cdcData.usbTrace[line - 2U];
+        result = snprintf(reportBuffer, sizeof(reportBuffer), "irp f %u ep %02x size %lu st %d gap %lu\r\n",
+                (unsigned int)entry->frame,
+                (unsigned int)entry->endpoint,
+                (unsigned long)entry->size,
+                (int)entry->status,
+                (unsigned long)((line > 2U) ? (entry->cycles - cdcData.usbTrace[line - 3U].cycles) : 0U));
+    }
+
+    if (result < 0)
+    {
+        return 0;
+    }
+
+    return ((size_t)result < sizeof(reportBuffer)) ? (size_t)result : (sizeof(reportBuffer) - 1U);
+}
+#endif
+
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+/* Names of the MSD command classes, in USB_DEVICE_MSD_OPCODE order */
+static const char * const msdOpcodeNames[USB_DEVICE_MSD_OPCODE_COUNT] =
+{
+    "read10", "write10", "tur", "sense", "inquiry", "capacity", "modesense", "other"
+};
+
+/* Mean of a phase summed over count commands */
+static unsigned long CDC_MeanUS ( uint64_t totalUS, uint32_t count )
+{
+    return (count != 0U) ? (unsigned long)(totalUS / count) : 0UL;
+}
+
+/* Formats one line of the MSD command dump. Returns the length of the
+   line. */
+static size_t CDC_MSDLineBuild ( uint32_t line )
+{
+    const USB_DEVICE_MSD_OPCODE_STATISTICS * statistics;
+    size_t length;
+    uint32_t i;
+    int result;
+
+    if (line == 0U)
+    {
+        result = snprintf(reportBuffer, sizeof(reportBuffer), "msd idle media %lu host %lu\r\n",
+                (unsigned long)cdcData.msdCommandStatistics.mediaIdleUS,
+                (unsigned long)cdcData.msdCommandStatistics.hostIdleUS);
+
+        if (result < 0)
+        {
+            return 0;
+        }
+
+        return ((size_t)result < sizeof(reportBuffer)) ? (size_t)result : (sizeof(reportBuffer) - 1U);
+    }
+
+    statistics = &cdcData.msdCommandStatistics.opcodes[line - 1U];
+
+    result = snprintf(reportBuffer, sizeof(reportBuffer), "scsi %s n %lu fail %lu setup %lu media %lu data %lu csw %lu max %lu h",
+            msdOpcodeNames[line - 1U],
+            (unsigned long)statistics->commands,
+            (unsigned long)statistics->failed,
+            CDC_MeanUS(statistics->setupUS, statistics->commands),
+            CDC_MeanUS(statistics->mediaUS, statistics->commands),
+            CDC_MeanUS(statistics->dataUS, statistics->commands),
+            CDC_MeanUS(statistics->statusUS, statistics->commands),
+            (unsigned long)statistics->maxUS);
+    if (result < 0)
+    {
+        return 0;
+    }
+    length = (size_t)result;
+
+    for (i = 0; (i < USB_DEVICE_MSD_LATENCY_BUCKETS) && (length < sizeof(reportBuffer)); i++)
+    {
+        result = snprintf(&reportBuffer[length], sizeof(reportBuffer) - length, " %lu",
+                (unsigned long)statistics->histogram[i]);
+        if (result < 0)
+        {
+            return 0;
+        }
+        length += (size_t)result;
+    }
+
+    if (length < sizeof(reportBuffer))
+    {
+        result = snprintf(&reportBuffer[length], sizeof(reportBuffer) - length, "\r\n");
+        if (result < 0)
+        {
+            return 0;
+        }
+        length += (size_t)result;
+    }
+
+    return (length < sizeof(reportBuffer)) ? length : (sizeof(reportBuffer) - 1U);
+}
+#endif
+
+#if defined(SYS_PROFILE_ENABLE)
+/* Formats the statistics of one profile probe. Returns the length of the
+   line. */
+static size_t CDC_ProfileLineBuild ( SYS_PROFILE_PROBE probe )
+{
+    SYS_PROFILE_STATISTICS statistics;
+    size_t length;
+    uint32_t i;
+    int result;
+
+    (void) SYS_PROFILE_StatisticsGet(probe, &statistics);
+
+    result = snprintf(reportBuffer, sizeof(reportBuffer), "%s n %lu min %lu mean %lu max %lu h",
+            SYS_PROFILE_NameGet(probe),
+            (unsigned long)statistics.count,
+            (unsigned long)((statistics.count != 0U) ? statistics.min : 0U),
+            (unsigned long)((statistics.count != 0U) ? (statistics.total / statistics.count) : 0U),
+            (unsigned long)statistics.max);
+    if (result < 0)
+    {
+        return 0;
+    }
+    length = (size_t)result;
+
+    for (i = 0; (i < SYS_PROFILE_HISTOGRAM_BUCKETS) && (length < sizeof(reportBuffer)); i++)
+    {
+        result = snprintf(&reportBuffer[length], sizeof(reportBuffer) - length, " %lu",
+                (unsigned long)statistics.histogram[i]);
+        if (result < 0)
+        {
+            return 0;
+        }
+        length += (size_t)result;
+    }
+
+    if (length < sizeof(reportBuffer))
+    {
+        result = snprintf(&reportBuffer[length], sizeof(reportBuffer) - length, "\r\n");
+        if (result < 0)
+        {
+            return 0;
+        }
+        length += (size_t)result;
+    }
+
+    return (length < sizeof(reportBuffer)) ? length : (sizeof(reportBuffer) - 1U);
+}
+
+/* Set when the copy measured by CDC_CopyLineBuild completes */
+static volatile bool copyCompleted;
+
+static void CDC_CopyEventHandler ( SYS_COPY_EVENT event, uintptr_t context )
+{
+    (void) event;
+    (void) context;
+
+    copyCompleted = true;
+}
+
+/* Copies the load pattern into the report buffer with the CPU and then with
+   the DMAC, and formats the cycle counts over it. Returns the length of the
+   line. */
+static size_t CDC_CopyLineBuild ( uint32_t index )
+{
+    size_t size = (size_t)8U << index;
+    size_t threshold;
+    uint32_t start;
+    uint32_t cpuCycles;
+    uint32_t dmaCycles = 0U;
+    uint32_t submitCycles = 0U;
+    int length;
+
+    start = DWT->CYCCNT;
+    (void) memcpy(reportBuffer, loadDataBuffer, size);
+    cpuCycles = DWT->CYCCNT - start;
+
+    /* Send the copy to the DMAC whatever its size */
+    threshold = SYS_COPY_ThresholdSet(0U);
+    copyCompleted = false;
+    start = DWT->CYCCNT;
+    if (SYS_COPY_Memcpy(reportBuffer, loadDataBuffer, size, CDC_CopyEventHandler, 0U))
+    {
+        submitCycles = DWT->CYCCNT - start;
+        while (!copyCompleted)
+        {
+            /* Wait for the DMAC interrupt */
+        }
+        dmaCycles = DWT->CYCCNT - start;
+    }
+    (void) SYS_COPY_ThresholdSet(threshold);
+
+    length = snprintf(reportBuffer, sizeof(reportBuffer), "copy %lu cpu %lu dma %lu submit %lu\r\n",
+            (unsigned long)size, (unsigned long)cpuCycles,
+            (unsigned long)dmaCycles, (unsigned long)submitCycles);
+    if (length < 0)
+    {
+        return 0;
+    }
+
+    return ((size_t)length < sizeof(reportBuffer)) ? (size_t)length : (sizeof(reportBuffer) - 1U);
+}
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CDC_Initialize ( void )
+
+  Remarks:
+    See prototype in cdc.h.
+ */
+
+void CDC_Initialize ( void )
+{
+    uint32_t i;
+
+    /* Place the App state machine in its initial state. */
+    cdcData.state = CDC_STATE_INIT;
+    cdcData.cdcWriteCompleted = true;
+    SYS_RING_Initialize(&cdcData.completionRing, CDC_COMPLETION_RING_SIZE);
+    cdcData.reportTimer = SYS_TIME_HANDLE_INVALID;
+    cdcData.taskDumpIndex = 0xFFFFFFFFU;
+    cdcData.memoryDumpIndex = 0xFFFFFFFFU;
+    cdcData.benchDumpPattern = (uint32_t)BENCH_PATTERN_COUNT;
+
+    /* Line coding of the previous session, the default if there is none */
+    (void) SYS_KVS_Get(CDC_KVS_KEY_LINE_CODING, &lineCoding, sizeof(lineCoding));
+#if (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+    cdcData.usbDumpLine = 0xFFFFFFFFU;
+#endif
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+    cdcData.msdDumpLine = 0xFFFFFFFFU;
+#endif
+#if defined(SYS_PROFILE_ENABLE)
+    cdcData.profileDumpProbe = (uint32_t)SYS_PROFILE_PROBE_COUNT;
+    cdcData.copyDumpIndex = CDC_COPY_SIZES;
+#endif
+
+    /* Printable pattern so the load stream can be viewed in a terminal */
+    for (i = 0; i < CDC_BUFFER_SIZE; i++)
+    {
+        loadDataBuffer[i] = (uint8_t)('0' + (i % 10U));
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    void CDC_Tasks ( void )
+
+  Remarks:
+    See prototype in cdc.h.
+ */
+
+void CDC_Tasks ( void )
+{
+    size_t length;
+    uint32_t position;
+
+    switch ( cdcData.state )
+    {
+        case CDC_STATE_INIT:
+        {
+            if (appData.isConfigured)
+            {
+                /* The MSD statistics restart on every configuration */
+                (void) memset(&cdcData.lastMsdStatistics, 0, sizeof(cdcData.lastMsdStatistics));
+                cdcData.rxBytes = 0;
+                cdcData.txBytes = 0;
+                cdcData.lastCdcRxBytes = 0;
+                cdcData.lastCdcTxBytes = 0;
+                cdcData.lastReportCount = SYS_TIME_CounterGet();
+                cdcData.lastIdleTime = SYS_SCHED_IdleTimeGet();
+                cdcData.reportPending = false;
+                cdcData.portOpen = false;
+                cdcData.loadEnabled = false;
+                cdcData.cdcWriteCompleted = true;
+
+                /* Completions of the previous configuration are stale */
+                SYS_RING_Release(&cdcData.completionRing,
+                        SYS_RING_CountGet(&cdcData.completionRing, &position));
+
+                USB_DEVICE_CDC_Read(USB_DEVICE_CDC_INDEX_0, &cdcData.rdTransferHandle, receiveDataBuffer, CDC_BUFFER_SIZE);
+
+                (void) SYS_TIME_DelayMS(CDC_REPORT_PERIOD_MS, &cdcData.reportTimer);
+                cdcData.state = CDC_STATE_SERVICE_TASKS;
+            }
+            break;
+        }
+
+        case CDC_STATE_SERVICE_TASKS:
+        {
+            if (!appData.isConfigured)
+            {
+                (void) SYS_TIME_TimerDestroy(cdcData.reportTimer);
+                cdcData.reportTimer = SYS_TIME_HANDLE_INVALID;
+                cdcData.state = CDC_STATE_INIT;
+                break;
+            }
+
+            CDC_CompletionsProcess();
+
+            if (SYS_TIME_DelayIsComplete(cdcData.reportTimer))
+            {
+                cdcData.reportPending = true;
+                (void) SYS_TIME_DelayMS(CDC_REPORT_PERIOD_MS, &cdcData.reportTimer);
+            }
+
+            if (!cdcData.cdcWriteCompleted)
+            {
+                /* A report that is due while a write is in flight is sent as
+                 * soon as the write completes. The rates are computed over the
+                 * actual time since the previous report. */
+                break;
+            }
+
+            if (cdcData.reportPending)
+            {
+                cdcData.reportPending = false;
+                length = CDC_ReportBuild();
+                if (cdcData.portOpen && (length > 0U))
+                {
+                    cdcData.cdcWriteCompleted = false;
+                    USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle,
+                            reportBuffer, length, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
+                }
+            }
+            else if (cdcData.taskDumpIndex < (uint32_t)SYS_SCHED_TaskCountGet())
+            {
+                /* One task per write, like the profile dump */
+                length = CDC_TaskLineBuild((size_t)cdcData.taskDumpIndex);
+                cdcData.taskDumpIndex++;
+                if (cdcData.portOpen && (length > 0U))
+                {
+                    cdcData.cdcWriteCompleted = false;
+                    USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle,
+                            reportBuffer, length, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
+                }
+            }
+            else if (cdcData.memoryDumpIndex < CDC_MemoryLineCountGet())
+            {
+                length = CDC_MemoryLineBuild(cdcData.memoryDumpIndex);
+                cdcData.memoryDumpIndex++;
+                if (cdcData.portOpen && (length > 0U))
+                {
+                    cdcData.cdcWriteCompleted = false;
+                    USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle,
+                            reportBuffer, length, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
+                }
+            }
+            else if ((cdcData.benchDumpPattern < (uint32_t)BENCH_PATTERN_COUNT) && !BENCH_IsRunning())
+            {
+                length = CDC_BenchLineBuild((BENCH_PATTERN)cdcData.benchDumpPattern);
+                cdcData.benchDumpPattern++;
+                if (cdcData.portOpen && (length > 0U))
+                {
+                    cdcData.cdcWriteCompleted = false;
+                    USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle,
+                            reportBuffer, length, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
+                }
+            }
+#if (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+            else if (cdcData.usbDumpLine < (2U + cdcData.usbTraceCount))
+            {
+                length = CDC_USBLineBuild(cdcData.usbDumpLine);
+                cdcData.usbDumpLine++;
+                if (cdcData.portOpen && (length > 0U))
+                {
+                    cdcData.cdcWriteCompleted = false;
+                    USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle,
+                            reportBuffer, length, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
+                }
+            }
+#endif
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+            else if (cdcData.msdDumpLine < (1U + (uint32_t)USB_DEVICE_MSD_OPCODE_COUNT))
+            {
+                length = CDC_MSDLineBuild(cdcData.msdDumpLine);
+                cdcData.msdDumpLine++;
+                if (cdcData.portOpen && (length > 0U))
+                {
+                    cdcData.cdcWriteCompleted = false;
+                    USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle,
+                            reportBuffer, length, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
+                }
+            }
+#endif
+#if defined(SYS_PROFILE_ENABLE)
+            else if (cdcData.profileDumpProbe < (uint32_t)SYS_PROFILE_PROBE_COUNT)
+            {
+                /* One probe per write, so a report that becomes due during
+                 * the dump goes out between two probe lines */
+                length = CDC_ProfileLineBuild((SYS_PROFILE_PROBE)cdcData.profileDumpProbe);
+                cdcData.profileDumpProbe++;
+                if (cdcData.portOpen && (length > 0U))
+                {
+                    cdcData.cdcWriteCompleted = false;
+                    USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle,
+                            reportBuffer, length, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
+                }
+            }
+            else if (cdcData.copyDumpIndex < CDC_COPY_SIZES)
+            {
+                /* The report buffer is free: the previous write is complete */
+                length = CDC_CopyLineBuild(cdcData.copyDumpIndex);
+                cdcData.copyDumpIndex++;
+                if (cdcData.portOpen && (length > 0U))
+                {
+                    cdcData.cdcWriteCompleted = false;
+                    USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle,
+                            reportBuffer, length, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
+                }
+            }
+#endif
+            else if (cdcData.portOpen && cdcData.loadEnabled)
+            {
+                /* Only one write is in flight at a time, so the load stream
+                 * cannot take more of the bus than the host gives the CDC
+                 * bulk IN endpoint. */
+                cdcData.cdcWriteCompleted = false;
+                USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle,
+                        loadDataBuffer, CDC_BUFFER_SIZE, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
+            }
+            else
+            {
+                /* Nothing to send */
+            }
+            break;
+        }
+
+        /* The default state should never be executed. */
+        default:
+        {
+            break;
+        }
+    }
+
+    /* The MSD data stage leaves part of each frame to the CDC bulk IN
+     * endpoint only while a write is in flight. Reads only carry single
+     * command bytes. */
+    USB_DEVICE_MSD_FrameBudgetEnable(0, (cdcData.state == CDC_STATE_SERVICE_TASKS) && !cdcData.cdcWriteCompleted);
+}
+
+
+/*******************************************************************************
+ End of File
+ */
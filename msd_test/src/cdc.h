@@ -0,0 +1,321 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    cdc.h
+
+  Summary:
+    This header file provides prototypes and definitions for the CDC telemetry
+    application.
+
+  Description:
+    This header file provides function prototypes and data type definitions for
+    the CDC telemetry application. The application shares the USB connection
+    with the MSD function and periodically reports the bus bandwidth used by
+    each function of the composite device on the CDC data interface.
+*******************************************************************************/
+
+#ifndef _CDC_H
+#define _CDC_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "configuration.h"
+#include "usb/usb_device_cdc.h"
+#include "usb/usb_device_msd.h"
+#include "driver/usb/usbfsv1/drv_usbfsv1.h"
+#include "system/time/sys_time.h"
+#include "system/sched/sys_sched.h"
+#include "system/ring/sys_ring.h"
+#include "system/memory/sys_memory.h"
+#include "system/copy/sys_copy.h"
+#include "system/kvs/sys_kvs.h"
+#include "bench.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Bandwidth report period in milliseconds */
+#define CDC_REPORT_PERIOD_MS 1000U
+
+/* Size of the CDC read and load buffers. A multiple of the bulk endpoint
+   size. */
+#define CDC_BUFFER_SIZE 512
+
+/* Size of the completion ring. At most one read and one write are in
+   flight. Must be a power of 2. */
+#define CDC_COMPLETION_RING_SIZE 4U
+
+/* Size of the report buffer. Holds one bandwidth report, one task line or one
+   profile probe line. */
+#define CDC_REPORT_BUFFER_SIZE 256U
+
+/* Copy sizes measured by the 'C' command, from 8 bytes doubling up to the
+   size of the report buffer */
+#define CDC_COPY_SIZES 6U
+
+/* Completed IRPs written by the 'U' command */
+#define CDC_USB_TRACE_ENTRIES 16U
+
+/* Key/value store key of the line coding the host last set */
+#define CDC_KVS_KEY_LINE_CODING 0x0100U
+
+// *****************************************************************************
+/* Application states
+
+  Summary:
+    Application states enumeration
+
+  Description:
+    This enumeration defines the valid application states.  These states
+    determine the behavior of the application at various times.
+*/
+
+typedef enum
+{
+    /* Application's state machine's initial state. */
+    CDC_STATE_INIT=0,
+    CDC_STATE_SERVICE_TASKS,
+
+} CDC_STATES;
+
+
+// *****************************************************************************
+/* Transfer completion
+
+  Summary:
+    Completion of a CDC read or write, handed from the event handler to the
+    task.
+*/
+
+typedef struct
+{
+    /* true for a write, false for a read */
+    bool isWrite;
+
+    USB_DEVICE_CDC_RESULT status;
+
+    /* Bytes transferred */
+    size_t length;
+
+} CDC_COMPLETION;
+
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds application data
+
+  Description:
+    This structure holds the application's data.
+
+  Remarks:
+    Application strings and buffers are be defined outside this structure.
+ */
+
+typedef struct
+{
+    /* The application's current state */
+    CDC_STATES state;
+
+    /* Completions posted by the event handler, which may run in the USB
+       interrupt */
+    SYS_RING completionRing;
+    CDC_COMPLETION completions[CDC_COMPLETION_RING_SIZE];
+
+    /* True while no write is in flight */
+    bool cdcWriteCompleted;
+    USB_DEVICE_CDC_TRANSFER_HANDLE rdTransferHandle;
+    USB_DEVICE_CDC_TRANSFER_HANDLE wrTransferHandle;
+
+    /* True while the host has the port open (DTR set) */
+    bool portOpen;
+
+    /* True while the host asked for a continuous CDC IN stream, so that the
+       bus sharing with MSD can be observed under load */
+    bool loadEnabled;
+
+    /* Report timer */
+    SYS_TIME_HANDLE reportTimer;
+
+    /* True when a report is due and waits for the write IRP */
+    bool reportPending;
+
+    /* Bytes moved on the CDC data endpoints since the device was configured */
+    uint32_t rxBytes;
+    uint32_t txBytes;
+
+    /* Counters at the time of the previous report */
+    uint32_t lastReportCount;
+    uint32_t lastCdcRxBytes;
+    uint32_t lastCdcTxBytes;
+    USB_DEVICE_MSD_STATISTICS lastMsdStatistics;
+    uint64_t lastIdleTime;
+
+    /* Next scheduler task to write while a task dump is in progress.
+       SYS_SCHED_TaskCountGet() or above when no dump is in progress. */
+    uint32_t taskDumpIndex;
+
+    /* Next line to write while a memory dump is in progress.
+       CDC_MemoryLineCountGet() or above when no dump is in progress. */
+    uint32_t memoryDumpIndex;
+
+    /* Next pattern to write once the benchmark run is over.
+       BENCH_PATTERN_COUNT when no dump is pending. */
+    uint32_t benchDumpPattern;
+
+#if (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+    /* Next line to write while a USB dump is in progress. 2 plus
+       usbTraceCount or above when no dump is in progress. */
+    uint32_t usbDumpLine;
+
+    /* Frame statistics and completed IRPs taken by the 'U' command */
+    DRV_USBFSV1_DEVICE_FRAME_STATISTICS usbFrameStatistics;
+    DRV_USBFSV1_DEVICE_TRACE_ENTRY usbTrace[CDC_USB_TRACE_ENTRIES];
+    uint32_t usbTraceCount;
+#endif
+
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+    /* Next line to write while an MSD command dump is in progress. 1 plus
+       USB_DEVICE_MSD_OPCODE_COUNT or above when no dump is in progress. */
+    uint32_t msdDumpLine;
+
+    /* Command statistics taken by the 'S' command */
+    USB_DEVICE_MSD_COMMAND_STATISTICS msdCommandStatistics;
+#endif
+
+#if defined(SYS_PROFILE_ENABLE)
+    /* Next probe to write while a profile dump is in progress.
+       SYS_PROFILE_PROBE_COUNT when no dump is in progress. */
+    uint32_t profileDumpProbe;
+
+    /* Next size to measure while a copy dump is in progress.
+       CDC_COPY_SIZES when no dump is in progress. */
+    uint32_t copyDumpIndex;
+#endif
+
+} CDC_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Callback Routines
+// *****************************************************************************
+// *****************************************************************************
+/* These routines are called by drivers when certain events occur.
+*/
+USB_DEVICE_CDC_EVENT_RESPONSE USBDeviceCDCEventHandler
+(
+        USB_DEVICE_CDC_INDEX instanceIndex,
+        USB_DEVICE_CDC_EVENT event,
+        void * pData,
+        uintptr_t userData
+);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void CDC_Initialize ( void )
+
+  Summary:
+     MPLAB Harmony application initialization routine.
+
+  Description:
+    This function initializes the CDC telemetry application and places it in
+    its initial state.
+
+  Precondition:
+    All other system initialization routines should be called before calling
+    this routine (in "SYS_Initialize").
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    CDC_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+void CDC_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    void CDC_Tasks ( void )
+
+  Summary:
+    CDC telemetry application tasks function
+
+  Description:
+    This routine keeps a read queued on the CDC data interface and, while the
+    host has the port open, writes one bandwidth report every
+    CDC_REPORT_PERIOD_MS. The report gives the bytes per second moved by the
+    MSD and the CDC function in the last period and the share of the period
+    the core was not sleeping.
+
+  Precondition:
+    The system and application initialization ("SYS_Initialize") should be
+    called before calling this.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    CDC_Tasks();
+    </code>
+
+  Remarks:
+    This routine must be called from SYS_Tasks() routine.
+ */
+
+void CDC_Tasks( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _CDC_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -71,7 +71,10 @@ extern "C" {
 // Section: System Configuration
 // *****************************************************************************
 // *****************************************************************************
-
+/* Define OSAL_USE_RTOS to run the tasks as FreeRTOS tasks over the FreeRTOS
+   OSAL (see FreeRTOSConfig.h). The FreeRTOS kernel with the GCC/ARM_CM4F port
+   and heap_4 must then be added to the project. */
+//#define OSAL_USE_RTOS
 
 
 // *****************************************************************************
@@ -81,13 +84,68 @@ extern "C" {
 // *****************************************************************************
 /* TIME System Service Configuration Options */
 #define SYS_TIME_INDEX_0                            (0)
-#define SYS_TIME_MAX_TIMERS                         (5)
-#define SYS_TIME_HW_COUNTER_WIDTH                   (16)
-#define SYS_TIME_HW_COUNTER_PERIOD                  (0xFFFFU)
+/* The scheduler poll, the SDMMC driver timers, the CDC report and the RAM
+   disk latency. The host build raises it for its timer benchmark. */
+#ifndef SYS_TIME_MAX_TIMERS
+#define SYS_TIME_MAX_TIMERS                         (6)
+#endif
+#define SYS_TIME_HW_COUNTER_WIDTH                   (32)
+#define SYS_TIME_HW_COUNTER_PERIOD                  (0xFFFFFFFFU)
 #define SYS_TIME_HW_COUNTER_HALF_PERIOD             (SYS_TIME_HW_COUNTER_PERIOD>>1)
 #define SYS_TIME_CPU_CLOCK_FREQUENCY                (120000000)
 #define SYS_TIME_COMPARE_UPDATE_EXECUTION_CYCLES    (232)
 
+/* MEMORY System Service Configuration Options */
+#define SYS_MEMORY_PAINT_PATTERN                    (0xA5A5A5A5U)
+#define SYS_MEMORY_PAINT_MARGIN                     (64U)
+#define SYS_MEMORY_ISRS(ISR)                        \
+    ISR(USB)                                        \
+    ISR(SDHC0)                                      \
+    ISR(TC0)
+
+/* COPY System Service Configuration Options */
+#define SYS_COPY_QUEUE_SIZE                         (4U)
+#define SYS_COPY_BLOCKS_NUMBER                      (4U)
+/* Requests smaller than this are copied by the CPU. Measured with the 'C'
+   command of the CDC port: set it to the first size the DMAC wins. */
+#define SYS_COPY_DMA_THRESHOLD                      (64U)
+
+/* KVS System Service Configuration Options */
+#define SYS_KVS_ENTRIES_NUMBER                      (16U)
+/* Time without changes after which the changed entries are written */
+#define SYS_KVS_FLUSH_DELAY_MS                      (1000U)
+
+/* FAT System Service Configuration Options */
+/* 4 KB of FAT, 1024 clusters, read or written at once */
+#define SYS_FAT_CACHE_SECTORS                       (8U)
+#define SYS_FAT_WRITE_BLOCKS_MAX                    (128U)
+
+/* SCHED System Service Configuration Options */
+#define SYS_SCHED_EVENT_USB                         (0x01U)
+#define SYS_SCHED_EVENT_SDHC                        (0x02U)
+#define SYS_SCHED_EVENT_TIME                        (0x04U)
+#define SYS_SCHED_EVENT_MEDIA                       (0x08U)
+#define SYS_SCHED_EVENT_POLL                        (0x10U)
+#define SYS_SCHED_EVENT_BENCH                       (0x20U)
+#define SYS_SCHED_EVENT_FAT                         (0x40U)
+#define SYS_SCHED_POLL_PERIOD_MS                    (100U)
+
+/* PROFILE System Service Configuration Options */
+/* Define SYS_PROFILE_ENABLE to build the cycle counter probes. Without it the
+   probes compile to nothing. */
+//#define SYS_PROFILE_ENABLE
+#define SYS_PROFILE_HISTOGRAM_BUCKETS               (16U)
+#define SYS_PROFILE_HISTOGRAM_SHIFT                 (4U)
+#define SYS_PROFILE_PROBES(PROBE)                   \
+    PROBE(DRV_SDMMC_TASKS)                          \
+    PROBE(USB_DEVICE_TASKS)                         \
+    PROBE(DRV_USBFSV1_TASKS)                        \
+    PROBE(USB_ISR)                                  \
+    PROBE(SDHC0_ISR)                                \
+    PROBE(TC0_ISR)                                  \
+    PROBE(USB_IRP_SUBMIT)                           \
+    PROBE(MSD_MEDIA_REQUEST)
+
 
 
 // *****************************************************************************
@@ -98,16 +156,59 @@ extern "C" {
 /* SDMMC Driver Global Configuration Options */
 #define DRV_SDMMC_INSTANCES_NUMBER                       (1U)
 
+/* Bind the driver to the SDHC0 PLIB at build time instead of through the
+   sdmmcPlib table. Comment out to use the table of the initialization data. */
+#define DRV_SDMMC_STATIC_PLIB                            SDHC0
+
 
 /*** SDMMC Driver Instance 0 Configuration ***/
 #define DRV_SDMMC_INDEX_0                                0
-#define DRV_SDMMC_IDX0_CLIENTS_NUMBER                    1
-#define DRV_SDMMC_IDX0_QUEUE_SIZE                        2
+/* The MSD function, the benchmark application and the FAT service */
+#define DRV_SDMMC_IDX0_CLIENTS_NUMBER                    3
+#define DRV_SDMMC_IDX0_QUEUE_SIZE                        3
 #define DRV_SDMMC_IDX0_PROTOCOL_SUPPORT                  DRV_SDMMC_PROTOCOL_SD
 #define DRV_SDMMC_IDX0_CONFIG_SPEED_MODE                 DRV_SDMMC_SPEED_MODE_DEFAULT
 #define DRV_SDMMC_IDX0_CONFIG_BUS_WIDTH                  DRV_SDMMC_BUS_WIDTH_4_BIT
 #define DRV_SDMMC_IDX0_CARD_DETECTION_METHOD             DRV_SDMMC_CD_METHOD_USE_SDCD
 
+/* Flash Media Driver Configuration Options */
+#define DRV_FLASH_INDEX_0                                0
+#define DRV_FLASH_CLIENTS_NUMBER                         (1U)
+/* Region of the media: the end of the bank at 0x80000, so the code in the
+   bank at 0 keeps running while it is erased and written. NVMCTRL_SEESBLK = 1
+   gives the SmartEEPROM the last 8 KB of bank A, 0x7E000 to 0x80000 while
+   the code runs from bank A. The same 8 KB at the end of the other bank are
+   left out of the media so that the layout holds after a bank swap. The
+   linker script rejects a ROM_LENGTH above 0x7E000 in the project linker
+   macros. The UF2 driver updates the firmware below the media in the same
+   bank, so after the bank swap of an update the media is the same region of
+   the other bank. */
+#define DRV_FLASH_MEDIA_START_ADDRESS                    (0xE0000U)
+#define DRV_FLASH_MEDIA_SIZE                             (0x1E000U)
+/* Time without writes after which the written data reaches the flash */
+#define DRV_FLASH_FLUSH_DELAY_MS                         (500U)
+
+/* RAM Disk Media Driver Configuration Options */
+#define DRV_RAMDISK_INDEX_0                              0
+#define DRV_RAMDISK_CLIENTS_NUMBER                       (1U)
+#define DRV_RAMDISK_MEDIA_SIZE                           (0x10000U)
+/* Time from a request to its completion. 0 completes the requests in the
+   call and measures the USB device stack alone. */
+#define DRV_RAMDISK_LATENCY_US                           (0U)
+
+/* UF2 Update Media Driver Configuration Options */
+#define DRV_UF2_INDEX_0                                  0
+#define DRV_UF2_CLIENTS_NUMBER                           (1U)
+/* The bank the code does not run from, mapped at 0x80000 whichever bank it
+   is. The image must fit below the flash media, ROM_LENGTH=0x60000 in the
+   project linker macros keeps the code within it. */
+#define DRV_UF2_BANK_ADDRESS                             (0x80000U)
+#define DRV_UF2_IMAGE_SIZE                               (DRV_FLASH_MEDIA_START_ADDRESS - DRV_UF2_BANK_ADDRESS)
+#define DRV_UF2_BOARD_ID                                 "SAMD51J20A-msd_test"
+/* Flash pages assembled in RAM at a time, how far out of order the host
+   may write the UF2 blocks */
+#define DRV_UF2_PAGES_NUMBER                             (8U)
+
 
 
 
@@ -118,7 +219,7 @@ extern "C" {
 // *****************************************************************************
 // *****************************************************************************
 /* Number of Endpoints used */
-#define DRV_USBFSV1_ENDPOINTS_NUMBER                        2U
+#define DRV_USBFSV1_ENDPOINTS_NUMBER                        4U
 
 /* The USB Device Layer will not initialize the USB Driver */
 #define USB_DEVICE_DRIVER_INITIALIZE_EXPLICIT
@@ -126,6 +227,10 @@ extern "C" {
 /* Maximum device layer instances */
 #define USB_DEVICE_INSTANCES_NUMBER                         1U
 
+/* Bind the device layer to the DRV_USBFSV1 driver at build time instead of
+   through the usbDriverInterface of the initialization data */
+#define USB_DEVICE_STATIC_DRIVER                            DRV_USBFSV1
+
 /* EP0 size in bytes */
 #define USB_DEVICE_EP0_BUFFER_SIZE                          64U
 
@@ -136,8 +241,31 @@ extern "C" {
 #define USB_DEVICE_MSD_NUM_SECTOR_BUFFERS 1
 
 
-/* Number of Logical Units */
-#define USB_DEVICE_MSD_LUNS_NUMBER      1
+/* Number of Logical Units: the SD card, the internal flash, the RAM disk and
+   the UF2 update volume */
+#define USB_DEVICE_MSD_LUNS_NUMBER      4
+
+/* Bind the logical unit to the DRV_SDMMC media functions at build time instead
+   of through the mediaFunctions of the initialization data. Only valid with a
+   single logical unit, so left out while the internal flash is LUN 1. */
+//#define USB_DEVICE_MSD_STATIC_MEDIA     DRV_SDMMC
+
+/* Bytes the MSD data stage may move in one USB frame while the CDC function
+   has a write in flight. The rest of the frame is left to the CDC function. */
+#define USB_DEVICE_MSD_FRAME_BYTE_BUDGET 1024U
+
+/* Time every command from its CBW to its CSW, split in phases and kept per
+   SCSI operation code. Read with USB_DEVICE_MSD_CommandStatisticsGet. */
+#define USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE true
+
+/* Maximum instances of CDC function driver */
+#define USB_DEVICE_CDC_INSTANCES_NUMBER                     1U
+
+
+/* CDC Transfer Queue Size for both read and
+   write. Applicable to all instances of the
+   function driver */
+#define USB_DEVICE_CDC_QUEUE_DEPTH_COMBINED                 3U
 
 
 
@@ -156,16 +284,88 @@ extern "C" {
 /* Enable usage of Dual Bank */
 #define DRV_USBFSV1_DUAL_BANK_ENABLE                        false
 
+/* Defer device IRP completion callbacks from the USB interrupt to
+   DRV_USBFSV1_Tasks. The ISR only queues completed IRPs. The host build
+   turns it on from the command line for its deferred variant. */
+#ifndef DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION
+#define DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION          false
+#endif
+
+/* Depth of the deferred IRP completion queue. Must be a power of 2. */
+#define DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH       16U
+
+/* Measure the device mode ISR execution time with the DWT cycle counter */
+#define DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE            false
+
+/* Trace the completed IRPs and count the data bytes moved in every USB frame.
+   Read with the 'U' command of the CDC port. */
+#define DRV_USBFSV1_DEVICE_TRACE_ENABLE                     false
+
+/* Completed IRPs the trace holds until they are read. Must be a power of 2. */
+#define DRV_USBFSV1_DEVICE_TRACE_DEPTH                      64U
+
 /* Alignment for buffers that are submitted to USB Driver*/ 
 #define USB_ALIGN  __ALIGNED(CACHE_LINE_SIZE)
 
 
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: RTOS Configuration
+// *****************************************************************************
+// *****************************************************************************
+/* The USB device layer and driver run above the SD card, so a card that is
+   slow to write never delays the control transfers. The applications run
+   below both. Stack sizes are in words. */
+
+/* USB Device Layer RTOS Configurations*/
+#define USB_DEVICE_RTOS_STACK_SIZE              512
+#define USB_DEVICE_RTOS_TASK_PRIORITY           3
+
+/* SDMMC Driver RTOS Configurations*/
+#define DRV_SDMMC_RTOS_STACK_SIZE               256
+#define DRV_SDMMC_RTOS_TASK_PRIORITY            2
+
+/* Flash Driver RTOS Configurations*/
+#define DRV_FLASH_RTOS_STACK_SIZE               256
+#define DRV_FLASH_RTOS_TASK_PRIORITY            2
+
+/* RAM Disk Driver RTOS Configurations*/
+#define DRV_RAMDISK_RTOS_STACK_SIZE             256
+#define DRV_RAMDISK_RTOS_TASK_PRIORITY          2
+
+/* UF2 Update Driver RTOS Configurations*/
+#define DRV_UF2_RTOS_STACK_SIZE                 256
+#define DRV_UF2_RTOS_TASK_PRIORITY              2
+
+/* KVS System Service RTOS Configurations*/
+#define SYS_KVS_RTOS_STACK_SIZE                 256
+#define SYS_KVS_RTOS_TASK_PRIORITY              1
+
+/* FAT System Service RTOS Configurations*/
+#define SYS_FAT_RTOS_STACK_SIZE                 256
+#define SYS_FAT_RTOS_TASK_PRIORITY              1
+
+/* Applications RTOS Configurations*/
+#define APP_RTOS_STACK_SIZE                     256
+#define APP_RTOS_TASK_PRIORITY                  1
+#define CDC_RTOS_STACK_SIZE                     384
+#define CDC_RTOS_TASK_PRIORITY                  1
+#define BENCH_RTOS_STACK_SIZE                   256
+#define BENCH_RTOS_TASK_PRIORITY                1
+
+
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Application Configuration
 // *****************************************************************************
 // *****************************************************************************
+/* Benchmark Application Configuration Options */
+#define BENCH_DURATION_MS                       2000U
+/* Define BENCH_WRITE_ENABLE to add the write workloads to the benchmark.
+   They overwrite the card, the file system included. */
+//#define BENCH_WRITE_ENABLE
 
 
 //DOM-IGNORE-BEGIN
@@ -51,8 +51,14 @@
 #include "peripheral/nvmctrl/plib_nvmctrl.h"
 #include "usb/usb_device_msd.h"
 #include "usb/usb_msd.h"
+#include "usb/usb_device_cdc.h"
+#include "usb/usb_cdc.h"
 #include "peripheral/evsys/plib_evsys.h"
+#include "peripheral/dmac/plib_dmac.h"
 #include "driver/sdmmc/drv_sdmmc.h"
+#include "driver/flash/drv_flash.h"
+#include "driver/ramdisk/drv_ramdisk.h"
+#include "driver/uf2/drv_uf2.h"
 #include "peripheral/port/plib_port.h"
 #include "peripheral/clock/plib_clock.h"
 #include "peripheral/nvic/plib_nvic.h"
@@ -62,12 +68,20 @@
 #include "peripheral/tc/plib_tc0.h"
 #include "peripheral/sdhc/plib_sdhc0.h"
 #include "system/time/sys_time.h"
+#include "system/profile/sys_profile.h"
+#include "system/memory/sys_memory.h"
+#include "system/copy/sys_copy.h"
+#include "system/kvs/sys_kvs.h"
+#include "system/fat/sys_fat.h"
+#include "system/sched/sys_sched.h"
 #include "driver/usb/usbfsv1/drv_usbfsv1.h"
 #include "system/int/sys_int.h"
 #include "system/cache/sys_cache.h"
 #include "osal/osal.h"
 #include "system/debug/sys_debug.h"
 #include "app.h"
+#include "cdc.h"
+#include "bench.h"
 
 
 
@@ -175,6 +189,34 @@ Remarks:
 
 void SYS_Tasks ( void );
 
+// *****************************************************************************
+/* System Tasks Initialization Function
+
+Function:
+    void SYS_TasksInitialize ( void );
+
+Summary:
+    Registers the polled tasks of the system with the scheduler.
+
+Description:
+    This function sets up the task table that SYS_Tasks runs and the timer that
+    polls the SD card detect line and VBUS.
+
+Precondition:
+    All modules called by SYS_Tasks must have been initialized.
+
+Parameters:
+    None.
+
+Returns:
+    None.
+
+Remarks:
+    This function is called at the end of SYS_Initialize.
+*/
+
+void SYS_TasksInitialize ( void );
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Type Definitions
@@ -204,6 +246,9 @@ typedef struct
     SYS_MODULE_OBJ  drvUSBFSV1Object;
 
     SYS_MODULE_OBJ  drvSDMMC0;
+    SYS_MODULE_OBJ  drvFlash0;
+    SYS_MODULE_OBJ  drvRamDisk0;
+    SYS_MODULE_OBJ  drvUf2_0;
 
 
 
@@ -0,0 +1,375 @@
+/*******************************************************************************
+  Flash Media Driver Interface Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_flash.h
+
+  Summary:
+    Flash Media Driver interface.
+
+  Description:
+    This file defines the interface to the Flash Media Driver. The driver
+    presents a region of the internal flash, reserved from the program memory,
+    as a block media of 512 byte blocks with the interface the MSD function
+    driver and the file system expect from a media driver.
+
+    Reads are served from the memory mapped flash and complete before the read
+    function returns. Writes are gathered in a RAM copy of one NVMCTRL erase
+    block. The copy is written back to the flash when a write falls in another
+    erase block or when no write came for DRV_FLASH_FLUSH_DELAY_MS, so a host
+    writing a file sector by sector costs one erase per erase block.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef DRV_FLASH_H    // Guards against multiple inclusion
+#define DRV_FLASH_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+#include "driver/driver_common.h"
+#include "system/system_module.h"
+#include "system/system_media.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Clients that may have the driver open at the same time */
+#ifndef DRV_FLASH_CLIENTS_NUMBER
+    #define DRV_FLASH_CLIENTS_NUMBER        (1U)
+#endif
+
+/* Time without writes after which the RAM copy of the erase block is written
+   back to the flash */
+#ifndef DRV_FLASH_FLUSH_DELAY_MS
+    #define DRV_FLASH_FLUSH_DELAY_MS        (500U)
+#endif
+
+/* Size of a media block in bytes */
+#define DRV_FLASH_BLOCK_SIZE                (512U)
+
+// *****************************************************************************
+/* Flash Media Driver command handle
+
+  Summary:
+    Identifies a read or write request.
+
+  Remarks:
+    Refer system_media.h for the definition of SYS_MEDIA_BLOCK_COMMAND_HANDLE.
+*/
+
+typedef SYS_MEDIA_BLOCK_COMMAND_HANDLE DRV_FLASH_COMMAND_HANDLE;
+
+#define DRV_FLASH_COMMAND_HANDLE_INVALID SYS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID
+
+// *****************************************************************************
+/* Flash Media Driver events
+
+  Summary:
+    Identifies the result of a request.
+*/
+
+typedef enum
+{
+    /* The request is complete */
+    DRV_FLASH_EVENT_COMMAND_COMPLETE = SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE,
+
+    /* The flash reported an error while the request, or an earlier
+       write, was written back */
+    DRV_FLASH_EVENT_COMMAND_ERROR = SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR
+
+} DRV_FLASH_EVENT;
+
+// *****************************************************************************
+/* Flash Media Driver event handler
+
+  Summary:
+    Pointer to the function called when a request ends.
+
+  Description:
+    The handler of a read, and of a write that fits in the RAM copy of the
+    erase block, is called before the read or write function returns. The
+    handler of a write that has to wait for the previous erase block to be
+    written back is called from DRV_FLASH_Tasks.
+*/
+
+typedef SYS_MEDIA_EVENT_HANDLER DRV_FLASH_EVENT_HANDLER;
+
+// *****************************************************************************
+/* Flash Media Driver initialization data
+
+  Summary:
+    Defines the flash region of the media.
+*/
+
+typedef struct
+{
+    /* First address of the region. Must be aligned to an erase block. */
+    uint32_t startAddress;
+
+    /* Size of the region in bytes. Must be a multiple of an erase block. */
+    uint32_t mediaSize;
+
+    /* RAM copy of one erase block, NVMCTRL_FLASH_BLOCKSIZE bytes aligned to
+       4 bytes */
+    uint8_t * eraseBuffer;
+
+} DRV_FLASH_INIT;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines - System Level
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    SYS_MODULE_OBJ DRV_FLASH_Initialize ( const SYS_MODULE_INDEX drvIndex,
+                                          const SYS_MODULE_INIT * const init )
+
+  Summary:
+    Initializes the driver over the region given by the initialization data.
+
+  Precondition:
+    NVMCTRL_Initialize must have been called.
+
+  Parameters:
+    drvIndex - DRV_FLASH_INDEX_0.
+    init     - Pointer to a DRV_FLASH_INIT structure.
+
+  Returns:
+    The driver object, or SYS_MODULE_OBJ_INVALID if the index or the region
+    is not valid.
+*/
+
+SYS_MODULE_OBJ DRV_FLASH_Initialize ( const SYS_MODULE_INDEX drvIndex, const SYS_MODULE_INIT * const init );
+
+//******************************************************************************
+/* Function:
+    SYS_STATUS DRV_FLASH_Status ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Returns SYS_STATUS_READY once the driver is initialized.
+*/
+
+SYS_STATUS DRV_FLASH_Status ( SYS_MODULE_OBJ object );
+
+//******************************************************************************
+/* Function:
+    void DRV_FLASH_Tasks ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Writes the RAM copy of the erase block back to the flash.
+
+  Description:
+    Erases the block and then writes it one page at a time, returning between
+    two NVMCTRL commands. Once the block is written, completes the write that
+    waited for it. Starts the write back when no write came for
+    DRV_FLASH_FLUSH_DELAY_MS.
+
+  Remarks:
+    Must be called while DRV_FLASH_IsBusy returns true and periodically
+    otherwise, for the delayed write back.
+*/
+
+void DRV_FLASH_Tasks ( SYS_MODULE_OBJ object );
+
+//******************************************************************************
+/* Function:
+    bool DRV_FLASH_IsBusy ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Returns true while an erase block is being written back.
+*/
+
+bool DRV_FLASH_IsBusy ( SYS_MODULE_OBJ object );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines - Client Level
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    DRV_HANDLE DRV_FLASH_Open ( const SYS_MODULE_INDEX drvIndex,
+                                const DRV_IO_INTENT ioIntent )
+
+  Summary:
+    Opens a client of the driver.
+
+  Returns:
+    DRV_HANDLE_INVALID if the driver is not ready or all the clients are in
+    use.
+*/
+
+DRV_HANDLE DRV_FLASH_Open ( const SYS_MODULE_INDEX drvIndex, const DRV_IO_INTENT ioIntent );
+
+//******************************************************************************
+/* Function:
+    void DRV_FLASH_Close ( DRV_HANDLE handle )
+
+  Summary:
+    Closes a client.
+
+  Remarks:
+    Data written by the client is still written back to the flash.
+*/
+
+void DRV_FLASH_Close ( DRV_HANDLE handle );
+
+//******************************************************************************
+/* Function:
+    void DRV_FLASH_AsyncRead ( const DRV_HANDLE handle,
+                               DRV_FLASH_COMMAND_HANDLE * commandHandle,
+                               void * targetBuffer,
+                               uint32_t blockStart, uint32_t nBlocks )
+
+  Summary:
+    Reads nBlocks blocks from blockStart.
+
+  Description:
+    The blocks held in the RAM copy of the erase block are read from it, the
+    others from the flash. The read completes before the function returns.
+
+  Returns:
+    DRV_FLASH_COMMAND_HANDLE_INVALID in commandHandle if the handle or the
+    block range is not valid.
+*/
+
+void DRV_FLASH_AsyncRead ( const DRV_HANDLE handle, DRV_FLASH_COMMAND_HANDLE * commandHandle,
+        void * targetBuffer, uint32_t blockStart, uint32_t nBlocks );
+
+//******************************************************************************
+/* Function:
+    void DRV_FLASH_AsyncWrite ( const DRV_HANDLE handle,
+                                DRV_FLASH_COMMAND_HANDLE * commandHandle,
+                                void * sourceBuffer,
+                                uint32_t blockStart, uint32_t nBlocks )
+
+  Summary:
+    Writes nBlocks blocks from blockStart.
+
+  Description:
+    The blocks are copied to the RAM copy of their erase block. A write that
+    falls in another erase block than the one held waits in the driver while
+    the held block is written back.
+
+    If the write back of the held block failed, the RAM copy keeps the
+    blocks and DRV_FLASH_Tasks writes it back again after
+    DRV_FLASH_FLUSH_DELAY_MS. The write that waited for it, or else the
+    next write, ends with DRV_FLASH_EVENT_COMMAND_ERROR without being
+    applied.
+
+  Returns:
+    DRV_FLASH_COMMAND_HANDLE_INVALID in commandHandle if the handle or the
+    block range is not valid, or if a write is already waiting.
+
+  Remarks:
+    The source buffer must stay valid until the request completes.
+*/
+
+void DRV_FLASH_AsyncWrite ( const DRV_HANDLE handle, DRV_FLASH_COMMAND_HANDLE * commandHandle,
+        void * sourceBuffer, uint32_t blockStart, uint32_t nBlocks );
+
+//******************************************************************************
+/* Function:
+    SYS_MEDIA_GEOMETRY * DRV_FLASH_GeometryGet ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns the geometry of the media.
+
+  Description:
+    The read and write regions have blocks of DRV_FLASH_BLOCK_SIZE bytes. The
+    erase region has the blocks of the NVMCTRL.
+*/
+
+SYS_MEDIA_GEOMETRY * DRV_FLASH_GeometryGet ( const DRV_HANDLE handle );
+
+//******************************************************************************
+/* Function:
+    void DRV_FLASH_EventHandlerSet ( const DRV_HANDLE handle,
+                                     const void * eventHandler,
+                                     const uintptr_t context )
+
+  Summary:
+    Sets the function called when a request of the client ends.
+*/
+
+void DRV_FLASH_EventHandlerSet ( const DRV_HANDLE handle, const void * eventHandler, const uintptr_t context );
+
+//******************************************************************************
+/* Function:
+    bool DRV_FLASH_IsAttached ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns true for a valid handle. The flash cannot be removed.
+*/
+
+bool DRV_FLASH_IsAttached ( const DRV_HANDLE handle );
+
+//******************************************************************************
+/* Function:
+    bool DRV_FLASH_IsWriteProtected ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns true if the client was opened without DRV_IO_INTENT_WRITE.
+*/
+
+bool DRV_FLASH_IsWriteProtected ( const DRV_HANDLE handle );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    }
+#endif
+//DOM-IGNORE-END
+
+#endif // DRV_FLASH_H
@@ -0,0 +1,651 @@
+/*******************************************************************************
+  Flash Media Driver Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_flash.c
+
+  Summary:
+    Source code for the Flash Media Driver.
+
+  Description:
+    This file contains the source code for the Flash Media Driver. Reads copy
+    the blocks from the memory mapped flash, or from the RAM copy of the erase
+    block when they are held there. Writes update the RAM copy. The write back
+    of the RAM copy erases the block and writes its pages from
+    DRV_FLASH_Tasks, one NVMCTRL command per call, so the scheduler keeps
+    running the other tasks while the flash is busy. The region is meant to be
+    in the other bank than the code, which keeps running while the bank of the
+    region is erased or written.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "configuration.h"
+#include "driver/flash/src/drv_flash_local.h"
+#include "system/int/sys_int.h"
+#include "system/time/sys_time.h"
+#include "system/memory/sys_memory.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+static DRV_FLASH_OBJ gDrvFlashObj;
+SYS_MEMORY_OBJECT_REGISTER(gDrvFlashObj);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static inline uint16_t lDRV_FLASH_UPDATE_TOKEN(uint16_t token)
+{
+    token++;
+
+    if (token >= DRV_FLASH_TOKEN_MAX)
+    {
+        token = 1;
+    }
+
+    return token;
+}
+
+static DRV_FLASH_CLIENT_OBJ * lDRV_FLASH_DriverHandleValidate( DRV_HANDLE handle )
+{
+    DRV_FLASH_CLIENT_OBJ * clientObj;
+    uint32_t index;
+
+    if ((handle == DRV_HANDLE_INVALID) || (gDrvFlashObj.status != SYS_STATUS_READY))
+    {
+        return NULL;
+    }
+
+    index = (uint32_t)handle & DRV_FLASH_INDEX_MASK;
+    if (index >= DRV_FLASH_CLIENTS_NUMBER)
+    {
+        return NULL;
+    }
+
+    clientObj = &gDrvFlashObj.clientObj[index];
+    if ((clientObj->inUse == false) || (clientObj->clientHandle != handle))
+    {
+        return NULL;
+    }
+
+    return clientObj;
+}
+
+static bool lDRV_FLASH_RangeIsValid( const DRV_FLASH_OBJ * dObj, uint32_t blockStart, uint32_t nBlocks )
+{
+    uint32_t numBlocks = dObj->mediaGeometryTable[SYS_MEDIA_GEOMETRY_TABLE_READ_ENTRY].numBlocks;
+
+    return ((nBlocks != 0U) && (blockStart < numBlocks) && (nBlocks <= (numBlocks - blockStart)));
+}
+
+static const uint8_t * lDRV_FLASH_Address( const DRV_FLASH_OBJ * dObj, uint32_t block )
+{
+    return (const uint8_t *)(uintptr_t)(dObj->startAddress + (block * DRV_FLASH_BLOCK_SIZE));
+}
+
+/* The SmartEEPROM shares the NVMCTRL, so its page writes keep the flash
+   busy too */
+static bool lDRV_FLASH_NVMIsBusy( void )
+{
+    return (NVMCTRL_IsBusy() || NVMCTRL_SmartEEPROM_IsBusy());
+}
+
+/* Starts the write back of the RAM copy unless the flash already holds it.
+   Called with the mutex held. */
+static void lDRV_FLASH_FlushStart( DRV_FLASH_OBJ * dObj )
+{
+    const uint8_t * address = lDRV_FLASH_Address(dObj, dObj->cacheBlock * DRV_FLASH_ERASE_BLOCKS);
+
+    if (memcmp(dObj->eraseBuffer, address, NVMCTRL_FLASH_BLOCKSIZE) == 0)
+    {
+        dObj->cacheDirty = false;
+        return;
+    }
+
+    dObj->flushPage = 0U;
+    dObj->flushState = DRV_FLASH_FLUSH_START;
+}
+
+/* Copies what is left of the pending write to the RAM copy. Returns false
+   if the write has to wait for the write back of the RAM copy. Called with
+   the mutex held. */
+static bool lDRV_FLASH_WriteProgress( DRV_FLASH_OBJ * dObj )
+{
+    uint32_t eraseBlock;
+    uint32_t offset;
+    uint32_t nBlocks;
+
+    while (dObj->writeBlocks != 0U)
+    {
+        /* The RAM copy must not change while it is written back */
+        if (dObj->flushState != DRV_FLASH_FLUSH_IDLE)
+        {
+            return false;
+        }
+
+        eraseBlock = dObj->writeBlock / DRV_FLASH_ERASE_BLOCKS;
+
+        if ((dObj->cacheValid == false) || (dObj->cacheBlock != eraseBlock))
+        {
+            if ((dObj->cacheValid == true) && (dObj->cacheDirty == true))
+            {
+                lDRV_FLASH_FlushStart(dObj);
+                continue;
+            }
+
+            (void) memcpy(dObj->eraseBuffer, lDRV_FLASH_Address(dObj, eraseBlock * DRV_FLASH_ERASE_BLOCKS),
+                    NVMCTRL_FLASH_BLOCKSIZE);
+            dObj->cacheBlock = eraseBlock;
+            dObj->cacheValid = true;
+        }
+
+        offset = dObj->writeBlock % DRV_FLASH_ERASE_BLOCKS;
+        nBlocks = DRV_FLASH_ERASE_BLOCKS - offset;
+        if (nBlocks > dObj->writeBlocks)
+        {
+            nBlocks = dObj->writeBlocks;
+        }
+
+        (void) memcpy(&dObj->eraseBuffer[offset * DRV_FLASH_BLOCK_SIZE], dObj->writeBuffer,
+                nBlocks * DRV_FLASH_BLOCK_SIZE);
+        dObj->cacheDirty = true;
+
+        dObj->writeBuffer += nBlocks * DRV_FLASH_BLOCK_SIZE;
+        dObj->writeBlock += nBlocks;
+        dObj->writeBlocks -= nBlocks;
+    }
+
+    dObj->lastWriteCount = SYS_TIME_CounterGet();
+
+    return true;
+}
+
+/* Returns true if the page of the RAM copy is erased, so it needs no write */
+static bool lDRV_FLASH_PageIsBlank( const DRV_FLASH_OBJ * dObj, uint32_t page )
+{
+    const uint32_t * data = (const uint32_t *)(const void *)&dObj->eraseBuffer[page * NVMCTRL_FLASH_PAGESIZE];
+    uint32_t i;
+
+    for (i = 0U; i < (NVMCTRL_FLASH_PAGESIZE / 4U); i++)
+    {
+        if (data[i] != 0xFFFFFFFFU)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Issues the next NVMCTRL command of the write back. Returns true when the
+   write back ended. Called with the mutex held and the NVMCTRL idle. */
+static bool lDRV_FLASH_FlushProgress( DRV_FLASH_OBJ * dObj, bool * failed )
+{
+    uint32_t address;
+
+    if (dObj->flushState == DRV_FLASH_FLUSH_START)
+    {
+        (void) NVMCTRL_BlockErase((uint32_t)(uintptr_t)lDRV_FLASH_Address(dObj, dObj->cacheBlock * DRV_FLASH_ERASE_BLOCKS));
+        dObj->flushState = DRV_FLASH_FLUSH_ERASE;
+        *failed = false;
+
+        return false;
+    }
+
+    *failed = ((NVMCTRL_ErrorGet() & DRV_FLASH_NVM_ERRORS) != 0U);
+
+    if (*failed == false)
+    {
+        while ((dObj->flushPage < DRV_FLASH_PAGES) && (lDRV_FLASH_PageIsBlank(dObj, dObj->flushPage) == true))
+        {
+            dObj->flushPage++;
+        }
+
+        if (dObj->flushPage < DRV_FLASH_PAGES)
+        {
+            address = (uint32_t)(uintptr_t)lDRV_FLASH_Address(dObj, dObj->cacheBlock * DRV_FLASH_ERASE_BLOCKS)
+                    + (dObj->flushPage * NVMCTRL_FLASH_PAGESIZE);
+
+            (void) NVMCTRL_PageWrite((const uint32_t *)(const void *)&dObj->eraseBuffer[dObj->flushPage * NVMCTRL_FLASH_PAGESIZE],
+                    address);
+            dObj->flushPage++;
+            dObj->flushState = DRV_FLASH_FLUSH_WRITE;
+
+            return false;
+        }
+
+        dObj->cacheDirty = false;
+    }
+    else
+    {
+        /* The RAM copy holds writes that were reported complete, so it is
+           kept dirty and written back again after the flush delay. The
+           error is reported to the next write. */
+        dObj->writeFailed = true;
+        dObj->lastWriteCount = SYS_TIME_CounterGet();
+    }
+
+    dObj->flushState = DRV_FLASH_FLUSH_IDLE;
+
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Driver Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+SYS_MODULE_OBJ DRV_FLASH_Initialize( const SYS_MODULE_INDEX drvIndex, const SYS_MODULE_INIT * const init )
+{
+    DRV_FLASH_OBJ * dObj = &gDrvFlashObj;
+    const DRV_FLASH_INIT * flashInit = (const DRV_FLASH_INIT *)init;
+
+    if ((drvIndex != 0U) || (flashInit == NULL) || (flashInit->eraseBuffer == NULL) ||
+        (flashInit->mediaSize == 0U) ||
+        ((flashInit->startAddress % NVMCTRL_FLASH_BLOCKSIZE) != 0U) ||
+        ((flashInit->mediaSize % NVMCTRL_FLASH_BLOCKSIZE) != 0U))
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
+    if (dObj->status == SYS_STATUS_READY)
+    {
+        /* Driver is already initialized */
+        return (SYS_MODULE_OBJ)drvIndex;
+    }
+
+    (void) memset(dObj, 0, sizeof(DRV_FLASH_OBJ));
+
+    if (OSAL_MUTEX_Create(&dObj->mutex) != OSAL_RESULT_SUCCESS)
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
+    dObj->startAddress = flashInit->startAddress;
+    dObj->mediaSize = flashInit->mediaSize;
+    dObj->eraseBuffer = flashInit->eraseBuffer;
+    dObj->clientToken = 1U;
+    dObj->commandToken = 1U;
+
+    dObj->mediaGeometryTable[SYS_MEDIA_GEOMETRY_TABLE_READ_ENTRY].blockSize = DRV_FLASH_BLOCK_SIZE;
+    dObj->mediaGeometryTable[SYS_MEDIA_GEOMETRY_TABLE_READ_ENTRY].numBlocks = dObj->mediaSize / DRV_FLASH_BLOCK_SIZE;
+    dObj->mediaGeometryTable[SYS_MEDIA_GEOMETRY_TABLE_WRITE_ENTRY].blockSize = DRV_FLASH_BLOCK_SIZE;
+    dObj->mediaGeometryTable[SYS_MEDIA_GEOMETRY_TABLE_WRITE_ENTRY].numBlocks = dObj->mediaSize / DRV_FLASH_BLOCK_SIZE;
+    dObj->mediaGeometryTable[SYS_MEDIA_GEOMETRY_TABLE_ERASE_ENTRY].blockSize = NVMCTRL_FLASH_BLOCKSIZE;
+    dObj->mediaGeometryTable[SYS_MEDIA_GEOMETRY_TABLE_ERASE_ENTRY].numBlocks = dObj->mediaSize / NVMCTRL_FLASH_BLOCKSIZE;
+
+    dObj->mediaGeometryObj.mediaProperty = SYS_MEDIA_READ_IS_BLOCKING;
+    dObj->mediaGeometryObj.numReadRegions = 1;
+    dObj->mediaGeometryObj.numWriteRegions = 1;
+    dObj->mediaGeometryObj.numEraseRegions = 1;
+    dObj->mediaGeometryObj.geometryTable = dObj->mediaGeometryTable;
+
+    dObj->status = SYS_STATUS_READY;
+
+    return (SYS_MODULE_OBJ)drvIndex;
+}
+
+SYS_STATUS DRV_FLASH_Status( SYS_MODULE_OBJ object )
+{
+    if (object != 0U)
+    {
+        return SYS_STATUS_UNINITIALIZED;
+    }
+
+    return gDrvFlashObj.status;
+}
+
+void DRV_FLASH_Tasks( SYS_MODULE_OBJ object )
+{
+    DRV_FLASH_OBJ * dObj = &gDrvFlashObj;
+    DRV_FLASH_EVENT_HANDLER eventHandler = NULL;
+    DRV_FLASH_COMMAND_HANDLE commandHandle = DRV_FLASH_COMMAND_HANDLE_INVALID;
+    DRV_FLASH_EVENT event = DRV_FLASH_EVENT_COMMAND_COMPLETE;
+    uintptr_t context = 0U;
+    bool failed = false;
+    bool flushEnded = false;
+    bool interruptState;
+
+    if ((object != 0U) || (dObj->status != SYS_STATUS_READY))
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+    {
+        return;
+    }
+
+    if (dObj->flushState == DRV_FLASH_FLUSH_IDLE)
+    {
+        if ((dObj->cacheDirty == true) &&
+            (SYS_TIME_CountToMS(SYS_TIME_CounterGet() - dObj->lastWriteCount) >= DRV_FLASH_FLUSH_DELAY_MS))
+        {
+            lDRV_FLASH_FlushStart(dObj);
+        }
+    }
+    else
+    {
+        /* The UF2 driver loads the page buffer too, so nothing may start an
+           NVMCTRL command between the check and the command */
+        interruptState = SYS_INT_Disable();
+        flushEnded = ((lDRV_FLASH_NVMIsBusy() == false) && (lDRV_FLASH_FlushProgress(dObj, &failed) == true));
+        SYS_INT_Restore(interruptState);
+    }
+
+    if ((flushEnded == true) && (dObj->writePending == true))
+    {
+        if ((failed == true) || (lDRV_FLASH_WriteProgress(dObj) == true))
+        {
+            dObj->writePending = false;
+
+            if (dObj->writeClient != NULL)
+            {
+                eventHandler = dObj->writeClient->eventHandler;
+                context = dObj->writeClient->context;
+                commandHandle = dObj->writeHandle;
+                event = failed ? DRV_FLASH_EVENT_COMMAND_ERROR : DRV_FLASH_EVENT_COMMAND_COMPLETE;
+            }
+
+            if (failed == true)
+            {
+                dObj->writeFailed = false;
+            }
+        }
+    }
+
+    (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+    if (eventHandler != NULL)
+    {
+        eventHandler((SYS_MEDIA_BLOCK_EVENT)event, commandHandle, context);
+    }
+}
+
+bool DRV_FLASH_IsBusy( SYS_MODULE_OBJ object )
+{
+    if (object != 0U)
+    {
+        return false;
+    }
+
+    return ((gDrvFlashObj.flushState != DRV_FLASH_FLUSH_IDLE) || (gDrvFlashObj.writePending == true));
+}
+
+DRV_HANDLE DRV_FLASH_Open( const SYS_MODULE_INDEX drvIndex, const DRV_IO_INTENT ioIntent )
+{
+    DRV_FLASH_OBJ * dObj = &gDrvFlashObj;
+    DRV_HANDLE handle = DRV_HANDLE_INVALID;
+    uint32_t index;
+
+    if ((drvIndex != 0U) || (dObj->status != SYS_STATUS_READY))
+    {
+        return DRV_HANDLE_INVALID;
+    }
+
+    if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+    {
+        return DRV_HANDLE_INVALID;
+    }
+
+    for (index = 0U; index < DRV_FLASH_CLIENTS_NUMBER; index++)
+    {
+        if (dObj->clientObj[index].inUse == false)
+        {
+            handle = ((uint32_t)dObj->clientToken << 16) | index;
+            dObj->clientToken = lDRV_FLASH_UPDATE_TOKEN(dObj->clientToken);
+
+            dObj->clientObj[index].inUse = true;
+            dObj->clientObj[index].ioIntent = ioIntent;
+            dObj->clientObj[index].clientHandle = handle;
+            dObj->clientObj[index].eventHandler = NULL;
+            dObj->clientObj[index].context = 0U;
+            break;
+        }
+    }
+
+    (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+    return handle;
+}
+
+void DRV_FLASH_Close( DRV_HANDLE handle )
+{
+    DRV_FLASH_CLIENT_OBJ * clientObj = lDRV_FLASH_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&gDrvFlashObj.mutex, OSAL_WAIT_FOREVER) == OSAL_RESULT_SUCCESS)
+    {
+        /* A pending write of the client still completes, silently */
+        if (gDrvFlashObj.writeClient == clientObj)
+        {
+            gDrvFlashObj.writeClient = NULL;
+        }
+
+        clientObj->inUse = false;
+        (void) OSAL_MUTEX_Unlock(&gDrvFlashObj.mutex);
+    }
+}
+
+void DRV_FLASH_AsyncRead( const DRV_HANDLE handle, DRV_FLASH_COMMAND_HANDLE * commandHandle,
+        void * targetBuffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    DRV_FLASH_OBJ * dObj = &gDrvFlashObj;
+    DRV_FLASH_CLIENT_OBJ * clientObj = lDRV_FLASH_DriverHandleValidate(handle);
+    DRV_FLASH_COMMAND_HANDLE readHandle;
+    uint8_t * target = (uint8_t *)targetBuffer;
+    uint32_t offset;
+    uint32_t blocks;
+
+    if (commandHandle != NULL)
+    {
+        *commandHandle = DRV_FLASH_COMMAND_HANDLE_INVALID;
+    }
+
+    if ((clientObj == NULL) || (target == NULL) || (lDRV_FLASH_RangeIsValid(dObj, blockStart, nBlocks) == false))
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+    {
+        return;
+    }
+
+    while (nBlocks != 0U)
+    {
+        offset = blockStart % DRV_FLASH_ERASE_BLOCKS;
+        blocks = DRV_FLASH_ERASE_BLOCKS - offset;
+        if (blocks > nBlocks)
+        {
+            blocks = nBlocks;
+        }
+
+        if ((dObj->cacheValid == true) && (dObj->cacheBlock == (blockStart / DRV_FLASH_ERASE_BLOCKS)))
+        {
+            (void) memcpy(target, &dObj->eraseBuffer[offset * DRV_FLASH_BLOCK_SIZE], blocks * DRV_FLASH_BLOCK_SIZE);
+        }
+        else
+        {
+            (void) memcpy(target, lDRV_FLASH_Address(dObj, blockStart), blocks * DRV_FLASH_BLOCK_SIZE);
+        }
+
+        target += blocks * DRV_FLASH_BLOCK_SIZE;
+        blockStart += blocks;
+        nBlocks -= blocks;
+    }
+
+    readHandle = ((uint32_t)dObj->commandToken << 16) | ((uint32_t)handle & DRV_FLASH_INDEX_MASK);
+    dObj->commandToken = lDRV_FLASH_UPDATE_TOKEN(dObj->commandToken);
+
+    (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+    if (commandHandle != NULL)
+    {
+        *commandHandle = readHandle;
+    }
+
+    if (clientObj->eventHandler != NULL)
+    {
+        clientObj->eventHandler((SYS_MEDIA_BLOCK_EVENT)DRV_FLASH_EVENT_COMMAND_COMPLETE, readHandle, clientObj->context);
+    }
+}
+
+void DRV_FLASH_AsyncWrite( const DRV_HANDLE handle, DRV_FLASH_COMMAND_HANDLE * commandHandle,
+        void * sourceBuffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    DRV_FLASH_OBJ * dObj = &gDrvFlashObj;
+    DRV_FLASH_CLIENT_OBJ * clientObj = lDRV_FLASH_DriverHandleValidate(handle);
+    DRV_FLASH_COMMAND_HANDLE writeHandle;
+    DRV_FLASH_EVENT event = DRV_FLASH_EVENT_COMMAND_COMPLETE;
+    bool completed;
+
+    if (commandHandle != NULL)
+    {
+        *commandHandle = DRV_FLASH_COMMAND_HANDLE_INVALID;
+    }
+
+    if ((clientObj == NULL) || (sourceBuffer == NULL) ||
+        (((uint32_t)clientObj->ioIntent & (uint32_t)DRV_IO_INTENT_WRITE) == 0U) ||
+        (lDRV_FLASH_RangeIsValid(dObj, blockStart, nBlocks) == false))
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+    {
+        return;
+    }
+
+    if (dObj->writePending == true)
+    {
+        (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+        return;
+    }
+
+    writeHandle = ((uint32_t)dObj->commandToken << 16) | ((uint32_t)handle & DRV_FLASH_INDEX_MASK);
+    dObj->commandToken = lDRV_FLASH_UPDATE_TOKEN(dObj->commandToken);
+
+    if (dObj->writeFailed == true)
+    {
+        /* A write back failed since the last write: this write fails
+           without being applied, and the RAM copy is written back again */
+        dObj->writeFailed = false;
+        event = DRV_FLASH_EVENT_COMMAND_ERROR;
+        completed = true;
+    }
+    else
+    {
+        dObj->writeClient = clientObj;
+        dObj->writeHandle = writeHandle;
+        dObj->writeBuffer = (const uint8_t *)sourceBuffer;
+        dObj->writeBlock = blockStart;
+        dObj->writeBlocks = nBlocks;
+
+        completed = lDRV_FLASH_WriteProgress(dObj);
+        dObj->writePending = !completed;
+    }
+
+    (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+    if (commandHandle != NULL)
+    {
+        *commandHandle = writeHandle;
+    }
+
+    if ((completed == true) && (clientObj->eventHandler != NULL))
+    {
+        clientObj->eventHandler((SYS_MEDIA_BLOCK_EVENT)event, writeHandle, clientObj->context);
+    }
+}
+
+SYS_MEDIA_GEOMETRY * DRV_FLASH_GeometryGet( const DRV_HANDLE handle )
+{
+    if (lDRV_FLASH_DriverHandleValidate(handle) == NULL)
+    {
+        return NULL;
+    }
+
+    return &gDrvFlashObj.mediaGeometryObj;
+}
+
+/* MISRA C-2012 Rule 11.1 deviated:1 Deviation record ID -  H3_MISRAC_2012_R_11_1_DR_1 */
+void DRV_FLASH_EventHandlerSet( const DRV_HANDLE handle, const void * eventHandler, const uintptr_t context )
+{
+    DRV_FLASH_CLIENT_OBJ * clientObj = lDRV_FLASH_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&gDrvFlashObj.mutex, OSAL_WAIT_FOREVER) == OSAL_RESULT_SUCCESS)
+    {
+        clientObj->eventHandler = (DRV_FLASH_EVENT_HANDLER)eventHandler;
+        clientObj->context = context;
+        (void) OSAL_MUTEX_Unlock(&gDrvFlashObj.mutex);
+    }
+}
+/* MISRAC 2012 deviation block end */
+
+bool DRV_FLASH_IsAttached( const DRV_HANDLE handle )
+{
+    return (lDRV_FLASH_DriverHandleValidate(handle) != NULL);
+}
+
+bool DRV_FLASH_IsWriteProtected( const DRV_HANDLE handle )
+{
+    DRV_FLASH_CLIENT_OBJ * clientObj = lDRV_FLASH_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return false;
+    }
+
+    return (((uint32_t)clientObj->ioIntent & (uint32_t)DRV_IO_INTENT_WRITE) == 0U);
+}
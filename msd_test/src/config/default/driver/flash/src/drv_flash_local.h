@@ -0,0 +1,174 @@
+/*******************************************************************************
+  Flash Media Driver Local Data Structures
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_flash_local.h
+
+  Summary:
+    Flash Media Driver local declarations and structures.
+
+  Description:
+    This file contains the Flash Media Driver's local declarations and
+    definitions.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+
+#ifndef DRV_FLASH_LOCAL_H
+#define DRV_FLASH_LOCAL_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: File includes
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "driver/flash/drv_flash.h"
+#include "peripheral/nvmctrl/plib_nvmctrl.h"
+#include "osal/osal.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Helper Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* Flash Driver Handle Macros */
+#define DRV_FLASH_INDEX_MASK                    (0x000000FFU)
+#define DRV_FLASH_TOKEN_MAX                     (0xFFFFU)
+
+/* Media blocks in an erase block and in a page */
+#define DRV_FLASH_ERASE_BLOCKS                  (NVMCTRL_FLASH_BLOCKSIZE / DRV_FLASH_BLOCK_SIZE)
+#define DRV_FLASH_PAGES                         (NVMCTRL_FLASH_BLOCKSIZE / NVMCTRL_FLASH_PAGESIZE)
+
+/* Error flags of NVMCTRL_ErrorGet */
+#define DRV_FLASH_NVM_ERRORS                    (NVMCTRL_INTFLAG_ADDRE_Msk | NVMCTRL_INTFLAG_PROGE_Msk | \
+                                                 NVMCTRL_INTFLAG_LOCKE_Msk | NVMCTRL_INTFLAG_NVME_Msk)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Steps of the write back of the RAM copy of the erase block */
+typedef enum
+{
+    /* The RAM copy is not being written back */
+    DRV_FLASH_FLUSH_IDLE = 0,
+
+    /* Waits for the NVMCTRL and the SmartEEPROM to be idle to erase the
+       block */
+    DRV_FLASH_FLUSH_START,
+
+    /* Waits for the erase of the block */
+    DRV_FLASH_FLUSH_ERASE,
+
+    /* Writes the pages, one at a time */
+    DRV_FLASH_FLUSH_WRITE
+
+} DRV_FLASH_FLUSH_STATE;
+
+/* Flash Driver client object */
+typedef struct
+{
+    /* The client is open */
+    bool                            inUse;
+
+    /* Intent the client was opened with */
+    DRV_IO_INTENT                   ioIntent;
+
+    /* Client handle returned by DRV_FLASH_Open */
+    DRV_HANDLE                      clientHandle;
+
+    /* Function called when a request of the client ends */
+    DRV_FLASH_EVENT_HANDLER         eventHandler;
+
+    uintptr_t                       context;
+
+} DRV_FLASH_CLIENT_OBJ;
+
+/* Flash Driver instance object */
+typedef struct
+{
+    SYS_STATUS                      status;
+
+    /* Region of the media */
+    uint32_t                        startAddress;
+    uint32_t                        mediaSize;
+
+    /* RAM copy of the erase block number cacheBlock. cacheDirty is set when
+       it differs from the flash. */
+    uint8_t *                       eraseBuffer;
+    uint32_t                        cacheBlock;
+    bool                            cacheValid;
+    bool                            cacheDirty;
+
+    /* Counter value at the last write to the RAM copy */
+    uint32_t                        lastWriteCount;
+
+    /* Write back of the RAM copy in progress and next page to write */
+    DRV_FLASH_FLUSH_STATE           flushState;
+    uint32_t                        flushPage;
+
+    /* Write that waits for the write back, and the part of it not yet
+       copied to the RAM copy. writeFailed is set when a write back fails
+       and cleared when a write reports the error. */
+    bool                            writePending;
+    bool                            writeFailed;
+    DRV_FLASH_CLIENT_OBJ *          writeClient;
+    DRV_FLASH_COMMAND_HANDLE        writeHandle;
+    const uint8_t *                 writeBuffer;
+    uint32_t                        writeBlock;
+    uint32_t                        writeBlocks;
+
+    /* Token of the next client and command handles */
+    uint16_t                        clientToken;
+    uint16_t                        commandToken;
+
+    DRV_FLASH_CLIENT_OBJ            clientObj[DRV_FLASH_CLIENTS_NUMBER];
+
+    /* Flash driver geometry object */
+    SYS_MEDIA_GEOMETRY              mediaGeometryObj;
+
+    /* Flash driver media geometry table */
+    SYS_MEDIA_REGION_GEOMETRY       mediaGeometryTable[3];
+
+    /* Mutex to protect the RAM copy and the pending write */
+    OSAL_MUTEX_DECLARE(mutex);
+
+} DRV_FLASH_OBJ;
+
+#endif //#ifndef DRV_FLASH_LOCAL_H
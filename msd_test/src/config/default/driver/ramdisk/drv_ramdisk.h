@@ -0,0 +1,339 @@
+/*******************************************************************************
+  RAM Disk Media Driver Interface Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_ramdisk.h
+
+  Summary:
+    RAM Disk Media Driver interface.
+
+  Description:
+    This file defines the interface to the RAM Disk Media Driver. The driver
+    presents a RAM buffer as a block media of 512 byte blocks with the
+    interface the MSD function driver expects from a media driver. It takes
+    the media out of the timing of the MSD function, so the time a host sees
+    on it is the time of the USB device stack.
+
+    A request completes in the call, or after the latency of the
+    initialization data to model a slower media.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef DRV_RAMDISK_H    // Guards against multiple inclusion
+#define DRV_RAMDISK_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+#include "driver/driver_common.h"
+#include "system/system_module.h"
+#include "system/system_media.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Clients that may have the driver open at the same time */
+#ifndef DRV_RAMDISK_CLIENTS_NUMBER
+    #define DRV_RAMDISK_CLIENTS_NUMBER      (1U)
+#endif
+
+/* Size of a media block in bytes */
+#define DRV_RAMDISK_BLOCK_SIZE              (512U)
+
+// *****************************************************************************
+/* RAM Disk Media Driver command handle
+
+  Summary:
+    Identifies a read or write request.
+
+  Remarks:
+    Refer system_media.h for the definition of SYS_MEDIA_BLOCK_COMMAND_HANDLE.
+*/
+
+typedef SYS_MEDIA_BLOCK_COMMAND_HANDLE DRV_RAMDISK_COMMAND_HANDLE;
+
+#define DRV_RAMDISK_COMMAND_HANDLE_INVALID SYS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID
+
+// *****************************************************************************
+/* RAM Disk Media Driver events
+
+  Summary:
+    Identifies the result of a request.
+*/
+
+typedef enum
+{
+    /* The request is complete */
+    DRV_RAMDISK_EVENT_COMMAND_COMPLETE = SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE,
+
+    /* Not reported by this driver, kept for the media interface */
+    DRV_RAMDISK_EVENT_COMMAND_ERROR = SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR
+
+} DRV_RAMDISK_EVENT;
+
+// *****************************************************************************
+/* RAM Disk Media Driver event handler
+
+  Summary:
+    Pointer to the function called when a request ends.
+
+  Description:
+    Without latency the handler is called before the read or write function
+    returns. With a latency it is called from DRV_RAMDISK_Tasks.
+*/
+
+typedef SYS_MEDIA_EVENT_HANDLER DRV_RAMDISK_EVENT_HANDLER;
+
+// *****************************************************************************
+/* RAM Disk Media Driver initialization data
+
+  Summary:
+    Defines the RAM buffer of the media and its latency.
+*/
+
+typedef struct
+{
+    /* RAM buffer holding the media */
+    uint8_t * mediaBuffer;
+
+    /* Size of the buffer in bytes. Must be a multiple of a block. */
+    uint32_t mediaSize;
+
+    /* Time from a request to its completion, in microseconds. The data is
+       moved at the completion. 0 completes the requests in the call. */
+    uint32_t latencyUS;
+
+} DRV_RAMDISK_INIT;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines - System Level
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    SYS_MODULE_OBJ DRV_RAMDISK_Initialize ( const SYS_MODULE_INDEX drvIndex,
+                                            const SYS_MODULE_INIT * const init )
+
+  Summary:
+    Initializes the driver over the buffer given by the initialization data.
+
+  Parameters:
+    drvIndex - DRV_RAMDISK_INDEX_0.
+    init     - Pointer to a DRV_RAMDISK_INIT structure.
+
+  Returns:
+    The driver object, or SYS_MODULE_OBJ_INVALID if the index or the buffer
+    is not valid.
+
+  Remarks:
+    The content of the buffer is kept.
+*/
+
+SYS_MODULE_OBJ DRV_RAMDISK_Initialize ( const SYS_MODULE_INDEX drvIndex, const SYS_MODULE_INIT * const init );
+
+//******************************************************************************
+/* Function:
+    SYS_STATUS DRV_RAMDISK_Status ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Returns SYS_STATUS_READY once the driver is initialized.
+*/
+
+SYS_STATUS DRV_RAMDISK_Status ( SYS_MODULE_OBJ object );
+
+//******************************************************************************
+/* Function:
+    void DRV_RAMDISK_Tasks ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Completes the requests whose latency has expired.
+
+  Remarks:
+    Must be called while DRV_RAMDISK_IsBusy returns true. Only needed with a
+    latency.
+*/
+
+void DRV_RAMDISK_Tasks ( SYS_MODULE_OBJ object );
+
+//******************************************************************************
+/* Function:
+    bool DRV_RAMDISK_IsBusy ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Returns true while a request whose latency has expired waits for
+    DRV_RAMDISK_Tasks.
+*/
+
+bool DRV_RAMDISK_IsBusy ( SYS_MODULE_OBJ object );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines - Client Level
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    DRV_HANDLE DRV_RAMDISK_Open ( const SYS_MODULE_INDEX drvIndex,
+                                  const DRV_IO_INTENT ioIntent )
+
+  Summary:
+    Opens a client of the driver.
+
+  Returns:
+    DRV_HANDLE_INVALID if the driver is not ready or all the clients are in
+    use.
+*/
+
+DRV_HANDLE DRV_RAMDISK_Open ( const SYS_MODULE_INDEX drvIndex, const DRV_IO_INTENT ioIntent );
+
+//******************************************************************************
+/* Function:
+    void DRV_RAMDISK_Close ( DRV_HANDLE handle )
+
+  Summary:
+    Closes a client. A request of the client in progress is dropped.
+*/
+
+void DRV_RAMDISK_Close ( DRV_HANDLE handle );
+
+//******************************************************************************
+/* Function:
+    void DRV_RAMDISK_AsyncRead ( const DRV_HANDLE handle,
+                                 DRV_RAMDISK_COMMAND_HANDLE * commandHandle,
+                                 void * targetBuffer,
+                                 uint32_t blockStart, uint32_t nBlocks )
+
+  Summary:
+    Reads nBlocks blocks from blockStart.
+
+  Returns:
+    DRV_RAMDISK_COMMAND_HANDLE_INVALID in commandHandle if the handle or the
+    block range is not valid, or if a request of the client is in progress.
+*/
+
+void DRV_RAMDISK_AsyncRead ( const DRV_HANDLE handle, DRV_RAMDISK_COMMAND_HANDLE * commandHandle,
+        void * targetBuffer, uint32_t blockStart, uint32_t nBlocks );
+
+//******************************************************************************
+/* Function:
+    void DRV_RAMDISK_AsyncWrite ( const DRV_HANDLE handle,
+                                  DRV_RAMDISK_COMMAND_HANDLE * commandHandle,
+                                  void * sourceBuffer,
+                                  uint32_t blockStart, uint32_t nBlocks )
+
+  Summary:
+    Writes nBlocks blocks from blockStart.
+
+  Returns:
+    DRV_RAMDISK_COMMAND_HANDLE_INVALID in commandHandle if the handle or the
+    block range is not valid, or if a request of the client is in progress.
+
+  Remarks:
+    With a latency, the source buffer must stay valid until the request
+    completes.
+*/
+
+void DRV_RAMDISK_AsyncWrite ( const DRV_HANDLE handle, DRV_RAMDISK_COMMAND_HANDLE * commandHandle,
+        void * sourceBuffer, uint32_t blockStart, uint32_t nBlocks );
+
+//******************************************************************************
+/* Function:
+    SYS_MEDIA_GEOMETRY * DRV_RAMDISK_GeometryGet ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns the geometry of the media, one region of DRV_RAMDISK_BLOCK_SIZE
+    byte blocks for reads, writes and erases.
+*/
+
+SYS_MEDIA_GEOMETRY * DRV_RAMDISK_GeometryGet ( const DRV_HANDLE handle );
+
+//******************************************************************************
+/* Function:
+    void DRV_RAMDISK_EventHandlerSet ( const DRV_HANDLE handle,
+                                       const void * eventHandler,
+                                       const uintptr_t context )
+
+  Summary:
+    Sets the function called when a request of the client ends.
+*/
+
+void DRV_RAMDISK_EventHandlerSet ( const DRV_HANDLE handle, const void * eventHandler, const uintptr_t context );
+
+//******************************************************************************
+/* Function:
+    bool DRV_RAMDISK_IsAttached ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns true for a valid handle.
+*/
+
+bool DRV_RAMDISK_IsAttached ( const DRV_HANDLE handle );
+
+//******************************************************************************
+/* Function:
+    bool DRV_RAMDISK_IsWriteProtected ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns true if the client was opened without DRV_IO_INTENT_WRITE.
+*/
+
+bool DRV_RAMDISK_IsWriteProtected ( const DRV_HANDLE handle );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    }
+#endif
+//DOM-IGNORE-END
+
+#endif // DRV_RAMDISK_H
@@ -0,0 +1,450 @@
+/*******************************************************************************
+  RAM Disk Media Driver Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_ramdisk.c
+
+  Summary:
+    Source code for the RAM Disk Media Driver.
+
+  Description:
+    This file contains the source code for the RAM Disk Media Driver. Each
+    client has at most one request in progress. Without latency the request
+    moves its data and completes in the call. With a latency it starts a
+    single shot SYS_TIME callback, whose interrupt wakes DRV_RAMDISK_Tasks to
+    move the data and complete it.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "configuration.h"
+#include "driver/ramdisk/src/drv_ramdisk_local.h"
+#include "system/memory/sys_memory.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+static DRV_RAMDISK_OBJ gDrvRamDiskObj;
+SYS_MEMORY_OBJECT_REGISTER(gDrvRamDiskObj);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static inline uint16_t lDRV_RAMDISK_UPDATE_TOKEN(uint16_t token)
+{
+    token++;
+
+    if (token >= DRV_RAMDISK_TOKEN_MAX)
+    {
+        token = 1;
+    }
+
+    return token;
+}
+
+static DRV_RAMDISK_CLIENT_OBJ * lDRV_RAMDISK_DriverHandleValidate( DRV_HANDLE handle )
+{
+    DRV_RAMDISK_CLIENT_OBJ * clientObj;
+    uint32_t index;
+
+    if ((handle == DRV_HANDLE_INVALID) || (gDrvRamDiskObj.status != SYS_STATUS_READY))
+    {
+        return NULL;
+    }
+
+    index = (uint32_t)handle & DRV_RAMDISK_INDEX_MASK;
+    if (index >= DRV_RAMDISK_CLIENTS_NUMBER)
+    {
+        return NULL;
+    }
+
+    clientObj = &gDrvRamDiskObj.clientObj[index];
+    if ((clientObj->inUse == false) || (clientObj->clientHandle != handle))
+    {
+        return NULL;
+    }
+
+    return clientObj;
+}
+
+static void lDRV_RAMDISK_TimerCallback( uintptr_t context )
+{
+    volatile bool * expiredFlag = (volatile bool *)context;
+
+    *expiredFlag = true;
+}
+
+/* Moves the data of the request of the client */
+static void lDRV_RAMDISK_Transfer( const DRV_RAMDISK_OBJ * dObj, const DRV_RAMDISK_CLIENT_OBJ * clientObj )
+{
+    uint8_t * media = &dObj->mediaBuffer[clientObj->requestBlock * DRV_RAMDISK_BLOCK_SIZE];
+    size_t size = (size_t)clientObj->requestBlocks * DRV_RAMDISK_BLOCK_SIZE;
+
+    if (clientObj->requestIsWrite)
+    {
+        (void) memcpy(media, clientObj->requestBuffer, size);
+    }
+    else
+    {
+        (void) memcpy(clientObj->requestBuffer, media, size);
+    }
+}
+
+static void lDRV_RAMDISK_Submit( const DRV_HANDLE handle, DRV_RAMDISK_COMMAND_HANDLE * commandHandle,
+        void * buffer, uint32_t blockStart, uint32_t nBlocks, bool isWrite )
+{
+    DRV_RAMDISK_OBJ * dObj = &gDrvRamDiskObj;
+    DRV_RAMDISK_CLIENT_OBJ * clientObj = lDRV_RAMDISK_DriverHandleValidate(handle);
+    DRV_RAMDISK_COMMAND_HANDLE requestHandle;
+    uint32_t numBlocks = dObj->mediaGeometryTable[SYS_MEDIA_GEOMETRY_TABLE_READ_ENTRY].numBlocks;
+    bool completed = false;
+
+    if (commandHandle != NULL)
+    {
+        *commandHandle = DRV_RAMDISK_COMMAND_HANDLE_INVALID;
+    }
+
+    if ((clientObj == NULL) || (buffer == NULL) || (nBlocks == 0U) ||
+        (blockStart >= numBlocks) || (nBlocks > (numBlocks - blockStart)) ||
+        (isWrite && (((uint32_t)clientObj->ioIntent & (uint32_t)DRV_IO_INTENT_WRITE) == 0U)))
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+    {
+        return;
+    }
+
+    if (clientObj->requestPending == true)
+    {
+        (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+        return;
+    }
+
+    requestHandle = ((uint32_t)dObj->commandToken << 16) | ((uint32_t)handle & DRV_RAMDISK_INDEX_MASK);
+    dObj->commandToken = lDRV_RAMDISK_UPDATE_TOKEN(dObj->commandToken);
+
+    clientObj->requestIsWrite = isWrite;
+    clientObj->requestHandle = requestHandle;
+    clientObj->requestBuffer = (uint8_t *)buffer;
+    clientObj->requestBlock = blockStart;
+    clientObj->requestBlocks = nBlocks;
+
+    if (dObj->latencyUS == 0U)
+    {
+        lDRV_RAMDISK_Transfer(dObj, clientObj);
+        completed = true;
+    }
+    else
+    {
+        clientObj->requestExpired = false;
+        clientObj->requestPending = true;
+
+        if (SYS_TIME_CallbackRegisterUS(lDRV_RAMDISK_TimerCallback, (uintptr_t)&clientObj->requestExpired,
+                dObj->latencyUS, SYS_TIME_SINGLE) == SYS_TIME_HANDLE_INVALID)
+        {
+            /* No timer left, complete on the next run of the task */
+            clientObj->requestExpired = true;
+        }
+    }
+
+    (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+    if (commandHandle != NULL)
+    {
+        *commandHandle = requestHandle;
+    }
+
+    if ((completed == true) && (clientObj->eventHandler != NULL))
+    {
+        clientObj->eventHandler((SYS_MEDIA_BLOCK_EVENT)DRV_RAMDISK_EVENT_COMMAND_COMPLETE, requestHandle, clientObj->context);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Driver Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+SYS_MODULE_OBJ DRV_RAMDISK_Initialize( const SYS_MODULE_INDEX drvIndex, const SYS_MODULE_INIT * const init )
+{
+    DRV_RAMDISK_OBJ * dObj = &gDrvRamDiskObj;
+    const DRV_RAMDISK_INIT * ramDiskInit = (const DRV_RAMDISK_INIT *)init;
+    uint32_t numBlocks;
+    uint32_t i;
+
+    if ((drvIndex != 0U) || (ramDiskInit == NULL) || (ramDiskInit->mediaBuffer == NULL) ||
+        (ramDiskInit->mediaSize == 0U) || ((ramDiskInit->mediaSize % DRV_RAMDISK_BLOCK_SIZE) != 0U))
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
+    if (dObj->status == SYS_STATUS_READY)
+    {
+        /* Driver is already initialized */
+        return (SYS_MODULE_OBJ)drvIndex;
+    }
+
+    (void) memset(dObj, 0, sizeof(DRV_RAMDISK_OBJ));
+
+    if (OSAL_MUTEX_Create(&dObj->mutex) != OSAL_RESULT_SUCCESS)
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
+    dObj->mediaBuffer = ramDiskInit->mediaBuffer;
+    dObj->mediaSize = ramDiskInit->mediaSize;
+    dObj->latencyUS = ramDiskInit->latencyUS;
+    dObj->clientToken = 1U;
+    dObj->commandToken = 1U;
+
+    numBlocks = dObj->mediaSize / DRV_RAMDISK_BLOCK_SIZE;
+    for (i = 0U; i <= (uint32_t)SYS_MEDIA_GEOMETRY_TABLE_ERASE_ENTRY; i++)
+    {
+        dObj->mediaGeometryTable[i].blockSize = DRV_RAMDISK_BLOCK_SIZE;
+        dObj->mediaGeometryTable[i].numBlocks = numBlocks;
+    }
+
+    if (dObj->latencyUS == 0U)
+    {
+        dObj->mediaGeometryObj.mediaProperty = (SYS_MEDIA_PROPERTY)((uint32_t)SYS_MEDIA_READ_IS_BLOCKING |
+                (uint32_t)SYS_MEDIA_WRITE_IS_BLOCKING);
+    }
+    dObj->mediaGeometryObj.numReadRegions = 1;
+    dObj->mediaGeometryObj.numWriteRegions = 1;
+    dObj->mediaGeometryObj.numEraseRegions = 1;
+    dObj->mediaGeometryObj.geometryTable = dObj->mediaGeometryTable;
+
+    dObj->status = SYS_STATUS_READY;
+
+    return (SYS_MODULE_OBJ)drvIndex;
+}
+
+SYS_STATUS DRV_RAMDISK_Status( SYS_MODULE_OBJ object )
+{
+    if (object != 0U)
+    {
+        return SYS_STATUS_UNINITIALIZED;
+    }
+
+    return gDrvRamDiskObj.status;
+}
+
+void DRV_RAMDISK_Tasks( SYS_MODULE_OBJ object )
+{
+    DRV_RAMDISK_OBJ * dObj = &gDrvRamDiskObj;
+    DRV_RAMDISK_CLIENT_OBJ * clientObj;
+    DRV_RAMDISK_EVENT_HANDLER eventHandler;
+    DRV_RAMDISK_COMMAND_HANDLE requestHandle = DRV_RAMDISK_COMMAND_HANDLE_INVALID;
+    uintptr_t context = 0U;
+    uint32_t i;
+
+    if ((object != 0U) || (dObj->status != SYS_STATUS_READY))
+    {
+        return;
+    }
+
+    for (i = 0U; i < DRV_RAMDISK_CLIENTS_NUMBER; i++)
+    {
+        clientObj = &dObj->clientObj[i];
+        eventHandler = NULL;
+
+        if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+        {
+            return;
+        }
+
+        if ((clientObj->requestPending == true) && (clientObj->requestExpired == true))
+        {
+            lDRV_RAMDISK_Transfer(dObj, clientObj);
+            clientObj->requestPending = false;
+
+            eventHandler = clientObj->eventHandler;
+            context = clientObj->context;
+            requestHandle = clientObj->requestHandle;
+        }
+
+        (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+        /* Called without the mutex, so the handler may queue the next request */
+        if (eventHandler != NULL)
+        {
+            eventHandler((SYS_MEDIA_BLOCK_EVENT)DRV_RAMDISK_EVENT_COMMAND_COMPLETE, requestHandle, context);
+        }
+    }
+}
+
+bool DRV_RAMDISK_IsBusy( SYS_MODULE_OBJ object )
+{
+    uint32_t i;
+
+    if (object != 0U)
+    {
+        return false;
+    }
+
+    for (i = 0U; i < DRV_RAMDISK_CLIENTS_NUMBER; i++)
+    {
+        if ((gDrvRamDiskObj.clientObj[i].requestPending == true) && (gDrvRamDiskObj.clientObj[i].requestExpired == true))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+DRV_HANDLE DRV_RAMDISK_Open( const SYS_MODULE_INDEX drvIndex, const DRV_IO_INTENT ioIntent )
+{
+    DRV_RAMDISK_OBJ * dObj = &gDrvRamDiskObj;
+    DRV_HANDLE handle = DRV_HANDLE_INVALID;
+    uint32_t index;
+
+    if ((drvIndex != 0U) || (dObj->status != SYS_STATUS_READY))
+    {
+        return DRV_HANDLE_INVALID;
+    }
+
+    if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+    {
+        return DRV_HANDLE_INVALID;
+    }
+
+    for (index = 0U; index < DRV_RAMDISK_CLIENTS_NUMBER; index++)
+    {
+        if (dObj->clientObj[index].inUse == false)
+        {
+            handle = ((uint32_t)dObj->clientToken << 16) | index;
+            dObj->clientToken = lDRV_RAMDISK_UPDATE_TOKEN(dObj->clientToken);
+
+            dObj->clientObj[index].inUse = true;
+            dObj->clientObj[index].ioIntent = ioIntent;
+            dObj->clientObj[index].clientHandle = handle;
+            dObj->clientObj[index].eventHandler = NULL;
+            dObj->clientObj[index].context = 0U;
+            dObj->clientObj[index].requestPending = false;
+            break;
+        }
+    }
+
+    (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+    return handle;
+}
+
+void DRV_RAMDISK_Close( DRV_HANDLE handle )
+{
+    DRV_RAMDISK_CLIENT_OBJ * clientObj = lDRV_RAMDISK_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&gDrvRamDiskObj.mutex, OSAL_WAIT_FOREVER) == OSAL_RESULT_SUCCESS)
+    {
+        /* A timer still running only sets the flag of the closed client */
+        clientObj->requestPending = false;
+        clientObj->inUse = false;
+        (void) OSAL_MUTEX_Unlock(&gDrvRamDiskObj.mutex);
+    }
+}
+
+void DRV_RAMDISK_AsyncRead( const DRV_HANDLE handle, DRV_RAMDISK_COMMAND_HANDLE * commandHandle,
+        void * targetBuffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    lDRV_RAMDISK_Submit(handle, commandHandle, targetBuffer, blockStart, nBlocks, false);
+}
+
+void DRV_RAMDISK_AsyncWrite( const DRV_HANDLE handle, DRV_RAMDISK_COMMAND_HANDLE * commandHandle,
+        void * sourceBuffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    lDRV_RAMDISK_Submit(handle, commandHandle, sourceBuffer, blockStart, nBlocks, true);
+}
+
+SYS_MEDIA_GEOMETRY * DRV_RAMDISK_GeometryGet( const DRV_HANDLE handle )
+{
+    if (lDRV_RAMDISK_DriverHandleValidate(handle) == NULL)
+    {
+        return NULL;
+    }
+
+    return &gDrvRamDiskObj.mediaGeometryObj;
+}
+
+/* MISRA C-2012 Rule 11.1 deviated:1 Deviation record ID -  H3_MISRAC_2012_R_11_1_DR_1 */
+void DRV_RAMDISK_EventHandlerSet( const DRV_HANDLE handle, const void * eventHandler, const uintptr_t context )
+{
+    DRV_RAMDISK_CLIENT_OBJ * clientObj = lDRV_RAMDISK_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&gDrvRamDiskObj.mutex, OSAL_WAIT_FOREVER) == OSAL_RESULT_SUCCESS)
+    {
+        clientObj->eventHandler = (DRV_RAMDISK_EVENT_HANDLER)eventHandler;
+        clientObj->context = context;
+        (void) OSAL_MUTEX_Unlock(&gDrvRamDiskObj.mutex);
+    }
+}
+/* MISRAC 2012 deviation block end */
+
+bool DRV_RAMDISK_IsAttached( const DRV_HANDLE handle )
+{
+    return (lDRV_RAMDISK_DriverHandleValidate(handle) != NULL);
+}
+
+bool DRV_RAMDISK_IsWriteProtected( const DRV_HANDLE handle )
+{
+    DRV_RAMDISK_CLIENT_OBJ * clientObj = lDRV_RAMDISK_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return false;
+    }
+
+    return (((uint32_t)clientObj->ioIntent & (uint32_t)DRV_IO_INTENT_WRITE) == 0U);
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************
+  RAM Disk Media Driver Local Data Structures
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_ramdisk_local.h
+
+  Summary:
+    RAM Disk Media Driver local declarations and structures.
+
+  Description:
+    This file contains the RAM Disk Media Driver's local declarations and
+    definitions.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+
+#ifndef DRV_RAMDISK_LOCAL_H
+#define DRV_RAMDISK_LOCAL_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: File includes
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "driver/ramdisk/drv_ramdisk.h"
+#include "system/time/sys_time.h"
+#include "osal/osal.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Helper Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* RAM Disk Driver Handle Macros */
+#define DRV_RAMDISK_INDEX_MASK                  (0x000000FFU)
+#define DRV_RAMDISK_TOKEN_MAX                   (0xFFFFU)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* RAM Disk Driver client object */
+typedef struct
+{
+    /* The client is open */
+    bool                            inUse;
+
+    /* Intent the client was opened with */
+    DRV_IO_INTENT                   ioIntent;
+
+    /* Client handle returned by DRV_RAMDISK_Open */
+    DRV_HANDLE                      clientHandle;
+
+    /* Function called when a request of the client ends */
+    DRV_RAMDISK_EVENT_HANDLER       eventHandler;
+
+    uintptr_t                       context;
+
+    /* Request waiting for its latency to expire. requestExpired is set by
+       the SYS_TIME callback. */
+    bool                            requestPending;
+    volatile bool                   requestExpired;
+    bool                            requestIsWrite;
+    DRV_RAMDISK_COMMAND_HANDLE      requestHandle;
+    uint8_t *                       requestBuffer;
+    uint32_t                        requestBlock;
+    uint32_t                        requestBlocks;
+
+} DRV_RAMDISK_CLIENT_OBJ;
+
+/* RAM Disk Driver instance object */
+typedef struct
+{
+    SYS_STATUS                      status;
+
+    /* Buffer holding the media */
+    uint8_t *                       mediaBuffer;
+    uint32_t                        mediaSize;
+
+    /* Time from a request to its completion */
+    uint32_t                        latencyUS;
+
+    /* Token of the next client and command handles */
+    uint16_t                        clientToken;
+    uint16_t                        commandToken;
+
+    DRV_RAMDISK_CLIENT_OBJ          clientObj[DRV_RAMDISK_CLIENTS_NUMBER];
+
+    /* RAM disk driver geometry object */
+    SYS_MEDIA_GEOMETRY              mediaGeometryObj;
+
+    /* RAM disk driver media geometry table */
+    SYS_MEDIA_REGION_GEOMETRY       mediaGeometryTable[3];
+
+    /* Mutex to protect the client objects */
+    OSAL_MUTEX_DECLARE(mutex);
+
+} DRV_RAMDISK_OBJ;
+
+#endif //#ifndef DRV_RAMDISK_LOCAL_H
@@ -397,6 +397,57 @@ void DRV_SDMMC_Tasks
     SYS_MODULE_OBJ object
 );
 
+// *****************************************************************************
+/* Function:
+    bool DRV_SDMMC_IsBusy (
+        SYS_MODULE_OBJ object
+    );
+
+  Summary:
+    Tells if the driver's state machine has work to do.
+
+  Description:
+    This routine tells if the next call to DRV_SDMMC_Tasks can make progress
+    without waiting for an interrupt, a timer or a change of the card detect
+    line. This is the case while the card is being initialized, while a
+    transfer is in progress and while transfers are queued.
+
+  Precondition:
+    The DRV_SDMMC_Initialize routine must have been called for the specified
+    SDMMC driver instance.
+
+  Parameters:
+    object      - Object handle for the specified driver instance (returned from
+                  DRV_SDMMC_Initialize)
+
+  Returns:
+    true        - DRV_SDMMC_Tasks must be called again.
+
+    false       - The driver waits for the card to be attached, for the card
+                  detect debounce timer, for the SDHC interrupt that ends a
+                  data transfer or for a transfer request.
+
+  Example:
+    <code>
+    SYS_MODULE_OBJ      object;
+
+    if (DRV_SDMMC_IsBusy(object) == true)
+    {
+        DRV_SDMMC_Tasks(object);
+    }
+    </code>
+
+  Remarks:
+    This routine must be called from the same context as DRV_SDMMC_Tasks. A
+    card that is inserted or removed while the driver is not busy is only
+    detected by the next call to DRV_SDMMC_Tasks.
+*/
+
+bool DRV_SDMMC_IsBusy
+(
+    SYS_MODULE_OBJ object
+);
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Interface Routines - Client Level
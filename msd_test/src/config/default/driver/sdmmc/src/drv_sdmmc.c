@@ -52,9 +52,54 @@
 #include "configuration.h"
 #include "driver/sdmmc/drv_sdmmc.h"
 #include "driver/sdmmc/src/drv_sdmmc_local.h"
+#include "system/memory/sys_memory.h"
 #include <string.h>
 
 static DRV_SDMMC_OBJ gDrvSDMMCObj[DRV_SDMMC_INSTANCES_NUMBER];
+SYS_MEMORY_OBJECT_REGISTER(gDrvSDMMCObj);
+
+#if defined(DRV_SDMMC_STATIC_PLIB)
+
+#if (DRV_SDMMC_INSTANCES_NUMBER > 1U)
+    #error DRV_SDMMC_STATIC_PLIB can only be used with a single driver instance.
+#endif
+
+#include "definitions.h"
+
+#define lDRV_SDMMC_PLIB_NAME(plib, name)    lDRV_SDMMC_PLIB_PASTE(plib, name)
+#define lDRV_SDMMC_PLIB_PASTE(plib, name)   plib##_##name
+
+/* PLIB interface named by DRV_SDMMC_STATIC_PLIB. As the table is constant and
+   local to this file, the compiler turns the calls through it into direct
+   calls to the PLIB and drops the checks of the NULL entries. */
+static const DRV_SDMMC_PLIB_API lDRV_SDMMC_StaticPlibAPI = {
+    .sdhostCallbackRegister = (DRV_SDMMC_PLIB_CALLBACK_REGISTER)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, CallbackRegister),
+    .sdhostInitModule = (DRV_SDMMC_PLIB_INIT_MODULE)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, ModuleInit),
+    .sdhostSetClock  = (DRV_SDMMC_PLIB_SET_CLOCK)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, ClockSet),
+    .sdhostIsCmdLineBusy = (DRV_SDMMC_PLIB_IS_CMD_LINE_BUSY)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, IsCmdLineBusy),
+    .sdhostIsDatLineBusy = (DRV_SDMMC_PLIB_IS_DATA_LINE_BUSY)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, IsDatLineBusy),
+    .sdhostSendCommand = (DRV_SDMMC_PLIB_SEND_COMMAND)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, CommandSend),
+    .sdhostReadResponse = (DRV_SDMMC_PLIB_READ_RESPONSE)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, ResponseRead),
+    .sdhostSetBlockCount = (DRV_SDMMC_PLIB_SET_BLOCK_COUNT)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, BlockCountSet),
+    .sdhostSetBlockSize = (DRV_SDMMC_PLIB_SET_BLOCK_SIZE)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, BlockSizeSet),
+    .sdhostSetBusWidth = (DRV_SDMMC_PLIB_SET_BUS_WIDTH)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, BusWidthSet),
+    .sdhostSetSpeedMode = (DRV_SDMMC_PLIB_SET_SPEED_MODE)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, SpeedModeSet),
+    .sdhostSetupDma = (DRV_SDMMC_PLIB_SETUP_DMA)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, DmaSetup),
+    .sdhostGetCommandError = (DRV_SDMMC_PLIB_GET_COMMAND_ERROR)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, CommandErrorGet),
+    .sdhostGetDataError = (DRV_SDMMC_PLIB_GET_DATA_ERROR)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, DataErrorGet),
+    .sdhostClockEnable = (DRV_SDMMC_PLIB_CLOCK_ENABLE)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, ClockEnable),
+    .sdhostResetError = (DRV_SDMMC_PLIB_RESET_ERROR)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, ErrorReset),
+    .sdhostIsCardAttached = (DRV_SDMMC_PLIB_IS_CARD_ATTACHED)lDRV_SDMMC_PLIB_NAME(DRV_SDMMC_STATIC_PLIB, IsCardAttached),
+    .sdhostIsWriteProtected = (DRV_SDMMC_PLIB_IS_WRITE_PROTECTED)NULL,
+};
+
+#define lDRV_SDMMC_PLIB(dObj)               (&lDRV_SDMMC_StaticPlibAPI)
+
+#else
+
+#define lDRV_SDMMC_PLIB(dObj)               ((dObj)->sdmmcPlib)
+
+#endif
 
 
 static inline uint32_t  lDRV_SDMMC_MAKE_HANDLE(uint16_t token, uint8_t drvIndex, uint8_t index)
@@ -328,12 +373,12 @@ static void lDRV_SDMMC_PlibCallbackHandler(
     if (((uint32_t)xferStatus & (uint32_t)DRV_SDMMC_XFER_STATUS_COMMAND_COMPLETED) != 0U)
     {
         dObj->cardCtxt.isCommandCompleted = true;
-        dObj->cardCtxt.errorFlag |= dObj->sdmmcPlib->sdhostGetCommandError();
+        dObj->cardCtxt.errorFlag |= lDRV_SDMMC_PLIB(dObj)->sdhostGetCommandError();
     }
     if (((uint32_t)xferStatus & (uint32_t)DRV_SDMMC_XFER_STATUS_DATA_COMPLETED) != 0U)
     {
         dObj->cardCtxt.isDataCompleted = true;
-        dObj->cardCtxt.errorFlag |= dObj->sdmmcPlib->sdhostGetDataError();
+        dObj->cardCtxt.errorFlag |= lDRV_SDMMC_PLIB(dObj)->sdhostGetDataError();
     }
 }
 
@@ -487,12 +532,12 @@ static void lDRV_SDMMC_CommandSend (
             /* Fall through to the next state. */
 
         case DRV_SDMMC_CMD_LINE_STATE_CHECK:
-            if (dObj->sdmmcPlib->sdhostIsCmdLineBusy () == true)
+            if (lDRV_SDMMC_PLIB(dObj)->sdhostIsCmdLineBusy () == true)
             {
                 /* Command line is busy. Wait for the line to become free. */
-                if (dObj->sdmmcPlib->sdhostResetError != NULL)
+                if (lDRV_SDMMC_PLIB(dObj)->sdhostResetError != NULL)
                 {
-                    dObj->sdmmcPlib->sdhostResetError (DRV_SDMMC_RESET_CMD);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostResetError (DRV_SDMMC_RESET_CMD);
                 }
 
                 if (dObj->isCmdTimerExpired == true)
@@ -504,16 +549,16 @@ static void lDRV_SDMMC_CommandSend (
                 break;
             }
 
-            if (dObj->sdmmcPlib->sdhostIsDatLineBusy() == true)
+            if (lDRV_SDMMC_PLIB(dObj)->sdhostIsDatLineBusy() == true)
             {
                 /* This command requires the use of the DAT line, but the
                  * DAT lines are busy. Wait for the lines to become free. */
                 if (dObj->isCmdTimerExpired == true)
                 {
                     /* Timer has expired. */
-                    if (dObj->sdmmcPlib->sdhostResetError != NULL)
+                    if (lDRV_SDMMC_PLIB(dObj)->sdhostResetError != NULL)
                     {
-                        dObj->sdmmcPlib->sdhostResetError (DRV_SDMMC_RESET_DAT);
+                        lDRV_SDMMC_PLIB(dObj)->sdhostResetError (DRV_SDMMC_RESET_DAT);
                     }
                     dObj->commandStatus = DRV_SDMMC_COMMAND_STATUS_TIMEOUT_ERROR;
                     dObj->cmdState = DRV_SDMMC_CMD_EXEC_IS_COMPLETE;
@@ -530,7 +575,7 @@ static void lDRV_SDMMC_CommandSend (
             dObj->cardCtxt.isCommandCompleted = false;
             dObj->cardCtxt.isDataCompleted = false;
             dObj->cardCtxt.errorFlag = 0;
-            dObj->sdmmcPlib->sdhostSendCommand (opCode, argument, respType, *dataTransferFlags);
+            lDRV_SDMMC_PLIB(dObj)->sdhostSendCommand (opCode, argument, respType, *dataTransferFlags);
             dObj->cmdState = DRV_SDMMC_CMD_CHECK_TRANSFER_COMPLETE;
             break;
 
@@ -598,7 +643,7 @@ static uint8_t lDRV_SDMMC_SDIO_IO_ReadDirect(
     {
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
-            dObj->sdmmcPlib->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
 
             if (outResponseFlags != NULL)
             {
@@ -648,7 +693,7 @@ static uint8_t lDRV_SDMMC_SDIO_IO_WriteDirect(
     {
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
-            dObj->sdmmcPlib->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
 
             if (outResponseFlags != NULL)
             {
@@ -701,7 +746,7 @@ static uint8_t lDRV_SDMMC_SDIO_CISP_Get(
     {
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
-            dObj->sdmmcPlib->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
 
             cisp[nBytesRead] = (uint8_t)DRV_SDMMC_SDIO_CMD52_RESP_DATA_GET(response);
 
@@ -765,7 +810,7 @@ static uint8_t lDRV_SDMMC_SDIO_CIS_Tuple_Rd(
     {
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
-            dObj->sdmmcPlib->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
 
             data = (uint8_t)DRV_SDMMC_SDIO_CMD52_RESP_DATA_GET(response);
 
@@ -927,7 +972,7 @@ static uint8_t lDRV_SDMMC_SDIO_SetBlkSize(
     {
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
-            dObj->sdmmcPlib->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
 
             if ((DRV_SDMMC_SDIO_CMD52_RESP_FLAGS_GET(response) & DRV_SDMMC_SDIO_CMD52_RESP_ERR_MSK) == 0U)
             {
@@ -1040,11 +1085,11 @@ static uint8_t lDRV_SDMMC_SDIO_EnableHSMode(DRV_SDMMC_OBJ* dObj)
         {
             /*HS (50 MHz) set successfully by the card. Now change the host speed to HS. */
 
-            if (dObj->sdmmcPlib->sdhostSetClock(DRV_SDMMC_CLOCK_FREQ_HS_50_MHZ) == true)
+            if (lDRV_SDMMC_PLIB(dObj)->sdhostSetClock(DRV_SDMMC_CLOCK_FREQ_HS_50_MHZ) == true)
             {
                 dObj->cardCtxt.currentSpeed = DRV_SDMMC_CLOCK_FREQ_HS_50_MHZ;
 
-                dObj->sdmmcPlib->sdhostSetSpeedMode (DRV_SDMMC_SPEED_MODE_HIGH);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetSpeedMode (DRV_SDMMC_SPEED_MODE_HIGH);
             }
             else
             {
@@ -1088,7 +1133,7 @@ static uint8_t lDRV_SDMMC_SDIO_SendOpCond(
     {
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
-            dObj->sdmmcPlib->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
 
             dObj->cardCtxt.nf = (uint8_t)((response & DRV_SDMMC_R4_NF_MSK) >> DRV_SDMMC_R4_NF_POS);
             dObj->cardCtxt.mp = (uint8_t)((response & DRV_SDMMC_R4_MP_MSK) >> DRV_SDMMC_R4_MP_POS);
@@ -1195,7 +1240,7 @@ static uint8_t lDRV_SDMMC_SendCID_CMD2(DRV_SDMMC_OBJ* dObj)
     {
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
-            dObj->sdmmcPlib->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_ALL, (uint32_t *)&dObj->cardCtxt.cidBuffer[0]);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_ALL, (uint32_t *)&dObj->cardCtxt.cidBuffer[0]);
 
             status = DRV_SDMMC_COMMAND_STATUS_SUCCESS;
         }
@@ -1224,7 +1269,7 @@ static uint8_t lDRV_SDMMC_GetRelativeAddr_CMD3(DRV_SDMMC_OBJ* dObj)
     {
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
-            dObj->sdmmcPlib->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
 
             if ((response & 0xE000U) != 0U)
             {
@@ -1282,7 +1327,7 @@ static uint8_t lDRV_SDMMC_SetRelativeAddr_CMD3(DRV_SDMMC_OBJ* dObj)
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
              /* Read command response */
-            dObj->sdmmcPlib->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
 
             /* Check for possible errors */
             if ((response & DRV_SDMMC_SET_RELATIVE_ADDR_ERROR) != 0U)
@@ -1321,11 +1366,11 @@ static uint8_t lDRV_SDMMC_ExtendedCSDRead(DRV_SDMMC_OBJ* dObj)
             dObj->dataTransferFlags.transferDir = DRV_SDMMC_DATA_TRANSFER_DIR_READ;
             dObj->dataTransferFlags.transferType = DRV_SDMMC_DATA_TRANSFER_TYPE_SINGLE;
 
-            dObj->sdmmcPlib->sdhostSetBlockCount (0);
-            dObj->sdmmcPlib->sdhostSetBlockSize(DRV_SDMMC_EXT_CSD_RESP_SIZE);
+            lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockCount (0);
+            lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockSize(DRV_SDMMC_EXT_CSD_RESP_SIZE);
 
 
-            dObj->sdmmcPlib->sdhostSetupDma(
+            lDRV_SDMMC_PLIB(dObj)->sdhostSetupDma(
                 dObj->cardCtxt.extCSDBuffer,
                 DRV_SDMMC_EXT_CSD_RESP_SIZE,
                 DRV_SDMMC_DATA_XFER_DIR_RD
@@ -1397,7 +1442,7 @@ static uint8_t lDRV_SDMMC_SendCSD_CMD9(DRV_SDMMC_OBJ* dObj)
     {
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
-            dObj->sdmmcPlib->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_ALL, (uint32_t *)&dObj->cardCtxt.csdBuffer[0]);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_ALL, (uint32_t *)&dObj->cardCtxt.csdBuffer[0]);
 
             lDRV_SDMMC_ParseCSD (&dObj->cardCtxt.csdBuffer[0], &dObj->cardCtxt, dObj->protocol);
 
@@ -1450,7 +1495,7 @@ static uint8_t lDRV_SDMMC_SendIFCond_CMD8(DRV_SDMMC_OBJ* dObj)
     {
         if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
         {
-            dObj->sdmmcPlib->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
+            lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
 
             if ((response & 0x1FFU) == 0x1AAU)
             {
@@ -1527,7 +1572,7 @@ static uint8_t lDRV_SDMMC_SendOPCond_CMD1(DRV_SDMMC_OBJ* dObj)
                 if(dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
                 {
                     /* Read command response */
-                    dObj->sdmmcPlib->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, (uint32_t *)&response);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, (uint32_t *)&response);
 
                     /* Device is not busy */
                     if ((response & DRV_SDMMC_OCR_NBUSY) != 0U)
@@ -1629,7 +1674,7 @@ static uint8_t lDRV_SDMMC_SendOpCond_ACMD41(DRV_SDMMC_OBJ* dObj)
             {
                 if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
                 {
-                    dObj->sdmmcPlib->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
 
                     /* Check if the card has set any one of the supported voltage range bits. */
                     if ((response & 0x3C0000U) == 0U)
@@ -1810,7 +1855,7 @@ static uint8_t lDRV_SDMMC_SendSCR_ACMD51(DRV_SDMMC_OBJ* dObj, uint8_t* scrBuffer
         case ACMD51_CHK_RESPONSE:
             if (SYS_TIME_DelayIsComplete(dObj->generalTimerHandle) == true)
             {
-                dObj->sdmmcPlib->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
+                lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
 
                 if ((response & (1UL << 25)) != 0U)
                 {
@@ -1833,7 +1878,7 @@ static uint8_t lDRV_SDMMC_SendSCR_ACMD51(DRV_SDMMC_OBJ* dObj, uint8_t* scrBuffer
                     {
                         /* SCR response is 64-bits (or 8 bytes). Set the block length to 8 bytes */
 
-                        dObj->sdmmcPlib->sdhostSetBlockSize(8);
+                        lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockSize(8);
 
                         dObj->dataTransferFlags.isDataPresent = true;
                         dObj->dataTransferFlags.transferDir = DRV_SDMMC_DATA_TRANSFER_DIR_READ;
@@ -1841,7 +1886,7 @@ static uint8_t lDRV_SDMMC_SendSCR_ACMD51(DRV_SDMMC_OBJ* dObj, uint8_t* scrBuffer
 
 
                         /* Set up the DMA for the data transfer. */
-                        dObj->sdmmcPlib->sdhostSetupDma (scrBuffer, 8, DRV_SDMMC_DATA_XFER_DIR_RD);
+                        lDRV_SDMMC_PLIB(dObj)->sdhostSetupDma (scrBuffer, 8, DRV_SDMMC_DATA_XFER_DIR_RD);
 
                         status = DRV_SDMMC_COMMAND_STATUS_IN_PROGRESS;
                         state = ACMD51_READ_SCR;
@@ -1945,7 +1990,7 @@ static uint8_t lDRV_SDMMC_CheckSwitchHS_CMD6(DRV_SDMMC_OBJ* dObj, uint8_t mode,
             //mode 1 - To switch to the specific function
 
             /* Set the block length to 64 bytes. */
-            dObj->sdmmcPlib->sdhostSetBlockSize (64);
+            lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockSize (64);
 
             dObj->dataTransferFlags.isDataPresent = true;
             dObj->dataTransferFlags.transferDir = DRV_SDMMC_DATA_TRANSFER_DIR_READ;
@@ -1953,7 +1998,7 @@ static uint8_t lDRV_SDMMC_CheckSwitchHS_CMD6(DRV_SDMMC_OBJ* dObj, uint8_t mode,
 
 
             /* Set up the DMA for the data transfer. */
-            dObj->sdmmcPlib->sdhostSetupDma (&dObj->cardCtxt.switchStatusBuffer[0], 64, DRV_SDMMC_DATA_XFER_DIR_RD);
+            lDRV_SDMMC_PLIB(dObj)->sdhostSetupDma (&dObj->cardCtxt.switchStatusBuffer[0], 64, DRV_SDMMC_DATA_XFER_DIR_RD);
             state = DRV_SDMMC_CMD6_ISSUE;
 
             /* Fall through to the next case. */
@@ -2040,7 +2085,7 @@ static void lDRV_SDMMC_MediaInitialize (
         case DRV_SDMMC_INIT_SET_INIT_SPEED:
             if (dObj->cardCtxt.currentSpeed != DRV_SDMMC_CLOCK_FREQ_400_KHZ)
             {
-                if (dObj->sdmmcPlib->sdhostSetClock(DRV_SDMMC_CLOCK_FREQ_400_KHZ) == true)
+                if (lDRV_SDMMC_PLIB(dObj)->sdhostSetClock(DRV_SDMMC_CLOCK_FREQ_400_KHZ) == true)
                 {
                     dObj->cardCtxt.currentSpeed = DRV_SDMMC_CLOCK_FREQ_400_KHZ;
                 }
@@ -2713,7 +2758,7 @@ static void lDRV_SDMMC_MediaInitialize (
         case DRV_SDMMC_INIT_SET_HOST_BUS_WIDTH:
 
             /* Configure the host controller to use 4-bit bus from now on. */
-            dObj->sdmmcPlib->sdhostSetBusWidth (dObj->cardCtxt.busWidth);
+            lDRV_SDMMC_PLIB(dObj)->sdhostSetBusWidth (dObj->cardCtxt.busWidth);
 
             if (dObj->protocol == DRV_SDMMC_PROTOCOL_SD)
             {
@@ -2744,7 +2789,7 @@ static void lDRV_SDMMC_MediaInitialize (
 
         case DRV_SDMMC_INIT_SET_DEFAULT_SPEED_HOST:
 
-            if (dObj->sdmmcPlib->sdhostSetClock(dObj->cardCtxt.defaultSpeed) == true)
+            if (lDRV_SDMMC_PLIB(dObj)->sdhostSetClock(dObj->cardCtxt.defaultSpeed) == true)
             {
                 dObj->cardCtxt.currentSpeed = dObj->cardCtxt.defaultSpeed;
 
@@ -2880,10 +2925,10 @@ static void lDRV_SDMMC_MediaInitialize (
                 {
                     hs_speed = DRV_SDMMC_CLOCK_FREQ_HS_52_MHZ;
                 }
-                if (dObj->sdmmcPlib->sdhostSetClock(hs_speed) == true)
+                if (lDRV_SDMMC_PLIB(dObj)->sdhostSetClock(hs_speed) == true)
                 {
                     dObj->cardCtxt.currentSpeed = hs_speed;
-                    dObj->sdmmcPlib->sdhostSetSpeedMode (DRV_SDMMC_SPEED_MODE_HIGH);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostSetSpeedMode (DRV_SDMMC_SPEED_MODE_HIGH);
                     if ((dObj->sdCardType & CARD_TYPE_SD_IO) != 0U)
                     {
                         dObj->initState = DRV_SDMMC_INIT_RD_MAX_BLK_SIZE_SDIO;
@@ -3013,7 +3058,7 @@ SYS_MODULE_OBJ DRV_SDMMC_Initialize (
     dObj->sleepWhenIdle                     = sdmmcInit->sleepWhenIdle;
 
     /* Register a callback with the underlying SDMMC PLIB */
-    dObj->sdmmcPlib->sdhostCallbackRegister(lDRV_SDMMC_PlibCallbackHandler, (uintptr_t)dObj);
+    lDRV_SDMMC_PLIB(dObj)->sdhostCallbackRegister(lDRV_SDMMC_PlibCallbackHandler, (uintptr_t)dObj);
 
 
     lDRV_SDMMC_InitCardContext((uint32_t)drvIndex, &dObj->cardCtxt);
@@ -3039,6 +3084,49 @@ SYS_STATUS DRV_SDMMC_Status (
     return (gDrvSDMMCObj[object].status);
 }
 
+bool DRV_SDMMC_IsBusy (
+    SYS_MODULE_OBJ object
+)
+{
+    DRV_SDMMC_OBJ* dObj = NULL;
+    bool isBusy = true;
+
+    /* Validate the request */
+    if( (object == SYS_MODULE_OBJ_INVALID) || (object >= DRV_SDMMC_INSTANCES_NUMBER) )
+    {
+        return false;
+    }
+
+    dObj = &gDrvSDMMCObj[object];
+
+    switch (dObj->taskState)
+    {
+        case DRV_SDMMC_TASK_WAIT_FOR_DEVICE_ATTACH:
+            /* Without a card detect line the initialization starts at once */
+            isBusy = (dObj->cardDetectionMethod != DRV_SDMMC_CD_METHOD_USE_SDCD);
+            break;
+
+        case DRV_SDMMC_TASK_WAIT_CD_LINE_DEBOUNCE_TIMEOUT:
+            isBusy = false;
+            break;
+
+        case DRV_SDMMC_TASK_PROCESS_QUEUE:
+            isBusy = (lDRV_SDMMC_BufferListGet(dObj) != NULL);
+            break;
+
+        case DRV_SDMMC_TASK_WAIT_DATA_XFER_COMPLETE:
+            /* The SDHC interrupt ends the data transfer */
+            isBusy = dObj->cardCtxt.isDataCompleted;
+            break;
+
+        default:
+            /* Card initialization or transfer in progress */
+            break;
+    }
+
+    return isBusy;
+}
+
 DRV_HANDLE DRV_SDMMC_Open (
     const SYS_MODULE_INDEX drvIndex,
     const DRV_IO_INTENT ioIntent
@@ -3776,7 +3864,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
             if (dObj->cardDetectionMethod == DRV_SDMMC_CD_METHOD_USE_SDCD)
             {
                 /* Check the Present state register to see if the card is inserted */
-                if (dObj->sdmmcPlib->sdhostIsCardAttached ())
+                if (lDRV_SDMMC_PLIB(dObj)->sdhostIsCardAttached ())
                 {
                     /* Start the debounce timer */
                     dObj->taskState = DRV_SDMMC_TASK_START_CD_LINE_DEBOUNCE_TIMER;
@@ -3787,7 +3875,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
             else
             {
                 lDRV_SDMMC_InitCardContext((uint32_t)object, &dObj->cardCtxt);
-                dObj->sdmmcPlib->sdhostInitModule();
+                lDRV_SDMMC_PLIB(dObj)->sdhostInitModule();
                 dObj->cardCtxt.currentSpeed = DRV_SDMMC_CLOCK_FREQ_400_KHZ;
 
                 /* Attempt media initialization assuming that the media is present */
@@ -3809,10 +3897,10 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
         case DRV_SDMMC_TASK_WAIT_CD_LINE_DEBOUNCE_TIMEOUT:
             if (SYS_TIME_DelayIsComplete(dObj->tmrHandle) == true)
             {
-                if (dObj->sdmmcPlib->sdhostIsCardAttached ())
+                if (lDRV_SDMMC_PLIB(dObj)->sdhostIsCardAttached ())
                 {
                     lDRV_SDMMC_InitCardContext((uint32_t)object, &dObj->cardCtxt);
-                    dObj->sdmmcPlib->sdhostInitModule();
+                    lDRV_SDMMC_PLIB(dObj)->sdhostInitModule();
                     dObj->cardCtxt.currentSpeed = DRV_SDMMC_CLOCK_FREQ_400_KHZ;
 
                     /* Debounce delay has elapsed. Kick start initialization. */
@@ -3836,9 +3924,9 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 /* Check and update the card's write protected status */
                 if (dObj->isWriteProtectCheckEnabled == true)
                 {
-                    if (dObj->sdmmcPlib->sdhostIsWriteProtected != NULL)
+                    if (lDRV_SDMMC_PLIB(dObj)->sdhostIsWriteProtected != NULL)
                     {
-                        dObj->cardCtxt.isWriteProtected = dObj->sdmmcPlib->sdhostIsWriteProtected();
+                        dObj->cardCtxt.isWriteProtected = lDRV_SDMMC_PLIB(dObj)->sdhostIsWriteProtected();
                     }
                     else
                     {
@@ -3871,7 +3959,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 else if(dObj->cardDetectionMethod == DRV_SDMMC_CD_METHOD_USE_SDCD)
                 {
                     /* SDCD# pin is available only on SDHC PLIB */
-                    if (dObj->sdmmcPlib->sdhostIsCardAttached() == false)
+                    if (lDRV_SDMMC_PLIB(dObj)->sdhostIsCardAttached() == false)
                     {
                         dObj->taskState = DRV_SDMMC_TASK_WAIT_FOR_DEVICE_ATTACH;
                     }
@@ -3911,7 +3999,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 }
 
                 if((dObj->cardDetectionMethod == DRV_SDMMC_CD_METHOD_USE_SDCD) &&
-                   (dObj->sdmmcPlib->sdhostIsCardAttached () == false))
+                   (lDRV_SDMMC_PLIB(dObj)->sdhostIsCardAttached () == false))
                 {
                     /* Card has been removed. */
                     dObj->taskState = DRV_SDMMC_TASK_HANDLE_CARD_DETACH;
@@ -3984,7 +4072,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 else if(dObj->cardDetectionMethod == DRV_SDMMC_CD_METHOD_USE_SDCD)
                 {
                     /* PLIB provides the card attach/detach status */
-                    if (dObj->sdmmcPlib->sdhostIsCardAttached () == false)
+                    if (lDRV_SDMMC_PLIB(dObj)->sdhostIsCardAttached () == false)
                     {
                         /* Card has been removed. Handle the event. */
                         dObj->taskState = DRV_SDMMC_TASK_HANDLE_CARD_DETACH;
@@ -4032,7 +4120,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
             {
                 if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
                 {
-                    dObj->sdmmcPlib->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
 
                     if (((response & 0x00001E00U) >> 9) != 0x0FU)
                     {
@@ -4069,7 +4157,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
             {
                 if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
                 {
-                    dObj->sdmmcPlib->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
                     if (((response & 0x00001E00U) >> 9) != 0x03U)
                     {
                         /* Card is not in the expected state (standby state) */
@@ -4096,7 +4184,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
             {
                 if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
                 {
-                    dObj->sdmmcPlib->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
                     dObj->taskState = DRV_SDMMC_TASK_SETUP_XFER;
                 }
                 else
@@ -4116,8 +4204,8 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
 
             if (currentBufObj->opType == DRV_SDMMC_OP_TYP_SDIO_WR_BLK)
             {
-                dObj->sdmmcPlib->sdhostSetBlockCount(currentBufObj->nBlocks);
-                dObj->sdmmcPlib->sdhostSetBlockSize(512);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockCount(currentBufObj->nBlocks);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockSize(512);
 
                 dObj->dataTransferFlags.transferDir = DRV_SDMMC_DATA_TRANSFER_DIR_WRITE;
                 dObj->dataTransferFlags.isDataPresent = true;
@@ -4128,11 +4216,11 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 currentBufObj->respType = (uint8_t)DRV_SDMMC_CMD_RESP_R5;
 
 
-                dObj->sdmmcPlib->sdhostSetupDma (currentBufObj->buffer, (currentBufObj->nBlocks << 9), DRV_SDMMC_DATA_XFER_DIR_WR);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetupDma (currentBufObj->buffer, (currentBufObj->nBlocks << 9), DRV_SDMMC_DATA_XFER_DIR_WR);
             }
             else if (currentBufObj->opType == DRV_SDMMC_OP_TYP_SDIO_WR_BYTES)
             {
-                dObj->sdmmcPlib->sdhostSetBlockSize(currentBufObj->nBlocks);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockSize(currentBufObj->nBlocks);
 
                 dObj->dataTransferFlags.transferDir = DRV_SDMMC_DATA_TRANSFER_DIR_WRITE;
                 dObj->dataTransferFlags.isDataPresent = true;
@@ -4143,12 +4231,12 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 currentBufObj->respType = (uint8_t)DRV_SDMMC_CMD_RESP_R5;
 
 
-                dObj->sdmmcPlib->sdhostSetupDma (currentBufObj->buffer, currentBufObj->nBlocks, DRV_SDMMC_DATA_XFER_DIR_WR);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetupDma (currentBufObj->buffer, currentBufObj->nBlocks, DRV_SDMMC_DATA_XFER_DIR_WR);
             }
             else if (currentBufObj->opType == DRV_SDMMC_OP_TYP_SDIO_RD_BLK)
             {
-                dObj->sdmmcPlib->sdhostSetBlockCount(currentBufObj->nBlocks);
-                dObj->sdmmcPlib->sdhostSetBlockSize(512);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockCount(currentBufObj->nBlocks);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockSize(512);
 
                 dObj->dataTransferFlags.transferDir = DRV_SDMMC_DATA_TRANSFER_DIR_READ;
                 dObj->dataTransferFlags.isDataPresent = true;
@@ -4159,11 +4247,11 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 currentBufObj->respType = (uint8_t)DRV_SDMMC_CMD_RESP_R5;
 
 
-                dObj->sdmmcPlib->sdhostSetupDma (currentBufObj->buffer, (currentBufObj->nBlocks << 9), DRV_SDMMC_DATA_XFER_DIR_RD);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetupDma (currentBufObj->buffer, (currentBufObj->nBlocks << 9), DRV_SDMMC_DATA_XFER_DIR_RD);
             }
             else if (currentBufObj->opType == DRV_SDMMC_OP_TYP_SDIO_RD_BYTES)
             {
-                dObj->sdmmcPlib->sdhostSetBlockSize(currentBufObj->nBlocks);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockSize(currentBufObj->nBlocks);
 
                 dObj->dataTransferFlags.transferDir = DRV_SDMMC_DATA_TRANSFER_DIR_READ;
                 dObj->dataTransferFlags.isDataPresent = true;
@@ -4174,7 +4262,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 currentBufObj->respType = (uint8_t)DRV_SDMMC_CMD_RESP_R5;
 
 
-                dObj->sdmmcPlib->sdhostSetupDma (currentBufObj->buffer, currentBufObj->nBlocks, DRV_SDMMC_DATA_XFER_DIR_RD);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetupDma (currentBufObj->buffer, currentBufObj->nBlocks, DRV_SDMMC_DATA_XFER_DIR_RD);
             }
             else if (currentBufObj->opType == DRV_SDMMC_OP_TYP_SD_MEM_READ)
             {
@@ -4183,13 +4271,13 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
 
                 if (currentBufObj->nBlocks == 1U)
                 {
-                    dObj->sdmmcPlib->sdhostSetBlockCount(0);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockCount(0);
                     currentBufObj->opCode = (uint8_t)DRV_SDMMC_CMD_READ_SINGLE_BLOCK;
                     dObj->dataTransferFlags.transferType = DRV_SDMMC_DATA_TRANSFER_TYPE_SINGLE;
                 }
                 else
                 {
-                    dObj->sdmmcPlib->sdhostSetBlockCount (currentBufObj->nBlocks);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockCount (currentBufObj->nBlocks);
                     currentBufObj->opCode = (uint8_t)DRV_SDMMC_CMD_READ_MULTI_BLOCK;
                     dObj->dataTransferFlags.transferType = DRV_SDMMC_DATA_TRANSFER_TYPE_MULTI;
                 }
@@ -4197,10 +4285,10 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 currentBufObj->arg = (dObj->cardCtxt.cardType == DRV_SDMMC_CARD_TYPE_STANDARD)? currentBufObj->blockStart << 9 : currentBufObj->blockStart;
                 currentBufObj->respType = (uint8_t)DRV_SDMMC_CMD_RESP_R1;
 
-                dObj->sdmmcPlib->sdhostSetBlockSize(512);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockSize(512);
 
 
-                dObj->sdmmcPlib->sdhostSetupDma (currentBufObj->buffer, (currentBufObj->nBlocks << 9), DRV_SDMMC_DATA_XFER_DIR_RD);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetupDma (currentBufObj->buffer, (currentBufObj->nBlocks << 9), DRV_SDMMC_DATA_XFER_DIR_RD);
 
             }
             else if (currentBufObj->opType == DRV_SDMMC_OP_TYP_SD_MEM_WRITE)
@@ -4210,23 +4298,23 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
 
                 if (currentBufObj->nBlocks == 1U)
                 {
-                    dObj->sdmmcPlib->sdhostSetBlockCount(0);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockCount(0);
                     currentBufObj->opCode = (uint8_t)DRV_SDMMC_CMD_WRITE_SINGLE_BLOCK;
                     dObj->dataTransferFlags.transferType = DRV_SDMMC_DATA_TRANSFER_TYPE_SINGLE;
                 }
                 else
                 {
-                    dObj->sdmmcPlib->sdhostSetBlockCount (currentBufObj->nBlocks);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockCount (currentBufObj->nBlocks);
                     currentBufObj->opCode = (uint8_t)DRV_SDMMC_CMD_WRITE_MULTI_BLOCK;
                     dObj->dataTransferFlags.transferType = DRV_SDMMC_DATA_TRANSFER_TYPE_MULTI;
                 }
                 currentBufObj->arg = (dObj->cardCtxt.cardType == DRV_SDMMC_CARD_TYPE_STANDARD)? currentBufObj->blockStart << 9 : currentBufObj->blockStart;
                 currentBufObj->respType = (uint8_t)DRV_SDMMC_CMD_RESP_R1;
 
-                dObj->sdmmcPlib->sdhostSetBlockSize(512);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetBlockSize(512);
 
 
-                dObj->sdmmcPlib->sdhostSetupDma (currentBufObj->buffer, (currentBufObj->nBlocks << 9), DRV_SDMMC_DATA_XFER_DIR_WR);
+                lDRV_SDMMC_PLIB(dObj)->sdhostSetupDma (currentBufObj->buffer, (currentBufObj->nBlocks << 9), DRV_SDMMC_DATA_XFER_DIR_WR);
             }
             else if (currentBufObj->opType == DRV_SDMMC_OP_TYP_SDIO_WR_DIR)
             {
@@ -4266,7 +4354,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 {
                     if (currentBufObj->respType == (uint8_t)DRV_SDMMC_CMD_RESP_R5)
                     {
-                        dObj->sdmmcPlib->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
+                        lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse(DRV_SDMMC_READ_RESP_REG_0, &response);
 
                         if ((DRV_SDMMC_SDIO_CMD52_RESP_FLAGS_GET(response) & DRV_SDMMC_SDIO_CMD52_RESP_ERR_MSK) != 0U)
                         {
@@ -4362,7 +4450,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
             {
                 if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
                 {
-                    dObj->sdmmcPlib->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
+                    lDRV_SDMMC_PLIB(dObj)->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
                     if ((response & 0x100U) != 0U)
                     {
                         //Card is ready for new data. Corresponds to buffer empty signaling on the bus.
@@ -4389,7 +4477,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
         case DRV_SDMMC_TASK_ERROR:
             if (dObj->cardDetectionMethod == DRV_SDMMC_CD_METHOD_USE_SDCD)
             {
-                cardAttached = dObj->sdmmcPlib->sdhostIsCardAttached ();
+                cardAttached = lDRV_SDMMC_PLIB(dObj)->sdhostIsCardAttached ();
                 currentBufObj->status = DRV_SDMMC_COMMAND_ERROR_UNKNOWN;
                 dObj->taskState = DRV_SDMMC_TASK_TRANSFER_COMPLETE;
             }
@@ -0,0 +1,408 @@
+/*******************************************************************************
+  UF2 Update Media Driver Interface Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_uf2.h
+
+  Summary:
+    UF2 Update Media Driver interface.
+
+  Description:
+    This file defines the interface to the UF2 Update Media Driver. The driver
+    presents a read only FAT16 volume holding INFO_UF2.TXT with the interface
+    the MSD function driver expects from a media driver. Copying a UF2 file
+    to the volume updates the firmware: the blocks of the file are programmed
+    into the other flash bank while the code keeps running from its bank.
+    Once every block of the file is programmed and read back, the banks are
+    swapped, which resets the device into the new firmware.
+
+    Only UF2 blocks of 256 bytes aligned to 256 bytes are programmed, the
+    format the UF2 tools produce by default. The other blocks written to the
+    volume, among them the directory and FAT updates of the host, are
+    ignored.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef DRV_UF2_H    // Guards against multiple inclusion
+#define DRV_UF2_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+#include "driver/driver_common.h"
+#include "system/system_module.h"
+#include "system/system_media.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Clients that may have the driver open at the same time */
+#ifndef DRV_UF2_CLIENTS_NUMBER
+    #define DRV_UF2_CLIENTS_NUMBER          (1U)
+#endif
+
+/* Family ID of the UF2 blocks to program. Blocks with another family ID are
+   ignored, blocks without one are programmed. */
+#ifndef DRV_UF2_FAMILY_ID
+    #define DRV_UF2_FAMILY_ID               (0x55114460U)
+#endif
+
+/* Board-ID line of INFO_UF2.TXT */
+#ifndef DRV_UF2_BOARD_ID
+    #define DRV_UF2_BOARD_ID                "SAMD51J20A"
+#endif
+
+/* Time without writes between the end of the update and the bank swap, so
+   the host completes the copy before the device resets */
+#ifndef DRV_UF2_SWAP_DELAY_MS
+    #define DRV_UF2_SWAP_DELAY_MS           (1000U)
+#endif
+
+/* Size of a media block in bytes */
+#define DRV_UF2_BLOCK_SIZE                  (512U)
+
+/* Blocks of the volume. Makes a FAT16 volume of 8 MB, room for the UF2 file
+   of any image. */
+#define DRV_UF2_MEDIA_BLOCKS                (16384U)
+
+// *****************************************************************************
+/* UF2 Update Media Driver command handle
+
+  Summary:
+    Identifies a read or write request.
+
+  Remarks:
+    Refer system_media.h for the definition of SYS_MEDIA_BLOCK_COMMAND_HANDLE.
+*/
+
+typedef SYS_MEDIA_BLOCK_COMMAND_HANDLE DRV_UF2_COMMAND_HANDLE;
+
+#define DRV_UF2_COMMAND_HANDLE_INVALID SYS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID
+
+// *****************************************************************************
+/* UF2 Update Media Driver events
+
+  Summary:
+    Identifies the result of a request.
+*/
+
+typedef enum
+{
+    /* The request is complete */
+    DRV_UF2_EVENT_COMMAND_COMPLETE = SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE,
+
+    /* Not reported by this driver, kept for the media interface. A failed
+       update shows as the missing bank swap. */
+    DRV_UF2_EVENT_COMMAND_ERROR = SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR
+
+} DRV_UF2_EVENT;
+
+// *****************************************************************************
+/* UF2 Update Media Driver event handler
+
+  Summary:
+    Pointer to the function called when a request ends.
+
+  Description:
+    Reads complete before the read function returns. A write completes before
+    the write function returns, unless one of its blocks waits for the page
+    before it to be programmed. It then completes from DRV_UF2_Tasks.
+*/
+
+typedef SYS_MEDIA_EVENT_HANDLER DRV_UF2_EVENT_HANDLER;
+
+// *****************************************************************************
+/* UF2 Update Media Driver update states
+
+  Summary:
+    Progress of the firmware update.
+*/
+
+typedef enum
+{
+    /* No UF2 block received since reset */
+    DRV_UF2_UPDATE_IDLE = 0,
+
+    /* Programming the blocks of a UF2 file */
+    DRV_UF2_UPDATE_RECEIVING,
+
+    /* Every block is programmed and read back, waiting to swap the banks */
+    DRV_UF2_UPDATE_SWAP,
+
+    /* A page read back differs or the image has no valid vector table. The
+       next UF2 block starts a new update. */
+    DRV_UF2_UPDATE_FAILED
+
+} DRV_UF2_UPDATE_STATE;
+
+// *****************************************************************************
+/* UF2 Update Media Driver initialization data
+
+  Summary:
+    Defines where the new firmware is programmed.
+*/
+
+typedef struct
+{
+    /* Address of the bank the code does not run from. Must be the start of
+       a flash block. */
+    uint32_t bankAddress;
+
+    /* Largest image, from the start of the bank. Must be a multiple of a
+       flash block. UF2 blocks past it are ignored. */
+    uint32_t imageSize;
+
+} DRV_UF2_INIT;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines - System Level
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    SYS_MODULE_OBJ DRV_UF2_Initialize ( const SYS_MODULE_INDEX drvIndex,
+                                        const SYS_MODULE_INIT * const init )
+
+  Summary:
+    Initializes the driver over the bank given by the initialization data.
+
+  Parameters:
+    drvIndex - DRV_UF2_INDEX_0.
+    init     - Pointer to a DRV_UF2_INIT structure.
+
+  Returns:
+    The driver object, or SYS_MODULE_OBJ_INVALID if the index or the bank is
+    not valid.
+
+  Remarks:
+    The bank is only erased by the first UF2 block written.
+*/
+
+SYS_MODULE_OBJ DRV_UF2_Initialize ( const SYS_MODULE_INDEX drvIndex, const SYS_MODULE_INIT * const init );
+
+//******************************************************************************
+/* Function:
+    SYS_STATUS DRV_UF2_Status ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Returns SYS_STATUS_READY once the driver is initialized.
+*/
+
+SYS_STATUS DRV_UF2_Status ( SYS_MODULE_OBJ object );
+
+//******************************************************************************
+/* Function:
+    void DRV_UF2_Tasks ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Programs and reads back the pages of the update and swaps the banks.
+
+  Description:
+    Issues at most one NVMCTRL command per call, when the NVMCTRL is idle,
+    and completes the write waiting for it. The banks are swapped
+    DRV_UF2_SWAP_DELAY_MS after the last write of a complete update, once
+    the key/value store has written its changes.
+
+  Remarks:
+    Must be called while DRV_UF2_IsBusy returns true, and periodically to
+    swap the banks.
+*/
+
+void DRV_UF2_Tasks ( SYS_MODULE_OBJ object );
+
+//******************************************************************************
+/* Function:
+    bool DRV_UF2_IsBusy ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Returns true while a page waits to be programmed or read back, or a
+    write waits for it.
+*/
+
+bool DRV_UF2_IsBusy ( SYS_MODULE_OBJ object );
+
+//******************************************************************************
+/* Function:
+    DRV_UF2_UPDATE_STATE DRV_UF2_UpdateStateGet ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Returns the progress of the firmware update.
+*/
+
+DRV_UF2_UPDATE_STATE DRV_UF2_UpdateStateGet ( SYS_MODULE_OBJ object );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines - Client Level
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    DRV_HANDLE DRV_UF2_Open ( const SYS_MODULE_INDEX drvIndex,
+                              const DRV_IO_INTENT ioIntent )
+
+  Summary:
+    Opens a client of the driver.
+
+  Returns:
+    DRV_HANDLE_INVALID if the driver is not ready or all the clients are in
+    use.
+*/
+
+DRV_HANDLE DRV_UF2_Open ( const SYS_MODULE_INDEX drvIndex, const DRV_IO_INTENT ioIntent );
+
+//******************************************************************************
+/* Function:
+    void DRV_UF2_Close ( DRV_HANDLE handle )
+
+  Summary:
+    Closes a client. A write of the client waiting for a page is dropped.
+*/
+
+void DRV_UF2_Close ( DRV_HANDLE handle );
+
+//******************************************************************************
+/* Function:
+    void DRV_UF2_AsyncRead ( const DRV_HANDLE handle,
+                             DRV_UF2_COMMAND_HANDLE * commandHandle,
+                             void * targetBuffer,
+                             uint32_t blockStart, uint32_t nBlocks )
+
+  Summary:
+    Reads nBlocks blocks of the volume from blockStart.
+
+  Returns:
+    DRV_UF2_COMMAND_HANDLE_INVALID in commandHandle if the handle or the
+    block range is not valid, or if a request of the client is in progress.
+
+  Remarks:
+    The blocks are built in the call: the boot sector, the FATs, the root
+    directory and INFO_UF2.TXT. The other blocks read as zeros.
+*/
+
+void DRV_UF2_AsyncRead ( const DRV_HANDLE handle, DRV_UF2_COMMAND_HANDLE * commandHandle,
+        void * targetBuffer, uint32_t blockStart, uint32_t nBlocks );
+
+//******************************************************************************
+/* Function:
+    void DRV_UF2_AsyncWrite ( const DRV_HANDLE handle,
+                              DRV_UF2_COMMAND_HANDLE * commandHandle,
+                              void * sourceBuffer,
+                              uint32_t blockStart, uint32_t nBlocks )
+
+  Summary:
+    Writes nBlocks blocks of the volume from blockStart.
+
+  Returns:
+    DRV_UF2_COMMAND_HANDLE_INVALID in commandHandle if the handle or the
+    block range is not valid, or if a request of the client is in progress.
+
+  Remarks:
+    The source buffer must stay valid until the request completes. The
+    blocks that are not UF2 blocks of this device are ignored.
+*/
+
+void DRV_UF2_AsyncWrite ( const DRV_HANDLE handle, DRV_UF2_COMMAND_HANDLE * commandHandle,
+        void * sourceBuffer, uint32_t blockStart, uint32_t nBlocks );
+
+//******************************************************************************
+/* Function:
+    SYS_MEDIA_GEOMETRY * DRV_UF2_GeometryGet ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns the geometry of the volume, one region of DRV_UF2_BLOCK_SIZE byte
+    blocks for reads, writes and erases.
+*/
+
+SYS_MEDIA_GEOMETRY * DRV_UF2_GeometryGet ( const DRV_HANDLE handle );
+
+//******************************************************************************
+/* Function:
+    void DRV_UF2_EventHandlerSet ( const DRV_HANDLE handle,
+                                   const void * eventHandler,
+                                   const uintptr_t context )
+
+  Summary:
+    Sets the function called when a request of the client ends.
+*/
+
+void DRV_UF2_EventHandlerSet ( const DRV_HANDLE handle, const void * eventHandler, const uintptr_t context );
+
+//******************************************************************************
+/* Function:
+    bool DRV_UF2_IsAttached ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns true for a valid handle.
+*/
+
+bool DRV_UF2_IsAttached ( const DRV_HANDLE handle );
+
+//******************************************************************************
+/* Function:
+    bool DRV_UF2_IsWriteProtected ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns true if the client was opened without DRV_IO_INTENT_WRITE.
+*/
+
+bool DRV_UF2_IsWriteProtected ( const DRV_HANDLE handle );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    }
+#endif
+//DOM-IGNORE-END
+
+#endif // DRV_UF2_H
@@ -0,0 +1,915 @@
+/*******************************************************************************
+  UF2 Update Media Driver Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_uf2.c
+
+  Summary:
+    Source code for the UF2 Update Media Driver.
+
+  Description:
+    This file contains the source code for the UF2 Update Media Driver. The
+    blocks of the volume are built when they are read. A written block that
+    is a UF2 block goes to the RAM copy of its flash page, one of
+    DRV_UF2_PAGES_NUMBER slots, so that the host may send the UF2 blocks of
+    a few pages out of order. Once the page is complete, or all the UF2
+    blocks of the image are there, DRV_UF2_Tasks erases the flash block of
+    the page if this update has not done it yet, loads the page buffer and
+    commits it, each when the NVMCTRL is idle. The host sends the next UF2
+    blocks while the page is programmed. Once the NVMCTRL is idle again the
+    page is read back and its CRC-32 compared with the one of the RAM copy.
+
+    A flash page is never programmed twice without an erase. If all the slots
+    hold incomplete pages, the oldest one is programmed as it is, and a UF2
+    block that arrives later for that page fails the update.
+
+    The page buffer and the NVMCTRL commands are shared with the flash driver
+    and the SmartEEPROM, so the page buffer is only loaded right before its
+    commit, with the interrupts disabled from the check of the NVMCTRL.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "configuration.h"
+#include "driver/uf2/src/drv_uf2_local.h"
+#include "system/int/sys_int.h"
+#include "system/time/sys_time.h"
+#include "system/kvs/sys_kvs.h"
+#include "system/memory/sys_memory.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+static DRV_UF2_OBJ gDrvUf2Obj;
+SYS_MEMORY_OBJECT_REGISTER(gDrvUf2Obj);
+
+/* Content of INFO_UF2.TXT */
+static const char gDrvUf2Info[] =
+    "UF2 Update msd_test\r\n"
+    "Model: MSD test\r\n"
+    "Board-ID: " DRV_UF2_BOARD_ID "\r\n";
+
+/* CRC-32 of each value of a nibble */
+static const uint32_t gDrvUf2CrcTable[16] =
+{
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static inline uint16_t lDRV_UF2_UPDATE_TOKEN(uint16_t token)
+{
+    token++;
+
+    if (token >= DRV_UF2_TOKEN_MAX)
+    {
+        token = 1;
+    }
+
+    return token;
+}
+
+static DRV_UF2_CLIENT_OBJ * lDRV_UF2_DriverHandleValidate( DRV_HANDLE handle )
+{
+    DRV_UF2_CLIENT_OBJ * clientObj;
+    uint32_t index;
+
+    if ((handle == DRV_HANDLE_INVALID) || (gDrvUf2Obj.status != SYS_STATUS_READY))
+    {
+        return NULL;
+    }
+
+    index = (uint32_t)handle & DRV_UF2_INDEX_MASK;
+    if (index >= DRV_UF2_CLIENTS_NUMBER)
+    {
+        return NULL;
+    }
+
+    clientObj = &gDrvUf2Obj.clientObj[index];
+    if ((clientObj->inUse == false) || (clientObj->clientHandle != handle))
+    {
+        return NULL;
+    }
+
+    return clientObj;
+}
+
+static void lDRV_UF2_Put16( uint8_t * buffer, uint32_t offset, uint32_t value )
+{
+    buffer[offset] = (uint8_t)value;
+    buffer[offset + 1U] = (uint8_t)(value >> 8);
+}
+
+static void lDRV_UF2_Put32( uint8_t * buffer, uint32_t offset, uint32_t value )
+{
+    lDRV_UF2_Put16(buffer, offset, value);
+    lDRV_UF2_Put16(buffer, offset + 2U, value >> 16);
+}
+
+/* CRC-32 of the UF2 blocks of a page set in filled */
+static uint32_t lDRV_UF2_PageCrc( const uint8_t * page, uint32_t filled )
+{
+    uint32_t crc = 0xFFFFFFFFU;
+    uint32_t payload;
+    uint32_t i;
+
+    for (payload = 0U; payload < DRV_UF2_PAGE_PAYLOADS; payload++)
+    {
+        if ((filled & (1UL << payload)) == 0U)
+        {
+            continue;
+        }
+
+        for (i = payload * DRV_UF2_PAYLOAD_SIZE; i < ((payload + 1U) * DRV_UF2_PAYLOAD_SIZE); i++)
+        {
+            crc ^= page[i];
+            crc = (crc >> 4) ^ gDrvUf2CrcTable[crc & 0xFU];
+            crc = (crc >> 4) ^ gDrvUf2CrcTable[crc & 0xFU];
+        }
+    }
+
+    return ~crc;
+}
+
+/* Builds a block of the volume */
+static void lDRV_UF2_BlockRead( uint32_t block, uint8_t * buffer )
+{
+    uint8_t * entry;
+
+    (void) memset(buffer, 0, DRV_UF2_BLOCK_SIZE);
+
+    if (block == 0U)
+    {
+        /* Boot sector with the FAT16 BIOS parameter block */
+        buffer[0] = 0xEBU;
+        buffer[1] = 0x3CU;
+        buffer[2] = 0x90U;
+        (void) memcpy(&buffer[3], "UF2 UF2 ", 8U);
+        lDRV_UF2_Put16(buffer, 11U, DRV_UF2_BLOCK_SIZE);
+        buffer[13] = 1U;
+        lDRV_UF2_Put16(buffer, 14U, DRV_UF2_FAT_START);
+        buffer[16] = 2U;
+        lDRV_UF2_Put16(buffer, 17U, DRV_UF2_ROOT_ENTRIES);
+        lDRV_UF2_Put16(buffer, 19U, DRV_UF2_MEDIA_BLOCKS);
+        buffer[21] = 0xF8U;
+        lDRV_UF2_Put16(buffer, 22U, DRV_UF2_FAT_BLOCKS);
+        lDRV_UF2_Put16(buffer, 24U, 1U);
+        lDRV_UF2_Put16(buffer, 26U, 1U);
+        buffer[36] = 0x80U;
+        buffer[38] = 0x29U;
+        lDRV_UF2_Put32(buffer, 39U, DRV_UF2_FAMILY_ID);
+        (void) memcpy(&buffer[43], DRV_UF2_VOLUME_LABEL, 11U);
+        (void) memcpy(&buffer[54], "FAT16   ", 8U);
+        buffer[510] = 0x55U;
+        buffer[511] = 0xAAU;
+    }
+    else if (block < DRV_UF2_ROOT_START)
+    {
+        if (((block - DRV_UF2_FAT_START) % DRV_UF2_FAT_BLOCKS) == 0U)
+        {
+            /* Media descriptor, then the single cluster of INFO_UF2.TXT */
+            lDRV_UF2_Put16(buffer, 0U, 0xFFF8U);
+            lDRV_UF2_Put16(buffer, 2U, 0xFFFFU);
+            lDRV_UF2_Put16(buffer, 4U, 0xFFFFU);
+        }
+    }
+    else if (block == DRV_UF2_ROOT_START)
+    {
+        (void) memcpy(&buffer[0], DRV_UF2_VOLUME_LABEL, 11U);
+        buffer[11] = 0x08U;
+
+        entry = &buffer[32];
+        (void) memcpy(&entry[0], "INFO_UF2TXT", 11U);
+        entry[11] = 0x01U;
+        lDRV_UF2_Put16(entry, 16U, DRV_UF2_FILE_DATE);
+        lDRV_UF2_Put16(entry, 18U, DRV_UF2_FILE_DATE);
+        lDRV_UF2_Put16(entry, 24U, DRV_UF2_FILE_DATE);
+        lDRV_UF2_Put16(entry, 26U, 2U);
+        lDRV_UF2_Put32(entry, 28U, sizeof(gDrvUf2Info) - 1U);
+    }
+    else if (block == DRV_UF2_DATA_START)
+    {
+        (void) memcpy(buffer, gDrvUf2Info, sizeof(gDrvUf2Info) - 1U);
+    }
+    else
+    {
+        /* Free cluster or unused directory block */
+    }
+}
+
+/* Starts the update of an image of numBlocks UF2 blocks */
+static void lDRV_UF2_UpdateStart( DRV_UF2_OBJ * dObj, uint32_t numBlocks )
+{
+    (void) memset(dObj->received, 0, sizeof(dObj->received));
+    (void) memset(dObj->erased, 0, sizeof(dObj->erased));
+    (void) memset(dObj->programmed, 0, sizeof(dObj->programmed));
+    dObj->numBlocks = numBlocks;
+    dObj->receivedBlocks = 0U;
+    dObj->updateState = DRV_UF2_UPDATE_RECEIVING;
+}
+
+/* Returns true if a slot holds a page */
+static bool lDRV_UF2_PagesInUse( const DRV_UF2_OBJ * dObj )
+{
+    uint32_t i;
+
+    for (i = 0U; i < DRV_UF2_PAGES_NUMBER; i++)
+    {
+        if (dObj->page[i].filled != 0U)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Lets the pages in the slots be programmed as they are */
+static void lDRV_UF2_PagesClose( DRV_UF2_OBJ * dObj )
+{
+    uint32_t i;
+
+    for (i = 0U; i < DRV_UF2_PAGES_NUMBER; i++)
+    {
+        if (dObj->page[i].filled != 0U)
+        {
+            dObj->page[i].full = true;
+        }
+    }
+}
+
+/* Returns the slot of the page at pageOffset, taking a free one if no slot
+   holds it yet. Returns NULL if all the slots are taken. If none of them is
+   waiting to be programmed, the oldest incomplete page is let go. */
+static DRV_UF2_PAGE * lDRV_UF2_PageGet( DRV_UF2_OBJ * dObj, uint32_t pageOffset )
+{
+    DRV_UF2_PAGE * page;
+    DRV_UF2_PAGE * freePage = NULL;
+    DRV_UF2_PAGE * oldestPage = NULL;
+    bool waiting = false;
+    uint32_t i;
+
+    for (i = 0U; i < DRV_UF2_PAGES_NUMBER; i++)
+    {
+        page = &dObj->page[i];
+
+        if (page->filled == 0U)
+        {
+            if (freePage == NULL)
+            {
+                freePage = page;
+            }
+        }
+        else if (page->offset == pageOffset)
+        {
+            /* Not programmed yet, even if it was let go */
+            return page;
+        }
+        else if ((page->full == false) &&
+                ((oldestPage == NULL) || ((page->sequence - oldestPage->sequence) > 0x7FFFFFFFU)))
+        {
+            oldestPage = page;
+        }
+        else if (page->full == true)
+        {
+            waiting = true;
+        }
+        else
+        {
+            /* Newer than the oldest incomplete page */
+        }
+    }
+
+    if (freePage != NULL)
+    {
+        (void) memset(freePage->data, 0xFF, sizeof(freePage->data));
+        freePage->offset = pageOffset;
+        freePage->full = false;
+        freePage->sequence = dObj->pageSequence;
+        dObj->pageSequence++;
+    }
+    else if (waiting == false)
+    {
+        oldestPage->full = true;
+    }
+    else
+    {
+        /* A slot is freed once its page is programmed */
+    }
+
+    return freePage;
+}
+
+/* Takes a block written by the host. Returns false if it must wait for a
+   page to be programmed. Called with the mutex held. */
+static bool lDRV_UF2_BlockWrite( DRV_UF2_OBJ * dObj, const uint8_t * buffer )
+{
+    const DRV_UF2_BLOCK * uf2 = (const DRV_UF2_BLOCK *)(const void *)buffer;
+    DRV_UF2_PAGE * page;
+    uint32_t pageOffset;
+    uint32_t flashPage;
+    uint32_t payload;
+    uint32_t blockNo = uf2->blockNo;
+
+    if ((uf2->magicStart0 != DRV_UF2_MAGIC_START0) || (uf2->magicStart1 != DRV_UF2_MAGIC_START1) ||
+        (uf2->magicEnd != DRV_UF2_MAGIC_END) ||
+        ((uf2->flags & (DRV_UF2_FLAG_NOT_MAIN_FLASH | DRV_UF2_FLAG_FILE_CONTAINER)) != 0U) ||
+        (((uf2->flags & DRV_UF2_FLAG_FAMILY_ID_PRESENT) != 0U) && (uf2->fileSize != DRV_UF2_FAMILY_ID)) ||
+        (uf2->payloadSize != DRV_UF2_PAYLOAD_SIZE) || ((uf2->targetAddr % DRV_UF2_PAYLOAD_SIZE) != 0U) ||
+        (uf2->targetAddr >= dObj->imageSize) ||
+        (uf2->numBlocks == 0U) || (uf2->numBlocks > DRV_UF2_BLOCKS_MAX) || (blockNo >= uf2->numBlocks))
+    {
+        /* Not a block of an image for this device */
+        return true;
+    }
+
+    if (((dObj->updateState == DRV_UF2_UPDATE_RECEIVING) || (dObj->updateState == DRV_UF2_UPDATE_SWAP)) &&
+        (uf2->numBlocks == dObj->numBlocks))
+    {
+        if ((dObj->received[blockNo / 32U] & (1UL << (blockNo % 32U))) != 0U)
+        {
+            /* Written again, the host rewrites the file */
+            return true;
+        }
+    }
+    else
+    {
+        /* Another image. The pages of the previous one are done first. */
+        if ((lDRV_UF2_PagesInUse(dObj) == true) || (dObj->verifyPending == true))
+        {
+            lDRV_UF2_PagesClose(dObj);
+            return false;
+        }
+
+        lDRV_UF2_UpdateStart(dObj, uf2->numBlocks);
+    }
+
+    pageOffset = uf2->targetAddr & ~(NVMCTRL_FLASH_PAGESIZE - 1U);
+    flashPage = pageOffset / NVMCTRL_FLASH_PAGESIZE;
+
+    if ((dObj->programmed[flashPage / 32U] & (1UL << (flashPage % 32U))) != 0U)
+    {
+        /* The page was programmed without this block and cannot be
+           programmed again without erasing the pages around it */
+        dObj->updateState = DRV_UF2_UPDATE_FAILED;
+        return true;
+    }
+
+    page = lDRV_UF2_PageGet(dObj, pageOffset);
+
+    if (page == NULL)
+    {
+        /* Waits for a slot to be programmed */
+        return false;
+    }
+
+    payload = (uf2->targetAddr - pageOffset) / DRV_UF2_PAYLOAD_SIZE;
+    (void) memcpy((uint8_t *)page->data + (payload * DRV_UF2_PAYLOAD_SIZE), uf2->data, DRV_UF2_PAYLOAD_SIZE);
+    page->filled |= (1UL << payload);
+
+    dObj->received[blockNo / 32U] |= (1UL << (blockNo % 32U));
+    dObj->receivedBlocks++;
+    dObj->lastWriteCount = SYS_TIME_CounterGet();
+
+    if (page->filled == ((1UL << DRV_UF2_PAGE_PAYLOADS) - 1U))
+    {
+        page->full = true;
+    }
+
+    if (dObj->receivedBlocks == dObj->numBlocks)
+    {
+        lDRV_UF2_PagesClose(dObj);
+    }
+
+    return true;
+}
+
+/* Takes the blocks of the write of the client. Returns true once all of
+   them are taken. Called with the mutex held. */
+static bool lDRV_UF2_WriteProgress( DRV_UF2_OBJ * dObj, DRV_UF2_CLIENT_OBJ * clientObj )
+{
+    while (clientObj->requestBlocks != 0U)
+    {
+        if (lDRV_UF2_BlockWrite(dObj, clientObj->requestBuffer) == false)
+        {
+            return false;
+        }
+
+        clientObj->requestBuffer += DRV_UF2_BLOCK_SIZE;
+        clientObj->requestBlock++;
+        clientObj->requestBlocks--;
+    }
+
+    return true;
+}
+
+/* Issues the next NVMCTRL command of a complete page, or reads the
+   programmed page back. Called with the mutex held. */
+static void lDRV_UF2_NVMProgress( DRV_UF2_OBJ * dObj )
+{
+    DRV_UF2_PAGE * page = NULL;
+    uint32_t eraseBlock = 0U;
+    uint32_t flashPage;
+    uint32_t address;
+    bool interruptState;
+    bool committed = false;
+    bool verify = false;
+    uint32_t i;
+
+    for (i = 0U; i < DRV_UF2_PAGES_NUMBER; i++)
+    {
+        if ((dObj->page[i].filled != 0U) && (dObj->page[i].full == true))
+        {
+            page = &dObj->page[i];
+            eraseBlock = page->offset / NVMCTRL_FLASH_BLOCKSIZE;
+            break;
+        }
+    }
+
+    /* Nothing may load the page buffer or start an NVMCTRL command between
+       the check and the command */
+    interruptState = SYS_INT_Disable();
+
+    if (NVMCTRL_IsBusy() || NVMCTRL_SmartEEPROM_IsBusy())
+    {
+        /* This driver, the flash driver or the key/value store */
+    }
+    else if (dObj->verifyPending == true)
+    {
+        verify = true;
+    }
+    else if (page == NULL)
+    {
+        /* The pages are still being assembled */
+    }
+    else if ((dObj->erased[eraseBlock / 32U] & (1UL << (eraseBlock % 32U))) == 0U)
+    {
+        (void) NVMCTRL_BlockErase(dObj->bankAddress + (eraseBlock * NVMCTRL_FLASH_BLOCKSIZE));
+        dObj->erased[eraseBlock / 32U] |= (1UL << (eraseBlock % 32U));
+    }
+    else
+    {
+        address = dObj->bankAddress + page->offset;
+        (void) NVMCTRL_PageBufferWrite(page->data, address);
+        (void) NVMCTRL_PageBufferCommit(address);
+
+        flashPage = page->offset / NVMCTRL_FLASH_PAGESIZE;
+        dObj->programmed[flashPage / 32U] |= (1UL << (flashPage % 32U));
+
+        dObj->verifyOffset = page->offset;
+        dObj->verifyFilled = page->filled;
+        committed = true;
+    }
+
+    SYS_INT_Restore(interruptState);
+
+    if (committed == true)
+    {
+        /* The slot is freed once the CRC of its RAM copy is taken */
+        dObj->verifyCrc = lDRV_UF2_PageCrc((const uint8_t *)page->data, dObj->verifyFilled);
+        dObj->verifyPending = true;
+        page->filled = 0U;
+        page->full = false;
+    }
+
+    if (verify == true)
+    {
+        /* The CMCC data cache is disabled, so the read sees the flash */
+        if (lDRV_UF2_PageCrc((const uint8_t *)(uintptr_t)(dObj->bankAddress + dObj->verifyOffset),
+                dObj->verifyFilled) != dObj->verifyCrc)
+        {
+            dObj->updateState = DRV_UF2_UPDATE_FAILED;
+        }
+
+        dObj->verifyPending = false;
+    }
+}
+
+/* Returns true if the bank starts with the vector table of an image that
+   fits in it */
+static bool lDRV_UF2_ImageIsValid( const DRV_UF2_OBJ * dObj )
+{
+    const uint32_t * vectors = (const uint32_t *)(uintptr_t)dObj->bankAddress;
+    uint32_t stackPointer = vectors[0];
+    uint32_t resetHandler = vectors[1];
+
+    return (((dObj->erased[0] & 1U) != 0U) &&
+            (stackPointer > HSRAM_ADDR) && (stackPointer <= (HSRAM_ADDR + HSRAM_SIZE)) &&
+            ((resetHandler & 1U) != 0U) && ((resetHandler & ~1U) < dObj->imageSize));
+}
+
+/* Swaps the banks, which resets the device, once the update has waited
+   long enough and nothing writes to the flash */
+static void lDRV_UF2_Swap( const DRV_UF2_OBJ * dObj )
+{
+    bool interruptState;
+
+    if (SYS_TIME_CountToMS(SYS_TIME_CounterGet() - dObj->lastWriteCount) < DRV_UF2_SWAP_DELAY_MS)
+    {
+        return;
+    }
+
+    /* The key/value store keeps its changes in RAM until it writes them */
+    SYS_KVS_Flush();
+
+    interruptState = SYS_INT_Disable();
+
+    if ((SYS_KVS_IsBusy() == false) && (NVMCTRL_IsBusy() == false) && (NVMCTRL_SmartEEPROM_IsBusy() == false))
+    {
+        NVMCTRL_BankSwap();
+    }
+
+    SYS_INT_Restore(interruptState);
+}
+
+static void lDRV_UF2_Submit( const DRV_HANDLE handle, DRV_UF2_COMMAND_HANDLE * commandHandle,
+        void * buffer, uint32_t blockStart, uint32_t nBlocks, bool isWrite )
+{
+    DRV_UF2_OBJ * dObj = &gDrvUf2Obj;
+    DRV_UF2_CLIENT_OBJ * clientObj = lDRV_UF2_DriverHandleValidate(handle);
+    DRV_UF2_COMMAND_HANDLE requestHandle;
+    bool completed = true;
+    uint32_t i;
+
+    if (commandHandle != NULL)
+    {
+        *commandHandle = DRV_UF2_COMMAND_HANDLE_INVALID;
+    }
+
+    if ((clientObj == NULL) || (buffer == NULL) || (nBlocks == 0U) ||
+        (blockStart >= DRV_UF2_MEDIA_BLOCKS) || (nBlocks > (DRV_UF2_MEDIA_BLOCKS - blockStart)) ||
+        (isWrite && (((uint32_t)clientObj->ioIntent & (uint32_t)DRV_IO_INTENT_WRITE) == 0U)))
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+    {
+        return;
+    }
+
+    if (clientObj->requestPending == true)
+    {
+        (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+        return;
+    }
+
+    requestHandle = ((uint32_t)dObj->commandToken << 16) | ((uint32_t)handle & DRV_UF2_INDEX_MASK);
+    dObj->commandToken = lDRV_UF2_UPDATE_TOKEN(dObj->commandToken);
+
+    if (isWrite)
+    {
+        clientObj->requestHandle = requestHandle;
+        clientObj->requestBuffer = (const uint8_t *)buffer;
+        clientObj->requestBlock = blockStart;
+        clientObj->requestBlocks = nBlocks;
+
+        completed = lDRV_UF2_WriteProgress(dObj, clientObj);
+        clientObj->requestPending = !completed;
+    }
+    else
+    {
+        for (i = 0U; i < nBlocks; i++)
+        {
+            lDRV_UF2_BlockRead(blockStart + i, (uint8_t *)buffer + (i * DRV_UF2_BLOCK_SIZE));
+        }
+    }
+
+    (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+    if (commandHandle != NULL)
+    {
+        *commandHandle = requestHandle;
+    }
+
+    if ((completed == true) && (clientObj->eventHandler != NULL))
+    {
+        clientObj->eventHandler((SYS_MEDIA_BLOCK_EVENT)DRV_UF2_EVENT_COMMAND_COMPLETE, requestHandle, clientObj->context);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Driver Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+SYS_MODULE_OBJ DRV_UF2_Initialize( const SYS_MODULE_INDEX drvIndex, const SYS_MODULE_INIT * const init )
+{
+    DRV_UF2_OBJ * dObj = &gDrvUf2Obj;
+    const DRV_UF2_INIT * uf2Init = (const DRV_UF2_INIT *)init;
+    uint32_t i;
+
+    if ((drvIndex != 0U) || (uf2Init == NULL) ||
+        ((uf2Init->bankAddress % NVMCTRL_FLASH_BLOCKSIZE) != 0U) || (uf2Init->imageSize == 0U) ||
+        ((uf2Init->imageSize % NVMCTRL_FLASH_BLOCKSIZE) != 0U) || (uf2Init->imageSize > (FLASH_SIZE / 2U)))
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
+    if (dObj->status == SYS_STATUS_READY)
+    {
+        /* Driver is already initialized */
+        return (SYS_MODULE_OBJ)drvIndex;
+    }
+
+    (void) memset(dObj, 0, sizeof(DRV_UF2_OBJ));
+
+    if (OSAL_MUTEX_Create(&dObj->mutex) != OSAL_RESULT_SUCCESS)
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
+    dObj->bankAddress = uf2Init->bankAddress;
+    dObj->imageSize = uf2Init->imageSize;
+    dObj->clientToken = 1U;
+    dObj->commandToken = 1U;
+    dObj->updateState = DRV_UF2_UPDATE_IDLE;
+
+    for (i = 0U; i <= (uint32_t)SYS_MEDIA_GEOMETRY_TABLE_ERASE_ENTRY; i++)
+    {
+        dObj->mediaGeometryTable[i].blockSize = DRV_UF2_BLOCK_SIZE;
+        dObj->mediaGeometryTable[i].numBlocks = DRV_UF2_MEDIA_BLOCKS;
+    }
+
+    dObj->mediaGeometryObj.mediaProperty = SYS_MEDIA_READ_IS_BLOCKING;
+    dObj->mediaGeometryObj.numReadRegions = 1;
+    dObj->mediaGeometryObj.numWriteRegions = 1;
+    dObj->mediaGeometryObj.numEraseRegions = 1;
+    dObj->mediaGeometryObj.geometryTable = dObj->mediaGeometryTable;
+
+    dObj->status = SYS_STATUS_READY;
+
+    return (SYS_MODULE_OBJ)drvIndex;
+}
+
+SYS_STATUS DRV_UF2_Status( SYS_MODULE_OBJ object )
+{
+    if (object != 0U)
+    {
+        return SYS_STATUS_UNINITIALIZED;
+    }
+
+    return gDrvUf2Obj.status;
+}
+
+void DRV_UF2_Tasks( SYS_MODULE_OBJ object )
+{
+    DRV_UF2_OBJ * dObj = &gDrvUf2Obj;
+    DRV_UF2_CLIENT_OBJ * clientObj;
+    DRV_UF2_EVENT_HANDLER eventHandler;
+    DRV_UF2_COMMAND_HANDLE requestHandle = DRV_UF2_COMMAND_HANDLE_INVALID;
+    uintptr_t context = 0U;
+    uint32_t i;
+
+    if ((object != 0U) || (dObj->status != SYS_STATUS_READY))
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+    {
+        return;
+    }
+
+    lDRV_UF2_NVMProgress(dObj);
+
+    if ((dObj->updateState == DRV_UF2_UPDATE_RECEIVING) && (dObj->receivedBlocks == dObj->numBlocks) &&
+        (lDRV_UF2_PagesInUse(dObj) == false) && (dObj->verifyPending == false))
+    {
+        dObj->updateState = lDRV_UF2_ImageIsValid(dObj) ? DRV_UF2_UPDATE_SWAP : DRV_UF2_UPDATE_FAILED;
+    }
+
+    if (dObj->updateState == DRV_UF2_UPDATE_SWAP)
+    {
+        lDRV_UF2_Swap(dObj);
+    }
+
+    (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+    for (i = 0U; i < DRV_UF2_CLIENTS_NUMBER; i++)
+    {
+        clientObj = &dObj->clientObj[i];
+        eventHandler = NULL;
+
+        if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+        {
+            return;
+        }
+
+        if ((clientObj->requestPending == true) && (lDRV_UF2_WriteProgress(dObj, clientObj) == true))
+        {
+            clientObj->requestPending = false;
+
+            eventHandler = clientObj->eventHandler;
+            context = clientObj->context;
+            requestHandle = clientObj->requestHandle;
+        }
+
+        (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+        /* Called without the mutex, so the handler may queue the next request */
+        if (eventHandler != NULL)
+        {
+            eventHandler((SYS_MEDIA_BLOCK_EVENT)DRV_UF2_EVENT_COMMAND_COMPLETE, requestHandle, context);
+        }
+    }
+}
+
+bool DRV_UF2_IsBusy( SYS_MODULE_OBJ object )
+{
+    uint32_t i;
+
+    if (object != 0U)
+    {
+        return false;
+    }
+
+    if (gDrvUf2Obj.verifyPending == true)
+    {
+        return true;
+    }
+
+    for (i = 0U; i < DRV_UF2_PAGES_NUMBER; i++)
+    {
+        if ((gDrvUf2Obj.page[i].filled != 0U) && (gDrvUf2Obj.page[i].full == true))
+        {
+            return true;
+        }
+    }
+
+    for (i = 0U; i < DRV_UF2_CLIENTS_NUMBER; i++)
+    {
+        if (gDrvUf2Obj.clientObj[i].requestPending == true)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+DRV_UF2_UPDATE_STATE DRV_UF2_UpdateStateGet( SYS_MODULE_OBJ object )
+{
+    if (object != 0U)
+    {
+        return DRV_UF2_UPDATE_IDLE;
+    }
+
+    return gDrvUf2Obj.updateState;
+}
+
+DRV_HANDLE DRV_UF2_Open( const SYS_MODULE_INDEX drvIndex, const DRV_IO_INTENT ioIntent )
+{
+    DRV_UF2_OBJ * dObj = &gDrvUf2Obj;
+    DRV_HANDLE handle = DRV_HANDLE_INVALID;
+    uint32_t index;
+
+    if ((drvIndex != 0U) || (dObj->status != SYS_STATUS_READY))
+    {
+        return DRV_HANDLE_INVALID;
+    }
+
+    if (OSAL_MUTEX_Lock(&dObj->mutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_SUCCESS)
+    {
+        return DRV_HANDLE_INVALID;
+    }
+
+    for (index = 0U; index < DRV_UF2_CLIENTS_NUMBER; index++)
+    {
+        if (dObj->clientObj[index].inUse == false)
+        {
+            handle = ((uint32_t)dObj->clientToken << 16) | index;
+            dObj->clientToken = lDRV_UF2_UPDATE_TOKEN(dObj->clientToken);
+
+            dObj->clientObj[index].inUse = true;
+            dObj->clientObj[index].ioIntent = ioIntent;
+            dObj->clientObj[index].clientHandle = handle;
+            dObj->clientObj[index].eventHandler = NULL;
+            dObj->clientObj[index].context = 0U;
+            dObj->clientObj[index].requestPending = false;
+            break;
+        }
+    }
+
+    (void) OSAL_MUTEX_Unlock(&dObj->mutex);
+
+    return handle;
+}
+
+void DRV_UF2_Close( DRV_HANDLE handle )
+{
+    DRV_UF2_CLIENT_OBJ * clientObj = lDRV_UF2_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&gDrvUf2Obj.mutex, OSAL_WAIT_FOREVER) == OSAL_RESULT_SUCCESS)
+    {
+        /* The blocks already taken stay in the update */
+        clientObj->requestPending = false;
+        clientObj->inUse = false;
+        (void) OSAL_MUTEX_Unlock(&gDrvUf2Obj.mutex);
+    }
+}
+
+void DRV_UF2_AsyncRead( const DRV_HANDLE handle, DRV_UF2_COMMAND_HANDLE * commandHandle,
+        void * targetBuffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    lDRV_UF2_Submit(handle, commandHandle, targetBuffer, blockStart, nBlocks, false);
+}
+
+void DRV_UF2_AsyncWrite( const DRV_HANDLE handle, DRV_UF2_COMMAND_HANDLE * commandHandle,
+        void * sourceBuffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    lDRV_UF2_Submit(handle, commandHandle, sourceBuffer, blockStart, nBlocks, true);
+}
+
+SYS_MEDIA_GEOMETRY * DRV_UF2_GeometryGet( const DRV_HANDLE handle )
+{
+    if (lDRV_UF2_DriverHandleValidate(handle) == NULL)
+    {
+        return NULL;
+    }
+
+    return &gDrvUf2Obj.mediaGeometryObj;
+}
+
+/* MISRA C-2012 Rule 11.1 deviated:1 Deviation record ID -  H3_MISRAC_2012_R_11_1_DR_1 */
+void DRV_UF2_EventHandlerSet( const DRV_HANDLE handle, const void * eventHandler, const uintptr_t context )
+{
+    DRV_UF2_CLIENT_OBJ * clientObj = lDRV_UF2_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return;
+    }
+
+    if (OSAL_MUTEX_Lock(&gDrvUf2Obj.mutex, OSAL_WAIT_FOREVER) == OSAL_RESULT_SUCCESS)
+    {
+        clientObj->eventHandler = (DRV_UF2_EVENT_HANDLER)eventHandler;
+        clientObj->context = context;
+        (void) OSAL_MUTEX_Unlock(&gDrvUf2Obj.mutex);
+    }
+}
+/* MISRAC 2012 deviation block end */
+
+bool DRV_UF2_IsAttached( const DRV_HANDLE handle )
+{
+    return (lDRV_UF2_DriverHandleValidate(handle) != NULL);
+}
+
+bool DRV_UF2_IsWriteProtected( const DRV_HANDLE handle )
+{
+    DRV_UF2_CLIENT_OBJ * clientObj = lDRV_UF2_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return false;
+    }
+
+    return (((uint32_t)clientObj->ioIntent & (uint32_t)DRV_IO_INTENT_WRITE) == 0U);
+}
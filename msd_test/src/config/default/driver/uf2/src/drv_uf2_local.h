@@ -0,0 +1,224 @@
+/*******************************************************************************
+  UF2 Update Media Driver Local Data Structures
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_uf2_local.h
+
+  Summary:
+    UF2 Update Media Driver local declarations and structures.
+
+  Description:
+    This file contains the UF2 Update Media Driver's local declarations and
+    definitions.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+
+#ifndef DRV_UF2_LOCAL_H
+#define DRV_UF2_LOCAL_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: File includes
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "driver/uf2/drv_uf2.h"
+#include "peripheral/nvmctrl/plib_nvmctrl.h"
+#include "osal/osal.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Helper Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* UF2 Driver Handle Macros */
+#define DRV_UF2_INDEX_MASK                      (0x000000FFU)
+#define DRV_UF2_TOKEN_MAX                       (0xFFFFU)
+
+/* UF2 block format */
+#define DRV_UF2_MAGIC_START0                    (0x0A324655U)
+#define DRV_UF2_MAGIC_START1                    (0x9E5D5157U)
+#define DRV_UF2_MAGIC_END                       (0x0AB16F30U)
+#define DRV_UF2_FLAG_NOT_MAIN_FLASH             (0x00000001U)
+#define DRV_UF2_FLAG_FILE_CONTAINER             (0x00001000U)
+#define DRV_UF2_FLAG_FAMILY_ID_PRESENT          (0x00002000U)
+#define DRV_UF2_PAYLOAD_SIZE                    (256U)
+
+/* Largest image the driver can track, in UF2 blocks: the size of a bank */
+#define DRV_UF2_BLOCKS_MAX                      ((FLASH_SIZE / 2U) / DRV_UF2_PAYLOAD_SIZE)
+#define DRV_UF2_ERASE_BLOCKS_MAX                ((FLASH_SIZE / 2U) / NVMCTRL_FLASH_BLOCKSIZE)
+#define DRV_UF2_FLASH_PAGES_MAX                 ((FLASH_SIZE / 2U) / NVMCTRL_FLASH_PAGESIZE)
+
+/* UF2 blocks in a flash page */
+#define DRV_UF2_PAGE_PAYLOADS                   (NVMCTRL_FLASH_PAGESIZE / DRV_UF2_PAYLOAD_SIZE)
+
+/* Layout of the volume: boot sector, two FATs, root directory and data.
+   INFO_UF2.TXT is the only file, in the first cluster of one block. */
+#define DRV_UF2_FAT_BLOCKS                      ((((DRV_UF2_MEDIA_BLOCKS + 2U) * 2U) + DRV_UF2_BLOCK_SIZE - 1U) / DRV_UF2_BLOCK_SIZE)
+#define DRV_UF2_ROOT_ENTRIES                    (512U)
+#define DRV_UF2_ROOT_BLOCKS                     ((DRV_UF2_ROOT_ENTRIES * 32U) / DRV_UF2_BLOCK_SIZE)
+#define DRV_UF2_FAT_START                       (1U)
+#define DRV_UF2_ROOT_START                      (DRV_UF2_FAT_START + (2U * DRV_UF2_FAT_BLOCKS))
+#define DRV_UF2_DATA_START                      (DRV_UF2_ROOT_START + DRV_UF2_ROOT_BLOCKS)
+#define DRV_UF2_VOLUME_LABEL                    "UF2 UPDATE "
+
+/* Date of INFO_UF2.TXT in the FAT format, 1 January 2019 */
+#define DRV_UF2_FILE_DATE                       (((2019U - 1980U) << 9) | (1U << 5) | 1U)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* UF2 block, as written by the host in one media block */
+typedef struct
+{
+    uint32_t                        magicStart0;
+    uint32_t                        magicStart1;
+    uint32_t                        flags;
+    uint32_t                        targetAddr;
+    uint32_t                        payloadSize;
+    uint32_t                        blockNo;
+    uint32_t                        numBlocks;
+
+    /* Family ID with DRV_UF2_FLAG_FAMILY_ID_PRESENT */
+    uint32_t                        fileSize;
+
+    uint8_t                         data[476];
+    uint32_t                        magicEnd;
+
+} DRV_UF2_BLOCK;
+
+/* Flash page assembled in RAM from its UF2 blocks */
+typedef struct
+{
+    uint32_t                        data[NVMCTRL_FLASH_PAGESIZE / 4U];
+    uint32_t                        offset;
+
+    /* One bit per UF2 block of the page, 0 while the slot is free */
+    uint32_t                        filled;
+
+    /* Set once no more UF2 blocks go to the page */
+    bool                            full;
+
+    /* Order in which the slots were taken */
+    uint32_t                        sequence;
+
+} DRV_UF2_PAGE;
+
+/* UF2 Driver client object */
+typedef struct
+{
+    /* The client is open */
+    bool                            inUse;
+
+    /* Intent the client was opened with */
+    DRV_IO_INTENT                   ioIntent;
+
+    /* Client handle returned by DRV_UF2_Open */
+    DRV_HANDLE                      clientHandle;
+
+    /* Function called when a request of the client ends */
+    DRV_UF2_EVENT_HANDLER           eventHandler;
+
+    uintptr_t                       context;
+
+    /* Write waiting for the page before it to be programmed. requestBlock
+       and requestBlocks are the blocks left. */
+    bool                            requestPending;
+    DRV_UF2_COMMAND_HANDLE          requestHandle;
+    const uint8_t *                 requestBuffer;
+    uint32_t                        requestBlock;
+    uint32_t                        requestBlocks;
+
+} DRV_UF2_CLIENT_OBJ;
+
+/* UF2 Driver instance object */
+typedef struct
+{
+    SYS_STATUS                      status;
+
+    /* Bank the update is programmed into */
+    uint32_t                        bankAddress;
+    uint32_t                        imageSize;
+
+    /* Token of the next client and command handles */
+    uint16_t                        clientToken;
+    uint16_t                        commandToken;
+
+    DRV_UF2_CLIENT_OBJ              clientObj[DRV_UF2_CLIENTS_NUMBER];
+
+    DRV_UF2_UPDATE_STATE            updateState;
+
+    /* Blocks of the UF2 file, one bit per block received */
+    uint32_t                        numBlocks;
+    uint32_t                        receivedBlocks;
+    uint32_t                        received[DRV_UF2_BLOCKS_MAX / 32U];
+
+    /* One bit per flash block erased since the start of the update */
+    uint32_t                        erased[(DRV_UF2_ERASE_BLOCKS_MAX + 31U) / 32U];
+
+    /* One bit per flash page programmed since the start of the update */
+    uint32_t                        programmed[(DRV_UF2_FLASH_PAGES_MAX + 31U) / 32U];
+
+    /* Pages being assembled. A page is only programmed once all its UF2
+       blocks are there, so that it is never programmed twice. */
+    DRV_UF2_PAGE                    page[DRV_UF2_PAGES_NUMBER];
+    uint32_t                        pageSequence;
+
+    /* Page being programmed, read back once the NVMCTRL is idle */
+    bool                            verifyPending;
+    uint32_t                        verifyOffset;
+    uint32_t                        verifyFilled;
+    uint32_t                        verifyCrc;
+
+    /* Counter value at the last UF2 block */
+    uint32_t                        lastWriteCount;
+
+    /* UF2 driver geometry object */
+    SYS_MEDIA_GEOMETRY              mediaGeometryObj;
+
+    /* UF2 driver media geometry table */
+    SYS_MEDIA_REGION_GEOMETRY       mediaGeometryTable[3];
+
+    /* Mutex to protect the client objects and the update */
+    OSAL_MUTEX_DECLARE(mutex);
+
+} DRV_UF2_OBJ;
+
+#endif //#ifndef DRV_UF2_LOCAL_H
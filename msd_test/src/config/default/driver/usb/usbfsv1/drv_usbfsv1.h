@@ -561,6 +561,138 @@ typedef struct
 
 } DRV_USBFSV1_INIT;
 
+// *****************************************************************************
+/* USB Device Mode ISR Statistics
+
+  Summary:
+    Execution time statistics of the device mode interrupt handler.
+
+  Description:
+    This structure is filled by the DRV_USBFSV1_DEVICE_ISRStatisticsGet
+    function. Execution times are measured in CPU clock cycles using the DWT
+    cycle counter. The IRP counters show how many IRP callbacks were invoked
+    from the interrupt and how many were deferred to DRV_USBFSV1_Tasks.
+
+  Remarks:
+    Statistics are only collected when DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE
+    is set to true.
+*/
+
+typedef struct
+{
+    /* Number of times the device mode ISR was executed */
+    uint32_t isrCount;
+
+    /* Execution time of the last ISR in cycles */
+    uint32_t lastCycles;
+
+    /* Shortest ISR execution time in cycles */
+    uint32_t minCycles;
+
+    /* Longest ISR execution time in cycles */
+    uint32_t maxCycles;
+
+    /* Sum of all ISR execution times in cycles */
+    uint64_t totalCycles;
+
+    /* IRP callbacks invoked from the ISR */
+    uint32_t irpCallbacksInIsr;
+
+    /* IRP callbacks deferred to DRV_USBFSV1_Tasks */
+    uint32_t irpCallbacksDeferred;
+
+    /* Deferred completions that found the queue full and were invoked
+       from the ISR instead */
+    uint32_t irpQueueOverflows;
+
+    /* Highest number of entries seen in the completion queue */
+    uint32_t irpQueueHighWater;
+
+} DRV_USBFSV1_DEVICE_ISR_STATISTICS;
+
+/* Buckets of the bytes per frame histogram and the bytes each bucket covers.
+   A full speed frame carries at most 19 bulk packets of 64 bytes. */
+#define DRV_USBFSV1_DEVICE_FRAME_HISTOGRAM_BUCKETS      10U
+#define DRV_USBFSV1_DEVICE_FRAME_HISTOGRAM_WIDTH        128U
+
+// *****************************************************************************
+/* USB Device Mode Frame Statistics
+
+  Summary:
+    Use of the USB frames by the data packets of the device.
+
+  Description:
+    This structure is filled by the DRV_USBFSV1_DEVICE_FrameStatisticsGet
+    function. The packets are counted in the frame in which the ISR handles
+    their completion. A frame ends at the next SOF interrupt.
+
+  Remarks:
+    Statistics are only collected when DRV_USBFSV1_DEVICE_TRACE_ENABLE is set
+    to true.
+*/
+
+typedef struct
+{
+    /* Frames that have ended */
+    uint32_t frames;
+
+    /* Frames that moved at least one data byte */
+    uint32_t busyFrames;
+
+    /* Packets moved, including zero length packets */
+    uint32_t packets;
+
+    /* Data bytes moved */
+    uint64_t bytes;
+
+    /* Most data bytes moved in one frame */
+    uint32_t maxFrameBytes;
+
+    /* Frames by data bytes moved. Bucket n counts the frames that moved
+       n * DRV_USBFSV1_DEVICE_FRAME_HISTOGRAM_WIDTH bytes or more, the last
+       bucket all the frames above. */
+    uint32_t histogram[DRV_USBFSV1_DEVICE_FRAME_HISTOGRAM_BUCKETS];
+
+    /* Completed IRPs that found the trace full and were not traced */
+    uint32_t traceOverflows;
+
+} DRV_USBFSV1_DEVICE_FRAME_STATISTICS;
+
+// *****************************************************************************
+/* USB Device Mode Transfer Trace Entry
+
+  Summary:
+    Describes one completed IRP.
+
+  Description:
+    The driver adds an entry to the trace when it completes an IRP in the ISR.
+    The entries are read in completion order by DRV_USBFSV1_DEVICE_TraceRead.
+    The time between two entries of an endpoint shows how long the endpoint
+    stayed idle or was NAKed between two transfers.
+
+  Remarks:
+    Entries are only added when DRV_USBFSV1_DEVICE_TRACE_ENABLE is set to true.
+*/
+
+typedef struct
+{
+    /* DWT cycle counter at the completion */
+    uint32_t cycles;
+
+    /* Bytes moved by the IRP */
+    uint32_t size;
+
+    /* Frame number at the completion */
+    uint16_t frame;
+
+    /* Endpoint address. Bit 7 is set for an IN endpoint. */
+    uint8_t endpoint;
+
+    /* Completion status, a USB_DEVICE_IRP_STATUS value */
+    int8_t status;
+
+} DRV_USBFSV1_DEVICE_TRACE_ENTRY;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Interface Routines - System Level
@@ -1963,6 +2095,163 @@ USB_ERROR DRV_USBFSV1_DEVICE_IRPCancel
     DRV_HANDLE handle, 
     USB_DEVICE_IRP * irp
 );
+
+// *****************************************************************************
+/* Function:
+    bool DRV_USBFSV1_DEVICE_ISRStatisticsGet
+    (
+        SYS_MODULE_OBJ object,
+        DRV_USBFSV1_DEVICE_ISR_STATISTICS * statistics,
+        bool reset
+    )
+
+  Summary:
+    Returns the device mode ISR execution statistics.
+
+  Description:
+    This function copies the device mode ISR execution time and IRP completion
+    statistics of the driver instance into the structure pointed to by
+    statistics. If reset is true, the statistics are cleared after they have
+    been copied.
+
+  Precondition:
+    The DRV_USBFSV1_Initialize function must have been called for the specified
+    USB Driver instance.
+
+  Parameters:
+    object - Object handle for the specified driver instance (returned from
+    DRV_USBFSV1_Initialize).
+
+    statistics - Pointer to the structure that receives the statistics.
+
+    reset - If true, the statistics are cleared after being read.
+
+  Returns:
+    true - The statistics were copied.
+    false - The object is invalid or statistics collection is disabled.
+
+  Example:
+    <code>
+    DRV_USBFSV1_DEVICE_ISR_STATISTICS isrStats;
+
+    if(DRV_USBFSV1_DEVICE_ISRStatisticsGet(sysObj.drvUSBFSV1Object, &isrStats, true))
+    {
+        // Average ISR time is isrStats.totalCycles / isrStats.isrCount
+    }
+    </code>
+
+  Remarks:
+    Statistics are only collected when DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE
+    is set to true.
+*/
+
+bool DRV_USBFSV1_DEVICE_ISRStatisticsGet
+(
+    SYS_MODULE_OBJ object,
+    DRV_USBFSV1_DEVICE_ISR_STATISTICS * statistics,
+    bool reset
+);
+
+// *****************************************************************************
+/* Function:
+    bool DRV_USBFSV1_DEVICE_FrameStatisticsGet
+    (
+        SYS_MODULE_OBJ object,
+        DRV_USBFSV1_DEVICE_FRAME_STATISTICS * statistics,
+        bool reset
+    )
+
+  Summary:
+    Returns the frame utilization statistics.
+
+  Description:
+    This function copies the frame utilization statistics of the driver
+    instance into the structure pointed to by statistics. If reset is true,
+    the statistics are cleared after they have been copied.
+
+  Precondition:
+    The DRV_USBFSV1_Initialize function must have been called for the specified
+    USB Driver instance.
+
+  Parameters:
+    object - Object handle for the specified driver instance (returned from
+    DRV_USBFSV1_Initialize).
+
+    statistics - Pointer to the structure that receives the statistics.
+
+    reset - If true, the statistics are cleared after being read.
+
+  Returns:
+    true - The statistics were copied.
+    false - The object is invalid or tracing is disabled.
+
+  Example:
+    <code>
+    DRV_USBFSV1_DEVICE_FRAME_STATISTICS frameStats;
+
+    if(DRV_USBFSV1_DEVICE_FrameStatisticsGet(sysObj.drvUSBFSV1Object, &frameStats, true))
+    {
+        // Average bytes per frame is frameStats.bytes / frameStats.frames
+    }
+    </code>
+
+  Remarks:
+    Statistics are only collected when DRV_USBFSV1_DEVICE_TRACE_ENABLE is set
+    to true.
+*/
+
+bool DRV_USBFSV1_DEVICE_FrameStatisticsGet
+(
+    SYS_MODULE_OBJ object,
+    DRV_USBFSV1_DEVICE_FRAME_STATISTICS * statistics,
+    bool reset
+);
+
+// *****************************************************************************
+/* Function:
+    uint32_t DRV_USBFSV1_DEVICE_TraceRead
+    (
+        SYS_MODULE_OBJ object,
+        DRV_USBFSV1_DEVICE_TRACE_ENTRY * entries,
+        uint32_t count
+    )
+
+  Summary:
+    Removes the oldest entries from the transfer trace.
+
+  Description:
+    This function copies up to count of the oldest trace entries into the
+    array pointed to by entries and removes them from the trace, which makes
+    room for DRV_USBFSV1_DEVICE_TRACE_DEPTH further completions. The trace
+    keeps the oldest entries when it is full.
+
+  Precondition:
+    The DRV_USBFSV1_Initialize function must have been called for the specified
+    USB Driver instance.
+
+  Parameters:
+    object - Object handle for the specified driver instance (returned from
+    DRV_USBFSV1_Initialize).
+
+    entries - Array that receives the entries.
+
+    count - Size of the array.
+
+  Returns:
+    Number of entries copied. 0 if the object is invalid or tracing is
+    disabled.
+
+  Remarks:
+    Must be called from a single task. The ISR adds entries without taking a
+    lock.
+*/
+
+uint32_t DRV_USBFSV1_DEVICE_TraceRead
+(
+    SYS_MODULE_OBJ object,
+    DRV_USBFSV1_DEVICE_TRACE_ENTRY * entries,
+    uint32_t count
+);
 // ****************************************************************************
 /* Function:
     bool DRV_USBFSV1_HOST_EventsDisable
@@ -52,6 +52,7 @@
 #include "usb/src/usb_external_dependencies.h"
 #include "driver/usb/usbfsv1/src/drv_usbfsv1_local.h"
 #include "interrupts.h"
+#include "system/memory/sys_memory.h"
 
 
 // *****************************************************************************
@@ -65,6 +66,7 @@
  * lumped together as group to save memory.
  ******************************************************/
 static DRV_USBFSV1_OBJ gDrvUSBFSV1Obj [DRV_USBFSV1_INSTANCES_NUMBER];
+SYS_MEMORY_OBJECT_REGISTER(gDrvUSBFSV1Obj);
 
 // *****************************************************************************
 // *****************************************************************************
@@ -326,6 +328,9 @@ void DRV_USBFSV1_Tasks
 
                 hDriver->vbusLevel = vbusLevel;
             }
+
+            /* Invoke the callbacks of IRPs completed in the ISR */
+            M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_DRAIN(hDriver);
         }
         else if(hDriver->operationMode == DRV_USBFSV1_OPMODE_HOST)
         {
@@ -631,7 +636,9 @@ void DRV_USBFSV1_Tasks_ISR
                 case DRV_USBFSV1_OPMODE_DEVICE:
 
                     /* Driver is running in Device Mode */
+                    M_DRV_USBFSV1_DEVICE_ISR_STATISTICS_START(drvObj);
                     M_DRV_USBFSV1_DEVICE_TASKS_ISR(drvObj);
+                    M_DRV_USBFSV1_DEVICE_ISR_STATISTICS_STOP(drvObj);
                     break;
 
                 case DRV_USBFSV1_OPMODE_HOST:
@@ -660,6 +667,163 @@ void DRV_USBFSV1_Tasks_ISR
 
 }/* end of DRV_USBFSV1_Tasks_ISR() */
 
+// *****************************************************************************
+/* Function:
+    bool DRV_USBFSV1_DEVICE_ISRStatisticsGet
+    (
+        SYS_MODULE_OBJ object,
+        DRV_USBFSV1_DEVICE_ISR_STATISTICS * statistics,
+        bool reset
+    )
+
+  Summary:
+    Returns the device mode ISR execution statistics.
+
+  Remarks:
+    See drv_usbfsv1.h for usage information.
+*/
+
+bool DRV_USBFSV1_DEVICE_ISRStatisticsGet
+(
+    SYS_MODULE_OBJ object,
+    DRV_USBFSV1_DEVICE_ISR_STATISTICS * statistics,
+    bool reset
+)
+{
+    bool retVal = false;
+
+#if (DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE == true)
+    DRV_USBFSV1_OBJ * hDriver;
+    bool interruptWasEnabled;
+
+    if((object < DRV_USBFSV1_INSTANCES_NUMBER) && (statistics != NULL))
+    {
+        hDriver = &gDrvUSBFSV1Obj[object];
+
+        /* The ISR updates the statistics. Take a consistent copy. */
+        interruptWasEnabled = SYS_INT_Disable();
+
+        *statistics = hDriver->isrStatistics;
+
+        if(reset == true)
+        {
+            (void) memset(&hDriver->isrStatistics, 0, sizeof(DRV_USBFSV1_DEVICE_ISR_STATISTICS));
+            hDriver->isrStatistics.minCycles = UINT32_MAX;
+        }
+
+        SYS_INT_Restore(interruptWasEnabled);
+
+        retVal = true;
+    }
+#else
+    (void) object;
+    (void) statistics;
+    (void) reset;
+#endif
+
+    return retVal;
+}
+
+// *****************************************************************************
+/* Function:
+    bool DRV_USBFSV1_DEVICE_FrameStatisticsGet
+    (
+        SYS_MODULE_OBJ object,
+        DRV_USBFSV1_DEVICE_FRAME_STATISTICS * statistics,
+        bool reset
+    )
+
+  Summary:
+    Returns the frame utilization statistics.
+
+  Remarks:
+    See drv_usbfsv1.h for usage information.
+*/
+
+bool DRV_USBFSV1_DEVICE_FrameStatisticsGet
+(
+    SYS_MODULE_OBJ object,
+    DRV_USBFSV1_DEVICE_FRAME_STATISTICS * statistics,
+    bool reset
+)
+{
+    bool retVal = false;
+
+#if (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+    DRV_USBFSV1_OBJ * hDriver;
+    bool interruptWasEnabled;
+
+    if((object < DRV_USBFSV1_INSTANCES_NUMBER) && (statistics != NULL))
+    {
+        hDriver = &gDrvUSBFSV1Obj[object];
+
+        /* The ISR updates the statistics. Take a consistent copy. */
+        interruptWasEnabled = SYS_INT_Disable();
+
+        *statistics = hDriver->frameStatistics;
+
+        if(reset == true)
+        {
+            (void) memset(&hDriver->frameStatistics, 0, sizeof(DRV_USBFSV1_DEVICE_FRAME_STATISTICS));
+        }
+
+        SYS_INT_Restore(interruptWasEnabled);
+
+        retVal = true;
+    }
+#else
+    (void) object;
+    (void) statistics;
+    (void) reset;
+#endif
+
+    return retVal;
+}
+
+// *****************************************************************************
+/* Function:
+    uint32_t DRV_USBFSV1_DEVICE_TraceRead
+    (
+        SYS_MODULE_OBJ object,
+        DRV_USBFSV1_DEVICE_TRACE_ENTRY * entries,
+        uint32_t count
+    )
+
+  Summary:
+    Removes the oldest entries from the transfer trace.
+
+  Remarks:
+    See drv_usbfsv1.h for usage information.
+*/
+
+uint32_t DRV_USBFSV1_DEVICE_TraceRead
+(
+    SYS_MODULE_OBJ object,
+    DRV_USBFSV1_DEVICE_TRACE_ENTRY * entries,
+    uint32_t count
+)
+{
+    uint32_t retVal = 0;
+
+#if (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+    DRV_USBFSV1_OBJ * hDriver;
+
+    if((object < DRV_USBFSV1_INSTANCES_NUMBER) && (entries != NULL))
+    {
+        hDriver = &gDrvUSBFSV1Obj[object];
+
+        retVal = SYS_RING_Read(&hDriver->traceRing, hDriver->traceEntry,
+                sizeof(DRV_USBFSV1_DEVICE_TRACE_ENTRY), entries, count);
+    }
+#else
+    (void) object;
+    (void) entries;
+    (void) count;
+#endif
+
+    return retVal;
+}
+
 
 // *****************************************************************************
 /* Function:
@@ -151,6 +151,31 @@ void F_DRV_USBFSV1_DEVICE_Initialize
     /* Initialize device specific flags */
     drvObj->isAttached = false;
     drvObj->isSuspended = false;
+
+#if (DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION == true)
+    /* Start with an empty IRP completion queue */
+    SYS_RING_Initialize(&drvObj->irpCompletionQueue.ring, DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH);
+#endif
+
+#if (DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE == true)
+    /* Enable the DWT cycle counter used to time the ISR */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    (void) memset(&drvObj->isrStatistics, 0, sizeof(DRV_USBFSV1_DEVICE_ISR_STATISTICS));
+    drvObj->isrStatistics.minCycles = UINT32_MAX;
+#endif
+
+#if (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+    /* Enable the DWT cycle counter used to time stamp the trace */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    drvObj->frameBytes = 0;
+    (void) memset(&drvObj->frameStatistics, 0, sizeof(DRV_USBFSV1_DEVICE_FRAME_STATISTICS));
+    SYS_RING_Initialize(&drvObj->traceRing, DRV_USBFSV1_DEVICE_TRACE_DEPTH);
+#endif
 }
 
 // *****************************************************************************
@@ -884,6 +909,8 @@ USB_ERROR DRV_USBFSV1_DEVICE_EndpointDisable
                     endpointObj->endpointState = (DRV_USBFSV1_DEVICE_ENDPOINT_STATE)temp_32;
                 }
 
+                /* Abort the IRPs waiting for their completion callback */
+                M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, DRV_USBFSV1_DEVICE_ENDPOINT_ALL, USB_DEVICE_IRP_STATUS_ABORTED);
             }
             else
             {
@@ -909,6 +936,9 @@ USB_ERROR DRV_USBFSV1_DEVICE_EndpointDisable
                     /* Update the endpoint database */
                     temp_32 = (uint32_t)endpointObj->endpointState & ~((uint32_t)DRV_USBFSV1_DEVICE_ENDPOINT_STATE_ENABLED);
                     endpointObj->endpointState = (DRV_USBFSV1_DEVICE_ENDPOINT_STATE)temp_32;
+
+                    M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, 0U, USB_DEVICE_IRP_STATUS_ABORTED);
+                    M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, DRV_USBFSV1_ENDPOINT_DIRECTION_MASK, USB_DEVICE_IRP_STATUS_ABORTED);
                 }
                 else
                 {
@@ -932,6 +962,8 @@ USB_ERROR DRV_USBFSV1_DEVICE_EndpointDisable
                     /* Update the endpoint database */
                     temp_32 = (uint32_t)endpointObj->endpointState  & ~((uint32_t)DRV_USBFSV1_DEVICE_ENDPOINT_STATE_ENABLED);
                     endpointObj->endpointState  = (DRV_USBFSV1_DEVICE_ENDPOINT_STATE)temp_32;
+
+                    M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, endpointAndDirection, USB_DEVICE_IRP_STATUS_ABORTED);
                 }
             }
             
@@ -1107,6 +1139,7 @@ USB_ERROR DRV_USBFSV1_DEVICE_EndpointStall
                 usbID->DEVICE.DEVICE_ENDPOINT[0].USB_EPSTATUSSET = USB_DEVICE_EPSTATUSSET_STALLRQ0_Msk;
 
                 F_DRV_USBFSV1_DEVICE_IRPQueueFlush(endpointObj, USB_DEVICE_IRP_STATUS_ABORTED_ENDPOINT_HALT);
+                M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, 0U, USB_DEVICE_IRP_STATUS_ABORTED_ENDPOINT_HALT);
                 
                 temp_32 = (uint32_t)endpointObj->endpointState | (uint32_t)DRV_USBFSV1_DEVICE_ENDPOINT_STATE_STALLED;
 
@@ -1115,6 +1148,7 @@ USB_ERROR DRV_USBFSV1_DEVICE_EndpointStall
                 endpointObj++;
 
                 F_DRV_USBFSV1_DEVICE_IRPQueueFlush(endpointObj, USB_DEVICE_IRP_STATUS_ABORTED_ENDPOINT_HALT);
+                M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, DRV_USBFSV1_ENDPOINT_DIRECTION_MASK, USB_DEVICE_IRP_STATUS_ABORTED_ENDPOINT_HALT);
                 
                 temp_32 = (uint32_t)endpointObj->endpointState | (uint32_t)DRV_USBFSV1_DEVICE_ENDPOINT_STATE_STALLED;               
                 endpointObj->endpointState = (DRV_USBFSV1_DEVICE_ENDPOINT_STATE)temp_32;
@@ -1135,6 +1169,7 @@ USB_ERROR DRV_USBFSV1_DEVICE_EndpointStall
                 endpointObj += direction;
                 
                 F_DRV_USBFSV1_DEVICE_IRPQueueFlush(endpointObj, USB_DEVICE_IRP_STATUS_ABORTED_ENDPOINT_HALT);
+                M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, endpointAndDirection, USB_DEVICE_IRP_STATUS_ABORTED_ENDPOINT_HALT);
                 
                 temp_32 = (uint32_t)endpointObj->endpointState | (uint32_t)DRV_USBFSV1_DEVICE_ENDPOINT_STATE_STALLED;
 
@@ -1250,6 +1285,7 @@ USB_ERROR DRV_USBFSV1_DEVICE_EndpointStallClear
                 endpointObj->endpointState = (DRV_USBFSV1_DEVICE_ENDPOINT_STATE)temp_32;
 
                 F_DRV_USBFSV1_DEVICE_IRPQueueFlush(endpointObj, USB_DEVICE_IRP_STATUS_TERMINATED_BY_HOST);
+                M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, 0U, USB_DEVICE_IRP_STATUS_TERMINATED_BY_HOST);
 
                 endpointObj++;
                 
@@ -1258,6 +1294,7 @@ USB_ERROR DRV_USBFSV1_DEVICE_EndpointStallClear
                 endpointObj->endpointState = (DRV_USBFSV1_DEVICE_ENDPOINT_STATE)temp_32;
 
                 F_DRV_USBFSV1_DEVICE_IRPQueueFlush(endpointObj, USB_DEVICE_IRP_STATUS_TERMINATED_BY_HOST);
+                M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, DRV_USBFSV1_ENDPOINT_DIRECTION_MASK, USB_DEVICE_IRP_STATUS_TERMINATED_BY_HOST);
 
             }
             else
@@ -1269,6 +1306,7 @@ USB_ERROR DRV_USBFSV1_DEVICE_EndpointStallClear
                 endpointObj->endpointState = (DRV_USBFSV1_DEVICE_ENDPOINT_STATE)temp_32;
 
                 F_DRV_USBFSV1_DEVICE_IRPQueueFlush(endpointObj, USB_DEVICE_IRP_STATUS_TERMINATED_BY_HOST);
+                M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, endpointAndDirection, USB_DEVICE_IRP_STATUS_TERMINATED_BY_HOST);
                 
                 if(direction == (uint8_t)USB_DATA_DIRECTION_DEVICE_TO_HOST)
                 {
@@ -1445,7 +1483,7 @@ bool DRV_USBFSV1_DEVICE_EndpointIsStalled
 */
 
 
-USB_ERROR DRV_USBFSV1_DEVICE_IRPSubmit
+USB_ERROR RAMFUNC DRV_USBFSV1_DEVICE_IRPSubmit
 (
     DRV_HANDLE handle,
     USB_ENDPOINT endpointAndDirection,
@@ -2041,6 +2079,7 @@ USB_ERROR DRV_USBFSV1_DEVICE_IRPCancelAll
         {
             /* Flush the endpoint */
             F_DRV_USBFSV1_DEVICE_IRPQueueFlush(endpointObj, USB_DEVICE_IRP_STATUS_ABORTED);
+            M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, endpointAndDirection, USB_DEVICE_IRP_STATUS_ABORTED);
 
             if(hDriver->isInInterruptContext == false)
             {
@@ -2206,6 +2245,353 @@ USB_ERROR DRV_USBFSV1_DEVICE_IRPCancel
 }
 
 /* MISRAC 2012 deviation block end */
+// *****************************************************************************
+/* Function:
+    static void F_DRV_USBFSV1_DEVICE_IRPComplete
+    (
+        DRV_USBFSV1_OBJ * hDriver,
+        DRV_USBFSV1_DEVICE_IRP_LOCAL * irp,
+        uint8_t endpoint
+    )
+
+  Summary:
+    Notifies the client of an IRP completed in the ISR.
+
+  Description:
+    When deferred IRP completion is disabled, the IRP callback is invoked
+    immediately. Otherwise the IRP and its final status are placed in the
+    completion queue and the callback is invoked later from DRV_USBFSV1_Tasks.
+    The IRP status is kept as in progress until then, so the client cannot
+    re-submit an IRP it has not been notified about. If the queue is full the
+    callback is invoked immediately. The endpoint address, with bit 7 set for
+    an IN endpoint, identifies the queued IRPs to be aborted when the endpoint
+    is flushed, and goes to the transfer trace.
+
+  Remarks:
+    This is a local function and should only be called from the ISR. The IRP
+    must already have been removed from the endpoint queue.
+*/
+
+static void F_DRV_USBFSV1_DEVICE_IRPComplete
+(
+    DRV_USBFSV1_OBJ * hDriver,
+    DRV_USBFSV1_DEVICE_IRP_LOCAL * irp,
+    uint8_t endpoint
+)
+{
+#if (DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION == true)
+    DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE * queue = &hDriver->irpCompletionQueue;
+    DRV_USBFSV1_DEVICE_IRP_COMPLETION * entry;
+    uint32_t position;
+    uint32_t freeCount = SYS_RING_FreeGet(&queue->ring, &position);
+#if (DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE == true)
+    uint32_t used;
+#endif
+
+    M_DRV_USBFSV1_DEVICE_TRACE_IRP(hDriver, irp, endpoint);
+
+    if(irp->callback == NULL)
+    {
+        /* Nothing to notify */
+    }
+    else if(freeCount != 0U)
+    {
+        entry = &queue->entry[SYS_RING_Index(&queue->ring, position)];
+        entry->irp = irp;
+        entry->status = irp->status;
+        entry->endpoint = endpoint;
+        irp->status = USB_DEVICE_IRP_STATUS_IN_PROGRESS;
+
+        SYS_RING_Commit(&queue->ring, 1U);
+
+#if (DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE == true)
+        hDriver->isrStatistics.irpCallbacksDeferred++;
+        /* Entries in use, including this one */
+        used = (DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH + 1U) - freeCount;
+        if(used > hDriver->isrStatistics.irpQueueHighWater)
+        {
+            hDriver->isrStatistics.irpQueueHighWater = used;
+        }
+#endif
+    }
+    else
+    {
+        /* Queue is full. Fall back to completing in the ISR. */
+#if (DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE == true)
+        hDriver->isrStatistics.irpQueueOverflows++;
+        hDriver->isrStatistics.irpCallbacksInIsr++;
+#endif
+        irp->callback((USB_DEVICE_IRP *)irp);
+    }
+#else
+    M_DRV_USBFSV1_DEVICE_TRACE_IRP(hDriver, irp, endpoint);
+
+    if(irp->callback != NULL)
+    {
+#if (DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE == true)
+        hDriver->isrStatistics.irpCallbacksInIsr++;
+#endif
+        irp->callback((USB_DEVICE_IRP *)irp);
+    }
+#endif
+}
+
+#if (DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION == true)
+// *****************************************************************************
+/* Function:
+    void F_DRV_USBFSV1_DEVICE_IRPCompletionQueueDrain(DRV_USBFSV1_OBJ * hDriver)
+
+  Summary:
+    Invokes the callbacks of IRPs that were completed in the ISR.
+
+  Description:
+    This function removes every entry from the deferred IRP completion queue,
+    restores the final IRP status and invokes the IRP callback. It is called
+    from DRV_USBFSV1_Tasks, so the callbacks (and any function driver or
+    application event handlers they call) run in task context. IRPs submitted
+    from these callbacks are queued to the endpoint as in any other task
+    context submission. An IRP that was cancelled by
+    DRV_USBFSV1_DEVICE_IRPCancel while in the queue keeps the aborted status.
+
+  Remarks:
+    This is a local function and should not be called directly by the
+    application.
+*/
+
+void F_DRV_USBFSV1_DEVICE_IRPCompletionQueueDrain(DRV_USBFSV1_OBJ * hDriver)
+{
+    DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE * queue = &hDriver->irpCompletionQueue;
+    DRV_USBFSV1_DEVICE_IRP_COMPLETION * entry;
+    DRV_USBFSV1_DEVICE_IRP_LOCAL * irp;
+    uint32_t position;
+
+    while(SYS_RING_CountGet(&queue->ring, &position) != 0U)
+    {
+        entry = &queue->entry[SYS_RING_Index(&queue->ring, position)];
+        irp = entry->irp;
+
+        if(irp->status == USB_DEVICE_IRP_STATUS_IN_PROGRESS)
+        {
+            irp->status = entry->status;
+        }
+
+        /* Release the entry before the callback, which may cause further
+         * completions to be queued by the ISR. */
+        SYS_RING_Release(&queue->ring, 1U);
+
+        irp->callback((USB_DEVICE_IRP *)irp);
+    }
+}
+
+// *****************************************************************************
+/* Function:
+    void F_DRV_USBFSV1_DEVICE_IRPCompletionQueueAbort
+    (
+        DRV_USBFSV1_OBJ * hDriver,
+        USB_ENDPOINT endpointAndDirection,
+        USB_DEVICE_IRP_STATUS status
+    )
+
+  Summary:
+    Aborts the IRPs of an endpoint that are in the completion queue.
+
+  Description:
+    This function changes the status to be reported for every queued IRP of
+    the specified endpoint and direction, or of all the endpoints if
+    endpointAndDirection is DRV_USBFSV1_DEVICE_ENDPOINT_ALL. It is called
+    wherever the endpoint IRP queue is flushed, so that an IRP that completed
+    just before the flush is reported with the same abort status as the IRPs
+    that were still queued to the endpoint. The callbacks are invoked by the
+    next F_DRV_USBFSV1_DEVICE_IRPCompletionQueueDrain call.
+
+  Remarks:
+    This is a local function and should only be called from the ISR or with
+    the USB interrupt disabled.
+*/
+
+void F_DRV_USBFSV1_DEVICE_IRPCompletionQueueAbort
+(
+    DRV_USBFSV1_OBJ * hDriver,
+    USB_ENDPOINT endpointAndDirection,
+    USB_DEVICE_IRP_STATUS status
+)
+{
+    DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE * queue = &hDriver->irpCompletionQueue;
+    DRV_USBFSV1_DEVICE_IRP_COMPLETION * entry;
+    uint32_t position;
+    uint32_t count = SYS_RING_CountGet(&queue->ring, &position);
+
+    while(count != 0U)
+    {
+        entry = &queue->entry[SYS_RING_Index(&queue->ring, position)];
+
+        if((endpointAndDirection == DRV_USBFSV1_DEVICE_ENDPOINT_ALL) || (entry->endpoint == endpointAndDirection))
+        {
+            entry->status = status;
+        }
+
+        position++;
+        count--;
+    }
+}
+#endif
+
+#if (DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE == true)
+// *****************************************************************************
+/* Function:
+    void F_DRV_USBFSV1_DEVICE_ISRStatisticsStart(DRV_USBFSV1_OBJ * hDriver)
+
+  Summary:
+    Records the cycle counter value at entry to the device mode ISR.
+
+  Remarks:
+    This is a local function and should not be called directly by the
+    application.
+*/
+
+void F_DRV_USBFSV1_DEVICE_ISRStatisticsStart(DRV_USBFSV1_OBJ * hDriver)
+{
+    hDriver->isrStartCycles = DWT->CYCCNT;
+}
+
+// *****************************************************************************
+/* Function:
+    void F_DRV_USBFSV1_DEVICE_ISRStatisticsStop(DRV_USBFSV1_OBJ * hDriver)
+
+  Summary:
+    Updates the ISR execution time statistics at exit from the device mode
+    ISR.
+
+  Remarks:
+    This is a local function and should not be called directly by the
+    application.
+*/
+
+void F_DRV_USBFSV1_DEVICE_ISRStatisticsStop(DRV_USBFSV1_OBJ * hDriver)
+{
+    DRV_USBFSV1_DEVICE_ISR_STATISTICS * stats = &hDriver->isrStatistics;
+    uint32_t cycles = DWT->CYCCNT - hDriver->isrStartCycles;
+
+    stats->isrCount++;
+    stats->lastCycles = cycles;
+    stats->totalCycles += cycles;
+
+    if(cycles < stats->minCycles)
+    {
+        stats->minCycles = cycles;
+    }
+
+    if(cycles > stats->maxCycles)
+    {
+        stats->maxCycles = cycles;
+    }
+}
+#endif
+
+#if (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+// *****************************************************************************
+/* Function:
+    void F_DRV_USBFSV1_DEVICE_TracePacket(DRV_USBFSV1_OBJ * hDriver, uint32_t bytes)
+
+  Summary:
+    Adds a packet handled by the ISR to the current frame.
+
+  Remarks:
+    This is a local function and should only be called from the ISR.
+*/
+
+void F_DRV_USBFSV1_DEVICE_TracePacket(DRV_USBFSV1_OBJ * hDriver, uint32_t bytes)
+{
+    hDriver->frameBytes += bytes;
+    hDriver->frameStatistics.packets++;
+    hDriver->frameStatistics.bytes += bytes;
+}
+
+// *****************************************************************************
+/* Function:
+    void F_DRV_USBFSV1_DEVICE_TraceFrame(DRV_USBFSV1_OBJ * hDriver)
+
+  Summary:
+    Ends the current frame at a SOF interrupt.
+
+  Remarks:
+    This is a local function and should only be called from the ISR.
+*/
+
+void F_DRV_USBFSV1_DEVICE_TraceFrame(DRV_USBFSV1_OBJ * hDriver)
+{
+    DRV_USBFSV1_DEVICE_FRAME_STATISTICS * stats = &hDriver->frameStatistics;
+    uint32_t bucket = hDriver->frameBytes / DRV_USBFSV1_DEVICE_FRAME_HISTOGRAM_WIDTH;
+
+    if(bucket >= DRV_USBFSV1_DEVICE_FRAME_HISTOGRAM_BUCKETS)
+    {
+        bucket = DRV_USBFSV1_DEVICE_FRAME_HISTOGRAM_BUCKETS - 1U;
+    }
+
+    stats->frames++;
+    stats->histogram[bucket]++;
+
+    if(hDriver->frameBytes != 0U)
+    {
+        stats->busyFrames++;
+    }
+
+    if(hDriver->frameBytes > stats->maxFrameBytes)
+    {
+        stats->maxFrameBytes = hDriver->frameBytes;
+    }
+
+    hDriver->frameBytes = 0;
+}
+
+// *****************************************************************************
+/* Function:
+    void F_DRV_USBFSV1_DEVICE_TraceIRP
+    (
+        DRV_USBFSV1_OBJ * hDriver,
+        DRV_USBFSV1_DEVICE_IRP_LOCAL * irp,
+        uint8_t endpoint
+    )
+
+  Summary:
+    Adds a completed IRP to the transfer trace.
+
+  Description:
+    The entry is dropped and counted in the frame statistics when the trace is
+    full.
+
+  Remarks:
+    This is a local function and should only be called from the ISR.
+*/
+
+void F_DRV_USBFSV1_DEVICE_TraceIRP
+(
+    DRV_USBFSV1_OBJ * hDriver,
+    DRV_USBFSV1_DEVICE_IRP_LOCAL * irp,
+    uint8_t endpoint
+)
+{
+    DRV_USBFSV1_DEVICE_TRACE_ENTRY * entry;
+    uint32_t position;
+
+    if(SYS_RING_FreeGet(&hDriver->traceRing, &position) == 0U)
+    {
+        hDriver->frameStatistics.traceOverflows++;
+    }
+    else
+    {
+        entry = &hDriver->traceEntry[SYS_RING_Index(&hDriver->traceRing, position)];
+        entry->cycles = DWT->CYCCNT;
+        entry->size = irp->size;
+        entry->frame = (uint16_t)((hDriver->usbID->DEVICE.USB_FNUM & USB_DEVICE_FNUM_FNUM_Msk) >> USB_DEVICE_FNUM_FNUM_Pos);
+        entry->endpoint = endpoint;
+        entry->status = (int8_t)irp->status;
+
+        SYS_RING_Commit(&hDriver->traceRing, 1U);
+    }
+}
+#endif
+
 // *****************************************************************************
 /* Function:
       void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
@@ -2227,7 +2613,7 @@ USB_ERROR DRV_USBFSV1_DEVICE_IRPCancel
     application.
 */
 
-void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
+void RAMFUNC F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
 {
     DRV_USBFSV1_DEVICE_ENDPOINT_OBJ * endpointObj;
     DRV_USBFSV1_DEVICE_IRP_LOCAL * irp;
@@ -2349,6 +2735,8 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
             
             usbID->DEVICE.USB_INTFLAG = USB_DEVICE_INTFLAG_SOF_Msk;
 
+            M_DRV_USBFSV1_DEVICE_TRACE_FRAME(hDriver);
+
             hDriver->pEventCallBack(hDriver->hClientArg, DRV_USBFSV1_EVENT_SOF_DETECT, NULL);
         }
 
@@ -2364,6 +2752,9 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
 
             /* Reset the Endpoint Descriptor Table Parameters */
             (void) memset(&hDriver->endpointDescriptorTable[0], 0, sizeof(usb_descriptor_device_registers_t) * DRV_USBFSV1_ENDPOINTS_NUMBER);
+
+            /* IRPs that completed before the reset are reported as aborted */
+            M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(hDriver, DRV_USBFSV1_DEVICE_ENDPOINT_ALL, USB_DEVICE_IRP_STATUS_ABORTED);
             
             if(hDriver->pEventCallBack != NULL)
             {
@@ -2394,6 +2785,8 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
             temp_32 = (uint32_t)(endpointObj + 1)->endpointState & ~((uint32_t)DRV_USBFSV1_DEVICE_ENDPOINT_STATE_STALLED);
             (endpointObj + 1)->endpointState = (DRV_USBFSV1_DEVICE_ENDPOINT_STATE)temp_32;
 
+            M_DRV_USBFSV1_DEVICE_TRACE_PACKET(hDriver, 8U);
+
             irp = endpointObj->irpQueue;
 
             if(irp != NULL)
@@ -2451,10 +2844,7 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
 
                 endpointObj->irpQueue = irp->next;
 
-                if(irp->callback != NULL)
-                {
-                    irp->callback((USB_DEVICE_IRP *)irp);
-                }
+                F_DRV_USBFSV1_DEVICE_IRPComplete(hDriver, irp, 0U);
             }
             else
             {
@@ -2482,6 +2872,9 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
             {
                 irp = endpointObj->irpQueue;
 
+                /* The packet that has been sent */
+                M_DRV_USBFSV1_DEVICE_TRACE_PACKET(hDriver, hDriver->endpointDescriptorTable[0].DEVICE_DESC_BANK[1].USB_PCKSIZE & USB_DEVICE_PCKSIZE_BYTE_COUNT_Msk);
+
                 if(hDriver->endpoint0State == DRV_USBFSV1_DEVICE_EP0_STATE_WAITING_FOR_TX_STATUS_COMPLETE)
                 {
                     hDriver->endpoint0State = DRV_USBFSV1_DEVICE_EP0_STATE_EXPECTING_SETUP_FROM_HOST;
@@ -2492,10 +2885,7 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
 
                     irp->size = 0;
 
-                    if(irp->callback != NULL)
-                    {
-                        irp->callback((USB_DEVICE_IRP *)irp);
-                    }
+                    F_DRV_USBFSV1_DEVICE_IRPComplete(hDriver, irp, DRV_USBFSV1_ENDPOINT_DIRECTION_MASK);
 
                     usbID->DEVICE.DEVICE_ENDPOINT[0].USB_EPINTFLAG = USB_DEVICE_EPINTFLAG_TRCPT1_Msk;
                 }
@@ -2528,10 +2918,7 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
 
                         endpointObj->irpQueue = irp->next;
 
-                        if(irp->callback != NULL)
-                        {
-                            irp->callback((USB_DEVICE_IRP *)irp);
-                        }
+                        F_DRV_USBFSV1_DEVICE_IRPComplete(hDriver, irp, DRV_USBFSV1_ENDPOINT_DIRECTION_MASK);
 
                         usbID->DEVICE.DEVICE_ENDPOINT[0].USB_EPINTFLAG = USB_DEVICE_EPINTFLAG_TRCPT1_Msk;
 
@@ -2580,6 +2967,8 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
                 {
                     irp = endpointObj->irpQueue;
 
+                    M_DRV_USBFSV1_DEVICE_TRACE_PACKET(hDriver, 0U);
+
                     irp->status = USB_DEVICE_IRP_STATUS_COMPLETED;
 
                     hDriver->endpoint0State = DRV_USBFSV1_DEVICE_EP0_STATE_EXPECTING_SETUP_FROM_HOST;
@@ -2592,10 +2981,7 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
 
                     irp->size = 0;
 
-                    if(irp->callback != NULL)
-                    {
-                        irp->callback((USB_DEVICE_IRP *)irp);
-                    }
+                    F_DRV_USBFSV1_DEVICE_IRPComplete(hDriver, irp, 0U);
                 }
                 else
                 {
@@ -2617,6 +3003,8 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
                     irp = endpointObj->irpQueue;
 
                     byteCount = (uint16_t)(hDriver->endpointDescriptorTable[0].DEVICE_DESC_BANK[0].USB_PCKSIZE & USB_DEVICE_PCKSIZE_BYTE_COUNT_Msk);
+
+                    M_DRV_USBFSV1_DEVICE_TRACE_PACKET(hDriver, byteCount);
                     
                     /* This is not acceptable as it may corrupt the ram location */
                     if((irp->nPendingBytes + byteCount) > irp->size)
@@ -2655,10 +3043,7 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
 
                         irp->size = irp->nPendingBytes;
 
-                        if(irp->callback != NULL)
-                        {
-                            irp->callback((USB_DEVICE_IRP *)irp);
-                        }
+                        F_DRV_USBFSV1_DEVICE_IRPComplete(hDriver, irp, 0U);
                     }
                 }
             }
@@ -2701,6 +3086,8 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
                 {
                     irp = endpointObj->irpQueue;
 
+                    M_DRV_USBFSV1_DEVICE_TRACE_PACKET(hDriver, hDriver->endpointDescriptorTable[epIndex].DEVICE_DESC_BANK[1].USB_PCKSIZE & USB_DEVICE_PCKSIZE_BYTE_COUNT_Msk);
+
                     if(irp->nPendingBytes == 0U)
                     {
                         if((irp->flags & USB_DEVICE_IRP_FLAG_SEND_ZLP) == USB_DEVICE_IRP_FLAG_SEND_ZLP)
@@ -2719,10 +3106,7 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
 
                             endpointObj->irpQueue = irp->next;
 
-                            if(irp->callback != NULL)
-                            {
-                                irp->callback((USB_DEVICE_IRP *)irp);
-                            }
+                            F_DRV_USBFSV1_DEVICE_IRPComplete(hDriver, irp, (uint8_t)(epIndex | DRV_USBFSV1_ENDPOINT_DIRECTION_MASK));
 
                             if(endpointObj->irpQueue == NULL)
                             {
@@ -2822,6 +3206,8 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
 
                     byteCount = (uint16_t)(hDriver->endpointDescriptorTable[epIndex].DEVICE_DESC_BANK[0].USB_PCKSIZE & USB_DEVICE_PCKSIZE_BYTE_COUNT_Msk);
 
+                    M_DRV_USBFSV1_DEVICE_TRACE_PACKET(hDriver, byteCount);
+
                     irp->nPendingBytes += byteCount;
 
                     if((irp->nPendingBytes < irp->size) && (byteCount >= endpointObj->maxPacketSize))
@@ -2852,10 +3238,7 @@ void F_DRV_USBFSV1_DEVICE_Tasks_ISR(DRV_USBFSV1_OBJ * hDriver)
 
                         irp->size = irp->nPendingBytes;
 
-                        if(irp->callback != NULL)
-                        {
-                            irp->callback((USB_DEVICE_IRP *)irp);
-                        }
+                        F_DRV_USBFSV1_DEVICE_IRPComplete(hDriver, irp, (uint8_t)epIndex);
                         
                         if(endpointObj->irpQueue != NULL)
                         {
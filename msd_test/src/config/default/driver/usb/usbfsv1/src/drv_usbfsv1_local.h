@@ -57,6 +57,7 @@
 #include "driver/usb/usbfsv1/drv_usbfsv1.h"
 #include "driver/usb/usbfsv1/src/drv_usbfsv1_variant_mapping.h"
 #include "osal/osal.h"
+#include "system/ring/sys_ring.h"
 
 /* MISRA C-2012 Rule 5.1, 5.2, 5.4 and 8.6 deviated below. Deviation record ID -  
     H3_USB_MISRAC_2012_R_5_2_DR_1, H3_USB_MISRAC_2012_R_5_4_DR_1 and H3_USB_MISRAC_2012_R_8_6_DR_1*/
@@ -180,6 +181,41 @@ typedef struct S_DRV_USBFSV1_DEVICE_IRP_LOCAL
 }
 DRV_USBFSV1_DEVICE_IRP_LOCAL;
 
+/***************************************************
+ * Entry in the deferred IRP completion queue. The
+ * final IRP status is held here until the IRP
+ * callback is invoked so that the client cannot
+ * re-submit the IRP before it has been notified.
+ ***************************************************/
+typedef struct
+{
+    /* The completed IRP */
+    DRV_USBFSV1_DEVICE_IRP_LOCAL * irp;
+
+    /* Status to be reported in the IRP callback */
+    USB_DEVICE_IRP_STATUS status;
+
+    /* Endpoint address. Bit 7 is set for an IN endpoint. */
+    uint8_t endpoint;
+
+}
+DRV_USBFSV1_DEVICE_IRP_COMPLETION;
+
+/***************************************************
+ * Single producer (ISR), single consumer (task)
+ * queue of completed IRPs.
+ ***************************************************/
+typedef struct
+{
+    /* Queue entries */
+    DRV_USBFSV1_DEVICE_IRP_COMPLETION entry[DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH];
+
+    /* Positions of the entries. The ISR produces and the task consumes. */
+    SYS_RING ring;
+
+}
+DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE;
+
 /************************************************
  * Endpoint state enumeration.
  ************************************************/
@@ -633,6 +669,32 @@ typedef struct S_DRV_USBFSV1_OBJ_STRUCT
     
     M_DRV_USBFSV1_FOR_HOST(bool, isResetting);
 
+#if (DRV_USBFSV1_DEVICE_SUPPORT == true) && (DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION == true)
+    /* IRPs completed in the ISR and waiting for their callback */
+    DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE irpCompletionQueue;
+#endif
+
+#if (DRV_USBFSV1_DEVICE_SUPPORT == true) && (DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE == true)
+    /* Cycle counter value at ISR entry */
+    uint32_t isrStartCycles;
+
+    /* Device mode ISR execution statistics */
+    DRV_USBFSV1_DEVICE_ISR_STATISTICS isrStatistics;
+#endif
+
+#if (DRV_USBFSV1_DEVICE_SUPPORT == true) && (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+    /* Data bytes moved since the last SOF */
+    uint32_t frameBytes;
+
+    /* Frame utilization statistics */
+    DRV_USBFSV1_DEVICE_FRAME_STATISTICS frameStatistics;
+
+    /* Completed IRPs not read yet. The ISR produces and
+     * DRV_USBFSV1_DEVICE_TraceRead consumes. */
+    DRV_USBFSV1_DEVICE_TRACE_ENTRY traceEntry[DRV_USBFSV1_DEVICE_TRACE_DEPTH];
+    SYS_RING traceRing;
+#endif
+
 } DRV_USBFSV1_OBJ;
 
 /****************************************
@@ -675,6 +737,25 @@ void F_DRV_USBFSV1_DEVICE_EndpointObjectEnable
   USB_TRANSFER_TYPE endpointType
 );
 
+void F_DRV_USBFSV1_DEVICE_IRPCompletionQueueDrain(DRV_USBFSV1_OBJ * hDriver);
+
+void F_DRV_USBFSV1_DEVICE_IRPCompletionQueueAbort
+(
+  DRV_USBFSV1_OBJ * hDriver,
+  USB_ENDPOINT endpointAndDirection,
+  USB_DEVICE_IRP_STATUS status
+);
+
+void F_DRV_USBFSV1_DEVICE_ISRStatisticsStart(DRV_USBFSV1_OBJ * hDriver);
+
+void F_DRV_USBFSV1_DEVICE_ISRStatisticsStop(DRV_USBFSV1_OBJ * hDriver);
+
+void F_DRV_USBFSV1_DEVICE_TracePacket(DRV_USBFSV1_OBJ * hDriver, uint32_t bytes);
+
+void F_DRV_USBFSV1_DEVICE_TraceFrame(DRV_USBFSV1_OBJ * hDriver);
+
+void F_DRV_USBFSV1_DEVICE_TraceIRP(DRV_USBFSV1_OBJ * hDriver, DRV_USBFSV1_DEVICE_IRP_LOCAL * irp, uint8_t endpoint);
+
 bool F_DRV_USBFSV1_HOST_ControlTransferProcess(DRV_USBFSV1_OBJ * hDriver);
 
 void F_DRV_USBFSV1_HOST_NonControlTransferDataSend(DRV_USBFSV1_OBJ * hDriver);
@@ -162,6 +162,34 @@ void DRV_USBFSV1_USB_Handler(void);
     #define M_DRV_USBFSV1_ISR_TRCPT0(x)          DRV_USBFSV1_Tasks_ISR(x)
     #define M_DRV_USBFSV1_ISR_TRCPT1(x)          DRV_USBFSV1_Tasks_ISR(x)
 
+#ifndef DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION
+    #define DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION  false
+#endif
+
+#ifndef DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH
+    #define DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH  16U
+#endif
+
+#if ((DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH & (DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH - 1U)) != 0U)
+    #error "DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH must be a power of 2"
+#endif
+
+#ifndef DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE
+    #define DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE  false
+#endif
+
+#ifndef DRV_USBFSV1_DEVICE_TRACE_ENABLE
+    #define DRV_USBFSV1_DEVICE_TRACE_ENABLE  false
+#endif
+
+#ifndef DRV_USBFSV1_DEVICE_TRACE_DEPTH
+    #define DRV_USBFSV1_DEVICE_TRACE_DEPTH  64U
+#endif
+
+#if ((DRV_USBFSV1_DEVICE_TRACE_DEPTH & (DRV_USBFSV1_DEVICE_TRACE_DEPTH - 1U)) != 0U)
+    #error "DRV_USBFSV1_DEVICE_TRACE_DEPTH must be a power of 2"
+#endif
+
 #if (DRV_USBFSV1_DEVICE_SUPPORT == true)
     #define M_DRV_USBFSV1_DEVICE_INIT(x, y)      F_DRV_USBFSV1_DEVICE_Initialize(x , y)
     #define M_DRV_USBFSV1_DEVICE_TASKS_ISR(x)    F_DRV_USBFSV1_DEVICE_Tasks_ISR(x)
@@ -172,6 +200,32 @@ void DRV_USBFSV1_USB_Handler(void);
     #define M_DRV_USBFSV1_DEVICE_TASKS_ISR(x) 
     #define M_DRV_USBFSV1_FOR_DEVICE(x, y)
 #endif
+
+#if (DRV_USBFSV1_DEVICE_SUPPORT == true) && (DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION == true)
+    #define M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_DRAIN(x)   F_DRV_USBFSV1_DEVICE_IRPCompletionQueueDrain(x)
+    #define M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(x, y, z)   F_DRV_USBFSV1_DEVICE_IRPCompletionQueueAbort(x, y, z)
+#else
+    #define M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_DRAIN(x)
+    #define M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_ABORT(x, y, z)
+#endif
+
+#if (DRV_USBFSV1_DEVICE_SUPPORT == true) && (DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE == true)
+    #define M_DRV_USBFSV1_DEVICE_ISR_STATISTICS_START(x)   F_DRV_USBFSV1_DEVICE_ISRStatisticsStart(x)
+    #define M_DRV_USBFSV1_DEVICE_ISR_STATISTICS_STOP(x)    F_DRV_USBFSV1_DEVICE_ISRStatisticsStop(x)
+#else
+    #define M_DRV_USBFSV1_DEVICE_ISR_STATISTICS_START(x)
+    #define M_DRV_USBFSV1_DEVICE_ISR_STATISTICS_STOP(x)
+#endif
+
+#if (DRV_USBFSV1_DEVICE_SUPPORT == true) && (DRV_USBFSV1_DEVICE_TRACE_ENABLE == true)
+    #define M_DRV_USBFSV1_DEVICE_TRACE_PACKET(x, y)        F_DRV_USBFSV1_DEVICE_TracePacket(x, y)
+    #define M_DRV_USBFSV1_DEVICE_TRACE_FRAME(x)            F_DRV_USBFSV1_DEVICE_TraceFrame(x)
+    #define M_DRV_USBFSV1_DEVICE_TRACE_IRP(x, y, z)        F_DRV_USBFSV1_DEVICE_TraceIRP(x, y, z)
+#else
+    #define M_DRV_USBFSV1_DEVICE_TRACE_PACKET(x, y)
+    #define M_DRV_USBFSV1_DEVICE_TRACE_FRAME(x)
+    #define M_DRV_USBFSV1_DEVICE_TRACE_IRP(x, y, z)
+#endif
  
 #if (DRV_USBFSV1_HOST_SUPPORT == true)
     #define M_DRV_USBFSV1_HOST_INIT(x, y, z)    F_DRV_USBFSV1_HOST_Initialize(x , y, z)
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ System Tasks File
+
+  File Name:
+    freertos_hooks.c
+
+  Summary:
+    This file contains source code necessary for FreeRTOS hooks
+
+  Description:
+    The idle hook puts the core to sleep between interrupts and accounts the
+    idle time of the scheduler service. The other hooks trap kernel failures.
+    The file is only built when OSAL_USE_RTOS is defined.
+
+  Remarks:
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "configuration.h"
+
+#if defined(OSAL_USE_RTOS)
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "system/int/sys_int.h"
+#include "system/sched/sys_sched.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RTOS "Hooks" Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void vApplicationIdleHook( void )
+
+  Remarks:
+    Runs when no task is ready. A task readied by an interrupt pends the
+    context switch, which ends the sleep even with the interrupts disabled.
+*/
+void vApplicationIdleHook( void )
+{
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+    SYS_SCHED_Idle();
+    SYS_INT_Restore(interruptState);
+}
+
+/*******************************************************************************
+  Function:
+    void vApplicationStackOverflowHook( TaskHandle_t pxTask, char *pcTaskName )
+
+  Remarks:
+    Called with configCHECK_FOR_STACK_OVERFLOW set to 2 when a task has
+    overwritten the end of its stack. pcTaskName names the task.
+*/
+void vApplicationStackOverflowHook( TaskHandle_t pxTask, char *pcTaskName )
+{
+    (void) pxTask;
+    (void) pcTaskName;
+
+    taskDISABLE_INTERRUPTS();
+    for( ;; ){}
+}
+
+/*******************************************************************************
+  Function:
+    void vApplicationMallocFailedHook( void )
+
+  Remarks:
+    Called when a task, semaphore or mutex could not be allocated from the
+    FreeRTOS heap (configTOTAL_HEAP_SIZE).
+*/
+void vApplicationMallocFailedHook( void )
+{
+    taskDISABLE_INTERRUPTS();
+    for( ;; ){}
+}
+
+#endif // OSAL_USE_RTOS
+
+/*******************************************************************************
+ End of File
+ */
@@ -58,8 +58,8 @@
 #pragma config BOD33_ACTION = RESET
 #pragma config BOD33_HYST = 0x2U
 #pragma config NVMCTRL_BOOTPROT = 0
-#pragma config NVMCTRL_SEESBLK = 0x0U
-#pragma config NVMCTRL_SEEPSZ = 0x0U
+#pragma config NVMCTRL_SEESBLK = 0x1U
+#pragma config NVMCTRL_SEEPSZ = 0x2U
 #pragma config RAMECC_ECCDIS = SET
 #pragma config WDT_ENABLE = CLEAR
 #pragma config WDT_ALWAYSON = CLEAR
@@ -89,6 +89,7 @@ static DRV_SDMMC_CLIENT_OBJ drvSDMMC0ClientObjPool[DRV_SDMMC_IDX0_CLIENTS_NUMBER
 
 /* SDMMC Transfer Objects Pool */
 static DRV_SDMMC_BUFFER_OBJ drvSDMMC0BufferObjPool[DRV_SDMMC_IDX0_QUEUE_SIZE];
+SYS_MEMORY_OBJECT_REGISTER(drvSDMMC0BufferObjPool);
 
 static const DRV_SDMMC_PLIB_API drvSDMMC0PlibAPI = {
     .sdhostCallbackRegister = (DRV_SDMMC_PLIB_CALLBACK_REGISTER)SDHC0_CallbackRegister,
@@ -130,6 +131,46 @@ static const DRV_SDMMC_INIT drvSDMMC0InitData =
 };
 // </editor-fold>
 
+// <editor-fold defaultstate="collapsed" desc="DRV_FLASH Instance 0 Initialization Data">
+
+/* RAM copy of the erase block being written */
+static uint8_t drvFlash0EraseBuffer[NVMCTRL_FLASH_BLOCKSIZE] __attribute__((aligned(4)));
+SYS_MEMORY_OBJECT_REGISTER(drvFlash0EraseBuffer);
+
+/*** Flash Driver Initialization Data ***/
+static const DRV_FLASH_INIT drvFlash0InitData =
+{
+    .startAddress                   = DRV_FLASH_MEDIA_START_ADDRESS,
+    .mediaSize                      = DRV_FLASH_MEDIA_SIZE,
+    .eraseBuffer                    = drvFlash0EraseBuffer,
+};
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DRV_RAMDISK Instance 0 Initialization Data">
+
+/* Content of the RAM disk */
+static uint8_t drvRamDisk0MediaBuffer[DRV_RAMDISK_MEDIA_SIZE] __attribute__((aligned(4)));
+SYS_MEMORY_OBJECT_REGISTER(drvRamDisk0MediaBuffer);
+
+/*** RAM Disk Driver Initialization Data ***/
+static const DRV_RAMDISK_INIT drvRamDisk0InitData =
+{
+    .mediaBuffer                    = drvRamDisk0MediaBuffer,
+    .mediaSize                      = DRV_RAMDISK_MEDIA_SIZE,
+    .latencyUS                      = DRV_RAMDISK_LATENCY_US,
+};
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DRV_UF2 Instance 0 Initialization Data">
+
+/*** UF2 Update Driver Initialization Data ***/
+static const DRV_UF2_INIT drvUf2_0InitData =
+{
+    .bankAddress                    = DRV_UF2_BANK_ADDRESS,
+    .imageSize                      = DRV_UF2_IMAGE_SIZE,
+};
+// </editor-fold>
+
 
 
 
@@ -200,9 +241,9 @@ static const SYS_TIME_PLIB_INTERFACE sysTimePlibAPI = {
     .timerStart = (SYS_TIME_PLIB_START)TC0_TimerStart,
     .timerStop = (SYS_TIME_PLIB_STOP)TC0_TimerStop,
     .timerFrequencyGet = (SYS_TIME_PLIB_FREQUENCY_GET)TC0_TimerFrequencyGet,
-    .timerPeriodSet = (SYS_TIME_PLIB_PERIOD_SET)TC0_Timer16bitPeriodSet,
-    .timerCompareSet = (SYS_TIME_PLIB_COMPARE_SET)TC0_Timer16bitCompareSet,
-    .timerCounterGet = (SYS_TIME_PLIB_COUNTER_GET)TC0_Timer16bitCounterGet,
+    .timerPeriodSet = (SYS_TIME_PLIB_PERIOD_SET)TC0_Timer32bitPeriodSet,
+    .timerCompareSet = (SYS_TIME_PLIB_COMPARE_SET)TC0_Timer32bitCompareSet,
+    .timerCounterGet = (SYS_TIME_PLIB_COUNTER_GET)TC0_Timer32bitCounterGet,
 };
 
 static const SYS_TIME_INIT sysTimeInitData =
@@ -239,6 +280,9 @@ void SYS_Initialize ( void* data )
     /* MISRAC 2012 deviation block start */
     /* MISRA C-2012 Rule 2.2 deviated in this file.  Deviation record ID -  H3_MISRAC_2012_R_2_2_DR_1 */
 
+    /* Paint the unused stack and the heap before anything else uses them */
+    SYS_MEMORY_Initialize();
+
     NVMCTRL_Initialize( );
 
   
@@ -246,15 +290,23 @@ void SYS_Initialize ( void* data )
 
     CLOCK_Initialize();
 
+    SYS_PROFILE_Initialize();
+
 
 
 
     EVSYS_Initialize();
 
+    DMAC_Initialize();
+
     TC0_TimerInitialize();
 
 	SDHC0_Initialize();
 
+    SYS_COPY_Initialize();
+
+    SYS_KVS_Initialize();
+
 
     /* MISRAC 2012 deviation block start */
     /* Following MISRA-C rules deviated in this block  */
@@ -263,6 +315,14 @@ void SYS_Initialize ( void* data )
 
    sysObj.drvSDMMC0 = DRV_SDMMC_Initialize(DRV_SDMMC_INDEX_0,(SYS_MODULE_INIT *)&drvSDMMC0InitData);
 
+   sysObj.drvFlash0 = DRV_FLASH_Initialize(DRV_FLASH_INDEX_0, (SYS_MODULE_INIT *)&drvFlash0InitData);
+
+   sysObj.drvRamDisk0 = DRV_RAMDISK_Initialize(DRV_RAMDISK_INDEX_0, (SYS_MODULE_INIT *)&drvRamDisk0InitData);
+
+   sysObj.drvUf2_0 = DRV_UF2_Initialize(DRV_UF2_INDEX_0, (SYS_MODULE_INIT *)&drvUf2_0InitData);
+
+    SYS_FAT_Initialize();
+
 
     /* MISRA C-2012 Rule 11.3, 11.8 deviated below. Deviation record ID -  
     H3_MISRAC_2012_R_11_3_DR_1 & H3_MISRAC_2012_R_11_8_DR_1*/
@@ -282,10 +342,14 @@ void SYS_Initialize ( void* data )
 
     /* MISRAC 2012 deviation block end */
     APP_Initialize();
+    CDC_Initialize();
+    BENCH_Initialize();
 
 
     NVIC_Initialize();
 
+    SYS_TasksInitialize();
+
 
     /* MISRAC 2012 deviation block end */
 }
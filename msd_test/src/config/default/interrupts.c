@@ -79,7 +79,7 @@ void __attribute__((optimize("-O1"), long_call, noreturn, used))Dummy_Handler(vo
 }
 
 /* MISRAC 2012 deviation block start */
-/* MISRA C-2012 Rule 8.6 deviated 117 times.  Deviation record ID -  H3_MISRAC_2012_R_8_6_DR_1 */
+/* MISRA C-2012 Rule 8.6 deviated 116 times.  Deviation record ID -  H3_MISRAC_2012_R_8_6_DR_1 */
 /* Device vectors list dummy definition*/
 extern void SVCall_Handler             ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void PendSV_Handler             ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
@@ -115,7 +115,6 @@ extern void EIC_EXTINT_15_Handler      ( void ) __attribute__((weak, alias("Dumm
 extern void FREQM_Handler              ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void NVMCTRL_0_Handler          ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void NVMCTRL_1_Handler          ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
-extern void DMAC_0_Handler             ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void DMAC_1_Handler             ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void DMAC_2_Handler             ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
 extern void DMAC_3_Handler             ( void ) __attribute__((weak, alias("Dummy_Handler"),noreturn));
@@ -202,6 +201,62 @@ extern void QSPI_Handler               ( void ) __attribute__((weak, alias("Dumm
 
 /* MISRAC 2012 deviation block end */
 
+/* The USB, TC0 and SDHC0 vectors sample the stack depth, run their handler
+   inside a profile probe and then post the scheduler event of the interrupt */
+static void USB_OTHER_VectorHandler(void)
+{
+    SYS_MEMORY_ISR_SAMPLE(USB);
+    SYS_PROFILE_ENTER(USB_ISR);
+    DRV_USBFSV1_OTHER_Handler();
+    SYS_PROFILE_EXIT(USB_ISR);
+    SYS_SCHED_EventPost(SYS_SCHED_EVENT_USB);
+}
+
+static void USB_SOF_HSOF_VectorHandler(void)
+{
+    SYS_MEMORY_ISR_SAMPLE(USB);
+    SYS_PROFILE_ENTER(USB_ISR);
+    DRV_USBFSV1_SOF_HSOF_Handler();
+    SYS_PROFILE_EXIT(USB_ISR);
+    SYS_SCHED_EventPost(SYS_SCHED_EVENT_USB);
+}
+
+static void USB_TRCPT0_VectorHandler(void)
+{
+    SYS_MEMORY_ISR_SAMPLE(USB);
+    SYS_PROFILE_ENTER(USB_ISR);
+    DRV_USBFSV1_TRCPT0_Handler();
+    SYS_PROFILE_EXIT(USB_ISR);
+    SYS_SCHED_EventPost(SYS_SCHED_EVENT_USB);
+}
+
+static void USB_TRCPT1_VectorHandler(void)
+{
+    SYS_MEMORY_ISR_SAMPLE(USB);
+    SYS_PROFILE_ENTER(USB_ISR);
+    DRV_USBFSV1_TRCPT1_Handler();
+    SYS_PROFILE_EXIT(USB_ISR);
+    SYS_SCHED_EventPost(SYS_SCHED_EVENT_USB);
+}
+
+static void TC0_VectorHandler(void)
+{
+    SYS_MEMORY_ISR_SAMPLE(TC0);
+    SYS_PROFILE_ENTER(TC0_ISR);
+    TC0_TimerInterruptHandler();
+    SYS_PROFILE_EXIT(TC0_ISR);
+    SYS_SCHED_EventPost(SYS_SCHED_EVENT_TIME);
+}
+
+static void SDHC0_VectorHandler(void)
+{
+    SYS_MEMORY_ISR_SAMPLE(SDHC0);
+    SYS_PROFILE_ENTER(SDHC0_ISR);
+    SDHC0_InterruptHandler();
+    SYS_PROFILE_EXIT(SDHC0_ISR);
+    SYS_SCHED_EventPost(SYS_SCHED_EVENT_SDHC);
+}
+
 /* Multiple handlers for vector */
 
 
@@ -253,7 +308,7 @@ const H3DeviceVectors exception_table=
     .pfnFREQM_Handler              = FREQM_Handler,
     .pfnNVMCTRL_0_Handler          = NVMCTRL_0_Handler,
     .pfnNVMCTRL_1_Handler          = NVMCTRL_1_Handler,
-    .pfnDMAC_0_Handler             = DMAC_0_Handler,
+    .pfnDMAC_0_Handler             = DMAC_0_InterruptHandler,
     .pfnDMAC_1_Handler             = DMAC_1_Handler,
     .pfnDMAC_2_Handler             = DMAC_2_Handler,
     .pfnDMAC_3_Handler             = DMAC_3_Handler,
@@ -289,10 +344,10 @@ const H3DeviceVectors exception_table=
     .pfnSERCOM5_1_Handler          = SERCOM5_1_Handler,
     .pfnSERCOM5_2_Handler          = SERCOM5_2_Handler,
     .pfnSERCOM5_OTHER_Handler      = SERCOM5_OTHER_Handler,
-    .pfnUSB_OTHER_Handler          = DRV_USBFSV1_OTHER_Handler,
-    .pfnUSB_SOF_HSOF_Handler       = DRV_USBFSV1_SOF_HSOF_Handler,
-    .pfnUSB_TRCPT0_Handler         = DRV_USBFSV1_TRCPT0_Handler,
-    .pfnUSB_TRCPT1_Handler         = DRV_USBFSV1_TRCPT1_Handler,
+    .pfnUSB_OTHER_Handler          = USB_OTHER_VectorHandler,
+    .pfnUSB_SOF_HSOF_Handler       = USB_SOF_HSOF_VectorHandler,
+    .pfnUSB_TRCPT0_Handler         = USB_TRCPT0_VectorHandler,
+    .pfnUSB_TRCPT1_Handler         = USB_TRCPT1_VectorHandler,
     .pfnTCC0_OTHER_Handler         = TCC0_OTHER_Handler,
     .pfnTCC0_MC0_Handler           = TCC0_MC0_Handler,
     .pfnTCC0_MC1_Handler           = TCC0_MC1_Handler,
@@ -315,7 +370,7 @@ const H3DeviceVectors exception_table=
     .pfnTCC4_OTHER_Handler         = TCC4_OTHER_Handler,
     .pfnTCC4_MC0_Handler           = TCC4_MC0_Handler,
     .pfnTCC4_MC1_Handler           = TCC4_MC1_Handler,
-    .pfnTC0_Handler                = TC0_TimerInterruptHandler,
+    .pfnTC0_Handler                = TC0_VectorHandler,
     .pfnTC1_Handler                = TC1_Handler,
     .pfnTC2_Handler                = TC2_Handler,
     .pfnTC3_Handler                = TC3_Handler,
@@ -341,7 +396,7 @@ const H3DeviceVectors exception_table=
     .pfnICM_Handler                = ICM_Handler,
     .pfnPUKCC_Handler              = PUKCC_Handler,
     .pfnQSPI_Handler               = QSPI_Handler,
-    .pfnSDHC0_Handler              = SDHC0_InterruptHandler,
+    .pfnSDHC0_Handler              = SDHC0_VectorHandler,
 
 
 
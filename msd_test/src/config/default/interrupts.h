@@ -69,6 +69,7 @@ void DRV_USBFSV1_TRCPT0_Handler (void);
 void DRV_USBFSV1_TRCPT1_Handler (void);
 void TC0_TimerInterruptHandler (void);
 void SDHC0_InterruptHandler (void);
+void DMAC_0_InterruptHandler (void);
 
 
 
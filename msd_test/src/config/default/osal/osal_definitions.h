@@ -24,5 +24,13 @@
 #ifndef OSAL_DEFINITIONS_H
 #define OSAL_DEFINITIONS_H
 
+#include "configuration.h"
+
+/* OSAL_USE_RTOS selects the FreeRTOS implementation, otherwise the basic
+   implementation is used */
+#if defined(OSAL_USE_RTOS)
+#include "osal/osal_freertos.h"
+#else
 #include "osal/osal_impl_basic.h"
+#endif
 #endif// OSAL_DEFINITIONS_H
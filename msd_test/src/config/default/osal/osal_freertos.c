@@ -0,0 +1,331 @@
+/*******************************************************************************
+  Operating System Abstraction Layer FreeRTOS Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    osal_freertos.c
+
+  Summary:
+    Source code for the OSAL FreeRTOS implementation.
+
+  Description:
+    This file contains the OSAL functions implemented over the FreeRTOS
+    kernel. Timeouts are given in milliseconds and converted to kernel ticks.
+    The file is only built when OSAL_USE_RTOS is defined.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "configuration.h"
+
+#if defined(OSAL_USE_RTOS)
+
+#include "osal/osal.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Converts an OSAL timeout in milliseconds to kernel ticks */
+static TickType_t OSAL_TicksGet(OSAL_TICK_TYPE waitMS)
+{
+    if (waitMS == OSAL_WAIT_FOREVER)
+    {
+        return portMAX_DELAY;
+    }
+
+    return (TickType_t)(waitMS / portTICK_PERIOD_MS);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines Group Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Critical Section group */
+// *****************************************************************************
+/* Function: OSAL_CRITSECT_DATA_TYPE OSAL_CRIT_Enter(OSAL_CRIT_TYPE severity)
+ */
+OSAL_CRITSECT_DATA_TYPE OSAL_CRIT_Enter(OSAL_CRIT_TYPE severity)
+{
+    if (severity == OSAL_CRIT_TYPE_LOW)
+    {
+        /* LOW priority critical sections only lock the scheduler */
+        vTaskSuspendAll();
+        return (0);
+    }
+
+    /* HIGH priority critical sections mask the interrupts that may call the
+       kernel. The mask form nests and is also valid in interrupt context. */
+    return portSET_INTERRUPT_MASK_FROM_ISR();
+}
+
+// *****************************************************************************
+/* Function: void OSAL_CRIT_Leave(OSAL_CRIT_TYPE severity, OSAL_CRITSECT_DATA_TYPE status)
+ */
+void OSAL_CRIT_Leave(OSAL_CRIT_TYPE severity, OSAL_CRITSECT_DATA_TYPE status)
+{
+    if (severity == OSAL_CRIT_TYPE_LOW)
+    {
+        (void) xTaskResumeAll();
+        return;
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(status);
+}
+
+// *****************************************************************************
+/* Function: OSAL_RESULT OSAL_SEM_Create(OSAL_SEM_HANDLE_TYPE* semID, OSAL_SEM_TYPE type,
+                                OSAL_SEM_COUNT_TYPE maxCount, OSAL_SEM_COUNT_TYPE initialCount)
+ */
+OSAL_RESULT OSAL_SEM_Create(OSAL_SEM_HANDLE_TYPE* semID, OSAL_SEM_TYPE type,
+                                OSAL_SEM_COUNT_TYPE maxCount, OSAL_SEM_COUNT_TYPE initialCount)
+{
+    if (semID == NULL)
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    if (type == OSAL_SEM_TYPE_COUNTING)
+    {
+        *semID = xSemaphoreCreateCounting(maxCount, initialCount);
+    }
+    else
+    {
+        *semID = xSemaphoreCreateBinary();
+        if ((*semID != NULL) && (initialCount != 0U))
+        {
+            (void) xSemaphoreGive(*semID);
+        }
+    }
+
+    return (*semID != NULL) ? OSAL_RESULT_SUCCESS : OSAL_RESULT_FAIL;
+}
+
+// *****************************************************************************
+/* Function: OSAL_RESULT OSAL_SEM_Delete(OSAL_SEM_HANDLE_TYPE* semID)
+ */
+OSAL_RESULT OSAL_SEM_Delete(OSAL_SEM_HANDLE_TYPE* semID)
+{
+    if ((semID == NULL) || (*semID == NULL))
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    vSemaphoreDelete(*semID);
+    *semID = NULL;
+
+    return OSAL_RESULT_SUCCESS;
+}
+
+// *****************************************************************************
+/* Function: OSAL_RESULT OSAL_SEM_Pend(OSAL_SEM_HANDLE_TYPE* semID, OSAL_TICK_TYPE waitMS)
+ */
+OSAL_RESULT OSAL_SEM_Pend(OSAL_SEM_HANDLE_TYPE* semID, OSAL_TICK_TYPE waitMS)
+{
+    if ((semID == NULL) || (*semID == NULL))
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    if (xSemaphoreTake(*semID, OSAL_TicksGet(waitMS)) == pdTRUE)
+    {
+        return OSAL_RESULT_SUCCESS;
+    }
+
+    return OSAL_RESULT_FAIL;
+}
+
+// *****************************************************************************
+/* Function: OSAL_RESULT OSAL_SEM_Post(OSAL_SEM_HANDLE_TYPE* semID)
+ */
+OSAL_RESULT OSAL_SEM_Post(OSAL_SEM_HANDLE_TYPE* semID)
+{
+    if ((semID == NULL) || (*semID == NULL))
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    if (xSemaphoreGive(*semID) == pdTRUE)
+    {
+        return OSAL_RESULT_SUCCESS;
+    }
+
+    return OSAL_RESULT_FAIL;
+}
+
+// *****************************************************************************
+/* Function: OSAL_RESULT OSAL_SEM_PostISR(OSAL_SEM_HANDLE_TYPE* semID)
+ */
+OSAL_RESULT OSAL_SEM_PostISR(OSAL_SEM_HANDLE_TYPE* semID)
+{
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    BaseType_t result;
+
+    if ((semID == NULL) || (*semID == NULL))
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    result = xSemaphoreGiveFromISR(*semID, &higherPriorityTaskWoken);
+
+    /* Switch to the woken task when the interrupt returns */
+    portEND_SWITCHING_ISR(higherPriorityTaskWoken);
+
+    return (result == pdTRUE) ? OSAL_RESULT_SUCCESS : OSAL_RESULT_FAIL;
+}
+
+// *****************************************************************************
+/* Function: OSAL_SEM_COUNT_TYPE OSAL_SEM_GetCount(OSAL_SEM_HANDLE_TYPE* semID)
+ */
+OSAL_SEM_COUNT_TYPE OSAL_SEM_GetCount(OSAL_SEM_HANDLE_TYPE* semID)
+{
+    if ((semID == NULL) || (*semID == NULL))
+    {
+        return 0;
+    }
+
+    return uxSemaphoreGetCount(*semID);
+}
+
+// *****************************************************************************
+/* Function: OSAL_RESULT OSAL_MUTEX_Create(OSAL_MUTEX_HANDLE_TYPE* mutexID)
+ */
+OSAL_RESULT OSAL_MUTEX_Create(OSAL_MUTEX_HANDLE_TYPE* mutexID)
+{
+    if (mutexID == NULL)
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    *mutexID = xSemaphoreCreateMutex();
+
+    return (*mutexID != NULL) ? OSAL_RESULT_SUCCESS : OSAL_RESULT_FAIL;
+}
+
+// *****************************************************************************
+/* Function: OSAL_RESULT OSAL_MUTEX_Delete(OSAL_MUTEX_HANDLE_TYPE* mutexID)
+ */
+OSAL_RESULT OSAL_MUTEX_Delete(OSAL_MUTEX_HANDLE_TYPE* mutexID)
+{
+    if ((mutexID == NULL) || (*mutexID == NULL))
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    vSemaphoreDelete(*mutexID);
+    *mutexID = NULL;
+
+    return OSAL_RESULT_SUCCESS;
+}
+
+// *****************************************************************************
+/* Function: OSAL_RESULT OSAL_MUTEX_Lock(OSAL_MUTEX_HANDLE_TYPE* mutexID, OSAL_TICK_TYPE waitMS)
+ */
+OSAL_RESULT OSAL_MUTEX_Lock(OSAL_MUTEX_HANDLE_TYPE* mutexID, OSAL_TICK_TYPE waitMS)
+{
+    if ((mutexID == NULL) || (*mutexID == NULL))
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    if (xSemaphoreTake(*mutexID, OSAL_TicksGet(waitMS)) == pdTRUE)
+    {
+        return OSAL_RESULT_SUCCESS;
+    }
+
+    return OSAL_RESULT_FAIL;
+}
+
+// *****************************************************************************
+/* Function: OSAL_RESULT OSAL_MUTEX_Unlock(OSAL_MUTEX_HANDLE_TYPE* mutexID)
+ */
+OSAL_RESULT OSAL_MUTEX_Unlock(OSAL_MUTEX_HANDLE_TYPE* mutexID)
+{
+    if ((mutexID == NULL) || (*mutexID == NULL))
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    if (xSemaphoreGive(*mutexID) == pdTRUE)
+    {
+        return OSAL_RESULT_SUCCESS;
+    }
+
+    return OSAL_RESULT_FAIL;
+}
+
+// *****************************************************************************
+/* Function: void* OSAL_Malloc(size_t size)
+ */
+void* OSAL_Malloc(size_t size)
+{
+    return pvPortMalloc(size);
+}
+
+// *****************************************************************************
+/* Function: void OSAL_Free(void* pData)
+ */
+void OSAL_Free(void* pData)
+{
+    vPortFree(pData);
+}
+
+// Initialization and Diagnostics
+// *****************************************************************************
+
+// *****************************************************************************
+/* Function: OSAL_RESULT OSAL_Initialize()
+ */
+OSAL_RESULT OSAL_Initialize(void)
+{
+    /* The kernel needs no initialization before the first object is created */
+    return OSAL_RESULT_SUCCESS;
+}
+
+// *****************************************************************************
+/* Function: const char* OSAL_Name()
+ */
+const char* OSAL_Name(void)
+{
+    return((const char*) "FreeRTOS");
+}
+
+#endif // OSAL_USE_RTOS
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,155 @@
+/*******************************************************************************
+  Operating System Abstraction Layer FreeRTOS Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    osal_freertos.h
+
+  Summary:
+    Header file for the OSAL FreeRTOS implementation.
+
+  Description:
+    This file defines the OSAL types over the FreeRTOS kernel objects. The
+    functions are implemented in osal_freertos.c. Semaphores and mutexes are
+    FreeRTOS semaphores, so a task that waits on them blocks instead of
+    polling, and mutexes inherit the priority of their waiters.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef OSAL_FREERTOS_H
+#define OSAL_FREERTOS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+
+typedef SemaphoreHandle_t               OSAL_SEM_HANDLE_TYPE;
+typedef SemaphoreHandle_t               OSAL_MUTEX_HANDLE_TYPE;
+typedef UBaseType_t                     OSAL_CRITSECT_DATA_TYPE;
+typedef TickType_t                      OSAL_TICK_TYPE;
+typedef UBaseType_t                     OSAL_SEM_COUNT_TYPE;
+
+#define OSAL_WAIT_FOREVER               (OSAL_TICK_TYPE)portMAX_DELAY
+#define OSAL_NO_WAIT                    (OSAL_TICK_TYPE)0
+
+#define OSAL_SEM_DECLARE(semID)         OSAL_SEM_HANDLE_TYPE        semID
+#define OSAL_MUTEX_DECLARE(mutexID)     OSAL_MUTEX_HANDLE_TYPE      mutexID
+
+// *****************************************************************************
+/* Macro: OSAL_ASSERT
+ */
+
+#define OSAL_ASSERT(test, message)      configASSERT(test)
+
+// *****************************************************************************
+/* OSAL Result type
+
+  Summary:
+    Enumerated type representing the general return value from OSAL functions.
+
+  Description:
+    This enum represents possible return types from OSAL functions.
+
+  Remarks:
+    These enum values are the possible return values from OSAL functions
+    where a standard success/fail type response is required. The majority
+    of OSAL functions will return this type with a few exceptions.
+*/
+
+typedef enum OSAL_SEM_TYPE
+{
+  OSAL_SEM_TYPE_BINARY,
+  OSAL_SEM_TYPE_COUNTING
+} OSAL_SEM_TYPE;
+
+typedef enum OSAL_CRIT_TYPE
+{
+  OSAL_CRIT_TYPE_LOW,
+  OSAL_CRIT_TYPE_HIGH
+} OSAL_CRIT_TYPE;
+
+typedef enum OSAL_RESULT
+{
+  OSAL_RESULT_NOT_IMPLEMENTED = -1,
+  OSAL_RESULT_FALSE = 0,
+  OSAL_RESULT_FAIL = 0,
+  OSAL_RESULT_TRUE = 1,
+  OSAL_RESULT_SUCCESS = 1,
+} OSAL_RESULT;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Section: Interface Routines Group Declarations
+// *****************************************************************************
+// *****************************************************************************
+OSAL_RESULT OSAL_SEM_Create(OSAL_SEM_HANDLE_TYPE* semID, OSAL_SEM_TYPE type, OSAL_SEM_COUNT_TYPE maxCount, OSAL_SEM_COUNT_TYPE initialCount);
+OSAL_RESULT OSAL_SEM_Delete(OSAL_SEM_HANDLE_TYPE* semID);
+OSAL_RESULT OSAL_SEM_Pend(OSAL_SEM_HANDLE_TYPE* semID, OSAL_TICK_TYPE waitMS);
+OSAL_RESULT OSAL_SEM_Post(OSAL_SEM_HANDLE_TYPE* semID);
+OSAL_RESULT OSAL_SEM_PostISR(OSAL_SEM_HANDLE_TYPE* semID);
+OSAL_SEM_COUNT_TYPE OSAL_SEM_GetCount(OSAL_SEM_HANDLE_TYPE* semID);
+
+OSAL_CRITSECT_DATA_TYPE OSAL_CRIT_Enter(OSAL_CRIT_TYPE severity);
+void OSAL_CRIT_Leave(OSAL_CRIT_TYPE severity, OSAL_CRITSECT_DATA_TYPE status);
+
+OSAL_RESULT OSAL_MUTEX_Create(OSAL_MUTEX_HANDLE_TYPE* mutexID);
+OSAL_RESULT OSAL_MUTEX_Delete(OSAL_MUTEX_HANDLE_TYPE* mutexID);
+OSAL_RESULT OSAL_MUTEX_Lock(OSAL_MUTEX_HANDLE_TYPE* mutexID, OSAL_TICK_TYPE waitMS);
+OSAL_RESULT OSAL_MUTEX_Unlock(OSAL_MUTEX_HANDLE_TYPE* mutexID);
+
+void* OSAL_Malloc(size_t size);
+void OSAL_Free(void* pData);
+
+OSAL_RESULT OSAL_Initialize(void);
+
+const char* OSAL_Name(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OSAL_FREERTOS_H
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,291 @@
+/*******************************************************************************
+  Direct Memory Access Controller (DMAC) PLIB
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    plib_dmac.c
+
+  Summary
+    Source for DMAC peripheral library interface Implementation.
+
+  Description
+    This file defines the interface to the DMAC peripheral library. This
+    library provides access to and control of the DMAC controller.
+
+  Remarks:
+    None.
+
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+/* This section lists the other files that are included in this file.
+*/
+
+#include <string.h>
+#include "interrupts.h"
+#include "plib_dmac.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* First descriptor and write-back descriptor of every channel. The DMAC
+   fetches the descriptor of channel n at DMAC_BASEADDR + 16 * n. */
+static dmac_descriptor_registers_t descriptor_section[DMAC_CHANNELS_NUMBER] __attribute__((aligned(16)));
+static dmac_descriptor_registers_t write_back_section[DMAC_CHANNELS_NUMBER] __attribute__((aligned(16)));
+
+static DMAC_CH_OBJECT dmacChannelObj[DMAC_CHANNELS_NUMBER];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: DMAC PLib Interface Implementations
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Initialize the DMAC controller and the configured channels */
+void DMAC_Initialize( void )
+{
+    uint32_t channel;
+
+    /* Disable and reset the DMAC module */
+    DMAC_REGS->DMAC_CTRL &= (uint16_t)(~DMAC_CTRL_DMAENABLE_Msk);
+    while((DMAC_REGS->DMAC_CTRL & DMAC_CTRL_DMAENABLE_Msk) != 0U)
+    {
+        /* Wait for the ongoing transfers to end */
+    }
+
+    DMAC_REGS->DMAC_CTRL = DMAC_CTRL_SWRST_Msk;
+    while((DMAC_REGS->DMAC_CTRL & DMAC_CTRL_SWRST_Msk) != 0U)
+    {
+        /* Wait for the reset to complete */
+    }
+
+    for(channel = 0U; channel < DMAC_CHANNELS_NUMBER; channel++)
+    {
+        dmacChannelObj[channel].callback = NULL;
+        dmacChannelObj[channel].context = 0U;
+        dmacChannelObj[channel].busyStatus = false;
+    }
+
+    /* Update the Base address and Write Back address registers */
+    DMAC_REGS->DMAC_BASEADDR = (uint32_t)descriptor_section;
+    DMAC_REGS->DMAC_WRBADDR = (uint32_t)write_back_section;
+
+    /* Round robin between the channels of priority level 0 */
+    DMAC_REGS->DMAC_PRICTRL0 = DMAC_PRICTRL0_RRLVLEN0_Msk;
+
+    /***************** Configure DMA channel 0 ********************/
+
+    /* Software trigger, one trigger for the whole transaction */
+    DMAC_REGS->CHANNEL[0].DMAC_CHCTRLA = DMAC_CHCTRLA_TRIGSRC_DISABLE | DMAC_CHCTRLA_TRIGACT_TRANSACTION |
+                                         DMAC_CHCTRLA_BURSTLEN_SINGLE | DMAC_CHCTRLA_THRESHOLD_1BEAT;
+
+    DMAC_REGS->CHANNEL[0].DMAC_CHPRILVL = DMAC_CHPRILVL_PRILVL_LVL0;
+
+    descriptor_section[0].DMAC_BTCTRL = (uint16_t)(DMAC_BTCTRL_BLOCKACT_INT | DMAC_BTCTRL_BEATSIZE_BYTE |
+                                         DMAC_BTCTRL_VALID_Msk | DMAC_BTCTRL_SRCINC_Msk | DMAC_BTCTRL_DSTINC_Msk);
+
+    DMAC_REGS->CHANNEL[0].DMAC_CHINTENSET = (uint8_t)(DMAC_CHINTENSET_TERR_Msk | DMAC_CHINTENSET_TCMPL_Msk);
+
+    /* Enable the DMAC module and priority level 0 */
+    DMAC_REGS->DMAC_CTRL = (uint16_t)(DMAC_CTRL_DMAENABLE_Msk | DMAC_CTRL_LVLEN0_Msk);
+}
+
+// *****************************************************************************
+/* Register the event handler of a channel */
+void DMAC_ChannelCallbackRegister( DMAC_CHANNEL channel, const DMAC_CHANNEL_CALLBACK eventHandler, const uintptr_t contextHandle )
+{
+    dmacChannelObj[channel].callback = eventHandler;
+
+    dmacChannelObj[channel].context = contextHandle;
+}
+
+// *****************************************************************************
+/* Start a single block transfer of blockSize bytes. The beat is the widest
+   access the addresses and the size are aligned to. */
+bool DMAC_ChannelTransfer( DMAC_CHANNEL channel, const void *srcAddr, const void *destAddr, size_t blockSize )
+{
+    uint32_t alignment = (uint32_t)(uintptr_t)srcAddr | (uint32_t)(uintptr_t)destAddr | (uint32_t)blockSize;
+    uint16_t btctrl;
+    uint32_t beatSize;
+
+    if ((dmacChannelObj[channel].busyStatus == true) || (blockSize == 0U))
+    {
+        return false;
+    }
+
+    if ((alignment & 0x3U) == 0U)
+    {
+        beatSize = 2U;
+    }
+    else if ((alignment & 0x1U) == 0U)
+    {
+        beatSize = 1U;
+    }
+    else
+    {
+        beatSize = 0U;
+    }
+
+    if ((blockSize >> beatSize) > DMAC_BLOCK_BEATS_MAX)
+    {
+        return false;
+    }
+
+    dmacChannelObj[channel].busyStatus = true;
+
+    btctrl = (uint16_t)(descriptor_section[channel].DMAC_BTCTRL & (uint16_t)(~DMAC_BTCTRL_BEATSIZE_Msk));
+    descriptor_section[channel].DMAC_BTCTRL = btctrl | DMAC_BTCTRL_BEATSIZE(beatSize);
+
+    /* With increment enabled the address registers hold the end of the block */
+    if ((btctrl & DMAC_BTCTRL_SRCINC_Msk) != 0U)
+    {
+        descriptor_section[channel].DMAC_SRCADDR = (uint32_t)(uintptr_t)srcAddr + (uint32_t)blockSize;
+    }
+    else
+    {
+        descriptor_section[channel].DMAC_SRCADDR = (uint32_t)(uintptr_t)srcAddr;
+    }
+
+    if ((btctrl & DMAC_BTCTRL_DSTINC_Msk) != 0U)
+    {
+        descriptor_section[channel].DMAC_DSTADDR = (uint32_t)(uintptr_t)destAddr + (uint32_t)blockSize;
+    }
+    else
+    {
+        descriptor_section[channel].DMAC_DSTADDR = (uint32_t)(uintptr_t)destAddr;
+    }
+
+    descriptor_section[channel].DMAC_BTCNT = (uint16_t)(blockSize >> beatSize);
+    descriptor_section[channel].DMAC_DESCADDR = 0U;
+
+    /* Enable the channel and trigger the transfer */
+    DMAC_REGS->CHANNEL[channel].DMAC_CHCTRLA |= DMAC_CHCTRLA_ENABLE_Msk;
+    DMAC_REGS->DMAC_SWTRIGCTRL |= (1UL << (uint32_t)channel);
+
+    return true;
+}
+
+// *****************************************************************************
+/* Start a linked list transfer. The first descriptor is copied to the
+   descriptor section of the channel. The others, linked through DMAC_DESCADDR,
+   are fetched from where they are and must stay valid until the end of the
+   transfer. Only the last descriptor may use DMAC_BTCTRL_BLOCKACT_INT. */
+bool DMAC_ChannelLinkedListTransfer( DMAC_CHANNEL channel, const dmac_descriptor_registers_t *channelDesc )
+{
+    if (dmacChannelObj[channel].busyStatus == true)
+    {
+        return false;
+    }
+
+    dmacChannelObj[channel].busyStatus = true;
+
+    (void) memcpy(&descriptor_section[channel], channelDesc, sizeof(dmac_descriptor_registers_t));
+
+    /* Enable the channel and trigger the transfer */
+    DMAC_REGS->CHANNEL[channel].DMAC_CHCTRLA |= DMAC_CHCTRLA_ENABLE_Msk;
+    DMAC_REGS->DMAC_SWTRIGCTRL |= (1UL << (uint32_t)channel);
+
+    return true;
+}
+
+// *****************************************************************************
+/* Abort the transfer of a channel */
+void DMAC_ChannelDisable( DMAC_CHANNEL channel )
+{
+    DMAC_REGS->CHANNEL[channel].DMAC_CHCTRLA &= ~DMAC_CHCTRLA_ENABLE_Msk;
+
+    while((DMAC_REGS->CHANNEL[channel].DMAC_CHCTRLA & DMAC_CHCTRLA_ENABLE_Msk) != 0U)
+    {
+        /* Wait for the current burst to end */
+    }
+
+    dmacChannelObj[channel].busyStatus = false;
+}
+
+// *****************************************************************************
+bool DMAC_ChannelIsBusy( DMAC_CHANNEL channel )
+{
+    return dmacChannelObj[channel].busyStatus;
+}
+
+// *****************************************************************************
+/* Returns the number of beats moved in the current block */
+uint16_t DMAC_ChannelGetTransferredCount( DMAC_CHANNEL channel )
+{
+    return (uint16_t)(descriptor_section[channel].DMAC_BTCNT - write_back_section[channel].DMAC_BTCNT);
+}
+
+// *****************************************************************************
+/* Interrupt of channel 0 */
+void __attribute__((used)) DMAC_0_InterruptHandler( void )
+{
+    DMAC_CH_OBJECT *dmacChObj = &dmacChannelObj[DMAC_CHANNEL_0];
+    DMAC_TRANSFER_EVENT event = DMAC_TRANSFER_EVENT_NONE;
+    uint8_t chanIntFlagStatus;
+
+    chanIntFlagStatus = DMAC_REGS->CHANNEL[DMAC_CHANNEL_0].DMAC_CHINTFLAG;
+
+    /* A bus error disables the channel */
+    if ((chanIntFlagStatus & DMAC_CHINTFLAG_TERR_Msk) != 0U)
+    {
+        DMAC_REGS->CHANNEL[DMAC_CHANNEL_0].DMAC_CHINTFLAG = DMAC_CHINTFLAG_TERR_Msk;
+
+        event = DMAC_TRANSFER_EVENT_ERROR;
+    }
+    else if ((chanIntFlagStatus & DMAC_CHINTFLAG_TCMPL_Msk) != 0U)
+    {
+        DMAC_REGS->CHANNEL[DMAC_CHANNEL_0].DMAC_CHINTFLAG = DMAC_CHINTFLAG_TCMPL_Msk;
+
+        /* Only the last block of a linked list requests the interrupt */
+        event = DMAC_TRANSFER_EVENT_COMPLETE;
+    }
+    else
+    {
+        /* Nothing to do */
+    }
+
+    if (event != DMAC_TRANSFER_EVENT_NONE)
+    {
+        dmacChObj->busyStatus = false;
+
+        if (dmacChObj->callback != NULL)
+        {
+            dmacChObj->callback(event, dmacChObj->context);
+        }
+    }
+}
@@ -0,0 +1,184 @@
+/*******************************************************************************
+  Direct Memory Access Controller (DMAC) PLIB
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    plib_dmac.h
+
+  Summary
+    DMAC PLIB Header File.
+
+  Description
+    This file defines the interface to the DMAC peripheral library. This
+    library provides access to and control of the DMAC controller.
+
+  Remarks:
+    Channel 0 is configured for software triggered memory to memory
+    transfers. A single software trigger moves the whole transaction, including
+    the blocks of a linked list.
+
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef PLIB_DMAC_H    // Guards against multiple inclusion
+#define PLIB_DMAC_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+/* This section lists the other files that are included in this file.
+*/
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "device.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus // Provide C Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* The following data type definitions are used by the functions in this
+    interface and should be considered part it.
+*/
+
+/* Number of channels configured */
+#define DMAC_CHANNELS_NUMBER        1U
+
+/* Largest number of beats of one block (DMAC_BTCNT) */
+#define DMAC_BLOCK_BEATS_MAX        0xFFFFU
+
+// *****************************************************************************
+/* DMAC Channels
+
+  Summary:
+    Identifies the configured DMAC channels.
+*/
+
+typedef enum
+{
+    /* DMAC Channel 0 */
+    DMAC_CHANNEL_0 = 0,
+
+} DMAC_CHANNEL;
+
+// *****************************************************************************
+/* DMAC Transfer Events
+
+  Summary:
+    Identifies the result of a transfer.
+*/
+
+typedef enum
+{
+    /* No event */
+    DMAC_TRANSFER_EVENT_NONE = 0,
+
+    /* All the blocks of the transfer have been moved */
+    DMAC_TRANSFER_EVENT_COMPLETE = 1,
+
+    /* A bus error stopped the transfer */
+    DMAC_TRANSFER_EVENT_ERROR = 2
+
+} DMAC_TRANSFER_EVENT;
+
+// *****************************************************************************
+/* DMAC Transfer Event Handler Function Pointer
+
+  Summary:
+    Pointer to the function called when a transfer of a channel ends.
+
+  Remarks:
+    The function is called from the DMAC interrupt.
+*/
+
+typedef void (*DMAC_CHANNEL_CALLBACK) (DMAC_TRANSFER_EVENT event, uintptr_t contextHandle);
+
+// *****************************************************************************
+/* DMAC Channel Object
+
+  Summary:
+    Run time state of a DMAC channel.
+
+  Remarks:
+    This structure is private to the DMAC PLIB.
+*/
+
+typedef struct
+{
+    DMAC_CHANNEL_CALLBACK   callback;
+
+    uintptr_t               context;
+
+    volatile bool           busyStatus;
+
+} DMAC_CH_OBJECT;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+/* The following functions make up the methods (set of possible operations) of
+   this interface.
+*/
+
+void DMAC_Initialize( void );
+
+void DMAC_ChannelCallbackRegister( DMAC_CHANNEL channel, const DMAC_CHANNEL_CALLBACK eventHandler, const uintptr_t contextHandle );
+
+bool DMAC_ChannelTransfer( DMAC_CHANNEL channel, const void *srcAddr, const void *destAddr, size_t blockSize );
+
+bool DMAC_ChannelLinkedListTransfer( DMAC_CHANNEL channel, const dmac_descriptor_registers_t *channelDesc );
+
+void DMAC_ChannelDisable( DMAC_CHANNEL channel );
+
+bool DMAC_ChannelIsBusy( DMAC_CHANNEL channel );
+
+uint16_t DMAC_ChannelGetTransferredCount( DMAC_CHANNEL channel );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    }
+
+#endif
+// DOM-IGNORE-END
+
+#endif /* PLIB_DMAC_H */
@@ -71,6 +71,8 @@ void NVIC_Initialize( void )
     NVIC_EnableIRQ(TC0_IRQn);
     NVIC_SetPriority(SDHC0_IRQn, 7);
     NVIC_EnableIRQ(SDHC0_IRQn);
+    NVIC_SetPriority(DMAC_0_IRQn, 7);
+    NVIC_EnableIRQ(DMAC_0_IRQn);
 
     /* Enable Usage fault */
     SCB->SHCSR |= (SCB_SHCSR_USGFAULTENA_Msk);
@@ -117,7 +117,7 @@ static void SDHC0_TransferModeSet ( uint32_t opcode, SDHC_DataTransferFlags tran
     SDHC0_REGS->SDHC_TMR = transferMode;
 }
 
-void __attribute__((used)) SDHC0_InterruptHandler(void)
+void __attribute__((used)) RAMFUNC SDHC0_InterruptHandler(void)
 {
     uint16_t nistr = 0U;
     uint16_t eistr = 0U;
@@ -65,6 +65,9 @@ extern void __attribute__((weak,long_call, alias("Dummy_App_Func"))) __xc32_on_b
 
 /* Linker defined variables */
 extern uint32_t __svectors;
+extern uint32_t __ramfunc_load;
+extern uint32_t __ramfunc_start;
+extern uint32_t __ramfunc_end;
 #if defined (__REINIT_STACK_POINTER)
 extern uint32_t _stack;
 #endif
@@ -86,6 +89,24 @@ __STATIC_INLINE void __attribute__((optimize("-O1"))) CMCC_Configure(void)
 }
 
 
+/* Copy the .ramfunc section from flash to SRAM */
+__STATIC_INLINE void __attribute__((optimize("-O1"))) RAMFUNC_Copy(void)
+{
+    uint32_t *pSrc = &__ramfunc_load;
+    uint32_t *pDest = &__ramfunc_start;
+
+    while (pDest < &__ramfunc_end)
+    {
+        *pDest = *pSrc;
+        pDest++;
+        pSrc++;
+    }
+
+    /* The copied code must be visible before it is fetched */
+    __DSB();
+    __ISB();
+}
+
 #if (__ARM_FP==14) || (__ARM_FP==4)
 
 /* Enable FPU */
@@ -148,6 +169,9 @@ void __attribute__((optimize("-O1"), section(".text.Reset_Handler"), long_call,
     /* Configure CMCC */
     CMCC_Configure();
 
+    /* Copy the functions that run from SRAM */
+    RAMFUNC_Copy();
+
     /* Initialize data after TCM is enabled.
      * Data initialization from the XC32 .dinit template */
     __pic32c_data_initialization();
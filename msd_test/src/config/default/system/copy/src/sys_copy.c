@@ -0,0 +1,307 @@
+/*******************************************************************************
+  Copy System Service Implementation.
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sys_copy.c
+
+  Summary:
+    Source code for the copy system service implementation.
+
+  Description:
+    This file contains the source code for the copy system service
+    implementation. The requests are kept in a queue in the order they were
+    made. The request at the front of the queue owns DMAC channel 0. Its
+    completion interrupt starts the next one before the client is called back.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "configuration.h"
+#include "system/copy/sys_copy.h"
+#include "system/int/sys_int.h"
+#include "system/memory/sys_memory.h"
+#include "peripheral/dmac/plib_dmac.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct
+{
+    /* Blocks of the request, linked through DMAC_DESCADDR */
+    dmac_descriptor_registers_t descriptors[SYS_COPY_BLOCKS_NUMBER];
+
+    /* Source of a fill, the value repeated in every byte */
+    uint32_t pattern;
+
+    SYS_COPY_CALLBACK callback;
+
+    uintptr_t context;
+
+} SYS_COPY_REQUEST;
+
+typedef struct
+{
+    SYS_COPY_REQUEST queue[SYS_COPY_QUEUE_SIZE];
+
+    /* Request in progress and number of queued requests, including it */
+    uint32_t first;
+    volatile uint32_t count;
+
+    /* Requests of fewer bytes are done by the CPU */
+    size_t threshold;
+
+} SYS_COPY_OBJ;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+static SYS_COPY_OBJ gSysCopyObj;
+SYS_MEMORY_OBJECT_REGISTER(gSysCopyObj);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Starts the request at the front of the queue. Called with the interrupts
+   disabled or from the DMAC interrupt. */
+static void SYS_COPY_Start ( void )
+{
+    if ((gSysCopyObj.count != 0U) && (DMAC_ChannelIsBusy(DMAC_CHANNEL_0) == false))
+    {
+        (void) DMAC_ChannelLinkedListTransfer(DMAC_CHANNEL_0,
+                &gSysCopyObj.queue[gSysCopyObj.first].descriptors[0]);
+    }
+}
+
+static void SYS_COPY_DMACEventHandler ( DMAC_TRANSFER_EVENT event, uintptr_t context )
+{
+    SYS_COPY_REQUEST * request = &gSysCopyObj.queue[gSysCopyObj.first];
+    SYS_COPY_CALLBACK callback = request->callback;
+    uintptr_t requestContext = request->context;
+
+    (void) context;
+
+    gSysCopyObj.first = (gSysCopyObj.first + 1U) % SYS_COPY_QUEUE_SIZE;
+    gSysCopyObj.count--;
+
+    /* Keep the DMAC busy while the client handles the completion */
+    SYS_COPY_Start();
+
+    if (callback != NULL)
+    {
+        callback((event == DMAC_TRANSFER_EVENT_COMPLETE) ? SYS_COPY_EVENT_COMPLETE : SYS_COPY_EVENT_ERROR,
+                requestContext);
+    }
+}
+
+/* Describes the request as a chain of blocks. Returns false if it needs more
+   than SYS_COPY_BLOCKS_NUMBER blocks. */
+static bool SYS_COPY_RequestBuild ( SYS_COPY_REQUEST * request, uint32_t dest, uint32_t src, bool fill, size_t size )
+{
+    uint32_t alignment = dest | (uint32_t)size | (fill ? 0U : src);
+    uint32_t beatSize;
+    uint32_t blockBytes;
+    uint32_t offset = 0U;
+    uint32_t bytes;
+    uint32_t block;
+    uint16_t btctrl;
+    dmac_descriptor_registers_t * descriptor;
+
+    /* Widest beat the addresses and the size are aligned to */
+    if ((alignment & 0x3U) == 0U)
+    {
+        beatSize = 2U;
+    }
+    else if ((alignment & 0x1U) == 0U)
+    {
+        beatSize = 1U;
+    }
+    else
+    {
+        beatSize = 0U;
+    }
+
+    blockBytes = DMAC_BLOCK_BEATS_MAX << beatSize;
+    if (((size + blockBytes - 1U) / blockBytes) > SYS_COPY_BLOCKS_NUMBER)
+    {
+        return false;
+    }
+
+    btctrl = (uint16_t)(DMAC_BTCTRL_VALID_Msk | DMAC_BTCTRL_BEATSIZE(beatSize) | DMAC_BTCTRL_DSTINC_Msk);
+    if (fill == false)
+    {
+        btctrl |= DMAC_BTCTRL_SRCINC_Msk;
+    }
+
+    for (block = 0U; offset < (uint32_t)size; block++)
+    {
+        descriptor = &request->descriptors[block];
+        bytes = (((uint32_t)size - offset) < blockBytes) ? ((uint32_t)size - offset) : blockBytes;
+        offset += bytes;
+
+        /* With increment enabled the address registers hold the end of the block */
+        descriptor->DMAC_BTCNT = (uint16_t)(bytes >> beatSize);
+        descriptor->DMAC_SRCADDR = fill ? (uint32_t)(uintptr_t)&request->pattern : (src + offset);
+        descriptor->DMAC_DSTADDR = dest + offset;
+
+        if (offset < (uint32_t)size)
+        {
+            descriptor->DMAC_BTCTRL = btctrl | DMAC_BTCTRL_BLOCKACT_NOACT;
+            descriptor->DMAC_DESCADDR = (uint32_t)(uintptr_t)&request->descriptors[block + 1U];
+        }
+        else
+        {
+            descriptor->DMAC_BTCTRL = btctrl | DMAC_BTCTRL_BLOCKACT_INT;
+            descriptor->DMAC_DESCADDR = 0U;
+        }
+    }
+
+    return true;
+}
+
+static bool SYS_COPY_Submit ( void * dest, const void * src, uint8_t value, size_t size,
+        SYS_COPY_CALLBACK callback, uintptr_t context )
+{
+    SYS_COPY_REQUEST * request;
+    bool interruptState;
+    bool result = false;
+    bool useCPU = false;
+
+    interruptState = SYS_INT_Disable();
+
+    if ((size == 0U) || ((gSysCopyObj.count == 0U) && (size < gSysCopyObj.threshold)))
+    {
+        /* Nothing is pending, so the request may complete at once */
+        useCPU = true;
+        result = true;
+    }
+    else if (gSysCopyObj.count < SYS_COPY_QUEUE_SIZE)
+    {
+        request = &gSysCopyObj.queue[(gSysCopyObj.first + gSysCopyObj.count) % SYS_COPY_QUEUE_SIZE];
+        request->pattern = (uint32_t)value * 0x01010101U;
+        request->callback = callback;
+        request->context = context;
+
+        if (SYS_COPY_RequestBuild(request, (uint32_t)(uintptr_t)dest, (uint32_t)(uintptr_t)src, (src == NULL), size))
+        {
+            gSysCopyObj.count++;
+            SYS_COPY_Start();
+            result = true;
+        }
+    }
+    else
+    {
+        /* The queue is full */
+    }
+
+    SYS_INT_Restore(interruptState);
+
+    if (useCPU)
+    {
+        if (src == NULL)
+        {
+            (void) memset(dest, (int)value, size);
+        }
+        else
+        {
+            (void) memcpy(dest, src, size);
+        }
+
+        if (callback != NULL)
+        {
+            callback(SYS_COPY_EVENT_COMPLETE, context);
+        }
+    }
+
+    return result;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_COPY_Initialize ( void )
+{
+    (void) memset(&gSysCopyObj, 0, sizeof(gSysCopyObj));
+
+    gSysCopyObj.threshold = SYS_COPY_DMA_THRESHOLD;
+
+    DMAC_ChannelCallbackRegister(DMAC_CHANNEL_0, SYS_COPY_DMACEventHandler, 0U);
+}
+
+bool SYS_COPY_Memcpy ( void * dest, const void * src, size_t size, SYS_COPY_CALLBACK callback, uintptr_t context )
+{
+    if ((dest == NULL) || (src == NULL))
+    {
+        return false;
+    }
+
+    return SYS_COPY_Submit(dest, src, 0U, size, callback, context);
+}
+
+bool SYS_COPY_Memset ( void * dest, uint8_t value, size_t size, SYS_COPY_CALLBACK callback, uintptr_t context )
+{
+    if (dest == NULL)
+    {
+        return false;
+    }
+
+    return SYS_COPY_Submit(dest, NULL, value, size, callback, context);
+}
+
+bool SYS_COPY_IsBusy ( void )
+{
+    return (gSysCopyObj.count != 0U);
+}
+
+size_t SYS_COPY_ThresholdSet ( size_t threshold )
+{
+    size_t previous = gSysCopyObj.threshold;
+
+    gSysCopyObj.threshold = threshold;
+
+    return previous;
+}
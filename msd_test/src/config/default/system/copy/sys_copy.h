@@ -0,0 +1,250 @@
+/*******************************************************************************
+  Copy System Service Library Interface Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sys_copy.h
+
+  Summary
+    Copy System Service Library interface.
+
+  Description
+    This file defines the interface to the Copy System Service Library. The
+    service copies or fills memory in the background with DMAC channel 0 and
+    calls the client back when the request is complete.
+
+    Every request is described by a chain of DMAC descriptors, so requests
+    larger than one DMAC block move without CPU intervention. Requests are
+    queued and run one after the other. Requests smaller than
+    SYS_COPY_DMA_THRESHOLD are done by the CPU in the calling context, where
+    programming the DMAC would cost more than the copy itself.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SYS_COPY_H    // Guards against multiple inclusion
+#define SYS_COPY_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Requests that may wait for the DMAC, including the one in progress */
+#ifndef SYS_COPY_QUEUE_SIZE
+    #define SYS_COPY_QUEUE_SIZE             (4U)
+#endif
+
+/* DMAC blocks of one request. A block moves up to 65535 beats. */
+#ifndef SYS_COPY_BLOCKS_NUMBER
+    #define SYS_COPY_BLOCKS_NUMBER          (4U)
+#endif
+
+/* Requests of fewer bytes are done by the CPU */
+#ifndef SYS_COPY_DMA_THRESHOLD
+    #define SYS_COPY_DMA_THRESHOLD          (64U)
+#endif
+
+// *****************************************************************************
+/* Copy events
+
+  Summary:
+    Identifies the result of a request.
+*/
+
+typedef enum
+{
+    /* The request is complete */
+    SYS_COPY_EVENT_COMPLETE,
+
+    /* A bus error stopped the request. The destination is partly written. */
+    SYS_COPY_EVENT_ERROR
+
+} SYS_COPY_EVENT;
+
+// *****************************************************************************
+/* Copy event handler
+
+  Summary:
+    Pointer to the function called when a request ends.
+
+  Description:
+    The handler of a request done by the DMAC is called from the DMAC
+    interrupt. The handler of a request done by the CPU is called before
+    SYS_COPY_Memcpy or SYS_COPY_Memset returns.
+*/
+
+typedef void (*SYS_COPY_CALLBACK) ( SYS_COPY_EVENT event, uintptr_t context );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    void SYS_COPY_Initialize ( void )
+
+  Summary:
+    Initializes the request queue and takes DMAC channel 0.
+
+  Precondition:
+    DMAC_Initialize must have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+*/
+
+void SYS_COPY_Initialize ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_COPY_Memcpy ( void * dest, const void * src, size_t size,
+                           SYS_COPY_CALLBACK callback, uintptr_t context )
+
+  Summary:
+    Copies size bytes from src to dest.
+
+  Description:
+    The request is queued for the DMAC, or done at once by the CPU when it is
+    smaller than the threshold and no DMAC request is pending. Requests always
+    complete in the order they were made.
+
+  Precondition:
+    SYS_COPY_Initialize must have been called.
+
+  Parameters:
+    dest     - Destination. Must not overlap src.
+    src      - Source.
+    size     - Number of bytes.
+    callback - Called when the request ends. May be NULL.
+    context  - Passed back to the callback.
+
+  Returns:
+    false if the queue is full or the request needs more than
+    SYS_COPY_BLOCKS_NUMBER blocks. Nothing has been copied then.
+
+  Remarks:
+    The buffers must stay valid until the callback. The DMAC moves words when
+    dest, src and size are multiples of 4, which is several times faster than
+    byte beats.
+*/
+
+bool SYS_COPY_Memcpy ( void * dest, const void * src, size_t size, SYS_COPY_CALLBACK callback, uintptr_t context );
+
+//******************************************************************************
+/* Function:
+    bool SYS_COPY_Memset ( void * dest, uint8_t value, size_t size,
+                           SYS_COPY_CALLBACK callback, uintptr_t context )
+
+  Summary:
+    Fills size bytes at dest with value.
+
+  Description:
+    Same as SYS_COPY_Memcpy with a fixed source.
+
+  Precondition:
+    SYS_COPY_Initialize must have been called.
+
+  Parameters:
+    dest     - Destination.
+    value    - Fill value.
+    size     - Number of bytes.
+    callback - Called when the request ends. May be NULL.
+    context  - Passed back to the callback.
+
+  Returns:
+    false if the queue is full or the request needs more than
+    SYS_COPY_BLOCKS_NUMBER blocks.
+*/
+
+bool SYS_COPY_Memset ( void * dest, uint8_t value, size_t size, SYS_COPY_CALLBACK callback, uintptr_t context );
+
+//******************************************************************************
+/* Function:
+    bool SYS_COPY_IsBusy ( void )
+
+  Summary:
+    Returns true while a DMAC request is queued or in progress.
+*/
+
+bool SYS_COPY_IsBusy ( void );
+
+//******************************************************************************
+/* Function:
+    size_t SYS_COPY_ThresholdSet ( size_t threshold )
+
+  Summary:
+    Changes the size under which requests are done by the CPU.
+
+  Parameters:
+    threshold - New threshold in bytes. 0 sends every request to the DMAC.
+
+  Returns:
+    The previous threshold.
+
+  Remarks:
+    Used to measure the CPU and DMAC copy times around the crossover size.
+*/
+
+size_t SYS_COPY_ThresholdSet ( size_t threshold );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    }
+#endif
+//DOM-IGNORE-END
+
+#endif // SYS_COPY_H
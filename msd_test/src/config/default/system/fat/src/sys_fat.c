@@ -0,0 +1,1335 @@
+/*******************************************************************************
+  FAT File System Service Implementation.
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sys_fat.c
+
+  Summary:
+    Source code for the FAT file system service implementation.
+
+  Description:
+    This file contains the source code for the FAT file system service
+    implementation. A request runs as a sequence of steps. SYS_FAT_Tasks runs
+    the steps of the request in progress until one queues a card request, and
+    goes on once the SDMMC driver has completed it.
+
+    The FAT is read and written through a window of SYS_FAT_CACHE_SECTORS
+    sectors. A changed window is written to every FAT copy before another
+    window is read, and at the end of the request that changed it.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "configuration.h"
+#include "system/fat/sys_fat.h"
+#include "system/int/sys_int.h"
+#include "system/memory/sys_memory.h"
+#include "system/sched/sys_sched.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* FAT32 entries of a FAT sector */
+#define SYS_FAT_ENTRIES_PER_SECTOR          (SYS_FAT_BLOCK_SIZE / 4U)
+
+/* Entries of a directory sector */
+#define SYS_FAT_DIR_ENTRIES_PER_SECTOR      (SYS_FAT_BLOCK_SIZE / 32U)
+
+/* Bits of a FAT32 entry that hold the cluster number */
+#define SYS_FAT_ENTRY_MASK                  (0x0FFFFFFFU)
+
+/* End of chain mark */
+#define SYS_FAT_ENTRY_EOC                   (0x0FFFFFFFU)
+
+/* Smallest cluster count of a FAT32 volume */
+#define SYS_FAT_FAT32_CLUSTERS_MIN          (65525U)
+
+/* Free count or cluster number not known */
+#define SYS_FAT_UNKNOWN                     (0xFFFFFFFFU)
+
+/* FS info sector signatures */
+#define SYS_FAT_FSINFO_LEAD_SIG             (0x41615252U)
+#define SYS_FAT_FSINFO_STRUCT_SIG           (0x61417272U)
+
+/* Directory entry fields */
+#define SYS_FAT_DIR_NAME_SIZE               (11U)
+#define SYS_FAT_DIR_ATTR                    (11U)
+#define SYS_FAT_DIR_CRT_DATE                (16U)
+#define SYS_FAT_DIR_ACC_DATE                (18U)
+#define SYS_FAT_DIR_CLUSTER_HI              (20U)
+#define SYS_FAT_DIR_WRT_DATE                (24U)
+#define SYS_FAT_DIR_CLUSTER_LO              (26U)
+#define SYS_FAT_DIR_SIZE                    (28U)
+
+#define SYS_FAT_DIR_FREE                    (0xE5U)
+#define SYS_FAT_DIR_END                     (0x00U)
+#define SYS_FAT_ATTR_VOLUME_ID              (0x08U)
+#define SYS_FAT_ATTR_ARCHIVE                (0x20U)
+
+/* Date of the files, 1 January 2019. The board has no calendar. */
+#define SYS_FAT_FILE_DATE                   ((uint16_t)(((2019U - 1980U) << 9) | (1U << 5) | 1U))
+
+typedef enum
+{
+    SYS_FAT_OPERATION_NONE = 0,
+    SYS_FAT_OPERATION_MOUNT,
+    SYS_FAT_OPERATION_UNMOUNT,
+    SYS_FAT_OPERATION_CREATE,
+    SYS_FAT_OPERATION_WRITE,
+    SYS_FAT_OPERATION_CLOSE,
+
+} SYS_FAT_OPERATION;
+
+typedef enum
+{
+    /* Waits for the MSD requests in flight, then reads block 0 */
+    SYS_FAT_STEP_MOUNT_START = 0,
+
+    /* Block 0 is the boot sector or the MBR */
+    SYS_FAT_STEP_MOUNT_BOOT,
+
+    /* Reads the BPB, then the FS info sector */
+    SYS_FAT_STEP_MOUNT_BPB,
+    SYS_FAT_STEP_MOUNT_FSINFO,
+
+    SYS_FAT_STEP_UNMOUNT_FLUSH,
+
+    /* Looks for the name and a free entry in the root directory */
+    SYS_FAT_STEP_CREATE_DIR_READ,
+    SYS_FAT_STEP_CREATE_DIR_SCAN,
+    SYS_FAT_STEP_CREATE_DIR_NEXT,
+
+    /* Looks for a run of free clusters and links it */
+    SYS_FAT_STEP_CREATE_ALLOCATE_START,
+    SYS_FAT_STEP_CREATE_ALLOCATE,
+    SYS_FAT_STEP_CREATE_CHAIN,
+    SYS_FAT_STEP_CREATE_FLUSH,
+
+    /* Fills the free entry once the chain is on the card */
+    SYS_FAT_STEP_CREATE_ENTRY_READ,
+    SYS_FAT_STEP_CREATE_ENTRY_WRITE,
+
+    SYS_FAT_STEP_WRITE,
+    SYS_FAT_STEP_WRITE_DONE,
+
+    /* Sets the size of the entry, then frees the clusters not written */
+    SYS_FAT_STEP_CLOSE_ENTRY_READ,
+    SYS_FAT_STEP_CLOSE_ENTRY_WRITE,
+    SYS_FAT_STEP_CLOSE_TRUNCATE,
+    SYS_FAT_STEP_CLOSE_FREE,
+    SYS_FAT_STEP_CLOSE_FLUSH,
+
+    /* Updates the free count and the next free cluster of the FS info
+       sector, the last steps of a file creation and close */
+    SYS_FAT_STEP_FSINFO_READ,
+    SYS_FAT_STEP_FSINFO_WRITE,
+
+    SYS_FAT_STEP_DONE,
+
+} SYS_FAT_STEP;
+
+typedef struct
+{
+    /* FAT sectors of the cache window. First, so that the buffers are
+       aligned for the SDHC DMA. */
+    uint32_t fatCache[SYS_FAT_CACHE_SECTORS * SYS_FAT_ENTRIES_PER_SECTOR];
+
+    /* Boot, directory and FS info sectors */
+    uint8_t sector[SYS_FAT_BLOCK_SIZE];
+
+    /* Client of the SDMMC driver and its request in flight */
+    DRV_HANDLE sdmmcHandle;
+    DRV_SDMMC_COMMAND_HANDLE commandHandle;
+    volatile bool commandCompleted;
+    volatile bool commandFailed;
+    bool requestPending;
+
+    /* The USB device is configured, and the host ejected the card */
+    volatile bool hostAttached;
+    volatile bool hostEjected;
+
+    /* The card belongs to the service, from SYS_FAT_Mount to the end of
+       SYS_FAT_Unmount */
+    volatile bool localOwned;
+
+    /* MSD requests queued to the SDMMC driver and not completed */
+    volatile uint32_t hostRequests;
+
+    /* Event handler of the MSD function */
+    SYS_MEDIA_EVENT_HANDLER hostEventHandler;
+    uintptr_t hostContext;
+
+    /* Request in progress */
+    SYS_FAT_OPERATION operation;
+    SYS_FAT_STEP step;
+    SYS_FAT_ERROR error;
+
+    SYS_FAT_EVENT_HANDLER eventHandler;
+    uintptr_t context;
+
+    /* Volume */
+    bool mounted;
+    uint32_t partitionStart;
+    uint32_t fatStart;
+    uint32_t fatSectors;
+    uint32_t fatCount;
+    /* Block of cluster 2 */
+    uint32_t dataStart;
+    /* log2 of the blocks of a cluster */
+    uint32_t clusterShift;
+    uint32_t lastCluster;
+    uint32_t rootCluster;
+    /* 0 without FS info sector */
+    uint32_t fsInfoBlock;
+    uint32_t freeCount;
+    uint32_t nextFree;
+
+    /* First FAT sector of the cache window, SYS_FAT_UNKNOWN if empty */
+    uint32_t cacheWindow;
+    uint32_t cacheSectors;
+    bool cacheDirty;
+    /* FAT copies the changed window was written to */
+    uint32_t cacheCopy;
+
+    /* Directory walk and cluster search of a file creation */
+    uint8_t name[SYS_FAT_DIR_NAME_SIZE];
+    uint32_t cluster;
+    uint32_t clusterBlock;
+    uint32_t searchStart;
+    uint32_t searchEnd;
+    bool searchWrapped;
+    uint32_t runStart;
+    uint32_t runLength;
+    bool entryFound;
+
+    /* File, open or being closed */
+    bool fileOpen;
+    uint32_t fileCluster;
+    uint32_t fileClusters;
+    uint32_t fileBlocks;
+    uint32_t fileEntryBlock;
+    uint32_t fileEntryIndex;
+
+    /* Data of the write in progress, and blocks of the request in flight */
+    const uint8_t * writeBuffer;
+    uint32_t writeBlocks;
+    uint32_t requestBlocks;
+
+} SYS_FAT_OBJ;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+static SYS_FAT_OBJ gSysFatObj CACHE_ALIGN;
+SYS_MEMORY_OBJECT_REGISTER(gSysFatObj);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint16_t SYS_FAT_Get16 ( const uint8_t * data )
+{
+    return (uint16_t)((uint32_t)data[0] | ((uint32_t)data[1] << 8));
+}
+
+static uint32_t SYS_FAT_Get32 ( const uint8_t * data )
+{
+    return ((uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+            ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+}
+
+static void SYS_FAT_Put16 ( uint8_t * data, uint32_t value )
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+static void SYS_FAT_Put32 ( uint8_t * data, uint32_t value )
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    data[3] = (uint8_t)(value >> 24);
+}
+
+/* Stores name as the 11 characters of a directory entry. Returns false if it
+   is not an 8.3 name. */
+static bool SYS_FAT_NameBuild ( const char * name, uint8_t * entryName )
+{
+    uint32_t length = 0U;
+    uint32_t limit = 8U;
+    uint32_t position = 0U;
+    uint8_t c;
+
+    (void) memset(entryName, (int)' ', SYS_FAT_DIR_NAME_SIZE);
+
+    for (; *name != '\0'; name++)
+    {
+        c = (uint8_t)*name;
+
+        if ((c == (uint8_t)'.') && (limit == 8U) && (length != 0U))
+        {
+            limit = 3U;
+            length = 0U;
+            position = 8U;
+            continue;
+        }
+
+        if ((c <= (uint8_t)' ') || (c >= 0x7FU) || (length == limit) ||
+            (strchr("\"*+,./:;<=>?[\\]|", (int)c) != NULL))
+        {
+            return false;
+        }
+
+        if ((c >= (uint8_t)'a') && (c <= (uint8_t)'z'))
+        {
+            c -= (uint8_t)('a' - 'A');
+        }
+
+        entryName[position] = c;
+        position++;
+        length++;
+    }
+
+    return (length != 0U);
+}
+
+/* First block of cluster */
+static uint32_t SYS_FAT_ClusterBlock ( uint32_t cluster )
+{
+    return gSysFatObj.dataStart + ((cluster - 2U) << gSysFatObj.clusterShift);
+}
+
+static void SYS_FAT_OperationEnd ( SYS_FAT_ERROR error )
+{
+    SYS_FAT_OPERATION operation = gSysFatObj.operation;
+
+    gSysFatObj.operation = SYS_FAT_OPERATION_NONE;
+    gSysFatObj.error = error;
+
+    if (error != SYS_FAT_ERROR_NONE)
+    {
+        /* The window may not be what the card holds */
+        gSysFatObj.cacheWindow = SYS_FAT_UNKNOWN;
+        gSysFatObj.cacheDirty = false;
+        gSysFatObj.cacheCopy = 0U;
+
+        if ((operation == SYS_FAT_OPERATION_MOUNT) || (operation == SYS_FAT_OPERATION_UNMOUNT))
+        {
+            gSysFatObj.mounted = false;
+            gSysFatObj.localOwned = false;
+        }
+    }
+    else if (operation == SYS_FAT_OPERATION_CREATE)
+    {
+        gSysFatObj.fileOpen = true;
+    }
+    else
+    {
+        /* Nothing else changes at the end */
+    }
+
+    if (gSysFatObj.eventHandler != NULL)
+    {
+        gSysFatObj.eventHandler((error == SYS_FAT_ERROR_NONE) ? SYS_FAT_EVENT_COMPLETE : SYS_FAT_EVENT_ERROR,
+                gSysFatObj.context);
+    }
+}
+
+/* Queues a card request. The steps go on once it has completed. */
+static void SYS_FAT_Request ( bool isWrite, void * buffer, uint32_t blockStart, uint32_t nBlocks )
+{
+    gSysFatObj.commandCompleted = false;
+    gSysFatObj.requestPending = true;
+
+    if (isWrite)
+    {
+        DRV_SDMMC_AsyncWrite(gSysFatObj.sdmmcHandle, &gSysFatObj.commandHandle, buffer, blockStart, nBlocks);
+    }
+    else
+    {
+        DRV_SDMMC_AsyncRead(gSysFatObj.sdmmcHandle, &gSysFatObj.commandHandle, buffer, blockStart, nBlocks);
+    }
+
+    if (gSysFatObj.commandHandle == DRV_SDMMC_COMMAND_HANDLE_INVALID)
+    {
+        gSysFatObj.requestPending = false;
+        SYS_FAT_OperationEnd(SYS_FAT_ERROR_IO);
+    }
+}
+
+/* Writes the changed window to the next FAT copy. Returns true once every
+   copy holds it. */
+static bool SYS_FAT_CacheFlush ( void )
+{
+    uint32_t copy;
+
+    if (gSysFatObj.cacheDirty == false)
+    {
+        return true;
+    }
+
+    if (gSysFatObj.cacheCopy < gSysFatObj.fatCount)
+    {
+        copy = gSysFatObj.cacheCopy;
+        gSysFatObj.cacheCopy++;
+        SYS_FAT_Request(true, gSysFatObj.fatCache,
+                gSysFatObj.fatStart + (copy * gSysFatObj.fatSectors) + gSysFatObj.cacheWindow,
+                gSysFatObj.cacheSectors);
+        return false;
+    }
+
+    gSysFatObj.cacheDirty = false;
+    gSysFatObj.cacheCopy = 0U;
+
+    return true;
+}
+
+/* Returns true if the window holds the entry of cluster. Otherwise queues
+   the next card request that loads it. */
+static bool SYS_FAT_CacheLoad ( uint32_t cluster )
+{
+    uint32_t window = ((cluster / SYS_FAT_ENTRIES_PER_SECTOR) / SYS_FAT_CACHE_SECTORS) * SYS_FAT_CACHE_SECTORS;
+
+    if (window == gSysFatObj.cacheWindow)
+    {
+        return true;
+    }
+
+    if (SYS_FAT_CacheFlush() == false)
+    {
+        return false;
+    }
+
+    gSysFatObj.cacheWindow = window;
+    gSysFatObj.cacheSectors = gSysFatObj.fatSectors - window;
+    if (gSysFatObj.cacheSectors > SYS_FAT_CACHE_SECTORS)
+    {
+        gSysFatObj.cacheSectors = SYS_FAT_CACHE_SECTORS;
+    }
+
+    SYS_FAT_Request(false, gSysFatObj.fatCache, gSysFatObj.fatStart + window, gSysFatObj.cacheSectors);
+
+    return false;
+}
+
+/* Entry of a cluster the window holds */
+static uint32_t SYS_FAT_EntryGet ( uint32_t cluster )
+{
+    return gSysFatObj.fatCache[cluster - (gSysFatObj.cacheWindow * SYS_FAT_ENTRIES_PER_SECTOR)] & SYS_FAT_ENTRY_MASK;
+}
+
+static void SYS_FAT_EntrySet ( uint32_t cluster, uint32_t value )
+{
+    uint32_t * entry = &gSysFatObj.fatCache[cluster - (gSysFatObj.cacheWindow * SYS_FAT_ENTRIES_PER_SECTOR)];
+
+    /* The top 4 bits are reserved and kept */
+    *entry = (*entry & ~SYS_FAT_ENTRY_MASK) | (value & SYS_FAT_ENTRY_MASK);
+    gSysFatObj.cacheDirty = true;
+}
+
+/* Hands the card back to the host */
+static void SYS_FAT_Release ( void )
+{
+    gSysFatObj.mounted = false;
+    gSysFatObj.hostEjected = false;
+    gSysFatObj.localOwned = false;
+}
+
+/* Reads the BPB in the sector buffer. Returns false if it is not a FAT32
+   boot sector. */
+static bool SYS_FAT_VolumeGet ( void )
+{
+    const uint8_t * bpb = gSysFatObj.sector;
+    uint32_t clusterBlocks = bpb[13];
+    uint32_t reserved = SYS_FAT_Get16(&bpb[14]);
+    uint32_t totalBlocks = SYS_FAT_Get16(&bpb[19]);
+    uint32_t fsInfo = SYS_FAT_Get16(&bpb[48]);
+    uint32_t fatArea;
+    uint32_t clusterCount;
+
+    gSysFatObj.fatCount = bpb[16];
+    gSysFatObj.fatSectors = SYS_FAT_Get32(&bpb[36]);
+    gSysFatObj.rootCluster = SYS_FAT_Get32(&bpb[44]);
+
+    if (totalBlocks == 0U)
+    {
+        totalBlocks = SYS_FAT_Get32(&bpb[32]);
+    }
+
+    /* FAT32 has no fixed root directory and no 16-bit FAT size */
+    if ((SYS_FAT_Get16(&bpb[510]) != 0xAA55U) || (SYS_FAT_Get16(&bpb[11]) != SYS_FAT_BLOCK_SIZE) ||
+        (clusterBlocks == 0U) || ((clusterBlocks & (clusterBlocks - 1U)) != 0U) ||
+        (reserved == 0U) || (gSysFatObj.fatCount == 0U) || (gSysFatObj.fatCount > 2U) ||
+        (SYS_FAT_Get16(&bpb[17]) != 0U) || (SYS_FAT_Get16(&bpb[22]) != 0U) || (gSysFatObj.fatSectors == 0U))
+    {
+        return false;
+    }
+
+    fatArea = reserved + (gSysFatObj.fatCount * gSysFatObj.fatSectors);
+    if (totalBlocks <= fatArea)
+    {
+        return false;
+    }
+
+    for (gSysFatObj.clusterShift = 0U; (1UL << gSysFatObj.clusterShift) != clusterBlocks; gSysFatObj.clusterShift++)
+    {
+    }
+
+    clusterCount = (totalBlocks - fatArea) >> gSysFatObj.clusterShift;
+    gSysFatObj.lastCluster = clusterCount + 1U;
+
+    if ((clusterCount < SYS_FAT_FAT32_CLUSTERS_MIN) ||
+        ((gSysFatObj.fatSectors * SYS_FAT_ENTRIES_PER_SECTOR) < (clusterCount + 2U)) ||
+        (gSysFatObj.rootCluster < 2U) || (gSysFatObj.rootCluster > gSysFatObj.lastCluster))
+    {
+        return false;
+    }
+
+    gSysFatObj.fatStart = gSysFatObj.partitionStart + reserved;
+    gSysFatObj.dataStart = gSysFatObj.partitionStart + fatArea;
+    gSysFatObj.fsInfoBlock = ((fsInfo == 0U) || (fsInfo == 0xFFFFU)) ? 0U : (gSysFatObj.partitionStart + fsInfo);
+    gSysFatObj.freeCount = SYS_FAT_UNKNOWN;
+    gSysFatObj.nextFree = 2U;
+
+    return true;
+}
+
+/* Runs the step of the request in progress. Returns false when the request
+   waits: for a card request, for the MSD requests or because it ended. */
+static bool SYS_FAT_Step ( void )
+{
+    uint8_t * entry;
+    uint32_t value;
+    uint32_t i;
+
+    switch (gSysFatObj.step)
+    {
+        case SYS_FAT_STEP_MOUNT_START:
+        {
+            if (gSysFatObj.hostRequests != 0U)
+            {
+                return false;
+            }
+
+            if (DRV_SDMMC_IsAttached(gSysFatObj.sdmmcHandle) == false)
+            {
+                SYS_FAT_OperationEnd(SYS_FAT_ERROR_IO);
+                return false;
+            }
+
+            gSysFatObj.partitionStart = 0U;
+            gSysFatObj.step = SYS_FAT_STEP_MOUNT_BOOT;
+            SYS_FAT_Request(false, gSysFatObj.sector, 0U, 1U);
+            break;
+        }
+
+        case SYS_FAT_STEP_MOUNT_BOOT:
+        {
+            entry = &gSysFatObj.sector[446];
+
+            if (SYS_FAT_Get16(&gSysFatObj.sector[510]) != 0xAA55U)
+            {
+                SYS_FAT_OperationEnd(SYS_FAT_ERROR_FORMAT);
+                return false;
+            }
+
+            if (((gSysFatObj.sector[0] == 0xEBU) || (gSysFatObj.sector[0] == 0xE9U)) && SYS_FAT_VolumeGet())
+            {
+                /* No partition table */
+                gSysFatObj.step = SYS_FAT_STEP_MOUNT_BPB;
+                return true;
+            }
+
+            if ((entry[4] != 0x0BU) && (entry[4] != 0x0CU))
+            {
+                SYS_FAT_OperationEnd(SYS_FAT_ERROR_FORMAT);
+                return false;
+            }
+
+            gSysFatObj.partitionStart = SYS_FAT_Get32(&entry[8]);
+            gSysFatObj.step = SYS_FAT_STEP_MOUNT_BPB;
+            SYS_FAT_Request(false, gSysFatObj.sector, gSysFatObj.partitionStart, 1U);
+            break;
+        }
+
+        case SYS_FAT_STEP_MOUNT_BPB:
+        {
+            if (SYS_FAT_VolumeGet() == false)
+            {
+                SYS_FAT_OperationEnd(SYS_FAT_ERROR_FORMAT);
+                return false;
+            }
+
+            gSysFatObj.step = SYS_FAT_STEP_MOUNT_FSINFO;
+            if (gSysFatObj.fsInfoBlock != 0U)
+            {
+                SYS_FAT_Request(false, gSysFatObj.sector, gSysFatObj.fsInfoBlock, 1U);
+            }
+            else
+            {
+                /* The next step finds no signature and keeps the defaults */
+                (void) memset(gSysFatObj.sector, 0, sizeof(gSysFatObj.sector));
+            }
+            break;
+        }
+
+        case SYS_FAT_STEP_MOUNT_FSINFO:
+        {
+            if ((SYS_FAT_Get32(&gSysFatObj.sector[0]) == SYS_FAT_FSINFO_LEAD_SIG) &&
+                (SYS_FAT_Get32(&gSysFatObj.sector[484]) == SYS_FAT_FSINFO_STRUCT_SIG))
+            {
+                value = SYS_FAT_Get32(&gSysFatObj.sector[488]);
+                if (value < gSysFatObj.lastCluster)
+                {
+                    gSysFatObj.freeCount = value;
+                }
+
+                value = SYS_FAT_Get32(&gSysFatObj.sector[492]);
+                if ((value >= 2U) && (value <= gSysFatObj.lastCluster))
+                {
+                    gSysFatObj.nextFree = value;
+                }
+            }
+
+            gSysFatObj.mounted = true;
+            SYS_FAT_OperationEnd(SYS_FAT_ERROR_NONE);
+            return false;
+        }
+
+        case SYS_FAT_STEP_UNMOUNT_FLUSH:
+        {
+            if (SYS_FAT_CacheFlush() == false)
+            {
+                break;
+            }
+
+            SYS_FAT_Release();
+            SYS_FAT_OperationEnd(SYS_FAT_ERROR_NONE);
+            return false;
+        }
+
+        case SYS_FAT_STEP_CREATE_DIR_READ:
+        {
+            gSysFatObj.step = SYS_FAT_STEP_CREATE_DIR_SCAN;
+            SYS_FAT_Request(false, gSysFatObj.sector,
+                    SYS_FAT_ClusterBlock(gSysFatObj.cluster) + gSysFatObj.clusterBlock, 1U);
+            break;
+        }
+
+        case SYS_FAT_STEP_CREATE_DIR_SCAN:
+        {
+            for (i = 0U; i < SYS_FAT_DIR_ENTRIES_PER_SECTOR; i++)
+            {
+                entry = &gSysFatObj.sector[i * 32U];
+
+                if (((entry[0] == SYS_FAT_DIR_FREE) || (entry[0] == SYS_FAT_DIR_END)) && (gSysFatObj.entryFound == false))
+                {
+                    gSysFatObj.entryFound = true;
+                    gSysFatObj.fileEntryBlock = SYS_FAT_ClusterBlock(gSysFatObj.cluster) + gSysFatObj.clusterBlock;
+                    gSysFatObj.fileEntryIndex = i;
+                }
+
+                if (entry[0] == SYS_FAT_DIR_END)
+                {
+                    /* No entry in use follows */
+                    gSysFatObj.step = SYS_FAT_STEP_CREATE_ALLOCATE_START;
+                    return true;
+                }
+
+                /* Long name entries have the volume ID bit set */
+                if ((entry[0] != SYS_FAT_DIR_FREE) && ((entry[SYS_FAT_DIR_ATTR] & SYS_FAT_ATTR_VOLUME_ID) == 0U) &&
+                    (memcmp(entry, gSysFatObj.name, SYS_FAT_DIR_NAME_SIZE) == 0))
+                {
+                    SYS_FAT_OperationEnd(SYS_FAT_ERROR_EXISTS);
+                    return false;
+                }
+            }
+
+            gSysFatObj.clusterBlock++;
+            gSysFatObj.step = (gSysFatObj.clusterBlock < (1UL << gSysFatObj.clusterShift)) ?
+                    SYS_FAT_STEP_CREATE_DIR_READ : SYS_FAT_STEP_CREATE_DIR_NEXT;
+            break;
+        }
+
+        case SYS_FAT_STEP_CREATE_DIR_NEXT:
+        {
+            if (SYS_FAT_CacheLoad(gSysFatObj.cluster) == false)
+            {
+                break;
+            }
+
+            value = SYS_FAT_EntryGet(gSysFatObj.cluster);
+            if ((value >= 2U) && (value <= gSysFatObj.lastCluster))
+            {
+                gSysFatObj.cluster = value;
+                gSysFatObj.clusterBlock = 0U;
+                gSysFatObj.step = SYS_FAT_STEP_CREATE_DIR_READ;
+            }
+            else if (gSysFatObj.entryFound)
+            {
+                gSysFatObj.step = SYS_FAT_STEP_CREATE_ALLOCATE_START;
+            }
+            else
+            {
+                SYS_FAT_OperationEnd(SYS_FAT_ERROR_DIRECTORY_FULL);
+                return false;
+            }
+            break;
+        }
+
+        case SYS_FAT_STEP_CREATE_ALLOCATE_START:
+        {
+            gSysFatObj.searchStart = gSysFatObj.nextFree;
+            gSysFatObj.searchEnd = gSysFatObj.lastCluster;
+            gSysFatObj.searchWrapped = false;
+            gSysFatObj.cluster = gSysFatObj.searchStart;
+            gSysFatObj.runLength = 0U;
+            gSysFatObj.step = SYS_FAT_STEP_CREATE_ALLOCATE;
+            break;
+        }
+
+        case SYS_FAT_STEP_CREATE_ALLOCATE:
+        {
+            while (gSysFatObj.cluster <= gSysFatObj.searchEnd)
+            {
+                if (SYS_FAT_CacheLoad(gSysFatObj.cluster) == false)
+                {
+                    return true;
+                }
+
+                if (SYS_FAT_EntryGet(gSysFatObj.cluster) != 0U)
+                {
+                    gSysFatObj.runLength = 0U;
+                }
+                else
+                {
+                    if (gSysFatObj.runLength == 0U)
+                    {
+                        gSysFatObj.runStart = gSysFatObj.cluster;
+                    }
+
+                    gSysFatObj.runLength++;
+                    if (gSysFatObj.runLength == gSysFatObj.fileClusters)
+                    {
+                        gSysFatObj.cluster = gSysFatObj.runStart;
+                        gSysFatObj.step = SYS_FAT_STEP_CREATE_CHAIN;
+                        return true;
+                    }
+                }
+
+                gSysFatObj.cluster++;
+            }
+
+            if (gSysFatObj.searchWrapped || (gSysFatObj.searchStart == 2U))
+            {
+                SYS_FAT_OperationEnd(SYS_FAT_ERROR_NO_SPACE);
+                return false;
+            }
+
+            /* Second pass over the runs that start before the next free
+               cluster */
+            gSysFatObj.searchWrapped = true;
+            gSysFatObj.searchEnd = gSysFatObj.searchStart + gSysFatObj.fileClusters - 2U;
+            if (gSysFatObj.searchEnd > gSysFatObj.lastCluster)
+            {
+                gSysFatObj.searchEnd = gSysFatObj.lastCluster;
+            }
+            gSysFatObj.cluster = 2U;
+            gSysFatObj.runLength = 0U;
+            break;
+        }
+
+        case SYS_FAT_STEP_CREATE_CHAIN:
+        {
+            value = gSysFatObj.runStart + gSysFatObj.fileClusters - 1U;
+
+            while (gSysFatObj.cluster <= value)
+            {
+                if (SYS_FAT_CacheLoad(gSysFatObj.cluster) == false)
+                {
+                    return true;
+                }
+
+                SYS_FAT_EntrySet(gSysFatObj.cluster, (gSysFatObj.cluster == value) ? SYS_FAT_ENTRY_EOC : (gSysFatObj.cluster + 1U));
+                gSysFatObj.cluster++;
+            }
+
+            gSysFatObj.fileCluster = gSysFatObj.runStart;
+            if (gSysFatObj.freeCount != SYS_FAT_UNKNOWN)
+            {
+                gSysFatObj.freeCount -= gSysFatObj.fileClusters;
+            }
+            gSysFatObj.nextFree = (value < gSysFatObj.lastCluster) ? (value + 1U) : 2U;
+            gSysFatObj.step = SYS_FAT_STEP_CREATE_FLUSH;
+            break;
+        }
+
+        case SYS_FAT_STEP_CREATE_FLUSH:
+        case SYS_FAT_STEP_CLOSE_FLUSH:
+        {
+            if (SYS_FAT_CacheFlush() == false)
+            {
+                break;
+            }
+
+            gSysFatObj.step = (gSysFatObj.step == SYS_FAT_STEP_CREATE_FLUSH) ?
+                    SYS_FAT_STEP_CREATE_ENTRY_READ : SYS_FAT_STEP_FSINFO_READ;
+            break;
+        }
+
+        case SYS_FAT_STEP_CREATE_ENTRY_READ:
+        case SYS_FAT_STEP_CLOSE_ENTRY_READ:
+        {
+            gSysFatObj.step = (gSysFatObj.step == SYS_FAT_STEP_CREATE_ENTRY_READ) ?
+                    SYS_FAT_STEP_CREATE_ENTRY_WRITE : SYS_FAT_STEP_CLOSE_ENTRY_WRITE;
+            SYS_FAT_Request(false, gSysFatObj.sector, gSysFatObj.fileEntryBlock, 1U);
+            break;
+        }
+
+        case SYS_FAT_STEP_CREATE_ENTRY_WRITE:
+        {
+            entry = &gSysFatObj.sector[gSysFatObj.fileEntryIndex * 32U];
+
+            (void) memset(entry, 0, 32U);
+            (void) memcpy(entry, gSysFatObj.name, SYS_FAT_DIR_NAME_SIZE);
+            entry[SYS_FAT_DIR_ATTR] = SYS_FAT_ATTR_ARCHIVE;
+            SYS_FAT_Put16(&entry[SYS_FAT_DIR_CRT_DATE], SYS_FAT_FILE_DATE);
+            SYS_FAT_Put16(&entry[SYS_FAT_DIR_ACC_DATE], SYS_FAT_FILE_DATE);
+            SYS_FAT_Put16(&entry[SYS_FAT_DIR_WRT_DATE], SYS_FAT_FILE_DATE);
+            SYS_FAT_Put16(&entry[SYS_FAT_DIR_CLUSTER_HI], gSysFatObj.fileCluster >> 16);
+            SYS_FAT_Put16(&entry[SYS_FAT_DIR_CLUSTER_LO], gSysFatObj.fileCluster);
+
+            gSysFatObj.fileBlocks = 0U;
+            gSysFatObj.step = SYS_FAT_STEP_FSINFO_READ;
+            SYS_FAT_Request(true, gSysFatObj.sector, gSysFatObj.fileEntryBlock, 1U);
+            break;
+        }
+
+        case SYS_FAT_STEP_WRITE:
+        {
+            if (gSysFatObj.writeBlocks == 0U)
+            {
+                SYS_FAT_OperationEnd(SYS_FAT_ERROR_NONE);
+                return false;
+            }
+
+            /* Up to the next multiple of SYS_FAT_WRITE_BLOCKS_MAX blocks */
+            gSysFatObj.requestBlocks = SYS_FAT_WRITE_BLOCKS_MAX - (gSysFatObj.fileBlocks % SYS_FAT_WRITE_BLOCKS_MAX);
+            if (gSysFatObj.requestBlocks > gSysFatObj.writeBlocks)
+            {
+                gSysFatObj.requestBlocks = gSysFatObj.writeBlocks;
+            }
+
+            gSysFatObj.step = SYS_FAT_STEP_WRITE_DONE;
+            SYS_FAT_Request(true, (void *)gSysFatObj.writeBuffer,
+                    SYS_FAT_ClusterBlock(gSysFatObj.fileCluster) + gSysFatObj.fileBlocks, gSysFatObj.requestBlocks);
+            break;
+        }
+
+        case SYS_FAT_STEP_WRITE_DONE:
+        {
+            gSysFatObj.fileBlocks += gSysFatObj.requestBlocks;
+            gSysFatObj.writeBlocks -= gSysFatObj.requestBlocks;
+            gSysFatObj.writeBuffer = &gSysFatObj.writeBuffer[gSysFatObj.requestBlocks * SYS_FAT_BLOCK_SIZE];
+            gSysFatObj.step = SYS_FAT_STEP_WRITE;
+            break;
+        }
+
+        case SYS_FAT_STEP_CLOSE_ENTRY_WRITE:
+        {
+            entry = &gSysFatObj.sector[gSysFatObj.fileEntryIndex * 32U];
+
+            SYS_FAT_Put32(&entry[SYS_FAT_DIR_SIZE], gSysFatObj.fileBlocks * SYS_FAT_BLOCK_SIZE);
+            if (gSysFatObj.fileBlocks == 0U)
+            {
+                /* An empty file has no cluster */
+                SYS_FAT_Put16(&entry[SYS_FAT_DIR_CLUSTER_HI], 0U);
+                SYS_FAT_Put16(&entry[SYS_FAT_DIR_CLUSTER_LO], 0U);
+            }
+
+            /* Clusters of the file that hold data */
+            value = (gSysFatObj.fileBlocks + (1UL << gSysFatObj.clusterShift) - 1U) >> gSysFatObj.clusterShift;
+            gSysFatObj.cluster = gSysFatObj.fileCluster + value;
+
+            /* The next file starts where this one ends */
+            if (value < gSysFatObj.fileClusters)
+            {
+                gSysFatObj.nextFree = gSysFatObj.cluster;
+                if (gSysFatObj.freeCount != SYS_FAT_UNKNOWN)
+                {
+                    gSysFatObj.freeCount += gSysFatObj.fileClusters - value;
+                }
+            }
+
+            gSysFatObj.step = (value == gSysFatObj.fileClusters) ? SYS_FAT_STEP_CLOSE_FLUSH :
+                    ((value == 0U) ? SYS_FAT_STEP_CLOSE_FREE : SYS_FAT_STEP_CLOSE_TRUNCATE);
+            SYS_FAT_Request(true, gSysFatObj.sector, gSysFatObj.fileEntryBlock, 1U);
+            break;
+        }
+
+        case SYS_FAT_STEP_CLOSE_TRUNCATE:
+        {
+            if (SYS_FAT_CacheLoad(gSysFatObj.cluster - 1U) == false)
+            {
+                break;
+            }
+
+            SYS_FAT_EntrySet(gSysFatObj.cluster - 1U, SYS_FAT_ENTRY_EOC);
+            gSysFatObj.step = SYS_FAT_STEP_CLOSE_FREE;
+            break;
+        }
+
+        case SYS_FAT_STEP_CLOSE_FREE:
+        {
+            value = gSysFatObj.fileCluster + gSysFatObj.fileClusters;
+
+            while (gSysFatObj.cluster < value)
+            {
+                if (SYS_FAT_CacheLoad(gSysFatObj.cluster) == false)
+                {
+                    return true;
+                }
+
+                SYS_FAT_EntrySet(gSysFatObj.cluster, 0U);
+                gSysFatObj.cluster++;
+            }
+
+            gSysFatObj.step = SYS_FAT_STEP_CLOSE_FLUSH;
+            break;
+        }
+
+        case SYS_FAT_STEP_FSINFO_READ:
+        {
+            if (gSysFatObj.fsInfoBlock == 0U)
+            {
+                SYS_FAT_OperationEnd(SYS_FAT_ERROR_NONE);
+                return false;
+            }
+
+            gSysFatObj.step = SYS_FAT_STEP_FSINFO_WRITE;
+            SYS_FAT_Request(false, gSysFatObj.sector, gSysFatObj.fsInfoBlock, 1U);
+            break;
+        }
+
+        case SYS_FAT_STEP_FSINFO_WRITE:
+        {
+            if ((SYS_FAT_Get32(&gSysFatObj.sector[0]) != SYS_FAT_FSINFO_LEAD_SIG) ||
+                (SYS_FAT_Get32(&gSysFatObj.sector[484]) != SYS_FAT_FSINFO_STRUCT_SIG))
+            {
+                SYS_FAT_OperationEnd(SYS_FAT_ERROR_NONE);
+                return false;
+            }
+
+            SYS_FAT_Put32(&gSysFatObj.sector[488], gSysFatObj.freeCount);
+            SYS_FAT_Put32(&gSysFatObj.sector[492], gSysFatObj.nextFree);
+            gSysFatObj.step = SYS_FAT_STEP_DONE;
+            SYS_FAT_Request(true, gSysFatObj.sector, gSysFatObj.fsInfoBlock, 1U);
+            break;
+        }
+
+        case SYS_FAT_STEP_DONE:
+        default:
+        {
+            SYS_FAT_OperationEnd(SYS_FAT_ERROR_NONE);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Starts a request. Called with the request checked. */
+static void SYS_FAT_OperationStart ( SYS_FAT_OPERATION operation, SYS_FAT_STEP step )
+{
+    gSysFatObj.error = SYS_FAT_ERROR_NONE;
+    gSysFatObj.step = step;
+    gSysFatObj.operation = operation;
+
+    SYS_SCHED_EventPost(SYS_SCHED_EVENT_FAT);
+}
+
+/* Called by DRV_SDMMC_Tasks when the request of the service completes */
+static void SYS_FAT_SDMMCEventHandler ( SYS_MEDIA_BLOCK_EVENT event, SYS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle, uintptr_t context )
+{
+    (void) commandHandle;
+    (void) context;
+
+    gSysFatObj.commandFailed = (event != (SYS_MEDIA_BLOCK_EVENT)DRV_SDMMC_EVENT_COMMAND_COMPLETE);
+    gSysFatObj.commandCompleted = true;
+}
+
+/* Called by DRV_SDMMC_Tasks when a request of the MSD function completes */
+static void SYS_FAT_HostEventHandler ( SYS_MEDIA_BLOCK_EVENT event, SYS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle, uintptr_t context )
+{
+    bool interruptState;
+
+    (void) context;
+
+    if (gSysFatObj.hostEventHandler != NULL)
+    {
+        gSysFatObj.hostEventHandler(event, commandHandle, gSysFatObj.hostContext);
+    }
+
+    /* Once the MSD function has seen the completion */
+    interruptState = SYS_INT_Disable();
+    gSysFatObj.hostRequests--;
+    SYS_INT_Restore(interruptState);
+}
+
+/* Counts a request of the MSD function. Returns false while the service
+   owns the card. */
+static bool SYS_FAT_HostRequestStart ( void )
+{
+    bool interruptState;
+    bool result = false;
+
+    interruptState = SYS_INT_Disable();
+
+    if (gSysFatObj.localOwned == false)
+    {
+        gSysFatObj.hostRequests++;
+        result = true;
+    }
+
+    SYS_INT_Restore(interruptState);
+
+    return result;
+}
+
+static void SYS_FAT_HostRequestCancel ( void )
+{
+    bool interruptState = SYS_INT_Disable();
+
+    gSysFatObj.hostRequests--;
+
+    SYS_INT_Restore(interruptState);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_FAT_Initialize ( void )
+{
+    (void) memset(&gSysFatObj, 0, sizeof(gSysFatObj));
+
+    gSysFatObj.sdmmcHandle = DRV_HANDLE_INVALID;
+    gSysFatObj.commandHandle = DRV_SDMMC_COMMAND_HANDLE_INVALID;
+    gSysFatObj.cacheWindow = SYS_FAT_UNKNOWN;
+}
+
+void SYS_FAT_Tasks ( void )
+{
+    if (gSysFatObj.sdmmcHandle == DRV_HANDLE_INVALID)
+    {
+        gSysFatObj.sdmmcHandle = DRV_SDMMC_Open(DRV_SDMMC_INDEX_0, DRV_IO_INTENT_READWRITE);
+        if (gSysFatObj.sdmmcHandle == DRV_HANDLE_INVALID)
+        {
+            return;
+        }
+
+        DRV_SDMMC_EventHandlerSet(gSysFatObj.sdmmcHandle, (const void*)SYS_FAT_SDMMCEventHandler, 0U);
+    }
+
+    if (gSysFatObj.requestPending)
+    {
+        if (gSysFatObj.commandCompleted == false)
+        {
+            return;
+        }
+
+        gSysFatObj.requestPending = false;
+        if (gSysFatObj.commandFailed)
+        {
+            SYS_FAT_OperationEnd(SYS_FAT_ERROR_IO);
+        }
+    }
+
+    if (gSysFatObj.mounted && (DRV_SDMMC_IsAttached(gSysFatObj.sdmmcHandle) == false))
+    {
+        /* The card was removed. The host gets the next one. */
+        gSysFatObj.fileOpen = false;
+        SYS_FAT_Release();
+
+        if (gSysFatObj.operation != SYS_FAT_OPERATION_NONE)
+        {
+            SYS_FAT_OperationEnd(SYS_FAT_ERROR_IO);
+        }
+    }
+
+    while ((gSysFatObj.operation != SYS_FAT_OPERATION_NONE) && (gSysFatObj.requestPending == false))
+    {
+        if (SYS_FAT_Step() == false)
+        {
+            break;
+        }
+    }
+}
+
+bool SYS_FAT_IsBusy ( void )
+{
+    return ((gSysFatObj.sdmmcHandle == DRV_HANDLE_INVALID) ||
+            ((gSysFatObj.operation != SYS_FAT_OPERATION_NONE) && (gSysFatObj.requestPending == false)));
+}
+
+void SYS_FAT_EventHandlerSet ( SYS_FAT_EVENT_HANDLER handler, uintptr_t context )
+{
+    gSysFatObj.eventHandler = handler;
+    gSysFatObj.context = context;
+}
+
+SYS_FAT_ERROR SYS_FAT_ErrorGet ( void )
+{
+    return gSysFatObj.error;
+}
+
+bool SYS_FAT_Mount ( void )
+{
+    bool interruptState;
+    bool result = false;
+
+    if ((gSysFatObj.operation != SYS_FAT_OPERATION_NONE) || gSysFatObj.mounted ||
+        (gSysFatObj.sdmmcHandle == DRV_HANDLE_INVALID))
+    {
+        return false;
+    }
+
+    /* No MSD request may start once the card is taken */
+    interruptState = SYS_INT_Disable();
+
+    if ((gSysFatObj.hostAttached == false) || gSysFatObj.hostEjected)
+    {
+        gSysFatObj.localOwned = true;
+        result = true;
+    }
+
+    SYS_INT_Restore(interruptState);
+
+    if (result)
+    {
+        /* The host may have changed the volume since the last mount */
+        gSysFatObj.cacheWindow = SYS_FAT_UNKNOWN;
+        gSysFatObj.cacheDirty = false;
+        gSysFatObj.cacheCopy = 0U;
+        gSysFatObj.fileOpen = false;
+
+        SYS_FAT_OperationStart(SYS_FAT_OPERATION_MOUNT, SYS_FAT_STEP_MOUNT_START);
+    }
+
+    return result;
+}
+
+bool SYS_FAT_Unmount ( void )
+{
+    if ((gSysFatObj.operation != SYS_FAT_OPERATION_NONE) || (gSysFatObj.mounted == false) || gSysFatObj.fileOpen)
+    {
+        return false;
+    }
+
+    SYS_FAT_OperationStart(SYS_FAT_OPERATION_UNMOUNT, SYS_FAT_STEP_UNMOUNT_FLUSH);
+
+    return true;
+}
+
+bool SYS_FAT_IsMounted ( void )
+{
+    return gSysFatObj.mounted;
+}
+
+bool SYS_FAT_FileCreate ( const char * name, uint32_t size )
+{
+    uint32_t clusterMask;
+
+    if ((gSysFatObj.operation != SYS_FAT_OPERATION_NONE) || (gSysFatObj.mounted == false) ||
+        gSysFatObj.fileOpen || (name == NULL) || (SYS_FAT_NameBuild(name, gSysFatObj.name) == false))
+    {
+        return false;
+    }
+
+    clusterMask = (SYS_FAT_BLOCK_SIZE << gSysFatObj.clusterShift) - 1U;
+    gSysFatObj.fileClusters = (uint32_t)(((uint64_t)size + clusterMask) / (clusterMask + 1U));
+    if (gSysFatObj.fileClusters == 0U)
+    {
+        gSysFatObj.fileClusters = 1U;
+    }
+
+    gSysFatObj.cluster = gSysFatObj.rootCluster;
+    gSysFatObj.clusterBlock = 0U;
+    gSysFatObj.entryFound = false;
+
+    SYS_FAT_OperationStart(SYS_FAT_OPERATION_CREATE, SYS_FAT_STEP_CREATE_DIR_READ);
+
+    return true;
+}
+
+bool SYS_FAT_FileWrite ( const void * buffer, uint32_t size )
+{
+    uint32_t blocks = size / SYS_FAT_BLOCK_SIZE;
+
+    if ((gSysFatObj.operation != SYS_FAT_OPERATION_NONE) || (gSysFatObj.fileOpen == false) ||
+        (buffer == NULL) || ((size % SYS_FAT_BLOCK_SIZE) != 0U) ||
+        (blocks > ((gSysFatObj.fileClusters << gSysFatObj.clusterShift) - gSysFatObj.fileBlocks)))
+    {
+        return false;
+    }
+
+    gSysFatObj.writeBuffer = (const uint8_t *)buffer;
+    gSysFatObj.writeBlocks = blocks;
+
+    SYS_FAT_OperationStart(SYS_FAT_OPERATION_WRITE, SYS_FAT_STEP_WRITE);
+
+    return true;
+}
+
+bool SYS_FAT_FileClose ( void )
+{
+    if ((gSysFatObj.operation != SYS_FAT_OPERATION_NONE) || (gSysFatObj.fileOpen == false))
+    {
+        return false;
+    }
+
+    gSysFatObj.fileOpen = false;
+
+    SYS_FAT_OperationStart(SYS_FAT_OPERATION_CLOSE, SYS_FAT_STEP_CLOSE_ENTRY_READ);
+
+    return true;
+}
+
+uint32_t SYS_FAT_FileSizeGet ( void )
+{
+    return gSysFatObj.fileOpen ? (gSysFatObj.fileBlocks * SYS_FAT_BLOCK_SIZE) : 0U;
+}
+
+void SYS_FAT_HostAttach ( void )
+{
+    gSysFatObj.hostEjected = false;
+    gSysFatObj.hostAttached = true;
+}
+
+void SYS_FAT_HostDetach ( void )
+{
+    gSysFatObj.hostAttached = false;
+    gSysFatObj.hostEjected = false;
+}
+
+bool SYS_FAT_MediaIsAttached ( const DRV_HANDLE handle )
+{
+    if (gSysFatObj.localOwned || gSysFatObj.hostEjected)
+    {
+        return false;
+    }
+
+    return DRV_SDMMC_IsAttached(handle);
+}
+
+void SYS_FAT_MediaAsyncRead
+(
+    const DRV_HANDLE handle,
+    DRV_SDMMC_COMMAND_HANDLE * commandHandle,
+    void * targetBuffer,
+    uint32_t blockStart,
+    uint32_t nBlocks
+)
+{
+    if (SYS_FAT_HostRequestStart() == false)
+    {
+        *commandHandle = DRV_SDMMC_COMMAND_HANDLE_INVALID;
+        return;
+    }
+
+    DRV_SDMMC_AsyncRead(handle, commandHandle, targetBuffer, blockStart, nBlocks);
+
+    if (*commandHandle == DRV_SDMMC_COMMAND_HANDLE_INVALID)
+    {
+        SYS_FAT_HostRequestCancel();
+    }
+}
+
+void SYS_FAT_MediaAsyncWrite
+(
+    const DRV_HANDLE handle,
+    DRV_SDMMC_COMMAND_HANDLE * commandHandle,
+    void * sourceBuffer,
+    uint32_t blockStart,
+    uint32_t nBlocks
+)
+{
+    if (SYS_FAT_HostRequestStart() == false)
+    {
+        *commandHandle = DRV_SDMMC_COMMAND_HANDLE_INVALID;
+        return;
+    }
+
+    DRV_SDMMC_AsyncWrite(handle, commandHandle, sourceBuffer, blockStart, nBlocks);
+
+    if (*commandHandle == DRV_SDMMC_COMMAND_HANDLE_INVALID)
+    {
+        SYS_FAT_HostRequestCancel();
+    }
+}
+
+/* MISRA C-2012 Rule 11.1 deviated:2 Deviation record ID -  H3_MISRAC_2012_R_11_1_DR_1 */
+void SYS_FAT_MediaEventHandlerSet
+(
+    const DRV_HANDLE handle,
+    const void * eventHandler,
+    const uintptr_t context
+)
+{
+    gSysFatObj.hostEventHandler = (SYS_MEDIA_EVENT_HANDLER)eventHandler;
+    gSysFatObj.hostContext = context;
+
+    DRV_SDMMC_EventHandlerSet(handle, (const void*)SYS_FAT_HostEventHandler, 0U);
+}
+/* MISRAC 2012 deviation block end */
+
+void SYS_FAT_MediaLoadEject ( const DRV_HANDLE handle, bool load )
+{
+    (void) handle;
+
+    gSysFatObj.hostEjected = (load == false);
+}
@@ -0,0 +1,417 @@
+/*******************************************************************************
+  FAT File System Service Library Interface Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sys_fat.h
+
+  Summary
+    FAT File System Service Library interface.
+
+  Description
+    This file defines the interface to the FAT File System Service Library.
+    The service writes log files to the FAT32 volume of the SD card through
+    its own client of the SDMMC driver, while the MSD function serves the
+    same card to the host.
+
+    The card has one owner at a time. It belongs to the host while the USB
+    device is configured, until the host ejects it. Only then SYS_FAT_Mount
+    gives it to the service, and the MSD function reports no medium until
+    SYS_FAT_Unmount gives it back. The mount reads the volume again, as the
+    host may have changed it, and the unmount writes the cached FAT before
+    the host sees the card again.
+
+    A log file is created with its full size allocated as one run of
+    clusters, so its data blocks follow each other on the card. The writes go
+    straight from the client buffer to the card in requests of up to
+    SYS_FAT_WRITE_BLOCKS_MAX blocks, without touching the FAT. The FAT is only
+    read and written through a cache of SYS_FAT_CACHE_SECTORS sectors at the
+    creation and the close of the file.
+
+    Only 8.3 names in the root directory are supported. The root directory
+    is not extended: a file is created in a free entry of its clusters.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SYS_FAT_H    // Guards against multiple inclusion
+#define SYS_FAT_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+#include "driver/sdmmc/drv_sdmmc.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* FAT sectors read and written at once by the cache */
+#ifndef SYS_FAT_CACHE_SECTORS
+    #define SYS_FAT_CACHE_SECTORS           (8U)
+#endif
+
+/* Largest write request in blocks. The SDHC transfers 64 KB per request. */
+#ifndef SYS_FAT_WRITE_BLOCKS_MAX
+    #define SYS_FAT_WRITE_BLOCKS_MAX        (128U)
+#endif
+
+/* Size of a card block in bytes */
+#define SYS_FAT_BLOCK_SIZE                  (512U)
+
+// *****************************************************************************
+/* FAT File System Events
+
+  Summary:
+    Completion of a request, passed to the event handler.
+*/
+
+typedef enum
+{
+    SYS_FAT_EVENT_COMPLETE = 0,
+
+    /* See SYS_FAT_ErrorGet */
+    SYS_FAT_EVENT_ERROR
+
+} SYS_FAT_EVENT;
+
+// *****************************************************************************
+/* FAT File System Errors
+
+  Summary:
+    Reason the last request failed.
+*/
+
+typedef enum
+{
+    SYS_FAT_ERROR_NONE = 0,
+
+    /* A card request failed or the card was removed */
+    SYS_FAT_ERROR_IO,
+
+    /* The card holds no FAT32 volume in its first partition */
+    SYS_FAT_ERROR_FORMAT,
+
+    /* The file already exists */
+    SYS_FAT_ERROR_EXISTS,
+
+    /* The root directory has no free entry */
+    SYS_FAT_ERROR_DIRECTORY_FULL,
+
+    /* The volume has no free run of clusters of the size of the file */
+    SYS_FAT_ERROR_NO_SPACE
+
+} SYS_FAT_ERROR;
+
+// *****************************************************************************
+/* FAT File System Event Handler
+
+  Summary:
+    Called by SYS_FAT_Tasks when a request completes.
+*/
+
+typedef void (*SYS_FAT_EVENT_HANDLER) ( SYS_FAT_EVENT event, uintptr_t context );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    void SYS_FAT_Initialize ( void )
+
+  Summary:
+    Leaves the card to the host and no volume mounted.
+
+  Precondition:
+    DRV_SDMMC_Initialize must have been called.
+*/
+
+void SYS_FAT_Initialize ( void );
+
+//******************************************************************************
+/* Function:
+    void SYS_FAT_Tasks ( void )
+
+  Summary:
+    Runs the request in progress.
+
+  Description:
+    Opens the SDMMC driver, then queues one card request at a time for the
+    request in progress and calls the event handler once it is done. Drops
+    the volume, and the file, if the card is removed while mounted.
+*/
+
+void SYS_FAT_Tasks ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_FAT_IsBusy ( void )
+
+  Summary:
+    Returns true while a request is in progress and no card request is in
+    flight.
+*/
+
+bool SYS_FAT_IsBusy ( void );
+
+//******************************************************************************
+/* Function:
+    void SYS_FAT_EventHandlerSet ( SYS_FAT_EVENT_HANDLER handler,
+                                   uintptr_t context )
+
+  Summary:
+    Sets the function called when a request completes.
+*/
+
+void SYS_FAT_EventHandlerSet ( SYS_FAT_EVENT_HANDLER handler, uintptr_t context );
+
+//******************************************************************************
+/* Function:
+    SYS_FAT_ERROR SYS_FAT_ErrorGet ( void )
+
+  Summary:
+    Returns the reason the last request failed.
+*/
+
+SYS_FAT_ERROR SYS_FAT_ErrorGet ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_FAT_Mount ( void )
+
+  Summary:
+    Takes the card from the host and mounts its volume.
+
+  Description:
+    The MSD function reports no medium from this call on. The volume is read
+    once the MSD requests in flight have completed.
+
+  Returns:
+    false if a request is in progress, the volume is mounted, the driver is
+    not open yet or the host has not ejected the card.
+*/
+
+bool SYS_FAT_Mount ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_FAT_Unmount ( void )
+
+  Summary:
+    Writes the cached FAT and gives the card back to the host.
+
+  Returns:
+    false if a request is in progress, the volume is not mounted or a file
+    is open.
+*/
+
+bool SYS_FAT_Unmount ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_FAT_IsMounted ( void )
+
+  Summary:
+    Returns true from the completion of SYS_FAT_Mount to SYS_FAT_Unmount.
+*/
+
+bool SYS_FAT_IsMounted ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_FAT_FileCreate ( const char * name, uint32_t size )
+
+  Summary:
+    Creates a file in the root directory with size bytes allocated.
+
+  Description:
+    The clusters of the file are one run, found from the next free cluster
+    of the FS info sector on. The file stays empty until SYS_FAT_FileClose.
+
+  Parameters:
+    name - 8.3 name, such as "LOG.BIN". Stored in upper case.
+    size - Bytes allocated, rounded up to whole clusters.
+
+  Returns:
+    false if a request is in progress, the volume is not mounted, a file is
+    open or the name is not a valid 8.3 name.
+*/
+
+bool SYS_FAT_FileCreate ( const char * name, uint32_t size );
+
+//******************************************************************************
+/* Function:
+    bool SYS_FAT_FileWrite ( const void * buffer, uint32_t size )
+
+  Summary:
+    Appends size bytes of buffer to the open file.
+
+  Description:
+    The requests are aligned to SYS_FAT_WRITE_BLOCKS_MAX blocks from the
+    start of the file, so with clusters of up to 64 KB each request covers
+    whole clusters. buffer must stay valid until the request completes.
+
+  Returns:
+    false if a request is in progress, no file is open, size is not a
+    multiple of SYS_FAT_BLOCK_SIZE or the data does not fit in the size
+    allocated by SYS_FAT_FileCreate.
+*/
+
+bool SYS_FAT_FileWrite ( const void * buffer, uint32_t size );
+
+//******************************************************************************
+/* Function:
+    bool SYS_FAT_FileClose ( void )
+
+  Summary:
+    Sets the size of the file to the bytes written and frees the clusters it
+    does not use.
+
+  Returns:
+    false if a request is in progress or no file is open.
+*/
+
+bool SYS_FAT_FileClose ( void );
+
+//******************************************************************************
+/* Function:
+    uint32_t SYS_FAT_FileSizeGet ( void )
+
+  Summary:
+    Returns the bytes written to the open file.
+*/
+
+uint32_t SYS_FAT_FileSizeGet ( void );
+
+//******************************************************************************
+/* Function:
+    void SYS_FAT_HostAttach ( void )
+    void SYS_FAT_HostDetach ( void )
+
+  Summary:
+    Tell the service the USB device was configured or left the bus.
+
+  Description:
+    The card belongs to the host while it is attached and has not ejected
+    it. A new configuration clears the ejection of the previous one.
+*/
+
+void SYS_FAT_HostAttach ( void );
+
+void SYS_FAT_HostDetach ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_FAT_MediaIsAttached ( const DRV_HANDLE handle )
+
+    void SYS_FAT_MediaAsyncRead ( const DRV_HANDLE handle,
+        DRV_SDMMC_COMMAND_HANDLE * commandHandle, void * targetBuffer,
+        uint32_t blockStart, uint32_t nBlocks )
+
+    void SYS_FAT_MediaAsyncWrite ( const DRV_HANDLE handle,
+        DRV_SDMMC_COMMAND_HANDLE * commandHandle, void * sourceBuffer,
+        uint32_t blockStart, uint32_t nBlocks )
+
+    void SYS_FAT_MediaEventHandlerSet ( const DRV_HANDLE handle,
+        const void * eventHandler, const uintptr_t context )
+
+    void SYS_FAT_MediaLoadEject ( const DRV_HANDLE handle, bool load )
+
+  Summary:
+    SD card media functions of the MSD function.
+
+  Description:
+    Wrap the DRV_SDMMC functions of the same name, so that the card is not
+    attached and its requests fail while the service owns it, and the
+    service knows when the requests of the host have completed. The other
+    media functions are the DRV_SDMMC ones.
+
+    SYS_FAT_MediaLoadEject is called for a START STOP UNIT command with the
+    LOEJ bit. After an eject the card is not attached until the host loads
+    it again or the device is configured again.
+*/
+
+bool SYS_FAT_MediaIsAttached ( const DRV_HANDLE handle );
+
+void SYS_FAT_MediaAsyncRead
+(
+    const DRV_HANDLE handle,
+    DRV_SDMMC_COMMAND_HANDLE * commandHandle,
+    void * targetBuffer,
+    uint32_t blockStart,
+    uint32_t nBlocks
+);
+
+void SYS_FAT_MediaAsyncWrite
+(
+    const DRV_HANDLE handle,
+    DRV_SDMMC_COMMAND_HANDLE * commandHandle,
+    void * sourceBuffer,
+    uint32_t blockStart,
+    uint32_t nBlocks
+);
+
+void SYS_FAT_MediaEventHandlerSet
+(
+    const DRV_HANDLE handle,
+    const void * eventHandler,
+    const uintptr_t context
+);
+
+void SYS_FAT_MediaLoadEject ( const DRV_HANDLE handle, bool load );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    }
+#endif
+//DOM-IGNORE-END
+
+#endif // SYS_FAT_H
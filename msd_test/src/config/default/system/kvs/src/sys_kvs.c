@@ -0,0 +1,393 @@
+/*******************************************************************************
+  Key/Value Store System Service Implementation.
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sys_kvs.c
+
+  Summary:
+    Source code for the key/value store system service implementation.
+
+  Description:
+    This file contains the source code for the key/value store system service
+    implementation. The store is an array of SYS_KVS_ENTRIES_NUMBER entries of
+    16 bytes at the start of the SmartEEPROM. A RAM copy of the array holds
+    the current values and a bit per entry marks the ones the SmartEEPROM does
+    not hold yet.
+
+    An entry is written in one go and followed by a SmartEEPROM flush, so its
+    page write runs in the background while the CPU goes on. The next entry
+    is only written once the NVMCTRL is idle, so a write never stalls the CPU.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "configuration.h"
+#include "system/kvs/sys_kvs.h"
+#include "system/int/sys_int.h"
+#include "system/time/sys_time.h"
+#include "system/memory/sys_memory.h"
+#include "peripheral/nvmctrl/plib_nvmctrl.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Words of an entry */
+#define SYS_KVS_ENTRY_WORDS                 (4U)
+
+typedef struct
+{
+    /* SYS_KVS_KEY_INVALID for a free entry */
+    uint16_t key;
+
+    /* Bytes of value in use */
+    uint8_t length;
+
+    /* Complement of the sum of the other bytes in use */
+    uint8_t check;
+
+    uint8_t value[SYS_KVS_VALUE_SIZE_MAX];
+
+} SYS_KVS_ENTRY;
+
+typedef union
+{
+    SYS_KVS_ENTRY entry;
+
+    uint32_t words[SYS_KVS_ENTRY_WORDS];
+
+} SYS_KVS_SLOT;
+
+typedef struct
+{
+    /* RAM copy of the store */
+    SYS_KVS_SLOT slots[SYS_KVS_ENTRIES_NUMBER];
+
+    /* One bit per entry the SmartEEPROM does not hold yet */
+    volatile uint32_t dirtyEntries;
+
+    /* Counter value at the last change */
+    volatile uint32_t changeCount;
+
+    /* SYS_KVS_Flush was called */
+    volatile bool flushRequested;
+
+    /* The changed entries are being written */
+    bool writing;
+
+    /* The SmartEEPROM is enabled and not locked */
+    bool persistent;
+
+} SYS_KVS_OBJ;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+static SYS_KVS_OBJ gSysKvsObj;
+SYS_MEMORY_OBJECT_REGISTER(gSysKvsObj);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint8_t SYS_KVS_Check ( const SYS_KVS_ENTRY * entry )
+{
+    uint32_t sum = (uint32_t)(entry->key & 0xFFU) + (uint32_t)(entry->key >> 8) + entry->length;
+    uint32_t i;
+
+    for (i = 0U; (i < entry->length) && (i < SYS_KVS_VALUE_SIZE_MAX); i++)
+    {
+        sum += entry->value[i];
+    }
+
+    return (uint8_t)~sum;
+}
+
+/* Returns the index of the entry of key, SYS_KVS_ENTRIES_NUMBER if there is
+   none. Called with the interrupts disabled. */
+static uint32_t SYS_KVS_Find ( uint16_t key )
+{
+    uint32_t i;
+
+    for (i = 0U; i < SYS_KVS_ENTRIES_NUMBER; i++)
+    {
+        if (gSysKvsObj.slots[i].entry.key == key)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/* Marks an entry as changed. Called with the interrupts disabled. */
+static void SYS_KVS_Changed ( uint32_t index )
+{
+    gSysKvsObj.dirtyEntries |= (1UL << index);
+    gSysKvsObj.changeCount = SYS_TIME_CounterGet();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_KVS_Initialize ( void )
+{
+    const volatile uint32_t * seeprom = (const volatile uint32_t *)SEEPROM_ADDR;
+    uint32_t status = NVMCTRL_SmartEEPROMStatusGet();
+    SYS_KVS_ENTRY * entry;
+    uint32_t i;
+    uint32_t word;
+
+    (void) memset(gSysKvsObj.slots, 0xFF, sizeof(gSysKvsObj.slots));
+    gSysKvsObj.dirtyEntries = 0U;
+    gSysKvsObj.changeCount = 0U;
+    gSysKvsObj.flushRequested = false;
+    gSysKvsObj.writing = false;
+    gSysKvsObj.persistent = (((status & NVMCTRL_SEESTAT_SBLK_Msk) != 0U) && ((status & NVMCTRL_SEESTAT_LOCK_Msk) == 0U));
+
+    if (gSysKvsObj.persistent == false)
+    {
+        return;
+    }
+
+    /* Page writes only when SYS_KVS_Tasks asks for them. The automatic
+       reallocation stays enabled in case the full flag is missed: the flash
+       driver clears the NVMCTRL flags. */
+    NVMCTRL_REGS->NVMCTRL_SEECFG = NVMCTRL_SEECFG_WMODE_BUFFERED;
+
+    for (i = 0U; i < SYS_KVS_ENTRIES_NUMBER; i++)
+    {
+        for (word = 0U; word < SYS_KVS_ENTRY_WORDS; word++)
+        {
+            gSysKvsObj.slots[i].words[word] = seeprom[(i * SYS_KVS_ENTRY_WORDS) + word];
+        }
+
+        entry = &gSysKvsObj.slots[i].entry;
+        if ((entry->key != SYS_KVS_KEY_INVALID) &&
+            ((entry->length > SYS_KVS_VALUE_SIZE_MAX) || (entry->check != SYS_KVS_Check(entry))))
+        {
+            /* Freed in RAM only, the SmartEEPROM keeps it until reused */
+            (void) memset(entry, 0xFF, sizeof(SYS_KVS_ENTRY));
+        }
+    }
+}
+
+void SYS_KVS_Tasks ( void )
+{
+    volatile uint32_t * seeprom = (volatile uint32_t *)SEEPROM_ADDR;
+    uint32_t words[SYS_KVS_ENTRY_WORDS];
+    bool interruptState;
+    uint32_t index;
+    uint32_t word;
+
+    if (gSysKvsObj.persistent == false)
+    {
+        gSysKvsObj.dirtyEntries = 0U;
+        gSysKvsObj.flushRequested = false;
+        return;
+    }
+
+    if (gSysKvsObj.writing == false)
+    {
+        if (gSysKvsObj.dirtyEntries == 0U)
+        {
+            gSysKvsObj.flushRequested = false;
+            return;
+        }
+
+        if ((gSysKvsObj.flushRequested == false) &&
+            (SYS_TIME_CountToMS(SYS_TIME_CounterGet() - gSysKvsObj.changeCount) < SYS_KVS_FLUSH_DELAY_MS))
+        {
+            return;
+        }
+
+        gSysKvsObj.writing = true;
+    }
+
+    /* Nothing may start an NVMCTRL command between the check and the write */
+    interruptState = SYS_INT_Disable();
+
+    if (NVMCTRL_IsBusy() || NVMCTRL_SmartEEPROM_IsBusy())
+    {
+        /* The previous entry or another client of the NVMCTRL */
+    }
+    else if (NVMCTRL_SmartEEPROM_IsActiveSectorFull())
+    {
+        /* Reallocate before the next write needs it, so the write does not
+           wait for it */
+        NVMCTRL_SmartEEPROMSectorReallocate();
+        NVMCTRL_REGS->NVMCTRL_INTFLAG = NVMCTRL_INTFLAG_SEESFULL_Msk;
+    }
+    else if (gSysKvsObj.dirtyEntries == 0U)
+    {
+        gSysKvsObj.writing = false;
+        gSysKvsObj.flushRequested = false;
+    }
+    else
+    {
+        for (index = 0U; (gSysKvsObj.dirtyEntries & (1UL << index)) == 0U; index++)
+        {
+        }
+        gSysKvsObj.dirtyEntries &= ~(1UL << index);
+
+        for (word = 0U; word < SYS_KVS_ENTRY_WORDS; word++)
+        {
+            words[word] = gSysKvsObj.slots[index].words[word];
+        }
+
+        for (word = 0U; word < SYS_KVS_ENTRY_WORDS; word++)
+        {
+            seeprom[(index * SYS_KVS_ENTRY_WORDS) + word] = words[word];
+        }
+
+        NVMCTRL_SmartEEPROMFlushPageBuffer();
+    }
+
+    SYS_INT_Restore(interruptState);
+}
+
+bool SYS_KVS_IsBusy ( void )
+{
+    return (gSysKvsObj.writing || (gSysKvsObj.flushRequested && (gSysKvsObj.dirtyEntries != 0U)));
+}
+
+bool SYS_KVS_Get ( uint16_t key, void * value, size_t size )
+{
+    bool interruptState;
+    uint32_t index;
+    bool result = false;
+
+    if (value == NULL)
+    {
+        return false;
+    }
+
+    interruptState = SYS_INT_Disable();
+
+    index = SYS_KVS_Find(key);
+    if ((key != SYS_KVS_KEY_INVALID) && (index < SYS_KVS_ENTRIES_NUMBER) &&
+        (gSysKvsObj.slots[index].entry.length == size))
+    {
+        (void) memcpy(value, gSysKvsObj.slots[index].entry.value, size);
+        result = true;
+    }
+
+    SYS_INT_Restore(interruptState);
+
+    return result;
+}
+
+bool SYS_KVS_Set ( uint16_t key, const void * value, size_t size )
+{
+    SYS_KVS_ENTRY * entry;
+    bool interruptState;
+    uint32_t index;
+
+    if ((key == SYS_KVS_KEY_INVALID) || (size > SYS_KVS_VALUE_SIZE_MAX) || ((value == NULL) && (size != 0U)))
+    {
+        return false;
+    }
+
+    interruptState = SYS_INT_Disable();
+
+    index = SYS_KVS_Find(key);
+    if (index == SYS_KVS_ENTRIES_NUMBER)
+    {
+        index = SYS_KVS_Find(SYS_KVS_KEY_INVALID);
+    }
+
+    if (index == SYS_KVS_ENTRIES_NUMBER)
+    {
+        SYS_INT_Restore(interruptState);
+        return false;
+    }
+
+    entry = &gSysKvsObj.slots[index].entry;
+    if ((entry->key != key) || (entry->length != size) || (memcmp(entry->value, value, size) != 0))
+    {
+        (void) memset(entry->value, 0xFF, SYS_KVS_VALUE_SIZE_MAX);
+        (void) memcpy(entry->value, value, size);
+        entry->key = key;
+        entry->length = (uint8_t)size;
+        entry->check = SYS_KVS_Check(entry);
+        SYS_KVS_Changed(index);
+    }
+
+    SYS_INT_Restore(interruptState);
+
+    return true;
+}
+
+bool SYS_KVS_Delete ( uint16_t key )
+{
+    bool interruptState;
+    uint32_t index;
+    bool result = false;
+
+    interruptState = SYS_INT_Disable();
+
+    index = SYS_KVS_Find(key);
+    if ((key != SYS_KVS_KEY_INVALID) && (index < SYS_KVS_ENTRIES_NUMBER))
+    {
+        (void) memset(&gSysKvsObj.slots[index], 0xFF, sizeof(SYS_KVS_SLOT));
+        SYS_KVS_Changed(index);
+        result = true;
+    }
+
+    SYS_INT_Restore(interruptState);
+
+    return result;
+}
+
+void SYS_KVS_Flush ( void )
+{
+    gSysKvsObj.flushRequested = true;
+}
+
+bool SYS_KVS_IsPersistent ( void )
+{
+    return gSysKvsObj.persistent;
+}
@@ -0,0 +1,238 @@
+/*******************************************************************************
+  Key/Value Store System Service Library Interface Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sys_kvs.h
+
+  Summary
+    Key/Value Store System Service Library interface.
+
+  Description
+    This file defines the interface to the Key/Value Store System Service
+    Library. The service keeps small settings in the SmartEEPROM so they
+    survive a reset.
+
+    The values live in a RAM copy of the store. Reads and writes only touch
+    the RAM copy and never wait for the NVMCTRL, so they may be made from the
+    USB or SD card paths. A changed entry is written to the SmartEEPROM from
+    SYS_KVS_Tasks, after SYS_KVS_FLUSH_DELAY_MS without changes or at an
+    explicit SYS_KVS_Flush. Each entry is one SmartEEPROM page, so the writes
+    to an entry in that time cost one page write.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SYS_KVS_H    // Guards against multiple inclusion
+#define SYS_KVS_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Entries of the store, 32 at most */
+#ifndef SYS_KVS_ENTRIES_NUMBER
+    #define SYS_KVS_ENTRIES_NUMBER          (16U)
+#endif
+
+/* Time without changes after which the changed entries are written */
+#ifndef SYS_KVS_FLUSH_DELAY_MS
+    #define SYS_KVS_FLUSH_DELAY_MS          (1000U)
+#endif
+
+/* Largest value of an entry in bytes. An entry with its header is 16 bytes,
+   the SmartEEPROM page size of NVMCTRL_SEEPSZ 2. */
+#define SYS_KVS_VALUE_SIZE_MAX              (12U)
+
+/* Key of a free entry. Keys are chosen by the clients. */
+#define SYS_KVS_KEY_INVALID                 (0xFFFFU)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    void SYS_KVS_Initialize ( void )
+
+  Summary:
+    Loads the RAM copy of the store from the SmartEEPROM.
+
+  Description:
+    Sets the SmartEEPROM to buffered writes without automatic sector
+    reallocation, so the NVMCTRL only writes it from SYS_KVS_Tasks. Entries
+    that fail their check are dropped.
+
+    Without SmartEEPROM, NVMCTRL_SEESBLK 0 in the user row, the store works
+    from RAM only and SYS_KVS_IsPersistent returns false.
+
+  Precondition:
+    NVMCTRL_Initialize must have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+*/
+
+void SYS_KVS_Initialize ( void );
+
+//******************************************************************************
+/* Function:
+    void SYS_KVS_Tasks ( void )
+
+  Summary:
+    Writes the changed entries to the SmartEEPROM.
+
+  Description:
+    Writes one entry per call and only while the NVMCTRL is idle, so a call
+    never waits for the flash. Reallocates the SmartEEPROM sector once it is
+    full.
+
+  Remarks:
+    Must be called while SYS_KVS_IsBusy returns true and periodically
+    otherwise, for the delayed write.
+*/
+
+void SYS_KVS_Tasks ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_KVS_IsBusy ( void )
+
+  Summary:
+    Returns true while changed entries are being written.
+*/
+
+bool SYS_KVS_IsBusy ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_KVS_Get ( uint16_t key, void * value, size_t size )
+
+  Summary:
+    Copies the value of key to value.
+
+  Returns:
+    false if key is not stored or its value is not size bytes. value is
+    left unchanged then.
+*/
+
+bool SYS_KVS_Get ( uint16_t key, void * value, size_t size );
+
+//******************************************************************************
+/* Function:
+    bool SYS_KVS_Set ( uint16_t key, const void * value, size_t size )
+
+  Summary:
+    Stores size bytes of value under key.
+
+  Description:
+    Updates the RAM copy. Storing the value the key already has changes
+    nothing.
+
+  Returns:
+    false if size is above SYS_KVS_VALUE_SIZE_MAX, key is
+    SYS_KVS_KEY_INVALID or all the entries are in use.
+
+  Remarks:
+    May be called from an interrupt.
+*/
+
+bool SYS_KVS_Set ( uint16_t key, const void * value, size_t size );
+
+//******************************************************************************
+/* Function:
+    bool SYS_KVS_Delete ( uint16_t key )
+
+  Summary:
+    Removes key from the store.
+
+  Returns:
+    false if key is not stored.
+*/
+
+bool SYS_KVS_Delete ( uint16_t key );
+
+//******************************************************************************
+/* Function:
+    void SYS_KVS_Flush ( void )
+
+  Summary:
+    Writes the changed entries without waiting for SYS_KVS_FLUSH_DELAY_MS.
+
+  Description:
+    The entries are written by the next calls of SYS_KVS_Tasks.
+*/
+
+void SYS_KVS_Flush ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_KVS_IsPersistent ( void )
+
+  Summary:
+    Returns true if the store is kept in the SmartEEPROM.
+*/
+
+bool SYS_KVS_IsPersistent ( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    }
+#endif
+//DOM-IGNORE-END
+
+#endif // SYS_KVS_H
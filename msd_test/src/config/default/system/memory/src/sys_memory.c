@@ -0,0 +1,251 @@
+/*******************************************************************************
+  Memory System Service Implementation.
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sys_memory.c
+
+  Summary:
+    Source code for the memory system service implementation.
+
+  Description:
+    This file contains the source code for the memory system service
+    implementation. The bounds of the main stack and of the heap come from the
+    symbols of the XC32 linker: _stack is the top of the stack and
+    _min_stack_size and _min_heap_size are the sizes set in the project
+    properties. The heap starts at _heap.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "configuration.h"
+#include "system/memory/sys_memory.h"
+
+#if defined(OSAL_USE_RTOS)
+#include "FreeRTOS.h"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Linker defined symbols. The sizes are given by the symbol addresses. */
+extern uint32_t _stack;
+extern uint32_t _min_stack_size;
+#if !defined(OSAL_USE_RTOS)
+extern uint32_t _heap;
+extern uint32_t _min_heap_size;
+#endif
+
+/* Registered objects, collected by the linker script */
+extern const SYS_MEMORY_OBJECT __sys_memory_objects_start[];
+extern const SYS_MEMORY_OBJECT __sys_memory_objects_end[];
+
+#define SYS_MEMORY_ISR_NAME(name)   #name,
+
+static const char * const gMemoryISRNames[SYS_MEMORY_ISR_COUNT + 1U] =
+{
+    SYS_MEMORY_ISRS(SYS_MEMORY_ISR_NAME)
+
+    NULL
+};
+
+static uint32_t gMemoryISRDepth[SYS_MEMORY_ISR_COUNT + 1U];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t * SYS_MEMORY_StackLimitGet ( void )
+{
+    return (uint32_t *)((uintptr_t)&_stack - (uintptr_t)&_min_stack_size);
+}
+
+/* Returns the number of bytes from the first word that differs from the
+   paint pattern to the end of the region */
+static uint32_t SYS_MEMORY_RegionUsedGet ( const uint32_t * start, const uint32_t * end, bool fromStart )
+{
+    const uint32_t * word;
+
+    if (fromStart)
+    {
+        /* The stack grows down: the unused words are at the start */
+        word = start;
+        while ((word < end) && (*word == SYS_MEMORY_PAINT_PATTERN))
+        {
+            word++;
+        }
+
+        return (uint32_t)((uintptr_t)end - (uintptr_t)word);
+    }
+
+    /* The heap grows up: the unused words are at the end */
+    word = end;
+    while ((word > start) && (*(word - 1) == SYS_MEMORY_PAINT_PATTERN))
+    {
+        word--;
+    }
+
+    return (uint32_t)((uintptr_t)word - (uintptr_t)start);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_MEMORY_Initialize ( void )
+{
+    uint32_t * word = SYS_MEMORY_StackLimitGet();
+    uint32_t * end = (uint32_t *)((__get_MSP() - SYS_MEMORY_PAINT_MARGIN) & ~3U);
+
+    while (word < end)
+    {
+        *word = SYS_MEMORY_PAINT_PATTERN;
+        word++;
+    }
+
+#if !defined(OSAL_USE_RTOS)
+    word = &_heap;
+    end = (uint32_t *)((uintptr_t)&_heap + (uintptr_t)&_min_heap_size);
+
+    while (word < end)
+    {
+        *word = SYS_MEMORY_PAINT_PATTERN;
+        word++;
+    }
+#endif
+}
+
+bool SYS_MEMORY_StackStatisticsGet ( SYS_MEMORY_STATISTICS * statistics )
+{
+    if (statistics == NULL)
+    {
+        return false;
+    }
+
+    statistics->size = (uint32_t)(uintptr_t)&_min_stack_size;
+    statistics->highWaterMark = SYS_MEMORY_RegionUsedGet(SYS_MEMORY_StackLimitGet(), &_stack, true);
+
+    return true;
+}
+
+bool SYS_MEMORY_HeapStatisticsGet ( SYS_MEMORY_STATISTICS * statistics )
+{
+    if (statistics == NULL)
+    {
+        return false;
+    }
+
+#if defined(OSAL_USE_RTOS)
+    statistics->size = (uint32_t)configTOTAL_HEAP_SIZE;
+    statistics->highWaterMark = statistics->size - (uint32_t)xPortGetMinimumEverFreeHeapSize();
+#else
+    statistics->size = (uint32_t)(uintptr_t)&_min_heap_size;
+    statistics->highWaterMark = SYS_MEMORY_RegionUsedGet(&_heap,
+            (const uint32_t *)((uintptr_t)&_heap + (uintptr_t)&_min_heap_size), false);
+#endif
+
+    return true;
+}
+
+void SYS_MEMORY_ISRSample ( SYS_MEMORY_ISR isr )
+{
+    uint32_t depth = (uint32_t)((uintptr_t)&_stack - __get_MSP());
+
+    /* The sampled interrupts share one priority and cannot preempt each
+       other */
+    if (depth > gMemoryISRDepth[isr])
+    {
+        gMemoryISRDepth[isr] = depth;
+    }
+}
+
+uint32_t SYS_MEMORY_ISRDepthGet ( SYS_MEMORY_ISR isr )
+{
+    if (isr >= SYS_MEMORY_ISR_COUNT)
+    {
+        return 0U;
+    }
+
+    return gMemoryISRDepth[isr];
+}
+
+const char * SYS_MEMORY_ISRNameGet ( SYS_MEMORY_ISR isr )
+{
+    if (isr >= SYS_MEMORY_ISR_COUNT)
+    {
+        return NULL;
+    }
+
+    return gMemoryISRNames[isr];
+}
+
+size_t SYS_MEMORY_ObjectCountGet ( void )
+{
+    return (size_t)(__sys_memory_objects_end - __sys_memory_objects_start);
+}
+
+const SYS_MEMORY_OBJECT * SYS_MEMORY_ObjectGet ( size_t rank )
+{
+    const SYS_MEMORY_OBJECT * object;
+    const SYS_MEMORY_OBJECT * other;
+    size_t larger;
+
+    for (object = __sys_memory_objects_start; object < __sys_memory_objects_end; object++)
+    {
+        /* Count the objects ranked before this one */
+        larger = 0U;
+        for (other = __sys_memory_objects_start; other < __sys_memory_objects_end; other++)
+        {
+            if ((other->size > object->size) ||
+                ((other->size == object->size) && ((uintptr_t)other->address < (uintptr_t)object->address)))
+            {
+                larger++;
+            }
+        }
+
+        if (larger == rank)
+        {
+            return object;
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,386 @@
+/*******************************************************************************
+  Memory System Service Library Interface Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sys_memory.h
+
+  Summary
+    Memory System Service Library interface.
+
+  Description
+    This file defines the interface to the Memory System Service Library. The
+    service reports how much of the main stack and of the heap has been used
+    since reset, the stack depth at the entry of the interrupts listed by
+    SYS_MEMORY_ISRS in configuration.h and the size of the objects registered
+    with SYS_MEMORY_OBJECT_REGISTER.
+
+    The unused part of the main stack and the heap are painted with a known
+    pattern by SYS_MEMORY_Initialize. The high-water marks are found by
+    scanning for the first word that no longer holds the pattern.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SYS_MEMORY_H    // Guards against multiple inclusion
+#define SYS_MEMORY_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+#include "device.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Value painted over the unused stack and heap */
+#ifndef SYS_MEMORY_PAINT_PATTERN
+    #define SYS_MEMORY_PAINT_PATTERN        (0xA5A5A5A5U)
+#endif
+
+/* Bytes below the stack pointer of SYS_MEMORY_Initialize that are left
+   unpainted, as they hold its own frame */
+#ifndef SYS_MEMORY_PAINT_MARGIN
+    #define SYS_MEMORY_PAINT_MARGIN         (64U)
+#endif
+
+#ifndef SYS_MEMORY_ISRS
+    #define SYS_MEMORY_ISRS(ISR)
+#endif
+
+// *****************************************************************************
+/* Sampled interrupt identifiers
+
+  Summary:
+    Identifies an interrupt whose stack depth is sampled.
+
+  Description:
+    One identifier SYS_MEMORY_ISR_<name> is generated for every entry of
+    SYS_MEMORY_ISRS.
+*/
+
+#define SYS_MEMORY_ISR_ID(name)     SYS_MEMORY_ISR_##name,
+
+typedef enum
+{
+    SYS_MEMORY_ISRS(SYS_MEMORY_ISR_ID)
+
+    SYS_MEMORY_ISR_COUNT
+
+} SYS_MEMORY_ISR;
+
+// *****************************************************************************
+/* Memory region statistics
+
+  Summary:
+    Usage of the main stack or of the heap.
+*/
+
+typedef struct
+{
+    /* Size of the region in bytes */
+    uint32_t size;
+
+    /* Most bytes ever used since reset */
+    uint32_t highWaterMark;
+
+} SYS_MEMORY_STATISTICS;
+
+// *****************************************************************************
+/* Registered object
+
+  Summary:
+    Describes an object of the static memory report.
+
+  Description:
+    The descriptors are placed in the .sys_memory_objects section by
+    SYS_MEMORY_OBJECT_REGISTER.
+*/
+
+typedef struct
+{
+    /* Name of the object */
+    const char * name;
+
+    /* Address and size in bytes */
+    const void * address;
+    uint32_t size;
+
+} SYS_MEMORY_OBJECT;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Macro:
+    SYS_MEMORY_OBJECT_REGISTER(object)
+
+  Summary:
+    Adds a statically allocated object to the static memory report.
+
+  Description:
+    The macro must be used at file scope after the definition of the object.
+    It also works for objects with internal linkage.
+*/
+
+#define SYS_MEMORY_OBJECT_REGISTER(object) \
+    static const SYS_MEMORY_OBJECT sysMemoryObject_##object \
+        __attribute__((used, section(".sys_memory_objects"))) = \
+        { #object, (const void *)&(object), (uint32_t)sizeof(object) }
+
+// *****************************************************************************
+/* Macro:
+    SYS_MEMORY_ISR_SAMPLE(isr)
+
+  Summary:
+    Samples the main stack depth at the entry of an interrupt.
+
+  Description:
+    The macro must be the first statement of the interrupt handler. The depth
+    includes the exception frame and the stack of the preempted code.
+*/
+
+#define SYS_MEMORY_ISR_SAMPLE(isr) \
+    SYS_MEMORY_ISRSample(SYS_MEMORY_ISR_##isr)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    void SYS_MEMORY_Initialize ( void )
+
+  Summary:
+    Paints the unused main stack and the heap.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Remarks:
+    This routine must be the first call of the SYS_Initialize function, before
+    anything is allocated from the heap.
+*/
+
+void SYS_MEMORY_Initialize ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_MEMORY_StackStatisticsGet ( SYS_MEMORY_STATISTICS * statistics )
+
+  Summary:
+    Returns the size and the high-water mark of the main stack.
+
+  Description:
+    The stack is scanned from its limit up to the first word that no longer
+    holds the paint pattern.
+
+  Precondition:
+    SYS_MEMORY_Initialize must have been called.
+
+  Parameters:
+    statistics - Receives the statistics.
+
+  Returns:
+    false if statistics is NULL.
+
+  Remarks:
+    The main stack is used by main and by the interrupts. With OSAL_USE_RTOS
+    the tasks run on their own stacks, which SYS_SCHED_StatisticsGet reports.
+*/
+
+bool SYS_MEMORY_StackStatisticsGet ( SYS_MEMORY_STATISTICS * statistics );
+
+//******************************************************************************
+/* Function:
+    bool SYS_MEMORY_HeapStatisticsGet ( SYS_MEMORY_STATISTICS * statistics )
+
+  Summary:
+    Returns the size and the high-water mark of the heap.
+
+  Precondition:
+    SYS_MEMORY_Initialize must have been called.
+
+  Parameters:
+    statistics - Receives the statistics.
+
+  Returns:
+    false if statistics is NULL.
+
+  Remarks:
+    With OSAL_USE_RTOS the FreeRTOS heap is reported instead of the C library
+    heap.
+*/
+
+bool SYS_MEMORY_HeapStatisticsGet ( SYS_MEMORY_STATISTICS * statistics );
+
+//******************************************************************************
+/* Function:
+    void SYS_MEMORY_ISRSample ( SYS_MEMORY_ISR isr )
+
+  Summary:
+    Records the main stack depth at the entry of an interrupt.
+
+  Description:
+    This function is normally called through SYS_MEMORY_ISR_SAMPLE.
+
+  Precondition:
+    None.
+
+  Parameters:
+    isr - Interrupt identifier.
+
+  Returns:
+    None.
+*/
+
+void SYS_MEMORY_ISRSample ( SYS_MEMORY_ISR isr );
+
+//******************************************************************************
+/* Function:
+    uint32_t SYS_MEMORY_ISRDepthGet ( SYS_MEMORY_ISR isr )
+
+  Summary:
+    Returns the deepest main stack seen at the entry of an interrupt.
+
+  Precondition:
+    None.
+
+  Parameters:
+    isr - Interrupt identifier.
+
+  Returns:
+    Depth in bytes, or 0 for an invalid identifier.
+*/
+
+uint32_t SYS_MEMORY_ISRDepthGet ( SYS_MEMORY_ISR isr );
+
+//******************************************************************************
+/* Function:
+    const char * SYS_MEMORY_ISRNameGet ( SYS_MEMORY_ISR isr )
+
+  Summary:
+    Returns the name of an interrupt as listed in SYS_MEMORY_ISRS.
+
+  Precondition:
+    None.
+
+  Parameters:
+    isr - Interrupt identifier.
+
+  Returns:
+    Name, or NULL for an invalid identifier.
+*/
+
+const char * SYS_MEMORY_ISRNameGet ( SYS_MEMORY_ISR isr );
+
+//******************************************************************************
+/* Function:
+    size_t SYS_MEMORY_ObjectCountGet ( void )
+
+  Summary:
+    Returns the number of registered objects.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    Number of objects registered with SYS_MEMORY_OBJECT_REGISTER.
+*/
+
+size_t SYS_MEMORY_ObjectCountGet ( void );
+
+//******************************************************************************
+/* Function:
+    const SYS_MEMORY_OBJECT * SYS_MEMORY_ObjectGet ( size_t rank )
+
+  Summary:
+    Returns a registered object by decreasing size.
+
+  Description:
+    Rank 0 is the largest object. Objects of the same size are ordered by
+    address.
+
+  Precondition:
+    None.
+
+  Parameters:
+    rank - Position of the object in the report.
+
+  Returns:
+    Descriptor of the object, or NULL when rank is out of range.
+
+  Remarks:
+    The objects are ranked on every call. The report is meant for a
+    diagnostic dump, not for a hot path.
+*/
+
+const SYS_MEMORY_OBJECT * SYS_MEMORY_ObjectGet ( size_t rank );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    }
+#endif
+//DOM-IGNORE-END
+
+#endif // SYS_MEMORY_H
@@ -0,0 +1,182 @@
+/*******************************************************************************
+  Profile System Service Implementation.
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sys_profile.c
+
+  Summary:
+    Source code for the profile system service implementation.
+
+  Description:
+    This file contains the source code for the profile system service
+    implementation. The statistics live in RAM and are updated by
+    SYS_PROFILE_Record in the context of the measured section.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "configuration.h"
+#include "system/profile/sys_profile.h"
+#include "system/int/sys_int.h"
+
+#if defined(SYS_PROFILE_ENABLE)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define SYS_PROFILE_PROBE_NAME(name)    #name,
+
+static const char * const gProfileProbeNames[SYS_PROFILE_PROBE_COUNT] =
+{
+    SYS_PROFILE_PROBES(SYS_PROFILE_PROBE_NAME)
+};
+
+static SYS_PROFILE_STATISTICS gProfileStatistics[SYS_PROFILE_PROBE_COUNT];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void SYS_PROFILE_StatisticsClear ( SYS_PROFILE_STATISTICS * statistics )
+{
+    (void) memset(statistics, 0, sizeof(*statistics));
+    statistics->min = 0xFFFFFFFFU;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_PROFILE_Initialize ( void )
+{
+    /* The DWT is only clocked while trace is enabled */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    SYS_PROFILE_Reset();
+}
+
+void SYS_PROFILE_Record ( SYS_PROFILE_PROBE probe, uint32_t cycles )
+{
+    SYS_PROFILE_STATISTICS * statistics = &gProfileStatistics[probe];
+    uint32_t bucket = 0U;
+    uint32_t log2Cycles;
+    bool interruptState;
+
+    if (cycles != 0U)
+    {
+        log2Cycles = 31U - (uint32_t)__builtin_clz(cycles);
+        if (log2Cycles > SYS_PROFILE_HISTOGRAM_SHIFT)
+        {
+            bucket = log2Cycles - SYS_PROFILE_HISTOGRAM_SHIFT;
+        }
+    }
+
+    if (bucket >= SYS_PROFILE_HISTOGRAM_BUCKETS)
+    {
+        bucket = SYS_PROFILE_HISTOGRAM_BUCKETS - 1U;
+    }
+
+    /* The same probe may also be recorded by an interrupt */
+    interruptState = SYS_INT_Disable();
+
+    statistics->count++;
+    statistics->total += cycles;
+
+    if (cycles < statistics->min)
+    {
+        statistics->min = cycles;
+    }
+
+    if (cycles > statistics->max)
+    {
+        statistics->max = cycles;
+    }
+
+    statistics->histogram[bucket]++;
+
+    SYS_INT_Restore(interruptState);
+}
+
+bool SYS_PROFILE_StatisticsGet ( SYS_PROFILE_PROBE probe, SYS_PROFILE_STATISTICS * statistics )
+{
+    bool interruptState;
+
+    if ((probe >= SYS_PROFILE_PROBE_COUNT) || (statistics == NULL))
+    {
+        return false;
+    }
+
+    /* Probes may be recorded from interrupts */
+    interruptState = SYS_INT_Disable();
+    *statistics = gProfileStatistics[probe];
+    SYS_INT_Restore(interruptState);
+
+    return true;
+}
+
+const char * SYS_PROFILE_NameGet ( SYS_PROFILE_PROBE probe )
+{
+    if (probe >= SYS_PROFILE_PROBE_COUNT)
+    {
+        return NULL;
+    }
+
+    return gProfileProbeNames[probe];
+}
+
+void SYS_PROFILE_Reset ( void )
+{
+    bool interruptState;
+    uint32_t i;
+
+    for (i = 0U; i < (uint32_t)SYS_PROFILE_PROBE_COUNT; i++)
+    {
+        interruptState = SYS_INT_Disable();
+        SYS_PROFILE_StatisticsClear(&gProfileStatistics[i]);
+        SYS_INT_Restore(interruptState);
+    }
+}
+
+#endif // SYS_PROFILE_ENABLE
@@ -0,0 +1,317 @@
+/*******************************************************************************
+  Profile System Service Library Interface Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sys_profile.h
+
+  Summary
+    Profile System Service Library interface.
+
+  Description
+    This file defines the interface to the Profile System Service Library. The
+    service measures code sections with the Cortex-M4 DWT cycle counter. The
+    probe points are listed at compile time by SYS_PROFILE_PROBES in
+    configuration.h and each section is bracketed by SYS_PROFILE_ENTER and
+    SYS_PROFILE_EXIT. The service keeps the count, minimum, maximum, total and
+    a log2 histogram of the cycles of every probe.
+
+    Unless SYS_PROFILE_ENABLE is defined, the macros and SYS_PROFILE_Initialize
+    compile to nothing.
+
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SYS_PROFILE_H    // Guards against multiple inclusion
+#define SYS_PROFILE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+#include "device.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+#if defined(SYS_PROFILE_ENABLE)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Number of histogram buckets. Bucket 0 counts the sections shorter than
+   2^(SYS_PROFILE_HISTOGRAM_SHIFT + 1) cycles, bucket n counts the sections of
+   2^(n + SYS_PROFILE_HISTOGRAM_SHIFT) up to twice that many cycles and the last
+   bucket also counts every longer section. */
+#ifndef SYS_PROFILE_HISTOGRAM_BUCKETS
+    #define SYS_PROFILE_HISTOGRAM_BUCKETS   (16U)
+#endif
+
+#ifndef SYS_PROFILE_HISTOGRAM_SHIFT
+    #define SYS_PROFILE_HISTOGRAM_SHIFT     (4U)
+#endif
+
+// *****************************************************************************
+/* Profile probe identifiers
+
+  Summary:
+    Identifies a probe point.
+
+  Description:
+    One identifier SYS_PROFILE_PROBE_<name> is generated for every entry of
+    SYS_PROFILE_PROBES.
+*/
+
+#define SYS_PROFILE_PROBE_ID(name)  SYS_PROFILE_PROBE_##name,
+
+typedef enum
+{
+    SYS_PROFILE_PROBES(SYS_PROFILE_PROBE_ID)
+
+    SYS_PROFILE_PROBE_COUNT
+
+} SYS_PROFILE_PROBE;
+
+// *****************************************************************************
+/* Profile probe statistics
+
+  Summary:
+    Cycle statistics of one probe.
+
+  Description:
+    The mean is total / count.
+*/
+
+typedef struct
+{
+    /* Number of measured sections */
+    uint32_t count;
+
+    /* Shortest and longest section in cycles */
+    uint32_t min;
+    uint32_t max;
+
+    /* Sum of all sections in cycles */
+    uint64_t total;
+
+    /* log2 histogram of the section lengths */
+    uint32_t histogram[SYS_PROFILE_HISTOGRAM_BUCKETS];
+
+} SYS_PROFILE_STATISTICS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Probe Macros
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Macro:
+    SYS_PROFILE_ENTER(probe)
+
+  Summary:
+    Starts the measurement of a probe.
+
+  Description:
+    This macro declares a local variable that holds the cycle counter at the
+    start of the section. It must be used as a statement in the same block as
+    the matching SYS_PROFILE_EXIT.
+
+  Remarks:
+    The measured time includes the interrupts that preempt the section.
+*/
+
+#define SYS_PROFILE_ENTER(probe) \
+    uint32_t sysProfileStart_##probe = DWT->CYCCNT
+
+// *****************************************************************************
+/* Macro:
+    SYS_PROFILE_EXIT(probe)
+
+  Summary:
+    Ends the measurement of a probe and records it.
+
+  Remarks:
+    A probe may be recorded from several execution contexts. A section that
+    is preempted by another recording of the same probe still measures its
+    own start and end.
+*/
+
+#define SYS_PROFILE_EXIT(probe) \
+    SYS_PROFILE_Record(SYS_PROFILE_PROBE_##probe, DWT->CYCCNT - sysProfileStart_##probe)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    void SYS_PROFILE_Initialize ( void )
+
+  Summary:
+    Enables the DWT cycle counter and clears the statistics of all probes.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function before any
+    probe is recorded.
+*/
+
+void SYS_PROFILE_Initialize ( void );
+
+//******************************************************************************
+/* Function:
+    void SYS_PROFILE_Record ( SYS_PROFILE_PROBE probe, uint32_t cycles )
+
+  Summary:
+    Adds one measured section to the statistics of a probe.
+
+  Description:
+    This function is normally called through SYS_PROFILE_EXIT. The statistics
+    are updated with the interrupts disabled.
+
+  Precondition:
+    SYS_PROFILE_Initialize must have been called.
+
+  Parameters:
+    probe - Probe identifier.
+
+    cycles - Length of the section in CPU cycles.
+
+  Returns:
+    None.
+*/
+
+void SYS_PROFILE_Record ( SYS_PROFILE_PROBE probe, uint32_t cycles );
+
+//******************************************************************************
+/* Function:
+    bool SYS_PROFILE_StatisticsGet ( SYS_PROFILE_PROBE probe,
+        SYS_PROFILE_STATISTICS * statistics )
+
+  Summary:
+    Returns a consistent copy of the statistics of a probe.
+
+  Precondition:
+    SYS_PROFILE_Initialize must have been called.
+
+  Parameters:
+    probe - Probe identifier.
+
+    statistics - Pointer to where the statistics are copied.
+
+  Returns:
+    true if the statistics were copied, false if probe is not valid.
+
+  Remarks:
+    Interrupts are disabled while the statistics are copied.
+*/
+
+bool SYS_PROFILE_StatisticsGet ( SYS_PROFILE_PROBE probe, SYS_PROFILE_STATISTICS * statistics );
+
+//******************************************************************************
+/* Function:
+    const char * SYS_PROFILE_NameGet ( SYS_PROFILE_PROBE probe )
+
+  Summary:
+    Returns the name of a probe as listed in SYS_PROFILE_PROBES.
+
+  Precondition:
+    None.
+
+  Parameters:
+    probe - Probe identifier.
+
+  Returns:
+    Name of the probe, or NULL if probe is not valid.
+*/
+
+const char * SYS_PROFILE_NameGet ( SYS_PROFILE_PROBE probe );
+
+//******************************************************************************
+/* Function:
+    void SYS_PROFILE_Reset ( void )
+
+  Summary:
+    Clears the statistics of all probes.
+
+  Precondition:
+    SYS_PROFILE_Initialize must have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+*/
+
+void SYS_PROFILE_Reset ( void );
+
+#else
+
+#define SYS_PROFILE_ENTER(probe)
+#define SYS_PROFILE_EXIT(probe)
+#define SYS_PROFILE_Initialize()
+
+#endif // SYS_PROFILE_ENABLE
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    }
+#endif
+//DOM-IGNORE-END
+
+#endif // SYS_PROFILE_H
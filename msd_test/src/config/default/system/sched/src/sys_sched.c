@@ -0,0 +1,344 @@
+/*******************************************************************************
+  Scheduler System Service Implementation.
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    sys_sched.c
+
+  Summary:
+    Source code for the scheduler system service implementation.
+
+  Description:
+    This file contains the source code for the scheduler system service
+    implementation. Every task has one ready bit. Posting an event sets the
+    ready bits of the tasks waiting for it, and SYS_SCHED_Run takes all ready
+    bits at once and runs the tasks in table order. With OSAL_USE_RTOS every
+    task runs in its own FreeRTOS task and waits for a task notification
+    instead of a ready bit.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "configuration.h"
+#include "device.h"
+#include "system/sched/sys_sched.h"
+#include "system/int/sys_int.h"
+#include "system/time/sys_time.h"
+#if defined(OSAL_USE_RTOS)
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Core instructions of the scheduler. A build for another core, such as the
+   host build on the POSIX port of FreeRTOS, defines its own. */
+#ifndef SYS_SCHED_IS_INTERRUPT
+#define SYS_SCHED_IS_INTERRUPT()        (__get_IPSR() != 0U)
+#endif
+
+#ifndef SYS_SCHED_WAIT_FOR_INTERRUPT
+#define SYS_SCHED_WAIT_FOR_INTERRUPT()  do { __DSB(); __WFI(); } while (false)
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct
+{
+    /* Task table */
+    const SYS_SCHED_TASK * tasks;
+    size_t taskCount;
+
+    /* One bit per task, set by SYS_SCHED_EventPost */
+    volatile uint32_t readyTasks;
+
+    /* Time spent in WFI */
+    uint64_t idleTime;
+
+    SYS_SCHED_TASK_STATISTICS statistics[SYS_SCHED_TASKS_MAX];
+
+#if defined(OSAL_USE_RTOS)
+    TaskHandle_t taskHandles[SYS_SCHED_TASKS_MAX];
+#endif
+
+} SYS_SCHED_OBJ;
+
+static SYS_SCHED_OBJ gSchedObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool SYS_SCHED_TaskIsBusy ( const SYS_SCHED_TASK * task )
+{
+    return ((task->isBusy != NULL) && task->isBusy());
+}
+
+/* Runs one step of a task, accounts it and posts its run events */
+static void SYS_SCHED_TaskRun ( size_t index )
+{
+    const SYS_SCHED_TASK * task = &gSchedObj.tasks[index];
+    SYS_SCHED_TASK_STATISTICS * statistics = &gSchedObj.statistics[index];
+    uint32_t startCount;
+    uint32_t runTime;
+
+    startCount = SYS_TIME_CounterGet();
+    task->run();
+    runTime = SYS_TIME_CounterGet() - startCount;
+
+    statistics->runs++;
+    statistics->runTime += runTime;
+    if (runTime > statistics->runTimeMax)
+    {
+        statistics->runTimeMax = runTime;
+    }
+
+    if (task->runEvents != 0U)
+    {
+        SYS_SCHED_EventPost(task->runEvents);
+    }
+}
+
+#if defined(OSAL_USE_RTOS)
+/* Body of the RTOS task of one table entry */
+static void SYS_SCHED_TaskEntry ( void * parameter )
+{
+    size_t index = (size_t)parameter;
+    TickType_t waitTicks;
+
+    for (;;)
+    {
+        SYS_SCHED_TaskRun(index);
+
+        /* Events posted while the task ran are still pending, so the wait
+           returns at once for them. A busy task only checks them. */
+        waitTicks = SYS_SCHED_TaskIsBusy(&gSchedObj.tasks[index]) ? 0U : portMAX_DELAY;
+        (void) xTaskNotifyWait(0U, 0U, NULL, waitTicks);
+    }
+}
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_SCHED_Initialize ( const SYS_SCHED_TASK * tasks, size_t count )
+{
+    (void) memset(&gSchedObj, 0, sizeof(gSchedObj));
+
+    if (count > SYS_SCHED_TASKS_MAX)
+    {
+        count = SYS_SCHED_TASKS_MAX;
+    }
+
+    gSchedObj.tasks = tasks;
+    gSchedObj.readyTasks = (count == SYS_SCHED_TASKS_MAX) ? 0xFFFFFFFFU : ((1UL << count) - 1U);
+
+#if defined(OSAL_USE_RTOS)
+    {
+        size_t i;
+
+        /* Every task runs its first step as soon as the kernel starts */
+        for (i = 0; i < count; i++)
+        {
+            (void) xTaskCreate(SYS_SCHED_TaskEntry, tasks[i].name,
+                    (configSTACK_DEPTH_TYPE)tasks[i].rtosStackSize, (void *)i,
+                    (UBaseType_t)tasks[i].rtosPriority, &gSchedObj.taskHandles[i]);
+        }
+    }
+#endif
+
+    /* Published last, events are only delivered to existing tasks */
+    gSchedObj.taskCount = count;
+}
+
+void SYS_SCHED_EventPost ( uint32_t events )
+{
+#if defined(OSAL_USE_RTOS)
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    bool isInterrupt = SYS_SCHED_IS_INTERRUPT();
+    size_t i;
+
+    for (i = 0; i < gSchedObj.taskCount; i++)
+    {
+        if (((gSchedObj.tasks[i].events & events) == 0U) || (gSchedObj.taskHandles[i] == NULL))
+        {
+            continue;
+        }
+
+        if (isInterrupt)
+        {
+            (void) xTaskNotifyFromISR(gSchedObj.taskHandles[i], 0U, eNoAction, &higherPriorityTaskWoken);
+        }
+        else
+        {
+            (void) xTaskNotify(gSchedObj.taskHandles[i], 0U, eNoAction);
+        }
+    }
+
+    if (isInterrupt)
+    {
+        /* Switch to the woken task when the interrupt returns */
+        portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    }
+#else
+    uint32_t readyTasks = 0U;
+    bool interruptState;
+    size_t i;
+
+    for (i = 0; i < gSchedObj.taskCount; i++)
+    {
+        if ((gSchedObj.tasks[i].events & events) != 0U)
+        {
+            readyTasks |= (1UL << i);
+        }
+    }
+
+    interruptState = SYS_INT_Disable();
+    gSchedObj.readyTasks |= readyTasks;
+    SYS_INT_Restore(interruptState);
+#endif
+}
+
+void SYS_SCHED_Run ( void )
+{
+#if defined(OSAL_USE_RTOS)
+    /* The tasks run from now on. This function never returns. */
+    vTaskStartScheduler();
+#else
+    uint32_t readyTasks;
+    bool interruptState;
+    bool taskRan = false;
+    size_t i;
+
+    interruptState = SYS_INT_Disable();
+    readyTasks = gSchedObj.readyTasks;
+    gSchedObj.readyTasks = 0U;
+    SYS_INT_Restore(interruptState);
+
+    for (i = 0; i < gSchedObj.taskCount; i++)
+    {
+        if (((readyTasks & (1UL << i)) == 0U) &&
+            (SYS_SCHED_TaskIsBusy(&gSchedObj.tasks[i]) == false))
+        {
+            continue;
+        }
+
+        SYS_SCHED_TaskRun(i);
+
+        taskRan = true;
+    }
+
+    if (taskRan)
+    {
+        /* The tasks that ran may have made others ready */
+        return;
+    }
+
+    /* An event posted after the ready bits were taken is still pending as an
+     * interrupt, so WFI returns at once instead of missing it */
+    interruptState = SYS_INT_Disable();
+    if (gSchedObj.readyTasks == 0U)
+    {
+        SYS_SCHED_Idle();
+    }
+    SYS_INT_Restore(interruptState);
+#endif
+}
+
+void SYS_SCHED_Idle ( void )
+{
+    uint32_t startCount;
+
+    startCount = SYS_TIME_CounterGet();
+    SYS_SCHED_WAIT_FOR_INTERRUPT();
+    gSchedObj.idleTime += (SYS_TIME_CounterGet() - startCount);
+}
+
+bool SYS_SCHED_TaskStatisticsGet ( size_t task, SYS_SCHED_TASK_STATISTICS * statistics )
+{
+    if ((task >= gSchedObj.taskCount) || (statistics == NULL))
+    {
+        return false;
+    }
+
+    *statistics = gSchedObj.statistics[task];
+
+#if defined(OSAL_USE_RTOS)
+    if (gSchedObj.taskHandles[task] != NULL)
+    {
+        TaskStatus_t taskStatus;
+
+        /* The kernel counts the processor time without the preemptions */
+        vTaskGetInfo(gSchedObj.taskHandles[task], &taskStatus, pdTRUE, eInvalid);
+        statistics->runTime = taskStatus.ulRunTimeCounter;
+        statistics->stackFree = (uint32_t)taskStatus.usStackHighWaterMark * sizeof(StackType_t);
+    }
+#endif
+
+    return true;
+}
+
+size_t SYS_SCHED_TaskCountGet ( void )
+{
+    return gSchedObj.taskCount;
+}
+
+const char * SYS_SCHED_TaskNameGet ( size_t task )
+{
+    if (task >= gSchedObj.taskCount)
+    {
+        return NULL;
+    }
+
+    return gSchedObj.tasks[task].name;
+}
+
+uint64_t SYS_SCHED_IdleTimeGet ( void )
+{
+    return gSchedObj.idleTime;
+}
@@ -0,0 +1,370 @@
+/*******************************************************************************
+  Scheduler System Service Library Interface Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sys_sched.h
+
+  Summary
+    Scheduler System Service Library interface.
+
+  Description
+    This file defines the interface to the Scheduler System Service Library.
+    The service runs the polled "Tasks" routines of the system as
+    run-to-completion tasks. Interrupt handlers and tasks post events, and a
+    task only runs when an event it waits for was posted or while it reports
+    itself busy. When no task is ready the core sleeps in WFI until the next
+    interrupt.
+
+    When OSAL_USE_RTOS is defined every task of the table becomes a FreeRTOS
+    task with its own priority and stack, and events are delivered as task
+    notifications. A task that waits for the card can then never delay a task
+    of higher priority.
+
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SYS_SCHED_H    // Guards against multiple inclusion
+#define SYS_SCHED_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Largest number of tasks. Each task has one ready bit. */
+#define SYS_SCHED_TASKS_MAX     (32U)
+
+// *****************************************************************************
+/* Scheduler task routine
+
+  Summary:
+    Runs one step of a task and returns.
+*/
+
+typedef void (*SYS_SCHED_TASK_FUNCTION)( void );
+
+// *****************************************************************************
+/* Scheduler busy routine
+
+  Summary:
+    Tells if a task can make progress without a new event.
+
+  Description:
+    A task whose busy routine returns true runs on every pass of the
+    scheduler, as a plain superloop would run it. Under an RTOS it keeps the
+    processor until it is no longer busy, so only the tasks of higher priority
+    run in between.
+*/
+
+typedef bool (*SYS_SCHED_BUSY_FUNCTION)( void );
+
+// *****************************************************************************
+/* Scheduler task descriptor
+
+  Summary:
+    Describes one task of the task table.
+
+  Description:
+    Events are a bitmask defined by the configuration (SYS_SCHED_EVENT_xxx).
+*/
+
+typedef struct
+{
+    /* Name reported with the statistics */
+    const char * name;
+
+    /* Task routine */
+    SYS_SCHED_TASK_FUNCTION run;
+
+    /* Busy routine, may be NULL if the task only runs on events */
+    SYS_SCHED_BUSY_FUNCTION isBusy;
+
+    /* Events that make the task ready */
+    uint32_t events;
+
+    /* Events posted every time the task has run, to wake the tasks that
+       consume its results */
+    uint32_t runEvents;
+
+    /* RTOS task priority and stack depth in words. Not used without an
+       RTOS, where the table order is the priority. */
+    uint32_t rtosPriority;
+    uint32_t rtosStackSize;
+
+} SYS_SCHED_TASK;
+
+// *****************************************************************************
+/* Scheduler task statistics
+
+  Summary:
+    Run-time accounting of one task.
+
+  Description:
+    Times are in SYS_TIME counts.
+*/
+
+typedef struct
+{
+    /* Number of times the task has run */
+    uint32_t runs;
+
+    /* Longest run. Under an RTOS this includes the time the task was
+       preempted. */
+    uint32_t runTimeMax;
+
+    /* Processor time used by the task */
+    uint64_t runTime;
+
+    /* Stack bytes the task has never used. Only measured under an RTOS,
+       0 otherwise. */
+    uint32_t stackFree;
+
+} SYS_SCHED_TASK_STATISTICS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    void SYS_SCHED_Initialize ( const SYS_SCHED_TASK * tasks, size_t count )
+
+  Summary:
+    Sets the task table and makes every task ready.
+
+  Precondition:
+    SYS_TIME must have been initialized.
+
+  Parameters:
+    tasks - Task table in priority order. The table is used in place and must
+    stay valid.
+
+    count - Number of tasks in the table, at most SYS_SCHED_TASKS_MAX.
+
+  Returns:
+    None.
+
+  Remarks:
+    Every task runs once on the first pass, so that the state machines can
+    leave their initial states.
+
+    Under an RTOS the tasks are created here and start with the kernel in
+    SYS_SCHED_Run. The kernel masks the interrupts from the first task
+    creation until it starts.
+*/
+
+void SYS_SCHED_Initialize ( const SYS_SCHED_TASK * tasks, size_t count );
+
+//******************************************************************************
+/* Function:
+    void SYS_SCHED_EventPost ( uint32_t events )
+
+  Summary:
+    Makes the tasks that wait for any of the events ready.
+
+  Precondition:
+    SYS_SCHED_Initialize must have been called.
+
+  Parameters:
+    events - Bitmask of the posted events.
+
+  Returns:
+    None.
+
+  Remarks:
+    This routine can be called from interrupt handlers.
+*/
+
+void SYS_SCHED_EventPost ( uint32_t events );
+
+//******************************************************************************
+/* Function:
+    void SYS_SCHED_Run ( void )
+
+  Summary:
+    Runs every ready task once, or sleeps until an interrupt if none is ready.
+
+  Description:
+    The tasks run in table order. A task is ready if one of its events was
+    posted since it last ran or if its busy routine returns true. When no task
+    is ready the core executes WFI with interrupts disabled, so that an event
+    posted after the check still wakes it up.
+
+  Precondition:
+    SYS_SCHED_Initialize must have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Remarks:
+    This routine is called from SYS_Tasks. Under an RTOS it starts the kernel
+    and does not return.
+*/
+
+void SYS_SCHED_Run ( void );
+
+//******************************************************************************
+/* Function:
+    void SYS_SCHED_Idle ( void )
+
+  Summary:
+    Sleeps in WFI until the next interrupt and accounts the sleep time.
+
+  Precondition:
+    Interrupts must be disabled by the caller, so that an interrupt that
+    becomes pending after the caller decided to sleep ends the sleep at once.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Remarks:
+    Called by SYS_SCHED_Run without an RTOS and by the RTOS idle hook.
+*/
+
+void SYS_SCHED_Idle ( void );
+
+//******************************************************************************
+/* Function:
+    bool SYS_SCHED_TaskStatisticsGet ( size_t task,
+        SYS_SCHED_TASK_STATISTICS * statistics )
+
+  Summary:
+    Returns the run-time accounting of a task.
+
+  Precondition:
+    SYS_SCHED_Initialize must have been called.
+
+  Parameters:
+    task - Index of the task in the task table.
+
+    statistics - Pointer to where the statistics are copied.
+
+  Returns:
+    true if the statistics were copied, false if task is not valid.
+*/
+
+bool SYS_SCHED_TaskStatisticsGet ( size_t task, SYS_SCHED_TASK_STATISTICS * statistics );
+
+//******************************************************************************
+/* Function:
+    size_t SYS_SCHED_TaskCountGet ( void )
+
+  Summary:
+    Returns the number of tasks in the task table.
+
+  Precondition:
+    SYS_SCHED_Initialize must have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    Number of tasks.
+*/
+
+size_t SYS_SCHED_TaskCountGet ( void );
+
+//******************************************************************************
+/* Function:
+    const char * SYS_SCHED_TaskNameGet ( size_t task )
+
+  Summary:
+    Returns the name of a task.
+
+  Precondition:
+    SYS_SCHED_Initialize must have been called.
+
+  Parameters:
+    task - Index of the task in the task table.
+
+  Returns:
+    Name of the task, or NULL if task is not valid.
+*/
+
+const char * SYS_SCHED_TaskNameGet ( size_t task );
+
+//******************************************************************************
+/* Function:
+    uint64_t SYS_SCHED_IdleTimeGet ( void )
+
+  Summary:
+    Returns the time the core has spent sleeping in SYS_SCHED_Run.
+
+  Precondition:
+    SYS_SCHED_Initialize must have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    Sleep time in SYS_TIME counts since SYS_SCHED_Initialize. The interrupt
+    that ends a sleep runs after the sleep time is taken.
+*/
+
+uint64_t SYS_SCHED_IdleTimeGet ( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    }
+#endif
+//DOM-IGNORE-END
+
+#endif // SYS_SCHED_H
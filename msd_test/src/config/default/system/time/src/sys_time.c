@@ -153,25 +153,25 @@ static SYS_TIME_TIMER_OBJ* SYS_TIME_GetTimerObject(SYS_TIME_HANDLE handle)
     return NULL;
 }
 
+static bool SYS_TIME_NextExpiryGet(uint32_t* relativeTimePending);
+
 static void SYS_TIME_HwTimerCompareUpdate(void)
 {
     uint64_t nextHwCounterValue = 0;
     uint64_t currHwCounterValue;
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
-    SYS_TIME_TIMER_OBJ* tmrActive = counterObj->tmrActive;
+    uint32_t relativeTimePending;
 
     counterObj->hwTimerPreviousValue = counterObj->hwTimerCurrentValue;
 
-    if (tmrActive != NULL)
+    if (SYS_TIME_NextExpiryGet(&relativeTimePending) == true)
     {
-        if (tmrActive->relativeTimePending > SYS_TIME_HW_COUNTER_HALF_PERIOD)
+        if (relativeTimePending > SYS_TIME_HW_COUNTER_HALF_PERIOD)
         {
             nextHwCounterValue = (uint64_t)counterObj->hwTimerCurrentValue + SYS_TIME_HW_COUNTER_HALF_PERIOD;
         }
         else
         {
-            /* Use a non-volatile intermediate to prevent dual volatile access in single statement */
-            uint32_t relativeTimePending = tmrActive->relativeTimePending;
             nextHwCounterValue = (uint64_t)counterObj->hwTimerCurrentValue + relativeTimePending;
         }
     }
@@ -207,6 +207,23 @@ static void SYS_TIME_HwTimerCompareUpdate(void)
     counterObj->timePlib->timerCompareSet(counterObj->hwTimerCompareValue);
 }
 
+#if !defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+
+/* Returns the counts from the last update to the expiry of the first timer */
+static bool SYS_TIME_NextExpiryGet(uint32_t* relativeTimePending)
+{
+    SYS_TIME_TIMER_OBJ* tmrActive = gSystemCounterObj.tmrActive;
+
+    if (tmrActive == NULL)
+    {
+        return false;
+    }
+
+    /* Use a non-volatile intermediate to prevent dual volatile access in single statement */
+    *relativeTimePending = tmrActive->relativeTimePending;
+    return true;
+}
+
 static bool SYS_TIME_RemoveFromList(SYS_TIME_TIMER_OBJ* delTimer)
 {
     SYS_TIME_COUNTER_OBJ* counter = (SYS_TIME_COUNTER_OBJ *)&gSystemCounterObj;
@@ -319,6 +336,8 @@ static bool SYS_TIME_AddToList(SYS_TIME_TIMER_OBJ* newTimer)
     return isHeadTimerUpdated;
 }
 
+#endif
+
 static uint32_t SYS_TIME_GetElapsedCount(uint32_t hwTimerCurrentValue)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
@@ -340,6 +359,363 @@ static uint32_t SYS_TIME_GetElapsedCount(uint32_t hwTimerCurrentValue)
 
 }
 
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+
+/* Timing wheel engine. Every active timer sits in the slot of one wheel level
+ * that is selected from its absolute expiry tick, so starting, stopping and
+ * expiring a timer never walks the other timers. When the wheel reaches the
+ * slot of a higher level, the timers of that slot are moved down to the
+ * levels below. */
+
+static SYS_TIME_TIMER_OBJ** SYS_TIME_WheelListGet(uint8_t level, uint8_t slot)
+{
+    if (level == SYS_TIME_WHEEL_LEVEL_EXPIRED)
+    {
+        return &gSystemCounterObj.tmrExpired;
+    }
+
+    return &gSystemCounterObj.wheel[level][slot];
+}
+
+static void SYS_TIME_WheelLink(SYS_TIME_TIMER_OBJ* tmr, uint8_t level, uint8_t slot)
+{
+    SYS_TIME_TIMER_OBJ** head = SYS_TIME_WheelListGet(level, slot);
+
+    tmr->tmrPrev = NULL;
+    tmr->tmrNext = *head;
+    if (*head != NULL)
+    {
+        (*head)->tmrPrev = tmr;
+    }
+    *head = tmr;
+
+    tmr->wheelLevel = level;
+    tmr->wheelSlot = slot;
+
+    if (level == SYS_TIME_WHEEL_LEVEL_EXPIRED)
+    {
+        tmr->relativeTimePending = 0;
+    }
+    else
+    {
+        gSystemCounterObj.wheelOccupied[level] |= (1UL << slot);
+    }
+}
+
+static void SYS_TIME_WheelUnlink(SYS_TIME_TIMER_OBJ* tmr)
+{
+    SYS_TIME_TIMER_OBJ** head;
+
+    if (tmr->wheelLevel == SYS_TIME_WHEEL_LEVEL_NONE)
+    {
+        return;
+    }
+
+    head = SYS_TIME_WheelListGet(tmr->wheelLevel, tmr->wheelSlot);
+
+    if (tmr->tmrPrev != NULL)
+    {
+        tmr->tmrPrev->tmrNext = tmr->tmrNext;
+    }
+    else
+    {
+        *head = tmr->tmrNext;
+    }
+    if (tmr->tmrNext != NULL)
+    {
+        tmr->tmrNext->tmrPrev = tmr->tmrPrev;
+    }
+
+    if ((*head == NULL) && (tmr->wheelLevel != SYS_TIME_WHEEL_LEVEL_EXPIRED))
+    {
+        gSystemCounterObj.wheelOccupied[tmr->wheelLevel] &= ~(1UL << tmr->wheelSlot);
+    }
+
+    tmr->tmrNext = NULL;
+    tmr->tmrPrev = NULL;
+    tmr->wheelLevel = SYS_TIME_WHEEL_LEVEL_NONE;
+}
+
+/* Places the timer in the wheel according to its expiryCount */
+static void SYS_TIME_WheelInsert(SYS_TIME_TIMER_OBJ* tmr)
+{
+    SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+    uint32_t expiryTick;
+    uint32_t delta;
+    uint32_t level = 0;
+
+    /* Round up so that a timer never expires early */
+    expiryTick = (uint32_t)((tmr->expiryCount + (SYS_TIME_WHEEL_TICK_COUNT - 1U)) >> SYS_TIME_WHEEL_TICK_SHIFT);
+    delta = expiryTick - counterObj->wheelTick;
+
+    if ((delta == 0U) || (delta > 0x7FFFFFFFU))
+    {
+        SYS_TIME_WheelLink(tmr, SYS_TIME_WHEEL_LEVEL_EXPIRED, 0);
+        return;
+    }
+
+    while ((level < (SYS_TIME_WHEEL_LEVELS - 1U)) && (delta >= (1UL << (SYS_TIME_WHEEL_SLOT_BITS * (level + 1U)))))
+    {
+        level++;
+    }
+
+    SYS_TIME_WheelLink(tmr, (uint8_t)level,
+            (uint8_t)((expiryTick >> (SYS_TIME_WHEEL_SLOT_BITS * level)) & SYS_TIME_WHEEL_SLOT_MASK));
+}
+
+/* Finds the first non-empty slot after the current tick. Returns its distance
+ * in wheel ticks, which is where the slot expires (level 0) or is moved down
+ * (higher levels). Slots of several levels can fall on the same tick. */
+static bool SYS_TIME_WheelNextEventGet(uint32_t* distance)
+{
+    SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+    uint32_t wheelTick = counterObj->wheelTick;
+    uint32_t level;
+    uint32_t shift;
+    uint32_t start;
+    uint32_t occupied;
+    uint32_t index;
+    uint32_t levelDistance;
+    bool found = false;
+
+    for (level = 0; level < SYS_TIME_WHEEL_LEVELS; level++)
+    {
+        occupied = counterObj->wheelOccupied[level];
+        if (occupied == 0U)
+        {
+            continue;
+        }
+
+        /* Rotate so that bit 0 is the slot after the current one. The slot of
+         * the current tick comes last, a full revolution later. */
+        shift = SYS_TIME_WHEEL_SLOT_BITS * level;
+        start = ((wheelTick >> shift) + 1U) & SYS_TIME_WHEEL_SLOT_MASK;
+        occupied = (occupied >> start) | (occupied << ((SYS_TIME_WHEEL_SLOTS - start) & SYS_TIME_WHEEL_SLOT_MASK));
+        index = (uint32_t)__builtin_ctz(occupied);
+
+        levelDistance = ((((wheelTick >> shift) + index + 1U) << shift) - wheelTick);
+        if ((found == false) || (levelDistance < *distance))
+        {
+            *distance = levelDistance;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/* Empties the slots that fall on the current tick, from the highest level
+ * down. A slot of level L holds the timers of the next 32^L ticks, so its
+ * timers move to the lower levels, whose slots of the same tick are then
+ * emptied in turn, or to the expired list. A slot must be emptied on its own
+ * tick: once the wheel has moved past it, it comes a full revolution later. */
+static void SYS_TIME_WheelSlotsExpire(void)
+{
+    SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+    uint32_t wheelTick = counterObj->wheelTick;
+    uint32_t level;
+    uint32_t shift;
+    SYS_TIME_TIMER_OBJ* tmr;
+    SYS_TIME_TIMER_OBJ* tmrNext;
+
+    for (level = SYS_TIME_WHEEL_LEVELS; level > 0U; level--)
+    {
+        shift = SYS_TIME_WHEEL_SLOT_BITS * (level - 1U);
+        if ((wheelTick & ((1UL << shift) - 1U)) != 0U)
+        {
+            continue;
+        }
+
+        tmr = counterObj->wheel[level - 1U][(wheelTick >> shift) & SYS_TIME_WHEEL_SLOT_MASK];
+        while (tmr != NULL)
+        {
+            tmrNext = tmr->tmrNext;
+            SYS_TIME_WheelUnlink(tmr);
+            SYS_TIME_WheelInsert(tmr);
+            tmr = tmrNext;
+        }
+    }
+}
+
+/* Returns the counts from the last update to the next wheel event */
+static bool SYS_TIME_NextExpiryGet(uint32_t* relativeTimePending)
+{
+    SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+    uint32_t distance;
+    uint64_t eventCount;
+
+    if (counterObj->tmrExpired != NULL)
+    {
+        *relativeTimePending = 0;
+        return true;
+    }
+
+    if (SYS_TIME_WheelNextEventGet(&distance) == false)
+    {
+        return false;
+    }
+
+    eventCount = ((counterObj->wheelCount >> SYS_TIME_WHEEL_TICK_SHIFT) + distance) << SYS_TIME_WHEEL_TICK_SHIFT;
+    eventCount -= counterObj->wheelCount;
+    *relativeTimePending = (eventCount > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)eventCount;
+
+    return true;
+}
+
+static bool SYS_TIME_RemoveFromList(SYS_TIME_TIMER_OBJ* delTimer)
+{
+    SYS_TIME_WheelUnlink(delTimer);
+
+    /* The next event can only move later, the early compare is harmless */
+    return false;
+}
+
+static bool SYS_TIME_AddToList(SYS_TIME_TIMER_OBJ* newTimer)
+{
+    uint32_t pendingBefore = 0;
+    uint32_t pendingAfter = 0;
+    bool hadExpiry;
+
+    if (newTimer == NULL)
+    {
+        return false;
+    }
+
+    hadExpiry = SYS_TIME_NextExpiryGet(&pendingBefore);
+
+    newTimer->expiryCount = gSystemCounterObj.wheelCount + newTimer->relativeTimePending;
+    SYS_TIME_WheelInsert(newTimer);
+
+    (void) SYS_TIME_NextExpiryGet(&pendingAfter);
+
+    return ((hadExpiry == false) || (pendingAfter < pendingBefore));
+}
+
+static uint32_t SYS_TIME_GetTotalElapsedCount(SYS_TIME_TIMER_OBJ* tmr)
+{
+    SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+    uint64_t currentCount;
+    uint64_t pendingCount = 0;
+
+    if (tmr->active == false)
+    {
+        return 0;
+    }
+
+    currentCount = counterObj->wheelCount + SYS_TIME_GetElapsedCount(counterObj->timePlib->timerCounterGet());
+    if (tmr->expiryCount > currentCount)
+    {
+        pendingCount = tmr->expiryCount - currentCount;
+    }
+
+    return (tmr->requestedTime >= pendingCount) ? (tmr->requestedTime - (uint32_t)pendingCount) : 0U;
+}
+
+static void SYS_TIME_UpdateTimerList(uint32_t elapsedCount)
+{
+    SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+    uint32_t targetTick;
+    uint32_t distance;
+
+    counterObj->wheelCount += elapsedCount;
+    targetTick = (uint32_t)(counterObj->wheelCount >> SYS_TIME_WHEEL_TICK_SHIFT);
+
+    /* Visit only the ticks that have timers to move, in time order */
+    while ((SYS_TIME_WheelNextEventGet(&distance) == true)
+            && (distance <= (targetTick - counterObj->wheelTick)))
+    {
+        counterObj->wheelTick += distance;
+
+        SYS_TIME_WheelSlotsExpire();
+    }
+
+    counterObj->wheelTick = targetTick;
+    counterObj->hwTimerPreviousValue = counterObj->hwTimerCurrentValue;
+}
+
+static void SYS_TIME_ClientNotify(void)
+{
+    SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+    SYS_TIME_TIMER_OBJ* tmr;
+
+    while (counterObj->tmrExpired != NULL)
+    {
+        tmr = counterObj->tmrExpired;
+        SYS_TIME_WheelUnlink(tmr);
+
+        tmr->tmrElapsedFlag = true;
+        tmr->tmrElapsed = true;
+
+        if ((tmr->type == SYS_TIME_SINGLE) && (tmr->callback != NULL))
+        {
+            /* Destroy single shot timer for which the callback is registered */
+            (void) SYS_TIME_TimerDestroy(tmr->tmrHandle);
+        }
+        else if (tmr->type == SYS_TIME_SINGLE)
+        {
+            /* Delay timers become inactive after expiry. */
+            tmr->active = false;
+        }
+        else
+        {
+            /* Periodic timers are added back after the callback */
+        }
+
+        if (tmr->callback != NULL)
+        {
+            tmr->callback(tmr->context);
+        }
+
+        /* tmrElapsed is cleared if the callback stopped, started, reloaded or
+         * destroyed the timer */
+        if (tmr->tmrElapsed == true)
+        {
+            tmr->tmrElapsed = false;
+
+            if (tmr->type == SYS_TIME_PERIODIC)
+            {
+                /* Keep the period free of drift unless the timer fell behind */
+                tmr->relativeTimePending = tmr->requestedTime;
+                tmr->expiryCount += tmr->requestedTime;
+                if (tmr->expiryCount <= counterObj->wheelCount)
+                {
+                    tmr->expiryCount = counterObj->wheelCount + tmr->requestedTime;
+                }
+                SYS_TIME_WheelInsert(tmr);
+            }
+        }
+    }
+}
+
+static void SYS_TIME_UpdateTime(uint32_t elapsedCounts)
+{
+    SYS_TIME_UpdateTimerList(elapsedCounts);
+
+    SYS_TIME_ClientNotify();
+}
+
+static void SYS_TIME_WheelInitialize(void)
+{
+    uint32_t i;
+
+    (void) memset(gSystemCounterObj.wheel, 0, sizeof(gSystemCounterObj.wheel));
+    (void) memset(gSystemCounterObj.wheelOccupied, 0, sizeof(gSystemCounterObj.wheelOccupied));
+    gSystemCounterObj.wheelCount = 0;
+    gSystemCounterObj.wheelTick = 0;
+    gSystemCounterObj.tmrExpired = NULL;
+    gSystemCounterObj.tmrFree = NULL;
+
+    /* Timer objects are taken from the free list in index order */
+    for (i = SYS_TIME_MAX_TIMERS; i > 0U; i--)
+    {
+        timers[i - 1U].wheelLevel = SYS_TIME_WHEEL_LEVEL_NONE;
+        timers[i - 1U].tmrNext = gSystemCounterObj.tmrFree;
+        gSystemCounterObj.tmrFree = &timers[i - 1U];
+    }
+}
+
+#else
+
 static uint32_t SYS_TIME_GetTotalElapsedCount(SYS_TIME_TIMER_OBJ* tmr)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
@@ -413,6 +789,8 @@ static void SYS_TIME_UpdateTimerList(uint32_t elapsedCount)
     counterObj->hwTimerPreviousValue = counterObj->hwTimerCurrentValue;
 }
 
+#endif
+
 static void SYS_TIME_TimerAdd(SYS_TIME_TIMER_OBJ* newTimer)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
@@ -440,6 +818,8 @@ static void SYS_TIME_TimerAdd(SYS_TIME_TIMER_OBJ* newTimer)
     }
 }
 
+#if !defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+
 static void SYS_TIME_ClientNotify(void)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
@@ -517,10 +897,11 @@ static void SYS_TIME_UpdateTime(uint32_t elapsedCounts)
     }
 }
 
+#endif
+
 static void SYS_TIME_PLIBCallback(uint32_t status, uintptr_t context)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ *)&gSystemCounterObj;
-    SYS_TIME_TIMER_OBJ* tmrActive = counterObj->tmrActive;
     uint32_t elapsedCount = 0;
     bool interruptState;
 
@@ -530,7 +911,15 @@ static void SYS_TIME_PLIBCallback(uint32_t status, uintptr_t context)
 
     counterObj->swCounter64 = counterObj->swCounter64 + elapsedCount;
 
-    if (tmrActive != NULL)
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+    /* The wheel must follow the counter even while it is empty */
+    counterObj->interruptNestingCount++;
+
+    SYS_TIME_UpdateTime(elapsedCount);
+
+    counterObj->interruptNestingCount--;
+#else
+    if (counterObj->tmrActive != NULL)
     {
         counterObj->interruptNestingCount++;
 
@@ -538,6 +927,7 @@ static void SYS_TIME_PLIBCallback(uint32_t status, uintptr_t context)
 
         counterObj->interruptNestingCount--;
     }
+#endif
 
     interruptState = SYS_INT_Disable();
     SYS_TIME_HwTimerCompareUpdate();
@@ -562,30 +952,47 @@ static SYS_TIME_HANDLE SYS_TIME_TimerObjectCreate(
     }
     if((gSystemCounterObj.status == SYS_STATUS_READY) && (period > 0U) && (period >= count))
     {
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+        /* Take the first unused object without searching for it */
+        tmr = gSystemCounterObj.tmrFree;
+        if (tmr != NULL)
+        {
+            gSystemCounterObj.tmrFree = tmr->tmrNext;
+            tmr->tmrNext = NULL;
+        }
+#else
         for(tmr = timers; tmr < &timers[SYS_TIME_MAX_TIMERS]; tmr++)
         {
             if(tmr->inUse == false)
             {
-                tmr->inUse = true;
-                tmr->active = false;
-                tmr->tmrElapsedFlag = false;
-                tmr->tmrElapsed = false;
-                tmr->type = type;
-                tmr->requestedTime = period;
-                tmr->callback = callBack;
-                tmr->context = context;
-                tmr->relativeTimePending = period - count;
-
-                /* Assign a handle to this request. The timer handle must be unique. */
-                tmr->tmrHandle = (SYS_TIME_HANDLE) SYS_TIME_MAKE_HANDLE(gSysTimeTokenCount, (uint16_t)tmrObjIndex);
-                /* Update the token number. */
-                gSysTimeTokenCount = SYS_TIME_UPDATE_TOKEN(gSysTimeTokenCount);
-
-                tmrHandle = tmr->tmrHandle;
-
                 break;
             }
-            tmrObjIndex++;
+        }
+        if (tmr == &timers[SYS_TIME_MAX_TIMERS])
+        {
+            tmr = NULL;
+        }
+#endif
+        if (tmr != NULL)
+        {
+            tmrObjIndex = (uint32_t)(tmr - timers);
+
+            tmr->inUse = true;
+            tmr->active = false;
+            tmr->tmrElapsedFlag = false;
+            tmr->tmrElapsed = false;
+            tmr->type = type;
+            tmr->requestedTime = period;
+            tmr->callback = callBack;
+            tmr->context = context;
+            tmr->relativeTimePending = period - count;
+
+            /* Assign a handle to this request. The timer handle must be unique. */
+            tmr->tmrHandle = (SYS_TIME_HANDLE) SYS_TIME_MAKE_HANDLE(gSysTimeTokenCount, (uint16_t)tmrObjIndex);
+            /* Update the token number. */
+            gSysTimeTokenCount = SYS_TIME_UPDATE_TOKEN(gSysTimeTokenCount);
+
+            tmrHandle = tmr->tmrHandle;
         }
     }
 
@@ -650,6 +1057,9 @@ SYS_MODULE_OBJ SYS_TIME_Initialize( const SYS_MODULE_INDEX index, const SYS_MODU
 
     SYS_TIME_CounterInit((SYS_MODULE_INIT *)init);
     (void) memset(timers, 0, sizeof(timers));
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+    SYS_TIME_WheelInitialize();
+#endif
 
     gSystemCounterObj.status = SYS_STATUS_READY;
 
@@ -858,6 +1268,10 @@ SYS_TIME_RESULT SYS_TIME_TimerDestroy(SYS_TIME_HANDLE handle)
         tmr->tmrElapsedFlag = false;
         tmr->tmrElapsed = false;
         tmr->inUse = false;
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+        tmr->tmrNext = gSystemCounterObj.tmrFree;
+        gSystemCounterObj.tmrFree = tmr;
+#endif
         result = SYS_TIME_SUCCESS;
     }
 
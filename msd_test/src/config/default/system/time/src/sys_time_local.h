@@ -79,6 +79,46 @@
 #define SYS_TIME_HANDLE_TOKEN_MAX              (0xFFFFU)
 #define SYS_TIME_INDEX_MASK                    (0x0000FFFFUL)
 
+// *****************************************************************************
+/* Timing Wheel Macros
+
+  Summary:
+    Timing wheel geometry.
+
+  Description:
+    When SYS_TIME_TIMING_WHEEL_ENABLE is defined, the timers are kept in a
+    hierarchical timing wheel instead of a delta sorted list. The wheel tick
+    is 2^SYS_TIME_WHEEL_TICK_SHIFT hardware counts. Each level has
+    SYS_TIME_WHEEL_SLOTS slots and every level spans SYS_TIME_WHEEL_SLOTS times
+    the range of the level below it. Timers expire on the first wheel tick at
+    or after their expiry count.
+
+  Remarks:
+    The levels must span the largest timer period of 2^32 counts.
+*/
+
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+
+#ifndef SYS_TIME_WHEEL_TICK_SHIFT
+#define SYS_TIME_WHEEL_TICK_SHIFT              (13U)
+#endif
+
+#define SYS_TIME_WHEEL_TICK_COUNT              (1ULL << SYS_TIME_WHEEL_TICK_SHIFT)
+#define SYS_TIME_WHEEL_SLOT_BITS               (5U)
+#define SYS_TIME_WHEEL_SLOTS                   (1UL << SYS_TIME_WHEEL_SLOT_BITS)
+#define SYS_TIME_WHEEL_SLOT_MASK               (SYS_TIME_WHEEL_SLOTS - 1U)
+#define SYS_TIME_WHEEL_LEVELS                  (4U)
+
+/* Pseudo levels of a timer that is on the expired list or on no list */
+#define SYS_TIME_WHEEL_LEVEL_EXPIRED           (SYS_TIME_WHEEL_LEVELS)
+#define SYS_TIME_WHEEL_LEVEL_NONE              (0xFFU)
+
+#if ((SYS_TIME_WHEEL_TICK_SHIFT + (SYS_TIME_WHEEL_LEVELS * SYS_TIME_WHEEL_SLOT_BITS)) < 33U)
+#error "SYS_TIME_WHEEL_TICK_SHIFT is too small for the timing wheel to span 2^32 counts"
+#endif
+
+#endif
+
 // *****************************************************************************
 /* SYS TIME OBJECT INSTANCE structure
 
@@ -104,6 +144,12 @@ typedef struct SYS_TIME_TIMER_OBJ_T{
       volatile bool                 tmrElapsed;    /* Set on every timer expiry. Cleared after timer is added back to the list */
       struct SYS_TIME_TIMER_OBJ_T*   tmrNext; /* Next timer */
       SYS_TIME_HANDLE               tmrHandle; /* Unique handle for object */
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+      struct SYS_TIME_TIMER_OBJ_T*   tmrPrev; /* Previous timer in the wheel slot */
+      uint64_t                      expiryCount; /* Absolute expiry on the wheel counter */
+      uint8_t                       wheelLevel; /* Wheel level, SYS_TIME_WHEEL_LEVEL_EXPIRED or SYS_TIME_WHEEL_LEVEL_NONE */
+      uint8_t                       wheelSlot; /* Slot within the wheel level */
+#endif
 } SYS_TIME_TIMER_OBJ;
 
 
@@ -121,6 +167,14 @@ typedef struct{
     uint8_t                         interruptNestingCount;
     bool                            hwTimerIntStatus;
     SYS_TIME_TIMER_OBJ*             tmrActive;
+#if defined(SYS_TIME_TIMING_WHEEL_ENABLE)
+    SYS_TIME_TIMER_OBJ*             wheel[SYS_TIME_WHEEL_LEVELS][SYS_TIME_WHEEL_SLOTS];
+    uint32_t                        wheelOccupied[SYS_TIME_WHEEL_LEVELS]; /* One bit per non-empty slot */
+    uint64_t                        wheelCount;            /* Counts the wheel has advanced over */
+    uint32_t                        wheelTick;             /* wheelCount in wheel ticks */
+    SYS_TIME_TIMER_OBJ*             tmrExpired;            /* Expired timers waiting for notification */
+    SYS_TIME_TIMER_OBJ*             tmrFree;               /* Unused timer objects */
+#endif
     /* Mutex to protect access to the shared resources */
     OSAL_MUTEX_DECLARE(timerMutex);
 
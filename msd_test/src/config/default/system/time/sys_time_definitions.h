@@ -75,9 +75,17 @@ typedef void (*SYS_TIME_PLIB_START)(void);
 typedef void (*SYS_TIME_PLIB_STOP)(void);
 
 
+/* The period, compare and counter functions take the native width of the
+   hardware counter, as given by SYS_TIME_HW_COUNTER_WIDTH */
+#if (SYS_TIME_HW_COUNTER_WIDTH == 32)
+typedef void (*SYS_TIME_PLIB_PERIOD_SET)(uint32_t period);
+typedef void (*SYS_TIME_PLIB_COMPARE_SET) (uint32_t compare);
+typedef uint32_t (*SYS_TIME_PLIB_COUNTER_GET)(void);
+#else
 typedef void (*SYS_TIME_PLIB_PERIOD_SET)(uint16_t period);
 typedef void (*SYS_TIME_PLIB_COMPARE_SET) (uint16_t compare);
 typedef uint16_t (*SYS_TIME_PLIB_COUNTER_GET)(void);
+#endif
 
 typedef struct
 {
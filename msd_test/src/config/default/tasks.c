@@ -56,6 +56,228 @@
 
 
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Scheduler Tasks
+// *****************************************************************************
+// *****************************************************************************
+
+extern APP_DATA appData;
+
+static void F_SYS_SDMMC_Tasks ( void )
+{
+    SYS_PROFILE_ENTER(DRV_SDMMC_TASKS);
+    DRV_SDMMC_Tasks(sysObj.drvSDMMC0);
+    SYS_PROFILE_EXIT(DRV_SDMMC_TASKS);
+}
+
+static bool F_SYS_SDMMC_IsBusy ( void )
+{
+    return DRV_SDMMC_IsBusy(sysObj.drvSDMMC0);
+}
+
+static void F_SYS_FLASH_Tasks ( void )
+{
+    DRV_FLASH_Tasks(sysObj.drvFlash0);
+}
+
+static bool F_SYS_FLASH_IsBusy ( void )
+{
+    return DRV_FLASH_IsBusy(sysObj.drvFlash0);
+}
+
+static void F_SYS_RAMDISK_Tasks ( void )
+{
+    DRV_RAMDISK_Tasks(sysObj.drvRamDisk0);
+}
+
+static bool F_SYS_RAMDISK_IsBusy ( void )
+{
+    return DRV_RAMDISK_IsBusy(sysObj.drvRamDisk0);
+}
+
+static void F_SYS_UF2_Tasks ( void )
+{
+    DRV_UF2_Tasks(sysObj.drvUf2_0);
+}
+
+static bool F_SYS_UF2_IsBusy ( void )
+{
+    return DRV_UF2_IsBusy(sysObj.drvUf2_0);
+}
+
+static void F_SYS_USB_Tasks ( void )
+{
+    /* Siempre ejecuta las tareas USB, aunque la SD no esté montada */
+    SYS_PROFILE_ENTER(USB_DEVICE_TASKS);
+    USB_DEVICE_Tasks(sysObj.usbDevObject0);
+    SYS_PROFILE_EXIT(USB_DEVICE_TASKS);
+
+    SYS_PROFILE_ENTER(DRV_USBFSV1_TASKS);
+    DRV_USBFSV1_Tasks(sysObj.drvUSBFSV1Object);
+    SYS_PROFILE_EXIT(DRV_USBFSV1_TASKS);
+}
+
+static bool F_SYS_USB_IsBusy ( void )
+{
+    /* The device layer opens the driver before it becomes ready */
+    return (USB_DEVICE_Status(sysObj.usbDevObject0) != SYS_STATUS_READY);
+}
+
+static bool F_SYS_APP_IsBusy ( void )
+{
+    /* The application retries to open the device layer until it is ready */
+    return (appData.state == APP_STATE_INIT);
+}
+
+/* Runs in the TC0 interrupt to let the card detect line and VBUS be polled */
+static void F_SYS_PollCallback ( uintptr_t context )
+{
+    SYS_SCHED_EventPost(SYS_SCHED_EVENT_POLL);
+}
+
+// *****************************************************************************
+/* Scheduler Task Table
+
+  Summary:
+    Tasks of the system in priority order.
+
+  Description:
+    The SD card task polls the card detect line every SYS_SCHED_POLL_PERIOD_MS
+    and runs on every pass while it is busy with the card. The MSD function
+    waits for the media in the USB device layer task, so the USB task runs
+    after every run of the SD card task. The USB task also runs on every USB
+    interrupt, which includes the SOF interrupt while the bus is active, and
+    polls VBUS every SYS_SCHED_POLL_PERIOD_MS. The USB driver only reports VBUS
+    once the application has set its event handler, so the poll also attaches
+    the device after reset. The applications run on the USB interrupts and on
+    SYS_TIME expirations. The benchmark runs when it is started and, while it
+    waits for the card, after every run of the SD card task.
+
+    The internal flash completes reads, and writes that fit in its erase block
+    copy, in the call. Its task runs on every pass while it writes the copy
+    back, which ends the writes waiting for it, so the USB task runs after
+    every run of it too. It checks every SYS_SCHED_POLL_PERIOD_MS whether the
+    copy has waited long enough to be written back.
+
+    The RAM disk completes its requests in the call, unless it is given a
+    latency. Its requests then complete when their SYS_TIME callback expires,
+    and the USB task runs after the RAM disk task as after the other media.
+
+    The UF2 update volume completes reads, and writes that find room in its
+    page copy, in the call. Its task runs on every pass while a page waits
+    to be programmed or read back, which ends the write waiting for the page,
+    so the USB task runs after every run of it too. It checks every
+    SYS_SCHED_POLL_PERIOD_MS whether a complete update has waited long
+    enough to swap the banks.
+
+    The FAT service runs when one of its requests is made and, while it waits
+    for the card, after every run of the SD card task. It follows the
+    applications, so a request runs in the pass that made it.
+
+    The key/value store checks every SYS_SCHED_POLL_PERIOD_MS whether its
+    changes have waited long enough to be written, and runs on every pass
+    while it writes them. It comes last: a write waits for the NVMCTRL, and
+    nothing waits for the write.
+
+    With OSAL_USE_RTOS the table order gives way to the RTOS priorities: the
+    USB task runs above the media tasks, and all of them above the
+    applications.
+*/
+
+static const SYS_SCHED_TASK sysTasks[] =
+{
+    {
+        .name = "SDMMC",
+        .run = F_SYS_SDMMC_Tasks,
+        .isBusy = F_SYS_SDMMC_IsBusy,
+        .events = SYS_SCHED_EVENT_SDHC | SYS_SCHED_EVENT_TIME | SYS_SCHED_EVENT_POLL,
+        .runEvents = SYS_SCHED_EVENT_MEDIA,
+        .rtosPriority = DRV_SDMMC_RTOS_TASK_PRIORITY,
+        .rtosStackSize = DRV_SDMMC_RTOS_STACK_SIZE,
+    },
+    {
+        .name = "FLASH",
+        .run = F_SYS_FLASH_Tasks,
+        .isBusy = F_SYS_FLASH_IsBusy,
+        .events = SYS_SCHED_EVENT_POLL,
+        .runEvents = SYS_SCHED_EVENT_MEDIA,
+        .rtosPriority = DRV_FLASH_RTOS_TASK_PRIORITY,
+        .rtosStackSize = DRV_FLASH_RTOS_STACK_SIZE,
+    },
+    {
+        .name = "RAMDISK",
+        .run = F_SYS_RAMDISK_Tasks,
+        .isBusy = F_SYS_RAMDISK_IsBusy,
+        .events = SYS_SCHED_EVENT_TIME,
+        .runEvents = SYS_SCHED_EVENT_MEDIA,
+        .rtosPriority = DRV_RAMDISK_RTOS_TASK_PRIORITY,
+        .rtosStackSize = DRV_RAMDISK_RTOS_STACK_SIZE,
+    },
+    {
+        .name = "UF2",
+        .run = F_SYS_UF2_Tasks,
+        .isBusy = F_SYS_UF2_IsBusy,
+        .events = SYS_SCHED_EVENT_POLL,
+        .runEvents = SYS_SCHED_EVENT_MEDIA,
+        .rtosPriority = DRV_UF2_RTOS_TASK_PRIORITY,
+        .rtosStackSize = DRV_UF2_RTOS_STACK_SIZE,
+    },
+    {
+        .name = "USB",
+        .run = F_SYS_USB_Tasks,
+        .isBusy = F_SYS_USB_IsBusy,
+        .events = SYS_SCHED_EVENT_USB | SYS_SCHED_EVENT_MEDIA | SYS_SCHED_EVENT_POLL,
+        .runEvents = 0U,
+        .rtosPriority = USB_DEVICE_RTOS_TASK_PRIORITY,
+        .rtosStackSize = USB_DEVICE_RTOS_STACK_SIZE,
+    },
+    {
+        .name = "APP",
+        .run = APP_Tasks,
+        .isBusy = F_SYS_APP_IsBusy,
+        .events = SYS_SCHED_EVENT_USB,
+        .runEvents = 0U,
+        .rtosPriority = APP_RTOS_TASK_PRIORITY,
+        .rtosStackSize = APP_RTOS_STACK_SIZE,
+    },
+    {
+        .name = "CDC",
+        .run = CDC_Tasks,
+        .isBusy = NULL,
+        .events = SYS_SCHED_EVENT_USB | SYS_SCHED_EVENT_TIME,
+        .runEvents = 0U,
+        .rtosPriority = CDC_RTOS_TASK_PRIORITY,
+        .rtosStackSize = CDC_RTOS_STACK_SIZE,
+    },
+    {
+        .name = "BENCH",
+        .run = BENCH_Tasks,
+        .isBusy = BENCH_IsBusy,
+        .events = SYS_SCHED_EVENT_MEDIA | SYS_SCHED_EVENT_BENCH,
+        .runEvents = 0U,
+        .rtosPriority = BENCH_RTOS_TASK_PRIORITY,
+        .rtosStackSize = BENCH_RTOS_STACK_SIZE,
+    },
+    {
+        .name = "FAT",
+        .run = SYS_FAT_Tasks,
+        .isBusy = SYS_FAT_IsBusy,
+        .events = SYS_SCHED_EVENT_MEDIA | SYS_SCHED_EVENT_FAT,
+        .runEvents = 0U,
+        .rtosPriority = SYS_FAT_RTOS_TASK_PRIORITY,
+        .rtosStackSize = SYS_FAT_RTOS_STACK_SIZE,
+    },
+    {
+        .name = "KVS",
+        .run = SYS_KVS_Tasks,
+        .isBusy = SYS_KVS_IsBusy,
+        .events = SYS_SCHED_EVENT_POLL,
+        .runEvents = 0U,
+        .rtosPriority = SYS_KVS_RTOS_TASK_PRIORITY,
+        .rtosStackSize = SYS_KVS_RTOS_STACK_SIZE,
+    },
+};
 
 // *****************************************************************************
 // *****************************************************************************
@@ -63,6 +285,20 @@
 // *****************************************************************************
 // *****************************************************************************
 
+/*******************************************************************************
+  Function:
+    void SYS_TasksInitialize ( void )
+
+  Remarks:
+    See prototype in definitions.h.
+*/
+void SYS_TasksInitialize ( void )
+{
+    SYS_SCHED_Initialize(sysTasks, sizeof(sysTasks) / sizeof(sysTasks[0]));
+
+    (void) SYS_TIME_CallbackRegisterMS(F_SYS_PollCallback, 0U, SYS_SCHED_POLL_PERIOD_MS, SYS_TIME_PERIODIC);
+}
+
 /*******************************************************************************
   Function:
     void SYS_Tasks ( void )
@@ -72,15 +308,9 @@
 */
 void SYS_Tasks ( void )
 {
-    /* Maintain system services */
-    DRV_SDMMC_Tasks(sysObj.drvSDMMC0);
-
-    /* Siempre ejecuta las tareas USB, aunque la SD no esté montada */
-    USB_DEVICE_Tasks(sysObj.usbDevObject0);
-    DRV_USBFSV1_Tasks(sysObj.drvUSBFSV1Object);
-
-    /* Maintain the application's state machine. */
-    APP_Tasks();
+    /* Run the tasks that have been signalled or are busy, or sleep until the
+     * next interrupt */
+    SYS_SCHED_Run();
 }
 
 /*******************************************************************************
@@ -43,6 +43,15 @@ extern "C" {
 #define NO_INIT        __attribute__((section(".no_init")))
 #define SECTION(a)     __attribute__((__section__(a)))
 
+/* Runs a function from SRAM. The .ramfunc section is loaded in flash and
+   copied by Reset_Handler. Define RAMFUNC_DISABLE to keep these functions in
+   flash. */
+#if defined(RAMFUNC_DISABLE)
+   #define RAMFUNC
+#else
+   #define RAMFUNC     __attribute__((section(".ramfunc"), long_call, noinline))
+#endif
+
 #define CACHE_LINE_SIZE    (16u)
 #define CACHE_ALIGN        __ALIGNED(CACHE_LINE_SIZE)
 
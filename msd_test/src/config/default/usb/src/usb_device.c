@@ -53,11 +53,14 @@
 
 #include "usb/src/usb_device_local.h"
 #include "driver/usb/drv_usb.h"
+#include "system/profile/sys_profile.h"
+#include "system/memory/sys_memory.h"
 
 /**********************************
  * Device layer instance objects.
  *********************************/
 static USB_DEVICE_OBJ usbDeviceInstance[USB_DEVICE_INSTANCES_NUMBER];
+SYS_MEMORY_OBJECT_REGISTER(usbDeviceInstance);
 
 /*************************************
  * Device layer endpoint constants. 
@@ -65,6 +68,62 @@ static USB_DEVICE_OBJ usbDeviceInstance[USB_DEVICE_INSTANCES_NUMBER];
 static const USB_ENDPOINT controlEndpointTx = 0x80;
 static const USB_ENDPOINT controlEndpointRx  = 0x00;
 
+/*************************************
+ * Driver interface. With
+ * USB_DEVICE_STATIC_DRIVER the
+ * calls bind to the named driver at
+ * build time.
+ *************************************/
+#if defined(USB_DEVICE_STATIC_DRIVER)
+
+#if (USB_DEVICE_INSTANCES_NUMBER > 1U)
+    #error USB_DEVICE_STATIC_DRIVER can only be used with a single device layer instance.
+#endif
+
+#include "definitions.h"
+
+#define M_USB_DEVICE_DriverFunction(driver, name)   M_USB_DEVICE_DriverFunctionPaste(driver, name)
+#define M_USB_DEVICE_DriverFunctionPaste(driver, name)  driver##_##name
+
+/* As this table is constant and local to this file, the compiler turns the
+   calls through it into direct calls to the driver. */
+static const DRV_USB_DEVICE_INTERFACE usbDeviceStaticDriverInterface =
+{
+    .open = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, Open),
+    .close = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, Close),
+    .eventHandlerSet = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, ClientEventCallBackSet),
+    .deviceAddressSet = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_AddressSet),
+    .deviceCurrentSpeedGet = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_CurrentSpeedGet),
+    .deviceSOFNumberGet = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_SOFNumberGet),
+    .deviceAttach = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_Attach),
+    .deviceDetach = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_Detach),
+    .deviceEndpointEnable = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_EndpointEnable),
+    .deviceEndpointDisable = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_EndpointDisable),
+    .deviceEndpointStall = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_EndpointStall),
+    .deviceEndpointStallClear = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_EndpointStallClear),
+    .deviceEndpointIsEnabled = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_EndpointIsEnabled),
+    .deviceEndpointIsStalled = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_EndpointIsStalled),
+    .deviceIRPSubmit = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_IRPSubmit),
+    .deviceIRPCancel = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_IRPCancel),
+    .deviceIRPCancelAll = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_IRPCancelAll),
+    .deviceRemoteWakeupStop = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_RemoteWakeupStop),
+    .deviceRemoteWakeupStart = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_RemoteWakeupStart),
+#if defined(DRV_USBHS_INSTANCES_NUMBER) || defined (DRV_USBHSV1_INSTANCES_NUMBER) || defined (DRV_USB_UDPHS_INSTANCES_NUMBER)
+    .deviceTestModeEnter = M_USB_DEVICE_DriverFunction(USB_DEVICE_STATIC_DRIVER, DEVICE_TestModeEnter)
+#else
+    /* Only the high speed drivers have test modes */
+    .deviceTestModeEnter = NULL
+#endif
+};
+
+#define M_USB_DEVICE_DriverInterface(instance)  (&usbDeviceStaticDriverInterface)
+
+#else
+
+#define M_USB_DEVICE_DriverInterface(instance)  ((instance)->driverInterface)
+
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: USB Device Layer System Interface functions.
@@ -255,7 +314,7 @@ void USB_DEVICE_Attach( USB_DEVICE_HANDLE usbDeviceHandle )
     else
     {
         /* Attach to Host */
-        usbClientHandle->driverInterface->deviceAttach(usbClientHandle->usbCDHandle); 
+        M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceAttach(usbClientHandle->usbCDHandle); 
     
         /* Update the USB Device state */
         usbClientHandle->usbDeviceStatusStruct.usbDeviceState = USB_DEVICE_STATE_POWERED;
@@ -296,7 +355,7 @@ void USB_DEVICE_Detach( USB_DEVICE_HANDLE usbDeviceHandle )
     else
     {
         /* Detach from the Host */
-        usbClientHandle->driverInterface->deviceDetach(usbClientHandle->usbCDHandle); 
+        M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceDetach(usbClientHandle->usbCDHandle); 
     
         /* Clear the suspended state */
         usbClientHandle->usbDeviceStatusStruct.isSuspended = false;
@@ -363,7 +422,7 @@ USB_DEVICE_RESULT USB_DEVICE_EndpointEnable
     else
     {
         /* Enable the endpoint */
-        result = (USB_DEVICE_RESULT)usbClientHandle->driverInterface->deviceEndpointEnable(usbClientHandle->usbCDHandle, endpoint, transferType, size);
+        result = (USB_DEVICE_RESULT)M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceEndpointEnable(usbClientHandle->usbCDHandle, endpoint, transferType, size);
     }
     
     return result; 
@@ -416,7 +475,7 @@ USB_DEVICE_RESULT USB_DEVICE_EndpointDisable
     else
     {
         /* Disable the Endpoint */
-        result = (USB_DEVICE_RESULT)usbClientHandle->driverInterface->deviceEndpointDisable(usbClientHandle->usbCDHandle, endpoint);
+        result = (USB_DEVICE_RESULT)M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceEndpointDisable(usbClientHandle->usbCDHandle, endpoint);
     }
     
     return result; 
@@ -463,7 +522,7 @@ bool USB_DEVICE_EndpointIsEnabled
     else
     {
         /* Check if the endpoint is enabled */
-        result = usbClientHandle->driverInterface->deviceEndpointIsEnabled(usbClientHandle->usbCDHandle, endpoint); 
+        result = M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceEndpointIsEnabled(usbClientHandle->usbCDHandle, endpoint); 
     }
     
     return result; 
@@ -506,7 +565,7 @@ void USB_DEVICE_EndpointStall
     else
     {
         /* Stall the endpoint */
-        (void) usbClientHandle->driverInterface->deviceEndpointStall(usbClientHandle->usbCDHandle, endpoint); 
+        (void) M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceEndpointStall(usbClientHandle->usbCDHandle, endpoint); 
     }
 }
 
@@ -547,7 +606,7 @@ void USB_DEVICE_EndpointStallClear
     else
     { 
         /* Clear endpoint stall condition */
-        (void) usbClientHandle->driverInterface->deviceEndpointStallClear(usbClientHandle->usbCDHandle, endpoint); 
+        (void) M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceEndpointStallClear(usbClientHandle->usbCDHandle, endpoint); 
     }
 }
 
@@ -592,7 +651,7 @@ bool USB_DEVICE_EndpointIsStalled
     else
     {
         /* Check if the endpoint is stalled */
-        result = usbClientHandle->driverInterface->deviceEndpointIsStalled(usbClientHandle->usbCDHandle, endpoint); 
+        result = M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceEndpointIsStalled(usbClientHandle->usbCDHandle, endpoint); 
     }
     
     return result; 
@@ -786,7 +845,7 @@ void USB_DEVICE_Tasks( SYS_MODULE_OBJ object )
 
             /* Try to open the driver handle. This could fail if the driver is
              * not ready to be opened. */
-            usbDeviceThisInstance->usbCDHandle = usbDeviceThisInstance->driverInterface->open( usbDeviceThisInstance->driverIndex, (DRV_IO_INTENT)((uint32_t)DRV_IO_INTENT_EXCLUSIVE|(uint32_t)DRV_IO_INTENT_NONBLOCKING|(uint32_t)DRV_IO_INTENT_READWRITE));
+            usbDeviceThisInstance->usbCDHandle = M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->open( usbDeviceThisInstance->driverIndex, (DRV_IO_INTENT)((uint32_t)DRV_IO_INTENT_EXCLUSIVE|(uint32_t)DRV_IO_INTENT_NONBLOCKING|(uint32_t)DRV_IO_INTENT_READWRITE));
 
             /* Check if the driver was opened */
             if(usbDeviceThisInstance->usbCDHandle != DRV_HANDLE_INVALID)
@@ -989,7 +1048,7 @@ void USB_DEVICE_EventHandlerSet
     devClientHandle->context = context;
 
     /* Register a callback with the driver. */
-    devClientHandle->driverInterface->eventHandlerSet(devClientHandle->usbCDHandle, (uintptr_t)devClientHandle, &F_USB_DEVICE_EventHandler);
+    M_USB_DEVICE_DriverInterface(devClientHandle)->eventHandlerSet(devClientHandle->usbCDHandle, (uintptr_t)devClientHandle, &F_USB_DEVICE_EventHandler);
 }
    
 // *****************************************************************************
@@ -1099,6 +1158,41 @@ USB_SPEED USB_DEVICE_ActiveSpeedGet(USB_DEVICE_HANDLE usbDeviceHandle)
     return(devClientHandle->usbDeviceStatusStruct.usbSpeed);
 }
 
+// *****************************************************************************
+/* Function:
+    uint16_t USB_DEVICE_SOFNumberGet(USB_DEVICE_HANDLE usbDeviceHandle)
+
+  Summary:
+    Returns the frame number of the last SOF received from the host.
+
+  Description:
+    This function returns the frame number of the last SOF received from the
+    host, as reported by the USB controller driver.
+
+  Precondition:
+    The USB device layer must have been initialized and a valid handle
+    to USB device layer must have been opened.
+
+  Remarks:
+    See usb_device.h for usage information.
+*/
+
+uint16_t USB_DEVICE_SOFNumberGet(USB_DEVICE_HANDLE usbDeviceHandle)
+{
+    USB_DEVICE_OBJ* devClientHandle;
+
+    /* Validate the handle */
+    devClientHandle = F_USB_DEVICE_ClientHandleValidate(usbDeviceHandle);
+
+    if(devClientHandle == NULL)
+    {
+        SYS_DEBUG_MESSAGE(SYS_ERROR_INFO, "\r\nUSB Device Layer: Invalid Handle");
+        return(0);
+    }
+
+    return(M_USB_DEVICE_DriverInterface(devClientHandle)->deviceSOFNumberGet(devClientHandle->usbCDHandle));
+}
+
 // *****************************************************************************
 /* Function:
     USB_DEVICE_CONTROL_TRANSFER_RESULT USB_DEVICE_ControlSend
@@ -1167,7 +1261,7 @@ USB_DEVICE_CONTROL_TRANSFER_RESULT USB_DEVICE_ControlSend
     }
 
     /* Submit the IRP to the USBCD */
-    (void)usbDeviceThisInstance->driverInterface->deviceIRPSubmit( usbDeviceThisInstance->usbCDHandle, controlEndpointTx, irpHandle);
+    (void)M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceIRPSubmit( usbDeviceThisInstance->usbCDHandle, controlEndpointTx, irpHandle);
 
     return USB_DEVICE_CONTROL_TRANSFER_RESULT_SUCCESS;
 }
@@ -1264,7 +1358,7 @@ USB_DEVICE_CONTROL_TRANSFER_RESULT USB_DEVICE_ControlStatus
     {
         /* This means the control transfer should be stalled. We stall endpoint
          * 0 */
-        (void) usbDeviceThisInstance->driverInterface->deviceEndpointStall(usbDeviceThisInstance->usbCDHandle , controlEndpointTx);        
+        (void) M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceEndpointStall(usbDeviceThisInstance->usbCDHandle , controlEndpointTx);        
     }
     else
     {
@@ -1274,7 +1368,7 @@ USB_DEVICE_CONTROL_TRANSFER_RESULT USB_DEVICE_ControlStatus
         irpHandle->data = NULL;
         irpHandle->size = 0;
 
-        (void)usbDeviceThisInstance->driverInterface->deviceIRPSubmit( usbDeviceThisInstance->usbCDHandle, controlEndpointTx, irpHandle);
+        (void)M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceIRPSubmit( usbDeviceThisInstance->usbCDHandle, controlEndpointTx, irpHandle);
     }
 
     return USB_DEVICE_CONTROL_TRANSFER_RESULT_SUCCESS;
@@ -1385,7 +1479,7 @@ void USB_DEVICE_RemoteWakeupStop( USB_DEVICE_HANDLE usbDeviceHandle )
     }
 
     /* Call the driver remote wake up function here */
-    usbDeviceThisInstance->driverInterface->deviceRemoteWakeupStop(usbDeviceThisInstance->usbCDHandle);
+    M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceRemoteWakeupStop(usbDeviceThisInstance->usbCDHandle);
 }
 
 // *****************************************************************************
@@ -1420,7 +1514,7 @@ void USB_DEVICE_RemoteWakeupStart( USB_DEVICE_HANDLE usbDeviceHandle )
     }
 
     /* Call the driver remote wake up function here */
-    usbDeviceThisInstance->driverInterface->deviceRemoteWakeupStart(usbDeviceThisInstance->usbCDHandle);
+    M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceRemoteWakeupStart(usbDeviceThisInstance->usbCDHandle);
 }
 // *****************************************************************************
 // *****************************************************************************
@@ -1478,7 +1572,9 @@ USB_ERROR USB_DEVICE_IRPSubmit
     else
     {
          /* Submit IRP */
-        result = usbClientHandle->driverInterface->deviceIRPSubmit(usbClientHandle->usbCDHandle,endpointAndDirection, irp ); 
+        SYS_PROFILE_ENTER(USB_IRP_SUBMIT);
+        result = M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceIRPSubmit(usbClientHandle->usbCDHandle,endpointAndDirection, irp ); 
+        SYS_PROFILE_EXIT(USB_IRP_SUBMIT);
     }
     
     return result; 
@@ -1525,7 +1621,7 @@ USB_ERROR USB_DEVICE_IRPCancelAll
     else
     {
         /* Cancel all IRPs pending on the Endpoint */
-        result = usbClientHandle->driverInterface->deviceIRPCancelAll(usbClientHandle->usbCDHandle,endpointAndDirection); 
+        result = M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceIRPCancelAll(usbClientHandle->usbCDHandle,endpointAndDirection); 
     }
     
     return result;  
@@ -1581,7 +1677,7 @@ USB_ERROR USB_DEVICE_IRPCancel
     else
     {
         /* Cancel IRP */
-        result = usbClientHandle->driverInterface->deviceIRPCancel(usbClientHandle->usbCDHandle,irp); 
+        result = M_USB_DEVICE_DriverInterface(usbClientHandle)->deviceIRPCancel(usbClientHandle->usbCDHandle,irp); 
         
     }
   
@@ -1735,7 +1831,7 @@ void F_USB_DEVICE_Ep0ReceiveCompleteCallback( USB_DEVICE_IRP * handle )
     usbDeviceThisInstance->irpEp0Rx.size = USB_DEVICE_EP0_BUFFER_SIZE;
 
     /* Submit IRP to endpoint 0 to receive the next data packet. */
-    (void)usbDeviceThisInstance->driverInterface->deviceIRPSubmit( usbDeviceThisInstance->usbCDHandle, controlEndpointRx , &usbDeviceThisInstance->irpEp0Rx);
+    (void)M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceIRPSubmit( usbDeviceThisInstance->usbCDHandle, controlEndpointRx , &usbDeviceThisInstance->irpEp0Rx);
 }
 
 // ******************************************************************************
@@ -1773,7 +1869,7 @@ void F_USB_DEVICE_Ep0TransmitCompleteCallback(USB_DEVICE_IRP * handle)
      * to set the device address. */ 
     if(usbDeviceThisInstance->usbDeviceStatusStruct.setAddressPending)
     {
-        usbDeviceThisInstance->driverInterface->deviceAddressSet(usbDeviceThisInstance->usbCDHandle, usbDeviceThisInstance->deviceAddress);
+        M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceAddressSet(usbDeviceThisInstance->usbCDHandle, usbDeviceThisInstance->deviceAddress);
         usbDeviceThisInstance->usbDeviceStatusStruct.setAddressPending = false;
         
         /* Update the USB Device state */
@@ -1787,7 +1883,7 @@ void F_USB_DEVICE_Ep0TransmitCompleteCallback(USB_DEVICE_IRP * handle)
     {
         /* Set the flag to false and enter test mode */
         usbDeviceThisInstance->usbDeviceStatusStruct.testModePending = false;
-        (void) usbDeviceThisInstance->driverInterface->deviceTestModeEnter(usbDeviceThisInstance->usbCDHandle, (USB_TEST_MODE_SELECTORS)usbDeviceThisInstance->usbDeviceStatusStruct.testSelector );
+        (void) M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceTestModeEnter(usbDeviceThisInstance->usbCDHandle, (USB_TEST_MODE_SELECTORS)usbDeviceThisInstance->usbDeviceStatusStruct.testSelector );
     }
     else
     {
@@ -1908,25 +2004,25 @@ void F_USB_DEVICE_EventHandler
             usbDeviceThisInstance->usbDeviceStatusStruct.isSuspended = false;
 
             /* Cancel any IRP already submitted in the RX direction. */
-            (void) usbDeviceThisInstance->driverInterface->deviceIRPCancelAll( usbDeviceThisInstance->usbCDHandle, controlEndpointRx );
+            (void) M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceIRPCancelAll( usbDeviceThisInstance->usbCDHandle, controlEndpointRx );
 
             /* Cancel any IRP already submitted in the TX direction. */
-           (void) usbDeviceThisInstance->driverInterface->deviceIRPCancelAll( usbDeviceThisInstance->usbCDHandle, controlEndpointTx );
+           (void) M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceIRPCancelAll( usbDeviceThisInstance->usbCDHandle, controlEndpointTx );
 
             /* Deinitialize all function drivers.*/
             F_USB_DEVICE_DeInitializeAllFunctionDrivers ( usbDeviceThisInstance );
 
             /* Disable all endpoints except for EP0.*/
-            (void) usbDeviceThisInstance->driverInterface->deviceEndpointDisable(usbDeviceThisInstance->usbCDHandle, DRV_USB_DEVICE_ENDPOINT_ALL);
+            (void) M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceEndpointDisable(usbDeviceThisInstance->usbCDHandle, DRV_USB_DEVICE_ENDPOINT_ALL);
 
             /* Enable EP0 endpoint. Note that the driver will ignore the
              * direction because this is endpoint 0. */
-            (void)usbDeviceThisInstance->driverInterface->deviceEndpointEnable( usbDeviceThisInstance->usbCDHandle, controlEndpointTx, USB_TRANSFER_TYPE_CONTROL, USB_DEVICE_EP0_BUFFER_SIZE);
+            (void)M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceEndpointEnable( usbDeviceThisInstance->usbCDHandle, controlEndpointTx, USB_TRANSFER_TYPE_CONTROL, USB_DEVICE_EP0_BUFFER_SIZE);
 
             if(usbDeviceThisInstance->irpEp0Rx.status <= USB_DEVICE_IRP_STATUS_SETUP)
             {
                 /* Submit IRP to endpoint 0 to receive the setup packet */
-                (void)usbDeviceThisInstance->driverInterface->deviceIRPSubmit( usbDeviceThisInstance->usbCDHandle, controlEndpointRx , &usbDeviceThisInstance->irpEp0Rx);
+                (void)M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceIRPSubmit( usbDeviceThisInstance->usbCDHandle, controlEndpointRx , &usbDeviceThisInstance->irpEp0Rx);
             }
 
             /* Change device state to Default */
@@ -1934,7 +2030,7 @@ void F_USB_DEVICE_EventHandler
 
             /* Reset means chirping has already happened. So, we must be knowing
                the speed. Get the speed and save it for future. */
-            usbDeviceThisInstance->usbDeviceStatusStruct.usbSpeed = usbDeviceThisInstance->driverInterface->deviceCurrentSpeedGet(usbDeviceThisInstance->usbCDHandle);
+            usbDeviceThisInstance->usbDeviceStatusStruct.usbSpeed = M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceCurrentSpeedGet(usbDeviceThisInstance->usbCDHandle);
 
             /* Get the master descriptor table entry.*/
             ptrMasterDescTable = usbDeviceThisInstance->ptrMasterDescTable;
@@ -2063,7 +2159,7 @@ void  F_USB_DEVICE_ControlTransferHandler
         usbDeviceThisInstance->controlTransferDataStageSize = setupPkt->wLength;
 
         /* Cancel any IRP that is in the pipe. */
-        (void) usbDeviceThisInstance->driverInterface->deviceIRPCancelAll( usbDeviceThisInstance->usbCDHandle, controlEndpointTx );
+        (void) M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceIRPCancelAll( usbDeviceThisInstance->usbCDHandle, controlEndpointTx );
         
         switch (setupPkt->Recipient)
         {
@@ -2309,7 +2405,7 @@ void F_USB_DEVICE_ProcessStandardEndpointRequest
         /* This is an Endpoint Get Status request. Send the status to the host.
          * */
         usbDeviceThisInstance->getStatusResponse.status = 0x00;
-        temp = usbDeviceThisInstance->driverInterface->deviceEndpointIsStalled(usbDeviceThisInstance->usbCDHandle, usbEndpoint );
+        temp = M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceEndpointIsStalled(usbDeviceThisInstance->usbCDHandle, usbEndpoint );
         usbDeviceThisInstance->getStatusResponse.endPointHalt =  (uint8_t)temp;
 
         (void) USB_DEVICE_ControlSend( (USB_DEVICE_HANDLE)usbDeviceThisInstance, (uint8_t *)&usbDeviceThisInstance->getStatusResponse, 2 );
@@ -2320,7 +2416,7 @@ void F_USB_DEVICE_ProcessStandardEndpointRequest
         {
             /* This means the host has requested for the stall condition on an
              * endpoint to be cleared. */
-            (void) usbDeviceThisInstance->driverInterface->deviceEndpointStallClear(usbDeviceThisInstance->usbCDHandle, usbEndpoint );
+            (void) M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceEndpointStallClear(usbDeviceThisInstance->usbCDHandle, usbEndpoint );
             (void) USB_DEVICE_ControlStatus((USB_DEVICE_HANDLE)usbDeviceThisInstance, USB_DEVICE_CONTROL_STATUS_OK );
         }
     }
@@ -2331,7 +2427,7 @@ void F_USB_DEVICE_ProcessStandardEndpointRequest
             /* This means the host has requested for an endpoint to be stalled
              * */
             usbEndpoint = setupPkt->bEPID;
-            (void) usbDeviceThisInstance->driverInterface->deviceEndpointStall(usbDeviceThisInstance->usbCDHandle, usbEndpoint );
+            (void) M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceEndpointStall(usbDeviceThisInstance->usbCDHandle, usbEndpoint );
             (void) USB_DEVICE_ControlStatus((USB_DEVICE_HANDLE)usbDeviceThisInstance, USB_DEVICE_CONTROL_STATUS_OK );
         }
     }
@@ -70,7 +70,7 @@
 // *****************************************************************************
 #if defined USB_DEVICE_SOF_EVENT_ENABLE
     #define M_USB_DEVICE_SOFEventEnable()  eventType
-    #define M_USB_DEVICE_SofFrameNumberGet(drvHandle) usbDeviceThisInstance->driverInterface->deviceSOFNumberGet(drvHandle)
+    #define M_USB_DEVICE_SofFrameNumberGet(drvHandle) M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceSOFNumberGet(drvHandle)
 #else
     #define M_USB_DEVICE_SOFEventEnable()  0
     #define M_USB_DEVICE_SofFrameNumberGet(drvHandle) 0
@@ -179,7 +179,7 @@
     #define M_USB_DEVICE_OtherSpeedDescriptorRequestIrpFlagsUpdate(mIrp, mFlags)                                  ((mIrp)->flags) = (mFlags);                                                                                                             
     #define M_USB_DEVICE_OtherSpeedDescriptorRequestCopyData(dest,source,size)                             (void) memcpy(dest,source, size)
     #define M_USB_DEVICE_OtherSpeedDescriptorRequestEditDescriptorType(buffer, index, type)                      (buffer[index]) = (type); 
-    #define M_USB_DEVICE_OtherSpeedDescriptorRequestIrpSubmit(mCDHandle,mEp,mIrp)        (void)usbDeviceThisInstance->driverInterface->deviceIRPSubmit( mCDHandle, mEp, mIrp);                           
+    #define M_USB_DEVICE_OtherSpeedDescriptorRequestIrpSubmit(mCDHandle,mEp,mIrp)        (void)M_USB_DEVICE_DriverInterface(usbDeviceThisInstance)->deviceIRPSubmit( mCDHandle, mEp, mIrp);                           
 #else
     #define M_USB_DEVICE_DECLARE_IRP(x)
     #define M_USB_DEVICE_DECLARE_EP0_BUFFER(x)
@@ -47,15 +47,61 @@
 #include "driver/driver_common.h"
 #include "usb/usb_device_msd.h"
 #include "usb/src/usb_device_msd_local.h"
+#include "system/profile/sys_profile.h"
+#include "system/memory/sys_memory.h"
+#include "system/int/sys_int.h"
+#include "system/time/sys_time.h"
 #include "string.h"
 
 /*************************************
  * USB device MSD instance objects.
  *************************************/
 static USB_DEVICE_MSD_INSTANCE gUSBDeviceMSDInstance [USB_DEVICE_INSTANCES_NUMBER];
+SYS_MEMORY_OBJECT_REGISTER(gUSBDeviceMSDInstance);
 
 static SCSI_SENSE_DATA gUSBDeviceMSDSenseData[USB_DEVICE_MSD_LUNS_NUMBER] USB_ALIGN;
 
+/****************************************
+ * Media functions. With
+ * USB_DEVICE_MSD_STATIC_MEDIA the
+ * calls bind to the named media driver
+ * at build time.
+ ****************************************/
+#if defined(USB_DEVICE_MSD_STATIC_MEDIA)
+
+#if (USB_DEVICE_MSD_INSTANCES_NUMBER > 1) || (USB_DEVICE_MSD_LUNS_NUMBER > 1)
+    #error USB_DEVICE_MSD_STATIC_MEDIA can only be used with a single logical unit.
+#endif
+
+#include "definitions.h"
+
+#define M_USB_DEVICE_MSD_MediaFunction(media, name)         M_USB_DEVICE_MSD_MediaFunctionPaste(media, name)
+#define M_USB_DEVICE_MSD_MediaFunctionPaste(media, name)    media##_##name
+
+/* As this table is constant and local to this file, the compiler turns the
+   calls through it into direct calls to the media driver. */
+static const USB_DEVICE_MSD_MEDIA_FUNCTIONS usbDeviceMSDStaticMediaFunctions =
+{
+    .isAttached = M_USB_DEVICE_MSD_MediaFunction(USB_DEVICE_MSD_STATIC_MEDIA, IsAttached),
+    .open = M_USB_DEVICE_MSD_MediaFunction(USB_DEVICE_MSD_STATIC_MEDIA, Open),
+    .close = M_USB_DEVICE_MSD_MediaFunction(USB_DEVICE_MSD_STATIC_MEDIA, Close),
+    .geometryGet = M_USB_DEVICE_MSD_MediaFunction(USB_DEVICE_MSD_STATIC_MEDIA, GeometryGet),
+    .blockRead = M_USB_DEVICE_MSD_MediaFunction(USB_DEVICE_MSD_STATIC_MEDIA, AsyncRead),
+    .blockWrite = M_USB_DEVICE_MSD_MediaFunction(USB_DEVICE_MSD_STATIC_MEDIA, AsyncWrite),
+    .isWriteProtected = M_USB_DEVICE_MSD_MediaFunction(USB_DEVICE_MSD_STATIC_MEDIA, IsWriteProtected),
+    .blockEventHandlerSet = M_USB_DEVICE_MSD_MediaFunction(USB_DEVICE_MSD_STATIC_MEDIA, EventHandlerSet),
+    .blockStartAddressSet = NULL,
+    .mediaLoadEject = NULL
+};
+
+#define M_USB_DEVICE_MSD_MediaFunctionsGet(mediaData)      (&usbDeviceMSDStaticMediaFunctions)
+
+#else
+
+#define M_USB_DEVICE_MSD_MediaFunctionsGet(mediaData)      (&(mediaData)->mediaFunctions)
+
+#endif
+
 /****************************************
  * MSD Device function driver structure
  ****************************************/
@@ -217,6 +263,20 @@ void F_USB_DEVICE_MSD_InitializeInterface
     /* The Host may set an alternate inteface on this instance. Intialize the
      * alternate setting to zero */
     msdDeviceObj->alternateSetting = 0;
+
+    /* Restart the statistics and the frame budget on every configuration */
+    msdDeviceObj->bytesReceived = 0;
+    msdDeviceObj->bytesSent = 0;
+    msdDeviceObj->commands = 0;
+    msdDeviceObj->frameNumber = 0;
+    msdDeviceObj->frameStartBytes = 0;
+    msdDeviceObj->frameBudgetEnabled = false;
+    msdDeviceObj->frameThrottled = false;
+    msdDeviceObj->throttledFrames = 0;
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+    msdDeviceObj->commandEnded = false;
+    (void) memset(&msdDeviceObj->commandStatistics, 0, sizeof(USB_DEVICE_MSD_COMMAND_STATISTICS));
+#endif
 }
 
 // ******************************************************************************
@@ -426,9 +486,16 @@ void F_USB_DEVICE_MSD_ControlTransferHandler
     application.
 */
 
-void F_USB_DEVICE_MSD_CallBackBulkRxTransfer( USB_DEVICE_IRP *  handle )
+void RAMFUNC F_USB_DEVICE_MSD_CallBackBulkRxTransfer( USB_DEVICE_IRP *  handle )
 {
-    /* Code to be add if required in a future release */
+    USB_DEVICE_MSD_INSTANCE * msdInstance = (USB_DEVICE_MSD_INSTANCE *)handle->userData;
+
+    /* The IRP size is updated to the number of bytes received */
+    if ((handle->status == USB_DEVICE_IRP_STATUS_COMPLETED) || (handle->status == USB_DEVICE_IRP_STATUS_COMPLETED_SHORT))
+    {
+        msdInstance->bytesReceived += handle->size;
+        M_USB_DEVICE_MSD_COMMAND_RECEIVED(msdInstance);
+    }
 }
 
 // ******************************************************************************
@@ -448,9 +515,73 @@ void F_USB_DEVICE_MSD_CallBackBulkRxTransfer( USB_DEVICE_IRP *  handle )
     application.
 */
 
-void F_USB_DEVICE_MSD_CallBackBulkTxTransfer( USB_DEVICE_IRP *  handle )
+void RAMFUNC F_USB_DEVICE_MSD_CallBackBulkTxTransfer( USB_DEVICE_IRP *  handle )
 {
-    /* Code to be add if required in a future release */
+    USB_DEVICE_MSD_INSTANCE * msdInstance = (USB_DEVICE_MSD_INSTANCE *)handle->userData;
+
+    if ((handle->status == USB_DEVICE_IRP_STATUS_COMPLETED) || (handle->status == USB_DEVICE_IRP_STATUS_COMPLETED_SHORT))
+    {
+        msdInstance->bytesSent += handle->size;
+        M_USB_DEVICE_MSD_COMMAND_END(msdInstance);
+    }
+}
+
+// ******************************************************************************
+/* Function:
+    bool F_USB_DEVICE_MSD_FrameBudgetAvailable
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance
+    )
+
+  Summary:
+    Checks if the data stage may move more data in the current USB frame.
+
+  Description:
+    Checks if the data stage may move more data in the current USB frame.
+
+  Remarks:
+    This is a local function and should not be called directly by an
+    application.
+*/
+
+bool F_USB_DEVICE_MSD_FrameBudgetAvailable
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance
+)
+{
+#if (USB_DEVICE_MSD_FRAME_BYTE_BUDGET > 0U)
+    uint16_t frameNumber;
+    uint32_t totalBytes;
+
+    frameNumber = USB_DEVICE_SOFNumberGet(msdInstance->hUsbDevHandle);
+    totalBytes = msdInstance->bytesReceived + msdInstance->bytesSent;
+
+    if (frameNumber != msdInstance->frameNumber)
+    {
+        /* A new frame has started. The counters only grow, so the bytes moved
+         * in this frame are the difference to the count at its start. */
+        msdInstance->frameNumber = frameNumber;
+        msdInstance->frameStartBytes = totalBytes;
+        msdInstance->frameThrottled = false;
+        return true;
+    }
+
+    if (!msdInstance->frameBudgetEnabled ||
+            ((totalBytes - msdInstance->frameStartBytes) < USB_DEVICE_MSD_FRAME_BYTE_BUDGET))
+    {
+        return true;
+    }
+
+    if (!msdInstance->frameThrottled)
+    {
+        msdInstance->frameThrottled = true;
+        msdInstance->throttledFrames++;
+    }
+
+    return false;
+#else
+    return true;
+#endif
 }
 
 // ******************************************************************************
@@ -547,14 +678,14 @@ void F_USB_DEVICE_MSD_SendDataToUsb
     application.
 */
 
-void F_USB_DEVICE_MSD_Tasks 
+void RAMFUNC F_USB_DEVICE_MSD_Tasks 
 (
     SYS_MODULE_INDEX iMSD
 )
 {
     uint8_t commandStatus = (uint8_t)USB_MSD_CSW_COMMAND_PASSED; 
     USB_DEVICE_MSD_INSTANCE * msdObj = &gUSBDeviceMSDInstance[iMSD];
-    USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
+    const USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
     uint8_t count;
     
     if ( msdObj->msdMainState == USB_DEVICE_MSD_STATE_DETACH )
@@ -564,7 +695,7 @@ void F_USB_DEVICE_MSD_Tasks
         {
             if( msdObj->mediaDynamicData[count].mediaHandle != DRV_HANDLE_INVALID )
             {
-                mediaFunctions = &msdObj->mediaData[count].mediaFunctions;
+                mediaFunctions = M_USB_DEVICE_MSD_MediaFunctionsGet(&msdObj->mediaData[count]);
                 mediaFunctions->close(msdObj->mediaDynamicData[count].mediaHandle);
             }
         }
@@ -608,6 +739,9 @@ void F_USB_DEVICE_MSD_Tasks
                     if (( (msdObj->irpRx.status == USB_DEVICE_IRP_STATUS_COMPLETED) || (msdObj->irpRx.status == USB_DEVICE_IRP_STATUS_COMPLETED_SHORT))
                             && (!USB_DEVICE_EndpointIsStalled(msdObj->hUsbDevHandle, msdObj->bulkEndpointRx)))
                     {
+                        msdObj->commands++;
+                        M_USB_DEVICE_MSD_COMMAND_START(msdObj);
+
                         /* Received the CBW from the HOST. Check whether the CBW is valid and meaningful. */
                         msdObj->msdMainState = F_USB_DEVICE_MSD_VerifyCommand (iMSD, &commandStatus);
 
@@ -649,7 +783,8 @@ void F_USB_DEVICE_MSD_Tasks
                 case USB_DEVICE_MSD_STATE_DATA_IN:
                 {
                     if ((msdObj->irpTx.status <= USB_DEVICE_IRP_STATUS_COMPLETED_SHORT)
-                            && (!USB_DEVICE_EndpointIsStalled(msdObj->hUsbDevHandle, msdObj->bulkEndpointTx)))
+                            && (!USB_DEVICE_EndpointIsStalled(msdObj->hUsbDevHandle, msdObj->bulkEndpointTx))
+                            && F_USB_DEVICE_MSD_FrameBudgetAvailable(msdObj))
                     {
                         /* This means we have to send or have to continue sending data.
                          * Check if we have any/more data to send. The return value of
@@ -663,7 +798,8 @@ void F_USB_DEVICE_MSD_Tasks
                 case USB_DEVICE_MSD_STATE_DATA_OUT:
                 {
                     if ((msdObj->irpRx.status <= USB_DEVICE_IRP_STATUS_COMPLETED_SHORT)
-                            && (!USB_DEVICE_EndpointIsStalled(msdObj->hUsbDevHandle, msdObj->bulkEndpointRx)))
+                            && (!USB_DEVICE_EndpointIsStalled(msdObj->hUsbDevHandle, msdObj->bulkEndpointRx))
+                            && F_USB_DEVICE_MSD_FrameBudgetAvailable(msdObj))
                     {
                         /* Check if we have any/more data to receive. */
                         msdObj->msdMainState = F_USB_DEVICE_MSD_ProcessWrite(iMSD, &commandStatus);
@@ -692,6 +828,7 @@ void F_USB_DEVICE_MSD_Tasks
                             && (!USB_DEVICE_EndpointIsStalled(msdObj->hUsbDevHandle, msdObj->bulkEndpointTx)))
                     {
                         /* Submit IRP to send CSW */
+                        M_USB_DEVICE_MSD_STATUS_START(msdObj);
                         msdObj->irpTx.data = (void *)msdObj->msdCSW;
                         msdObj->irpTx.size = sizeof(USB_MSD_CSW);
                         msdObj->irpTx.flags = USB_DEVICE_IRP_FLAG_DATA_PENDING;
@@ -745,9 +882,11 @@ void F_USB_DEVICE_MSD_BlockEventHandler
     switch(event)
     {
         case SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE:
+            M_USB_DEVICE_MSD_MEDIA_COMPLETE(mediaDynamicData);
             mediaDynamicData->mediaState = USB_DEVICE_MSD_MEDIA_OPERATION_COMPLETE;
             break;
         case SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR:
+            M_USB_DEVICE_MSD_MEDIA_COMPLETE(mediaDynamicData);
             mediaDynamicData->mediaState = USB_DEVICE_MSD_MEDIA_OPERATION_ERROR;
             break;
         default:
@@ -789,7 +928,7 @@ void F_USB_DEVICE_MSD_CheckAndUpdateMediaState
      * by the F_USB_DEVICE_MSD_ProcessNonRWCommand() function to decide
      * whether it should be continue processing the command */
 
-    USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
+    const USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
     USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData;
     SYS_MODULE_INDEX mediaInstanceIndex;
     DRV_HANDLE drvHandle;
@@ -800,7 +939,7 @@ void F_USB_DEVICE_MSD_CheckAndUpdateMediaState
     mediaDynamicData = &msdThisInstance->mediaDynamicData[logicalUnit];
 
     /* Pointer to the media functions */
-    mediaFunctions = &msdThisInstance->mediaData[logicalUnit].mediaFunctions;
+    mediaFunctions = M_USB_DEVICE_MSD_MediaFunctionsGet(&msdThisInstance->mediaData[logicalUnit]);
 
     /* Harmony module index for this media */
     mediaInstanceIndex = msdThisInstance->mediaData[logicalUnit].instanceIndex;
@@ -889,7 +1028,7 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_VerifyCommand
     USB_MSD_CBW * lCBW;
     USB_DEVICE_MSD_INSTANCE * msdInstance = &gUSBDeviceMSDInstance[iMSD];
 
-    USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
+    const USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
     USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData;
 
     *commandStatus = (uint8_t)USB_MSD_CSW_COMMAND_PASSED; 
@@ -930,7 +1069,7 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_VerifyCommand
     }
 
     mediaDynamicData = &msdInstance->mediaDynamicData[logicalUnit];
-    mediaFunctions = &msdInstance->mediaData[logicalUnit].mediaFunctions;
+    mediaFunctions = M_USB_DEVICE_MSD_MediaFunctionsGet(&msdInstance->mediaData[logicalUnit]);
 
     /* Find the number of bytes to be transferred. */
     length = (((uint32_t)lCBW->CBWCB[7] << 8) | lCBW->CBWCB[8]);
@@ -1078,7 +1217,7 @@ void  F_USB_DEVICE_MSD_SaveBlockAddressAndLength
 
 }    
 
-USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessRead
+USB_DEVICE_MSD_STATE RAMFUNC F_USB_DEVICE_MSD_ProcessRead
 (
     SYS_MODULE_INDEX iMSD,
     uint8_t *commandStatus
@@ -1090,7 +1229,7 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessRead
     uint8_t logicalUnit;
 
     SYS_MEDIA_BLOCK_COMMAND_HANDLE mediaReadWriteHandle = SYS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID;
-    USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
+    const USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
     USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData;
 
     USB_DEVICE_MSD_INSTANCE * msdInstance = &gUSBDeviceMSDInstance[iMSD];
@@ -1109,7 +1248,7 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessRead
     mediaDynamicData = &msdInstance->mediaDynamicData[logicalUnit];
 
     /* Pointer to the media functions for this LUN */
-    mediaFunctions = &msdInstance->mediaData[logicalUnit].mediaFunctions;
+    mediaFunctions = M_USB_DEVICE_MSD_MediaFunctionsGet(&msdInstance->mediaData[logicalUnit]);
 
     /* Pointer to the working buffer for this LUN */
     msdBuffer = msdInstance->mediaData[logicalUnit].sectorBuffer;
@@ -1169,11 +1308,14 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessRead
         mediaReadBlockSize = mediaDynamicData->mediaGeometry->geometryTable[0].blockSize;
 
         /* Read bufferOffset number of sectors data from the media. */
+        M_USB_DEVICE_MSD_MEDIA_REQUEST(msdInstance, mediaDynamicData);
+        SYS_PROFILE_ENTER(MSD_MEDIA_REQUEST);
         mediaFunctions->blockRead (drvHandle, 
                         &mediaReadWriteHandle, 
                         (uint8_t*)&msdBuffer[0],
                         (logicalBlockAddress.Val * (mediaDynamicData->sectorSize/mediaReadBlockSize)),
                         msdInstance->bufferOffset * (mediaDynamicData->sectorSize/mediaReadBlockSize));
+        SYS_PROFILE_EXIT(MSD_MEDIA_REQUEST);
 
         if (mediaReadWriteHandle == SYS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID)
         {
@@ -1204,7 +1346,7 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessRead
     return USB_DEVICE_MSD_STATE_DATA_IN;
 }
 
-USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessWrite
+USB_DEVICE_MSD_STATE RAMFUNC F_USB_DEVICE_MSD_ProcessWrite
 (
     SYS_MODULE_INDEX iMSD,
     uint8_t * commandStatus
@@ -1221,7 +1363,7 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessWrite
     uint8_t logicalUnit;
 
     SYS_MEDIA_BLOCK_COMMAND_HANDLE mediaReadWriteHandle = SYS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID;
-    USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
+    const USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
     USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData;
 
     USB_DEVICE_MSD_INSTANCE * msdInstance = &gUSBDeviceMSDInstance[iMSD];
@@ -1240,7 +1382,7 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessWrite
     mediaDynamicData = &msdInstance->mediaDynamicData[logicalUnit] ;
 
     /* Pointer to the media functions for this LUN */
-    mediaFunctions = &msdInstance->mediaData[logicalUnit].mediaFunctions;
+    mediaFunctions = M_USB_DEVICE_MSD_MediaFunctionsGet(&msdInstance->mediaData[logicalUnit]);
 
     /* Pointer to the working buffer for this LUN */
     msdBuffer = msdInstance->mediaData[logicalUnit].sectorBuffer;
@@ -1403,6 +1545,7 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessWrite
                 mediaDynamicData->mediaState = USB_DEVICE_MSD_MEDIA_OPERATION_PENDING;
 
                 /* Read one media sector worth of data. */
+                M_USB_DEVICE_MSD_MEDIA_REQUEST(msdInstance, mediaDynamicData);
                 mediaFunctions->blockRead(drvHandle, &mediaReadWriteHandle,
                         writeBlockBackupBuffer, (memoryBlock * (mediaWriteBlockSize/mediaReadBlockSize)),
                         (mediaWriteBlockSize/mediaReadBlockSize));
@@ -1464,8 +1607,11 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessWrite
 
         /* number of sectors to be written in this block != 0 */
         /* Write data to the media */
+        M_USB_DEVICE_MSD_MEDIA_REQUEST(msdInstance, mediaDynamicData);
+        SYS_PROFILE_ENTER(MSD_MEDIA_REQUEST);
         mediaFunctions->blockWrite (drvHandle, &mediaReadWriteHandle, 
                 (uint8_t*)data, blockAddress, numBlocks);
+        SYS_PROFILE_EXIT(MSD_MEDIA_REQUEST);
 
         if (mediaReadWriteHandle == SYS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID)
         {
@@ -1522,7 +1668,7 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessNonRWCommand
     uint8_t * msdBuffer;
     uint32_t length = 0;
 
-    USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
+    const USB_DEVICE_MSD_MEDIA_FUNCTIONS * mediaFunctions;
     USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData;
     USB_DEVICE_MSD_STATE msdNextState = USB_DEVICE_MSD_STATE_CSW;
 
@@ -1543,7 +1689,7 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessNonRWCommand
     mediaDynamicData = &msdInstance->mediaDynamicData[logicalUnit];
 
     /* Pointer to the media functions for this LUN */
-    mediaFunctions = &msdInstance->mediaData[logicalUnit].mediaFunctions;
+    mediaFunctions = M_USB_DEVICE_MSD_MediaFunctionsGet(&msdInstance->mediaData[logicalUnit]);
 
     /* Pointer to the working buffer for this LUN */
     msdBuffer = msdInstance->mediaData[logicalUnit].sectorBuffer;
@@ -1800,14 +1946,63 @@ USB_DEVICE_MSD_STATE F_USB_DEVICE_MSD_ProcessNonRWCommand
             }
             break;
 
-        case (uint8_t)SCSI_VERIFY:
         case (uint8_t)SCSI_STOP_START:
+            /* Byte 4 holds the LOEJ (bit 1) and START (bit 0) bits. A load
+             * or an eject passes even without media. */
+            if(((lCBW->CBWCB[4] & 0x02U) != 0U) && (mediaFunctions->mediaLoadEject != NULL)
+                    && (drvHandle != DRV_HANDLE_INVALID))
+            {
+                mediaFunctions->mediaLoadEject(drvHandle, ((lCBW->CBWCB[4] & 0x01U) != 0U));
+            }
+            else if(mediaDynamicData->mediaPresent == false)
+            {
+                (*commandStatus) = (uint8_t)USB_MSD_CSW_COMMAND_FAILED;
+            }
+            else
+            {
+                /* Nothing to do */
+            }
+            break;
+
+        case (uint8_t)SCSI_VERIFY:
             if(mediaDynamicData->mediaPresent == false)
             {
                 (*commandStatus) = (uint8_t)USB_MSD_CSW_COMMAND_FAILED;
             }
             break;
 
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+        case (uint8_t)USB_DEVICE_MSD_SCSI_COMMAND_STATISTICS_READ:
+            {
+                if ((lCBW->dCBWDataTransferLength == 0U) ||
+                        ((lCBW->bmCBWFlags.value & (uint8_t)USB_MSD_CBW_DIRECTION_BITMASK) == 0U))
+                {
+                    /* Fail the command if
+                       1. Host does not want to receive any data.
+                       2. If the data transfer direction is not IN.
+                       */
+                    (*commandStatus) = (uint8_t)USB_MSD_CSW_COMMAND_FAILED;
+                    break;
+                }
+
+                length = (uint32_t)sizeof(USB_DEVICE_MSD_COMMAND_STATISTICS);
+                if (length > lCBW->dCBWDataTransferLength)
+                {
+                    /* Transfer the amount of data that the host is expecting. */
+                    length = lCBW->dCBWDataTransferLength;
+                }
+
+                msdInstance->rxTxTotalDataByteCount = length;
+
+                (void) USB_DEVICE_MSD_CommandStatisticsGet(iMSD, &msdInstance->commandStatisticsReport,
+                        ((lCBW->CBWCB[1] & USB_DEVICE_MSD_SCSI_COMMAND_STATISTICS_RESET) != 0U));
+
+                F_USB_DEVICE_MSD_SendDataToUsb (iMSD, (uint8_t *)&msdInstance->commandStatisticsReport,
+                        (uint16_t)length);
+            }
+            break;
+#endif
+
         case (uint8_t)SCSI_PREVENT_ALLOW_MEDIUM_REMOVAL:
             mediaDynamicData->senseData->SenseKey = (uint8_t)SCSI_SENSE_ILLEGAL_REQUEST;
             mediaDynamicData->senseData->ASC = (uint8_t)SCSI_ASC_INVALID_COMMAND_OPCODE;
@@ -1863,6 +2058,402 @@ void F_USB_DEVICE_MSD_Deinitialization ( SYS_MODULE_INDEX iMSD )
     (void) USB_DEVICE_EndpointDisable( msdInstance->hUsbDevHandle, msdInstance->bulkEndpointTx );
 }
 
+// ******************************************************************************
+/* Function:
+    void USB_DEVICE_MSD_StatisticsGet
+    (
+        SYS_MODULE_INDEX iMSD,
+        USB_DEVICE_MSD_STATISTICS * statistics
+    )
+
+  Summary:
+    Returns the transfer statistics of an MSD instance.
+
+  Description:
+    Returns the transfer statistics of an MSD instance.
+
+  Remarks:
+    See usb_device_msd.h for usage information.
+*/
+
+void USB_DEVICE_MSD_StatisticsGet
+(
+    SYS_MODULE_INDEX iMSD,
+    USB_DEVICE_MSD_STATISTICS * statistics
+)
+{
+    USB_DEVICE_MSD_INSTANCE * msdInstance;
+
+    msdInstance = &gUSBDeviceMSDInstance[ iMSD ];
+
+    statistics->bytesReceived = msdInstance->bytesReceived;
+    statistics->bytesSent = msdInstance->bytesSent;
+    statistics->commands = msdInstance->commands;
+    statistics->throttledFrames = msdInstance->throttledFrames;
+}
+
+// ******************************************************************************
+/* Function:
+    void USB_DEVICE_MSD_FrameBudgetEnable
+    (
+        SYS_MODULE_INDEX iMSD,
+        bool enable
+    )
+
+  Summary:
+    Applies or lifts the frame byte budget of an MSD instance.
+
+  Description:
+    Applies or lifts the frame byte budget of an MSD instance.
+
+  Remarks:
+    See usb_device_msd.h for usage information.
+*/
+
+void USB_DEVICE_MSD_FrameBudgetEnable
+(
+    SYS_MODULE_INDEX iMSD,
+    bool enable
+)
+{
+    gUSBDeviceMSDInstance[ iMSD ].frameBudgetEnabled = enable;
+}
+
+// ******************************************************************************
+/* Function:
+    bool USB_DEVICE_MSD_CommandStatisticsGet
+    (
+        SYS_MODULE_INDEX iMSD,
+        USB_DEVICE_MSD_COMMAND_STATISTICS * statistics,
+        bool reset
+    )
+
+  Summary:
+    Returns the command statistics of an MSD instance.
+
+  Description:
+    Returns the command statistics of an MSD instance.
+
+  Remarks:
+    See usb_device_msd.h for usage information.
+*/
+
+bool USB_DEVICE_MSD_CommandStatisticsGet
+(
+    SYS_MODULE_INDEX iMSD,
+    USB_DEVICE_MSD_COMMAND_STATISTICS * statistics,
+    bool reset
+)
+{
+    bool retVal = false;
+
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+    USB_DEVICE_MSD_INSTANCE * msdInstance;
+    bool interruptWasEnabled;
+
+    if ((iMSD < USB_DEVICE_MSD_INSTANCES_NUMBER) && (statistics != NULL))
+    {
+        msdInstance = &gUSBDeviceMSDInstance[ iMSD ];
+
+        /* The IRP callbacks update the statistics. Take a consistent copy. */
+        interruptWasEnabled = SYS_INT_Disable();
+
+        *statistics = msdInstance->commandStatistics;
+
+        if (reset == true)
+        {
+            (void) memset(&msdInstance->commandStatistics, 0, sizeof(USB_DEVICE_MSD_COMMAND_STATISTICS));
+        }
+
+        SYS_INT_Restore(interruptWasEnabled);
+
+        retVal = true;
+    }
+#else
+    (void) iMSD;
+    (void) statistics;
+    (void) reset;
+#endif
+
+    return retVal;
+}
+
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_CommandReceived
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance
+    )
+
+  Summary:
+    Time stamps the CBW when its IRP completes.
+
+  Description:
+    The time since the CSW of the previous command is the time the device
+    waited for the host.
+
+  Remarks:
+    This is a local function and should not be called directly by an
+    application.
+*/
+
+void RAMFUNC F_USB_DEVICE_MSD_CommandReceived
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance
+)
+{
+    if (msdInstance->irpRx.data != (void *)msdInstance->msdCBW)
+    {
+        /* Data stage of a write */
+        return;
+    }
+
+    msdInstance->commandStartCount = SYS_TIME_CounterGet();
+
+    if (msdInstance->commandEnded)
+    {
+        msdInstance->commandEnded = false;
+        msdInstance->commandStatistics.hostIdleUS +=
+                SYS_TIME_CountToUS(msdInstance->commandStartCount - msdInstance->commandEndCount);
+    }
+}
+
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_CommandStart
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance
+    )
+
+  Summary:
+    Classifies a valid CBW and restarts the timing of the command.
+
+  Description:
+    Classifies a valid CBW and restarts the timing of the command.
+
+  Remarks:
+    This is a local function and should not be called directly by an
+    application.
+*/
+
+void RAMFUNC F_USB_DEVICE_MSD_CommandStart
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance
+)
+{
+    USB_DEVICE_MSD_OPCODE opcode;
+
+    switch (msdInstance->msdCBW->CBWCB[0])
+    {
+        case (uint8_t)SCSI_READ_10:
+            opcode = USB_DEVICE_MSD_OPCODE_READ_10;
+            break;
+        case (uint8_t)SCSI_WRITE_10:
+            opcode = USB_DEVICE_MSD_OPCODE_WRITE_10;
+            break;
+        case (uint8_t)SCSI_TEST_UNIT_READY:
+            opcode = USB_DEVICE_MSD_OPCODE_TEST_UNIT_READY;
+            break;
+        case (uint8_t)SCSI_REQUEST_SENSE:
+            opcode = USB_DEVICE_MSD_OPCODE_REQUEST_SENSE;
+            break;
+        case (uint8_t)SCSI_INQUIRY:
+            opcode = USB_DEVICE_MSD_OPCODE_INQUIRY;
+            break;
+        case (uint8_t)SCSI_READ_CAPACITY:
+            opcode = USB_DEVICE_MSD_OPCODE_READ_CAPACITY;
+            break;
+        case (uint8_t)SCSI_MODE_SENSE:
+            opcode = USB_DEVICE_MSD_OPCODE_MODE_SENSE;
+            break;
+        default:
+            opcode = USB_DEVICE_MSD_OPCODE_OTHER;
+            break;
+    }
+
+    msdInstance->commandOpcode = opcode;
+    msdInstance->commandLUN = msdInstance->msdCBW->bCBWLUN;
+    msdInstance->commandMediaStarted = false;
+
+    if (msdInstance->commandLUN < msdInstance->numberOfLogicalUnits)
+    {
+        msdInstance->mediaDynamicData[msdInstance->commandLUN].requestCounts = 0;
+    }
+}
+
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_MediaRequest
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance,
+        USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData
+    )
+
+  Summary:
+    Time stamps a media request.
+
+  Description:
+    Time stamps a media request. The first request of a command ends the setup
+    phase of the command.
+
+  Remarks:
+    This is a local function and should not be called directly by an
+    application.
+*/
+
+void RAMFUNC F_USB_DEVICE_MSD_MediaRequest
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance,
+    USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData
+)
+{
+    mediaDynamicData->requestStartCount = SYS_TIME_CounterGet();
+
+    if (!msdInstance->commandMediaStarted)
+    {
+        msdInstance->commandMediaStarted = true;
+        msdInstance->commandMediaCount = mediaDynamicData->requestStartCount;
+    }
+}
+
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_MediaComplete
+    (
+        USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData
+    )
+
+  Summary:
+    Adds the time of a completed media request to the current command.
+
+  Description:
+    Adds the time of a completed media request to the current command.
+
+  Remarks:
+    This is a local function and should not be called directly by an
+    application.
+*/
+
+void RAMFUNC F_USB_DEVICE_MSD_MediaComplete
+(
+    USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData
+)
+{
+    mediaDynamicData->requestCounts += SYS_TIME_CounterGet() - mediaDynamicData->requestStartCount;
+}
+
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_StatusStart
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance
+    )
+
+  Summary:
+    Time stamps the CSW.
+
+  Description:
+    Time stamps the CSW and remembers if the command failed. Called just before
+    the CSW IRP is submitted.
+
+  Remarks:
+    This is a local function and should not be called directly by an
+    application.
+*/
+
+void RAMFUNC F_USB_DEVICE_MSD_StatusStart
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance
+)
+{
+    msdInstance->commandFailed = (msdInstance->msdCSW->bCSWStatus != (uint8_t)USB_MSD_CSW_COMMAND_PASSED);
+    msdInstance->commandStatusCount = SYS_TIME_CounterGet();
+}
+
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_CommandEnd
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance
+    )
+
+  Summary:
+    Adds the current command to the command statistics.
+
+  Description:
+    Splits the time of the command in its phases once the CSW is sent. The
+    media and the USB transfers of a command do not overlap, so the data phase
+    is the data stage less the media time.
+
+  Remarks:
+    This is a local function and should not be called directly by an
+    application.
+*/
+
+void RAMFUNC F_USB_DEVICE_MSD_CommandEnd
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance
+)
+{
+    USB_DEVICE_MSD_OPCODE_STATISTICS * statistics;
+    uint32_t endCount;
+    uint32_t mediaStartCount;
+    uint32_t mediaCounts = 0;
+    uint32_t commandUS;
+    uint32_t mediaUS;
+    uint32_t dataUS;
+    uint32_t bucket = 0;
+
+    if (msdInstance->irpTx.data != (void *)msdInstance->msdCSW)
+    {
+        /* Data stage of a read */
+        return;
+    }
+
+    endCount = SYS_TIME_CounterGet();
+    statistics = &msdInstance->commandStatistics.opcodes[msdInstance->commandOpcode];
+
+    mediaStartCount = msdInstance->commandMediaStarted ? msdInstance->commandMediaCount : msdInstance->commandStartCount;
+    if (msdInstance->commandLUN < msdInstance->numberOfLogicalUnits)
+    {
+        mediaCounts = msdInstance->mediaDynamicData[msdInstance->commandLUN].requestCounts;
+    }
+
+    commandUS = SYS_TIME_CountToUS(endCount - msdInstance->commandStartCount);
+    mediaUS = SYS_TIME_CountToUS(mediaCounts);
+    dataUS = SYS_TIME_CountToUS(msdInstance->commandStatusCount - mediaStartCount);
+    dataUS = (dataUS > mediaUS) ? (dataUS - mediaUS) : 0U;
+
+    statistics->commands++;
+    if (msdInstance->commandFailed)
+    {
+        statistics->failed++;
+    }
+
+    statistics->setupUS += SYS_TIME_CountToUS(mediaStartCount - msdInstance->commandStartCount);
+    statistics->mediaUS += mediaUS;
+    statistics->dataUS += dataUS;
+    statistics->statusUS += SYS_TIME_CountToUS(endCount - msdInstance->commandStatusCount);
+
+    if (commandUS > statistics->maxUS)
+    {
+        statistics->maxUS = commandUS;
+    }
+
+    while ((bucket < (USB_DEVICE_MSD_LATENCY_BUCKETS - 1U)) && ((commandUS >> bucket) != 0U))
+    {
+        bucket++;
+    }
+    statistics->histogram[bucket]++;
+
+    msdInstance->commandStatistics.mediaIdleUS += (commandUS > mediaUS) ? (commandUS - mediaUS) : 0U;
+
+    msdInstance->commandEndCount = endCount;
+    msdInstance->commandEnded = true;
+}
+#endif
+
 // ******************************************************************************
 /* Function:
      void F_USB_DEVICE_MSD_ResetSenseData ( USB_DEVICE_MSD_SENSE_DATA * senseData )
@@ -52,6 +52,33 @@
 
 #define M_DRV_MSD_NUM_SECTORS_BUFFERING (USB_DEVICE_MSD_NUM_SECTOR_BUFFERS)
 
+/* Bytes the data stage may move in one USB frame before it waits for the next
+   SOF. Zero lets the data stage run without a limit. */
+#ifndef USB_DEVICE_MSD_FRAME_BYTE_BUDGET
+#define USB_DEVICE_MSD_FRAME_BYTE_BUDGET 0U
+#endif
+
+/* True to time the commands, see USB_DEVICE_MSD_CommandStatisticsGet */
+#ifndef USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE
+#define USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE false
+#endif
+
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+#define M_USB_DEVICE_MSD_COMMAND_RECEIVED(x)        F_USB_DEVICE_MSD_CommandReceived(x)
+#define M_USB_DEVICE_MSD_COMMAND_START(x)           F_USB_DEVICE_MSD_CommandStart(x)
+#define M_USB_DEVICE_MSD_MEDIA_REQUEST(x, y)        F_USB_DEVICE_MSD_MediaRequest(x, y)
+#define M_USB_DEVICE_MSD_MEDIA_COMPLETE(x)          F_USB_DEVICE_MSD_MediaComplete(x)
+#define M_USB_DEVICE_MSD_STATUS_START(x)            F_USB_DEVICE_MSD_StatusStart(x)
+#define M_USB_DEVICE_MSD_COMMAND_END(x)             F_USB_DEVICE_MSD_CommandEnd(x)
+#else
+#define M_USB_DEVICE_MSD_COMMAND_RECEIVED(x)
+#define M_USB_DEVICE_MSD_COMMAND_START(x)
+#define M_USB_DEVICE_MSD_MEDIA_REQUEST(x, y)
+#define M_USB_DEVICE_MSD_MEDIA_COMPLETE(x)
+#define M_USB_DEVICE_MSD_STATUS_START(x)
+#define M_USB_DEVICE_MSD_COMMAND_END(x)
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Local data types.
@@ -147,6 +174,13 @@ typedef struct
     
     /* Pointer to the media geometry */
     SYS_MEDIA_GEOMETRY * mediaGeometry;
+
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+    /* SYS_TIME counter at the start of the media request in progress and
+       counts spent in the media requests of the current command */
+    uint32_t requestStartCount;
+    volatile uint32_t requestCounts;
+#endif
 } USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA;
 
 // *****************************************************************************
@@ -220,6 +254,52 @@ typedef struct
      * MSD instance */
     uint8_t alternateSetting;
 
+    /* Bytes moved on the bulk endpoints. Updated by the IRP callbacks. */
+    volatile uint32_t bytesReceived;
+    volatile uint32_t bytesSent;
+
+    /* Number of CBWs received */
+    uint32_t commands;
+
+    /* Frame number and byte count at the start of the current frame budget */
+    uint16_t frameNumber;
+    uint32_t frameStartBytes;
+
+    /* Set while another function has data to move. The budget only applies
+       then. */
+    bool frameBudgetEnabled;
+
+    /* True once the data stage was held back in the current frame */
+    bool frameThrottled;
+    uint32_t throttledFrames;
+
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+    /* Class and logical unit of the current command */
+    USB_DEVICE_MSD_OPCODE commandOpcode;
+    uint8_t commandLUN;
+
+    /* True once the current command made a media request */
+    bool commandMediaStarted;
+
+    /* True when the current command reported a failure in its CSW */
+    bool commandFailed;
+
+    /* SYS_TIME counter at the CBW, the first media request and the CSW of
+       the current command, and at the end of the previous command */
+    uint32_t commandStartCount;
+    uint32_t commandMediaCount;
+    uint32_t commandStatusCount;
+    uint32_t commandEndCount;
+    bool commandEnded;
+
+    /* Updated by the IRP callbacks */
+    USB_DEVICE_MSD_COMMAND_STATISTICS commandStatistics;
+
+    /* Copy sent to the host by USB_DEVICE_MSD_SCSI_COMMAND_STATISTICS_READ,
+       which stays still during the data stage */
+    USB_DEVICE_MSD_COMMAND_STATISTICS commandStatisticsReport;
+#endif
+
 }USB_DEVICE_MSD_INSTANCE;
 
 
@@ -673,5 +753,143 @@ void  F_USB_DEVICE_MSD_SaveBlockAddressAndLength
     USB_DEVICE_MSD_DWORD_VAL * logicalBlockLength
 );
 
+// *****************************************************************************
+/* Function:
+    bool F_USB_DEVICE_MSD_FrameBudgetAvailable
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance
+    )
+
+  Summary:
+    Checks if the data stage may move more data in the current USB frame.
+
+  Description:
+    While the budget is enabled by USB_DEVICE_MSD_FrameBudgetEnable, this
+    function returns false once the bulk endpoints of the instance have moved
+    USB_DEVICE_MSD_FRAME_BYTE_BUDGET bytes in the current frame. The remaining
+    bus time of the frame is then left to the other functions of a composite
+    device. The budget is restored on the next SOF.
+
+  Returns:
+    True if the data stage can continue.
+
+  Remarks:
+    Bytes are counted when an IRP completes, so a sector that straddles two
+    frames is charged to the frame in which it completes.
+*/
+
+bool F_USB_DEVICE_MSD_FrameBudgetAvailable
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance
+);
+
+#if (USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE == true)
+// *****************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_CommandReceived
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance
+    )
+
+  Summary:
+    Time stamps the CBW when its IRP completes.
+
+  Remarks:
+    Called by the bulk OUT IRP callback.
+*/
+
+void F_USB_DEVICE_MSD_CommandReceived
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance
+);
+
+// *****************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_CommandStart
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance
+    )
+
+  Summary:
+    Classifies a valid CBW and restarts the timing of the command.
+*/
+
+void F_USB_DEVICE_MSD_CommandStart
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance
+);
+
+// *****************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_MediaRequest
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance,
+        USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData
+    )
+
+  Summary:
+    Time stamps a media request. Called just before the request is made.
+*/
+
+void F_USB_DEVICE_MSD_MediaRequest
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance,
+    USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData
+);
+
+// *****************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_MediaComplete
+    (
+        USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData
+    )
+
+  Summary:
+    Adds the time of a completed media request to the current command.
+
+  Remarks:
+    Called by the media event handler.
+*/
+
+void F_USB_DEVICE_MSD_MediaComplete
+(
+    USB_DEVICE_MSD_MEDIA_DYNAMIC_DATA * mediaDynamicData
+);
+
+// *****************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_StatusStart
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance
+    )
+
+  Summary:
+    Time stamps the CSW. Called just before its IRP is submitted.
+*/
+
+void F_USB_DEVICE_MSD_StatusStart
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance
+);
+
+// *****************************************************************************
+/* Function:
+    void F_USB_DEVICE_MSD_CommandEnd
+    (
+        USB_DEVICE_MSD_INSTANCE * msdInstance
+    )
+
+  Summary:
+    Adds the current command to the command statistics.
+
+  Remarks:
+    Called by the bulk IN IRP callback when the CSW completes.
+*/
+
+void F_USB_DEVICE_MSD_CommandEnd
+(
+    USB_DEVICE_MSD_INSTANCE * msdInstance
+);
 #endif
 
+#endif
@@ -319,7 +319,7 @@ typedef struct S_USB_DEVICE_IRP
      * The following members should not
      * be modified by the client
      ***********************************/
-    uint32_t privateData[3];
+    uintptr_t privateData[3];
 
 } USB_DEVICE_IRP;
 
@@ -1968,6 +1968,44 @@ bool USB_DEVICE_IsSuspended( USB_DEVICE_HANDLE usbDeviceHandle );
 
 USB_SPEED USB_DEVICE_ActiveSpeedGet( USB_DEVICE_HANDLE usbDeviceHandle );
 
+// *****************************************************************************
+/* Function:
+    uint16_t USB_DEVICE_SOFNumberGet(USB_DEVICE_HANDLE usbDeviceHandle)
+
+  Summary:
+    Returns the frame number of the last SOF received from the host.
+
+  Description:
+    This function returns the frame number contained in the last Start Of
+    Frame packet received from the host. Function drivers can use the frame
+    number to limit the amount of data they move in one frame, so that other
+    functions of a composite device get a share of the bus.
+
+  Precondition:
+    The USB device layer must have been initialized and a valid handle
+    to USB device layer must have been opened.
+
+  Parameters:
+    usbDeviceHandle    - Pointer to device layer handle that is returned from
+                        USB_DEVICE_Open
+
+  Returns:
+    The 11 bit frame number of the last SOF. Returns 0 if the handle is
+    invalid.
+
+  Example:
+    <code>
+    uint16_t frameNumber;
+
+    frameNumber = USB_DEVICE_SOFNumberGet(usbDeviceHandle);
+    </code>
+
+  Remarks:
+    The frame number does not advance while the bus is suspended.
+*/
+
+uint16_t USB_DEVICE_SOFNumberGet( USB_DEVICE_HANDLE usbDeviceHandle );
+
 // *****************************************************************************
 /* Function:
     void USB_DEVICE_PowerStateSet
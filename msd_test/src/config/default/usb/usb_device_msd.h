@@ -189,6 +189,18 @@ typedef struct USB_DEVICE_MSD_MEDIA_FUNCTIONS
         const void * addressOfStartBlock
     );
 
+    /* If not NULL, the MSD function driver calls this function when the host
+       sends a START STOP UNIT command with the LOEJ bit set, with load false
+       when the host ejects the media and true when it loads it. Media shared
+       with the device use it to learn that the host has let go of them. This
+       function pointer can be NULL. */
+
+    void (*mediaLoadEject)
+    (
+        const DRV_HANDLE drvHandle,
+        bool load
+    );
+
 } USB_DEVICE_MSD_MEDIA_FUNCTIONS;
 
 // *****************************************************************************
@@ -279,6 +291,176 @@ typedef struct
 
 } USB_DEVICE_MSD_INIT;
 
+// *****************************************************************************
+/* USB Device MSD Statistics
+
+  Summary:
+    Transfer statistics of an MSD function driver instance.
+
+  Description:
+    This structure holds the number of bytes moved on the bulk endpoints of an
+    MSD instance since the device was configured. The application can sample
+    it periodically to find the bus bandwidth used by the MSD function of a
+    composite device.
+
+  Remarks:
+    The byte counters wrap around at 2^32.
+*/
+
+typedef struct
+{
+    /* Bytes received on the bulk OUT endpoint, including CBWs */
+    uint32_t bytesReceived;
+
+    /* Bytes sent on the bulk IN endpoint, including CSWs */
+    uint32_t bytesSent;
+
+    /* Number of CBWs received */
+    uint32_t commands;
+
+    /* Number of frames in which the data stage was held back because the
+       frame byte budget was used up */
+    uint32_t throttledFrames;
+
+} USB_DEVICE_MSD_STATISTICS;
+
+// *****************************************************************************
+/* USB Device MSD Command Latency Buckets
+
+  Summary:
+    Number of buckets of the command latency histograms.
+
+  Description:
+    Bucket n of a latency histogram counts the commands that took less than
+    2^n microseconds from the CBW to the CSW. The last bucket counts all the
+    longer ones.
+*/
+
+#define USB_DEVICE_MSD_LATENCY_BUCKETS 20U
+
+// *****************************************************************************
+/* USB Device MSD Command Classes
+
+  Summary:
+    SCSI commands the command statistics are kept for.
+
+  Description:
+    The commands a host sends to a mass storage device are counted and timed
+    per class. All the other operation codes are counted together.
+*/
+
+typedef enum
+{
+    USB_DEVICE_MSD_OPCODE_READ_10 = 0,
+    USB_DEVICE_MSD_OPCODE_WRITE_10,
+    USB_DEVICE_MSD_OPCODE_TEST_UNIT_READY,
+    USB_DEVICE_MSD_OPCODE_REQUEST_SENSE,
+    USB_DEVICE_MSD_OPCODE_INQUIRY,
+    USB_DEVICE_MSD_OPCODE_READ_CAPACITY,
+    USB_DEVICE_MSD_OPCODE_MODE_SENSE,
+    USB_DEVICE_MSD_OPCODE_OTHER,
+
+    USB_DEVICE_MSD_OPCODE_COUNT
+
+} USB_DEVICE_MSD_OPCODE;
+
+// *****************************************************************************
+/* USB Device MSD Opcode Statistics
+
+  Summary:
+    Timing of the commands of one class.
+
+  Description:
+    The time of a command, from the reception of its CBW to the completion of
+    its CSW, is split in four phases:
+    - setup: from the CBW to the first media request. Zero for the commands
+      that do not access the media.
+    - media: while a media request was in progress.
+    - data: the rest of the data stage, mostly waiting for the USB transfers.
+    - status: from the submission of the CSW to its completion.
+
+    The phases are summed over the commands, so dividing a sum by the number
+    of commands gives the mean time of the phase.
+
+  Remarks:
+    The times are in microseconds.
+*/
+
+typedef struct
+{
+    /* Commands completed with a CSW */
+    uint32_t commands;
+
+    /* Commands completed with a failed status */
+    uint32_t failed;
+
+    /* Largest time from the CBW to the CSW */
+    uint32_t maxUS;
+
+    uint64_t setupUS;
+    uint64_t mediaUS;
+    uint64_t dataUS;
+    uint64_t statusUS;
+
+    /* Commands by time from the CBW to the CSW, see
+       USB_DEVICE_MSD_LATENCY_BUCKETS */
+    uint32_t histogram[USB_DEVICE_MSD_LATENCY_BUCKETS];
+
+} USB_DEVICE_MSD_OPCODE_STATISTICS;
+
+// *****************************************************************************
+/* USB Device MSD Command Statistics
+
+  Summary:
+    Timing of the commands of an MSD function driver instance.
+
+  Description:
+    This structure holds the timing of the commands per class and shows where
+    the time of a command goes. A large media time points at the media, a
+    large data or status time at the bus, and a large host idle time at the
+    host, which does not send commands fast enough to keep the device busy.
+
+  Remarks:
+    The times are in microseconds.
+*/
+
+typedef struct
+{
+    USB_DEVICE_MSD_OPCODE_STATISTICS opcodes[USB_DEVICE_MSD_OPCODE_COUNT];
+
+    /* Time a command was in progress while no media request was */
+    uint64_t mediaIdleUS;
+
+    /* Time from the CSW of a command to the CBW of the next one */
+    uint64_t hostIdleUS;
+
+} USB_DEVICE_MSD_COMMAND_STATISTICS;
+
+// *****************************************************************************
+/* USB Device MSD Command Statistics SCSI Command
+
+  Summary:
+    Vendor specific SCSI command that reads the command statistics.
+
+  Description:
+    A host reads the command statistics of the device with this operation
+    code in byte 0 of a CBW with an IN data stage. The data is the
+    USB_DEVICE_MSD_COMMAND_STATISTICS structure as the device holds it in
+    memory, little endian with its natural alignment, cut to the transfer
+    length of the CBW. The statistics are restarted once they are read if
+    byte 1 of the command block has USB_DEVICE_MSD_SCSI_COMMAND_STATISTICS_RESET
+    set.
+
+    The command fails with an invalid operation code when
+    USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE is not true. It is counted
+    in USB_DEVICE_MSD_OPCODE_OTHER, and its own CSW in the statistics the
+    next read returns.
+*/
+
+#define USB_DEVICE_MSD_SCSI_COMMAND_STATISTICS_READ     0xC0U
+
+#define USB_DEVICE_MSD_SCSI_COMMAND_STATISTICS_RESET    0x01U
+
 // *****************************************************************************
 /* USB Device MSD Function Driver Function Pointer
 
@@ -296,6 +478,151 @@ typedef struct
 /*DOM-IGNORE-BEGIN*/ extern USB_DEVICE_FUNCTION_DRIVER msdFunctionDriver ; /*DOM-IGNORE-END*/
 #define USB_DEVICE_MSD_FUNCTION_DRIVER /*DOM-IGNORE-BEGIN*/&msdFunctionDriver/*DOM-IGNORE-END*/
 
+// *****************************************************************************
+/* Function:
+    void USB_DEVICE_MSD_StatisticsGet
+    (
+        SYS_MODULE_INDEX iMSD,
+        USB_DEVICE_MSD_STATISTICS * statistics
+    )
+
+  Summary:
+    Returns the transfer statistics of an MSD instance.
+
+  Description:
+    This function copies the transfer statistics of the specified MSD function
+    driver instance to the statistics structure. The statistics are reset
+    every time the host configures the device.
+
+  Precondition:
+    The USB Device Layer must have been initialized.
+
+  Parameters:
+    iMSD - MSD function driver instance index.
+
+    statistics - Pointer to the structure where the statistics are copied.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    USB_DEVICE_MSD_STATISTICS msdStatistics;
+
+    USB_DEVICE_MSD_StatisticsGet(0, &msdStatistics);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+void USB_DEVICE_MSD_StatisticsGet
+(
+    SYS_MODULE_INDEX iMSD,
+    USB_DEVICE_MSD_STATISTICS * statistics
+);
+
+// *****************************************************************************
+/* Function:
+    void USB_DEVICE_MSD_FrameBudgetEnable
+    (
+        SYS_MODULE_INDEX iMSD,
+        bool enable
+    )
+
+  Summary:
+    Applies or lifts the frame byte budget of an MSD instance.
+
+  Description:
+    While the budget is enabled, the data stage of the specified MSD function
+    driver instance moves at most USB_DEVICE_MSD_FRAME_BYTE_BUDGET bytes in a
+    USB frame. Another function of a composite device enables it while it has
+    data to move, so that the MSD transfers run at full speed while the other
+    function is idle. The budget is disabled every time the host configures
+    the device.
+
+  Precondition:
+    The USB Device Layer must have been initialized.
+
+  Parameters:
+    iMSD - MSD function driver instance index.
+
+    enable - True to apply the budget, false to lift it.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    // A CDC write is in flight
+    USB_DEVICE_MSD_FrameBudgetEnable(0, true);
+    </code>
+
+  Remarks:
+    The function has no effect if USB_DEVICE_MSD_FRAME_BYTE_BUDGET is 0.
+*/
+
+void USB_DEVICE_MSD_FrameBudgetEnable
+(
+    SYS_MODULE_INDEX iMSD,
+    bool enable
+);
+
+// *****************************************************************************
+/* Function:
+    bool USB_DEVICE_MSD_CommandStatisticsGet
+    (
+        SYS_MODULE_INDEX iMSD,
+        USB_DEVICE_MSD_COMMAND_STATISTICS * statistics,
+        bool reset
+    )
+
+  Summary:
+    Returns the command statistics of an MSD instance.
+
+  Description:
+    This function copies the command statistics of the specified MSD function
+    driver instance to the statistics structure and optionally restarts them.
+    The statistics are also restarted every time the host configures the
+    device.
+
+  Precondition:
+    The USB Device Layer must have been initialized.
+
+  Parameters:
+    iMSD - MSD function driver instance index.
+
+    statistics - Pointer to the structure where the statistics are copied.
+
+    reset - true to restart the statistics once they are copied.
+
+  Returns:
+    false if USB_DEVICE_MSD_COMMAND_STATISTICS_ENABLE is not true or the
+    parameters are not valid.
+
+  Example:
+    <code>
+    USB_DEVICE_MSD_COMMAND_STATISTICS commandStatistics;
+
+    if (USB_DEVICE_MSD_CommandStatisticsGet(0, &commandStatistics, true))
+    {
+        // Mean media time of the READ(10) commands
+    }
+    </code>
+
+  Remarks:
+    The statistics are updated by the USB interrupt. They are copied with the
+    interrupts disabled. The host reads them with the
+    USB_DEVICE_MSD_SCSI_COMMAND_STATISTICS_READ command.
+*/
+
+bool USB_DEVICE_MSD_CommandStatisticsGet
+(
+    SYS_MODULE_INDEX iMSD,
+    USB_DEVICE_MSD_COMMAND_STATISTICS * statistics,
+    bool reset
+);
+
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
 }
@@ -53,9 +53,12 @@
 /* MISRA C-2012 Rule 10.3, 11.1 and 11.8 deviated below. Deviation record ID -  
    H3_USB_MISRAC_2012_R_10_3_DR_1, H3_USB_MISRAC_2012_R_11_1_DR_1 & H3_USB_MISRAC_2012_R_11_8_DR_1*/
 /***********************************************
- * Sector buffer needed by for the MSD LUN.
+ * Sector buffer needed by for the MSD LUNs. The
+ * function serves one command at a time, so the
+ * LUNs share it.
  ***********************************************/
 static uint8_t sectorBuffer[512 * USB_DEVICE_MSD_NUM_SECTOR_BUFFERS] USB_ALIGN;
+SYS_MEMORY_OBJECT_REGISTER(sectorBuffer);
 
 /***********************************************
  * CBW and CSW structure needed by for the MSD
@@ -68,7 +71,7 @@ static USB_MSD_CSW msdCSW0 USB_ALIGN;
 /*******************************************
  * MSD Function Driver initialization
  *******************************************/
-static USB_DEVICE_MSD_MEDIA_INIT_DATA USB_ALIGN  msdMediaInit0[1] =
+static USB_DEVICE_MSD_MEDIA_INIT_DATA USB_ALIGN  msdMediaInit0[USB_DEVICE_MSD_LUNS_NUMBER] =
 {
     /* LUN 0 */ 
     {
@@ -97,15 +100,137 @@ static USB_DEVICE_MSD_MEDIA_INIT_DATA USB_ALIGN  msdMediaInit0[1] =
                 '0','0','0','1'
             }
         },
+        /* Through the FAT service, which takes the card from the host */
         {
-            DRV_SDMMC_IsAttached,
+            SYS_FAT_MediaIsAttached,
             DRV_SDMMC_Open,
             DRV_SDMMC_Close,
             DRV_SDMMC_GeometryGet,
-            DRV_SDMMC_AsyncRead,
-            DRV_SDMMC_AsyncWrite,
+            SYS_FAT_MediaAsyncRead,
+            SYS_FAT_MediaAsyncWrite,
             DRV_SDMMC_IsWriteProtected,
-            DRV_SDMMC_EventHandlerSet,
+            SYS_FAT_MediaEventHandlerSet,
+            NULL,
+            SYS_FAT_MediaLoadEject
+        }
+    },
+    /* LUN 1 */
+    {
+        DRV_FLASH_INDEX_0,
+        512,
+        sectorBuffer,
+        NULL,
+        0,
+        {
+            0x00,    // peripheral device is connected, direct access block device
+            0x00,    // not removable
+            0x04,    // version = 00=> does not conform to any standard, 4=> SPC-2
+            0x02,    // response is in format specified by SPC-2
+            0x1F,    // additional length
+            0x00,    // sccs etc.
+            0x00,    // bque=1 and cmdque=0,indicates simple queueing 00 is obsolete,
+                     // but as in case of other device, we are just using 00
+            0x00,    // 00 obsolete, 0x80 for basic task queueing
+            {
+                'M','i','c','r','o','c','h','p'
+            },
+            {
+                'I','n','t','e','r','n','a','l',' ','F','l','a','s','h',' ',' '
+            },
+            {
+                '0','0','0','1'
+            }
+        },
+        {
+            DRV_FLASH_IsAttached,
+            DRV_FLASH_Open,
+            DRV_FLASH_Close,
+            DRV_FLASH_GeometryGet,
+            DRV_FLASH_AsyncRead,
+            DRV_FLASH_AsyncWrite,
+            DRV_FLASH_IsWriteProtected,
+            DRV_FLASH_EventHandlerSet,
+            NULL,
+            NULL
+        }
+    },
+    /* LUN 2 */
+    {
+        DRV_RAMDISK_INDEX_0,
+        512,
+        sectorBuffer,
+        NULL,
+        0,
+        {
+            0x00,    // peripheral device is connected, direct access block device
+            0x00,    // not removable
+            0x04,    // version = 00=> does not conform to any standard, 4=> SPC-2
+            0x02,    // response is in format specified by SPC-2
+            0x1F,    // additional length
+            0x00,    // sccs etc.
+            0x00,    // bque=1 and cmdque=0,indicates simple queueing 00 is obsolete,
+                     // but as in case of other device, we are just using 00
+            0x00,    // 00 obsolete, 0x80 for basic task queueing
+            {
+                'M','i','c','r','o','c','h','p'
+            },
+            {
+                'R','A','M',' ','D','i','s','k',' ',' ',' ',' ',' ',' ',' ',' '
+            },
+            {
+                '0','0','0','1'
+            }
+        },
+        {
+            DRV_RAMDISK_IsAttached,
+            DRV_RAMDISK_Open,
+            DRV_RAMDISK_Close,
+            DRV_RAMDISK_GeometryGet,
+            DRV_RAMDISK_AsyncRead,
+            DRV_RAMDISK_AsyncWrite,
+            DRV_RAMDISK_IsWriteProtected,
+            DRV_RAMDISK_EventHandlerSet,
+            NULL,
+            NULL
+        }
+    },
+    /* LUN 3 */
+    {
+        DRV_UF2_INDEX_0,
+        512,
+        sectorBuffer,
+        NULL,
+        0,
+        {
+            0x00,    // peripheral device is connected, direct access block device
+            0x00,    // not removable
+            0x04,    // version = 00=> does not conform to any standard, 4=> SPC-2
+            0x02,    // response is in format specified by SPC-2
+            0x1F,    // additional length
+            0x00,    // sccs etc.
+            0x00,    // bque=1 and cmdque=0,indicates simple queueing 00 is obsolete,
+                     // but as in case of other device, we are just using 00
+            0x00,    // 00 obsolete, 0x80 for basic task queueing
+            {
+                'M','i','c','r','o','c','h','p'
+            },
+            {
+                'U','F','2',' ','U','p','d','a','t','e',' ',' ',' ',' ',' ',' '
+            },
+            {
+                '0','0','0','1'
+            }
+        },
+        {
+            DRV_UF2_IsAttached,
+            DRV_UF2_Open,
+            DRV_UF2_Close,
+            DRV_UF2_GeometryGet,
+            DRV_UF2_AsyncRead,
+            DRV_UF2_AsyncWrite,
+            DRV_UF2_IsWriteProtected,
+            DRV_UF2_EventHandlerSet,
+            NULL,
             NULL
         }
     },
@@ -116,7 +241,7 @@ static USB_DEVICE_MSD_MEDIA_INIT_DATA USB_ALIGN  msdMediaInit0[1] =
  **************************************************/
 static const USB_DEVICE_MSD_INIT msdInit0 =
 {
-    .numberOfLogicalUnits = 1,
+    .numberOfLogicalUnits = USB_DEVICE_MSD_LUNS_NUMBER,
     .msdCBW = (USB_MSD_CBW*)&msdCBW0,
     .msdCSW = &msdCSW0,
     .mediaInit = &msdMediaInit0[0]
@@ -124,6 +249,15 @@ static const USB_DEVICE_MSD_INIT msdInit0 =
 
 /* MISRAC 2012 deviation block end */
 
+/* MISRA C-2012 Rule 10.3 deviated:4 Deviation record ID -  H3_USB_MISRAC_2012_R_10_3_DR_1 */
+static const USB_DEVICE_CDC_INIT cdcInit0 =
+{
+    .queueSizeRead = 1,
+    .queueSizeWrite = 1,
+    .queueSizeSerialStateNotification = 1
+};
+/* MISRAC 2012 deviation block end */   
+
 
 /**************************************************
  * USB Device Layer Function Driver Registration
@@ -131,7 +265,7 @@ static const USB_DEVICE_MSD_INIT msdInit0 =
  **************************************************/
 /* MISRA C-2012 Rule 10.3 deviated:2, 11.8 deviated:6 deviated below. Deviation record ID -  
    H3_USB_MISRAC_2012_R_10_3_DR_1 & H3_USB_MISRAC_2012_R_11_8_DR_1*/
-static const USB_DEVICE_FUNCTION_REGISTRATION_TABLE funcRegistrationTable[1] =
+static const USB_DEVICE_FUNCTION_REGISTRATION_TABLE funcRegistrationTable[2] =
 {
     
     /* MSD Function 0 */
@@ -145,6 +279,16 @@ static const USB_DEVICE_FUNCTION_REGISTRATION_TABLE funcRegistrationTable[1] =
         .funcDriverInit = (void*)&msdInit0    /* Function driver init data */
     },
 
+    /* CDC Function 0 */
+    {
+        .configurationValue = 1,                            // Configuration value
+        .interfaceNumber = 1,                               // First interfaceNumber of this function
+        .speed = (USB_SPEED)((uint32_t)USB_SPEED_HIGH|(uint32_t)USB_SPEED_FULL),             // Function Speed
+        .numberOfInterfaces = 2,                            // Number of interfaces
+        .funcDriverIndex = 0,                               // Index of CDC Function Driver
+        .driver = (void*)USB_DEVICE_CDC_FUNCTION_DRIVER,    // USB CDC function data exposed to device layer
+        .funcDriverInit = (void*)&cdcInit0                  // Function driver init data
+    },
 
 
 };
@@ -166,7 +310,7 @@ static const USB_DEVICE_DESCRIPTOR usbDeviceDescriptor =
     USB_DEVICE_EP0_BUFFER_SIZE,                             // Max packet size for EP0, see configuration.h
     0x04D8,                                                 // Vendor ID
     0x0009,                                                 // Product ID
-    0x0100,                                                 // Device release number in BCD format
+    0x0200,                                                 // Device release number in BCD format
     0x01,                                                   // Manufacturer string index
     0x02,                                                   // Product string index
     0x03,                                                   // Device serial number string index
@@ -184,8 +328,8 @@ static const uint8_t fullSpeedConfigurationDescriptor[]=
 
     0x09,                                                   // Size of this descriptor in bytes
     (uint8_t)USB_DESCRIPTOR_CONFIGURATION,                           // Descriptor Type
-    USB_DEVICE_16bitTo8bitArrange(32),                      //(32 Bytes)Size of the Configuration descriptor
-    1,                                                      // Number of interfaces in this configuration
+    USB_DEVICE_16bitTo8bitArrange(98),                      //(98 Bytes)Size of the Configuration descriptor
+    3,                                                      // Number of interfaces in this configuration
     0x01,                                                   // Index value of this configuration
     0x00,                                                   // Configuration string index
     USB_ATTRIBUTE_DEFAULT | USB_ATTRIBUTE_SELF_POWERED, // Attributes
@@ -221,6 +365,94 @@ static const uint8_t fullSpeedConfigurationDescriptor[]=
     0x40,0x00,                  // Max packet size of this EP
     0x00,                       // Interval (in ms)
 
+    /* Descriptor for Function 2 - CDC     */ 
+
+    /* Interface Association Descriptor (CDC) */
+
+    0x08,                                                   // Size of this descriptor in bytes
+    USB_DESCRIPTOR_INTERFACE_ASSOCIATION,                   // Interface Association Descriptor Type
+    1,                                                      // First interface of the function
+    2,                                                      // Number of interfaces of the function
+    USB_CDC_COMMUNICATIONS_INTERFACE_CLASS_CODE,            // Function class
+    (uint8_t)USB_CDC_SUBCLASS_ABSTRACT_CONTROL_MODEL,                // Function subclass
+    (uint8_t)USB_CDC_PROTOCOL_AT_V250,                               // Function protocol
+    0x00,                                                   // Function string index
+
+    /* Interface Descriptor */
+
+    0x09,                                                   // Size of this descriptor in bytes
+    (uint8_t)USB_DESCRIPTOR_INTERFACE,                               // Descriptor Type is Interface descriptor
+    1,                                                      // Interface Number
+    0x00,                                                   // Alternate Setting Number
+    0x01,                                                   // Number of endpoints in this interface
+    USB_CDC_COMMUNICATIONS_INTERFACE_CLASS_CODE,            // Class code
+    (uint8_t)USB_CDC_SUBCLASS_ABSTRACT_CONTROL_MODEL,                // Subclass code
+    (uint8_t)USB_CDC_PROTOCOL_AT_V250,                               // Protocol code
+    0x00,                                                   // Interface string index
+
+    /* CDC Class-Specific Descriptors */
+
+    (uint8_t)sizeof(USB_CDC_HEADER_FUNCTIONAL_DESCRIPTOR),                   // Size of the descriptor
+    (uint8_t)USB_CDC_DESC_CS_INTERFACE,                                      // CS_INTERFACE
+    (uint8_t)USB_CDC_FUNCTIONAL_HEADER,                                      // Type of functional descriptor
+    0x20,0x01,                                                      // CDC spec version
+
+    (uint8_t)sizeof(USB_CDC_ACM_FUNCTIONAL_DESCRIPTOR),                      // Size of the descriptor
+    (uint8_t)USB_CDC_DESC_CS_INTERFACE,                                      // CS_INTERFACE
+    (uint8_t)USB_CDC_FUNCTIONAL_ABSTRACT_CONTROL_MANAGEMENT,                 // Type of functional descriptor
+    USB_CDC_ACM_SUPPORT_LINE_CODING_LINE_STATE_AND_NOTIFICATION,    // bmCapabilities of ACM
+
+    sizeof(USB_CDC_UNION_FUNCTIONAL_DESCRIPTOR_HEADER) + 1,         // Size of the descriptor
+    (uint8_t)USB_CDC_DESC_CS_INTERFACE,                                      // CS_INTERFACE
+    (uint8_t)USB_CDC_FUNCTIONAL_UNION,                                       // Type of functional descriptor
+    1,                                                              // com interface number
+    2,
+
+    (uint8_t)sizeof(USB_CDC_CALL_MANAGEMENT_DESCRIPTOR),                     // Size of the descriptor
+    (uint8_t)USB_CDC_DESC_CS_INTERFACE,                                      // CS_INTERFACE
+    (uint8_t)USB_CDC_FUNCTIONAL_CALL_MANAGEMENT,                             // Type of functional descriptor
+    0x00,                                                           // bmCapabilities of CallManagement
+    2,                                                              // Data interface number
+
+    /* Interrupt Endpoint (IN) Descriptor */
+
+    0x07,                                                   // Size of this descriptor
+    USB_DESCRIPTOR_ENDPOINT,                                // Endpoint Descriptor
+    2 | USB_EP_DIRECTION_IN,                                // EndpointAddress ( EP2 IN INTERRUPT)
+    (uint8_t)USB_TRANSFER_TYPE_INTERRUPT,                            // Attributes type of EP (INTERRUPT)
+    0x10,0x00,                                              // Max packet size of this EP
+    0x02,                                                   // Interval (in ms)
+
+    /* Interface Descriptor */
+
+    0x09,                                                   // Size of this descriptor in bytes
+    USB_DESCRIPTOR_INTERFACE,                               // INTERFACE descriptor type
+    2,                                                      // Interface Number
+    0x00,                                                   // Alternate Setting Number
+    0x02,                                                   // Number of endpoints in this interface
+    USB_CDC_DATA_INTERFACE_CLASS_CODE,                      // Class code
+    0x00,                                                   // Subclass code
+    (uint8_t)USB_CDC_PROTOCOL_NO_CLASS_SPECIFIC,                     // Protocol code
+    0x00,                                                   // Interface string index
+
+    /* Bulk Endpoint (OUT) Descriptor */
+
+    0x07,                                                   // Size of this descriptor
+    USB_DESCRIPTOR_ENDPOINT,                                // Endpoint Descriptor
+    3 | USB_EP_DIRECTION_OUT,                               // EndpointAddress ( EP3 OUT )
+    (uint8_t)USB_TRANSFER_TYPE_BULK,                                 // Attributes type of EP (BULK)
+    0x40, 0x00,                                             // Max packet size of this EP
+    0x00,                                                   // Interval (in ms)
+
+     /* Bulk Endpoint (IN)Descriptor */
+
+    0x07,                                                   // Size of this descriptor
+    USB_DESCRIPTOR_ENDPOINT,                                // Endpoint Descriptor
+    3 | USB_EP_DIRECTION_IN,                                // EndpointAddress ( EP3 IN )
+    (uint8_t)USB_TRANSFER_TYPE_BULK,                                 // Attributes type of EP (BULK)
+    0x40, 0x00,                                             // Max packet size of this EP
+    0x00,                                                   // Interval (in ms)
+
 
 };
 /* MISRAC 2012 deviation block end */
@@ -278,14 +510,14 @@ const struct
 {
     uint8_t bLength;                                    // Size of this descriptor in bytes
     uint8_t bDscType;                                   // STRING descriptor type
-    uint16_t string[22];                                // String
+    uint16_t string[19];                                // String
 }
 
 static sd002 =
 {
     (uint8_t)sizeof(sd002),
     USB_DESCRIPTOR_STRING,
-    {'S','i','m','p','l','e',' ','M','S','D',' ','D','e','v','i','c','e',' ','D','e','m','o'}
+    {'M','S','D',' ','+',' ','C','D','C',' ','C','o','m','p','o','s','i','t','e'}
 };
 /******************************************************************************
  * Serial number string descriptor.  Note: This should be unique for each unit
@@ -346,7 +578,7 @@ const USB_DEVICE_INIT usbDevInitData =
 {
     /* Number of function drivers registered to this instance of the
        USB device layer */
-    .registeredFuncCount = 1,
+    .registeredFuncCount = 2,
 
     /* Function driver table registered to this instance of the USB device layer*/
     .registeredFunctions = (USB_DEVICE_FUNCTION_REGISTRATION_TABLE*)funcRegistrationTable,
@@ -0,0 +1,119 @@
+/*******************************************************************************
+  Simulated System Implementation
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_system.c
+
+  Summary
+    Initialization and tasks of the modules the host build runs.
+
+  Description
+    See sim_system.h, which the host build of msd_test shares. This project
+    has no SD card: SIM_SYSTEM_Initialize only initializes TC0, which
+    input.c polls the button with, as initialization.c does.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "configuration.h"
+#include "definitions.h"
+#include "sim_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Structure to hold the object handles for the modules in the system. */
+SYSTEM_OBJECTS sysObj;
+
+/* Tasks of the host programs, in the order they run */
+#define SIM_SYSTEM_TASKS_MAX        (8U)
+
+static void (*simSystemTasks[SIM_SYSTEM_TASKS_MAX])( void );
+
+static uint32_t simSystemTasksNumber;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SIM_SYSTEM_Initialize( void )
+{
+    simSystemTasksNumber = 0U;
+
+    TC0_TimerInitialize();
+}
+
+bool SIM_SYSTEM_TasksAdd( void (*task)( void ) )
+{
+    if (simSystemTasksNumber >= SIM_SYSTEM_TASKS_MAX)
+    {
+        return false;
+    }
+    simSystemTasks[simSystemTasksNumber++] = task;
+    return true;
+}
+
+void SIM_SYSTEM_Tasks( SIM_TIME step )
+{
+    uint32_t index;
+
+    for (index = 0U; index < simSystemTasksNumber; index++)
+    {
+        simSystemTasks[index]();
+    }
+
+    SIM_CLOCK_Advance(step);
+}
+
+bool SIM_SYSTEM_RunUntil( bool (*isDone)( uintptr_t context ), uintptr_t context,
+                          SIM_TIME step, SIM_TIME timeout )
+{
+    SIM_TIME end = SIM_CLOCK_Now() + timeout;
+
+    while (!isDone(context))
+    {
+        if (SIM_CLOCK_Now() >= end)
+        {
+            return false;
+        }
+        SIM_SYSTEM_Tasks(step);
+    }
+    return true;
+}
@@ -0,0 +1,156 @@
+/*******************************************************************************
+  Simulated USB System
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sim_usb_system.c
+
+  Summary
+    Initialization and tasks of the USB device stack of the host build.
+
+  Description
+    See sim_usb_system.h, which the host build of msd_test shares. Here the
+    stack is the one of this project, initialized with the initialization
+    data of initialization.c and usb_device_init_data.c: the USBFSV1 driver
+    on the simulated peripheral, the USB device layer with its CDC and
+    vendor functions, and the applications of app.c, cdc.c and vendor.c.
+    The tasks run in the order of tasks.c.
+
+    input.c is not built: its event queue orders the slots with the Cortex-M
+    __DMB, and the host has no button. The INPUT functions below stand in
+    for it, with a button that is never pressed.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "configuration.h"
+#include "definitions.h"
+#include "sim_core.h"
+#include "sim_usb.h"
+#include "sim_system.h"
+#include "sim_usb_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Driver Initialization Data
+// *****************************************************************************
+// *****************************************************************************
+
+static const DRV_USBFSV1_INIT drvUSBInit =
+{
+    .interruptSource = USB_OTHER_IRQn,
+    .interruptSource1 = USB_SOF_HSOF_IRQn,
+    .interruptSource2 = USB_TRCPT0_IRQn,
+    .interruptSource3 = USB_TRCPT1_IRQn,
+    .moduleInit = {0},
+    .operationMode = DRV_USBFSV1_OPMODE_DEVICE,
+    .operationSpeed = USB_SPEED_FULL,
+    .runInStandby = true,
+    .suspendInSleep = false,
+    .usbID = USB_REGS,
+};
+
+extern APP_DATA appData;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Button Input
+// *****************************************************************************
+// *****************************************************************************
+
+void INPUT_Initialize ( void )
+{
+}
+
+bool INPUT_EventGet ( INPUT_EVENT * event )
+{
+    (void)event;
+    return false;
+}
+
+uint32_t INPUT_DroppedCountGet ( void )
+{
+    return 0U;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void SIM_USB_SYSTEM_Tasks( void )
+{
+    DRV_USBFSV1_Tasks(sysObj.drvUSBFSV1Object);
+
+    USB_DEVICE_Tasks(sysObj.usbDevObject0);
+
+    APP_Tasks();
+
+    CDC_Tasks();
+
+    VENDOR_Tasks();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+bool SIM_USB_SYSTEM_Initialize( void )
+{
+    if (!SIM_CORE_Initialize() || !SIM_USB_Initialize())
+    {
+        return false;
+    }
+
+    SIM_SYSTEM_Initialize();
+
+    sysObj.drvUSBFSV1Object = DRV_USBFSV1_Initialize(DRV_USBFSV1_INDEX_0, (SYS_MODULE_INIT *)&drvUSBInit);
+
+    sysObj.usbDevObject0 = USB_DEVICE_Initialize(USB_DEVICE_INDEX_0, (SYS_MODULE_INIT *)&usbDevInitData);
+
+    APP_Initialize();
+    INPUT_Initialize();
+    CDC_Initialize();
+    VENDOR_Initialize();
+
+    return SIM_SYSTEM_TasksAdd(SIM_USB_SYSTEM_Tasks);
+}
+
+bool SIM_USB_SYSTEM_IsConfigured( void )
+{
+    return appData.deviceIsConfigured;
+}
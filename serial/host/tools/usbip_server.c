@@ -0,0 +1,204 @@
+/*******************************************************************************
+  USB/IP Server of the Host Build
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    usbip_server.c
+
+  Summary
+    Exports the simulated USB device to the USB/IP client of Linux.
+
+  Description
+    The server runs the USB device stack of this project on the simulated
+    USB peripheral, enumerates it and serves it with the SIM_USBIP of the
+    msd_test host build until it is interrupted:
+
+        usbip_server &
+        sudo modprobe vhci-hcd
+        sudo usbip attach -r 127.0.0.1 -b 1-1
+        vendor_bench_libusb
+
+    The kernel binds cdc_acm to the CDC function, and the vendor function
+    is left to libusb programs such as vendor_bench_libusb, as WinUSB gets
+    it on Windows. "usbip detach -p <port>" releases the device, and the
+    server waits for the next attach.
+
+    Options:
+        --address <ip>      address to listen on (127.0.0.1)
+        --port <n>          TCP port (3240)
+        --trace             prints the transfers on the simulated bus
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_system.h"
+#include "sim_usb.h"
+#include "sim_usb_host.h"
+#include "sim_usb_system.h"
+#include "sim_usbip.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define USBIP_SERVER_LOOP_STEP        SIM_TIME_US(2)
+
+#define USBIP_SERVER_TIMEOUT          SIM_TIME_MS(3000)
+
+static volatile sig_atomic_t usbipServerIsStopped;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void USBIP_SERVER_SignalHandler( int signalNumber )
+{
+    (void)signalNumber;
+    usbipServerIsStopped = 1;
+}
+
+static bool USBIP_SERVER_IsConfigured( uintptr_t context )
+{
+    (void)context;
+    return SIM_USB_SYSTEM_IsConfigured();
+}
+
+static void USBIP_SERVER_Usage( const char* program )
+{
+    fprintf(stderr, "usage: %s [--address ip] [--port n] [--trace]\n", program);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    SIM_USBIP_INIT usbipInit =
+    {
+        .address = "127.0.0.1",
+        .port = SIM_USBIP_PORT_DEFAULT,
+        .step = USBIP_SERVER_LOOP_STEP,
+    };
+    SIM_USBIP_STATISTICS statistics;
+    bool isTraceEnabled = false;
+    int argIndex;
+
+    for (argIndex = 1; argIndex < argc; argIndex++)
+    {
+        const char* arg = argv[argIndex];
+        const char* value = (argIndex + 1 < argc) ? argv[argIndex + 1] : NULL;
+
+        if (strcmp(arg, "--trace") == 0)
+        {
+            isTraceEnabled = true;
+            continue;
+        }
+        if (value == NULL)
+        {
+            USBIP_SERVER_Usage(argv[0]);
+            return 2;
+        }
+        argIndex++;
+
+        if (strcmp(arg, "--address") == 0)
+        {
+            usbipInit.address = value;
+        }
+        else if (strcmp(arg, "--port") == 0)
+        {
+            usbipInit.port = (uint16_t)strtoul(value, NULL, 0);
+        }
+        else
+        {
+            USBIP_SERVER_Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_USB_SYSTEM_Initialize())
+    {
+        fprintf(stderr, "cannot map the USB registers\n");
+        return 1;
+    }
+    SIM_USB_HOST_Initialize(USBIP_SERVER_LOOP_STEP, USBIP_SERVER_TIMEOUT);
+    if (!SIM_USB_HOST_Enumerate() ||
+        !SIM_SYSTEM_RunUntil(USBIP_SERVER_IsConfigured, 0U, USBIP_SERVER_LOOP_STEP, USBIP_SERVER_TIMEOUT))
+    {
+        fprintf(stderr, "the device did not enumerate\n");
+        return 1;
+    }
+    if (!SIM_USBIP_Initialize(&usbipInit))
+    {
+        fprintf(stderr, "cannot listen on %s:%u\n", usbipInit.address, (unsigned)usbipInit.port);
+        return 1;
+    }
+    if (isTraceEnabled)
+    {
+        SIM_USB_TraceSet(stdout);
+    }
+
+    (void)signal(SIGINT, USBIP_SERVER_SignalHandler);
+    (void)signal(SIGTERM, USBIP_SERVER_SignalHandler);
+    printf("# listening address=%s port=%u busid=%s\n", usbipInit.address,
+           (unsigned)SIM_USBIP_PortGet(), SIM_USBIP_BUS_ID);
+    fflush(stdout);
+
+    while (usbipServerIsStopped == 0)
+    {
+        SIM_USBIP_Tasks();
+    }
+
+    SIM_USB_TraceSet(NULL);
+    SIM_USBIP_StatisticsGet(&statistics);
+    SIM_USBIP_Deinitialize();
+
+    printf("# connections=%lu imports=%lu submits=%lu unlinks=%lu errors=%lu in_bytes=%llu out_bytes=%llu virtual_ms=%llu\n",
+           (unsigned long)statistics.connections, (unsigned long)statistics.imports,
+           (unsigned long)statistics.submits, (unsigned long)statistics.unlinks,
+           (unsigned long)statistics.errors, (unsigned long long)statistics.inBytes,
+           (unsigned long long)statistics.outBytes, (unsigned long long)(SIM_CLOCK_Now() / 1000000U));
+    return 0;
+}
@@ -0,0 +1,409 @@
+/*******************************************************************************
+  USB_DEVICE_VENDOR Host Benchmark
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    vendor_bench.c
+
+  Summary
+    Streams bulk data through USB_DEVICE_VENDOR in virtual time.
+
+  Description
+    The benchmark runs the USB device stack of this project on the
+    simulated USB peripheral, with vendor.c as the source and sink of the
+    vendor function, and streams to and from its bulk endpoints as a host
+    does, with several transfers queued per endpoint. It prints one line
+    per run, in the format of the 'B' lines of the target benchmarks:
+
+        bench name=<in|out|both> us=<time> in_kbps=<KB/s> out_kbps=<KB/s>
+              bus=<percent> err=<errors>
+
+    bus= is the data rate of the run in percent of the highest bulk data
+    rate of a full speed bus, 19 packets of 64 bytes per frame. The times
+    are virtual, given by the bus timing of SIM_USB and a fixed processor
+    time per pass of the main loop.
+
+    The data read has to be the byte ramp vendor.c sends, without a gap,
+    and the firmware has to count every byte written. err= counts the
+    bytes that differ, the bytes missing on the firmware side and the
+    transfers that failed on either side.
+
+    Options:
+        --duration <ms>     virtual time of each run (200)
+        --min-kbps <n>      fails if a run in one direction is slower
+        --transfers <n>     transfers queued per endpoint (2)
+        --trace             prints the transfers on the simulated bus
+
+    tools/usbip_server.c exports the same device to the USB/IP client of
+    Linux, for vendor_bench_libusb.c and other libusb programs.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "sim_system.h"
+#include "sim_usb.h"
+#include "sim_usb_host.h"
+#include "sim_usb_system.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Processor time of one pass of the main loop */
+#define VENDOR_BENCH_LOOP_STEP      SIM_TIME_US(2)
+
+#define VENDOR_BENCH_TIMEOUT        SIM_TIME_MS(3000)
+
+#define VENDOR_BENCH_TRANSFERS_MAX  (8U)
+
+/* Two IRPs of vendor.c */
+#define VENDOR_BENCH_TRANSFER_SIZE  (2U * VENDOR_BUFFER_SIZE)
+
+/* Bulk data bytes a full speed bus carries in a millisecond */
+#define VENDOR_BENCH_BUS_BYTES_MS   (19U * 64U)
+
+typedef struct
+{
+    SIM_USB_TRANSFER transfer;
+
+    /* Submitted and not accounted yet */
+    bool isActive;
+
+    uint8_t buffer[VENDOR_BENCH_TRANSFER_SIZE];
+
+} VENDOR_BENCH_TRANSFER;
+
+typedef struct
+{
+    uint32_t transfers;
+
+    /* Submitting new transfers */
+    bool isRunning;
+
+    /* Next byte of the ramp vendor.c sends */
+    uint8_t inExpected;
+
+    uint64_t inBytes;
+
+    uint64_t outBytes;
+
+    uint32_t errors;
+
+    VENDOR_BENCH_TRANSFER in[VENDOR_BENCH_TRANSFERS_MAX];
+
+    VENDOR_BENCH_TRANSFER out[VENDOR_BENCH_TRANSFERS_MAX];
+
+} VENDOR_BENCH_OBJ;
+
+extern VENDOR_DATA vendorData;
+
+static VENDOR_BENCH_OBJ vendorBenchObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool VENDOR_BENCH_IsStreaming( uintptr_t context )
+{
+    (void)context;
+    return SIM_USB_SYSTEM_IsConfigured() && (vendorData.state == VENDOR_STATE_STREAM);
+}
+
+static void VENDOR_BENCH_TransferSubmit( VENDOR_BENCH_TRANSFER* bench, uint8_t endpoint )
+{
+    const SIM_USB_HOST_DEVICE* device = SIM_USB_HOST_DeviceGet();
+    SIM_USB_TRANSFER* transfer = &bench->transfer;
+
+    memset(transfer, 0, sizeof(*transfer));
+    transfer->address = device->address;
+    transfer->endpoint = endpoint;
+    transfer->type = SIM_USB_TRANSFER_BULK;
+    transfer->maxPacketSize = device->vendorMaxPacketSize;
+    transfer->buffer = bench->buffer;
+    transfer->length = VENDOR_BENCH_TRANSFER_SIZE;
+    bench->isActive = true;
+    SIM_USB_TransferSubmit(transfer);
+}
+
+/* Accounts the transfer that ended, and submits it again while the run
+   goes on. Returns true if the transfer is pending. */
+static bool VENDOR_BENCH_TransferService( VENDOR_BENCH_TRANSFER* bench, uint8_t endpoint )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    SIM_USB_TRANSFER* transfer = &bench->transfer;
+    uint32_t index;
+
+    if (!bench->isActive)
+    {
+        return false;
+    }
+    if (transfer->status == SIM_USB_TRANSFER_PENDING)
+    {
+        return true;
+    }
+    if (transfer->status != SIM_USB_TRANSFER_COMPLETED)
+    {
+        obj->errors++;
+    }
+
+    if ((endpoint & 0x80U) != 0U)
+    {
+        for (index = 0U; index < transfer->actualLength; index++)
+        {
+            if (bench->buffer[index] != obj->inExpected)
+            {
+                obj->errors++;
+                /* Follow the stream from there */
+                obj->inExpected = bench->buffer[index];
+            }
+            obj->inExpected++;
+        }
+        obj->inBytes += transfer->actualLength;
+    }
+    else
+    {
+        obj->outBytes += transfer->actualLength;
+    }
+
+    if (!obj->isRunning)
+    {
+        bench->isActive = false;
+        return false;
+    }
+    VENDOR_BENCH_TransferSubmit(bench, endpoint);
+    return true;
+}
+
+/* Runs the transfers of both directions and returns the ones still
+   pending */
+static uint32_t VENDOR_BENCH_Service( bool isIn, bool isOut )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    const SIM_USB_HOST_DEVICE* device = SIM_USB_HOST_DeviceGet();
+    uint32_t pending = 0U;
+    uint32_t index;
+
+    for (index = 0U; index < obj->transfers; index++)
+    {
+        if (isIn && VENDOR_BENCH_TransferService(&obj->in[index], device->vendorIn))
+        {
+            pending++;
+        }
+        if (isOut && VENDOR_BENCH_TransferService(&obj->out[index], device->vendorOut))
+        {
+            pending++;
+        }
+    }
+    return pending;
+}
+
+static bool VENDOR_BENCH_Run( const char* name, bool isIn, bool isOut, SIM_TIME duration, uint32_t minKbps )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    const SIM_USB_HOST_DEVICE* device = SIM_USB_HOST_DeviceGet();
+    uint32_t rxBytesStart = vendorData.rxBytes;
+    uint32_t vendorErrorsStart = vendorData.errors;
+    uint32_t rxBytes;
+    uint64_t inKbps;
+    uint64_t outKbps;
+    uint64_t bus;
+    SIM_TIME start;
+    SIM_TIME end;
+    SIM_TIME time;
+    uint32_t index;
+
+    obj->inBytes = 0U;
+    obj->outBytes = 0U;
+    obj->errors = 0U;
+    obj->isRunning = true;
+
+    start = SIM_CLOCK_Now();
+    for (index = 0U; index < obj->transfers; index++)
+    {
+        if (isIn)
+        {
+            VENDOR_BENCH_TransferSubmit(&obj->in[index], device->vendorIn);
+        }
+        if (isOut)
+        {
+            memset(obj->out[index].buffer, (int)index, VENDOR_BENCH_TRANSFER_SIZE);
+            VENDOR_BENCH_TransferSubmit(&obj->out[index], device->vendorOut);
+        }
+    }
+
+    end = start + duration;
+    while (SIM_CLOCK_Now() < end)
+    {
+        SIM_SYSTEM_Tasks(VENDOR_BENCH_LOOP_STEP);
+        (void)VENDOR_BENCH_Service(isIn, isOut);
+    }
+
+    /* The transfers in progress end and count */
+    obj->isRunning = false;
+    end = SIM_CLOCK_Now() + VENDOR_BENCH_TIMEOUT;
+    while ((VENDOR_BENCH_Service(isIn, isOut) != 0U) && (SIM_CLOCK_Now() < end))
+    {
+        SIM_SYSTEM_Tasks(VENDOR_BENCH_LOOP_STEP);
+    }
+    time = SIM_CLOCK_Now() - start;
+
+    /* The firmware counts the data it read from its IRP callbacks */
+    SIM_USB_HOST_Wait(SIM_TIME_MS(1));
+    rxBytes = vendorData.rxBytes - rxBytesStart;
+    if (rxBytes != (uint32_t)obj->outBytes)
+    {
+        fprintf(stderr, "%s: the firmware read %lu bytes of %llu\n", name, (unsigned long)rxBytes,
+                (unsigned long long)obj->outBytes);
+        obj->errors++;
+    }
+    obj->errors += vendorData.errors - vendorErrorsStart;
+
+    inKbps = (obj->inBytes * 1000000000U / 1024U) / time;
+    outKbps = (obj->outBytes * 1000000000U / 1024U) / time;
+    bus = ((obj->inBytes + obj->outBytes) * 100U * 1000000U) / (VENDOR_BENCH_BUS_BYTES_MS * time);
+
+    printf("bench name=%s us=%llu in_kbps=%llu out_kbps=%llu bus=%llu err=%lu\n", name,
+           (unsigned long long)(time / 1000U), (unsigned long long)inKbps, (unsigned long long)outKbps,
+           (unsigned long long)bus, (unsigned long)obj->errors);
+
+    if (isIn != isOut)
+    {
+        if ((isIn ? inKbps : outKbps) < minKbps)
+        {
+            fprintf(stderr, "%s: %llu KB/s, below %lu KB/s\n", name,
+                    (unsigned long long)(isIn ? inKbps : outKbps), (unsigned long)minKbps);
+            return false;
+        }
+    }
+    return (obj->errors == 0U);
+}
+
+static void VENDOR_BENCH_Usage( const char* program )
+{
+    fprintf(stderr, "usage: %s [--duration ms] [--min-kbps n] [--transfers n] [--trace]\n", program);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    SIM_TIME duration = SIM_TIME_MS(200);
+    uint32_t minKbps = 0U;
+    bool isTraceEnabled = false;
+    bool isFailed = false;
+    int argIndex;
+
+    obj->transfers = 2U;
+
+    for (argIndex = 1; argIndex < argc; argIndex++)
+    {
+        const char* arg = argv[argIndex];
+        const char* value = (argIndex + 1 < argc) ? argv[argIndex + 1] : NULL;
+
+        if (strcmp(arg, "--trace") == 0)
+        {
+            isTraceEnabled = true;
+            continue;
+        }
+        if (value == NULL)
+        {
+            VENDOR_BENCH_Usage(argv[0]);
+            return 2;
+        }
+        argIndex++;
+
+        if (strcmp(arg, "--duration") == 0)
+        {
+            duration = SIM_TIME_MS(strtoull(value, NULL, 0));
+        }
+        else if (strcmp(arg, "--min-kbps") == 0)
+        {
+            minKbps = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else if (strcmp(arg, "--transfers") == 0)
+        {
+            obj->transfers = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else
+        {
+            VENDOR_BENCH_Usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((obj->transfers == 0U) || (obj->transfers > VENDOR_BENCH_TRANSFERS_MAX) || (duration == 0U))
+    {
+        VENDOR_BENCH_Usage(argv[0]);
+        return 2;
+    }
+
+    SIM_CLOCK_Initialize();
+    if (!SIM_USB_SYSTEM_Initialize())
+    {
+        fprintf(stderr, "cannot map the USB registers\n");
+        return 1;
+    }
+    SIM_USB_HOST_Initialize(VENDOR_BENCH_LOOP_STEP, VENDOR_BENCH_TIMEOUT);
+    if (!SIM_USB_HOST_Enumerate() || (SIM_USB_HOST_DeviceGet()->vendorIn == SIM_USB_HOST_ENDPOINT_NONE) ||
+        !SIM_SYSTEM_RunUntil(VENDOR_BENCH_IsStreaming, 0U, VENDOR_BENCH_LOOP_STEP, VENDOR_BENCH_TIMEOUT))
+    {
+        fprintf(stderr, "the device did not enumerate\n");
+        return 1;
+    }
+    if (isTraceEnabled)
+    {
+        SIM_USB_TraceSet(stdout);
+    }
+    printf("# transfers=%lu size=%lu attach_us=%llu\n", (unsigned long)obj->transfers,
+           (unsigned long)VENDOR_BENCH_TRANSFER_SIZE, (unsigned long long)(SIM_CLOCK_Now() / 1000U));
+
+    isFailed |= !VENDOR_BENCH_Run("in", true, false, duration, minKbps);
+    isFailed |= !VENDOR_BENCH_Run("out", false, true, duration, minKbps);
+    isFailed |= !VENDOR_BENCH_Run("both", true, true, duration, minKbps);
+
+    SIM_USB_TraceSet(NULL);
+    return isFailed ? 1 : 0;
+}
@@ -0,0 +1,469 @@
+/*******************************************************************************
+  USB_DEVICE_VENDOR libusb Benchmark
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    vendor_bench_libusb.c
+
+  Summary
+    Streams bulk data through the vendor function of a device with libusb.
+
+  Description
+    The benchmark opens the device by its vendor and product IDs, claims
+    its vendor specific interface and streams to and from the bulk
+    endpoints of the interface, with several asynchronous transfers queued
+    per endpoint, as vendor_bench does on the simulated bus. The device is
+    the target itself, or usbip_server attached through vhci_hcd as a local
+    stand-in. It prints one line per run, in real time:
+
+        bench name=<in|out|both> us=<time> in_kbps=<KB/s> out_kbps=<KB/s>
+              bus=<percent> err=<errors>
+
+    bus= is the data rate of the run in percent of the highest bulk data
+    rate of a full speed bus, 19 packets of 64 bytes per frame. The data
+    read has to be the byte ramp vendor.c sends, without a gap. err= counts
+    the bytes that differ and the transfers that failed.
+
+    Options:
+        --vid <id>          vendor ID (0x04D8)
+        --pid <id>          product ID (0x000A)
+        --duration <ms>     time of each run (2000)
+        --transfers <n>     transfers queued per endpoint (8)
+        --size <bytes>      size of a transfer (16384)
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <libusb.h>
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data
+// *****************************************************************************
+// *****************************************************************************
+
+#define VENDOR_BENCH_TRANSFERS_MAX  (32U)
+
+/* Bulk data bytes a full speed bus carries in a millisecond */
+#define VENDOR_BENCH_BUS_BYTES_MS   (19U * 64U)
+
+/* Time the transfers in progress have to end after a run */
+#define VENDOR_BENCH_DRAIN_MS       (3000U)
+
+typedef struct
+{
+    struct libusb_transfer* transfer;
+
+    /* Submitted and not ended yet */
+    bool isActive;
+
+} VENDOR_BENCH_TRANSFER;
+
+typedef struct
+{
+    libusb_context* context;
+
+    libusb_device_handle* handle;
+
+    uint8_t interfaceNumber;
+
+    uint8_t endpointIn;
+
+    uint8_t endpointOut;
+
+    uint32_t transfers;
+
+    uint32_t size;
+
+    /* Submitting new transfers */
+    bool isRunning;
+
+    /* Next byte of the ramp vendor.c sends */
+    uint8_t inExpected;
+
+    uint64_t inBytes;
+
+    uint64_t outBytes;
+
+    uint32_t errors;
+
+    VENDOR_BENCH_TRANSFER in[VENDOR_BENCH_TRANSFERS_MAX];
+
+    VENDOR_BENCH_TRANSFER out[VENDOR_BENCH_TRANSFERS_MAX];
+
+} VENDOR_BENCH_OBJ;
+
+static VENDOR_BENCH_OBJ vendorBenchObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t VENDOR_BENCH_NowUs( void )
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000U) + ((uint64_t)now.tv_nsec / 1000U);
+}
+
+static void LIBUSB_CALL VENDOR_BENCH_TransferCallback( struct libusb_transfer* transfer )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    VENDOR_BENCH_TRANSFER* bench = (VENDOR_BENCH_TRANSFER*)transfer->user_data;
+    int index;
+
+    if (transfer->status != LIBUSB_TRANSFER_COMPLETED)
+    {
+        obj->errors++;
+    }
+
+    if ((transfer->endpoint & LIBUSB_ENDPOINT_IN) != 0U)
+    {
+        for (index = 0; index < transfer->actual_length; index++)
+        {
+            if (transfer->buffer[index] != obj->inExpected)
+            {
+                obj->errors++;
+                /* Follow the stream from there */
+                obj->inExpected = transfer->buffer[index];
+            }
+            obj->inExpected++;
+        }
+        obj->inBytes += (uint64_t)transfer->actual_length;
+    }
+    else
+    {
+        obj->outBytes += (uint64_t)transfer->actual_length;
+    }
+
+    if (!obj->isRunning || (transfer->status != LIBUSB_TRANSFER_COMPLETED) ||
+        (libusb_submit_transfer(transfer) != LIBUSB_SUCCESS))
+    {
+        bench->isActive = false;
+    }
+}
+
+static bool VENDOR_BENCH_TransferSubmit( VENDOR_BENCH_TRANSFER* bench )
+{
+    bench->isActive = (libusb_submit_transfer(bench->transfer) == LIBUSB_SUCCESS);
+    return bench->isActive;
+}
+
+static uint32_t VENDOR_BENCH_ActiveCount( void )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    uint32_t active = 0U;
+    uint32_t index;
+
+    for (index = 0U; index < obj->transfers; index++)
+    {
+        active += obj->in[index].isActive ? 1U : 0U;
+        active += obj->out[index].isActive ? 1U : 0U;
+    }
+    return active;
+}
+
+static void VENDOR_BENCH_EventsHandle( void )
+{
+    struct timeval timeout = { .tv_sec = 0, .tv_usec = 100000 };
+
+    (void)libusb_handle_events_timeout_completed(vendorBenchObj.context, &timeout, NULL);
+}
+
+static bool VENDOR_BENCH_Run( const char* name, bool isIn, bool isOut, uint32_t durationMs )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    uint64_t start;
+    uint64_t end;
+    uint64_t time;
+    uint32_t index;
+
+    obj->inBytes = 0U;
+    obj->outBytes = 0U;
+    obj->errors = 0U;
+    obj->isRunning = true;
+
+    start = VENDOR_BENCH_NowUs();
+    for (index = 0U; index < obj->transfers; index++)
+    {
+        if (isIn && !VENDOR_BENCH_TransferSubmit(&obj->in[index]))
+        {
+            obj->errors++;
+        }
+        if (isOut && !VENDOR_BENCH_TransferSubmit(&obj->out[index]))
+        {
+            obj->errors++;
+        }
+    }
+
+    end = start + ((uint64_t)durationMs * 1000U);
+    while ((VENDOR_BENCH_NowUs() < end) && (VENDOR_BENCH_ActiveCount() != 0U))
+    {
+        VENDOR_BENCH_EventsHandle();
+    }
+
+    /* The transfers in progress end and count */
+    obj->isRunning = false;
+    end = VENDOR_BENCH_NowUs() + ((uint64_t)VENDOR_BENCH_DRAIN_MS * 1000U);
+    while ((VENDOR_BENCH_ActiveCount() != 0U) && (VENDOR_BENCH_NowUs() < end))
+    {
+        VENDOR_BENCH_EventsHandle();
+    }
+    if (VENDOR_BENCH_ActiveCount() != 0U)
+    {
+        fprintf(stderr, "%s: the transfers did not end\n", name);
+        return false;
+    }
+    time = VENDOR_BENCH_NowUs() - start;
+
+    printf("bench name=%s us=%llu in_kbps=%llu out_kbps=%llu bus=%llu err=%lu\n", name,
+           (unsigned long long)time,
+           (unsigned long long)((obj->inBytes * 1000000U / 1024U) / time),
+           (unsigned long long)((obj->outBytes * 1000000U / 1024U) / time),
+           (unsigned long long)(((obj->inBytes + obj->outBytes) * 100U * 1000U) / (VENDOR_BENCH_BUS_BYTES_MS * time)),
+           (unsigned long)obj->errors);
+    fflush(stdout);
+    return (obj->errors == 0U);
+}
+
+/* Finds the vendor specific interface and its bulk endpoints */
+static bool VENDOR_BENCH_InterfaceFind( void )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    struct libusb_config_descriptor* config;
+    const struct libusb_interface_descriptor* interface;
+    const struct libusb_endpoint_descriptor* endpoint;
+    bool isFound = false;
+    int index;
+    int endpointIndex;
+
+    if (libusb_get_active_config_descriptor(libusb_get_device(obj->handle), &config) != LIBUSB_SUCCESS)
+    {
+        return false;
+    }
+    for (index = 0; (index < config->bNumInterfaces) && !isFound; index++)
+    {
+        if (config->interface[index].num_altsetting < 1)
+        {
+            continue;
+        }
+        interface = &config->interface[index].altsetting[0];
+        if (interface->bInterfaceClass != LIBUSB_CLASS_VENDOR_SPEC)
+        {
+            continue;
+        }
+        obj->interfaceNumber = interface->bInterfaceNumber;
+        obj->endpointIn = 0U;
+        obj->endpointOut = 0U;
+        for (endpointIndex = 0; endpointIndex < interface->bNumEndpoints; endpointIndex++)
+        {
+            endpoint = &interface->endpoint[endpointIndex];
+            if ((endpoint->bmAttributes & LIBUSB_TRANSFER_TYPE_MASK) != LIBUSB_TRANSFER_TYPE_BULK)
+            {
+                continue;
+            }
+            if ((endpoint->bEndpointAddress & LIBUSB_ENDPOINT_IN) != 0U)
+            {
+                obj->endpointIn = endpoint->bEndpointAddress;
+            }
+            else
+            {
+                obj->endpointOut = endpoint->bEndpointAddress;
+            }
+        }
+        isFound = (obj->endpointIn != 0U) && (obj->endpointOut != 0U);
+    }
+    libusb_free_config_descriptor(config);
+    return isFound;
+}
+
+static bool VENDOR_BENCH_TransfersAllocate( void )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    VENDOR_BENCH_TRANSFER* bench;
+    uint8_t* buffer;
+    uint32_t index;
+
+    for (index = 0U; index < (2U * obj->transfers); index++)
+    {
+        bench = (index < obj->transfers) ? &obj->in[index] : &obj->out[index - obj->transfers];
+        bench->transfer = libusb_alloc_transfer(0);
+        buffer = malloc(obj->size);
+        if ((bench->transfer == NULL) || (buffer == NULL))
+        {
+            free(buffer);
+            return false;
+        }
+        memset(buffer, (int)index, obj->size);
+        libusb_fill_bulk_transfer(bench->transfer, obj->handle,
+                                  (index < obj->transfers) ? obj->endpointIn : obj->endpointOut,
+                                  buffer, (int)obj->size, VENDOR_BENCH_TransferCallback, bench, 0U);
+        bench->transfer->flags = LIBUSB_TRANSFER_FREE_BUFFER;
+    }
+    return true;
+}
+
+static void VENDOR_BENCH_TransfersFree( void )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    uint32_t index;
+
+    for (index = 0U; index < obj->transfers; index++)
+    {
+        libusb_free_transfer(obj->in[index].transfer);
+        libusb_free_transfer(obj->out[index].transfer);
+    }
+}
+
+static void VENDOR_BENCH_Usage( const char* program )
+{
+    fprintf(stderr, "usage: %s [--vid id] [--pid id] [--duration ms] [--transfers n] [--size bytes]\n", program);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main( int argc, char** argv )
+{
+    VENDOR_BENCH_OBJ* obj = &vendorBenchObj;
+    uint16_t vendorId = 0x04D8U;
+    uint16_t productId = 0x000AU;
+    uint32_t durationMs = 2000U;
+    bool isFailed = false;
+    int argIndex;
+
+    obj->transfers = 8U;
+    obj->size = 16384U;
+
+    for (argIndex = 1; argIndex < argc; argIndex++)
+    {
+        const char* arg = argv[argIndex];
+        const char* value = (argIndex + 1 < argc) ? argv[argIndex + 1] : NULL;
+
+        if (value == NULL)
+        {
+            VENDOR_BENCH_Usage(argv[0]);
+            return 2;
+        }
+        argIndex++;
+
+        if (strcmp(arg, "--vid") == 0)
+        {
+            vendorId = (uint16_t)strtoul(value, NULL, 0);
+        }
+        else if (strcmp(arg, "--pid") == 0)
+        {
+            productId = (uint16_t)strtoul(value, NULL, 0);
+        }
+        else if (strcmp(arg, "--duration") == 0)
+        {
+            durationMs = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else if (strcmp(arg, "--transfers") == 0)
+        {
+            obj->transfers = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else if (strcmp(arg, "--size") == 0)
+        {
+            obj->size = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else
+        {
+            VENDOR_BENCH_Usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((obj->transfers == 0U) || (obj->transfers > VENDOR_BENCH_TRANSFERS_MAX) ||
+        (obj->size == 0U) || (durationMs == 0U))
+    {
+        VENDOR_BENCH_Usage(argv[0]);
+        return 2;
+    }
+
+    if (libusb_init(&obj->context) != LIBUSB_SUCCESS)
+    {
+        fprintf(stderr, "cannot initialize libusb\n");
+        return 1;
+    }
+    obj->handle = libusb_open_device_with_vid_pid(obj->context, vendorId, productId);
+    if (obj->handle == NULL)
+    {
+        fprintf(stderr, "no device %04x:%04x\n", (unsigned)vendorId, (unsigned)productId);
+        libusb_exit(obj->context);
+        return 1;
+    }
+    (void)libusb_set_auto_detach_kernel_driver(obj->handle, 1);
+    if (!VENDOR_BENCH_InterfaceFind() || (libusb_claim_interface(obj->handle, obj->interfaceNumber) != LIBUSB_SUCCESS))
+    {
+        fprintf(stderr, "cannot claim the vendor specific interface\n");
+        libusb_close(obj->handle);
+        libusb_exit(obj->context);
+        return 1;
+    }
+
+    printf("# device=%04x:%04x interface=%u in=0x%02x out=0x%02x transfers=%lu size=%lu\n",
+           (unsigned)vendorId, (unsigned)productId, (unsigned)obj->interfaceNumber,
+           (unsigned)obj->endpointIn, (unsigned)obj->endpointOut,
+           (unsigned long)obj->transfers, (unsigned long)obj->size);
+
+    if (!VENDOR_BENCH_TransfersAllocate())
+    {
+        fprintf(stderr, "out of memory\n");
+        isFailed = true;
+    }
+    else
+    {
+        isFailed |= !VENDOR_BENCH_Run("in", true, false, durationMs);
+        isFailed |= !VENDOR_BENCH_Run("out", false, true, durationMs);
+        isFailed |= !VENDOR_BENCH_Run("both", true, true, durationMs);
+    }
+
+    VENDOR_BENCH_TransfersFree();
+    (void)libusb_release_interface(obj->handle, obj->interfaceNumber);
+    libusb_close(obj->handle);
+    libusb_exit(obj->context);
+    return isFailed ? 1 : 0;
+}
@@ -29,8 +29,10 @@
 
 #include "app.h"
 #include "cdc.h"
+#include "vendor.h"
 #include "peripheral/port/plib_port.h"
 #include "usb/usb_device_cdc.h"
+#include "usb/usb_device_vendor.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -54,7 +56,7 @@
 */
 
 APP_DATA appData;
-extern CDC_DATA cdcData;
+extern const USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR usbDeviceVendorMsOs20Descriptor;
 
 // *****************************************************************************
 // *****************************************************************************
@@ -103,27 +105,6 @@ USB_DEVICE_EVENT_RESPONSE APP_USBDeviceEventHandler
             // event and can be used the application for time
             // related activities. pData will point to a USB_DEVICE_EVENT_DATA_SOF type data
             // containing the frame number.
-            if(BTN_1_Get() == 0){
-                if(cdcData.ignoreBtn){
-                    break;
-                }
-                if(cdcData.debouncing){
-                    cdcData.btnDebounceCNT++;
-                    if(cdcData.btnDebounceCNT >= BTN_DEBOUNCE_COUNT){
-                        cdcData.debouncing = false;
-                        cdcData.btnPressed = true;
-                        cdcData.ignoreBtn = true;
-                    }
-                }
-                else{
-                    cdcData.debouncing = true;
-                    cdcData.btnDebounceCNT = 0;
-                }
-            }
-            else{
-                cdcData.ignoreBtn = false;
-            }
-                
             break;
 
         case USB_DEVICE_EVENT_RESET :
@@ -164,6 +145,7 @@ USB_DEVICE_EVENT_RESPONSE APP_USBDeviceEventHandler
             {
                 appData.deviceIsConfigured = true;
                 USB_DEVICE_CDC_EventHandlerSet(USB_DEVICE_CDC_INDEX_0, USBDeviceCDCEventHandler, 0);
+                USB_DEVICE_VENDOR_EventHandlerSet(USB_DEVICE_VENDOR_INDEX_0, USBDeviceVendorEventHandler, 0);
                 // Device is enumerated. Register here the USB Function Driver Event Handler function.
             }
             break;
@@ -192,6 +174,15 @@ USB_DEVICE_EVENT_RESPONSE APP_USBDeviceEventHandler
             // Application can now respond to the Setup packet by submitting a buffer
             // to receive 32 bytes in the  control write transfer */
             // USB_DEVICE_ControlReceive(appData.usbDevHandle, data, 32);
+
+            // The only device request handled here is the Microsoft OS 2.0
+            // descriptor request that lets Windows bind WinUSB to the vendor
+            // interface. Anything else is stalled.
+            if (USB_DEVICE_VENDOR_MSOS20RequestProcess(appData.usbDevHandle,
+                    (USB_SETUP_PACKET *)pData, &usbDeviceVendorMsOs20Descriptor) == false)
+            {
+                USB_DEVICE_ControlStatus(appData.usbDevHandle, USB_DEVICE_CONTROL_STATUS_ERROR);
+            }
             break;
 
         case USB_DEVICE_EVENT_CONTROL_TRANSFER_DATA_RECEIVED:
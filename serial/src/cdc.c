@@ -27,8 +27,11 @@
 // *****************************************************************************
 // *****************************************************************************
 
+#include <string.h>
 #include "cdc.h"
 #include "app.h"
+#include "input.h"
+#include "command.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -53,8 +56,8 @@
 
 CDC_DATA cdcData;
 extern APP_DATA appData;
-uint8_t receiveDataBuffer[512] CACHE_ALIGN;
-uint8_t CACHE_ALIGN switchPrompt[] = "\r\nPUSH BUTTON PRESSED\r\n";
+uint8_t receiveDataBuffer[CDC_RX_BUFFER_SIZE] CACHE_ALIGN;
+uint8_t receiveReadBuffer[CDC_RX_READ_SIZE] USB_ALIGN;
 
 // *****************************************************************************
 // *****************************************************************************
@@ -169,6 +172,10 @@ USB_DEVICE_CDC_EVENT_RESPONSE USBDeviceCDCEventHandler
                 USB_DEVICE_CDC_EVENT_DATA_READ_COMPLETE * readObj = (USB_DEVICE_CDC_EVENT_DATA_READ_COMPLETE *)pData;
                 if (readObj->handle == cdcData.rdTransferHandle)
                 {
+                    if (readObj->status == USB_DEVICE_CDC_RESULT_OK)
+                    {
+                        cdcData.rxReadLength = readObj->length;
+                    }
                     cdcData.cdcReadCompleted = true;
                 }
             }
@@ -197,8 +204,69 @@ USB_DEVICE_CDC_EVENT_RESPONSE USBDeviceCDCEventHandler
 // *****************************************************************************
 
 
-/* TODO:  Add any necessary local functions.
-*/
+/* Appends the last read to the bytes of an incomplete frame, runs the
+   received frames through the command protocol and queues the next read */
+static void CDC_ReceiveProcess ( void )
+{
+    size_t consumed;
+    size_t readSize;
+    bool allProcessed;
+
+    if (cdcData.rxReadLength > 0U)
+    {
+        (void) memcpy(&receiveDataBuffer[cdcData.rxLength], receiveReadBuffer, cdcData.rxReadLength);
+        cdcData.rxLength += cdcData.rxReadLength;
+        cdcData.rxReadLength = 0;
+    }
+
+    allProcessed = COMMAND_RxProcess(receiveDataBuffer, cdcData.rxLength, &consumed);
+    if (consumed > 0U)
+    {
+        (void) memmove(receiveDataBuffer, &receiveDataBuffer[consumed], cdcData.rxLength - consumed);
+        cdcData.rxLength -= consumed;
+    }
+
+    /* Frames left behind because the transmit buffer was full are processed
+     * before more data is accepted from the host */
+    readSize = (CDC_RX_BUFFER_SIZE - cdcData.rxLength) & ~(CDC_RX_PACKET_SIZE - 1U);
+    if (readSize > CDC_RX_READ_SIZE)
+    {
+        readSize = CDC_RX_READ_SIZE;
+    }
+
+    if (allProcessed && (readSize > 0U))
+    {
+        cdcData.cdcReadCompleted = false;
+        if (USB_DEVICE_CDC_Read(USB_DEVICE_CDC_INDEX_0, &cdcData.rdTransferHandle,
+                receiveReadBuffer, readSize) != USB_DEVICE_CDC_RESULT_OK)
+        {
+            cdcData.cdcReadCompleted = true;
+        }
+    }
+}
+
+/* Writes the frames collected by the command protocol */
+static void CDC_TransmitProcess ( void )
+{
+    uint8_t * buffer;
+    size_t length;
+
+    if (!cdcData.cdcWriteCompleted)
+    {
+        return;
+    }
+
+    buffer = COMMAND_TxBufferGet(&length);
+    if (buffer != NULL)
+    {
+        cdcData.cdcWriteCompleted = false;
+        if (USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle,
+                buffer, length, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE) != USB_DEVICE_CDC_RESULT_OK)
+        {
+            cdcData.cdcWriteCompleted = true;
+        }
+    }
+}
 
 
 // *****************************************************************************
@@ -239,6 +307,17 @@ void CDC_Initialize ( void )
 
 void CDC_Tasks ( void )
 {
+    INPUT_EVENT inputEvent;
+
+    /* Presses made while the device is not configured are not reported */
+    while (INPUT_EventGet(&inputEvent))
+    {
+        if ((inputEvent.source == INPUT_SOURCE_BTN_1) && (inputEvent.edge == INPUT_EDGE_PRESSED)
+                && (cdcData.state == CDC_STATE_SERVICE_TASKS))
+        {
+            (void) COMMAND_EventPost(COMMAND_EVENT_BUTTON_PRESSED, NULL, 0);
+        }
+    }
 
     /* Check the application's current state. */
     switch ( cdcData.state )
@@ -249,8 +328,11 @@ void CDC_Tasks ( void )
 
             if (appData.deviceIsConfigured)
             {
-                cdcData.cdcReadCompleted = false;
-                USB_DEVICE_CDC_Read(USB_DEVICE_CDC_INDEX_0, &cdcData.rdTransferHandle, receiveDataBuffer, 512);
+                COMMAND_Initialize();
+                cdcData.rxLength = 0;
+                cdcData.rxReadLength = 0;
+                cdcData.cdcReadCompleted = true;
+                CDC_ReceiveProcess();
                 cdcData.state = CDC_STATE_SERVICE_TASKS;
             }
             break;
@@ -264,24 +346,12 @@ void CDC_Tasks ( void )
                 cdcData.cdcWriteCompleted = true;
                 break;
             }
+            /* The receive buffer is only touched while no read is queued */
             if (cdcData.cdcReadCompleted)
             {
-                if (receiveDataBuffer[0] == 'T')
-                {
-                    LED_B_Toggle();
-                }
-                cdcData.cdcReadCompleted = false;
-                USB_DEVICE_CDC_Read(USB_DEVICE_CDC_INDEX_0, &cdcData.rdTransferHandle, receiveDataBuffer, 512);
-            }
-            if (cdcData.btnPressed)
-            {
-                if (cdcData.cdcWriteCompleted)
-                {
-                    cdcData.btnPressed = false;
-                    cdcData.cdcWriteCompleted = false;
-                    USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &cdcData.wrTransferHandle, switchPrompt, sizeof(switchPrompt), USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
-                }
+                CDC_ReceiveProcess();
             }
+            CDC_TransmitProcess();
             break;
         }
 
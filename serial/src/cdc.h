@@ -89,19 +89,32 @@ typedef struct
     CDC_STATES state;
 
     /* TODO: Define any additional data used by the application. */
-    bool btnPressed;
-    bool debouncing;
-    bool ignoreBtn;
-    uint16_t btnDebounceCNT;
     bool cdcReadCompleted;
     bool cdcWriteCompleted;
     bool cdcSerialStateNotificationCompleted;
     USB_DEVICE_CDC_TRANSFER_HANDLE rdTransferHandle;
     USB_DEVICE_CDC_TRANSFER_HANDLE wrTransferHandle;
 
+    /* Bytes held in the receive buffer that are not processed yet */
+    size_t rxLength;
+
+    /* Bytes of the last read, waiting in the read buffer to be appended to
+       the receive buffer. Set by the read complete event. */
+    size_t rxReadLength;
+
 } CDC_DATA;
 
-#define BTN_DEBOUNCE_COUNT 150
+/* Size of the receive buffer. Holds a partial frame plus at least one read. */
+#define CDC_RX_BUFFER_SIZE 1024U
+
+/* Bulk OUT endpoint size. Reads must be a multiple of it. */
+#define CDC_RX_PACKET_SIZE 64U
+
+/* Size of the read buffer. The USB controller DMA needs a word aligned
+   buffer, which the end of a partial frame in the receive buffer is not, so
+   the data is read here and then appended to the receive buffer. */
+#define CDC_RX_READ_SIZE (8U * CDC_RX_PACKET_SIZE)
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Application Callback Routines
@@ -0,0 +1,441 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    command.c
+
+  Summary:
+    This file contains the source code for the framed command protocol.
+
+  Description:
+    This file contains the source code for the framed command protocol. Frames
+    are decoded in place in the CDC receive buffer and dispatched through a
+    constant table indexed by the command byte. Each handler writes its
+    response payload straight into the transmit buffer behind room for the
+    response header, and the response is then COBS encoded in place, so a
+    request is never copied on its way through the protocol.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "command.h"
+#include "definitions.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+static COMMAND_STATUS F_COMMAND_Ping(const uint8_t * request, size_t requestLength, uint8_t * response, size_t * responseLength);
+static COMMAND_STATUS F_COMMAND_Version(const uint8_t * request, size_t requestLength, uint8_t * response, size_t * responseLength);
+static COMMAND_STATUS F_COMMAND_Led(const uint8_t * request, size_t requestLength, uint8_t * response, size_t * responseLength);
+static COMMAND_STATUS F_COMMAND_Statistics(const uint8_t * request, size_t requestLength, uint8_t * response, size_t * responseLength);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Command table. Indexed by the command byte of the request. */
+static const COMMAND_DESCRIPTOR commandTable[COMMAND_ID_COUNT] =
+{
+    [COMMAND_ID_PING] =
+    {
+        .requestLengthMin = 0U,
+        .requestLengthMax = (uint8_t)COMMAND_RESPONSE_PAYLOAD_SIZE_MAX,
+        .handler = F_COMMAND_Ping,
+    },
+    [COMMAND_ID_VERSION] =
+    {
+        .requestLengthMin = 0U,
+        .requestLengthMax = 0U,
+        .handler = F_COMMAND_Version,
+    },
+    [COMMAND_ID_LED] =
+    {
+        .requestLengthMin = 1U,
+        .requestLengthMax = 1U,
+        .handler = F_COMMAND_Led,
+    },
+    [COMMAND_ID_STATISTICS] =
+    {
+        .requestLengthMin = 0U,
+        .requestLengthMax = 0U,
+        .handler = F_COMMAND_Statistics,
+    },
+};
+
+/* Protocol state */
+static struct
+{
+    /* Transmit buffers. Frames are collected in txBuffer[txIndex]. */
+    uint8_t txBuffer[2][COMMAND_TX_BUFFER_SIZE];
+    uint32_t txIndex;
+    size_t txLength;
+
+    /* True while the rest of an overlong frame is skipped */
+    bool rxDiscard;
+
+    /* Sequence number expected in the next request */
+    uint8_t sequenceNext;
+    bool sequenceValid;
+
+    /* Sequence number of the next event */
+    uint8_t eventSequence;
+
+    COMMAND_STATISTICS statistics;
+
+} commandData CACHE_ALIGN;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Decodes the COBS frame of length bytes at frame in place. The frame does
+   not include the delimiter. Returns false if the frame is malformed. */
+static bool F_COMMAND_CobsDecode ( uint8_t * frame, size_t length, size_t * decodedLength )
+{
+    size_t readIndex = 0;
+    size_t writeIndex = 0;
+    size_t code;
+
+    while (readIndex < length)
+    {
+        code = frame[readIndex];
+        if ((readIndex + code) > length)
+        {
+            return false;
+        }
+        readIndex++;
+
+        /* The decoded data never overtakes the encoded data */
+        (void) memmove(&frame[writeIndex], &frame[readIndex], code - 1U);
+        writeIndex += code - 1U;
+        readIndex += code - 1U;
+
+        /* Every block but the last and the full ones ends in a zero */
+        if ((code != 0xFFU) && (readIndex < length))
+        {
+            frame[writeIndex] = 0U;
+            writeIndex++;
+        }
+    }
+
+    *decodedLength = writeIndex;
+    return true;
+}
+
+/* Encodes the length bytes at frame + 1 in place and appends the delimiter.
+   length must not exceed COMMAND_FRAME_SIZE_MAX, so the frame is a single
+   COBS block and every data byte stays where it is. Every zero is replaced
+   by the distance to the next zero, and the code byte at frame[0] is the
+   distance to the first zero. Returns the encoded length. */
+static size_t F_COMMAND_CobsEncode ( uint8_t * frame, size_t length )
+{
+    size_t codeIndex = 0;
+    size_t index;
+
+    for (index = 1; index <= length; index++)
+    {
+        if (frame[index] == 0U)
+        {
+            frame[codeIndex] = (uint8_t)(index - codeIndex);
+            codeIndex = index;
+        }
+    }
+
+    frame[codeIndex] = (uint8_t)(length + 1U - codeIndex);
+    frame[length + 1U] = 0U;
+
+    return length + 2U;
+}
+
+/* Executes the decoded request and appends the encoded response to the
+   transmit buffer */
+static void F_COMMAND_Execute ( const uint8_t * request, size_t length )
+{
+    uint8_t * frame = &commandData.txBuffer[commandData.txIndex][commandData.txLength];
+    uint8_t * response = &frame[1];
+    uint8_t sequence = request[0];
+    uint8_t command = request[1];
+    size_t requestLength = length - COMMAND_REQUEST_HEADER_SIZE;
+    size_t responseLength = COMMAND_RESPONSE_PAYLOAD_SIZE_MAX;
+    const COMMAND_DESCRIPTOR * descriptor;
+    COMMAND_STATUS status;
+
+    if (commandData.sequenceValid && (sequence != commandData.sequenceNext))
+    {
+        commandData.statistics.sequenceErrors++;
+    }
+    commandData.sequenceNext = sequence + 1U;
+    commandData.sequenceValid = true;
+    commandData.statistics.requests++;
+
+    if ((command >= (uint8_t)COMMAND_ID_COUNT) || (commandTable[command].handler == NULL))
+    {
+        status = COMMAND_STATUS_UNKNOWN_COMMAND;
+    }
+    else
+    {
+        descriptor = &commandTable[command];
+        if ((requestLength < descriptor->requestLengthMin) || (requestLength > descriptor->requestLengthMax))
+        {
+            status = COMMAND_STATUS_INVALID_LENGTH;
+        }
+        else
+        {
+            status = descriptor->handler(&request[COMMAND_REQUEST_HEADER_SIZE], requestLength,
+                    &response[COMMAND_RESPONSE_HEADER_SIZE], &responseLength);
+        }
+    }
+
+    if (status != COMMAND_STATUS_OK)
+    {
+        responseLength = 0;
+    }
+
+    response[0] = sequence;
+    response[1] = command;
+    response[2] = (uint8_t)status;
+
+    commandData.txLength += F_COMMAND_CobsEncode(frame, responseLength + COMMAND_RESPONSE_HEADER_SIZE);
+}
+
+static COMMAND_STATUS F_COMMAND_Ping ( const uint8_t * request, size_t requestLength, uint8_t * response, size_t * responseLength )
+{
+    (void) memcpy(response, request, requestLength);
+    *responseLength = requestLength;
+
+    return COMMAND_STATUS_OK;
+}
+
+static COMMAND_STATUS F_COMMAND_Version ( const uint8_t * request, size_t requestLength, uint8_t * response, size_t * responseLength )
+{
+    response[0] = (uint8_t)COMMAND_PROTOCOL_VERSION;
+    response[1] = (uint8_t)COMMAND_FRAME_SIZE_MAX;
+    *responseLength = 2;
+
+    return COMMAND_STATUS_OK;
+}
+
+static COMMAND_STATUS F_COMMAND_Led ( const uint8_t * request, size_t requestLength, uint8_t * response, size_t * responseLength )
+{
+    switch (request[0])
+    {
+        case 0U:
+            LED_B_Clear();
+            break;
+
+        case 1U:
+            LED_B_Set();
+            break;
+
+        case 2U:
+            LED_B_Toggle();
+            break;
+
+        default:
+            return COMMAND_STATUS_INVALID_PARAMETER;
+    }
+
+    *responseLength = 0;
+
+    return COMMAND_STATUS_OK;
+}
+
+static COMMAND_STATUS F_COMMAND_Statistics ( const uint8_t * request, size_t requestLength, uint8_t * response, size_t * responseLength )
+{
+    /* Little endian, in the order of COMMAND_STATISTICS */
+    (void) memcpy(response, &commandData.statistics, sizeof(COMMAND_STATISTICS));
+    *responseLength = sizeof(COMMAND_STATISTICS);
+
+    return COMMAND_STATUS_OK;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Protocol Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void COMMAND_Initialize ( void )
+
+  Remarks:
+    See prototype in command.h.
+ */
+
+void COMMAND_Initialize ( void )
+{
+    commandData.txIndex = 0;
+    commandData.txLength = 0;
+    commandData.rxDiscard = false;
+    commandData.sequenceValid = false;
+    commandData.eventSequence = 0;
+    (void) memset(&commandData.statistics, 0, sizeof(commandData.statistics));
+}
+
+
+/*******************************************************************************
+  Function:
+    bool COMMAND_RxProcess ( uint8_t * buffer, size_t length, size_t * consumed )
+
+  Remarks:
+    See prototype in command.h.
+ */
+
+bool COMMAND_RxProcess ( uint8_t * buffer, size_t length, size_t * consumed )
+{
+    size_t start = 0;
+    size_t end;
+    size_t decodedLength;
+    uint8_t * delimiter;
+
+    while (start < length)
+    {
+        delimiter = memchr(&buffer[start], 0, length - start);
+        if (delimiter == NULL)
+        {
+            if ((length - start) >= COMMAND_FRAME_ENCODED_SIZE_MAX)
+            {
+                /* Too long for a frame. Skip up to the next delimiter. */
+                if (!commandData.rxDiscard)
+                {
+                    commandData.statistics.frameErrors++;
+                    commandData.rxDiscard = true;
+                }
+                start = length;
+            }
+            break;
+        }
+
+        end = (size_t)(delimiter - buffer);
+
+        if (commandData.rxDiscard)
+        {
+            commandData.rxDiscard = false;
+        }
+        else if (end == start)
+        {
+            /* Back to back delimiters are allowed to resynchronize */
+        }
+        else
+        {
+            if ((COMMAND_TX_BUFFER_SIZE - commandData.txLength) < COMMAND_FRAME_ENCODED_SIZE_MAX)
+            {
+                *consumed = start;
+                return false;
+            }
+
+            if (F_COMMAND_CobsDecode(&buffer[start], end - start, &decodedLength)
+                    && (decodedLength >= COMMAND_REQUEST_HEADER_SIZE))
+            {
+                F_COMMAND_Execute(&buffer[start], decodedLength);
+            }
+            else
+            {
+                commandData.statistics.frameErrors++;
+            }
+        }
+
+        start = end + 1U;
+    }
+
+    *consumed = start;
+    return true;
+}
+
+
+/*******************************************************************************
+  Function:
+    bool COMMAND_EventPost ( COMMAND_EVENT event, const uint8_t * payload,
+        size_t length )
+
+  Remarks:
+    See prototype in command.h.
+ */
+
+bool COMMAND_EventPost ( COMMAND_EVENT event, const uint8_t * payload, size_t length )
+{
+    uint8_t * frame = &commandData.txBuffer[commandData.txIndex][commandData.txLength];
+
+    if ((length > COMMAND_RESPONSE_PAYLOAD_SIZE_MAX)
+            || ((COMMAND_TX_BUFFER_SIZE - commandData.txLength) < (length + COMMAND_RESPONSE_HEADER_SIZE + 2U)))
+    {
+        commandData.statistics.eventsDropped++;
+        return false;
+    }
+
+    /* Events use the response layout with their own sequence numbers */
+    frame[1] = commandData.eventSequence;
+    frame[2] = (uint8_t)event;
+    frame[3] = (uint8_t)COMMAND_STATUS_OK;
+    if (length > 0U)
+    {
+        (void) memcpy(&frame[1U + COMMAND_RESPONSE_HEADER_SIZE], payload, length);
+    }
+    commandData.eventSequence++;
+
+    commandData.txLength += F_COMMAND_CobsEncode(frame, length + COMMAND_RESPONSE_HEADER_SIZE);
+
+    return true;
+}
+
+
+/*******************************************************************************
+  Function:
+    uint8_t * COMMAND_TxBufferGet ( size_t * length )
+
+  Remarks:
+    See prototype in command.h.
+ */
+
+uint8_t * COMMAND_TxBufferGet ( size_t * length )
+{
+    uint8_t * buffer;
+
+    if (commandData.txLength == 0U)
+    {
+        return NULL;
+    }
+
+    buffer = commandData.txBuffer[commandData.txIndex];
+    *length = commandData.txLength;
+
+    commandData.txIndex ^= 1U;
+    commandData.txLength = 0;
+
+    return buffer;
+}
+
+
+/*******************************************************************************
+  Function:
+    void COMMAND_StatisticsGet ( COMMAND_STATISTICS * statistics )
+
+  Remarks:
+    See prototype in command.h.
+ */
+
+void COMMAND_StatisticsGet ( COMMAND_STATISTICS * statistics )
+{
+    *statistics = commandData.statistics;
+}
+
+
+/*******************************************************************************
+ End of File
+ */
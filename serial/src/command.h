@@ -0,0 +1,346 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    command.h
+
+  Summary:
+    This header file provides prototypes and definitions for the framed
+    command protocol.
+
+  Description:
+    This header file provides function prototypes and data type definitions for
+    the framed command protocol carried on the CDC data interface. Frames are
+    COBS encoded and terminated by a zero byte. A decoded request is
+
+        [sequence] [command] [payload ...]
+
+    and its response is
+
+        [sequence] [command] [status] [payload ...]
+
+    The sequence number of a request is copied to its response, so the host can
+    keep many requests outstanding and match the responses, which always come
+    in request order. Frames whose command has COMMAND_EVENT_FLAG set are
+    unsolicited events sent by the device.
+*******************************************************************************/
+
+#ifndef _COMMAND_H
+#define _COMMAND_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Protocol version reported by COMMAND_ID_VERSION */
+#define COMMAND_PROTOCOL_VERSION 1U
+
+/* Largest decoded frame. Frames up to 254 bytes need a single COBS block,
+   which lets responses be encoded in place. */
+#define COMMAND_FRAME_SIZE_MAX 254U
+
+/* Largest encoded frame including the code byte and the delimiter */
+#define COMMAND_FRAME_ENCODED_SIZE_MAX (COMMAND_FRAME_SIZE_MAX + 2U)
+
+/* Size of a request and of a response header */
+#define COMMAND_REQUEST_HEADER_SIZE 2U
+#define COMMAND_RESPONSE_HEADER_SIZE 3U
+
+/* Largest response payload */
+#define COMMAND_RESPONSE_PAYLOAD_SIZE_MAX (COMMAND_FRAME_SIZE_MAX - COMMAND_RESPONSE_HEADER_SIZE)
+
+/* Size of each of the two transmit buffers. Responses are collected in one
+   buffer while the other one is written to the host. */
+#define COMMAND_TX_BUFFER_SIZE 1024U
+
+/* Set in the command byte of unsolicited event frames */
+#define COMMAND_EVENT_FLAG 0x80U
+
+// *****************************************************************************
+/* Command identifiers
+
+  Summary:
+    Identifies the request in the command byte of a frame.
+*/
+
+typedef enum
+{
+    /* Returns the request payload unchanged */
+    COMMAND_ID_PING = 0,
+
+    /* Returns the protocol version and the largest frame size */
+    COMMAND_ID_VERSION,
+
+    /* Payload is one byte: 0 turns LED_B off, 1 on, 2 toggles it */
+    COMMAND_ID_LED,
+
+    /* Returns COMMAND_STATISTICS */
+    COMMAND_ID_STATISTICS,
+
+    COMMAND_ID_COUNT
+
+} COMMAND_ID;
+
+// *****************************************************************************
+/* Event identifiers
+
+  Summary:
+    Identifies an unsolicited event frame. Always has COMMAND_EVENT_FLAG set.
+*/
+
+typedef enum
+{
+    /* BTN_1 was pressed. No payload. */
+    COMMAND_EVENT_BUTTON_PRESSED = COMMAND_EVENT_FLAG,
+
+} COMMAND_EVENT;
+
+// *****************************************************************************
+/* Response status
+
+  Summary:
+    Status byte of a response.
+*/
+
+typedef enum
+{
+    COMMAND_STATUS_OK = 0,
+    COMMAND_STATUS_UNKNOWN_COMMAND,
+    COMMAND_STATUS_INVALID_LENGTH,
+    COMMAND_STATUS_INVALID_PARAMETER,
+
+} COMMAND_STATUS;
+
+// *****************************************************************************
+/* Command handler
+
+  Summary:
+    Executes one request.
+
+  Description:
+    The handler reads requestLength payload bytes from request and writes the
+    response payload directly into the transmit buffer at response. On entry
+    responseLength is COMMAND_RESPONSE_PAYLOAD_SIZE_MAX, the handler sets it to
+    the length of the response payload.
+*/
+
+typedef COMMAND_STATUS (*COMMAND_HANDLER)
+(
+    const uint8_t * request,
+    size_t requestLength,
+    uint8_t * response,
+    size_t * responseLength
+);
+
+// *****************************************************************************
+/* Command table entry
+
+  Summary:
+    Describes one command of the compile-time command table.
+*/
+
+typedef struct
+{
+    /* Shortest and longest accepted request payload */
+    uint8_t requestLengthMin;
+    uint8_t requestLengthMax;
+
+    COMMAND_HANDLER handler;
+
+} COMMAND_DESCRIPTOR;
+
+// *****************************************************************************
+/* Protocol statistics
+
+  Summary:
+    Counters of the framed command protocol since COMMAND_Initialize.
+*/
+
+typedef struct
+{
+    /* Requests dispatched */
+    uint32_t requests;
+
+    /* Frames discarded because they could not be decoded, were shorter than
+       a request header or overran the receive buffer */
+    uint32_t frameErrors;
+
+    /* Requests whose sequence number did not follow the previous one */
+    uint32_t sequenceErrors;
+
+    /* Events lost because the transmit buffer was full */
+    uint32_t eventsDropped;
+
+} COMMAND_STATISTICS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Protocol Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void COMMAND_Initialize ( void )
+
+  Summary:
+    Initializes the framed command protocol.
+
+  Description:
+    This function empties the transmit buffers and clears the statistics. It is
+    called whenever the CDC data interface is (re)started.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+*/
+
+void COMMAND_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    bool COMMAND_RxProcess ( uint8_t * buffer, size_t length, size_t * consumed )
+
+  Summary:
+    Decodes and executes the complete frames in a receive buffer.
+
+  Description:
+    This function decodes every complete frame in buffer in place and executes
+    it through the command table. The responses are encoded into the transmit
+    buffer. Processing stops early when the transmit buffer cannot hold
+    another response.
+
+  Precondition:
+    COMMAND_Initialize must have been called.
+
+  Parameters:
+    buffer - Received bytes. The frames are decoded in place.
+
+    length - Number of received bytes in buffer.
+
+    consumed - Returns the number of bytes at the start of buffer that have
+    been processed and can be discarded.
+
+  Returns:
+    true if all complete frames were processed, false if processing stopped
+    because the transmit buffer is full.
+
+  Remarks:
+    A frame that is not terminated within COMMAND_FRAME_ENCODED_SIZE_MAX bytes
+    is discarded.
+*/
+
+bool COMMAND_RxProcess ( uint8_t * buffer, size_t length, size_t * consumed );
+
+
+/*******************************************************************************
+  Function:
+    bool COMMAND_EventPost ( COMMAND_EVENT event, const uint8_t * payload,
+        size_t length )
+
+  Summary:
+    Adds an unsolicited event frame to the transmit buffer.
+
+  Precondition:
+    COMMAND_Initialize must have been called.
+
+  Parameters:
+    event - Event identifier.
+
+    payload - Event payload, may be NULL if length is 0.
+
+    length - Length of the payload. At most COMMAND_RESPONSE_PAYLOAD_SIZE_MAX.
+
+  Returns:
+    true if the event was added, false if the transmit buffer is full.
+*/
+
+bool COMMAND_EventPost ( COMMAND_EVENT event, const uint8_t * payload, size_t length );
+
+
+/*******************************************************************************
+  Function:
+    uint8_t * COMMAND_TxBufferGet ( size_t * length )
+
+  Summary:
+    Takes the transmit buffer for writing to the host.
+
+  Description:
+    This function returns the transmit buffer with the encoded frames collected
+    so far and switches collection to the other buffer.
+
+  Precondition:
+    The buffer returned by the previous call must have been written
+    completely.
+
+  Parameters:
+    length - Returns the number of bytes to write.
+
+  Returns:
+    Pointer to the bytes to write, or NULL if there is nothing to send.
+*/
+
+uint8_t * COMMAND_TxBufferGet ( size_t * length );
+
+
+/*******************************************************************************
+  Function:
+    void COMMAND_StatisticsGet ( COMMAND_STATISTICS * statistics )
+
+  Summary:
+    Returns the protocol statistics.
+
+  Precondition:
+    COMMAND_Initialize must have been called.
+
+  Parameters:
+    statistics - Pointer to where the statistics are copied.
+
+  Returns:
+    None.
+*/
+
+void COMMAND_StatisticsGet ( COMMAND_STATISTICS * statistics );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _COMMAND_H */
+
+/*******************************************************************************
+ End of File
+ */
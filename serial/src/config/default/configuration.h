@@ -102,6 +102,14 @@ extern "C" {
    function driver */
 #define USB_DEVICE_CDC_QUEUE_DEPTH_COMBINED                 3U
 
+/* Maximum instances of Vendor function driver */
+#define USB_DEVICE_VENDOR_INSTANCES_NUMBER                  1U
+
+/* Vendor IRP ring depth for read and write. Applicable to
+   all instances of the function driver. Must be a power of 2. */
+#define USB_DEVICE_VENDOR_QUEUE_DEPTH_READ                  4U
+#define USB_DEVICE_VENDOR_QUEUE_DEPTH_WRITE                 4U
+
 /*** USB Driver Configuration ***/
 
 /* Maximum USB driver instances */
@@ -117,11 +125,21 @@ extern "C" {
 /* Enable usage of Dual Bank */
 #define DRV_USBFSV1_DUAL_BANK_ENABLE                        false
 
+/* Defer device IRP completion callbacks from the USB interrupt to
+   DRV_USBFSV1_Tasks. The ISR only queues completed IRPs. */
+#define DRV_USBFSV1_DEVICE_IRP_DEFERRED_COMPLETION          false
+
+/* Depth of the deferred IRP completion queue. Must be a power of 2. */
+#define DRV_USBFSV1_DEVICE_IRP_COMPLETION_QUEUE_DEPTH       16U
+
+/* Measure the device mode ISR execution time with the DWT cycle counter */
+#define DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE            false
+
 /* Alignment for buffers that are submitted to USB Driver*/ 
 #define USB_ALIGN  __ALIGNED(CACHE_LINE_SIZE)
 
 /* Number of Endpoints used */
-#define DRV_USBFSV1_ENDPOINTS_NUMBER                        3U
+#define DRV_USBFSV1_ENDPOINTS_NUMBER                        4U
 
 /* The USB Device Layer will not initialize the USB Driver */
 #define USB_DEVICE_DRIVER_INITIALIZE_EXPLICIT
@@ -132,8 +150,8 @@ extern "C" {
 /* EP0 size in bytes */
 #define USB_DEVICE_EP0_BUFFER_SIZE                          64U
 
-/* Enable SOF Events */
-#define USB_DEVICE_SOF_EVENT_ENABLE
+/* Enable BOS Descriptor (Microsoft OS 2.0 platform capability) */
+#define USB_DEVICE_BOS_DESCRIPTOR_SUPPORT_ENABLE
 
 
 
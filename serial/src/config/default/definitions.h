@@ -49,9 +49,12 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include "usb/usb_device_cdc.h"
+#include "usb/usb_device_vendor.h"
 #include "usb/usb_cdc.h"
 #include "peripheral/nvmctrl/plib_nvmctrl.h"
 #include "peripheral/evsys/plib_evsys.h"
+#include "peripheral/eic/plib_eic.h"
+#include "peripheral/tc/plib_tc0.h"
 #include "peripheral/port/plib_port.h"
 #include "peripheral/clock/plib_clock.h"
 #include "peripheral/nvic/plib_nvic.h"
@@ -64,7 +67,10 @@
 #include "osal/osal.h"
 #include "system/debug/sys_debug.h"
 #include "app.h"
+#include "input.h"
+#include "command.h"
 #include "cdc.h"
+#include "vendor.h"
 
 
 
@@ -210,6 +216,8 @@ typedef struct
 
 extern const USB_DEVICE_INIT usbDevInitData; 
 
+extern const USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR usbDeviceVendorMsOs20Descriptor;
+
 
 
 extern SYSTEM_OBJECTS sysObj;
@@ -561,6 +561,55 @@ typedef struct
 
 } DRV_USBFSV1_INIT;
 
+// *****************************************************************************
+/* USB Device Mode ISR Statistics
+
+  Summary:
+    Execution time statistics of the device mode interrupt handler.
+
+  Description:
+    This structure is filled by the DRV_USBFSV1_DEVICE_ISRStatisticsGet
+    function. Execution times are measured in CPU clock cycles using the DWT
+    cycle counter. The IRP counters show how many IRP callbacks were invoked
+    from the interrupt and how many were deferred to DRV_USBFSV1_Tasks.
+
+  Remarks:
+    Statistics are only collected when DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE
+    is set to true.
+*/
+
+typedef struct
+{
+    /* Number of times the device mode ISR was executed */
+    uint32_t isrCount;
+
+    /* Execution time of the last ISR in cycles */
+    uint32_t lastCycles;
+
+    /* Shortest ISR execution time in cycles */
+    uint32_t minCycles;
+
+    /* Longest ISR execution time in cycles */
+    uint32_t maxCycles;
+
+    /* Sum of all ISR execution times in cycles */
+    uint64_t totalCycles;
+
+    /* IRP callbacks invoked from the ISR */
+    uint32_t irpCallbacksInIsr;
+
+    /* IRP callbacks deferred to DRV_USBFSV1_Tasks */
+    uint32_t irpCallbacksDeferred;
+
+    /* Deferred completions that found the queue full and were invoked
+       from the ISR instead */
+    uint32_t irpQueueOverflows;
+
+    /* Highest number of entries seen in the completion queue */
+    uint32_t irpQueueHighWater;
+
+} DRV_USBFSV1_DEVICE_ISR_STATISTICS;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Interface Routines - System Level
@@ -1963,6 +2012,62 @@ USB_ERROR DRV_USBFSV1_DEVICE_IRPCancel
     DRV_HANDLE handle, 
     USB_DEVICE_IRP * irp
 );
+
+// *****************************************************************************
+/* Function:
+    bool DRV_USBFSV1_DEVICE_ISRStatisticsGet
+    (
+        SYS_MODULE_OBJ object,
+        DRV_USBFSV1_DEVICE_ISR_STATISTICS * statistics,
+        bool reset
+    )
+
+  Summary:
+    Returns the device mode ISR execution statistics.
+
+  Description:
+    This function copies the device mode ISR execution time and IRP completion
+    statistics of the driver instance into the structure pointed to by
+    statistics. If reset is true, the statistics are cleared after they have
+    been copied.
+
+  Precondition:
+    The DRV_USBFSV1_Initialize function must have been called for the specified
+    USB Driver instance.
+
+  Parameters:
+    object - Object handle for the specified driver instance (returned from
+    DRV_USBFSV1_Initialize).
+
+    statistics - Pointer to the structure that receives the statistics.
+
+    reset - If true, the statistics are cleared after being read.
+
+  Returns:
+    true - The statistics were copied.
+    false - The object is invalid or statistics collection is disabled.
+
+  Example:
+    <code>
+    DRV_USBFSV1_DEVICE_ISR_STATISTICS isrStats;
+
+    if(DRV_USBFSV1_DEVICE_ISRStatisticsGet(sysObj.drvUSBFSV1Object, &isrStats, true))
+    {
+        // Average ISR time is isrStats.totalCycles / isrStats.isrCount
+    }
+    </code>
+
+  Remarks:
+    Statistics are only collected when DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE
+    is set to true.
+*/
+
+bool DRV_USBFSV1_DEVICE_ISRStatisticsGet
+(
+    SYS_MODULE_OBJ object,
+    DRV_USBFSV1_DEVICE_ISR_STATISTICS * statistics,
+    bool reset
+);
 // ****************************************************************************
 /* Function:
     bool DRV_USBFSV1_HOST_EventsDisable
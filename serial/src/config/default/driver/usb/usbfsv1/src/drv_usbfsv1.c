@@ -326,6 +326,9 @@ void DRV_USBFSV1_Tasks
 
                 hDriver->vbusLevel = vbusLevel;
             }
+
+            /* Invoke the callbacks of IRPs completed in the ISR */
+            M_DRV_USBFSV1_DEVICE_IRP_COMPLETION_DRAIN(hDriver);
         }
         else if(hDriver->operationMode == DRV_USBFSV1_OPMODE_HOST)
         {
@@ -631,7 +634,9 @@ void DRV_USBFSV1_Tasks_ISR
                 case DRV_USBFSV1_OPMODE_DEVICE:
 
                     /* Driver is running in Device Mode */
+                    M_DRV_USBFSV1_DEVICE_ISR_STATISTICS_START(drvObj);
                     M_DRV_USBFSV1_DEVICE_TASKS_ISR(drvObj);
+                    M_DRV_USBFSV1_DEVICE_ISR_STATISTICS_STOP(drvObj);
                     break;
 
                 case DRV_USBFSV1_OPMODE_HOST:
@@ -660,6 +665,63 @@ void DRV_USBFSV1_Tasks_ISR
 
 }/* end of DRV_USBFSV1_Tasks_ISR() */
 
+// *****************************************************************************
+/* Function:
+    bool DRV_USBFSV1_DEVICE_ISRStatisticsGet
+    (
+        SYS_MODULE_OBJ object,
+        DRV_USBFSV1_DEVICE_ISR_STATISTICS * statistics,
+        bool reset
+    )
+
+  Summary:
+    Returns the device mode ISR execution statistics.
+
+  Remarks:
+    See drv_usbfsv1.h for usage information.
+*/
+
+bool DRV_USBFSV1_DEVICE_ISRStatisticsGet
+(
+    SYS_MODULE_OBJ object,
+    DRV_USBFSV1_DEVICE_ISR_STATISTICS * statistics,
+    bool reset
+)
+{
+    bool retVal = false;
+
+#if (DRV_USBFSV1_DEVICE_ISR_STATISTICS_ENABLE == true)
+    DRV_USBFSV1_OBJ * hDriver;
+    bool interruptWasEnabled;
+
+    if((object < DRV_USBFSV1_INSTANCES_NUMBER) && (statistics != NULL))
+    {
+        hDriver = &gDrvUSBFSV1Obj[object];
+
+        /* The ISR updates the statistics. Take a consistent copy. */
+        interruptWasEnabled = SYS_INT_Disable();
+
+        *statistics = hDriver->isrStatistics;
+
+        if(reset == true)
+        {
+            (void) memset(&hDriver->isrStatistics, 0, sizeof(DRV_USBFSV1_DEVICE_ISR_STATISTICS));
+            hDriver->isrStatistics.minCycles = UINT32_MAX;
+        }
+
+        SYS_INT_Restore(interruptWasEnabled);
+
+        retVal = true;
+    }
+#else
+    (void) object;
+    (void) statistics;
+    (void) reset;
+#endif
+
+    return retVal;
+}
+
 
 // *****************************************************************************
 /* Function:
@@ -184,6 +184,10 @@ void SYS_Initialize ( void* data )
 
     EVSYS_Initialize();
 
+    EIC_Initialize();
+
+    TC0_TimerInitialize();
+
 
     /* MISRAC 2012 deviation block start */
     /* Following MISRA-C rules deviated in this block  */
@@ -203,7 +207,9 @@ void SYS_Initialize ( void* data )
 
     /* MISRAC 2012 deviation block end */
     APP_Initialize();
+    INPUT_Initialize();
     CDC_Initialize();
+    VENDOR_Initialize();
 
 
     NVIC_Initialize();
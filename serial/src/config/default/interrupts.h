@@ -67,6 +67,7 @@ void DRV_USBFSV1_OTHER_Handler (void);
 void DRV_USBFSV1_SOF_HSOF_Handler (void);
 void DRV_USBFSV1_TRCPT0_Handler (void);
 void DRV_USBFSV1_TRCPT1_Handler (void);
+void TC0_TimerInterruptHandler (void);
 
 
 
@@ -0,0 +1,74 @@
+/*******************************************************************************
+  EIC Peripheral Library
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_eic.c
+
+  Summary:
+    EIC Source File
+
+  Description:
+    None
+
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+
+#include "plib_eic.h"
+#include "interrupts.h"
+
+
+
+void EIC_Initialize( void )
+{
+    /* Reset all registers in the EIC module to their initial state and
+       EIC will be disabled. */
+    EIC_REGS->EIC_CTRLA |= (uint8_t)EIC_CTRLA_SWRST_Msk;
+
+    while((EIC_REGS->EIC_SYNCBUSY & EIC_SYNCBUSY_SWRST_Msk) == EIC_SYNCBUSY_SWRST_Msk)
+    {
+        /* Wait for sync */
+    }
+
+    /* EIC is clocked by ULP32K so that the filter keeps working in standby */
+    EIC_REGS->EIC_CTRLA = (uint8_t)EIC_CTRLA_CKSEL_CLK_ULP32K;
+
+    /* Interrupt sense type and filter control for EXTINT channels 0 to 7 */
+    EIC_REGS->EIC_CONFIG[0] =  EIC_CONFIG_SENSE5_BOTH | EIC_CONFIG_FILTEN5_Msk;
+
+    /* Event output. The EXTINT interrupt itself is not used. */
+    EIC_REGS->EIC_EVCTRL = EIC_EVCTRL_EXTINTEO((uint32_t)1U << EIC_PIN_BTN_1);
+
+    /* Enable the EIC */
+    EIC_REGS->EIC_CTRLA |= (uint8_t)EIC_CTRLA_ENABLE_Msk;
+
+    while((EIC_REGS->EIC_SYNCBUSY & EIC_SYNCBUSY_ENABLE_Msk) == EIC_SYNCBUSY_ENABLE_Msk)
+    {
+        /* Wait for sync */
+    }
+}
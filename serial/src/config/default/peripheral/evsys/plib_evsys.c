@@ -45,8 +45,12 @@
 
 void EVSYS_Initialize( void )
 {
-    /*Event Channel User Configuration*/
+    /* Event Channel 0 Configuration: EIC EXTINT 5 (BTN_1) */
+    EVSYS_REGS->CHANNEL[0].EVSYS_CHANNEL = EVSYS_CHANNEL_EVGEN(EVENT_ID_GEN_EIC_EXTINT_5) | EVSYS_CHANNEL_PATH_ASYNCHRONOUS;
 
+    /*Event Channel User Configuration*/
+    /* TC0 EVU retriggers the debounce timer on every BTN_1 edge */
+    EVSYS_REGS->EVSYS_USER[EVENT_ID_USER_TC0_EVU] = 0x1U;
 }
 
 
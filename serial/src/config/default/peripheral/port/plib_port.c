@@ -74,7 +74,7 @@ void PORT_Initialize(void)
    PORT_REGS->GROUP[0].PORT_DIR = 0x10U;
    PORT_REGS->GROUP[0].PORT_OUT = 0x20U;
    PORT_REGS->GROUP[0].PORT_PINCFG[4] = 0x2U;
-   PORT_REGS->GROUP[0].PORT_PINCFG[5] = 0x6U;
+   PORT_REGS->GROUP[0].PORT_PINCFG[5] = 0x7U;
    PORT_REGS->GROUP[0].PORT_PINCFG[24] = 0x1U;
    PORT_REGS->GROUP[0].PORT_PINCFG[25] = 0x1U;
 
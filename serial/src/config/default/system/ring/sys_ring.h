@@ -0,0 +1,670 @@
+/*******************************************************************************
+  Ring Buffer System Service Library Interface Header File
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    sys_ring.h
+
+  Summary
+    Lock-free ring buffers to hand data from interrupts to tasks.
+
+  Description
+    This file implements, as inline functions, two ring buffers over a storage
+    array owned by the caller. The rings only manage positions. A position is
+    a free running 32-bit counter and SYS_RING_Index maps it to the storage
+    array, whose size must be a power of 2.
+
+    SYS_RING is a single producer, single consumer ring. The producer only
+    writes the head and the consumer only writes the tail, so neither side
+    needs to disable interrupts.
+
+    SYS_RING_MPSC accepts several producers, for example interrupts of
+    different priorities. Producers reserve slots with LDREX/STREX, or a C11
+    compare and exchange when the file is built for a host, and mark
+    each written slot in a sequence array. The consumer stops at the first
+    slot that is reserved but not yet written, so a producer preempted
+    between reservation and commit never blocks the others.
+
+    Both rings have a batch interface: the producer reserves or fills many
+    slots and publishes them at once, and the consumer releases many slots
+    at once.
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef SYS_RING_H    // Guards against multiple inclusion
+#define SYS_RING_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#if defined(__arm__)
+#include "device.h"
+#else
+#include <stdatomic.h>
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// DOM-IGNORE-BEGIN
+/* Orders the slot accesses against the position updates. The host build uses
+   the C11 fence, as the rings are then shared between threads. */
+#if defined(__arm__)
+    #define SYS_RING_BARRIER()      __DMB()
+#else
+    #define SYS_RING_BARRIER()      atomic_thread_fence(memory_order_seq_cst)
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Single producer, single consumer ring
+
+  Summary:
+    Positions of a single producer, single consumer ring.
+
+  Description:
+    head - tail is the number of slots in use. The storage array is declared
+    next to the ring by the user.
+*/
+
+typedef struct
+{
+    /* Next position to write. Only updated by the producer. */
+    volatile uint32_t head;
+
+    /* Next position to read. Only updated by the consumer. */
+    volatile uint32_t tail;
+
+    /* Number of slots minus 1 */
+    uint32_t mask;
+
+} SYS_RING;
+
+// *****************************************************************************
+/* Multiple producer, single consumer ring
+
+  Summary:
+    Positions of a multiple producer, single consumer ring.
+
+  Description:
+    The head is advanced by the producers when they reserve slots. A slot at
+    position p may be read once its sequence word holds p + 1.
+*/
+
+typedef struct
+{
+    /* head is the next position to reserve, tail the next to read */
+    SYS_RING ring;
+
+    /* One word per slot, written by the producer that filled the slot */
+    volatile uint32_t * sequence;
+
+} SYS_RING_MPSC;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Single Producer, Single Consumer Ring
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    void SYS_RING_Initialize ( SYS_RING * ring, uint32_t size )
+
+  Summary:
+    Initializes an empty ring.
+
+  Precondition:
+    None.
+
+  Parameters:
+    ring - Ring to initialize.
+
+    size - Number of slots of the storage array. Must be a power of 2.
+
+  Returns:
+    None.
+
+  Remarks:
+    Must not be called while a producer or the consumer uses the ring.
+*/
+
+static inline void SYS_RING_Initialize ( SYS_RING * ring, uint32_t size )
+{
+    ring->head = 0U;
+    ring->tail = 0U;
+    ring->mask = size - 1U;
+}
+
+//******************************************************************************
+/* Function:
+    uint32_t SYS_RING_Index ( const SYS_RING * ring, uint32_t position )
+
+  Summary:
+    Returns the storage array index of a position.
+*/
+
+static inline uint32_t SYS_RING_Index ( const SYS_RING * ring, uint32_t position )
+{
+    return (position & ring->mask);
+}
+
+//******************************************************************************
+/* Function:
+    uint32_t SYS_RING_FreeGet ( const SYS_RING * ring, uint32_t * position )
+
+  Summary:
+    Returns the number of slots the producer may fill.
+
+  Parameters:
+    ring - Ring to fill.
+
+    position - Returns the position of the first free slot.
+
+  Returns:
+    Number of free slots, starting at position.
+
+  Remarks:
+    Producer side. The slots are published with SYS_RING_Commit.
+*/
+
+static inline uint32_t SYS_RING_FreeGet ( const SYS_RING * ring, uint32_t * position )
+{
+    uint32_t head = ring->head;
+
+    *position = head;
+
+    return ((ring->mask + 1U) - (head - ring->tail));
+}
+
+//******************************************************************************
+/* Function:
+    void SYS_RING_Commit ( SYS_RING * ring, uint32_t count )
+
+  Summary:
+    Publishes the next count slots to the consumer.
+
+  Remarks:
+    Producer side. The slots must have been written before.
+*/
+
+static inline void SYS_RING_Commit ( SYS_RING * ring, uint32_t count )
+{
+    /* The slots must be visible before the consumer sees the new head */
+    SYS_RING_BARRIER();
+    ring->head = ring->head + count;
+}
+
+//******************************************************************************
+/* Function:
+    uint32_t SYS_RING_CountGet ( const SYS_RING * ring, uint32_t * position )
+
+  Summary:
+    Returns the number of slots the consumer may read.
+
+  Parameters:
+    ring - Ring to read.
+
+    position - Returns the position of the first slot to read.
+
+  Returns:
+    Number of published slots, starting at position.
+
+  Remarks:
+    Consumer side. The slots are handed back with SYS_RING_Release.
+*/
+
+static inline uint32_t SYS_RING_CountGet ( const SYS_RING * ring, uint32_t * position )
+{
+    uint32_t tail = ring->tail;
+    uint32_t count = ring->head - tail;
+
+    /* Read the slots only after the head update has been observed */
+    SYS_RING_BARRIER();
+    *position = tail;
+
+    return count;
+}
+
+//******************************************************************************
+/* Function:
+    void SYS_RING_Release ( SYS_RING * ring, uint32_t count )
+
+  Summary:
+    Hands the next count slots back to the producer.
+
+  Remarks:
+    Consumer side. The slots must not be read afterwards.
+*/
+
+static inline void SYS_RING_Release ( SYS_RING * ring, uint32_t count )
+{
+    /* The slots must have been read before the producer may reuse them */
+    SYS_RING_BARRIER();
+    ring->tail = ring->tail + count;
+}
+
+//******************************************************************************
+/* Function:
+    uint32_t SYS_RING_Write ( SYS_RING * ring, void * storage,
+        size_t elementSize, const void * elements, uint32_t count )
+
+  Summary:
+    Copies up to count elements into the ring and publishes them.
+
+  Parameters:
+    ring - Ring to fill.
+
+    storage - Storage array of the ring.
+
+    elementSize - Size of one element in bytes.
+
+    elements - Elements to copy.
+
+    count - Number of elements to copy.
+
+  Returns:
+    Number of elements copied, less than count if the ring is full.
+
+  Remarks:
+    Producer side. The copy is split in two at the end of the storage array.
+*/
+
+static inline uint32_t SYS_RING_Write ( SYS_RING * ring, void * storage,
+        size_t elementSize, const void * elements, uint32_t count )
+{
+    uint32_t position;
+    uint32_t index;
+    uint32_t first;
+    uint32_t freeCount = SYS_RING_FreeGet(ring, &position);
+
+    if (count > freeCount)
+    {
+        count = freeCount;
+    }
+
+    index = SYS_RING_Index(ring, position);
+    first = (ring->mask + 1U) - index;
+    if (first > count)
+    {
+        first = count;
+    }
+
+    (void) memcpy((uint8_t *)storage + (index * elementSize), elements, first * elementSize);
+    (void) memcpy(storage, (const uint8_t *)elements + (first * elementSize), (count - first) * elementSize);
+
+    SYS_RING_Commit(ring, count);
+
+    return count;
+}
+
+//******************************************************************************
+/* Function:
+    uint32_t SYS_RING_Read ( SYS_RING * ring, const void * storage,
+        size_t elementSize, void * elements, uint32_t count )
+
+  Summary:
+    Copies up to count elements out of the ring and releases them.
+
+  Parameters:
+    ring - Ring to read.
+
+    storage - Storage array of the ring.
+
+    elementSize - Size of one element in bytes.
+
+    elements - Buffer for the elements.
+
+    count - Number of elements the buffer can hold.
+
+  Returns:
+    Number of elements copied, less than count if the ring ran empty.
+
+  Remarks:
+    Consumer side.
+*/
+
+static inline uint32_t SYS_RING_Read ( SYS_RING * ring, const void * storage,
+        size_t elementSize, void * elements, uint32_t count )
+{
+    uint32_t position;
+    uint32_t index;
+    uint32_t first;
+    uint32_t usedCount = SYS_RING_CountGet(ring, &position);
+
+    if (count > usedCount)
+    {
+        count = usedCount;
+    }
+
+    index = SYS_RING_Index(ring, position);
+    first = (ring->mask + 1U) - index;
+    if (first > count)
+    {
+        first = count;
+    }
+
+    (void) memcpy(elements, (const uint8_t *)storage + (index * elementSize), first * elementSize);
+    (void) memcpy((uint8_t *)elements + (first * elementSize), storage, (count - first) * elementSize);
+
+    SYS_RING_Release(ring, count);
+
+    return count;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Multiple Producer, Single Consumer Ring
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    void SYS_RING_MPSC_Initialize ( SYS_RING_MPSC * ring,
+        volatile uint32_t * sequence, uint32_t size )
+
+  Summary:
+    Initializes an empty ring.
+
+  Parameters:
+    ring - Ring to initialize.
+
+    sequence - Array of size words, one per slot of the storage array.
+
+    size - Number of slots of the storage array. Must be a power of 2.
+
+  Returns:
+    None.
+
+  Remarks:
+    Must not be called while a producer or the consumer uses the ring.
+*/
+
+static inline void SYS_RING_MPSC_Initialize ( SYS_RING_MPSC * ring,
+        volatile uint32_t * sequence, uint32_t size )
+{
+    uint32_t i;
+
+    SYS_RING_Initialize(&ring->ring, size);
+    ring->sequence = sequence;
+
+    /* Position i is ready when its word holds i + 1 */
+    for (i = 0U; i < size; i++)
+    {
+        sequence[i] = 0U;
+    }
+}
+
+//******************************************************************************
+/* Function:
+    bool SYS_RING_MPSC_Reserve ( SYS_RING_MPSC * ring, uint32_t count,
+        uint32_t * position )
+
+  Summary:
+    Reserves count consecutive slots for one producer.
+
+  Parameters:
+    ring - Ring to fill.
+
+    count - Number of slots to reserve.
+
+    position - Returns the position of the first reserved slot.
+
+  Returns:
+    true if the slots were reserved, false if the ring has less than count
+    free slots.
+
+  Remarks:
+    Producer side, can be called from interrupts and tasks. The slots are
+    published with SYS_RING_MPSC_Commit.
+*/
+
+static inline bool SYS_RING_MPSC_Reserve ( SYS_RING_MPSC * ring, uint32_t count,
+        uint32_t * position )
+{
+    uint32_t head;
+
+#if defined(__arm__)
+    do
+    {
+        head = __LDREXW(&ring->ring.head);
+        if (((head - ring->ring.tail) + count) > (ring->ring.mask + 1U))
+        {
+            __CLREX();
+            return false;
+        }
+    } while (__STREXW(head + count, &ring->ring.head) != 0U);
+#else
+    /* uint32_t and its atomic type share size and alignment on the hosts
+       the project is built for */
+    head = ring->ring.head;
+    do
+    {
+        if (((head - ring->ring.tail) + count) > (ring->ring.mask + 1U))
+        {
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak((volatile _Atomic uint32_t *)&ring->ring.head, &head, head + count));
+#endif
+
+    *position = head;
+
+    return true;
+}
+
+//******************************************************************************
+/* Function:
+    void SYS_RING_MPSC_Commit ( SYS_RING_MPSC * ring, uint32_t position,
+        uint32_t count )
+
+  Summary:
+    Publishes slots reserved with SYS_RING_MPSC_Reserve.
+
+  Remarks:
+    Producer side. The slots must have been written before. Slots of other
+    producers that were reserved earlier may still be unpublished.
+*/
+
+static inline void SYS_RING_MPSC_Commit ( SYS_RING_MPSC * ring, uint32_t position,
+        uint32_t count )
+{
+    uint32_t i;
+
+    /* The slots must be visible before the consumer sees them ready */
+    SYS_RING_BARRIER();
+
+    for (i = 0U; i < count; i++)
+    {
+        ring->sequence[SYS_RING_Index(&ring->ring, position + i)] = position + i + 1U;
+    }
+}
+
+//******************************************************************************
+/* Function:
+    uint32_t SYS_RING_MPSC_CountGet ( const SYS_RING_MPSC * ring,
+        uint32_t * position )
+
+  Summary:
+    Returns the number of consecutive published slots the consumer may read.
+
+  Remarks:
+    Consumer side. The count stops at the first slot that is reserved but not
+    published yet. The slots are handed back with SYS_RING_MPSC_Release.
+*/
+
+static inline uint32_t SYS_RING_MPSC_CountGet ( const SYS_RING_MPSC * ring,
+        uint32_t * position )
+{
+    uint32_t tail = ring->ring.tail;
+    uint32_t reserved = ring->ring.head - tail;
+    uint32_t count = 0U;
+
+    while ((count < reserved) &&
+           (ring->sequence[SYS_RING_Index(&ring->ring, tail + count)] == (tail + count + 1U)))
+    {
+        count++;
+    }
+
+    /* Read the slots only after their sequence words have been observed */
+    SYS_RING_BARRIER();
+    *position = tail;
+
+    return count;
+}
+
+//******************************************************************************
+/* Function:
+    void SYS_RING_MPSC_Release ( SYS_RING_MPSC * ring, uint32_t count )
+
+  Summary:
+    Hands the next count slots back to the producers.
+
+  Remarks:
+    Consumer side.
+*/
+
+static inline void SYS_RING_MPSC_Release ( SYS_RING_MPSC * ring, uint32_t count )
+{
+    SYS_RING_Release(&ring->ring, count);
+}
+
+//******************************************************************************
+/* Function:
+    bool SYS_RING_MPSC_Write ( SYS_RING_MPSC * ring, void * storage,
+        size_t elementSize, const void * elements, uint32_t count )
+
+  Summary:
+    Copies count elements into the ring and publishes them.
+
+  Returns:
+    true if the elements were copied, false if the ring has less than count
+    free slots. Nothing is copied in that case.
+
+  Remarks:
+    Producer side, can be called from interrupts and tasks.
+*/
+
+static inline bool SYS_RING_MPSC_Write ( SYS_RING_MPSC * ring, void * storage,
+        size_t elementSize, const void * elements, uint32_t count )
+{
+    uint32_t position;
+    uint32_t index;
+    uint32_t first;
+
+    if (!SYS_RING_MPSC_Reserve(ring, count, &position))
+    {
+        return false;
+    }
+
+    index = SYS_RING_Index(&ring->ring, position);
+    first = (ring->ring.mask + 1U) - index;
+    if (first > count)
+    {
+        first = count;
+    }
+
+    (void) memcpy((uint8_t *)storage + (index * elementSize), elements, first * elementSize);
+    (void) memcpy(storage, (const uint8_t *)elements + (first * elementSize), (count - first) * elementSize);
+
+    SYS_RING_MPSC_Commit(ring, position, count);
+
+    return true;
+}
+
+//******************************************************************************
+/* Function:
+    uint32_t SYS_RING_MPSC_Read ( SYS_RING_MPSC * ring, const void * storage,
+        size_t elementSize, void * elements, uint32_t count )
+
+  Summary:
+    Copies up to count published elements out of the ring and releases them.
+
+  Returns:
+    Number of elements copied.
+
+  Remarks:
+    Consumer side.
+*/
+
+static inline uint32_t SYS_RING_MPSC_Read ( SYS_RING_MPSC * ring, const void * storage,
+        size_t elementSize, void * elements, uint32_t count )
+{
+    uint32_t position;
+    uint32_t index;
+    uint32_t first;
+    uint32_t readyCount = SYS_RING_MPSC_CountGet(ring, &position);
+
+    if (count > readyCount)
+    {
+        count = readyCount;
+    }
+
+    index = SYS_RING_Index(&ring->ring, position);
+    first = (ring->ring.mask + 1U) - index;
+    if (first > count)
+    {
+        first = count;
+    }
+
+    (void) memcpy(elements, (const uint8_t *)storage + (index * elementSize), first * elementSize);
+    (void) memcpy((uint8_t *)elements + (first * elementSize), storage, (count - first) * elementSize);
+
+    SYS_RING_MPSC_Release(ring, count);
+
+    return count;
+}
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    }
+#endif
+//DOM-IGNORE-END
+
+#endif // SYS_RING_H
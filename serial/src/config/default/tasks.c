@@ -94,6 +94,9 @@ void SYS_Tasks ( void )
     /* Call Application task CDC. */
     CDC_Tasks();
 
+    /* Call Application task VENDOR. */
+    VENDOR_Tasks();
+
 
 
 
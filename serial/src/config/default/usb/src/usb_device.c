@@ -1099,6 +1099,41 @@ USB_SPEED USB_DEVICE_ActiveSpeedGet(USB_DEVICE_HANDLE usbDeviceHandle)
     return(devClientHandle->usbDeviceStatusStruct.usbSpeed);
 }
 
+// *****************************************************************************
+/* Function:
+    uint16_t USB_DEVICE_SOFNumberGet(USB_DEVICE_HANDLE usbDeviceHandle)
+
+  Summary:
+    Returns the frame number of the last SOF received from the host.
+
+  Description:
+    This function returns the frame number of the last SOF received from the
+    host, as reported by the USB controller driver.
+
+  Precondition:
+    The USB device layer must have been initialized and a valid handle
+    to USB device layer must have been opened.
+
+  Remarks:
+    See usb_device.h for usage information.
+*/
+
+uint16_t USB_DEVICE_SOFNumberGet(USB_DEVICE_HANDLE usbDeviceHandle)
+{
+    USB_DEVICE_OBJ* devClientHandle;
+
+    /* Validate the handle */
+    devClientHandle = F_USB_DEVICE_ClientHandleValidate(usbDeviceHandle);
+
+    if(devClientHandle == NULL)
+    {
+        SYS_DEBUG_MESSAGE(SYS_ERROR_INFO, "\r\nUSB Device Layer: Invalid Handle");
+        return(0);
+    }
+
+    return(devClientHandle->driverInterface->deviceSOFNumberGet(devClientHandle->usbCDHandle));
+}
+
 // *****************************************************************************
 /* Function:
     USB_DEVICE_CONTROL_TRANSFER_RESULT USB_DEVICE_ControlSend
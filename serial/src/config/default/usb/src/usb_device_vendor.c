@@ -0,0 +1,912 @@
+/*******************************************************************************
+ USB Vendor Class Function Driver
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    usb_device_vendor.c
+
+  Summary:
+    USB Vendor class function driver.
+
+  Description:
+    USB Vendor class function driver. The driver owns one vendor specific
+    interface with a bulk OUT and a bulk IN endpoint and streams raw data
+    through a ring of IRPs on each endpoint.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "usb/usb_device_vendor.h"
+#include "usb/src/usb_device_vendor_local.h"
+#include "usb/src/usb_external_dependencies.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: File Scope or Global Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Vendor Device function driver structure
+
+  Summary:
+    Defines the function driver structure required for the device layer.
+
+  Description:
+    This data type defines the function driver structure required for the
+    device layer.
+
+  Remarks:
+    This structure is private to the USB stack.
+*/
+
+const USB_DEVICE_FUNCTION_DRIVER vendorFunctionDriver =
+{
+
+    /* Vendor init function */
+    .initializeByDescriptor         = F_USB_DEVICE_VENDOR_Initialization ,
+
+    /* Vendor de-init function */
+    .deInitialize                   = F_USB_DEVICE_VENDOR_Deinitialization ,
+
+    /* EP0 activity callback */
+    .controlTransferNotification    = F_USB_DEVICE_VENDOR_ControlTransferHandler,
+
+    /* Vendor tasks function */
+    .tasks                          = NULL,
+
+    /* Vendor Global Initialize */
+    .globalInitialize               = NULL
+};
+
+// *****************************************************************************
+/* Vendor Device IRPs
+
+  Summary:
+    IRP rings of the Vendor instances.
+
+  Description:
+    Each instance owns a ring of read IRPs and a ring of write IRPs. The rings
+    are not shared between instances or directions so no lock is needed to
+    find a free IRP.
+
+  Remarks:
+    These arrays are private to the USB stack.
+*/
+
+static USB_DEVICE_IRP gUSBDeviceVendorReadIRP[USB_DEVICE_VENDOR_INSTANCES_NUMBER][USB_DEVICE_VENDOR_QUEUE_DEPTH_READ];
+static USB_DEVICE_IRP gUSBDeviceVendorWriteIRP[USB_DEVICE_VENDOR_INSTANCES_NUMBER][USB_DEVICE_VENDOR_QUEUE_DEPTH_WRITE];
+
+// *****************************************************************************
+/* Vendor Instance structure
+
+  Summary:
+    Defines the Vendor instance(s).
+
+  Description:
+    This data type defines the Vendor instance(s). The number of instances is
+    defined by the application using USB_DEVICE_VENDOR_INSTANCES_NUMBER.
+
+  Remarks:
+    This structure is private to the Vendor function driver.
+*/
+
+static USB_DEVICE_VENDOR_INSTANCE gUSBDeviceVendorInstance[USB_DEVICE_VENDOR_INSTANCES_NUMBER];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: File Scope Functions
+// *****************************************************************************
+// *****************************************************************************
+
+// ******************************************************************************
+/* Function:
+    static void F_USB_DEVICE_VENDOR_RingReset
+    (
+        USB_DEVICE_VENDOR_IRP_RING * ring,
+        USB_DEVICE_IRP * irp,
+        uint32_t depth,
+        size_t queueSize
+    )
+
+  Summary:
+    Resets an IRP ring.
+
+  Description:
+    This function empties an IRP ring and limits the number of outstanding IRPs
+    to queueSize.
+
+  Remarks:
+    This is local function and should not be called directly by the application.
+*/
+
+static void F_USB_DEVICE_VENDOR_RingReset
+(
+    USB_DEVICE_VENDOR_IRP_RING * ring,
+    USB_DEVICE_IRP * irp,
+    uint32_t depth,
+    size_t queueSize
+)
+{
+    ring->irp = irp;
+    ring->depth = depth;
+    ring->queueSize = ((queueSize == 0U) || (queueSize > depth)) ? depth : (uint32_t)queueSize;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->count = 0;
+}
+
+// ******************************************************************************
+/* Function:
+    static USB_DEVICE_VENDOR_RESULT F_USB_DEVICE_VENDOR_IRPStatusToResult
+    (
+        USB_DEVICE_IRP_STATUS status
+    )
+
+  Summary:
+    Maps the IRP completion status to a Vendor result.
+
+  Description:
+    Maps the IRP completion status to a Vendor result.
+
+  Remarks:
+    This is local function and should not be called directly by the application.
+*/
+
+static USB_DEVICE_VENDOR_RESULT F_USB_DEVICE_VENDOR_IRPStatusToResult
+(
+    USB_DEVICE_IRP_STATUS status
+)
+{
+    USB_DEVICE_VENDOR_RESULT result;
+
+    if ((status == USB_DEVICE_IRP_STATUS_COMPLETED)
+        || (status == USB_DEVICE_IRP_STATUS_COMPLETED_SHORT))
+    {
+        /* Transfer completed successfully */
+        result = USB_DEVICE_VENDOR_RESULT_OK;
+    }
+    else if (status == USB_DEVICE_IRP_STATUS_ABORTED_ENDPOINT_HALT)
+    {
+        /* Transfer cancelled due to Endpoint Halt */
+        result = USB_DEVICE_VENDOR_RESULT_ERROR_ENDPOINT_HALTED;
+    }
+    else if (status == USB_DEVICE_IRP_STATUS_TERMINATED_BY_HOST)
+    {
+        /* Transfer Cancelled by Host (Host sent a Clear feature )*/
+        result = USB_DEVICE_VENDOR_RESULT_ERROR_TERMINATED_BY_HOST;
+    }
+    else
+    {
+        /* Transfer was not completed successfully */
+        result = USB_DEVICE_VENDOR_RESULT_ERROR;
+    }
+
+    return result;
+}
+
+// ******************************************************************************
+/* Function:
+    static USB_DEVICE_VENDOR_RESULT F_USB_DEVICE_VENDOR_RingSubmit
+    (
+        USB_DEVICE_VENDOR_INSTANCE * thisVendorDevice,
+        uint32_t direction,
+        USB_DEVICE_VENDOR_TRANSFER_HANDLE * transferHandle,
+        void * data,
+        size_t size,
+        USB_DEVICE_IRP_FLAG flags,
+        void (*callback)(USB_DEVICE_IRP * irp),
+        uintptr_t iVendor
+    )
+
+  Summary:
+    Submits the IRP at the head of a ring.
+
+  Description:
+    This function fills the IRP at the head of the ring of the specified
+    direction and submits it to the device layer.
+
+  Remarks:
+    This is local function and should not be called directly by the application.
+*/
+
+static USB_DEVICE_VENDOR_RESULT F_USB_DEVICE_VENDOR_RingSubmit
+(
+    USB_DEVICE_VENDOR_INSTANCE * thisVendorDevice,
+    uint32_t direction,
+    USB_DEVICE_VENDOR_TRANSFER_HANDLE * transferHandle,
+    void * data,
+    size_t size,
+    USB_DEVICE_IRP_FLAG flags,
+    void (*callback)(USB_DEVICE_IRP * irp),
+    uintptr_t iVendor
+)
+{
+    USB_DEVICE_VENDOR_IRP_RING * ring = &thisVendorDevice->ring[direction];
+    USB_DEVICE_IRP * irp;
+    USB_ERROR irpError;
+    OSAL_CRITSECT_DATA_TYPE IntState;
+    uint32_t head;
+
+    if(ring->count >= ring->queueSize)
+    {
+        return(USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_QUEUE_FULL);
+    }
+
+    head = ring->head;
+    irp = &ring->irp[head];
+    irp->data = data;
+    irp->size = (uint32_t)size;
+    irp->flags = flags;
+    irp->userData = iVendor;
+    irp->callback = callback;
+
+    /* The IRP callback decrements the count from the USB interrupt */
+    IntState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+    ring->count++;
+    ring->head = (head + 1U) & (ring->depth - 1U);
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, IntState);
+
+    *transferHandle = (USB_DEVICE_VENDOR_TRANSFER_HANDLE)irp;
+
+    irpError = USB_DEVICE_IRPSubmit(thisVendorDevice->deviceHandle,
+            thisVendorDevice->endpoint[direction].address, irp);
+
+    if(irpError != USB_ERROR_NONE)
+    {
+        /* The IRP was not queued by the driver and will not complete. As
+         * this is the only producer, the IRP is still at the head. */
+        IntState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+        ring->count--;
+        ring->head = head;
+        OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, IntState);
+
+        *transferHandle = USB_DEVICE_VENDOR_TRANSFER_HANDLE_INVALID;
+    }
+
+    return((USB_DEVICE_VENDOR_RESULT)irpError);
+}
+
+// ******************************************************************************
+/* Function:
+    static void F_USB_DEVICE_VENDOR_IRPComplete
+    (
+        USB_DEVICE_IRP * irp,
+        uint32_t direction,
+        USB_DEVICE_VENDOR_EVENT event
+    )
+
+  Summary:
+    Common part of the read and write IRP callbacks.
+
+  Description:
+    This function retires the IRP at the tail of the ring and sends the
+    completion event to the application.
+
+  Remarks:
+    This is local function and should not be called directly by the application.
+*/
+
+static void F_USB_DEVICE_VENDOR_IRPComplete
+(
+    USB_DEVICE_IRP * irp,
+    uint32_t direction,
+    USB_DEVICE_VENDOR_EVENT event
+)
+{
+    USB_DEVICE_VENDOR_INSTANCE * thisVendorDevice;
+    USB_DEVICE_VENDOR_IRP_RING * ring;
+    USB_DEVICE_VENDOR_EVENT_DATA_READ_COMPLETE eventData;
+
+    /* The user data field of the IRP contains the Vendor instance
+     * that submitted this IRP */
+    thisVendorDevice = &gUSBDeviceVendorInstance[irp->userData];
+    ring = &thisVendorDevice->ring[direction];
+
+    eventData.handle = (USB_DEVICE_VENDOR_TRANSFER_HANDLE)irp;
+    eventData.data = irp->data;
+    eventData.length = irp->size;
+    eventData.status = F_USB_DEVICE_VENDOR_IRPStatusToResult(irp->status);
+
+    /* IRPs of an endpoint complete in submission order. The slot can be
+     * reused once the count is updated, so the event data is captured
+     * first. The application may queue the next request from the event
+     * handler. */
+    ring->tail = (ring->tail + 1U) & (ring->depth - 1U);
+    ring->count--;
+
+    if(thisVendorDevice->appEventCallBack != NULL)
+    {
+        thisVendorDevice->appEventCallBack((USB_DEVICE_VENDOR_INDEX)(irp->userData),
+                event, &eventData, thisVendorDevice->userData);
+    }
+}
+
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_VENDOR_Initialization
+    (
+        SYS_MODULE_INDEX iVendor,
+        USB_DEVICE_HANDLE deviceHandle,
+        void* initData,
+        uint8_t infNum,
+        uint8_t altSetting,
+        uint8_t descType,
+        uint8_t * pDesc
+    )
+
+  Summary:
+    USB Device Vendor function called by the device layer during Set
+    Configuration processing.
+
+  Description:
+    USB Device Vendor function called by the device layer during Set
+    Configuration processing.
+
+  Remarks:
+    This is local function and should not be called directly by the application.
+*/
+
+/* MISRA C-2012 Rule 11.3 deviated:2 Deviation record ID -  H3_USB_MISRAC_2012_R_11_3_DR_1 */
+
+void F_USB_DEVICE_VENDOR_Initialization
+(
+    SYS_MODULE_INDEX iVendor,
+    USB_DEVICE_HANDLE deviceHandle,
+    void* initData,
+    uint8_t infNum,
+    uint8_t altSetting,
+    uint8_t descType,
+    uint8_t * pDesc
+)
+{
+    uint8_t epAddress;
+    uint8_t epDir;
+    uint16_t maxPacketSize;
+    USB_DEVICE_VENDOR_INSTANCE * thisVendorDevice;
+    USB_DEVICE_VENDOR_INIT * vendorInit;
+    USB_ENDPOINT_DESCRIPTOR * pEPDesc;
+
+    /* Avoid unused warning */
+    ( void ) ( altSetting );
+
+    /* Check the validity of the function driver index */
+    if (iVendor >= USB_DEVICE_VENDOR_INSTANCES_NUMBER)
+    {
+        SYS_DEBUG(0, "USB Device Vendor: Invalid index");
+        return;
+    }
+
+    thisVendorDevice = &gUSBDeviceVendorInstance[iVendor];
+
+    switch ( descType )
+    {
+        case USB_DESCRIPTOR_INTERFACE:
+
+            /* The interface descriptor is presented before the endpoint
+             * descriptors. Reset the rings here. */
+            vendorInit = (USB_DEVICE_VENDOR_INIT *) initData;
+
+            thisVendorDevice->deviceHandle = deviceHandle;
+            thisVendorDevice->interfaceNum = infNum;
+
+            F_USB_DEVICE_VENDOR_RingReset(&thisVendorDevice->ring[USB_DEVICE_VENDOR_ENDPOINT_RX],
+                    gUSBDeviceVendorReadIRP[iVendor], USB_DEVICE_VENDOR_QUEUE_DEPTH_READ,
+                    vendorInit->queueSizeRead);
+
+            F_USB_DEVICE_VENDOR_RingReset(&thisVendorDevice->ring[USB_DEVICE_VENDOR_ENDPOINT_TX],
+                    gUSBDeviceVendorWriteIRP[iVendor], USB_DEVICE_VENDOR_QUEUE_DEPTH_WRITE,
+                    vendorInit->queueSizeWrite);
+            break;
+
+        case USB_DESCRIPTOR_ENDPOINT:
+
+            pEPDesc = ( USB_ENDPOINT_DESCRIPTOR* ) pDesc;
+
+            if ( pEPDesc->transferType != (uint8_t)USB_TRANSFER_TYPE_BULK )
+            {
+                /* Only the bulk endpoints are owned by this driver */
+                SYS_DEBUG(0, "USB Device Vendor: Cannot handle this endpoint type" );
+                break;
+            }
+
+            epAddress = pEPDesc->bEndpointAddress;
+            epDir = (( epAddress & 0x80U ) != 0U) ?
+                (uint8_t)( USB_DEVICE_VENDOR_ENDPOINT_TX ) : (uint8_t)( USB_DEVICE_VENDOR_ENDPOINT_RX );
+            maxPacketSize = pEPDesc->wMaxPacketSize;
+
+            thisVendorDevice->endpoint[epDir].address = epAddress;
+            thisVendorDevice->endpoint[epDir].maxPacketSize = maxPacketSize;
+
+            (void) USB_DEVICE_EndpointEnable ( deviceHandle,
+                    0,
+                    epAddress,
+                    USB_TRANSFER_TYPE_BULK,
+                    maxPacketSize );
+
+            thisVendorDevice->endpoint[epDir].isConfigured = true;
+            break;
+
+        default:
+            /* Unsupported descriptor type */
+            break;
+    }
+}
+
+/* MISRAC 2012 deviation block end */
+
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_VENDOR_Deinitialization ( SYS_MODULE_INDEX iVendor )
+
+  Summary:
+    Deinitializes the function driver instance.
+
+  Description:
+    Deinitializes the function driver instance.
+
+  Remarks:
+    This is local function and should not be called directly by the application.
+*/
+
+void F_USB_DEVICE_VENDOR_Deinitialization ( SYS_MODULE_INDEX iVendor )
+{
+    USB_DEVICE_VENDOR_INSTANCE * thisVendorDevice;
+    USB_DEVICE_VENDOR_ENDPOINT * endpoint;
+    uint32_t direction;
+
+    if(iVendor >= USB_DEVICE_VENDOR_INSTANCES_NUMBER)
+    {
+        SYS_DEBUG(0, "USB Device Vendor: Invalid instance");
+        return;
+    }
+
+    thisVendorDevice = &gUSBDeviceVendorInstance[iVendor];
+
+    for(direction = 0; direction < 2U; direction++)
+    {
+        endpoint = &thisVendorDevice->endpoint[direction];
+
+        if(endpoint->isConfigured)
+        {
+            /* Cancelling completes the outstanding IRPs in order, which
+             * empties the ring through the IRP callbacks */
+            (void) USB_DEVICE_IRPCancelAll(thisVendorDevice->deviceHandle, endpoint->address);
+            (void) USB_DEVICE_EndpointDisable(thisVendorDevice->deviceHandle, endpoint->address);
+            endpoint->isConfigured = false;
+        }
+    }
+}
+
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_VENDOR_ControlTransferHandler
+    (
+        SYS_MODULE_INDEX iVendor,
+        USB_DEVICE_EVENT controlTransferEvent,
+        USB_SETUP_PACKET * setupRequest
+    )
+
+  Summary:
+    Control Transfer Handler for interface and endpoint requests.
+
+  Description:
+    The Vendor function driver does not define any requests. Setup requests
+    that reach the function driver are stalled.
+
+  Remarks:
+    This is local function and should not be called directly by the application.
+*/
+
+void F_USB_DEVICE_VENDOR_ControlTransferHandler
+(
+    SYS_MODULE_INDEX iVendor,
+    USB_DEVICE_EVENT controlTransferEvent,
+    USB_SETUP_PACKET * setupRequest
+)
+{
+    ( void ) ( setupRequest );
+
+    if (iVendor >= USB_DEVICE_VENDOR_INSTANCES_NUMBER)
+    {
+        SYS_DEBUG(0, "USB Device Vendor: Invalid Vendor index" );
+        return;
+    }
+
+    if (controlTransferEvent == USB_DEVICE_EVENT_CONTROL_TRANSFER_SETUP_REQUEST)
+    {
+        (void) USB_DEVICE_ControlStatus(gUSBDeviceVendorInstance[iVendor].deviceHandle,
+                USB_DEVICE_CONTROL_STATUS_ERROR);
+    }
+}
+
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_VENDOR_ReadIRPCallback (USB_DEVICE_IRP * irp )
+
+  Summary:
+    IRP call back for Data Read IRPs.
+
+  Description:
+    This is IRP call back for IRPs submitted through the USB_DEVICE_VENDOR_Read()
+    function.
+
+  Remarks:
+    This is local function and should not be called directly by the application.
+*/
+
+void F_USB_DEVICE_VENDOR_ReadIRPCallback (USB_DEVICE_IRP * irp )
+{
+    F_USB_DEVICE_VENDOR_IRPComplete(irp, USB_DEVICE_VENDOR_ENDPOINT_RX,
+            USB_DEVICE_VENDOR_EVENT_READ_COMPLETE);
+}
+
+// ******************************************************************************
+/* Function:
+    void F_USB_DEVICE_VENDOR_WriteIRPCallback (USB_DEVICE_IRP * irp )
+
+  Summary:
+    IRP call back for Data Write IRPs.
+
+  Description:
+    This is IRP call back for IRPs submitted through the
+    USB_DEVICE_VENDOR_Write() function.
+
+  Remarks:
+    This is local function and should not be called directly by the application.
+*/
+
+void F_USB_DEVICE_VENDOR_WriteIRPCallback (USB_DEVICE_IRP * irp )
+{
+    F_USB_DEVICE_VENDOR_IRPComplete(irp, USB_DEVICE_VENDOR_ENDPOINT_TX,
+            USB_DEVICE_VENDOR_EVENT_WRITE_COMPLETE);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Vendor Interface Function Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Function:
+    USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_EventHandlerSet
+    (
+        USB_DEVICE_VENDOR_INDEX instance,
+        USB_DEVICE_VENDOR_EVENT_HANDLER eventHandler,
+        uintptr_t context
+    );
+
+  Summary:
+    This function registers a event handler for the specified Vendor function
+    driver instance.
+
+  Description:
+    This function registers a event handler for the specified Vendor function
+    driver instance.
+
+  Remarks:
+    Refer to usb_device_vendor.h for usage information.
+*/
+
+USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_EventHandlerSet
+(
+    USB_DEVICE_VENDOR_INDEX iVendor,
+    USB_DEVICE_VENDOR_EVENT_HANDLER eventHandler,
+    uintptr_t userData
+)
+{
+    if ( iVendor >= USB_DEVICE_VENDOR_INSTANCES_NUMBER )
+    {
+        return USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_INVALID;
+    }
+
+    if ( eventHandler == NULL )
+    {
+        return USB_DEVICE_VENDOR_RESULT_ERROR_PARAMETER_INVALID;
+    }
+
+    gUSBDeviceVendorInstance[iVendor].appEventCallBack = eventHandler;
+    gUSBDeviceVendorInstance[iVendor].userData = userData;
+
+    return USB_DEVICE_VENDOR_RESULT_OK;
+}
+
+// *****************************************************************************
+/* Function:
+    USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_Read
+    (
+        USB_DEVICE_VENDOR_INDEX instance,
+        USB_DEVICE_VENDOR_TRANSFER_HANDLE * transferHandle,
+        void * data,
+        size_t size
+    );
+
+  Summary:
+    This function queues a read on the bulk OUT endpoint of the Vendor
+    function driver.
+
+  Description:
+    This function queues a read on the bulk OUT endpoint of the Vendor
+    function driver.
+
+  Remarks:
+    Refer to usb_device_vendor.h for usage information.
+*/
+
+USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_Read
+(
+    USB_DEVICE_VENDOR_INDEX iVendor,
+    USB_DEVICE_VENDOR_TRANSFER_HANDLE * transferHandle,
+    void * data,
+    size_t size
+)
+{
+    USB_DEVICE_VENDOR_INSTANCE * thisVendorDevice;
+    USB_DEVICE_VENDOR_ENDPOINT * endpoint;
+
+    *transferHandle = USB_DEVICE_VENDOR_TRANSFER_HANDLE_INVALID;
+
+    if ( iVendor >= USB_DEVICE_VENDOR_INSTANCES_NUMBER )
+    {
+        SYS_ASSERT(false, "Invalid Vendor Device Index");
+        return USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_INVALID;
+    }
+
+    thisVendorDevice = &gUSBDeviceVendorInstance[iVendor];
+    endpoint = &thisVendorDevice->endpoint[USB_DEVICE_VENDOR_ENDPOINT_RX];
+
+    if(!(endpoint->isConfigured))
+    {
+        return (USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_NOT_CONFIGURED);
+    }
+
+    /* For read the size should be a multiple of endpoint size*/
+    if((size == 0U) || ((size % endpoint->maxPacketSize) != 0U))
+    {
+        return(USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_SIZE_INVALID);
+    }
+
+    return F_USB_DEVICE_VENDOR_RingSubmit(thisVendorDevice, USB_DEVICE_VENDOR_ENDPOINT_RX,
+            transferHandle, data, size, USB_DEVICE_IRP_FLAG_NONE,
+            F_USB_DEVICE_VENDOR_ReadIRPCallback, (uintptr_t)iVendor);
+}
+
+// *****************************************************************************
+/* Function:
+    USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_Write
+    (
+        USB_DEVICE_VENDOR_INDEX instance,
+        USB_DEVICE_VENDOR_TRANSFER_HANDLE * transferHandle,
+        const void * data,
+        size_t size,
+        USB_DEVICE_VENDOR_TRANSFER_FLAGS flags
+    );
+
+  Summary:
+    This function queues a write on the bulk IN endpoint of the Vendor
+    function driver.
+
+  Description:
+    This function queues a write on the bulk IN endpoint of the Vendor
+    function driver.
+
+  Remarks:
+    Refer to usb_device_vendor.h for usage information.
+*/
+
+/* MISRA C-2012 Rule 11.8 deviated:1 Deviation record ID -  H3_USB_MISRAC_2012_R_11_8_DR_1 */
+
+USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_Write
+(
+    USB_DEVICE_VENDOR_INDEX iVendor,
+    USB_DEVICE_VENDOR_TRANSFER_HANDLE * transferHandle,
+    const void * data,
+    size_t size,
+    USB_DEVICE_VENDOR_TRANSFER_FLAGS flags
+)
+{
+    size_t remainderValue;
+    USB_DEVICE_IRP_FLAG irpFlag = USB_DEVICE_IRP_FLAG_NONE;
+    USB_DEVICE_VENDOR_INSTANCE * thisVendorDevice;
+    USB_DEVICE_VENDOR_ENDPOINT * endpoint;
+
+    *transferHandle = USB_DEVICE_VENDOR_TRANSFER_HANDLE_INVALID;
+
+    if ( iVendor >= USB_DEVICE_VENDOR_INSTANCES_NUMBER )
+    {
+        SYS_ASSERT(false, "Invalid Vendor Device Index");
+        return USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_INVALID;
+    }
+
+    thisVendorDevice = &gUSBDeviceVendorInstance[iVendor];
+    endpoint = &thisVendorDevice->endpoint[USB_DEVICE_VENDOR_ENDPOINT_TX];
+
+    if(!(endpoint->isConfigured))
+    {
+        return (USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_NOT_CONFIGURED);
+    }
+
+    if(size == 0U)
+    {
+        return (USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_SIZE_INVALID);
+    }
+
+    if(((uint8_t)flags & (uint8_t)USB_DEVICE_VENDOR_TRANSFER_FLAGS_MORE_DATA_PENDING) != 0U)
+    {
+        if(size < endpoint->maxPacketSize)
+        {
+            /* For a data pending flag, we must atleast get max packet
+             * size worth data */
+            return(USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_SIZE_INVALID);
+        }
+
+        remainderValue = size % endpoint->maxPacketSize;
+        size -= remainderValue;
+        irpFlag = USB_DEVICE_IRP_FLAG_DATA_PENDING;
+    }
+    else if(((uint8_t)flags & (uint8_t)USB_DEVICE_VENDOR_TRANSFER_FLAGS_DATA_COMPLETE) != 0U)
+    {
+        irpFlag = USB_DEVICE_IRP_FLAG_DATA_COMPLETE;
+    }
+    else
+    {
+        /* Do Nothing */
+    }
+
+    return F_USB_DEVICE_VENDOR_RingSubmit(thisVendorDevice, USB_DEVICE_VENDOR_ENDPOINT_TX,
+            transferHandle, (void *)data, size, irpFlag,
+            F_USB_DEVICE_VENDOR_WriteIRPCallback, (uintptr_t)iVendor);
+}
+
+/* MISRAC 2012 deviation block end */
+
+size_t USB_DEVICE_VENDOR_ReadQueueFreeGet ( USB_DEVICE_VENDOR_INDEX iVendor )
+{
+    USB_DEVICE_VENDOR_INSTANCE * thisVendorDevice;
+
+    if ( iVendor >= USB_DEVICE_VENDOR_INSTANCES_NUMBER )
+    {
+        return 0;
+    }
+
+    thisVendorDevice = &gUSBDeviceVendorInstance[iVendor];
+
+    if(!(thisVendorDevice->endpoint[USB_DEVICE_VENDOR_ENDPOINT_RX].isConfigured))
+    {
+        return 0;
+    }
+
+    return (size_t)(thisVendorDevice->ring[USB_DEVICE_VENDOR_ENDPOINT_RX].queueSize
+            - thisVendorDevice->ring[USB_DEVICE_VENDOR_ENDPOINT_RX].count);
+}
+
+size_t USB_DEVICE_VENDOR_WriteQueueFreeGet ( USB_DEVICE_VENDOR_INDEX iVendor )
+{
+    USB_DEVICE_VENDOR_INSTANCE * thisVendorDevice;
+
+    if ( iVendor >= USB_DEVICE_VENDOR_INSTANCES_NUMBER )
+    {
+        return 0;
+    }
+
+    thisVendorDevice = &gUSBDeviceVendorInstance[iVendor];
+
+    if(!(thisVendorDevice->endpoint[USB_DEVICE_VENDOR_ENDPOINT_TX].isConfigured))
+    {
+        return 0;
+    }
+
+    return (size_t)(thisVendorDevice->ring[USB_DEVICE_VENDOR_ENDPOINT_TX].queueSize
+            - thisVendorDevice->ring[USB_DEVICE_VENDOR_ENDPOINT_TX].count);
+}
+
+uint16_t USB_DEVICE_VENDOR_ReadPacketSizeGet ( USB_DEVICE_VENDOR_INDEX iVendor )
+{
+    if ( iVendor >= USB_DEVICE_VENDOR_INSTANCES_NUMBER )
+    {
+        SYS_ASSERT ( false , "Invalid Vendor index" );
+        return (0);
+    }
+
+    return (gUSBDeviceVendorInstance[iVendor].endpoint[USB_DEVICE_VENDOR_ENDPOINT_RX].maxPacketSize);
+}
+
+uint16_t USB_DEVICE_VENDOR_WritePacketSizeGet ( USB_DEVICE_VENDOR_INDEX iVendor )
+{
+    if ( iVendor >= USB_DEVICE_VENDOR_INSTANCES_NUMBER )
+    {
+        SYS_ASSERT ( false , "Invalid Vendor index" );
+        return (0);
+    }
+
+    return (gUSBDeviceVendorInstance[iVendor].endpoint[USB_DEVICE_VENDOR_ENDPOINT_TX].maxPacketSize);
+}
+
+// *****************************************************************************
+/* Function:
+    bool USB_DEVICE_VENDOR_MSOS20RequestProcess
+    (
+        USB_DEVICE_HANDLE usbDeviceHandle,
+        const USB_SETUP_PACKET * setupPkt,
+        const USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR * msOs20Descriptor
+    );
+
+  Summary:
+    Responds to the Microsoft OS 2.0 descriptor set request.
+
+  Description:
+    Responds to the Microsoft OS 2.0 descriptor set request.
+
+  Remarks:
+    Refer to usb_device_vendor.h for usage information.
+*/
+
+/* MISRA C-2012 Rule 11.8 deviated:1 Deviation record ID -  H3_USB_MISRAC_2012_R_11_8_DR_1 */
+
+bool USB_DEVICE_VENDOR_MSOS20RequestProcess
+(
+    USB_DEVICE_HANDLE usbDeviceHandle,
+    const USB_SETUP_PACKET * setupPkt,
+    const USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR * msOs20Descriptor
+)
+{
+    size_t size;
+
+    if((setupPkt->DataDir != (uint8_t)USB_SETUP_REQUEST_DIRECTION_DEVICE_TO_HOST)
+            || (setupPkt->RequestType != (uint8_t)USB_SETUP_REQUEST_TYPE_VENDOR)
+            || (setupPkt->Recipient != USB_SETUP_RECIPIENT_DEVICE)
+            || (setupPkt->bRequest != msOs20Descriptor->vendorCode)
+            || (setupPkt->wIndex != USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR_INDEX))
+    {
+        return false;
+    }
+
+    /* The device layer does not clip the data stage to wLength */
+    size = msOs20Descriptor->descriptorSetLength;
+    if(size > setupPkt->wLength)
+    {
+        size = setupPkt->wLength;
+    }
+
+    (void) USB_DEVICE_ControlSend(usbDeviceHandle, (void *)msOs20Descriptor->descriptorSet, size);
+
+    return true;
+}
+
+/* MISRAC 2012 deviation block end */
+
+/*******************************************************************************
+ End of File
+ */
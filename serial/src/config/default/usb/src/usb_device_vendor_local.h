@@ -0,0 +1,321 @@
+/*******************************************************************************
+  USB Device Vendor Function Driver Local Definitions
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    usb_device_vendor_local.h
+
+  Summary:
+    USB Device Vendor Function Driver Local Definitions
+
+  Description:
+    This file contains the local data types and function prototypes of the
+    USB Device Vendor Function Driver.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef M_USB_DEVICE_VENDOR_LOCAL_H
+#define M_USB_DEVICE_VENDOR_LOCAL_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+#include "system/system_common.h"
+#include "system/system_module.h"
+#include "usb/usb_common.h"
+#include "usb/usb_chapter_9.h"
+#include "usb/usb_device.h"
+#include "usb/usb_device_vendor.h"
+#include "osal/osal.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#define USB_DEVICE_VENDOR_ENDPOINT_RX          USB_DATA_DIRECTION_HOST_TO_DEVICE
+#define USB_DEVICE_VENDOR_ENDPOINT_TX          USB_DATA_DIRECTION_DEVICE_TO_HOST
+
+#if ((USB_DEVICE_VENDOR_QUEUE_DEPTH_READ & (USB_DEVICE_VENDOR_QUEUE_DEPTH_READ - 1U)) != 0U)
+    #error "USB_DEVICE_VENDOR_QUEUE_DEPTH_READ must be a power of 2"
+#endif
+
+#if ((USB_DEVICE_VENDOR_QUEUE_DEPTH_WRITE & (USB_DEVICE_VENDOR_QUEUE_DEPTH_WRITE - 1U)) != 0U)
+    #error "USB_DEVICE_VENDOR_QUEUE_DEPTH_WRITE must be a power of 2"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Vendor endpoint instance.
+
+  Summary:
+    Identifies the Vendor endpoint instance.
+
+  Description:
+    This type identifies the Vendor endpoint instance.
+
+  Remarks:
+    This structure is internal to the Vendor function driver.
+*/
+
+typedef struct
+{
+    /* End point address */
+    uint8_t address;
+
+    /* End point maximum payload */
+    uint16_t maxPacketSize;
+
+    bool    isConfigured;
+
+} USB_DEVICE_VENDOR_ENDPOINT;
+
+// *****************************************************************************
+/* Vendor IRP ring.
+
+  Summary:
+    Ring of IRPs owned by one endpoint of a Vendor instance.
+
+  Description:
+    The IRPs of an endpoint are used in strict FIFO order. The USB Driver
+    completes the IRPs of an endpoint in the order in which they were
+    submitted, so the producer only moves head and the IRP callback only moves
+    tail. This avoids searching for a free IRP and avoids the mutex that the
+    CDC function driver needs for its shared IRP pool.
+
+  Remarks:
+    This structure is internal to the Vendor function driver.
+*/
+
+typedef struct
+{
+    /* IRP storage. Points into the static IRP pool of the instance. */
+    USB_DEVICE_IRP * irp;
+
+    /* Number of IRPs in the storage. Always a power of 2. */
+    uint32_t depth;
+
+    /* Maximum number of outstanding IRPs for this instance */
+    uint32_t queueSize;
+
+    /* Index of the next IRP to be submitted */
+    uint32_t head;
+
+    /* Index of the oldest outstanding IRP */
+    volatile uint32_t tail;
+
+    /* Number of outstanding IRPs */
+    volatile uint32_t count;
+
+} USB_DEVICE_VENDOR_IRP_RING;
+
+// *****************************************************************************
+/* Vendor instance structure.
+
+  Summary:
+    Identifies the Vendor instance.
+
+  Description:
+    This type identifies the Vendor instance.
+
+  Remarks:
+    This structure is internal to the Vendor function driver.
+*/
+
+typedef struct
+{
+    /* Device layer handle */
+    USB_DEVICE_HANDLE deviceHandle;
+
+    /* Vendor interface number */
+    uint8_t interfaceNum;
+
+    /* Bulk endpoints, indexed by USB_DEVICE_VENDOR_ENDPOINT_RX/TX */
+    USB_DEVICE_VENDOR_ENDPOINT endpoint[2];
+
+    /* IRP rings, indexed by USB_DEVICE_VENDOR_ENDPOINT_RX/TX */
+    USB_DEVICE_VENDOR_IRP_RING ring[2];
+
+    /* Application callback */
+    USB_DEVICE_VENDOR_EVENT_HANDLER appEventCallBack;
+
+    /* Application user data */
+    uintptr_t userData;
+
+} USB_DEVICE_VENDOR_INSTANCE;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Vendor specific functions
+// *****************************************************************************
+// *****************************************************************************
+
+//******************************************************************************
+/* Function:
+    void F_USB_DEVICE_VENDOR_Initialization
+    (
+        SYS_MODULE_INDEX iVendor,
+        USB_DEVICE_HANDLE deviceHandle,
+        void* initData,
+        uint8_t infNum,
+        uint8_t altSetting,
+        uint8_t descType,
+        uint8_t * pDesc
+    )
+
+  Summary:
+    Vendor function driver init function.
+
+  Description:
+    This function handles the Vendor interface and endpoint descriptors during
+    Set Configuration processing.
+
+  Remarks:
+    Called by the device layer per instance.
+ */
+
+void F_USB_DEVICE_VENDOR_Initialization
+(
+    SYS_MODULE_INDEX iVendor,
+    USB_DEVICE_HANDLE deviceHandle,
+    void* initData,
+    uint8_t infNum,
+    uint8_t altSetting,
+    uint8_t descType,
+    uint8_t * pDesc
+);
+
+//******************************************************************************
+/* Function:
+    void F_USB_DEVICE_VENDOR_Deinitialization ( SYS_MODULE_INDEX iVendor )
+
+  Summary:
+    Vendor function driver deinitialization.
+
+  Description:
+    This function cancels all outstanding IRPs and disables the endpoints of
+    the specified instance.
+
+  Remarks:
+    Called by the device layer.
+ */
+
+void F_USB_DEVICE_VENDOR_Deinitialization ( SYS_MODULE_INDEX iVendor );
+
+//******************************************************************************
+/* Function:
+    void F_USB_DEVICE_VENDOR_ControlTransferHandler
+    (
+        SYS_MODULE_INDEX iVendor,
+        USB_DEVICE_EVENT controlTransferEvent,
+        USB_SETUP_PACKET * setupRequest
+    )
+
+  Summary:
+    Handles interface and endpoint requests that are not standard requests.
+
+  Description:
+    The Vendor function driver does not define any interface requests. All such
+    requests are stalled.
+
+  Remarks:
+    Called by the device layer.
+ */
+
+void F_USB_DEVICE_VENDOR_ControlTransferHandler
+(
+    SYS_MODULE_INDEX iVendor,
+    USB_DEVICE_EVENT controlTransferEvent,
+    USB_SETUP_PACKET * setupRequest
+);
+
+//******************************************************************************
+/* Function:
+    void F_USB_DEVICE_VENDOR_ReadIRPCallback (USB_DEVICE_IRP * irp )
+
+  Summary:
+    RX data callback.
+
+  Description:
+    This function handles RX data events
+
+  Remarks:
+    Called by the controller driver
+ */
+
+void F_USB_DEVICE_VENDOR_ReadIRPCallback (USB_DEVICE_IRP * irp );
+
+//******************************************************************************
+/* Function:
+    void F_USB_DEVICE_VENDOR_WriteIRPCallback (USB_DEVICE_IRP * irp )
+
+  Summary:
+    TX data callback.
+
+  Description:
+    This function handles TX data events
+
+  Remarks:
+    Called by the controller driver
+ */
+
+void F_USB_DEVICE_VENDOR_WriteIRPCallback (USB_DEVICE_IRP * irp );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif // M_USB_DEVICE_VENDOR_LOCAL_H
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,808 @@
+/*******************************************************************************
+  USB Device Vendor Function Driver Interface
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    usb_device_vendor.h
+
+  Summary:
+    USB Device Vendor Function Driver Interface
+
+  Description:
+    This file describes the USB Device Vendor Function Driver interface. The
+    Vendor Function Driver exposes one vendor specific interface with a pair of
+    raw bulk endpoints. It does not add any class protocol on top of the bulk
+    data and is intended for streaming data to and from a host application that
+    uses WinUSB or libusb. The application should include this file if it needs
+    to use the Vendor Function Driver API.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef M_USB_DEVICE_VENDOR_H
+#define M_USB_DEVICE_VENDOR_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+#include "usb/usb_common.h"
+#include "usb/usb_chapter_9.h"
+#include "usb/usb_device.h"
+#include "usb/src/usb_device_function_driver.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* USB Vendor Interface Class Code
+
+  Summary:
+    Class code of the vendor specific interface.
+
+  Description:
+    This is the interface class code that must be used in the interface
+    descriptor of an interface that is owned by the Vendor Function Driver.
+
+  Remarks:
+    None.
+*/
+
+#define USB_VENDOR_SPECIFIC_INTERFACE_CLASS_CODE            0xFFU
+
+// *****************************************************************************
+/* Microsoft OS 2.0 Descriptor Constants
+
+  Summary:
+    Constants required to build the Microsoft OS 2.0 descriptors.
+
+  Description:
+    These constants are used in the BOS platform capability descriptor and in
+    the Microsoft OS 2.0 descriptor set. Windows 8.1 and later reads these
+    descriptors and binds the WinUSB driver to the vendor interface without an
+    INF file. The host retrieves the descriptor set with a vendor device
+    request whose bRequest is the vendor code advertised in the BOS platform
+    capability descriptor and whose wIndex is
+    USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR_INDEX.
+
+  Remarks:
+    Refer to the Microsoft OS 2.0 Descriptors Specification.
+*/
+
+#define USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR_INDEX         0x07U
+#define USB_DEVICE_VENDOR_MS_OS_20_SET_ALT_ENUMERATION      0x08U
+
+#define USB_DEVICE_VENDOR_MS_OS_20_SET_HEADER_DESCRIPTOR    0x00U
+#define USB_DEVICE_VENDOR_MS_OS_20_SUBSET_HEADER_CONFIGURATION 0x01U
+#define USB_DEVICE_VENDOR_MS_OS_20_SUBSET_HEADER_FUNCTION   0x02U
+#define USB_DEVICE_VENDOR_MS_OS_20_FEATURE_COMPATIBLE_ID    0x03U
+#define USB_DEVICE_VENDOR_MS_OS_20_FEATURE_REG_PROPERTY     0x04U
+
+#define USB_DEVICE_VENDOR_MS_OS_20_REG_MULTI_SZ             0x07U
+
+/* Windows 8.1 (NTDDI_WINBLUE) */
+#define USB_DEVICE_VENDOR_MS_OS_20_WINDOWS_VERSION          0x06030000UL
+
+/* Device capability type of the BOS platform capability descriptor */
+#define USB_DEVICE_VENDOR_DEVICE_CAPABILITY_PLATFORM        0x05U
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Index Constants
+
+  Summary:
+    USB Device Vendor Function Driver Index Constants
+
+  Description:
+    This constants can be used by the application to specify Vendor function
+    driver instance indexes.
+
+  Remarks:
+    None.
+*/
+
+/* Use this to specify Vendor Function Driver Instance 0 */
+#define USB_DEVICE_VENDOR_INDEX_0 0
+
+/* Use this to specify Vendor Function Driver Instance 1 */
+#define USB_DEVICE_VENDOR_INDEX_1 1
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Index
+
+  Summary:
+    USB Device Vendor Function Driver Index
+
+  Description:
+    This uniquely identifies a Vendor Function Driver instance.
+
+  Remarks:
+    None.
+*/
+
+typedef uintptr_t USB_DEVICE_VENDOR_INDEX;
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Events
+
+  Summary:
+    USB Device Vendor Function Driver Events
+
+  Description:
+    These events are specific to the USB Device Vendor Function Driver
+    instance. Each event description contains details about the parameters
+    passed with the event. The contents of pData depends on the generated
+    event.
+
+  Remarks:
+    The read and write complete events are generated from the context of the
+    USB Driver IRP completion. This is the USB interrupt unless the driver is
+    configured to defer IRP completion to the driver tasks routine.
+*/
+
+typedef enum
+{
+    /* This event occurs when a write operation scheduled by calling the
+       USB_DEVICE_VENDOR_Write function has completed. The pData parameter
+       should be interpreted as a USB_DEVICE_VENDOR_EVENT_DATA_WRITE_COMPLETE
+       pointer type. */
+
+    USB_DEVICE_VENDOR_EVENT_WRITE_COMPLETE,
+
+    /* This event occurs when a read operation scheduled by calling the
+       USB_DEVICE_VENDOR_Read function has completed. The pData parameter
+       should be interpreted as a USB_DEVICE_VENDOR_EVENT_DATA_READ_COMPLETE
+       pointer type. */
+
+    USB_DEVICE_VENDOR_EVENT_READ_COMPLETE
+
+} USB_DEVICE_VENDOR_EVENT;
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Event Handler Response Type
+
+  Summary:
+    USB Device Vendor Function Driver Event Callback Response Type
+
+  Description:
+    This is the return type of the Vendor Function Driver event handler.
+
+  Remarks:
+    None.
+*/
+
+typedef void USB_DEVICE_VENDOR_EVENT_RESPONSE;
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Event Handler Response None
+
+  Summary:
+    USB Device Vendor Function Driver Event Handler Response Type None.
+
+  Description:
+    This is the definition of the Vendor Function Driver Event Handler Response
+    Type none.
+
+  Remarks:
+    Intentionally defined to be empty.
+*/
+
+#define USB_DEVICE_VENDOR_EVENT_RESPONSE_NONE
+
+// *****************************************************************************
+/* USB Device Vendor Event Handler Function Pointer Type.
+
+  Summary:
+    USB Device Vendor Event Handler Function Pointer Type.
+
+  Description:
+    This data type defines the required function signature of the USB Device
+    Vendor Function Driver event handling callback function. The parameters
+    have the same meaning as the parameters of the CDC Function Driver event
+    handler.
+
+  Remarks:
+    The event handler should not block. A streaming application would
+    typically resubmit the buffer from the event handler or flag it for
+    resubmission in its tasks routine.
+*/
+
+typedef USB_DEVICE_VENDOR_EVENT_RESPONSE (*USB_DEVICE_VENDOR_EVENT_HANDLER)
+(
+    USB_DEVICE_VENDOR_INDEX instanceIndex,
+    USB_DEVICE_VENDOR_EVENT event,
+    void * pData,
+    uintptr_t context
+);
+
+// *****************************************************************************
+/* USB Device Vendor Transfer Flags
+
+  Summary:
+    USB Device Vendor Function Driver Transfer Flags
+
+  Description:
+    These flags are used to indicate status of the pending data while sending
+    data to the host by using the USB_DEVICE_VENDOR_Write function. They have
+    the same meaning as the USB_DEVICE_CDC_TRANSFER_FLAGS.
+
+  Remarks:
+    A stream that is split over several writes should use
+    USB_DEVICE_VENDOR_TRANSFER_FLAGS_MORE_DATA_PENDING on every write but the
+    last so that no zero length packet is inserted in the middle of the
+    stream.
+*/
+
+typedef enum
+{
+    /* No further data is to be sent in this transfer. A zero length packet is
+       sent if the size is a multiple of the maximum packet size. */
+
+    USB_DEVICE_VENDOR_TRANSFER_FLAGS_DATA_COMPLETE /* DOM-IGNORE-BEGIN */ = (1<<0) /* DOM-IGNORE-END */,
+
+    /* More data follows in this transfer. No zero length packet is sent. */
+
+    USB_DEVICE_VENDOR_TRANSFER_FLAGS_MORE_DATA_PENDING /* DOM-IGNORE-BEGIN */ = (1<<1) /* DOM-IGNORE-END */
+
+} USB_DEVICE_VENDOR_TRANSFER_FLAGS;
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Transfer Handle Definition
+
+  Summary:
+    USB Device Vendor Function Driver Transfer Handle Definition.
+
+  Description:
+    This definition defines a USB Device Vendor Function Driver Transfer
+    Handle. The transfer handle is valid for the life time of the transfer and
+    expires when the transfer related event had occurred.
+
+  Remarks:
+    None.
+*/
+
+typedef uintptr_t USB_DEVICE_VENDOR_TRANSFER_HANDLE;
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Invalid Transfer Handle Definition
+
+  Summary:
+    USB Device Vendor Function Driver Invalid Transfer Handle Definition.
+
+  Description:
+    This value is returned in the transfer handle by the USB_DEVICE_VENDOR_Read
+    and USB_DEVICE_VENDOR_Write functions when the request was not successful.
+
+  Remarks:
+    None.
+*/
+
+#define USB_DEVICE_VENDOR_TRANSFER_HANDLE_INVALID  ((USB_DEVICE_VENDOR_TRANSFER_HANDLE)(-1))
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Result enumeration.
+
+  Summary:
+    USB Device Vendor Function Driver Result enumeration.
+
+  Description:
+    This enumeration lists the possible USB Device Vendor Function Driver
+    operation results.
+
+  Remarks:
+    None.
+*/
+/* MISRA C-2012 Rule 5.2 deviated:9 Deviation record ID -  H3_USB_MISRAC_2012_R_5_2_DR_1 */
+
+typedef enum
+{
+    /* The operation was successful */
+    USB_DEVICE_VENDOR_RESULT_OK /* DOM-IGNORE-BEGIN */ = USB_ERROR_NONE /* DOM-IGNORE-END */,
+
+    /* The transfer size is invalid */
+    USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_SIZE_INVALID
+        /* DOM-IGNORE-BEGIN */ = USB_ERROR_IRP_SIZE_INVALID /* DOM-IGNORE-END */,
+
+    /* The transfer queue is full and no new transfers can be scheduled */
+    USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_QUEUE_FULL
+        /* DOM-IGNORE-BEGIN */ = USB_ERROR_IRP_QUEUE_FULL /* DOM-IGNORE-END */,
+
+    /* The specified instance is not provisioned in the system */
+    USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_INVALID
+        /* DOM-IGNORE-BEGIN */ = USB_ERROR_DEVICE_FUNCTION_INSTANCE_INVALID /* DOM-IGNORE-END */,
+
+    /* The specified instance is not configured yet */
+    USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_NOT_CONFIGURED
+        /* DOM-IGNORE-BEGIN */ = USB_ERROR_ENDPOINT_NOT_CONFIGURED /* DOM-IGNORE-END */,
+
+    /* The event handler provided is NULL */
+    USB_DEVICE_VENDOR_RESULT_ERROR_PARAMETER_INVALID
+        /* DOM-IGNORE-BEGIN */ = USB_ERROR_PARAMETER_INVALID /* DOM-IGNORE-END */,
+
+    /* Transfer terminated because host halted the endpoint */
+    USB_DEVICE_VENDOR_RESULT_ERROR_ENDPOINT_HALTED
+        /* DOM-IGNORE-BEGIN */ = USB_ERROR_ENDPOINT_HALTED /* DOM-IGNORE-END */,
+
+    /* Transfer terminated by host because of a stall clear */
+    USB_DEVICE_VENDOR_RESULT_ERROR_TERMINATED_BY_HOST
+        /* DOM-IGNORE-BEGIN */ = USB_ERROR_TRANSFER_TERMINATED_BY_HOST /* DOM-IGNORE-END */,
+
+    /* General Vendor Function driver error */
+    USB_DEVICE_VENDOR_RESULT_ERROR
+
+} USB_DEVICE_VENDOR_RESULT;
+
+/* MISRAC 2012 deviation block end */
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Read and Write Complete Event Data.
+
+  Summary:
+    USB Device Vendor Function Driver Read and Write Complete Event Data.
+
+  Description:
+    This data type defines the data structure returned by the driver along with
+    USB_DEVICE_VENDOR_EVENT_READ_COMPLETE and
+    USB_DEVICE_VENDOR_EVENT_WRITE_COMPLETE events.
+
+  Remarks:
+    None.
+*/
+
+typedef struct
+{
+    /* Transfer handle associated with this read or write request */
+    USB_DEVICE_VENDOR_TRANSFER_HANDLE handle;
+
+    /* Data buffer that was passed to the read or write request */
+    void * data;
+
+    /* Indicates the amount of data (in bytes) that was read or written */
+    size_t length;
+
+    /* Completion status of the transfer */
+    USB_DEVICE_VENDOR_RESULT status;
+
+}
+USB_DEVICE_VENDOR_EVENT_DATA_WRITE_COMPLETE,
+USB_DEVICE_VENDOR_EVENT_DATA_READ_COMPLETE;
+
+// *****************************************************************************
+/* USB Device Vendor Microsoft OS 2.0 Descriptor Set
+
+  Summary:
+    Identifies the Microsoft OS 2.0 descriptor set of the device.
+
+  Description:
+    This data type ties the Microsoft OS 2.0 descriptor set to the vendor code
+    that is advertised in the BOS platform capability descriptor. It is
+    defined along with the other device descriptors and is passed to the
+    USB_DEVICE_VENDOR_MSOS20RequestProcess function.
+
+  Remarks:
+    None.
+*/
+
+typedef struct
+{
+    /* bMS_VendorCode of the BOS platform capability descriptor */
+    uint8_t vendorCode;
+
+    /* Total length of the descriptor set */
+    uint16_t descriptorSetLength;
+
+    /* Pointer to the descriptor set */
+    const uint8_t * descriptorSet;
+
+} USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Vendor Interface Function Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Function:
+    USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_EventHandlerSet
+    (
+        USB_DEVICE_VENDOR_INDEX instance,
+        USB_DEVICE_VENDOR_EVENT_HANDLER eventHandler,
+        uintptr_t context
+    );
+
+  Summary:
+    This function registers an event handler for the specified Vendor function
+    driver instance.
+
+  Description:
+    This function registers an event handler for the specified Vendor function
+    driver instance. This function should be called by the client when it
+    receives a SET CONFIGURATION event from the device layer.
+
+  Precondition:
+    None.
+
+  Parameters:
+    instance     - Instance of the Vendor Function Driver.
+    eventHandler - A pointer to event handler function.
+    context      - Application specific context that is returned in the event
+                   handler.
+
+  Returns:
+    USB_DEVICE_VENDOR_RESULT_OK - The operation was successful
+    USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_INVALID - The specified instance
+    does not exist.
+    USB_DEVICE_VENDOR_RESULT_ERROR_PARAMETER_INVALID - The eventHandler
+    parameter is NULL
+
+  Example:
+    <code>
+    USB_DEVICE_VENDOR_EventHandlerSet(USB_DEVICE_VENDOR_INDEX_0,
+            APP_USBDeviceVendorEventHandler, (uintptr_t)&myAppData);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_EventHandlerSet
+(
+    USB_DEVICE_VENDOR_INDEX instance,
+    USB_DEVICE_VENDOR_EVENT_HANDLER eventHandler,
+    uintptr_t context
+);
+
+// *****************************************************************************
+/* Function:
+    USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_Read
+    (
+        USB_DEVICE_VENDOR_INDEX instance,
+        USB_DEVICE_VENDOR_TRANSFER_HANDLE * transferHandle,
+        void * data,
+        size_t size
+    );
+
+  Summary:
+    This function queues a read on the bulk OUT endpoint of the Vendor
+    function driver.
+
+  Description:
+    This function queues a read on the bulk OUT endpoint. The request is placed
+    in the read IRP ring of the instance and is serviced as data arrives from
+    the host. Up to queueSizeRead requests can be outstanding at any time.
+    Keeping more than one request queued lets the USB Driver arm the endpoint
+    again as soon as a transfer completes, which is what allows a stream to
+    use every bulk slot in the frame. The termination of the request is
+    indicated by the USB_DEVICE_VENDOR_EVENT_READ_COMPLETE event. Requests
+    complete in the order in which they were queued.
+
+  Precondition:
+    The function driver should have been configured.
+
+  Parameters:
+    instance - Vendor Function Driver instance.
+    transferHandle - Pointer to a USB_DEVICE_VENDOR_TRANSFER_HANDLE type of
+                     variable. This variable will contain the transfer handle
+                     in case the read request was successful.
+    data - Pointer to the data buffer where read data will be stored.
+    size - Size of the data buffer. Must be a non zero multiple of the
+           endpoint maximum packet size.
+
+  Returns:
+    USB_DEVICE_VENDOR_RESULT_OK - The read request was successful.
+    USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_INVALID - The instance is invalid.
+    USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_NOT_CONFIGURED - The endpoint is
+    not configured.
+    USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_SIZE_INVALID - The size is invalid.
+    USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_QUEUE_FULL - The read ring is full.
+
+  Example:
+    <code>
+    </code>
+
+  Remarks:
+    This function should be called from a single context per instance. It can
+    be called from the read complete event handler.
+*/
+
+USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_Read
+(
+    USB_DEVICE_VENDOR_INDEX instance,
+    USB_DEVICE_VENDOR_TRANSFER_HANDLE * transferHandle,
+    void * data,
+    size_t size
+);
+
+// *****************************************************************************
+/* Function:
+    USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_Write
+    (
+        USB_DEVICE_VENDOR_INDEX instance,
+        USB_DEVICE_VENDOR_TRANSFER_HANDLE * transferHandle,
+        const void * data,
+        size_t size,
+        USB_DEVICE_VENDOR_TRANSFER_FLAGS flags
+    );
+
+  Summary:
+    This function queues a write on the bulk IN endpoint of the Vendor
+    function driver.
+
+  Description:
+    This function queues a write on the bulk IN endpoint. The request is placed
+    in the write IRP ring of the instance and is serviced as the host requests
+    data. Up to queueSizeWrite requests can be outstanding at any time. The
+    termination of the request is indicated by the
+    USB_DEVICE_VENDOR_EVENT_WRITE_COMPLETE event. Requests complete in the
+    order in which they were queued.
+
+  Precondition:
+    The function driver should have been configured.
+
+  Parameters:
+    instance - Vendor Function Driver instance.
+    transferHandle - Pointer to a USB_DEVICE_VENDOR_TRANSFER_HANDLE type of
+                     variable. This variable will contain the transfer handle
+                     in case the write request was successful.
+    data - Pointer to the data to be sent.
+    size - Size of the data in bytes.
+    flags - Flags that indicate whether the transfer should continue or end.
+
+  Returns:
+    USB_DEVICE_VENDOR_RESULT_OK - The write request was successful.
+    USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_INVALID - The instance is invalid.
+    USB_DEVICE_VENDOR_RESULT_ERROR_INSTANCE_NOT_CONFIGURED - The endpoint is
+    not configured.
+    USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_SIZE_INVALID - The size is invalid.
+    USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_QUEUE_FULL - The write ring is
+    full.
+
+  Example:
+    <code>
+    </code>
+
+  Remarks:
+    This function should be called from a single context per instance. It can
+    be called from the write complete event handler. The data buffer must not
+    be modified until the write complete event for the request has occurred.
+*/
+
+USB_DEVICE_VENDOR_RESULT USB_DEVICE_VENDOR_Write
+(
+    USB_DEVICE_VENDOR_INDEX instance,
+    USB_DEVICE_VENDOR_TRANSFER_HANDLE * transferHandle,
+    const void * data,
+    size_t size,
+    USB_DEVICE_VENDOR_TRANSFER_FLAGS flags
+);
+
+// *****************************************************************************
+/* Function:
+    size_t USB_DEVICE_VENDOR_ReadQueueFreeGet ( USB_DEVICE_VENDOR_INDEX instance )
+
+  Summary:
+    Returns the number of read requests that can still be queued.
+
+  Description:
+    This function returns the number of read requests that can be queued before
+    USB_DEVICE_VENDOR_Read returns
+    USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_QUEUE_FULL. A streaming application
+    can use this to keep the read ring topped up.
+
+  Remarks:
+    Returns 0 for an invalid or unconfigured instance.
+*/
+
+size_t USB_DEVICE_VENDOR_ReadQueueFreeGet ( USB_DEVICE_VENDOR_INDEX instance );
+
+// *****************************************************************************
+/* Function:
+    size_t USB_DEVICE_VENDOR_WriteQueueFreeGet ( USB_DEVICE_VENDOR_INDEX instance )
+
+  Summary:
+    Returns the number of write requests that can still be queued.
+
+  Description:
+    This function returns the number of write requests that can be queued
+    before USB_DEVICE_VENDOR_Write returns
+    USB_DEVICE_VENDOR_RESULT_ERROR_TRANSFER_QUEUE_FULL.
+
+  Remarks:
+    Returns 0 for an invalid or unconfigured instance.
+*/
+
+size_t USB_DEVICE_VENDOR_WriteQueueFreeGet ( USB_DEVICE_VENDOR_INDEX instance );
+
+// *****************************************************************************
+/* Function:
+    uint16_t USB_DEVICE_VENDOR_ReadPacketSizeGet ( USB_DEVICE_VENDOR_INDEX instance )
+
+  Summary:
+    Returns the maximum packet size of the bulk OUT endpoint.
+
+  Description:
+    Returns the maximum packet size of the bulk OUT endpoint. Read sizes must
+    be a multiple of this value.
+
+  Remarks:
+    None.
+*/
+
+uint16_t USB_DEVICE_VENDOR_ReadPacketSizeGet ( USB_DEVICE_VENDOR_INDEX instance );
+
+// *****************************************************************************
+/* Function:
+    uint16_t USB_DEVICE_VENDOR_WritePacketSizeGet ( USB_DEVICE_VENDOR_INDEX instance )
+
+  Summary:
+    Returns the maximum packet size of the bulk IN endpoint.
+
+  Description:
+    Returns the maximum packet size of the bulk IN endpoint.
+
+  Remarks:
+    None.
+*/
+
+uint16_t USB_DEVICE_VENDOR_WritePacketSizeGet ( USB_DEVICE_VENDOR_INDEX instance );
+
+// *****************************************************************************
+/* Function:
+    bool USB_DEVICE_VENDOR_MSOS20RequestProcess
+    (
+        USB_DEVICE_HANDLE usbDeviceHandle,
+        const USB_SETUP_PACKET * setupPkt,
+        const USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR * msOs20Descriptor
+    );
+
+  Summary:
+    Responds to the Microsoft OS 2.0 descriptor set request.
+
+  Description:
+    The Microsoft OS 2.0 descriptor set is requested with a vendor request to
+    the device recipient. The device layer forwards such requests to the
+    device layer client and not to a function driver. The application should
+    call this function from its USB_DEVICE_EVENT_CONTROL_TRANSFER_SETUP_REQUEST
+    event handling. If the request is the descriptor set request, the function
+    starts the data stage and returns true. Otherwise it returns false and the
+    application must respond to the request.
+
+  Precondition:
+    None.
+
+  Parameters:
+    usbDeviceHandle - Device layer handle returned by USB_DEVICE_Open.
+    setupPkt - Setup packet passed along with the event.
+    msOs20Descriptor - Descriptor set of the device.
+
+  Returns:
+    true - The request was handled.
+    false - The request is not a Microsoft OS 2.0 descriptor request.
+
+  Example:
+    <code>
+    case USB_DEVICE_EVENT_CONTROL_TRANSFER_SETUP_REQUEST:
+        if(USB_DEVICE_VENDOR_MSOS20RequestProcess(appData.usbDevHandle,
+                (USB_SETUP_PACKET *)pData, &usbDeviceVendorMsOs20Descriptor) == false)
+        {
+            USB_DEVICE_ControlStatus(appData.usbDevHandle,
+                    USB_DEVICE_CONTROL_STATUS_ERROR);
+        }
+        break;
+    </code>
+
+  Remarks:
+    None.
+*/
+
+bool USB_DEVICE_VENDOR_MSOS20RequestProcess
+(
+    USB_DEVICE_HANDLE usbDeviceHandle,
+    const USB_SETUP_PACKET * setupPkt,
+    const USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR * msOs20Descriptor
+);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Types. This section is specific to the implementation
+//          of the USB Device Vendor Function Driver
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Function Pointer
+
+  Summary:
+    USB Device Vendor Function Driver Function pointer
+
+  Description:
+    This is the USB Device Vendor Function Driver Function pointer. This should
+    registered with the device layer in the function driver registration table.
+
+  Remarks:
+    None.
+*/
+
+/*DOM-IGNORE-BEGIN*/extern const USB_DEVICE_FUNCTION_DRIVER vendorFunctionDriver;/*DOM-IGNORE-END*/
+#define USB_DEVICE_VENDOR_FUNCTION_DRIVER /*DOM-IGNORE-BEGIN*/&vendorFunctionDriver/*DOM-IGNORE-END*/
+
+// *****************************************************************************
+/* USB Device Vendor Function Driver Initialization Data Structure
+
+  Summary:
+    USB Device Vendor Function Driver Initialization Data Structure
+
+  Description:
+    This data structure must be defined for every instance of the Vendor
+    function driver. The funcDriverInit member of the Device Layer Function
+    Driver registration table entry must point to this data structure.
+
+  Remarks:
+    The queue sizes are limited by the USB_DEVICE_VENDOR_QUEUE_DEPTH_READ and
+    USB_DEVICE_VENDOR_QUEUE_DEPTH_WRITE configuration macros.
+*/
+
+typedef struct
+{
+    /* Number of read requests that can be outstanding */
+    size_t queueSizeRead;
+
+    /* Number of write requests that can be outstanding */
+    size_t queueSizeWrite;
+
+} USB_DEVICE_VENDOR_INIT;
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif
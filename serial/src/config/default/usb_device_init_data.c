@@ -58,6 +58,12 @@ static const USB_DEVICE_CDC_INIT cdcInit0 =
 };
 /* MISRAC 2012 deviation block end */   
 
+static const USB_DEVICE_VENDOR_INIT vendorInit0 =
+{
+    .queueSizeRead = USB_DEVICE_VENDOR_QUEUE_DEPTH_READ,
+    .queueSizeWrite = USB_DEVICE_VENDOR_QUEUE_DEPTH_WRITE
+};
+
 
 
 /**************************************************
@@ -66,7 +72,7 @@ static const USB_DEVICE_CDC_INIT cdcInit0 =
  **************************************************/
 /* MISRA C-2012 Rule 10.3 deviated:2, 11.8 deviated:6 deviated below. Deviation record ID -  
    H3_USB_MISRAC_2012_R_10_3_DR_1 & H3_USB_MISRAC_2012_R_11_8_DR_1*/
-static const USB_DEVICE_FUNCTION_REGISTRATION_TABLE funcRegistrationTable[1] =
+static const USB_DEVICE_FUNCTION_REGISTRATION_TABLE funcRegistrationTable[2] =
 {
         /* CDC Function 0 */
     {
@@ -78,7 +84,16 @@ static const USB_DEVICE_FUNCTION_REGISTRATION_TABLE funcRegistrationTable[1] =
         .driver = (void*)USB_DEVICE_CDC_FUNCTION_DRIVER,    // USB CDC function data exposed to device layer
         .funcDriverInit = (void*)&cdcInit0                  // Function driver init data
     },
-
+        /* Vendor Function 0 */
+    {
+        .configurationValue = 1,                            // Configuration value
+        .interfaceNumber = 2,                               // First interfaceNumber of this function
+        .speed = (USB_SPEED)((uint32_t)USB_SPEED_HIGH|(uint32_t)USB_SPEED_FULL),             // Function Speed
+        .numberOfInterfaces = 1,                            // Number of interfaces
+        .funcDriverIndex = 0,                               // Index of Vendor Function Driver
+        .driver = (void*)USB_DEVICE_VENDOR_FUNCTION_DRIVER, // USB Vendor function data exposed to device layer
+        .funcDriverInit = (void*)&vendorInit0               // Function driver init data
+    },
 
 };
 /* MISRAC 2012 deviation block end */
@@ -92,10 +107,10 @@ static const USB_DEVICE_DESCRIPTOR usbDeviceDescriptor =
 {
     0x12,                                                   // Size of this descriptor in bytes
     (uint8_t)USB_DESCRIPTOR_DEVICE,                                  // DEVICE descriptor type
-    0x0200,                                                 // USB Spec Release Number in BCD format
-    USB_CDC_CLASS_CODE,                                     // Class Code
-    USB_CDC_SUBCLASS_CODE,                                  // Subclass code
-    0x00,                                                   // Protocol code
+    0x0210,                                                 // USB Spec Release Number in BCD format (BOS support)
+    0xEF,                                                   // Class Code (Miscellaneous)
+    0x02,                                                   // Subclass code (Common Class)
+    0x01,                                                   // Protocol code (Interface Association Descriptor)
 
 
     USB_DEVICE_EP0_BUFFER_SIZE,                             // Max packet size for EP0, see configuration.h
@@ -119,12 +134,24 @@ static const uint8_t fullSpeedConfigurationDescriptor[]=
 
     0x09,                                                   // Size of this descriptor in bytes
     (uint8_t)USB_DESCRIPTOR_CONFIGURATION,                           // Descriptor Type
-    USB_DEVICE_16bitTo8bitArrange(67),                      //(67 Bytes)Size of the Configuration descriptor
-    2,                                                      // Number of interfaces in this configuration
+    USB_DEVICE_16bitTo8bitArrange(98),                      //(98 Bytes)Size of the Configuration descriptor
+    3,                                                      // Number of interfaces in this configuration
     0x01,                                                   // Index value of this configuration
     0x00,                                                   // Configuration string index
     USB_ATTRIBUTE_DEFAULT | USB_ATTRIBUTE_SELF_POWERED, // Attributes
     50,                                                 // Maximum Power: 100mA
+
+    /* Interface Association Descriptor (CDC) */
+
+    0x08,                                                   // Size of this descriptor in bytes
+    USB_DESCRIPTOR_INTERFACE_ASSOCIATION,                   // Interface Association Descriptor Type
+    0,                                                      // First interface of the function
+    2,                                                      // Number of interfaces of the function
+    USB_CDC_COMMUNICATIONS_INTERFACE_CLASS_CODE,            // Function class
+    (uint8_t)USB_CDC_SUBCLASS_ABSTRACT_CONTROL_MODEL,                // Function subclass
+    (uint8_t)USB_CDC_PROTOCOL_AT_V250,                               // Function protocol
+    0x00,                                                   // Function string index
+
     /* Interface Descriptor */
 
     0x09,                                                   // Size of this descriptor in bytes
@@ -200,6 +227,36 @@ static const uint8_t fullSpeedConfigurationDescriptor[]=
     0x40, 0x00,                                             // Max packet size of this EP
     0x00,                                                   // Interval (in ms)
 
+    /* Interface Descriptor (Vendor) */
+
+    0x09,                                                   // Size of this descriptor in bytes
+    USB_DESCRIPTOR_INTERFACE,                               // INTERFACE descriptor type
+    2,                                                      // Interface Number
+    0x00,                                                   // Alternate Setting Number
+    0x02,                                                   // Number of endpoints in this interface
+    USB_VENDOR_SPECIFIC_INTERFACE_CLASS_CODE,               // Class code
+    0x00,                                                   // Subclass code
+    0x00,                                                   // Protocol code
+    0x00,                                                   // Interface string index
+
+    /* Bulk Endpoint (OUT) Descriptor */
+
+    0x07,                                                   // Size of this descriptor
+    USB_DESCRIPTOR_ENDPOINT,                                // Endpoint Descriptor
+    3 | USB_EP_DIRECTION_OUT,                               // EndpointAddress ( EP3 OUT )
+    (uint8_t)USB_TRANSFER_TYPE_BULK,                                 // Attributes type of EP (BULK)
+    0x40, 0x00,                                             // Max packet size of this EP
+    0x00,                                                   // Interval (in ms)
+
+    /* Bulk Endpoint (IN) Descriptor */
+
+    0x07,                                                   // Size of this descriptor
+    USB_DESCRIPTOR_ENDPOINT,                                // Endpoint Descriptor
+    3 | USB_EP_DIRECTION_IN,                                // EndpointAddress ( EP3 IN )
+    (uint8_t)USB_TRANSFER_TYPE_BULK,                                 // Attributes type of EP (BULK)
+    0x40, 0x00,                                             // Max packet size of this EP
+    0x00,                                                   // Interval (in ms)
+
 
 
 };
@@ -213,6 +270,104 @@ static USB_DEVICE_CONFIGURATION_DESCRIPTORS_TABLE fullSpeedConfigDescSet[1] =
     fullSpeedConfigurationDescriptor
 };
 
+/*******************************************
+ *  Microsoft OS 2.0 Descriptor Set
+ *******************************************/
+/* The descriptor set binds WinUSB to the vendor interface (interface 2) and
+   registers the device interface GUID that host applications open. */
+#define USB_DEVICE_VENDOR_MS_OS_20_VENDOR_CODE      0x20U
+#define USB_DEVICE_VENDOR_MS_OS_20_SET_LENGTH       178U
+
+static const uint8_t msOs20DescriptorSet[USB_DEVICE_VENDOR_MS_OS_20_SET_LENGTH] =
+{
+    /* Descriptor Set Header */
+
+    0x0A, 0x00,                                             // wLength
+    USB_DEVICE_VENDOR_MS_OS_20_SET_HEADER_DESCRIPTOR, 0x00, // wDescriptorType
+    0x00, 0x00, 0x03, 0x06,                                 // dwWindowsVersion (Windows 8.1)
+    USB_DEVICE_16bitTo8bitArrange(USB_DEVICE_VENDOR_MS_OS_20_SET_LENGTH), // wTotalLength
+
+    /* Configuration Subset Header */
+
+    0x08, 0x00,                                             // wLength
+    USB_DEVICE_VENDOR_MS_OS_20_SUBSET_HEADER_CONFIGURATION, 0x00, // wDescriptorType
+    0x00,                                                   // bConfigurationValue (configuration index)
+    0x00,                                                   // bReserved
+    USB_DEVICE_16bitTo8bitArrange(168),                     // wTotalLength of this subset
+
+    /* Function Subset Header */
+
+    0x08, 0x00,                                             // wLength
+    USB_DEVICE_VENDOR_MS_OS_20_SUBSET_HEADER_FUNCTION, 0x00, // wDescriptorType
+    2,                                                      // bFirstInterface
+    0x00,                                                   // bReserved
+    USB_DEVICE_16bitTo8bitArrange(160),                     // wSubsetLength
+
+    /* Compatible ID Descriptor */
+
+    0x14, 0x00,                                             // wLength
+    USB_DEVICE_VENDOR_MS_OS_20_FEATURE_COMPATIBLE_ID, 0x00, // wDescriptorType
+    'W', 'I', 'N', 'U', 'S', 'B', 0x00, 0x00,               // CompatibleID
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,         // SubCompatibleID
+
+    /* Registry Property Descriptor */
+
+    0x84, 0x00,                                             // wLength
+    USB_DEVICE_VENDOR_MS_OS_20_FEATURE_REG_PROPERTY, 0x00,  // wDescriptorType
+    USB_DEVICE_VENDOR_MS_OS_20_REG_MULTI_SZ, 0x00,          // wPropertyDataType
+    0x2A, 0x00,                                             // wPropertyNameLength
+    'D', 0x00, 'e', 0x00, 'v', 0x00, 'i', 0x00,
+    'c', 0x00, 'e', 0x00, 'I', 0x00, 'n', 0x00,
+    't', 0x00, 'e', 0x00, 'r', 0x00, 'f', 0x00,
+    'a', 0x00, 'c', 0x00, 'e', 0x00, 'G', 0x00,
+    'U', 0x00, 'I', 0x00, 'D', 0x00, 's', 0x00,
+    0x00, 0x00,
+    0x50, 0x00,                                             // wPropertyDataLength
+    '{', 0x00, '3', 0x00, 'C', 0x00, '5', 0x00,
+    'E', 0x00, '1', 0x00, 'D', 0x00, '2', 0x00,
+    'A', 0x00, '-', 0x00, '8', 0x00, 'F', 0x00,
+    '4', 0x00, 'B', 0x00, '-', 0x00, '4', 0x00,
+    'A', 0x00, '6', 0x00, 'E', 0x00, '-', 0x00,
+    '9', 0x00, 'D', 0x00, '2', 0x00, '7', 0x00,
+    '-', 0x00, '5', 0x00, 'B', 0x00, '1', 0x00,
+    'F', 0x00, '0', 0x00, 'C', 0x00, '8', 0x00,
+    'E', 0x00, '6', 0x00, 'A', 0x00, '4', 0x00,
+    '3', 0x00, '}', 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+const USB_DEVICE_VENDOR_MS_OS_20_DESCRIPTOR usbDeviceVendorMsOs20Descriptor =
+{
+    .vendorCode = USB_DEVICE_VENDOR_MS_OS_20_VENDOR_CODE,
+    .descriptorSetLength = USB_DEVICE_VENDOR_MS_OS_20_SET_LENGTH,
+    .descriptorSet = msOs20DescriptorSet
+};
+
+/*******************************************
+ *  BOS Descriptor
+ *******************************************/
+static const uint8_t bosDescriptor[] =
+{
+    /* BOS Descriptor */
+
+    0x05,                                                   // Size of this descriptor in bytes
+    USB_DESCRIPTOR_BOS,                                     // BOS descriptor type
+    USB_DEVICE_16bitTo8bitArrange(33),                      // Total length of the BOS descriptors
+    0x01,                                                   // Number of device capabilities
+
+    /* Microsoft OS 2.0 Platform Capability Descriptor */
+
+    0x1C,                                                   // Size of this descriptor in bytes
+    USB_DESCRIPTOR_DEVICE_CAPABILITY,                       // Device capability descriptor type
+    USB_DEVICE_VENDOR_DEVICE_CAPABILITY_PLATFORM,           // Platform capability
+    0x00,                                                   // Reserved
+    0xDF, 0x60, 0xDD, 0xD8, 0x89, 0x45, 0xC7, 0x4C,         // MS OS 2.0 Platform Capability ID
+    0x9C, 0xD2, 0x65, 0x9D, 0x9E, 0x64, 0x8A, 0x9F,         // D8DD60DF-4589-4CC7-9CD2-659D9E648A9F
+    0x00, 0x00, 0x03, 0x06,                                 // dwWindowsVersion (Windows 8.1)
+    USB_DEVICE_16bitTo8bitArrange(USB_DEVICE_VENDOR_MS_OS_20_SET_LENGTH), // wMSOSDescriptorSetTotalLength
+    USB_DEVICE_VENDOR_MS_OS_20_VENDOR_CODE,                 // bMS_VendorCode
+    0x00                                                    // bAltEnumCode
+};
+
 /**************************************
  *  String descriptors.
  *************************************/
@@ -292,7 +447,8 @@ static const USB_DEVICE_MASTER_DESCRIPTOR usbMasterDescriptor =
     3,                                                      // Total number of string descriptors available.
     stringDescriptors,                                      // Pointer to array of string descriptors.
     NULL,
-    NULL
+    NULL,
+    bosDescriptor                                           // Pointer to BOS descriptor
 };
 
 
@@ -303,7 +459,7 @@ const USB_DEVICE_INIT usbDevInitData =
 {
     /* Number of function drivers registered to this instance of the
        USB device layer */
-    .registeredFuncCount = 1,
+    .registeredFuncCount = 2,
 
     /* Function driver table registered to this instance of the USB device layer*/
     .registeredFunctions = (USB_DEVICE_FUNCTION_REGISTRATION_TABLE*)funcRegistrationTable,
@@ -0,0 +1,144 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    input.c
+
+  Summary:
+    This file contains the source code for the button input module.
+
+  Description:
+    This file contains the source code for the button input module. The EIC
+    filters BTN_1 and generates an event on both edges, which retriggers the
+    one-shot TC0 through EVSYS channel 0. TC0 only overflows once the pin has
+    been stable for the whole debounce period, and its interrupt compares the
+    pin with the last debounced level to post PRESSED and RELEASED events.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "input.h"
+#include "definitions.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+static INPUT_DATA inputData;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Called from the TC0 interrupt when the debounce period expires */
+static void F_INPUT_DebounceCallback ( TC_TIMER_STATUS status, uintptr_t context )
+{
+    uint32_t level = BTN_1_Get();
+    uint32_t head = inputData.head;
+
+    if (level == inputData.btn1Level)
+    {
+        /* The pin bounced back to the debounced level */
+        return;
+    }
+
+    inputData.btn1Level = level;
+
+    if ((head - inputData.tail) >= INPUT_QUEUE_DEPTH)
+    {
+        inputData.dropped++;
+        return;
+    }
+
+    inputData.queue[head & (INPUT_QUEUE_DEPTH - 1U)].source = INPUT_SOURCE_BTN_1;
+    inputData.queue[head & (INPUT_QUEUE_DEPTH - 1U)].edge = (level == 0U) ? INPUT_EDGE_PRESSED : INPUT_EDGE_RELEASED;
+
+    /* The event must be in the queue before the consumer sees the new head */
+    __DMB();
+    inputData.head = head + 1U;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Initialization and Event Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void INPUT_Initialize ( void )
+
+  Remarks:
+    See prototype in input.h.
+ */
+
+void INPUT_Initialize ( void )
+{
+    /* The button is released until the first debounce period says otherwise */
+    inputData.btn1Level = 1U;
+    inputData.head = 0U;
+    inputData.tail = 0U;
+    inputData.dropped = 0U;
+
+    TC0_TimerCallbackRegister(F_INPUT_DebounceCallback, 0U);
+
+    /* The one-shot counter runs one debounce period and then waits for the
+     * next EIC event */
+    TC0_TimerStart();
+}
+
+
+/*******************************************************************************
+  Function:
+    bool INPUT_EventGet ( INPUT_EVENT * event )
+
+  Remarks:
+    See prototype in input.h.
+ */
+
+bool INPUT_EventGet ( INPUT_EVENT * event )
+{
+    uint32_t tail = inputData.tail;
+
+    if (tail == inputData.head)
+    {
+        return false;
+    }
+
+    /* Read the event only after the head that publishes it */
+    __DMB();
+    *event = inputData.queue[tail & (INPUT_QUEUE_DEPTH - 1U)];
+    inputData.tail = tail + 1U;
+
+    return true;
+}
+
+
+/*******************************************************************************
+  Function:
+    uint32_t INPUT_DroppedCountGet ( void )
+
+  Remarks:
+    See prototype in input.h.
+ */
+
+uint32_t INPUT_DroppedCountGet ( void )
+{
+    return inputData.dropped;
+}
+
+
+/*******************************************************************************
+ End of File
+ */
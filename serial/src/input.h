@@ -0,0 +1,229 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    input.h
+
+  Summary:
+    This header file provides prototypes and definitions for the button input
+    module.
+
+  Description:
+    This header file provides function prototypes and data type definitions for
+    the button input module. The button is filtered by the EIC and debounced by
+    TC0, which the EIC retriggers through the event system on every edge. The
+    TC0 interrupt posts the debounced edges into a queue that the application
+    reads from its task routine, so the button costs nothing in the USB event
+    path and keeps working while the bus is suspended.
+*******************************************************************************/
+
+#ifndef _INPUT_H
+#define _INPUT_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Number of edge events the queue holds. Must be a power of 2. */
+#define INPUT_QUEUE_DEPTH 8U
+
+// *****************************************************************************
+/* Input sources
+
+  Summary:
+    Identifies the input that generated an event.
+*/
+
+typedef enum
+{
+    INPUT_SOURCE_BTN_1 = 0,
+
+} INPUT_SOURCE;
+
+// *****************************************************************************
+/* Input edges
+
+  Summary:
+    Identifies the debounced edge of an input event.
+*/
+
+typedef enum
+{
+    INPUT_EDGE_PRESSED = 0,
+    INPUT_EDGE_RELEASED,
+
+} INPUT_EDGE;
+
+// *****************************************************************************
+/* Input event
+
+  Summary:
+    Debounced edge of an input.
+*/
+
+typedef struct
+{
+    INPUT_SOURCE source;
+    INPUT_EDGE edge;
+
+} INPUT_EVENT;
+
+// *****************************************************************************
+/* Input Data
+
+  Summary:
+    Holds the input module data
+
+  Description:
+    This structure holds the debounced button state and the event queue. The
+    queue has a single producer, the TC0 interrupt, and a single consumer,
+    INPUT_EventGet. The producer only writes the head and the consumer only
+    writes the tail.
+ */
+
+typedef struct
+{
+    /* Debounced level of BTN_1 (0 is pressed) */
+    uint32_t btn1Level;
+
+    /* Event queue */
+    INPUT_EVENT queue[INPUT_QUEUE_DEPTH];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+
+    /* Events lost because the queue was full */
+    volatile uint32_t dropped;
+
+} INPUT_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Initialization and Event Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void INPUT_Initialize ( void )
+
+  Summary:
+    Initializes the button input module.
+
+  Description:
+    This function registers the TC0 debounce callback, empties the event queue
+    and starts TC0 once so that the debounced state is taken from the pin.
+
+  Precondition:
+    EIC_Initialize, EVSYS_Initialize and TC0_TimerInitialize must have been
+    called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    INPUT_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+void INPUT_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    bool INPUT_EventGet ( INPUT_EVENT * event )
+
+  Summary:
+    Takes the oldest debounced edge from the event queue.
+
+  Description:
+    This function copies the oldest event of the queue to event and removes it
+    from the queue.
+
+  Precondition:
+    INPUT_Initialize must have been called.
+
+  Parameters:
+    event - Pointer to where the event is copied.
+
+  Returns:
+    true if an event was copied, false if the queue is empty.
+
+  Example:
+    <code>
+    INPUT_EVENT event;
+
+    while (INPUT_EventGet(&event))
+    {
+        // Handle event
+    }
+    </code>
+
+  Remarks:
+    Must only be called from one task context.
+*/
+
+bool INPUT_EventGet ( INPUT_EVENT * event );
+
+
+/*******************************************************************************
+  Function:
+    uint32_t INPUT_DroppedCountGet ( void )
+
+  Summary:
+    Returns the number of events lost because the queue was full.
+
+  Precondition:
+    INPUT_Initialize must have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    Number of dropped events since INPUT_Initialize.
+*/
+
+uint32_t INPUT_DroppedCountGet ( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _INPUT_H */
+
+/*******************************************************************************
+ End of File
+ */
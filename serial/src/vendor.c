@@ -0,0 +1,201 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    vendor.c
+
+  Summary:
+    This file contains the source code for the vendor bulk streaming
+    application.
+
+  Description:
+    This file contains the source code for the vendor bulk streaming
+    application. All buffers are queued from VENDOR_Tasks so that the vendor
+    function driver only ever sees one producer per IRP ring. The event
+    handler only does the accounting.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "vendor.h"
+#include "app.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds application data
+
+  Description:
+    This structure holds the application's data.
+
+  Remarks:
+    This structure should be initialized by the VENDOR_Initialize function.
+
+    Application strings and buffers are be defined outside this structure.
+*/
+
+VENDOR_DATA vendorData;
+extern APP_DATA appData;
+
+/* One receive buffer per read IRP. The read ring completes in order, so the
+   buffer at rxBufferIndex is always free when the ring has a free slot. */
+static uint8_t vendorReceiveBuffer[USB_DEVICE_VENDOR_QUEUE_DEPTH_READ][VENDOR_BUFFER_SIZE] CACHE_ALIGN;
+
+/* The transmit buffer is never modified after initialization and is queued
+   on every write IRP. */
+static uint8_t vendorTransmitBuffer[VENDOR_BUFFER_SIZE] CACHE_ALIGN;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Callback Functions
+// *****************************************************************************
+// *****************************************************************************
+
+USB_DEVICE_VENDOR_EVENT_RESPONSE USBDeviceVendorEventHandler
+(
+    USB_DEVICE_VENDOR_INDEX instanceIndex,
+    USB_DEVICE_VENDOR_EVENT event,
+    void * pData,
+    uintptr_t userData
+)
+{
+    USB_DEVICE_VENDOR_EVENT_DATA_READ_COMPLETE * eventData = (USB_DEVICE_VENDOR_EVENT_DATA_READ_COMPLETE *)pData;
+
+    if (eventData->status != USB_DEVICE_VENDOR_RESULT_OK)
+    {
+        vendorData.errors++;
+        return USB_DEVICE_VENDOR_EVENT_RESPONSE_NONE;
+    }
+
+    switch(event)
+    {
+        case USB_DEVICE_VENDOR_EVENT_READ_COMPLETE:
+            vendorData.rxBytes += eventData->length;
+            break;
+
+        case USB_DEVICE_VENDOR_EVENT_WRITE_COMPLETE:
+            vendorData.txBytes += eventData->length;
+            break;
+
+        default:
+            break;
+    }
+
+    return USB_DEVICE_VENDOR_EVENT_RESPONSE_NONE;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void VENDOR_Initialize ( void )
+
+  Remarks:
+    See prototype in vendor.h.
+ */
+
+void VENDOR_Initialize ( void )
+{
+    uint32_t i;
+
+    /* Place the App state machine in its initial state. */
+    vendorData.state = VENDOR_STATE_INIT;
+
+    /* Byte ramp so the host can check the stream for lost packets */
+    for (i = 0; i < VENDOR_BUFFER_SIZE; i++)
+    {
+        vendorTransmitBuffer[i] = (uint8_t)i;
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    void VENDOR_Tasks ( void )
+
+  Remarks:
+    See prototype in vendor.h.
+ */
+
+void VENDOR_Tasks ( void )
+{
+    USB_DEVICE_VENDOR_TRANSFER_HANDLE transferHandle;
+
+    switch ( vendorData.state )
+    {
+        case VENDOR_STATE_INIT:
+        {
+            if (appData.deviceIsConfigured)
+            {
+                vendorData.rxBufferIndex = 0;
+                vendorData.rxBytes = 0;
+                vendorData.txBytes = 0;
+                vendorData.errors = 0;
+                vendorData.state = VENDOR_STATE_STREAM;
+            }
+            break;
+        }
+
+        case VENDOR_STATE_STREAM:
+        {
+            if (!appData.deviceIsConfigured)
+            {
+                vendorData.state = VENDOR_STATE_INIT;
+                break;
+            }
+
+            /* Keep every read IRP queued so the OUT endpoint is re-armed as
+             * soon as a transfer completes */
+            while (USB_DEVICE_VENDOR_ReadQueueFreeGet(USB_DEVICE_VENDOR_INDEX_0) > 0U)
+            {
+                if (USB_DEVICE_VENDOR_Read(USB_DEVICE_VENDOR_INDEX_0, &transferHandle,
+                        vendorReceiveBuffer[vendorData.rxBufferIndex], VENDOR_BUFFER_SIZE) != USB_DEVICE_VENDOR_RESULT_OK)
+                {
+                    break;
+                }
+                vendorData.rxBufferIndex = (vendorData.rxBufferIndex + 1U) % USB_DEVICE_VENDOR_QUEUE_DEPTH_READ;
+            }
+
+            /* The IN stream never ends, so no zero length packets */
+            while (USB_DEVICE_VENDOR_WriteQueueFreeGet(USB_DEVICE_VENDOR_INDEX_0) > 0U)
+            {
+                if (USB_DEVICE_VENDOR_Write(USB_DEVICE_VENDOR_INDEX_0, &transferHandle,
+                        vendorTransmitBuffer, VENDOR_BUFFER_SIZE,
+                        USB_DEVICE_VENDOR_TRANSFER_FLAGS_MORE_DATA_PENDING) != USB_DEVICE_VENDOR_RESULT_OK)
+                {
+                    break;
+                }
+            }
+            break;
+        }
+
+        /* The default state should never be executed. */
+        default:
+        {
+            break;
+        }
+    }
+}
+
+
+/*******************************************************************************
+ End of File
+ */
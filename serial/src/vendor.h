@@ -0,0 +1,202 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    vendor.h
+
+  Summary:
+    This header file provides prototypes and definitions for the vendor bulk
+    streaming application.
+
+  Description:
+    This header file provides function prototypes and data type definitions for
+    the vendor bulk streaming application. The application sinks all data
+    received on the vendor bulk OUT endpoint and sources a continuous test
+    pattern on the vendor bulk IN endpoint so that a host application can
+    measure the throughput of the raw bulk channel.
+*******************************************************************************/
+
+#ifndef _VENDOR_H
+#define _VENDOR_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "configuration.h"
+#include "usb/usb_device_vendor.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Size of one streaming buffer. A multiple of the bulk endpoint size so that
+   reads are accepted and writes do not end with a short packet. */
+#define VENDOR_BUFFER_SIZE 2048
+
+// *****************************************************************************
+/* Application states
+
+  Summary:
+    Application states enumeration
+
+  Description:
+    This enumeration defines the valid application states.  These states
+    determine the behavior of the application at various times.
+*/
+
+typedef enum
+{
+    /* Application's state machine's initial state. */
+    VENDOR_STATE_INIT=0,
+    VENDOR_STATE_STREAM,
+
+} VENDOR_STATES;
+
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds application data
+
+  Description:
+    This structure holds the application's data.
+
+  Remarks:
+    Application strings and buffers are be defined outside this structure.
+ */
+
+typedef struct
+{
+    /* The application's current state */
+    VENDOR_STATES state;
+
+    /* Index of the next receive buffer to queue */
+    uint32_t rxBufferIndex;
+
+    /* Bytes received and sent since the device was configured */
+    volatile uint32_t rxBytes;
+    volatile uint32_t txBytes;
+
+    /* Transfers that completed with an error */
+    volatile uint32_t errors;
+
+} VENDOR_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Callback Routines
+// *****************************************************************************
+// *****************************************************************************
+/* These routines are called by drivers when certain events occur.
+*/
+USB_DEVICE_VENDOR_EVENT_RESPONSE USBDeviceVendorEventHandler
+(
+        USB_DEVICE_VENDOR_INDEX instanceIndex,
+        USB_DEVICE_VENDOR_EVENT event,
+        void * pData,
+        uintptr_t userData
+);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void VENDOR_Initialize ( void )
+
+  Summary:
+     MPLAB Harmony application initialization routine.
+
+  Description:
+    This function initializes the vendor streaming application and fills the
+    transmit buffer with the test pattern.
+
+  Precondition:
+    All other system initialization routines should be called before calling
+    this routine (in "SYS_Initialize").
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    VENDOR_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+void VENDOR_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    void VENDOR_Tasks ( void )
+
+  Summary:
+    Vendor streaming application tasks function
+
+  Description:
+    This routine keeps the read and write IRP rings of the vendor function
+    driver full while the device is configured.
+
+  Precondition:
+    The system and application initialization ("SYS_Initialize") should be
+    called before calling this.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    VENDOR_Tasks();
+    </code>
+
+  Remarks:
+    This routine must be called from SYS_Tasks() routine.
+ */
+
+void VENDOR_Tasks( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _VENDOR_H */
+
+/*******************************************************************************
+ End of File
+ */